@@ -0,0 +1,59 @@
+#include "cppkit/crypto/aes.hpp"
+#include <chrono>
+#include <iomanip>
+#include <iostream>
+
+using namespace cppkit::crypto;
+
+template <typename Fn>
+static void run(const std::string& name, const size_t bytesPerCall, Fn&& fn, const size_t totalBytes = 512u << 20)
+{
+  using Clock = std::chrono::steady_clock;
+  const size_t iterations = std::max<size_t>(1, totalBytes / bytesPerCall);
+  for (size_t i = 0; i < iterations / 16 + 1; ++i)
+    fn();
+  const auto start = Clock::now();
+  for (size_t i = 0; i < iterations; ++i)
+    fn();
+  const double seconds = std::chrono::duration<double>(Clock::now() - start).count();
+  std::cout << std::left << std::setw(30) << name << std::right << std::fixed << std::setprecision(3)
+      << std::setw(10) << static_cast<double>(bytesPerCall) * iterations / seconds / 1e9 << " GB/s" << std::endl;
+}
+
+int main()
+{
+  constexpr size_t kSize = 16 * 1024;
+  std::vector<uint8_t> data(kSize, 0x5A);
+  const std::vector<uint8_t> key128(16, 0x01);
+  const std::vector<uint8_t> key256(32, 0x02);
+  const uint8_t iv[16] = {};
+  const uint8_t nonce[12] = {};
+  const bool hardware = Aes::hardwareAccelerated();
+
+  {
+    // 旧实现：每次调用都会复制并填充明文，返回新的 vector
+    const std::vector<uint8_t> small(kSize / 16, 0x5A);
+    size_t sink = 0;
+    run("AES_Encrypt_CBC (legacy)", small.size(), [&] { sink += AES_Encrypt_CBC(small, key128.data(), iv).size(); },
+        4u << 20);
+  }
+
+  for (const bool useHardware : {false, true})
+  {
+    if (!Aes::setHardwareAccelerated(useHardware))
+      continue;
+    const std::string suffix = useHardware ? " (aes-ni)" : " (t-table)";
+    for (const auto* key : {&key128, &key256})
+    {
+      const std::string bits = std::to_string(key->size() * 8);
+      AesCtr ctr(*key, std::span<const uint8_t, 16>(iv, 16));
+      const size_t total = useHardware ? 512u << 20 : 32u << 20;
+      run("AES-" + bits + "-CTR" + suffix, kSize, [&] { ctr.update(data); }, total);
+
+      AesGcm gcm(*key);
+      run("AES-" + bits + "-GCM" + suffix, kSize, [&] { gcm.seal(nonce, {}, data); }, total);
+    }
+  }
+  Aes::setHardwareAccelerated(hardware);
+  return 0;
+}
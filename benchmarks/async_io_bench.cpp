@@ -0,0 +1,85 @@
+#include "cppkit/io/file.hpp"
+#include <chrono>
+#include <fstream>
+#include <iomanip>
+#include <iostream>
+#include <random>
+
+using namespace cppkit;
+using Clock = std::chrono::steady_clock;
+
+constexpr size_t kFileSize = 256 * 1024 * 1024;
+constexpr size_t kBlock = 4096;
+constexpr size_t kReads = 200000;
+
+// 每完成一个读就补一个新的随机读，保持 depth 个请求在途，返回每秒完成的读次数
+static double randomReads(const io::File& file, const io::IoBackend backend, const unsigned depth)
+{
+    event::EventLoop loop;
+    io::IoEngine engine(&loop, io::IoEngineConfig{.queueDepth = depth, .backend = backend});
+    std::vector<char> buffers(depth * kBlock);
+    std::mt19937_64 gen(42);
+    std::uniform_int_distribution<size_t> block(0, kFileSize / kBlock - 1);
+    size_t issued = 0;
+    size_t completed = 0;
+
+    std::function<void(size_t)> issue = [&](const size_t slot)
+    {
+        ++issued;
+        file.readAsync(engine, buffers.data() + slot * kBlock, kBlock, block(gen) * kBlock, [&, slot](ssize_t)
+        {
+            if (++completed == kReads)
+                loop.stop();
+            else if (issued < kReads)
+                issue(slot);
+        });
+    };
+
+    const auto start = Clock::now();
+    for (unsigned slot = 0; slot < depth; ++slot)
+        issue(slot);
+    loop.run();
+    return static_cast<double>(kReads) / std::chrono::duration<double>(Clock::now() - start).count();
+}
+
+int main()
+{
+    const std::string path = (std::filesystem::temp_directory_path() / "cppkit_async_io_bench.bin").string();
+    {
+        std::string block(1 << 20, 'x');
+        std::ofstream ofs(path, std::ios::binary);
+        for (size_t written = 0; written < kFileSize; written += block.size())
+            ofs.write(block.data(), static_cast<std::streamsize>(block.size()));
+    }
+    const io::File file(path);
+
+    // 同步 pread 作为基准
+    {
+        std::vector<char> buffer(kBlock);
+        std::mt19937_64 gen(42);
+        std::uniform_int_distribution<size_t> block(0, kFileSize / kBlock - 1);
+        const auto start = Clock::now();
+        for (size_t i = 0; i < kReads; ++i)
+            (void)file.read(buffer.data(), kBlock, block(gen) * kBlock);
+        std::cout << "sync pread: " << std::fixed << std::setprecision(0)
+            << kReads / std::chrono::duration<double>(Clock::now() - start).count() << " reads/s" << std::endl;
+    }
+
+    event::EventLoop probeLoop;
+    const bool uring = io::IoEngine(&probeLoop).usingIoUring();
+    std::cout << "random 4KB reads over " << kFileSize / (1024 * 1024) << " MB (page cache warm)\n"
+        << std::left << std::setw(8) << "depth" << std::right << std::setw(20) << "io_uring (reads/s)"
+        << std::setw(22) << "thread pool (reads/s)" << std::endl;
+    for (const unsigned depth : {1u, 4u, 16u, 64u, 256u})
+    {
+        std::cout << std::left << std::setw(8) << depth << std::right << std::setw(20);
+        if (uring)
+            std::cout << randomReads(file, io::IoBackend::IO_URING, depth);
+        else
+            std::cout << "n/a";
+        std::cout << std::setw(22) << randomReads(file, io::IoBackend::THREAD_POOL, depth) << std::endl;
+    }
+
+    std::filesystem::remove(path);
+    return 0;
+}
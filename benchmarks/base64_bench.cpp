@@ -0,0 +1,86 @@
+#include "cppkit/crypto/base.hpp"
+#include <chrono>
+#include <iomanip>
+#include <iostream>
+
+using namespace cppkit::crypto;
+
+// 旧实现：先复制成 vector，每 3 字节 4 次 push_back
+static std::string legacyEncode(const std::string& input)
+{
+  static constexpr char table[] = "ABCDEFGHIJKLMNOPQRSTUVWXYZabcdefghijklmnopqrstuvwxyz0123456789+/";
+  const std::vector<uint8_t> data(input.begin(), input.end());
+  std::string out;
+  out.reserve((data.size() + 2) / 3 * 4);
+  size_t i = 0;
+  for (; i + 3 <= data.size(); i += 3)
+  {
+    const uint32_t n = (data[i] << 16) | (data[i + 1] << 8) | data[i + 2];
+    out.push_back(table[(n >> 18) & 63]);
+    out.push_back(table[(n >> 12) & 63]);
+    out.push_back(table[(n >> 6) & 63]);
+    out.push_back(table[n & 63]);
+  }
+  if (i < data.size())
+  {
+    const uint32_t n = (data[i] << 16) | (i + 1 < data.size() ? data[i + 1] << 8 : 0);
+    out.push_back(table[(n >> 18) & 63]);
+    out.push_back(table[(n >> 12) & 63]);
+    out.push_back(i + 1 < data.size() ? table[(n >> 6) & 63] : '=');
+    out.push_back('=');
+  }
+  return out;
+}
+
+template <typename Fn>
+static void run(const std::string& name, const size_t bytesPerCall, Fn&& fn)
+{
+  using Clock = std::chrono::steady_clock;
+  const size_t iterations = std::max<size_t>(1, (256u << 20) / bytesPerCall);
+  for (size_t i = 0; i < iterations / 16 + 1; ++i)
+    fn();
+  const auto start = Clock::now();
+  for (size_t i = 0; i < iterations; ++i)
+    fn();
+  const double seconds = std::chrono::duration<double>(Clock::now() - start).count();
+  std::cout << std::left << std::setw(32) << name << std::right << std::fixed << std::setprecision(3)
+      << std::setw(10) << static_cast<double>(bytesPerCall) * iterations / seconds / 1e9 << " GB/s" << std::endl;
+}
+
+int main()
+{
+  const Base64::Backend saved = Base64::backend();
+  std::cout << "default backend: " << Base64::backendName(saved) << " (GB/s of binary data)" << std::endl;
+
+  for (const size_t size : {size_t{20}, size_t{1024}, size_t{64} << 10})
+  {
+    std::string data(size, '\0');
+    for (size_t i = 0; i < size; ++i)
+      data[i] = static_cast<char>(i * 131 + 7);
+    const auto bytes = std::span(reinterpret_cast<const uint8_t*>(data.data()), size);
+    const std::string encoded = Base64::encode(data);
+    std::string mime;
+    for (size_t i = 0; i < encoded.size(); i += 76)
+      mime += encoded.substr(i, 76) + "\r\n";
+    std::vector<char> text(Base64::encodedLength(size));
+    std::vector<uint8_t> binary(Base64::decodedMaxLength(encoded.size()));
+    const std::string suffix = "/" + std::to_string(size);
+    size_t sink = 0;
+
+    run("encode/legacy" + suffix, size, [&] { sink += legacyEncode(data).size(); });
+    for (const auto backend : {Base64::Backend::Scalar, Base64::Backend::Ssse3, Base64::Backend::Avx2})
+    {
+      if (!Base64::setBackend(backend))
+        continue;
+      const std::string name = Base64::backendName(backend) + suffix;
+      run("encode/" + name, size, [&] { sink += Base64::encode(data).size(); });
+      run("encode-span/" + name, size, [&] { sink += Base64::encode(bytes, text); });
+      run("decode-span/" + name, size, [&] { sink += Base64::decode(encoded, binary); });
+      run("decode-mime/" + name, size, [&] { sink += Base64::decode(mime, binary, Base64::kMime); });
+    }
+    Base64::setBackend(saved);
+    if (sink == 0)
+      return 1;
+  }
+  return 0;
+}
@@ -0,0 +1,92 @@
+#include "cppkit/crypto/crypto.hpp"
+#include <chrono>
+#include <iomanip>
+#include <iostream>
+
+#if defined(__x86_64__) || defined(__i386__)
+#include <x86intrin.h>
+#endif
+
+using namespace cppkit::crypto;
+
+// 周期计数：x86 上使用 TSC，其他平台退化为纳秒
+static uint64_t cycles()
+{
+#if defined(__x86_64__) || defined(__i386__)
+  return __rdtsc();
+#else
+  return std::chrono::duration_cast<std::chrono::nanoseconds>(
+      std::chrono::steady_clock::now().time_since_epoch()).count();
+#endif
+}
+
+template <typename Fn>
+static void run(const std::string& name, const size_t bytesPerCall, Fn&& fn)
+{
+  using Clock = std::chrono::steady_clock;
+  const size_t iterations = std::max<size_t>(1, (256u << 20) / bytesPerCall);
+  for (size_t i = 0; i < iterations / 16 + 1; ++i)
+    fn();
+
+  const auto start = Clock::now();
+  const uint64_t c0 = cycles();
+  for (size_t i = 0; i < iterations; ++i)
+    fn();
+  const uint64_t c1 = cycles();
+  const double seconds = std::chrono::duration<double>(Clock::now() - start).count();
+  const double bytes = static_cast<double>(bytesPerCall) * static_cast<double>(iterations);
+  std::cout << std::left << std::setw(32) << name << std::right << std::fixed << std::setprecision(2)
+      << std::setw(8) << static_cast<double>(c1 - c0) / bytes << " cycles/B" << std::setprecision(0)
+      << std::setw(10) << bytes / seconds / 1e6 << " MB/s" << std::endl;
+}
+
+template <typename Hash>
+static void benchHash(const char* name, const std::string& data)
+{
+  for (const auto backend : {ShaBackend::Scalar, ShaBackend::ShaNi})
+  {
+    if (!Hash::setBackend(backend))
+      continue;
+    for (const size_t size : {size_t{64}, size_t{1024}, size_t{1} << 20})
+    {
+      volatile uint8_t sink = 0;
+      run(std::string(name) + "/" + backendName(backend) + "/" + std::to_string(size), size, [&]
+      {
+        Hash hash;
+        hash.update(reinterpret_cast<const uint8_t*>(data.data()), size);
+        sink = hash.digest()[0];
+      });
+    }
+  }
+}
+
+int main()
+{
+  const std::string data(1 << 20, 'x');
+  const ShaBackend sha1Default = SHA1::backend();
+  const ShaBackend sha256Default = SHA256::backend();
+  std::cout << "default: sha1=" << backendName(sha1Default) << " sha256=" << backendName(sha256Default) << std::endl;
+
+  benchHash<SHA1>("sha1", data);
+  benchHash<SHA256>("sha256", data);
+
+  // 8 条独立消息一组
+  for (const size_t size : {size_t{64}, size_t{1024}, size_t{16384}})
+  {
+    std::vector<std::string_view> messages;
+    for (size_t i = 0; i < 8; ++i)
+      messages.emplace_back(data.data() + i * size, size);
+    std::vector<std::array<uint8_t, 32>> out(messages.size());
+    for (const auto backend : {ShaBackend::Scalar, ShaBackend::ShaNi, ShaBackend::Avx2})
+    {
+      if (!SHA256::setBackend(backend))
+        continue;
+      run("sha256x8/" + std::string(backendName(backend)) + "/" + std::to_string(size), size * 8,
+          [&] { SHA256::hashMany(messages, out); });
+    }
+  }
+
+  SHA1::setBackend(sha1Default);
+  SHA256::setBackend(sha256Default);
+  return 0;
+}
@@ -0,0 +1,136 @@
+#include "cppkit/io/file.hpp"
+#include <chrono>
+#include <cstring>
+#include <fstream>
+#include <functional>
+#include <iomanip>
+#include <iostream>
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+using namespace cppkit;
+using Clock = std::chrono::steady_clock;
+
+// 按 8 字节累加，保证每个字节都被读到且不会被优化掉
+static uint64_t checksum(const char* data, const size_t size)
+{
+    uint64_t sum = 0;
+    size_t i = 0;
+    for (; i + 8 <= size; i += 8)
+    {
+        uint64_t word;
+        std::memcpy(&word, data + i, 8);
+        sum += word;
+    }
+    for (; i < size; ++i)
+        sum += static_cast<uint8_t>(data[i]);
+    return sum;
+}
+
+// 旧实现：每个 chunk 一次 mmap + munmap
+static size_t legacyChunkedRead(const std::string& path, const std::function<void(const char*, ssize_t)>& fun,
+                                size_t offset, const int chunk)
+{
+    const int fd = ::open(path.c_str(), O_RDONLY);
+    struct stat st{};
+    fstat(fd, &st);
+    const size_t filesize = st.st_size;
+    const long pageSize = sysconf(_SC_PAGE_SIZE);
+    size_t total{};
+    while (offset < filesize)
+    {
+        const size_t bytes = std::min(static_cast<size_t>(chunk), filesize - offset);
+        const size_t pageOffset = offset & ~(pageSize - 1);
+        const size_t delta = offset - pageOffset;
+        void* addr = mmap(nullptr, delta + bytes, PROT_READ, MAP_PRIVATE, fd, static_cast<off_t>(pageOffset));
+        fun(static_cast<char*>(addr) + delta, static_cast<ssize_t>(bytes));
+        munmap(addr, delta + bytes);
+        offset += bytes;
+        total += bytes;
+    }
+    ::close(fd);
+    return total;
+}
+
+// 取 3 次中最快的一次，返回 GB/s
+static void run(const char* name, const size_t bytes, const std::function<uint64_t()>& fn)
+{
+    double best = 1e9;
+    uint64_t sum = 0;
+    for (int i = 0; i < 3; ++i)
+    {
+        const auto start = Clock::now();
+        sum = fn();
+        best = std::min(best, std::chrono::duration<double>(Clock::now() - start).count());
+    }
+    std::cout << std::left << std::setw(36) << name << std::right << std::fixed << std::setprecision(2)
+        << std::setw(8) << bytes / best / 1e9 << " GB/s   (checksum " << std::hex << sum << std::dec << ")"
+        << std::endl;
+}
+
+int main()
+{
+    constexpr size_t kSize = 256 * 1024 * 1024;
+    const std::string path = (std::filesystem::temp_directory_path() / "cppkit_file_read_bench.bin").string();
+    {
+        std::string block(1 << 20, '\0');
+        for (size_t i = 0; i < block.size(); ++i)
+            block[i] = static_cast<char>(i * 131 % 251);
+        std::ofstream ofs(path, std::ios::binary);
+        for (size_t written = 0; written < kSize; written += block.size())
+            ofs.write(block.data(), static_cast<std::streamsize>(block.size()));
+    }
+    std::cout << "file " << kSize / (1024 * 1024) << " MB (page cache warm)" << std::endl;
+
+    const io::File file(path);
+    run("legacy mmap per 4KB chunk", kSize, [&]
+    {
+        uint64_t sum = 0;
+        legacyChunkedRead(path, [&](const char* data, const ssize_t n) { sum += checksum(data, n); }, 0,
+                          DEFAULT_BUFFER_SIZE);
+        return sum;
+    });
+    run("File::read(fun) 4KB chunks", kSize, [&]
+    {
+        uint64_t sum = 0;
+        (void)file.read([&](const char* data, const ssize_t n) { sum += checksum(data, n); });
+        return sum;
+    });
+    run("File::read(fun) 1MB chunks", kSize, [&]
+    {
+        uint64_t sum = 0;
+        (void)file.read([&](const char* data, const ssize_t n) { sum += checksum(data, n); }, 0, 1 << 20);
+        return sum;
+    });
+    run("MappedFile whole (sequential)", kSize, [&]
+    {
+        const io::MappedFile mapped(path);
+        return checksum(mapped.view().data(), mapped.size());
+    });
+    run("MappedFile whole (populate)", kSize, [&]
+    {
+        const io::MappedFile mapped(path, io::MapOptions{.populate = true});
+        return checksum(mapped.view().data(), mapped.size());
+    });
+    run("MappedFile whole (hugepage hint)", kSize, [&]
+    {
+        const io::MappedFile mapped(path, io::MapOptions{.willNeed = true, .hugePages = true});
+        return checksum(mapped.view().data(), mapped.size());
+    });
+    run("File::read pread 1MB buffer", kSize, [&]
+    {
+        static std::vector<char> buffer(1 << 20);
+        uint64_t sum = 0;
+        for (size_t offset = 0; offset < kSize; offset += buffer.size())
+        {
+            const size_t n = file.read(buffer.data(), buffer.size(), offset);
+            sum += checksum(buffer.data(), n);
+        }
+        return sum;
+    });
+
+    std::filesystem::remove(path);
+    return 0;
+}
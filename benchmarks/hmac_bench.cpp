@@ -0,0 +1,83 @@
+#include "cppkit/crypto/crypto.hpp"
+#include <chrono>
+#include <iomanip>
+#include <iostream>
+
+using namespace cppkit::crypto;
+
+// 旧版 SHA256::hmac 的做法：每次调用都重建 vector 密钥填充，并用 ostringstream 输出十六进制
+static std::string legacyHmac(const std::string& key, const std::string& message)
+{
+  constexpr size_t blockSize = 64;
+  std::vector<uint8_t> keyBytes(key.begin(), key.end());
+  keyBytes.resize(blockSize, 0x00);
+  std::vector<uint8_t> oKeyPad(blockSize);
+  std::vector<uint8_t> iKeyPad(blockSize);
+  for (size_t i = 0; i < blockSize; ++i)
+  {
+    oKeyPad[i] = keyBytes[i] ^ 0x5c;
+    iKeyPad[i] = keyBytes[i] ^ 0x36;
+  }
+  SHA256 inner;
+  inner.update(iKeyPad.data(), iKeyPad.size());
+  inner.update(reinterpret_cast<const uint8_t*>(message.data()), message.size());
+  auto innerHash = inner.digest();
+  SHA256 outer;
+  outer.update(oKeyPad.data(), oKeyPad.size());
+  outer.update(innerHash.data(), innerHash.size());
+  auto mac = outer.digest();
+  std::ostringstream oss;
+  for (const auto b : mac)
+    oss << std::hex << std::setw(2) << std::setfill('0') << static_cast<int>(b);
+  return oss.str();
+}
+
+template <typename Fn>
+static void run(const char* name, Fn&& fn)
+{
+  using Clock = std::chrono::steady_clock;
+  constexpr size_t kIterations = 1000000;
+  for (size_t i = 0; i < kIterations / 10; ++i)
+    fn();
+  const auto start = Clock::now();
+  for (size_t i = 0; i < kIterations; ++i)
+    fn();
+  const double seconds = std::chrono::duration<double>(Clock::now() - start).count();
+  std::cout << std::left << std::setw(36) << name << std::right << std::fixed << std::setprecision(2)
+      << std::setw(10) << kIterations / seconds / 1e6 << " M ops/s" << std::endl;
+}
+
+int main()
+{
+  const std::string key = "request-signing-key-0123456789";
+  const std::string message(64, 'm');
+  size_t sink = 0;
+
+  std::cout << "HMAC over 64-byte messages (sha256 backend: " << backendName(SHA256::backend()) << ")" << std::endl;
+  run("legacy hmac (hex)", [&] { sink += legacyHmac(key, message).size(); });
+  run("SHA256::hmac (hex)", [&] { sink += SHA256::hmac(key, message).size(); });
+
+  const Hmac<SHA256> sha256(key);
+  run("Hmac<SHA256>::mac (precomputed)", [&] { sink += sha256.mac(message)[0]; });
+
+  const Hmac<SHA1> sha1(key);
+  run("Hmac<SHA1>::mac (precomputed)", [&] { sink += sha1.mac(message)[0]; });
+
+  const Hmac<SHA512> sha512(key);
+  run("Hmac<SHA512>::mac (precomputed)", [&] { sink += sha512.mac(message)[0]; });
+
+  const Hmac<MD5> md5(key);
+  run("Hmac<MD5>::mac (precomputed)", [&] { sink += md5.mac(message)[0]; });
+
+  const auto digest = sha256.mac(message);
+  run("hex: ostringstream (32 bytes)", [&]
+  {
+    std::ostringstream oss;
+    for (const auto b : digest)
+      oss << std::hex << std::setw(2) << std::setfill('0') << static_cast<int>(b);
+    sink += oss.str().size();
+  });
+  run("hex: hexEncode (32 bytes)", [&] { sink += hexEncode(digest).size(); });
+
+  return sink == 0;
+}
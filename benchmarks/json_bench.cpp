@@ -0,0 +1,163 @@
+#include "cppkit/json/json.hpp"
+#include "cppkit/json/json_lazy.hpp"
+#include "cppkit/json/json_parser.hpp"
+#include <chrono>
+#include <iostream>
+#include <iomanip>
+#if defined(__GLIBC__)
+#include <malloc.h>
+#endif
+
+using namespace cppkit::json;
+
+struct Item
+{
+    int64_t id{};
+    std::string name;
+    double price{};
+    std::vector<std::string> tags;
+};
+
+REFLECT(Item, FIELD(id), FIELD(name), FIELD(price), FIELD(tags))
+
+struct Order
+{
+    std::string orderId;
+    bool paid{};
+    std::vector<Item> items;
+    std::map<std::string, std::string> attrs;
+};
+
+REFLECT(Order, FIELD(orderId), FIELD(paid), FIELD(items), FIELD(attrs))
+
+struct Summary
+{
+    std::string orderId;
+    std::map<std::string, std::string> attrs;
+};
+
+REFLECT(Summary, FIELD(orderId), FIELD(attrs))
+
+static Order makeOrder()
+{
+    Order order{"ORD-2025-0001", true, {}, {{"channel", "web"}, {"note", "leave at \"front\" door\n"}}};
+    for (int i = 0; i < 32; ++i)
+    {
+        order.items.push_back({i, "item name number " + std::to_string(i), 19.99 + i * 0.37, {"red", "large", "sale"}});
+    }
+    return order;
+}
+
+// 执行 fn 直到耗时超过 minTime，返回每秒次数与吞吐
+template <typename Fn>
+static void run(const char* name, Fn&& fn)
+{
+    using Clock = std::chrono::steady_clock;
+    constexpr auto minTime = std::chrono::milliseconds(500);
+    size_t bytes = fn(); // warmup
+    size_t iterations = 0;
+    const auto start = Clock::now();
+    auto elapsed = Clock::duration::zero();
+    while (elapsed < minTime)
+    {
+        for (int i = 0; i < 64; ++i)
+            bytes = fn();
+        iterations += 64;
+        elapsed = Clock::now() - start;
+    }
+    const double seconds = std::chrono::duration<double>(elapsed).count();
+    std::cout << std::left << std::setw(32) << name
+        << std::right << std::setw(12) << std::fixed << std::setprecision(1) << iterations / seconds << " ops/s"
+        << std::setw(10) << std::setprecision(1) << static_cast<double>(bytes) * iterations / seconds / 1e6 << " MB/s"
+        << std::endl;
+}
+
+static size_t heapInUse()
+{
+#if defined(__GLIBC__)
+    return mallinfo2().uordblks;
+#else
+    return 0;
+#endif
+}
+
+// 解析一个较大的文档，报告解析吞吐以及解析结果占用的堆内存
+static void parseFootprint()
+{
+    std::string doc = "[";
+    for (int i = 0; i < 100000; ++i)
+    {
+        if (i)
+            doc += ',';
+        doc += R"({"id":)" + std::to_string(i) + R"(,"name":"user)" + std::to_string(i) +
+            R"(","score":)" + std::to_string(i * 0.5) + R"(,"active":true,"tags":["a","bb","ccc"]})";
+    }
+    doc += "]";
+
+    const auto start = std::chrono::steady_clock::now();
+    const size_t before = heapInUse();
+    const Json json = Json::parse(doc);
+    const size_t after = heapInUse();
+    const double seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+    std::cout << "parse " << doc.size() / 1e6 << " MB: " << std::fixed << std::setprecision(1)
+        << doc.size() / seconds / 1e6 << " MB/s, tree uses " << (after - before) / 1e6 << " MB heap ("
+        << std::setprecision(2) << static_cast<double>(after - before) / doc.size() << " bytes per input byte)"
+        << std::endl;
+}
+
+int main()
+{
+    parseFootprint();
+
+    // 只取大文档中 items 前后的少量字段：按需解析跳过 items，完整解析需要物化整棵树
+    Order big = makeOrder();
+    for (int i = 0; i < 5; ++i)
+        big.items.insert(big.items.end(), big.items.begin(), big.items.end());
+    const std::string bigDoc = stringify(big);
+    run("fromJson<Summary>(full parse)", [&]
+    {
+        Summary summary;
+        ReflectionParser::fromJson(Json::parse(bigDoc), summary);
+        return bigDoc.size();
+    });
+    run("fromJson<Summary>(lazy)", [&]
+    {
+        Summary summary;
+        ReflectionParser::fromJson(LazyDocument(bigDoc), summary);
+        return bigDoc.size();
+    });
+    run("LazyDocument::at_pointer", [&]
+    {
+        const LazyDocument doc(bigDoc);
+        return doc.at_pointer("/items/1000/price").asNumber() > 0 ? bigDoc.size() : 0;
+    });
+
+    const Order order = makeOrder();
+    const Json json(order);
+
+    std::string str;
+    OutputBuffer buffer;
+
+    run("Json::dump", [&] { return json.dump().size(); });
+    run("Json::dump(pretty)", [&] { return json.dump(true).size(); });
+    run("Json::dumpTo(OutputBuffer)", [&]
+    {
+        buffer.clear();
+        json.dumpTo(buffer);
+        return buffer.size();
+    });
+    run("stringify<Order>", [&] { return stringify(order).size(); });
+    run("stringifyTo(std::string)", [&]
+    {
+        str.clear();
+        stringifyTo(str, order);
+        return str.size();
+    });
+    run("stringifyTo(OutputBuffer)", [&]
+    {
+        buffer.clear();
+        stringifyTo(buffer, order);
+        return buffer.size();
+    });
+    return 0;
+}
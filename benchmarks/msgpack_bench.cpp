@@ -0,0 +1,99 @@
+#include "cppkit/msgpack/msgpack.hpp"
+#include "cppkit/json/json_parser.hpp"
+#include <chrono>
+#include <iomanip>
+#include <iostream>
+
+using namespace cppkit;
+
+struct Item
+{
+    int64_t id{};
+    std::string name;
+    double price{};
+    std::vector<std::string> tags;
+};
+
+REFLECT(Item, FIELD(id), FIELD(name), FIELD(price), FIELD(tags))
+
+struct Order
+{
+    std::string orderId;
+    bool paid{};
+    std::vector<Item> items;
+    std::map<std::string, std::string> attrs;
+};
+
+REFLECT(Order, FIELD(orderId), FIELD(paid), FIELD(items), FIELD(attrs))
+
+static Order makeOrder()
+{
+    Order order{"ORD-2025-0001", true, {}, {{"channel", "web"}, {"note", "leave at \"front\" door\n"}}};
+    for (int i = 0; i < 32; ++i)
+    {
+        order.items.push_back({i, "item name number " + std::to_string(i), 19.99 + i * 0.37, {"red", "large", "sale"}});
+    }
+    return order;
+}
+
+// 执行 fn 直到耗时超过 minTime，返回每秒次数与吞吐
+template <typename Fn>
+static void run(const char* name, Fn&& fn)
+{
+    using Clock = std::chrono::steady_clock;
+    constexpr auto minTime = std::chrono::milliseconds(500);
+    size_t bytes = fn(); // warmup
+    size_t iterations = 0;
+    const auto start = Clock::now();
+    auto elapsed = Clock::duration::zero();
+    while (elapsed < minTime)
+    {
+        for (int i = 0; i < 64; ++i)
+            bytes = fn();
+        iterations += 64;
+        elapsed = Clock::now() - start;
+    }
+    const double seconds = std::chrono::duration<double>(elapsed).count();
+    std::cout << std::left << std::setw(32) << name
+        << std::right << std::setw(12) << std::fixed << std::setprecision(1) << iterations / seconds << " ops/s"
+        << std::setw(10) << std::setprecision(1) << static_cast<double>(bytes) * iterations / seconds / 1e6 << " MB/s"
+        << std::endl;
+}
+
+int main()
+{
+    const Order order = makeOrder();
+    json::OutputBuffer buffer;
+    const std::string text = json::stringify(order);
+    const std::string packed = msgpack::encode(order);
+    std::cout << "payload: json " << text.size() << " bytes, msgpack " << packed.size() << " bytes" << std::endl;
+
+    run("json::stringifyTo", [&]
+    {
+        buffer.clear();
+        json::stringifyTo(buffer, order);
+        return buffer.size();
+    });
+    run("msgpack::encodeTo", [&]
+    {
+        buffer.clear();
+        msgpack::encodeTo(buffer, order);
+        return buffer.size();
+    });
+    run("json::fromJson<Order>", [&]
+    {
+        const auto decoded = json::fromJson<Order>(text);
+        return text.size();
+    });
+    run("msgpack::decode<Order>", [&]
+    {
+        const auto decoded = msgpack::decode<Order>(packed);
+        return packed.size();
+    });
+    run("msgpack::toJson", [&]
+    {
+        const auto decoded = msgpack::toJson(packed);
+        return packed.size();
+    });
+    return 0;
+}
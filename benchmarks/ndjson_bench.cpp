@@ -0,0 +1,68 @@
+#include "cppkit/json/ndjson.hpp"
+#include <chrono>
+#include <filesystem>
+#include <iomanip>
+#include <iostream>
+
+using namespace cppkit;
+using namespace cppkit::json;
+
+struct Event
+{
+    int64_t ts{};
+    std::string level;
+    std::string service;
+    std::string message;
+    std::vector<int> codes;
+    std::map<std::string, std::string> labels;
+};
+
+REFLECT(Event, FIELD(ts), FIELD(level), FIELD(service), FIELD(message), FIELD(codes), FIELD(labels))
+
+static void report(const char* name, const size_t bytes, const size_t docs, const double seconds)
+{
+    std::cout << std::left << std::setw(28) << name << std::right << std::fixed
+        << std::setw(10) << std::setprecision(1) << bytes / seconds / 1e6 << " MB/s"
+        << std::setw(14) << std::setprecision(0) << docs / seconds << " docs/s" << std::endl;
+}
+
+int main()
+{
+    using Clock = std::chrono::steady_clock;
+    const std::string path = (std::filesystem::temp_directory_path() / "cppkit_ndjson_bench.ndjson").string();
+    constexpr size_t kRecords = 400000;
+
+    // 写入
+    {
+        Event event{0, "info", "order-service", "", {200, 201, 304}, {{"region", "eu-west-1"}, {"pod", "api-7f9c"}}};
+        const auto start = Clock::now();
+        NdjsonWriter writer(path);
+        for (size_t i = 0; i < kRecords; ++i)
+        {
+            event.ts = 1700000000000 + static_cast<int64_t>(i);
+            event.message = "request " + std::to_string(i) + " handled in \"fast\" path";
+            writer.write(event);
+        }
+        writer.flush();
+        report("NdjsonWriter", writer.bytesWritten(), writer.records(),
+               std::chrono::duration<double>(Clock::now() - start).count());
+    }
+
+    // 读取：单线程与线程池
+    auto read = [&](const char* name, concurrency::ThreadPool* pool)
+    {
+        const auto start = Clock::now();
+        NdjsonReader reader(path, pool);
+        int64_t checksum = 0;
+        const size_t docs = reader.forEach([&](const Json& doc) { checksum += doc["ts"].asInt64(); });
+        report(name, reader.bytesRead(), docs, std::chrono::duration<double>(Clock::now() - start).count());
+        return checksum;
+    };
+    read("NdjsonReader(1 thread)", nullptr);
+    concurrency::ThreadPool pool;
+    const std::string name = "NdjsonReader(pool x" + std::to_string(pool.workerCount()) + ")";
+    read(name.c_str(), &pool);
+
+    std::filesystem::remove(path);
+    return 0;
+}
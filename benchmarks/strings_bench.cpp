@@ -0,0 +1,188 @@
+#include "cppkit/strings.hpp"
+#include <cctype>
+#include <chrono>
+#include <functional>
+#include <iomanip>
+#include <iostream>
+#include <random>
+
+using namespace cppkit;
+using Clock = std::chrono::steady_clock;
+
+// 改写之前逐字节、每次分配新字符串的实现，作为基准
+namespace legacy
+{
+    static std::string toLower(std::string s)
+    {
+        std::ranges::transform(s, s.begin(), [](const unsigned char c) { return std::tolower(c); });
+        return s;
+    }
+
+    static std::vector<std::string> split(const std::string_view s, const char delimiter)
+    {
+        std::vector<std::string> result;
+        size_t start = 0;
+        size_t end;
+        while ((end = s.find(delimiter, start)) != std::string::npos)
+        {
+            result.emplace_back(s.substr(start, end - start));
+            start = end + 1;
+        }
+        result.emplace_back(s.substr(start));
+        return result;
+    }
+
+    static std::string escapeHtml(const std::string_view s)
+    {
+        std::string result;
+        result.reserve(s.size());
+        for (const char c : s)
+        {
+            switch (c)
+            {
+            case '&': result.append("&amp;");
+                break;
+            case '<': result.append("&lt;");
+                break;
+            case '>': result.append("&gt;");
+                break;
+            case '"': result.append("&quot;");
+                break;
+            case '\'': result.append("&#39;");
+                break;
+            default: result.push_back(c);
+                break;
+            }
+        }
+        return result;
+    }
+
+    static std::string urlDecode(const std::string_view s)
+    {
+        const auto hex = [](const char c)
+        {
+            if (c >= '0' && c <= '9') return c - '0';
+            if (c >= 'a' && c <= 'f') return c - 'a' + 10;
+            if (c >= 'A' && c <= 'F') return c - 'A' + 10;
+            return -1;
+        };
+        std::string result;
+        result.reserve(s.size());
+        for (size_t i = 0; i < s.size(); ++i)
+        {
+            if (s[i] == '+')
+            {
+                result += ' ';
+            }
+            else if (s[i] == '%' && i + 2 < s.size() && hex(s[i + 1]) != -1 && hex(s[i + 2]) != -1)
+            {
+                result += static_cast<char>(hex(s[i + 1]) << 4 | hex(s[i + 2]));
+                i += 2;
+            }
+            else
+            {
+                result += s[i];
+            }
+        }
+        return result;
+    }
+}
+
+static size_t sink = 0;
+
+// 重复执行 op 直到处理满 totalBytes，返回 MB/s
+static double throughput(const size_t bytesPerOp, const std::function<void()>& op)
+{
+    constexpr size_t totalBytes = 256 * 1024 * 1024;
+    const size_t iterations = std::max<size_t>(1, totalBytes / bytesPerOp);
+    const auto start = Clock::now();
+    for (size_t i = 0; i < iterations; ++i)
+    {
+        op();
+    }
+    const double seconds = std::chrono::duration<double>(Clock::now() - start).count();
+    return static_cast<double>(iterations * bytesPerOp) / seconds / (1024 * 1024);
+}
+
+static void report(const std::string& name, const double before, const double after)
+{
+    std::cout << std::left << std::setw(36) << name << std::right << std::fixed << std::setprecision(0)
+        << std::setw(12) << before << std::setw(12) << after << std::setw(9) << std::setprecision(1)
+        << after / before << "x" << std::endl;
+}
+
+int main()
+{
+    std::mt19937 gen(7);
+    const auto randomText = [&](const size_t size, const std::string_view alphabet)
+    {
+        std::string s(size, ' ');
+        for (char& c : s)
+        {
+            c = alphabet[gen() % alphabet.size()];
+        }
+        return s;
+    };
+
+    const std::string header = randomText(4096, "abcdefghijklmnopqrstuvwxyzABCDEFGHIJKLMNOPQRSTUVWXYZ-: 0123456789");
+    const std::string headerName = "Sec-WebSocket-Extensions";
+    const std::string path = "/api/v1/users/12345/repositories/cppkit/branches/main/commits";
+    const std::string prose = randomText(4096, "abcdefghijklmnopqrstuvwxyz     ,.<>&");
+    const std::string query = randomText(4096, "abcdefghijklmnopqrstuvwxyz0123456789=&%+");
+
+    std::cout << std::left << std::setw(36) << "MB/s" << std::right << std::setw(12) << "before" << std::setw(12)
+        << "after" << std::endl;
+
+    report("toLower (4KB)",
+           throughput(header.size(), [&] { sink += legacy::toLower(header).size(); }),
+           throughput(header.size(), [&] { sink += toLower(header).size(); }));
+
+    std::string buffer;
+    report("appendLower into reused buffer (4KB)",
+           throughput(header.size(), [&] { sink += legacy::toLower(header).size(); }),
+           throughput(header.size(), [&]
+           {
+               buffer.clear();
+               appendLower(buffer, header);
+               sink += buffer.size();
+           }));
+
+    report("header name compare (toLower ==)",
+           throughput(headerName.size(), [&] { sink += legacy::toLower(headerName) == "sec-websocket-extensions"; }),
+           throughput(headerName.size(), [&] { sink += iequals(headerName, "sec-websocket-extensions"); }));
+
+    const std::string longName = header;
+    const std::string longNameLower = legacy::toLower(header);
+    report("iequals (4KB)",
+           throughput(longName.size(), [&] { sink += legacy::toLower(longName) == longNameLower; }),
+           throughput(longName.size(), [&] { sink += iequals(longName, longNameLower); }));
+
+    std::vector<std::string_view> parts;
+    report("split route path",
+           throughput(path.size(), [&] { sink += legacy::split(path, '/').size(); }),
+           throughput(path.size(), [&]
+           {
+               splitInto(path, '/', parts);
+               sink += parts.size();
+           }));
+
+    report("escapeHtml (4KB text)",
+           throughput(prose.size(), [&] { sink += legacy::escapeHtml(prose).size(); }),
+           throughput(prose.size(), [&] { sink += escapeHtml(prose).size(); }));
+
+    const std::string plain = randomText(4096, "abcdefghijklmnopqrstuvwxyz ");
+    report("escapeHtml (4KB, nothing to escape)",
+           throughput(plain.size(), [&] { sink += legacy::escapeHtml(plain).size(); }),
+           throughput(plain.size(), [&] { sink += escapeHtml(plain).size(); }));
+
+    report("urlDecode (4KB query)",
+           throughput(query.size(), [&] { sink += legacy::urlDecode(query).size(); }),
+           throughput(query.size(), [&] { sink += urlDecode(query).size(); }));
+
+    const std::string plainQuery = randomText(4096, "abcdefghijklmnopqrstuvwxyz0123456789=");
+    report("urlDecode (4KB, nothing to decode)",
+           throughput(plainQuery.size(), [&] { sink += legacy::urlDecode(plainQuery).size(); }),
+           throughput(plainQuery.size(), [&] { sink += urlDecode(plainQuery).size(); }));
+
+    return sink == 0;
+}
@@ -0,0 +1,83 @@
+#include "cppkit/crypto/crypto.hpp"
+#include "cppkit/testing/bench.hpp"
+#include <string>
+
+using namespace cppkit::bench;
+using namespace cppkit::crypto;
+
+namespace
+{
+    const std::string small(64, 'a');
+    const std::string large(64 * 1024, 'b');
+}
+
+BENCH(Crypto, Sha256_64B)
+{
+    for (auto _ : state)
+    {
+        auto digest = SHA256::shaBinary(std::string_view(small));
+        DoNotOptimize(digest);
+    }
+    state.SetBytesProcessed(state.Iterations() * small.size());
+}
+
+BENCH(Crypto, Sha256_64KB)
+{
+    for (auto _ : state)
+    {
+        auto digest = SHA256::shaBinary(std::string_view(large));
+        DoNotOptimize(digest);
+    }
+    state.SetBytesProcessed(state.Iterations() * large.size());
+}
+
+BENCH(Crypto, Sha1_64KB)
+{
+    for (auto _ : state)
+    {
+        auto digest = SHA1::shaBinary(std::string_view(large));
+        DoNotOptimize(digest);
+    }
+    state.SetBytesProcessed(state.Iterations() * large.size());
+}
+
+BENCH(Crypto, Md5_64KB)
+{
+    for (auto _ : state)
+    {
+        auto digest = MD5::hashBinary(large);
+        DoNotOptimize(digest);
+    }
+    state.SetBytesProcessed(state.Iterations() * large.size());
+}
+
+BENCH(Crypto, HmacSha256_64B)
+{
+    for (auto _ : state)
+    {
+        auto mac = SHA256::hmacBinary("secret-key", small);
+        DoNotOptimize(mac);
+    }
+    state.SetBytesProcessed(state.Iterations() * small.size());
+}
+
+BENCH(Crypto, Base64Encode_64KB)
+{
+    for (auto _ : state)
+    {
+        auto encoded = Base64::encode(std::string_view(large));
+        DoNotOptimize(encoded);
+    }
+    state.SetBytesProcessed(state.Iterations() * large.size());
+}
+
+BENCH(Crypto, Base64Decode_64KB)
+{
+    const std::string encoded = Base64::encode(std::string_view(large));
+    for (auto _ : state)
+    {
+        auto decoded = Base64::decode(encoded);
+        DoNotOptimize(decoded);
+    }
+    state.SetBytesProcessed(state.Iterations() * encoded.size());
+}
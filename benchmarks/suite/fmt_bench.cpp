@@ -0,0 +1,160 @@
+#include "cppkit/fmt.hpp"
+#include "cppkit/testing/bench.hpp"
+#include <cstdio>
+#include <sstream>
+#include <string>
+#include <version>
+#if defined(__cpp_lib_format)
+#include <format>
+#endif
+
+using namespace cppkit::bench;
+
+// 改写之前的实现：运行期逐字节扫描格式串，参数经 std::ostringstream 写出
+namespace legacy
+{
+    inline void formatImpl(std::ostringstream& oss, const char* fmt)
+    {
+        while (*fmt)
+        {
+            if ((fmt[0] == '{' && fmt[1] == '{') || (fmt[0] == '}' && fmt[1] == '}'))
+            {
+                oss << *fmt;
+                fmt += 2;
+                continue;
+            }
+            oss << *fmt++;
+        }
+    }
+
+    template <typename T, typename... Args>
+    void formatImpl(std::ostringstream& oss, const char* fmt, const T& arg, const Args&... args)
+    {
+        while (*fmt)
+        {
+            if ((fmt[0] == '{' && fmt[1] == '{') || (fmt[0] == '}' && fmt[1] == '}'))
+            {
+                oss << *fmt;
+                fmt += 2;
+                continue;
+            }
+            if (fmt[0] == '{' && fmt[1] == '}')
+            {
+                oss << arg;
+                formatImpl(oss, fmt + 2, args...);
+                return;
+            }
+            oss << *fmt++;
+        }
+    }
+
+    template <typename... Args>
+    std::string format(const char* fmt, const Args&... args)
+    {
+        std::ostringstream oss;
+        formatImpl(oss, fmt, args...);
+        return oss.str();
+    }
+}
+
+namespace
+{
+    const std::string method = "GET";
+    const std::string path = "/api/v1/users/12345";
+    int status = 200;
+    double millis = 3.14159;
+    uint64_t bytes = 1234567;
+}
+
+// 典型访问日志行："{} {} -> {} in {}ms ({} bytes)"
+BENCH(Fmt, LegacyOstringstream)
+{
+    for (auto _ : state)
+    {
+        auto s = legacy::format("{} {} -> {} in {}ms ({} bytes)", method, path, status, millis, bytes);
+        DoNotOptimize(s);
+    }
+}
+
+BENCH(Fmt, Snprintf)
+{
+    char buf[256];
+    for (auto _ : state)
+    {
+        const int n = std::snprintf(buf, sizeof(buf), "%s %s -> %d in %gms (%llu bytes)", method.c_str(),
+                                    path.c_str(), status, millis, static_cast<unsigned long long>(bytes));
+        DoNotOptimize(n);
+        ClobberMemory();
+    }
+}
+
+#if defined(__cpp_lib_format)
+BENCH(Fmt, StdFormat)
+{
+    for (auto _ : state)
+    {
+        auto s = std::format("{} {} -> {} in {}ms ({} bytes)", method, path, status, millis, bytes);
+        DoNotOptimize(s);
+    }
+}
+#endif
+
+// 运行期格式串
+BENCH(Fmt, Format)
+{
+    for (auto _ : state)
+    {
+        auto s = cppkit::format("{} {} -> {} in {}ms ({} bytes)", method, path, status, millis, bytes);
+        DoNotOptimize(s);
+    }
+}
+
+// 编译期切分格式串
+BENCH(Fmt, Sprintf)
+{
+    for (auto _ : state)
+    {
+        auto s = cppkit::sprintf("{} {} -> {} in {}ms ({} bytes)", method, path, status, millis, bytes);
+        DoNotOptimize(s);
+    }
+}
+
+// 复用 FixedBuffer，不分配内存
+BENCH(Fmt, FormatToFixedBuffer)
+{
+    cppkit::FixedBuffer<> buffer;
+    for (auto _ : state)
+    {
+        buffer.clear();
+        cppkit::formatTo<"{} {} -> {} in {}ms ({} bytes)">(buffer, method, path, status, millis, bytes);
+        DoNotOptimize(buffer);
+    }
+}
+
+// 只有一个参数的短格式串："id={}"
+BENCH(Fmt, ShortLegacyOstringstream)
+{
+    for (auto _ : state)
+    {
+        auto s = legacy::format("id={}", ++status);
+        DoNotOptimize(s);
+    }
+}
+
+BENCH(Fmt, ShortFormat)
+{
+    for (auto _ : state)
+    {
+        auto s = cppkit::format("id={}", ++status);
+        DoNotOptimize(s);
+    }
+}
+
+BENCH(Fmt, ShortSprintf)
+{
+    for (auto _ : state)
+    {
+        auto s = cppkit::sprintf("id={}", ++status);
+        DoNotOptimize(s);
+    }
+}
@@ -0,0 +1,61 @@
+#include "cppkit/http/server/http_request.hpp"
+#include "cppkit/testing/bench.hpp"
+#include <string>
+
+using namespace cppkit::bench;
+using cppkit::http::server::HttpRequest;
+
+namespace
+{
+    // 浏览器发出的典型 GET 请求头
+    const std::string browserRequest =
+        "GET /api/v1/users/12345/repositories?page=2&per_page=50&sort=updated%20at HTTP/1.1\r\n"
+        "Host: api.example.com\r\n"
+        "User-Agent: Mozilla/5.0 (X11; Linux x86_64) AppleWebKit/537.36 (KHTML, like Gecko) Chrome/120.0 Safari/537.36\r\n"
+        "Accept: text/html,application/xhtml+xml,application/xml;q=0.9,image/avif,image/webp,*/*;q=0.8\r\n"
+        "Accept-Language: en-US,en;q=0.9,zh-CN;q=0.8\r\n"
+        "Accept-Encoding: gzip, deflate, br\r\n"
+        "Cookie: session=0123456789abcdef0123456789abcdef; theme=dark; tz=Asia%2FShanghai\r\n"
+        "Connection: keep-alive\r\n"
+        "Cache-Control: max-age=0\r\n"
+        "\r\n";
+
+    // 内部服务之间的最小请求
+    const std::string minimalRequest =
+        "GET /healthz HTTP/1.1\r\n"
+        "Host: localhost\r\n"
+        "\r\n";
+}
+
+BENCH(HttpParser, BrowserRequest)
+{
+    for (auto _ : state)
+    {
+        HttpRequest request = HttpRequest::parse(-1, browserRequest, "");
+        DoNotOptimize(request);
+    }
+    state.SetBytesProcessed(state.Iterations() * browserRequest.size());
+}
+
+BENCH(HttpParser, MinimalRequest)
+{
+    for (auto _ : state)
+    {
+        HttpRequest request = HttpRequest::parse(-1, minimalRequest, "");
+        DoNotOptimize(request);
+    }
+    state.SetBytesProcessed(state.Iterations() * minimalRequest.size());
+}
+
+BENCH(HttpParser, ParseAndReadHeaders)
+{
+    for (auto _ : state)
+    {
+        const HttpRequest request = HttpRequest::parse(-1, browserRequest, "");
+        auto host = request.getHeader("Host");
+        auto page = request.getQuery("page");
+        DoNotOptimize(host);
+        DoNotOptimize(page);
+    }
+    state.SetBytesProcessed(state.Iterations() * browserRequest.size());
+}
@@ -0,0 +1,63 @@
+#include "cppkit/json/json.hpp"
+#include "cppkit/testing/bench.hpp"
+#include <string>
+
+using namespace cppkit::bench;
+using cppkit::json::Json;
+
+namespace
+{
+    // 一个典型的 API 响应：对象数组，带字符串、数字、布尔和嵌套数组
+    std::string makeDocument()
+    {
+        std::string s = "{\"total\":64,\"items\":[";
+        for (int i = 0; i < 64; ++i)
+        {
+            if (i > 0)
+            {
+                s += ",";
+            }
+            s += "{\"id\":" + std::to_string(i) + ",\"name\":\"item name number " + std::to_string(i) +
+                "\",\"price\":" + std::to_string(19.99 + i * 0.37) +
+                ",\"active\":true,\"tags\":[\"red\",\"large\",\"sale\"],\"note\":\"line\\nbreak \\\"quoted\\\"\"}";
+        }
+        s += "]}";
+        return s;
+    }
+
+    const std::string document = makeDocument();
+}
+
+BENCH(Json, Parse)
+{
+    for (auto _ : state)
+    {
+        Json json = Json::parse(document);
+        DoNotOptimize(json);
+    }
+    state.SetBytesProcessed(state.Iterations() * document.size());
+}
+
+BENCH(Json, Dump)
+{
+    const Json json = Json::parse(document);
+    size_t bytes = 0;
+    for (auto _ : state)
+    {
+        std::string out = json.dump();
+        bytes += out.size();
+        DoNotOptimize(out);
+    }
+    state.SetBytesProcessed(bytes);
+}
+
+BENCH(Json, ParseAndLookup)
+{
+    for (auto _ : state)
+    {
+        const Json json = Json::parse(document);
+        auto name = json["items"][size_t{32}]["name"].asString();
+        DoNotOptimize(name);
+    }
+    state.SetBytesProcessed(state.Iterations() * document.size());
+}
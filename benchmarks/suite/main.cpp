@@ -0,0 +1,7 @@
+#include "cppkit/testing/bench.hpp"
+
+// 各 *_bench.cpp 通过 BENCH 注册，链接进同一个 cppkit_bench 可执行文件
+int main(const int argc, char** argv)
+{
+    return cppkit::bench::RunAllBenchmarks(argc, argv);
+}
@@ -0,0 +1,83 @@
+#include "cppkit/memory_pool.hpp"
+#include "cppkit/testing/bench.hpp"
+#include <memory>
+#include <mutex>
+#include <vector>
+
+using namespace cppkit::bench;
+
+namespace
+{
+    struct Node
+    {
+        int64_t key;
+        int64_t value;
+        Node* next;
+    };
+
+    constexpr size_t BATCH = 256;
+}
+
+BENCH(MemoryPool, CreateDestroy)
+{
+    cppkit::MemoryPool<Node> pool;
+    for (auto _ : state)
+    {
+        Node* node = pool.create(1, 2, nullptr);
+        DoNotOptimize(node);
+        pool.destroy(node);
+    }
+    state.SetItemsProcessed(state.Iterations());
+}
+
+// 每轮分配一批再全部释放，空闲链表不会一直命中同一个节点
+BENCH(MemoryPool, Batch256)
+{
+    cppkit::MemoryPool<Node> pool;
+    std::vector<Node*> nodes(BATCH);
+    for (auto _ : state)
+    {
+        for (size_t i = 0; i < BATCH; ++i)
+        {
+            nodes[i] = pool.create(static_cast<int64_t>(i), 0, nullptr);
+        }
+        ClobberMemory();
+        for (Node* node : nodes)
+        {
+            pool.destroy(node);
+        }
+    }
+    state.SetItemsProcessed(state.Iterations() * BATCH);
+}
+
+// 同样的分配模式走 new/delete，作为对照
+BENCH(MemoryPool, Batch256NewDelete)
+{
+    std::vector<Node*> nodes(BATCH);
+    for (auto _ : state)
+    {
+        for (size_t i = 0; i < BATCH; ++i)
+        {
+            nodes[i] = new Node{static_cast<int64_t>(i), 0, nullptr};
+        }
+        ClobberMemory();
+        for (Node* node : nodes)
+        {
+            delete node;
+        }
+    }
+    state.SetItemsProcessed(state.Iterations() * BATCH);
+}
+
+static cppkit::MemoryPool<Node, 1024, cppkit::SpinLock> sharedPool;
+
+BENCH_THREADS(MemoryPool, SpinLockShared, 0)
+{
+    for (auto _ : state)
+    {
+        Node* node = sharedPool.create(1, 2, nullptr);
+        DoNotOptimize(node);
+        sharedPool.destroy(node);
+    }
+    state.SetItemsProcessed(state.Iterations());
+}
@@ -0,0 +1,81 @@
+#include "cppkit/metrics/metrics.hpp"
+#include "cppkit/testing/bench.hpp"
+#include <atomic>
+
+using namespace cppkit::bench;
+using namespace cppkit::metrics;
+
+namespace
+{
+    // 多线程基准共享同一个实例，衡量争用
+    std::atomic<uint64_t> shared{0};
+    Counter counter;
+    Histogram histogram;
+}
+
+// 对照：所有线程争用同一个原子变量
+BENCH(Metrics, AtomicFetchAdd)
+{
+    for (auto _ : state)
+    {
+        shared.fetch_add(1, std::memory_order_relaxed);
+    }
+    state.SetItemsProcessed(state.Iterations());
+}
+
+BENCH_THREADS(Metrics, AtomicFetchAddShared, 0)
+{
+    for (auto _ : state)
+    {
+        shared.fetch_add(1, std::memory_order_relaxed);
+    }
+    state.SetItemsProcessed(state.Iterations());
+}
+
+BENCH(Metrics, CounterInc)
+{
+    for (auto _ : state)
+    {
+        counter.inc();
+    }
+    state.SetItemsProcessed(state.Iterations());
+}
+
+BENCH_THREADS(Metrics, CounterIncShared, 0)
+{
+    for (auto _ : state)
+    {
+        counter.inc();
+    }
+    state.SetItemsProcessed(state.Iterations());
+}
+
+// 宏展开后经过函数内静态引用查找
+BENCH(Metrics, CounterIncMacro)
+{
+    for (auto _ : state)
+    {
+        CK_COUNTER_INC("bench_total", "Benchmark counter");
+    }
+    state.SetItemsProcessed(state.Iterations());
+}
+
+BENCH(Metrics, HistogramRecord)
+{
+    uint64_t value = 0;
+    for (auto _ : state)
+    {
+        histogram.record(value += 37);
+    }
+    state.SetItemsProcessed(state.Iterations());
+}
+
+BENCH_THREADS(Metrics, HistogramRecordShared, 0)
+{
+    uint64_t value = state.ThreadIndex();
+    for (auto _ : state)
+    {
+        histogram.record(value += 37);
+    }
+    state.SetItemsProcessed(state.Iterations());
+}
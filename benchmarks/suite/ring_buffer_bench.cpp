@@ -0,0 +1,51 @@
+#include "cppkit/concurrency/ring_buffer.hpp"
+#include "cppkit/testing/bench.hpp"
+#include <string>
+
+using namespace cppkit::bench;
+using cppkit::concurrency::RingBuffer;
+
+BENCH(RingBuffer, PushPop)
+{
+    RingBuffer<int, 1024> queue;
+    int value = 0;
+    for (auto _ : state)
+    {
+        queue.push(value);
+        queue.pop(value);
+        DoNotOptimize(value);
+    }
+    state.SetItemsProcessed(state.Iterations());
+}
+
+BENCH(RingBuffer, PushPopString)
+{
+    RingBuffer<std::string, 1024> queue;
+    std::string line(96, 'x');
+    for (auto _ : state)
+    {
+        queue.push(std::move(line));
+        queue.pop(line);
+        DoNotOptimize(line);
+    }
+    state.SetItemsProcessed(state.Iterations());
+}
+
+// 多个线程同时向同一个队列推入再弹出，衡量 CAS 争用
+static RingBuffer<int, 4096> sharedQueue;
+
+BENCH_THREADS(RingBuffer, SharedPushPop, 0)
+{
+    int value = state.ThreadIndex();
+    for (auto _ : state)
+    {
+        while (!sharedQueue.push(value))
+        {
+        }
+        while (!sharedQueue.pop(value))
+        {
+        }
+        DoNotOptimize(value);
+    }
+    state.SetItemsProcessed(state.Iterations());
+}
@@ -0,0 +1,90 @@
+#include "cppkit/http/server/http_router.hpp"
+#include "cppkit/testing/bench.hpp"
+#include <string>
+#include <unordered_map>
+
+using namespace cppkit::bench;
+using cppkit::http::HttpMethod;
+using namespace cppkit::http::server;
+
+namespace
+{
+    // 一组接近真实服务的路由：静态路径、带参数的路径和通配
+    Router makeRouter()
+    {
+        Router router;
+        const HttpHandler handler = [](const HttpRequest&, HttpResponseWriter&) {};
+        for (const char* resource : {"users", "orders", "products", "invoices", "sessions", "reports"})
+        {
+            const std::string base = std::string("/api/v1/") + resource;
+            router.addRoute(HttpMethod::Get, base, handler);
+            router.addRoute(HttpMethod::Post, base, handler);
+            router.addRoute(HttpMethod::Get, base + "/:id", handler);
+            router.addRoute(HttpMethod::Put, base + "/:id", handler);
+            router.addRoute(HttpMethod::Get, base + "/:id/history", handler);
+        }
+        router.addRoute(HttpMethod::Get, "/static/*", handler);
+        router.addRoute(HttpMethod::Get, "/healthz", handler);
+        return router;
+    }
+
+    // 路由表依赖其他编译单元的静态变量，首次使用时再构建，避免静态初始化顺序问题
+    const Router& router()
+    {
+        static const Router instance = makeRouter();
+        return instance;
+    }
+
+    const std::string staticPath = "/api/v1/products";
+    const std::string paramPath = "/api/v1/orders/12345/history";
+    const std::string wildcardPath = "/static/css/site/main.css";
+    const std::string missingPath = "/api/v2/unknown/path";
+}
+
+BENCH(Router, StaticPath)
+{
+    std::unordered_map<std::string, std::string> params;
+    for (auto _ : state)
+    {
+        params.clear();
+        auto handler = router().find(HttpMethod::Get, staticPath, params);
+        DoNotOptimize(handler);
+    }
+    state.SetItemsProcessed(state.Iterations());
+}
+
+BENCH(Router, ParamPath)
+{
+    std::unordered_map<std::string, std::string> params;
+    for (auto _ : state)
+    {
+        params.clear();
+        auto handler = router().find(HttpMethod::Get, paramPath, params);
+        DoNotOptimize(handler);
+    }
+    state.SetItemsProcessed(state.Iterations());
+}
+
+BENCH(Router, Wildcard)
+{
+    std::unordered_map<std::string, std::string> params;
+    for (auto _ : state)
+    {
+        params.clear();
+        auto handler = router().find(HttpMethod::Get, wildcardPath, params);
+        DoNotOptimize(handler);
+    }
+    state.SetItemsProcessed(state.Iterations());
+}
+
+BENCH(Router, NotFound)
+{
+    std::unordered_map<std::string, std::string> params;
+    for (auto _ : state)
+    {
+        params.clear();
+        auto handler = router().find(HttpMethod::Delete, missingPath, params);
+        DoNotOptimize(handler);
+    }
+    state.SetItemsProcessed(state.Iterations());
+}
@@ -0,0 +1,40 @@
+#include "cppkit/concurrency/thread_pool.hpp"
+#include "cppkit/testing/bench.hpp"
+#include <vector>
+
+using namespace cppkit::bench;
+using cppkit::concurrency::ThreadPool;
+
+// 提交一个任务并等待结果：一次完整的跨线程往返
+BENCH(ThreadPool, EnqueueWait)
+{
+    ThreadPool pool(2);
+    for (auto _ : state)
+    {
+        auto result = pool.enqueue([] { return 1; }).get();
+        DoNotOptimize(result);
+    }
+    state.SetItemsProcessed(state.Iterations());
+}
+
+// 批量提交后统一等待，衡量队列吞吐
+BENCH(ThreadPool, EnqueueBatch64)
+{
+    constexpr size_t batch = 64;
+    ThreadPool pool(std::max(2u, std::thread::hardware_concurrency()));
+    std::vector<std::future<int>> futures;
+    futures.reserve(batch);
+    for (auto _ : state)
+    {
+        futures.clear();
+        for (size_t i = 0; i < batch; ++i)
+        {
+            futures.push_back(pool.enqueue([i] { return static_cast<int>(i); }));
+        }
+        for (auto& f : futures)
+        {
+            DoNotOptimize(f.get());
+        }
+    }
+    state.SetItemsProcessed(state.Iterations() * batch);
+}
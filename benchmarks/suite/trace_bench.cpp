@@ -0,0 +1,77 @@
+#include "cppkit/trace/trace.hpp"
+#include "cppkit/testing/bench.hpp"
+
+using namespace cppkit::bench;
+using namespace cppkit;
+
+// 关闭时的开销应只剩一次分支判断
+BENCH(Trace, SpanDisabled)
+{
+    trace::setEnabled(false);
+    for (auto _ : state)
+    {
+        trace::Span span("bench");
+        ClobberMemory();
+    }
+}
+
+BENCH(Trace, SpanRoot)
+{
+    trace::setEnabled(true);
+    for (auto _ : state)
+    {
+        trace::Span span("bench");
+        ClobberMemory();
+    }
+    trace::setEnabled(false);
+    trace::collect();
+}
+
+BENCH(Trace, SpanChild)
+{
+    trace::setEnabled(true);
+    {
+        trace::Span root("root");
+        for (auto _ : state)
+        {
+            trace::Span span("bench");
+            ClobberMemory();
+        }
+    }
+    trace::setEnabled(false);
+    trace::collect();
+}
+
+BENCH(Trace, Traceparent)
+{
+    trace::setEnabled(true);
+    {
+        trace::Span root("root");
+        for (auto _ : state)
+        {
+            auto header = trace::current().traceparent();
+            DoNotOptimize(header);
+        }
+    }
+    trace::setEnabled(false);
+    trace::collect();
+}
+
+// 取出写满的线程缓冲区
+BENCH(Trace, CollectFullBuffer)
+{
+    trace::setEnabled(true);
+    for (auto _ : state)
+    {
+        state.PauseTiming();
+        for (size_t i = 0; i < trace::DEFAULT_BUFFER_CAPACITY; ++i)
+        {
+            trace::Span span("bench");
+        }
+        state.ResumeTiming();
+        auto spans = trace::collect();
+        DoNotOptimize(spans);
+    }
+    trace::setEnabled(false);
+    state.SetItemsProcessed(state.Iterations() * trace::DEFAULT_BUFFER_CAPACITY);
+}
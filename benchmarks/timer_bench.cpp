@@ -0,0 +1,194 @@
+#include "cppkit/timer.hpp"
+#include <algorithm>
+#include <iomanip>
+#include <iostream>
+#include <list>
+#include <random>
+#include <sys/resource.h>
+#include <unordered_map>
+
+using namespace cppkit;
+using namespace std::chrono_literals;
+using Clock = std::chrono::steady_clock;
+
+// 旧实现的插入、取消路径与固定 tick 的工作线程：全局锁、每个任务一个 shared_ptr 节点加链表节点
+class LegacyTimer
+{
+  struct Node
+  {
+    TimerId id;
+    std::function<void()> callback;
+    size_t rounds;
+    bool canceled = false;
+  };
+
+public:
+  explicit LegacyTimer(const std::chrono::milliseconds tick) : tick_(tick), slots_(512)
+  {
+    worker_ = std::thread([this]
+    {
+      while (running_)
+      {
+        {
+          std::lock_guard lock(mutex_);
+          auto& slot = slots_[current_];
+          for (auto it = slot.begin(); it != slot.end();)
+          {
+            if ((*it)->canceled || (*it)->rounds == 0)
+            {
+              if (!(*it)->canceled)
+                (*it)->callback();
+              map_.erase((*it)->id);
+              it = slot.erase(it);
+            }
+            else
+            {
+              --(*it)->rounds;
+              ++it;
+            }
+          }
+          current_ = (current_ + 1) % slots_.size();
+        }
+        std::this_thread::sleep_for(tick_);
+      }
+    });
+  }
+
+  ~LegacyTimer()
+  {
+    running_ = false;
+    worker_.join();
+  }
+
+  TimerId setTimeout(const std::chrono::milliseconds delay, std::function<void()> task)
+  {
+    std::lock_guard lock(mutex_);
+    const TimerId id = nextId_++;
+    const size_t ticks = std::max<size_t>(delay / tick_, 1);
+    auto node = std::make_shared<Node>(id, std::move(task), ticks / slots_.size());
+    slots_[(current_ + ticks) % slots_.size()].push_back(node);
+    map_[id] = node;
+    return id;
+  }
+
+  void cancel(const TimerId id)
+  {
+    std::lock_guard lock(mutex_);
+    if (const auto it = map_.find(id); it != map_.end())
+    {
+      if (const auto node = it->second.lock())
+        node->canceled = true;
+      map_.erase(it);
+    }
+  }
+
+private:
+  std::chrono::milliseconds tick_;
+  std::vector<std::list<std::shared_ptr<Node>>> slots_;
+  size_t current_ = 0;
+  std::atomic<bool> running_ = true;
+  std::thread worker_;
+  std::mutex mutex_;
+  TimerId nextId_ = 1;
+  std::unordered_map<TimerId, std::weak_ptr<Node>> map_;
+};
+
+// 每个线程反复添加 8 个远期任务再全部取消，返回每秒完成的添加加取消次数
+template <typename T>
+static double insertCancel(T& timer, const size_t threads)
+{
+  constexpr size_t perThread = 200000;
+  std::vector<std::thread> workers;
+  const auto start = Clock::now();
+  for (size_t t = 0; t < threads; ++t)
+  {
+    workers.emplace_back([&timer]
+    {
+      TimerId ids[8];
+      for (size_t i = 0; i < perThread; i += 8)
+      {
+        for (size_t j = 0; j < 8; ++j)
+          ids[j] = timer.setTimeout(std::chrono::milliseconds(10000 + (i + j) % 5000), [] {});
+        for (const TimerId id : ids)
+          (void) timer.cancel(id);
+      }
+    });
+  }
+  for (auto& worker : workers)
+    worker.join();
+  return static_cast<double>(perThread * threads) / std::chrono::duration<double>(Clock::now() - start).count();
+}
+
+static double cpuSeconds()
+{
+  rusage usage{};
+  getrusage(RUSAGE_SELF, &usage);
+  return static_cast<double>(usage.ru_utime.tv_sec + usage.ru_stime.tv_sec) +
+      static_cast<double>(usage.ru_utime.tv_usec + usage.ru_stime.tv_usec) / 1e6;
+}
+
+int main()
+{
+  std::cout << std::left << std::setw(10) << "threads" << std::right << std::setw(22) << "legacy (ops/s)"
+      << std::setw(22) << "wheel (ops/s)" << std::endl;
+  for (const size_t threads : {size_t{1}, size_t{8}, size_t{32}})
+  {
+    double legacy;
+    double wheel;
+    {
+      LegacyTimer timer(1ms);
+      legacy = insertCancel(timer, threads);
+    }
+    {
+      Timer timer;
+      wheel = insertCancel(timer, threads);
+    }
+    std::cout << std::left << std::setw(10) << threads << std::right << std::fixed << std::setprecision(0)
+        << std::setw(22) << legacy << std::setw(22) << wheel << std::endl;
+  }
+
+  // 触发精度：随机 1~50ms 的任务，统计实际触发时间晚了多少
+  {
+    Timer timer;
+    constexpr size_t count = 2000;
+    std::mutex mutex;
+    std::vector<double> lateUs;
+    std::mt19937 gen(7);
+    std::uniform_int_distribution<int> delayUs(1000, 50000);
+    for (size_t i = 0; i < count; ++i)
+    {
+      const auto delay = std::chrono::microseconds(delayUs(gen));
+      const auto due = Clock::now() + delay;
+      (void) timer.setTimeout(delay, [&mutex, &lateUs, due]
+      {
+        const double late = std::chrono::duration<double, std::micro>(Clock::now() - due).count();
+        std::lock_guard lock(mutex);
+        lateUs.push_back(late);
+      });
+    }
+    std::this_thread::sleep_for(100ms);
+    std::lock_guard lock(mutex);
+    std::ranges::sort(lateUs);
+    std::cout << "\nwheel lateness (tick 100us, " << lateUs.size() << " timers): min " << std::setprecision(1)
+        << lateUs.front() << "us  p50 " << lateUs[lateUs.size() / 2] << "us  p99 " << lateUs[lateUs.size() * 99 / 100]
+        << "us  max " << lateUs.back() << "us" << std::endl;
+  }
+
+  // 空闲开销：只有一个 10 秒后的任务时，1 秒内消耗的 CPU
+  std::cout << "\nidle cpu for 1s with one timer pending:" << std::endl;
+  {
+    LegacyTimer timer(1ms);
+    (void) timer.setTimeout(10s, [] {});
+    const double start = cpuSeconds();
+    std::this_thread::sleep_for(1s);
+    std::cout << "  legacy (tick 1ms)    " << std::setprecision(2) << (cpuSeconds() - start) * 1e3 << " ms" << std::endl;
+  }
+  {
+    Timer timer;
+    (void) timer.setTimeout(10s, [] {});
+    const double start = cpuSeconds();
+    std::this_thread::sleep_for(1s);
+    std::cout << "  wheel  (tick 100us)  " << (cpuSeconds() - start) * 1e3 << " ms" << std::endl;
+  }
+  return 0;
+}
@@ -0,0 +1,97 @@
+#include "cppkit/websocket/frame.hpp"
+#include "cppkit/random.hpp"
+#include <chrono>
+#include <iomanip>
+#include <iostream>
+
+using namespace cppkit::websocket;
+
+// 旧实现：负载拷贝进新 vector，按 i % 4 逐字节去掩码
+static size_t legacyParse(std::span<const uint8_t> data, std::vector<uint8_t>& payload)
+{
+  size_t offset = 2;
+  uint64_t length = data[1] & 0x7F;
+  if (length == 126)
+  {
+    length = (data[2] << 8) | data[3];
+    offset += 2;
+  }
+  uint8_t key[4];
+  std::memcpy(key, &data[offset], 4);
+  offset += 4;
+  payload.resize(length);
+  std::memcpy(payload.data(), &data[offset], length);
+  for (uint64_t i = 0; i < length; ++i)
+    payload[i] ^= key[i % 4];
+  return offset + length;
+}
+
+// 旧实现：每个掩码字节调用一次 Random::nextInt，负载拷贝两次
+static std::vector<uint8_t> legacyBuild(const std::vector<uint8_t>& payload)
+{
+  std::vector<uint8_t> frame;
+  std::vector<uint8_t> masked = payload;
+  frame.push_back(0x82);
+  frame.push_back(0x80 | 126);
+  frame.push_back(static_cast<uint8_t>(payload.size() >> 8));
+  frame.push_back(static_cast<uint8_t>(payload.size()));
+  std::vector<uint8_t> key(4);
+  for (auto& k : key)
+    k = static_cast<uint8_t>(cppkit::Random::nextInt(0, 255));
+  frame.insert(frame.end(), key.begin(), key.end());
+  for (size_t i = 0; i < masked.size(); ++i)
+    masked[i] ^= key[i % 4];
+  frame.insert(frame.end(), masked.begin(), masked.end());
+  return frame;
+}
+
+template <typename Fn>
+static void run(const std::string& name, const size_t bytesPerCall, Fn&& fn)
+{
+  using Clock = std::chrono::steady_clock;
+  const size_t iterations = std::max<size_t>(1, (256u << 20) / bytesPerCall);
+  for (size_t i = 0; i < iterations / 16 + 1; ++i)
+    fn();
+  const auto start = Clock::now();
+  for (size_t i = 0; i < iterations; ++i)
+    fn();
+  const double seconds = std::chrono::duration<double>(Clock::now() - start).count();
+  std::cout << std::left << std::setw(28) << name << std::right << std::fixed << std::setprecision(2)
+      << std::setw(10) << iterations / seconds / 1e6 << " M msg/s" << std::setw(10)
+      << static_cast<double>(bytesPerCall) * iterations / seconds / 1e9 << " GB/s" << std::endl;
+}
+
+int main()
+{
+  for (const size_t size : {size_t{128}, size_t{1024}, size_t{16384}})
+  {
+    const std::vector<uint8_t> payload(size, 'x');
+    const std::string suffix = "/" + std::to_string(size);
+    const auto wire = buildFrame(payload, MessageType::BINARY, true, true);
+    size_t sink = 0;
+
+    std::vector<uint8_t> copied;
+    run("parse/legacy" + suffix, size, [&] { sink += legacyParse(wire, copied); });
+    // 原地去掩码会改写缓冲区，再次解析前恢复成掩码状态
+    auto buffer = wire;
+    run("parse/view" + suffix, size, [&]
+    {
+      Frame frame{};
+      sink += parseFrame(buffer, frame);
+      maskPayload(frame.payload.data(), frame.payload.data(), frame.payload.size(), frame.maskingKey);
+    });
+
+    run("build-masked/legacy" + suffix, size, [&] { sink += legacyBuild(payload).size(); });
+    run("build-masked/buildFrame" + suffix, size, [&]
+    {
+      sink += buildFrame(payload, MessageType::BINARY, true, true).size();
+    });
+    run("header-only (writev)" + suffix, size, [&]
+    {
+      sink += makeFrameHeader(payload.size(), MessageType::BINARY).size;
+    });
+    if (sink == 0)
+      return 1;
+  }
+  return 0;
+}
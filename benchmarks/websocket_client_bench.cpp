@@ -0,0 +1,176 @@
+#include "cppkit/websocket/client.hpp"
+#include "cppkit/websocket/server.hpp"
+#include <atomic>
+#include <chrono>
+#include <iomanip>
+#include <iostream>
+#include <sys/resource.h>
+#include <thread>
+
+using namespace cppkit::websocket;
+using Clock = std::chrono::steady_clock;
+
+// 回显服务器跑在独立线程，收到 "stop" 时退出
+static void runEchoServer(const uint16_t port, std::atomic<bool>& ready)
+{
+  WebSocketServer server("127.0.0.1", port);
+  server.setOnConnect([&ready](const cppkit::http::server::HttpRequest&, const ConnInfo&)
+  {
+    ready = true;
+  });
+  server.setOnMessage([&server](const ConnInfo& conn, const std::span<const uint8_t> data, const MessageType type)
+  {
+    if (std::string_view(reinterpret_cast<const char*>(data.data()), data.size()) == "stop")
+      server.stop();
+    else
+      (void) server.send(conn, data, type);
+  });
+  server.start();
+}
+
+static double seconds(const Clock::time_point start)
+{
+  return std::chrono::duration<double>(Clock::now() - start).count();
+}
+
+// 阻塞模式：逐个连接，每个连接都要等完整的一次握手往返
+static double blockingHandshakes(const std::string& url, const size_t count)
+{
+  std::vector<std::unique_ptr<WebSocketClient>> clients;
+  const auto start = Clock::now();
+  for (size_t i = 0; i < count; ++i)
+  {
+    auto client = std::make_unique<WebSocketClient>();
+    if (!client->connect(url))
+      return 0;
+    clients.push_back(std::move(client));
+  }
+  const double elapsed = seconds(start);
+  for (auto& client : clients)
+    client->disconnect();
+  return static_cast<double>(count) / elapsed;
+}
+
+struct LoopResult
+{
+  double handshakes = 0; // 每秒完成的握手
+  double messages = 0; // 每秒回显的消息
+};
+
+// 非阻塞模式：一个线程一个事件循环同时驱动全部连接，每个连接收到回显后立即发下一条
+static LoopResult loopClients(const std::string& url, const size_t count)
+{
+  cppkit::event::EventLoop loop;
+  std::vector<std::unique_ptr<WebSocketClient>> clients;
+  const std::string message(64, 'x');
+  size_t connected = 0;
+  size_t echoed = 0;
+  bool echoing = false;
+  bool failed = false;
+
+  for (size_t i = 0; i < count; ++i)
+  {
+    auto client = std::make_unique<WebSocketClient>(&loop);
+    WebSocketClient* c = client.get();
+    client->setOnConnect([&connected]
+    {
+      ++connected;
+    });
+    client->setOnMessage([c, &message, &echoed, &echoing](std::span<const uint8_t>, MessageType)
+    {
+      ++echoed;
+      if (echoing)
+        (void) c->send(message);
+    });
+    client->setOnError([&failed](const std::string&)
+    {
+      failed = true;
+    });
+    clients.push_back(std::move(client));
+  }
+
+  LoopResult result;
+  auto start = Clock::now();
+  for (auto& client : clients)
+  {
+    if (!client->connect(url))
+      return result;
+  }
+
+  // 1ms 检查一次进度
+  (void) loop.createTimeEvent(1, [&](int64_t) -> int64_t
+  {
+    if (failed)
+    {
+      loop.stop();
+      return 0;
+    }
+    if (!echoing && connected == count)
+    {
+      result.handshakes = static_cast<double>(count) / seconds(start);
+      echoing = true;
+      start = Clock::now();
+      for (auto& client : clients)
+        (void) client->send(message);
+    }
+    else if (echoing && seconds(start) > 1.0)
+    {
+      result.messages = static_cast<double>(echoed) / seconds(start);
+      loop.stop();
+      return 0;
+    }
+    return 1;
+  });
+  loop.run();
+
+  for (auto& client : clients)
+    client->disconnect();
+  return result;
+}
+
+int main()
+{
+  // 客户端和服务端各占一份 fd
+  rlimit limit{};
+  getrlimit(RLIMIT_NOFILE, &limit);
+  limit.rlim_cur = limit.rlim_max;
+  setrlimit(RLIMIT_NOFILE, &limit);
+
+  constexpr uint16_t port = 18790;
+  const std::string url = "ws://127.0.0.1:" + std::to_string(port) + "/";
+  std::atomic<bool> ready = false;
+  std::thread server(runEchoServer, port, std::ref(ready));
+
+  // 等服务端开始监听
+  while (!ready)
+  {
+    WebSocketClient probe;
+    probe.setOnError([](const std::string&)
+    {
+    });
+    if (probe.connect(url))
+      probe.disconnect();
+    else
+      std::this_thread::sleep_for(std::chrono::milliseconds(10));
+  }
+
+  std::cout << std::left << std::setw(14) << "connections" << std::right << std::setw(26) << "blocking (handshake/s)"
+      << std::setw(22) << "loop (handshake/s)" << std::setw(20) << "loop (echo msg/s)" << std::endl;
+
+  for (const size_t count : {size_t{10}, size_t{100}, size_t{1000}, size_t{2000}})
+  {
+    const size_t maxCount = limit.rlim_cur > 64 ? (limit.rlim_cur - 64) / 2 : 0;
+    if (count > maxCount)
+      break;
+    const double blocking = blockingHandshakes(url, count);
+    const auto [handshakes, messages] = loopClients(url, count);
+    std::cout << std::left << std::setw(14) << count << std::right << std::fixed << std::setprecision(0)
+        << std::setw(26) << blocking << std::setw(22) << handshakes << std::setw(20) << messages << std::endl;
+  }
+
+  WebSocketClient stopper;
+  if (stopper.connect(url))
+    (void) stopper.send(std::string_view("stop"));
+  server.join();
+  return 0;
+}
@@ -0,0 +1,121 @@
+#include "cppkit/websocket/deflate.hpp"
+#include "cppkit/websocket/frame.hpp"
+#include <algorithm>
+#include <chrono>
+#include <iomanip>
+#include <iostream>
+#include <random>
+
+using namespace cppkit::websocket;
+
+// 模拟行情推送：字段固定，数值随机
+static std::vector<std::string> makeFeed(const size_t messageSize, const size_t count)
+{
+  std::mt19937 gen(42);
+  std::uniform_int_distribution price(1000, 99999);
+  const char* symbols[] = {"AAPL", "MSFT", "GOOG", "AMZN", "TSLA", "NVDA"};
+  std::vector<std::string> feed;
+  for (size_t i = 0; i < count; ++i)
+  {
+    std::string message = "[";
+    while (message.size() < messageSize)
+    {
+      message += R"({"symbol":")" + std::string(symbols[gen() % 6]) + R"(","price":)" + std::to_string(price(gen)) +
+          R"(,"volume":)" + std::to_string(price(gen) * 10) + R"(,"side":")" + (gen() % 2 ? "buy" : "sell") +
+          R"(","ts":)" + std::to_string(1700000000000 + i * 1000 + gen() % 1000) + "},";
+    }
+    message.back() = ']';
+    feed.push_back(std::move(message));
+  }
+  return feed;
+}
+
+static std::span<const uint8_t> bytes(const std::string& s)
+{
+  return {reinterpret_cast<const uint8_t*>(s.data()), s.size()};
+}
+
+int main()
+{
+  if (!deflateAvailable())
+  {
+    std::cout << "built without zlib, permessage-deflate unavailable" << std::endl;
+    return 0;
+  }
+
+  using Clock = std::chrono::steady_clock;
+  std::cout << std::left << std::setw(8) << "size" << std::setw(26) << "mode" << std::right << std::setw(10) << "ratio"
+      << std::setw(14) << "deflate MB/s" << std::setw(14) << "us/msg" << std::setw(14) << "inflate MB/s"
+      << std::setw(18) << "saved KB/cpu-ms" << std::endl;
+
+  for (const size_t size : {size_t{256}, size_t{4096}, size_t{65536}})
+  {
+    // 消息总量远大于 32 KiB 窗口，避免同一条消息在窗口内重复出现
+    const auto feed = makeFeed(size, std::max<size_t>(64, (1 << 20) / size));
+    size_t original = 0;
+    for (const auto& message : feed)
+      original += message.size();
+
+    for (const int level : {1, 6})
+    {
+      for (const bool takeover : {true, false})
+      {
+        DeflateOptions options;
+        options.level = level;
+        options.minSize = 0;
+        DeflateParams params;
+        params.serverNoContextTakeover = !takeover;
+        PerMessageDeflate server(params, true, options);
+        PerMessageDeflate client(params, false, options);
+
+        // 压缩与解压各跑满约 0.2 秒，按轮计时
+        std::vector<std::vector<uint8_t>> compressed(feed.size());
+        size_t compressedBytes = 0;
+        size_t rounds = 0;
+        double deflateSeconds = 0;
+        while (deflateSeconds < 0.2)
+        {
+          compressedBytes = 0;
+          const auto start = Clock::now();
+          for (size_t i = 0; i < feed.size(); ++i)
+          {
+            server.compress(bytes(feed[i]), compressed[i]);
+            compressedBytes += compressed[i].size();
+          }
+          deflateSeconds += std::chrono::duration<double>(Clock::now() - start).count();
+          ++rounds;
+        }
+
+        // 解压必须按压缩的顺序重放：每轮重新压缩一遍（不计时）保持两端上下文一致
+        std::vector<uint8_t> plain;
+        size_t inflateRounds = 0;
+        double inflateSeconds = 0;
+        PerMessageDeflate replayServer(params, true, options);
+        while (inflateSeconds < 0.2)
+        {
+          for (size_t i = 0; i < feed.size(); ++i)
+            replayServer.compress(bytes(feed[i]), compressed[i]);
+          const auto start = Clock::now();
+          for (const auto& message : compressed)
+          {
+            if (client.decompress(message, plain, MAX_PAYLOAD_SIZE) != InflateStatus::OK)
+              return 1;
+          }
+          inflateSeconds += std::chrono::duration<double>(Clock::now() - start).count();
+          ++inflateRounds;
+        }
+
+        const double total = static_cast<double>(original) * static_cast<double>(rounds);
+        const double ratio = static_cast<double>(original) / static_cast<double>(compressedBytes);
+        const double saved = static_cast<double>(original - compressedBytes) * static_cast<double>(rounds);
+        const std::string mode = "level " + std::to_string(level) + (takeover ? " takeover" : " no-takeover");
+        std::cout << std::left << std::setw(8) << size << std::setw(26) << mode << std::right << std::fixed
+            << std::setprecision(2) << std::setw(10) << ratio << std::setw(14) << total / deflateSeconds / 1e6
+            << std::setw(14) << deflateSeconds * 1e6 / static_cast<double>(rounds * feed.size()) << std::setw(14)
+            << static_cast<double>(original) * static_cast<double>(inflateRounds) / inflateSeconds / 1e6
+            << std::setw(18) << saved / 1024 / (deflateSeconds * 1e3) << std::endl;
+      }
+    }
+  }
+  return 0;
+}
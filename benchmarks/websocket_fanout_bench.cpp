@@ -0,0 +1,137 @@
+#include "cppkit/websocket/conn.hpp"
+#include <algorithm>
+#include <chrono>
+#include <fcntl.h>
+#include <iomanip>
+#include <iostream>
+#include <sys/resource.h>
+#include <sys/socket.h>
+#include <unistd.h>
+
+using namespace cppkit::websocket;
+
+// 每个订阅者一对非阻塞 socket，发送端模拟服务端连接，接收端在计时之外读空
+struct Subscriber
+{
+  int sender = -1;
+  int receiver = -1;
+  std::unique_ptr<Outbox> outbox;
+};
+
+static void drain(const std::vector<Subscriber>& subscribers)
+{
+  uint8_t buf[65536];
+  for (const auto& s : subscribers)
+  {
+    while (::read(s.receiver, buf, sizeof(buf)) > 0)
+    {
+    }
+    s.outbox->flush();
+  }
+}
+
+template <typename Fn>
+static double measure(const std::vector<Subscriber>& subscribers, const size_t batch, Fn&& publish)
+{
+  using Clock = std::chrono::steady_clock;
+  double seconds = 0;
+  size_t published = 0;
+  while (seconds < 0.3)
+  {
+    const auto start = Clock::now();
+    for (size_t i = 0; i < batch; ++i)
+      publish();
+    seconds += std::chrono::duration<double>(Clock::now() - start).count();
+    published += batch;
+    drain(subscribers);
+  }
+  return static_cast<double>(published) / seconds;
+}
+
+int main()
+{
+  // 最多需要 2 * 5000 个 fd
+  rlimit limit{};
+  getrlimit(RLIMIT_NOFILE, &limit);
+  limit.rlim_cur = limit.rlim_max;
+  setrlimit(RLIMIT_NOFILE, &limit);
+
+  cppkit::event::EventLoop loop;
+  const OutboxLimits limits;
+  size_t sink = 0;
+
+  std::cout << std::left << std::setw(10) << "payload" << std::setw(14) << "subscribers" << std::right
+      << std::setw(24) << "legacy (publish/s)" << std::setw(24) << "shared (publish/s)" << std::setw(24)
+      << "shared (deliveries/s)" << std::endl;
+
+  std::vector<std::pair<size_t, size_t>> cases;
+  for (const size_t size : {size_t{256}, size_t{16384}})
+  {
+    for (const size_t count : {size_t{1}, size_t{10}, size_t{100}, size_t{1000}, size_t{5000}})
+      cases.emplace_back(size, count);
+  }
+
+  for (const auto& [size, count] : cases)
+  {
+    const std::vector<uint8_t> payload(size, 'x');
+    std::vector<Subscriber> subscribers(count);
+    bool ok = true;
+    for (auto& s : subscribers)
+    {
+      int fds[2];
+      if (socketpair(AF_UNIX, SOCK_STREAM, 0, fds) != 0)
+      {
+        ok = false;
+        break;
+      }
+      s.sender = fds[0];
+      s.receiver = fds[1];
+      fcntl(s.sender, F_SETFL, fcntl(s.sender, F_GETFL) | O_NONBLOCK);
+      fcntl(s.receiver, F_SETFL, fcntl(s.receiver, F_GETFL) | O_NONBLOCK);
+      s.outbox = std::make_unique<Outbox>(&loop, s.sender, limits, [](int, int) {});
+    }
+
+    if (ok)
+    {
+      // 每批消息放得进 socket 缓冲区，不触发排队
+      const size_t batch = std::clamp<size_t>(16 * 1024 / (size + MAX_FRAME_HEADER_SIZE), 1, 32);
+
+      // 旧实现：每个订阅者各成帧一次再发送
+      const double legacy = measure(subscribers, batch, [&]
+      {
+        for (const auto& s : subscribers)
+        {
+          const auto frame = buildFrame(payload, MessageType::BINARY);
+          sink += static_cast<size_t>(::send(s.sender, frame.data(), frame.size(), 0));
+        }
+      });
+
+      // 新实现：成帧一次，所有订阅者的输出队列共享
+      const double shared = measure(subscribers, batch, [&]
+      {
+        const SharedFrame frame = makeSharedFrame(payload);
+        for (const auto& s : subscribers)
+          sink += s.outbox->send(frame);
+      });
+
+      std::cout << std::left << std::setw(10) << size << std::setw(14) << count << std::right << std::fixed
+          << std::setprecision(0) << std::setw(24) << legacy << std::setw(24) << shared << std::setw(24)
+          << shared * static_cast<double>(count) << std::endl;
+    }
+    else
+    {
+      std::cout << std::left << std::setw(10) << size << std::setw(14) << count
+          << " skipped: not enough file descriptors" << std::endl;
+    }
+
+    for (const auto& s : subscribers)
+    {
+      if (s.sender >= 0)
+      {
+        ::close(s.sender);
+        ::close(s.receiver);
+      }
+    }
+  }
+  return sink == 0 ? 1 : 0;
+}
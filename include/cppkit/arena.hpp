@@ -0,0 +1,130 @@
+#pragma once
+
+#include <algorithm>
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <new>
+#include <string_view>
+#include <utility>
+
+namespace cppkit
+{
+    // 单调分配器：只分配不单独释放，内存在 reset() 或析构时整体归还
+    // 适合生命周期一致的大量小对象（如一次解析得到的整棵 JSON 树），不会调用对象的析构函数
+    class Arena
+    {
+    public:
+        explicit Arena(const size_t blockSize = 64 * 1024) noexcept : blockSize_(blockSize)
+        {
+        }
+
+        ~Arena() { release(nullptr); }
+
+        Arena(const Arena&) = delete;
+
+        Arena& operator=(const Arena&) = delete;
+
+        // 分配 bytes 字节，按 align 对齐
+        [[nodiscard]] void* allocate(const size_t bytes, const size_t align = alignof(std::max_align_t))
+        {
+            auto p = reinterpret_cast<uintptr_t>(cur_);
+            p = (p + align - 1) & ~(static_cast<uintptr_t>(align) - 1);
+            if (cur_ == nullptr || p + bytes > reinterpret_cast<uintptr_t>(end_))
+            {
+                newBlock(bytes + align);
+                p = reinterpret_cast<uintptr_t>(cur_);
+                p = (p + align - 1) & ~(static_cast<uintptr_t>(align) - 1);
+            }
+            cur_ = reinterpret_cast<char*>(p + bytes);
+            used_ += bytes;
+            return reinterpret_cast<void*>(p);
+        }
+
+        template <typename T>
+        [[nodiscard]] T* allocateArray(const size_t n)
+        {
+            return static_cast<T*>(allocate(n * sizeof(T), alignof(T)));
+        }
+
+        // 在 arena 中构造对象，对象的析构函数不会被调用
+        template <typename T, typename... Args>
+        [[nodiscard]] T* create(Args&&... args)
+        {
+            return new(allocate(sizeof(T), alignof(T))) T(std::forward<Args>(args)...);
+        }
+
+        // 拷贝字符串并追加 '\0'
+        [[nodiscard]] char* copyString(const std::string_view s)
+        {
+            auto* p = static_cast<char*>(allocate(s.size() + 1, 1));
+            std::memcpy(p, s.data(), s.size());
+            p[s.size()] = '\0';
+            return p;
+        }
+
+        // 丢弃所有分配，保留最近的一个块以便复用
+        void reset() noexcept
+        {
+            Block* keep = head_;
+            release(keep);
+            head_ = keep;
+            if (keep)
+            {
+                keep->next = nullptr;
+                cur_ = reinterpret_cast<char*>(keep + 1);
+                end_ = cur_ + keep->size;
+                reserved_ = keep->size;
+            }
+            used_ = 0;
+        }
+
+        // 已分配给调用方的字节数
+        [[nodiscard]] size_t used() const noexcept { return used_; }
+
+        // 向系统申请的字节数
+        [[nodiscard]] size_t reserved() const noexcept { return reserved_; }
+
+    private:
+        struct alignas(std::max_align_t) Block
+        {
+            Block* next;
+            size_t size;
+        };
+
+        void newBlock(const size_t minSize)
+        {
+            // 块大小按已申请总量增长，减少大文档的块数量
+            const size_t size = std::max({minSize, blockSize_, std::min(reserved_, static_cast<size_t>(16) << 20)});
+            auto* block = static_cast<Block*>(::operator new(sizeof(Block) + size));
+            block->next = head_;
+            block->size = size;
+            head_ = block;
+            cur_ = reinterpret_cast<char*>(block + 1);
+            end_ = cur_ + size;
+            reserved_ += size;
+        }
+
+        void release(const Block* keep) noexcept
+        {
+            Block* block = head_;
+            while (block)
+            {
+                Block* next = block->next;
+                if (block != keep)
+                    ::operator delete(block);
+                block = next;
+            }
+            head_ = nullptr;
+            cur_ = end_ = nullptr;
+            reserved_ = 0;
+        }
+
+        Block* head_ = nullptr;
+        char* cur_ = nullptr;
+        char* end_ = nullptr;
+        size_t blockSize_;
+        size_t used_ = 0;
+        size_t reserved_ = 0;
+    };
+} // namespace cppkit
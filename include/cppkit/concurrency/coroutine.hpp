@@ -1,5 +1,6 @@
 #pragma once
 
+#include "cppkit/trace/trace.hpp"
 #include <coroutine>
 #include <exception>
 #include <iostream>
@@ -20,6 +21,17 @@ namespace cppkit::concurrency
     template <>
     class Task<void>;
 
+    // Initial suspend that restores the creator's trace context when the coroutine first runs
+    struct initial_context_awaiter : std::suspend_always
+    {
+        trace::Context context = trace::current();
+
+        void await_resume() const noexcept
+        {
+            trace::setCurrent(context);
+        }
+    };
+
     // Scheduler class - fully defined first
     class Scheduler
     {
@@ -55,6 +67,7 @@ namespace cppkit::concurrency
         void run()
         {
             current_scheduler = this;
+            const trace::Context outer = trace::current();
             running_ = true;
 
             running_ = true;
@@ -76,6 +89,7 @@ namespace cppkit::concurrency
                 if (handle)
                 {
                     handle.resume();
+                    trace::setCurrent(outer); // A suspended coroutine may leave its trace context behind
                     --task_count_; // Decrement after Task completes
                 }
             }
@@ -122,7 +136,7 @@ namespace cppkit::concurrency
             }
 
             // Initial suspend: always suspend initially
-            [[nodiscard]] std::suspend_always initial_suspend() const noexcept
+            [[nodiscard]] initial_context_awaiter initial_suspend() const noexcept
             {
                 return {};
             }
@@ -183,6 +197,7 @@ namespace cppkit::concurrency
 
     private:
         std::coroutine_handle<promise_type> handle_;
+        mutable trace::Context caller_context_; // Trace context of the awaiting coroutine
 
     public:
         explicit Task(std::coroutine_handle<promise_type> handle) noexcept : handle_(handle)
@@ -238,6 +253,7 @@ namespace cppkit::concurrency
         template <typename promise_type>
         void await_suspend(std::coroutine_handle<promise_type> caller) const noexcept
         {
+            caller_context_ = trace::current();
             // Store the caller as continuation
             handle_.promise().continuation = caller;
             // Schedule this coroutine to run
@@ -247,6 +263,7 @@ namespace cppkit::concurrency
         // Final awaiter for Task
         T await_resume() const
         {
+            trace::setCurrent(caller_context_);
             if (handle_.promise().exception)
             {
                 std::rethrow_exception(handle_.promise().exception);
@@ -275,7 +292,7 @@ namespace cppkit::concurrency
             }
 
             // Initial suspend: always suspend initially
-            std::suspend_always initial_suspend() const noexcept
+            initial_context_awaiter initial_suspend() const noexcept
             {
                 return {};
             }
@@ -335,6 +352,7 @@ namespace cppkit::concurrency
 
     private:
         std::coroutine_handle<promise_type> handle_;
+        mutable trace::Context caller_context_; // Trace context of the awaiting coroutine
 
     public:
         explicit Task(std::coroutine_handle<promise_type> handle) noexcept : handle_(handle)
@@ -388,6 +406,7 @@ namespace cppkit::concurrency
         template <typename promise_type>
         void await_suspend(std::coroutine_handle<promise_type> caller) const noexcept
         {
+            caller_context_ = trace::current();
             // Store the caller as continuation
             handle_.promise().continuation = caller;
             // Schedule this coroutine to run
@@ -397,6 +416,7 @@ namespace cppkit::concurrency
         // Final awaiter for void Task
         void await_resume() const
         {
+            trace::setCurrent(caller_context_);
             if (handle_.promise().exception)
             {
                 std::rethrow_exception(handle_.promise().exception);
@@ -409,6 +429,8 @@ namespace cppkit::concurrency
     {
         struct yield_awaiter
         {
+            trace::Context context = trace::current();
+
             bool await_ready() const noexcept
             {
                 return false;
@@ -422,9 +444,9 @@ namespace cppkit::concurrency
                 return std::noop_coroutine();
             }
 
-            void await_resume() noexcept
+            void await_resume() const noexcept
             {
-                // Do nothing
+                trace::setCurrent(context);
             }
         };
 
@@ -454,6 +476,7 @@ namespace cppkit::concurrency
             {
             private:
                 mutex& mutex_;
+                trace::Context context_ = trace::current();
 
             public:
                 explicit lock_awaiter(mutex& m) noexcept : mutex_(m)
@@ -479,9 +502,10 @@ namespace cppkit::concurrency
                     }
                 }
 
-                void await_resume() noexcept
+                void await_resume() const noexcept
                 {
                     // Already locked
+                    trace::setCurrent(context_);
                 }
             };
 
@@ -527,6 +551,7 @@ namespace cppkit::concurrency
             {
             private:
                 condition_variable& cv_;
+                trace::Context context_ = trace::current();
 
             public:
                 explicit wait_awaiter(condition_variable& cv) noexcept : cv_(cv)
@@ -543,9 +568,9 @@ namespace cppkit::concurrency
                     cv_.wait_queue_.push(handle);
                 }
 
-                void await_resume() noexcept
+                void await_resume() const noexcept
                 {
-                    // Do nothing
+                    trace::setCurrent(context_);
                 }
             };
 
@@ -0,0 +1,88 @@
+#pragma once
+
+#include <atomic>
+#include <cstdint>
+#include <cstring>
+#include <thread>
+#include <type_traits>
+
+namespace cppkit::concurrency
+{
+    // 单写者、多读者的顺序锁：写者从不阻塞，读者不加锁，读到写了一半的数据时重试。
+    // 数据按 8 字节一组存放在原子变量里，读写都是 relaxed 原子操作，不存在数据竞争
+    template <typename T>
+    class SeqLock
+    {
+        static_assert(std::is_trivially_copyable_v<T>, "SeqLock requires a trivially copyable type");
+
+    public:
+        SeqLock()
+        {
+            uint64_t words[WORDS]{};
+            const T value{};
+            std::memcpy(words, &value, sizeof(T));
+            for (size_t i = 0; i < WORDS; ++i)
+            {
+                _words[i].store(words[i], std::memory_order_relaxed);
+            }
+        }
+
+        SeqLock(const SeqLock&) = delete;
+
+        SeqLock& operator=(const SeqLock&) = delete;
+
+        // 只能由一个线程调用
+        void store(const T& value)
+        {
+            uint64_t words[WORDS]{};
+            std::memcpy(words, &value, sizeof(T));
+
+            const uint64_t seq = _seq.load(std::memory_order_relaxed);
+            _seq.store(seq + 1, std::memory_order_relaxed);
+            std::atomic_thread_fence(std::memory_order_release);
+            for (size_t i = 0; i < WORDS; ++i)
+            {
+                _words[i].store(words[i], std::memory_order_relaxed);
+            }
+            _seq.store(seq + 2, std::memory_order_release);
+        }
+
+        [[nodiscard]] T load() const
+        {
+            uint64_t words[WORDS];
+            while (true)
+            {
+                const uint64_t before = _seq.load(std::memory_order_acquire);
+                if (before & 1)
+                {
+                    std::this_thread::yield(); // 写者正在写
+                    continue;
+                }
+                for (size_t i = 0; i < WORDS; ++i)
+                {
+                    words[i] = _words[i].load(std::memory_order_relaxed);
+                }
+                std::atomic_thread_fence(std::memory_order_acquire);
+                if (_seq.load(std::memory_order_relaxed) == before)
+                {
+                    break;
+                }
+            }
+            T value;
+            std::memcpy(&value, words, sizeof(T));
+            return value;
+        }
+
+        // 已经完成的写入次数
+        [[nodiscard]] uint64_t version() const
+        {
+            return _seq.load(std::memory_order_acquire) / 2;
+        }
+
+    private:
+        static constexpr size_t WORDS = (sizeof(T) + sizeof(uint64_t) - 1) / sizeof(uint64_t);
+
+        alignas(64) std::atomic<uint64_t> _seq{0};
+        std::atomic<uint64_t> _words[WORDS];
+    };
+} // namespace cppkit::concurrency
@@ -1,5 +1,7 @@
 #pragma once
 
+#include "cppkit/metrics/metrics.hpp"
+#include "cppkit/trace/trace.hpp"
 #include <vector>
 #include <queue>
 #include <thread>
@@ -41,7 +43,12 @@ namespace cppkit::concurrency
                 std::lock_guard lock(mtx);
                 if (stop.load(std::memory_order_acquire))
                     throw std::runtime_error("enqueue on stopped ThreadPool");
-                tasks.emplace([taskPtr] { (*taskPtr)(); });
+                // 启用追踪时带上提交者的上下文和入队时间
+                if (trace::enabled())
+                    tasks.push(QueuedTask{[taskPtr] { (*taskPtr)(); }, trace::current(), trace::nowNs()});
+                else
+                    tasks.push(QueuedTask{[taskPtr] { (*taskPtr)(); }, {}, 0});
+                CK_GAUGE_ADD("cppkit_thread_pool_queue_depth", "Tasks waiting in thread pool queues", 1);
             }
             cv.notify_one();
             return res;
@@ -57,9 +64,16 @@ namespace cppkit::concurrency
         void shutdownNow();
 
     private:
+        struct QueuedTask
+        {
+            std::function<void()> fn;
+            trace::Context context; // 提交时的追踪上下文
+            uint64_t enqueuedNs = 0; // 0 表示提交时未启用追踪
+        };
+
         std::vector<std::thread> workers; // 工作线程队列
 
-        std::queue<std::function<void()>> tasks; // 任务队列
+        std::queue<QueuedTask> tasks; // 任务队列
 
         mutable std::mutex mtx; // 互斥锁
 
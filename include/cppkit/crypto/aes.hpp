@@ -9,6 +9,8 @@
 #include <sstream>
 #include <cstring>
 #include <cassert>
+#include <span>
+#include "hex.hpp"
 
 namespace cppkit::crypto
 {
@@ -555,7 +557,7 @@ namespace cppkit::crypto
   }
 
   // Key expansion: expand 16-uint8_t key into (Nb*(Nr+1)) * 4 uint8_ts = 176 uint8_ts for AES-128
-  void KeyExpansion(const uint8_t key[16], uint8_t roundKey[176])
+  inline void KeyExpansion(const uint8_t key[16], uint8_t roundKey[176])
   {
     // first 16 uint8_ts are original key
     std::memcpy(roundKey, key, 16);
@@ -668,21 +670,21 @@ namespace cppkit::crypto
         st[c][r] ^= roundKey[c * 4 + r];
   }
 
-  void BlockToState(const uint8_t in[16], State& st)
+  inline void BlockToState(const uint8_t in[16], State& st)
   {
     for (int c = 0; c < 4; ++c)
       for (int r = 0; r < 4; ++r)
         st[c][r] = in[c * 4 + r];
   }
 
-  void StateToBlock(const State& st, uint8_t out[16])
+  inline void StateToBlock(const State& st, uint8_t out[16])
   {
     for (int c = 0; c < 4; ++c)
       for (int r = 0; r < 4; ++r)
         out[c * 4 + r] = st[c][r];
   }
 
-  void AES_EncryptBlock(const uint8_t in[16], uint8_t out[16], const uint8_t roundKey[176])
+  inline void AES_EncryptBlock(const uint8_t in[16], uint8_t out[16], const uint8_t roundKey[176])
   {
     State st;
     BlockToState(in, st);
@@ -705,7 +707,7 @@ namespace cppkit::crypto
     StateToBlock(st, out);
   }
 
-  void AES_DecryptBlock(const uint8_t in[16], uint8_t out[16], const uint8_t roundKey[176])
+  inline void AES_DecryptBlock(const uint8_t in[16], uint8_t out[16], const uint8_t roundKey[176])
   {
     State st;
     BlockToState(in, st);
@@ -833,15 +835,128 @@ namespace cppkit::crypto
   // Utilities
   inline std::string toHex(const std::vector<uint8_t>& data)
   {
-    std::ostringstream oss;
-    oss << std::hex << std::setfill('0');
-    for (uint8_t b : data)
-      oss << std::setw(2) << static_cast<int>(b);
-    return oss.str();
+    return hexEncode(data);
   }
 
   inline std::vector<uint8_t> fromString(const std::string& s)
   {
     return {s.begin(), s.end()};
   }
+
+  // AES 引擎：支持 AES-128/192/256，CPU 支持 AES-NI 时使用硬件指令，否则使用 T 表实现
+  // 只提供加密方向，CTR 与 GCM 模式都只需要加密
+  class Aes
+  {
+  public:
+    // key 长度必须为 16、24 或 32 字节，否则抛出 std::runtime_error
+    explicit Aes(std::span<const uint8_t> key);
+
+    void encryptBlock(const uint8_t in[16], uint8_t out[16]) const;
+
+    // 逐块加密 blocks 个 16 字节块（ECB），in 与 out 可以相同
+    void encryptBlocks(const uint8_t* in, uint8_t* out, size_t blocks) const;
+
+    [[nodiscard]]
+    int rounds() const noexcept { return rounds_; }
+
+    // 新建的对象是否使用 AES-NI 与 PCLMULQDQ
+    static bool hardwareAccelerated() noexcept;
+
+    // 开关硬件实现（主要用于测试与基准），只影响之后创建的对象；CPU 不支持时返回 false
+    static bool setHardwareAccelerated(bool enabled) noexcept;
+
+    [[nodiscard]]
+    bool usesHardware() const noexcept { return hardware_; }
+
+  private:
+    friend class AesCtr;
+    friend class AesGcm;
+
+    // 计数器模式：以 counter 为起点加密 blocks 个计数器块并与 in 异或写入 out，结束后 counter 指向下一个值
+    // inc32 为 true 时只递增低 32 位（GCM），否则按 128 位大端整数递增
+    void ctr(uint8_t counter[16], bool inc32, const uint8_t* in, uint8_t* out, size_t blocks) const;
+
+    alignas(16) uint8_t roundKeys_[240]{}; // 按字节存放的轮密钥，AES-NI 直接加载
+    uint32_t roundWords_[60]{};           // 同一轮密钥的大端字，T 表实现使用
+    int rounds_ = 0;
+    bool hardware_ = false;
+  };
+
+  // CTR 模式流式加解密（两个方向相同），可以多次调用 update 处理任意长度的数据
+  class AesCtr
+  {
+  public:
+    // iv 为 16 字节的初始计数器块
+    AesCtr(std::span<const uint8_t> key, std::span<const uint8_t, 16> iv);
+
+    // 原地处理
+    void update(std::span<uint8_t> data);
+
+    // out 的长度不能小于 in，两者可以相同
+    void update(std::span<const uint8_t> in, std::span<uint8_t> out);
+
+  private:
+    Aes aes_;
+    uint8_t counter_[16];
+    uint8_t keystream_[16]{};
+    size_t used_ = 16; // keystream_ 中已使用的字节数
+  };
+
+  // GCM 认证加密。一条消息的调用顺序：start -> aad* -> encrypt*/decrypt* -> finish/verify
+  // 同一个对象可以连续处理多条消息，密钥相关的预计算只做一次
+  class AesGcm
+  {
+  public:
+    static constexpr size_t kTagSize = 16;
+
+    explicit AesGcm(std::span<const uint8_t> key);
+
+    // 开始一条新消息，推荐使用 12 字节的 iv；同一密钥下 iv 不能重复使用
+    void start(std::span<const uint8_t> iv);
+
+    // 附加认证数据，必须在 encrypt/decrypt 之前调用，可以分多次传入
+    void aad(std::span<const uint8_t> data);
+
+    // 原地加密，可以分多次传入
+    void encrypt(std::span<uint8_t> data);
+
+    // 原地解密，可以分多次传入；调用方需要在使用明文之前用 verify 校验
+    void decrypt(std::span<uint8_t> data);
+
+    // 结束当前消息并返回认证标签
+    std::array<uint8_t, kTagSize> finish();
+
+    // 结束当前消息并以常数时间比较认证标签，tag 可以截断但不能少于 12 字节
+    bool verify(std::span<const uint8_t> tag);
+
+    // 一次性加密 data 并返回认证标签
+    std::array<uint8_t, kTagSize> seal(std::span<const uint8_t> iv, std::span<const uint8_t> aad,
+                                       std::span<uint8_t> data);
+
+    // 一次性解密 data 并校验标签，失败时 data 中的内容不可信
+    bool open(std::span<const uint8_t> iv, std::span<const uint8_t> aad, std::span<uint8_t> data,
+              std::span<const uint8_t> tag);
+
+  private:
+    void ghash(const uint8_t* data, size_t blocks);
+
+    // 把 GHASH 缓冲区中不完整的块补零后吸收
+    void flushGhash();
+
+    void crypt(std::span<uint8_t> data, bool encrypting);
+
+    Aes aes_;
+    alignas(16) uint8_t hPowers_[8][16]{}; // H^1..H^8，AES-NI 实现使用字节反序的表示
+    uint64_t hh_[16]{}, hl_[16]{};          // 标量实现使用的 4 位乘法表（Shoup），i·H 的高低 64 位
+    uint8_t x_[16]{};                       // GHASH 累加值
+    uint8_t j0_[16]{};
+    uint8_t counter_[16]{};
+    uint8_t keystream_[16]{};
+    size_t used_ = 16;
+    uint8_t partial_[16]{}; // 尚未吸收进 GHASH 的不完整块
+    size_t partialLen_ = 0;
+    uint64_t aadLen_ = 0;
+    uint64_t textLen_ = 0;
+    enum class Stage : uint8_t { Idle, Aad, Text } stage_ = Stage::Idle;
+  };
 } // namespace cppkit::crypto
\ No newline at end of file
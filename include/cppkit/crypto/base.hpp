@@ -1,19 +1,86 @@
 #pragma once
 
 #include <string>
+#include <string_view>
+#include <span>
 #include <vector>
+#include <optional>
 #include <stdexcept>
 #include <cstdint>
 
 namespace cppkit::crypto
 {
+  // RFC 4648 字母表：标准 (§4，'+' '/') 或 URL 安全 (§5，'-' '_')
+  enum class Base64Alphabet : uint8_t
+  {
+    Standard,
+    Url,
+  };
+
+  struct Base64Options
+  {
+    Base64Alphabet alphabet = Base64Alphabet::Standard;
+    // 编码时是否输出 '=' 填充；解码时为 true 表示要求输入带完整填充，false 表示填充可有可无
+    bool padding = true;
+    // 解码时跳过空白字符（空格、\t、\r、\n），例如按行折断的 MIME 数据
+    bool ignoreWhitespace = false;
+  };
+
   class Base64 final
   {
   public:
-    static std::string encode(const std::vector<uint8_t>& data);
+    // 编解码的实现，运行时按 CPU 特性选择
+    enum class Backend : uint8_t
+    {
+      Scalar,
+      Ssse3, // 每次处理 12 字节 / 16 字符
+      Avx2,  // 每次处理 24 字节 / 32 字符
+    };
+
+    static constexpr Base64Options kStandard{};
+    static constexpr Base64Options kUrl{Base64Alphabet::Url, true, false};
+    // JWT 等场景常用的无填充 URL 安全格式
+    static constexpr Base64Options kUrlNoPadding{Base64Alphabet::Url, false, false};
+    // 允许换行与空白的标准格式
+    static constexpr Base64Options kMime{Base64Alphabet::Standard, true, true};
+
+    // 编码 n 字节得到的字符数
+    static constexpr size_t encodedLength(const size_t n, const bool padding = true) noexcept
+    {
+      if (padding)
+        return (n + 2) / 3 * 4;
+      return n / 3 * 4 + (n % 3 == 0 ? 0 : n % 3 + 1);
+    }
+
+    // n 个字符最多解码出的字节数
+    static constexpr size_t decodedMaxLength(const size_t n) noexcept
+    {
+      return n / 4 * 3 + n % 4 * 3 / 4;
+    }
+
+    static std::string encode(std::span<const uint8_t> data, const Base64Options& options = kStandard);
+
+    static std::string encode(std::string_view data, const Base64Options& options = kStandard);
+
+    // 编码到调用方提供的缓冲区，不分配内存；out 至少 encodedLength 个字符，返回写入的字符数
+    static size_t encode(std::span<const uint8_t> data, std::span<char> out, const Base64Options& options = kStandard);
+
+    static std::vector<uint8_t> decode(std::string_view input, const Base64Options& options = kStandard);
+
+    // 解码到调用方提供的缓冲区，不分配内存；返回写入的字节数
+    // out 不小于 decodedMaxLength(input.size()) 时总是足够
+    static size_t decode(std::string_view input, std::span<uint8_t> out, const Base64Options& options = kStandard);
+
+    // 同上，输入非法或 out 不够时返回 std::nullopt，不抛异常
+    static std::optional<size_t> tryDecode(std::string_view input, std::span<uint8_t> out,
+                                           const Base64Options& options = kStandard) noexcept;
+
+    // 当前使用的实现，默认按 CPU 特性选择：AVX2 > SSSE3 > 标量
+    static Backend backend() noexcept;
 
-    static std::string encode(const std::string& data);
+    // 切换实现（主要用于测试与基准），CPU 不支持时返回 false；对所有线程生效
+    static bool setBackend(Backend backend) noexcept;
 
-    static std::vector<uint8_t> decode(const std::string& input);
+    static const char* backendName(Backend backend) noexcept;
   };
-}
\ No newline at end of file
+}
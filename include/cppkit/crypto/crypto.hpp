@@ -1,8 +1,11 @@
 #pragma once
 
 #include "base.hpp"
+#include "hex.hpp"
+#include "hmac.hpp"
 #include "md5.hpp"
 #include "sha1.hpp"
 #include "sha256.hpp"
+#include "sha_backend.hpp"
 #include "sha512.hpp"
 #include "aes.hpp"
\ No newline at end of file
@@ -0,0 +1,43 @@
+#pragma once
+
+#include <array>
+#include <cstdint>
+#include <cstring>
+#include <span>
+#include <string>
+
+namespace cppkit::crypto
+{
+  namespace internal
+  {
+    // 每个字节对应的两个小写十六进制字符
+    inline constexpr auto kHexPairs = []
+    {
+      constexpr char digits[] = "0123456789abcdef";
+      std::array<char, 512> table{};
+      for (int i = 0; i < 256; ++i)
+      {
+        table[i * 2] = digits[i >> 4];
+        table[i * 2 + 1] = digits[i & 0xF];
+      }
+      return table;
+    }();
+  } // namespace internal
+
+  // 把 data 编码为小写十六进制写入 out，out 至少需要 2 * data.size() 字节，不追加 '\0'
+  inline void hexEncode(const std::span<const uint8_t> data, char* out) noexcept
+  {
+    for (const uint8_t b : data)
+    {
+      std::memcpy(out, internal::kHexPairs.data() + b * 2, 2);
+      out += 2;
+    }
+  }
+
+  inline std::string hexEncode(const std::span<const uint8_t> data)
+  {
+    std::string out(data.size() * 2, '\0');
+    hexEncode(data, out.data());
+    return out;
+  }
+} // namespace cppkit::crypto
@@ -0,0 +1,104 @@
+#pragma once
+
+#include "hex.hpp"
+#include <algorithm>
+#include <array>
+#include <span>
+#include <string>
+#include <string_view>
+
+namespace cppkit::crypto
+{
+  // HMAC（RFC 2104），Hash 可以是 MD5、SHA1、SHA256、SHA512
+  // 构造时预先把 ipad/opad 各压缩一个块并保存中间状态，之后每条消息都从保存的状态开始，
+  // 不再重复处理密钥。对象可以拷贝，拷贝只复制几十字节的哈希状态
+  template <typename Hash>
+  class Hmac
+  {
+  public:
+    static constexpr size_t kBlockSize = Hash::kBlockSize;
+    static constexpr size_t kDigestSize = Hash::kDigestSize;
+    using Digest = std::array<uint8_t, kDigestSize>;
+
+    explicit Hmac(const std::span<const uint8_t> key)
+    {
+      std::array<uint8_t, kBlockSize> pad{};
+      if (key.size() > kBlockSize)
+      {
+        Hash hash;
+        hash.update(key);
+        const auto hashed = hash.digest();
+        std::copy(hashed.begin(), hashed.end(), pad.begin());
+      }
+      else
+        std::copy(key.begin(), key.end(), pad.begin());
+
+      for (auto& b : pad)
+        b ^= 0x36;
+      innerKeyed_.update(pad);
+      for (auto& b : pad)
+        b ^= 0x36 ^ 0x5c;
+      outerKeyed_.update(pad);
+      inner_ = innerKeyed_;
+    }
+
+    explicit Hmac(const std::string_view key)
+      : Hmac(std::span(reinterpret_cast<const uint8_t*>(key.data()), key.size()))
+    {
+    }
+
+    // 流式追加消息
+    Hmac& update(const std::span<const uint8_t> data)
+    {
+      inner_.update(data);
+      return *this;
+    }
+
+    Hmac& update(const std::string_view data)
+    {
+      inner_.update(data);
+      return *this;
+    }
+
+    // 结束当前消息并返回 MAC，随后回到只含密钥的状态，可以直接开始下一条消息
+    Digest digest()
+    {
+      const Digest result = finish(inner_);
+      inner_ = innerKeyed_;
+      return result;
+    }
+
+    std::string hexDigest() { return hexEncode(digest()); }
+
+    // 丢弃已追加但未结束的消息
+    void reset() { inner_ = innerKeyed_; }
+
+    // 一次性计算，不影响流式状态，可以在多个线程中同时调用
+    [[nodiscard]]
+    Digest mac(const std::span<const uint8_t> message) const
+    {
+      Hash inner = innerKeyed_;
+      inner.update(message);
+      return finish(inner);
+    }
+
+    [[nodiscard]]
+    Digest mac(const std::string_view message) const
+    {
+      return mac(std::span(reinterpret_cast<const uint8_t*>(message.data()), message.size()));
+    }
+
+  private:
+    Digest finish(Hash& inner) const
+    {
+      const auto innerDigest = inner.digest();
+      Hash outer = outerKeyed_;
+      outer.update(innerDigest);
+      return outer.digest();
+    }
+
+    Hash innerKeyed_;
+    Hash outerKeyed_;
+    Hash inner_;
+  };
+} // namespace cppkit::crypto
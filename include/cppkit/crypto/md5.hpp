@@ -1,23 +1,31 @@
 #pragma once
 
 #include "base.hpp"
+#include "hex.hpp"
 #include <string>
+#include <string_view>
 #include <array>
+#include <span>
 
 namespace cppkit::crypto
 {
   class MD5 final
   {
   public:
+    static constexpr size_t kBlockSize = 64;
+    static constexpr size_t kDigestSize = 16;
+
     MD5();
 
     // 更新哈希计算
     // data: 输入数据  len: 输入数据长度
     void update(const uint8_t* data, size_t len);
 
+    void update(std::span<const uint8_t> data) { update(data.data(), data.size()); }
+
     // 更新哈希计算
     // data: 输入数据
-    void update(const std::string& data);
+    void update(std::string_view data) { update(reinterpret_cast<const uint8_t*>(data.data()), data.size()); }
 
     // 获取最终的哈希值
     std::array<uint8_t, 16> digest();
@@ -29,10 +37,13 @@ namespace cppkit::crypto
     std::string base64Digest();
 
     // 静态方法，直接计算输入数据的MD5哈希值（十六进制字符串形式）
-    static std::string hash(const std::string& data);
+    static std::string hash(std::string_view data);
+
+    // 静态方法，直接计算输入数据的MD5哈希值（二进制形式）
+    static std::array<uint8_t, 16> hashBinary(std::string_view data);
 
     // 静态方法，直接计算输入数据的MD5哈希值（Base64字符串形式）
-    static std::string hashBase64(const std::string& data);
+    static std::string hashBase64(std::string_view data);
 
   private:
     // MD5变换函数
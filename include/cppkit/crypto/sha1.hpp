@@ -6,17 +6,26 @@
 #include <string>
 #include <sstream>
 #include <iomanip>
+#include <span>
+#include <string_view>
+#include "hex.hpp"
+#include "sha_backend.hpp"
 
 namespace cppkit::crypto
 {
   class SHA1
   {
   public:
+    static constexpr size_t kBlockSize = 64;
+    static constexpr size_t kDigestSize = 20;
+
     SHA1() { reset(); }
 
     void update(const uint8_t* data, size_t len);
 
-    void update(const std::string& str);
+    void update(std::span<const uint8_t> data) { update(data.data(), data.size()); }
+
+    void update(std::string_view str) { update(reinterpret_cast<const uint8_t*>(str.data()), str.size()); }
 
     std::array<uint8_t, 20> digest();
 
@@ -24,19 +33,29 @@ namespace cppkit::crypto
 
     void reset();
 
-    static std::string sha(const std::string& message);
+    static std::string sha(std::string_view message);
 
     // 返回二进制SHA1哈希
-    static std::array<uint8_t, 20> shaBinary(const std::string& message);
+    static std::array<uint8_t, 20> shaBinary(std::string_view message);
+
+    static std::array<uint8_t, 20> shaBinary(std::span<const uint8_t> message);
+
+    // 需要对同一个密钥重复计算时请使用 Hmac<SHA1>
+    static std::string hmac(std::string_view key, std::string_view message);
 
-    static std::string hmac(const std::string& key, const std::string& message);
+    static std::array<uint8_t, 20> hmacBinary(std::string_view key, std::string_view message);
+
+    // 当前使用的实现，支持 SHA-NI 时默认使用
+    static ShaBackend backend() noexcept;
+
+    // 切换实现（主要用于测试与基准），只接受 Scalar 与 ShaNi，CPU 不支持时返回 false
+    static bool setBackend(ShaBackend backend) noexcept;
 
   private:
     void finalize();
 
-    void transform(const uint8_t block[64]);
-
-    static uint32_t leftRotate(uint32_t x, uint32_t n);
+    // 连续压缩 blocks 个 64 字节块
+    static void compress(uint32_t state[5], const uint8_t* data, size_t blocks);
 
     uint32_t state_[5]{};
     uint8_t buffer_[64]{};
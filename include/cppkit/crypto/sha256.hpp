@@ -8,17 +8,26 @@
 #include <iomanip>
 #include <vector>
 #include <algorithm>
+#include <span>
+#include <string_view>
+#include "hex.hpp"
+#include "sha_backend.hpp"
 
 namespace cppkit::crypto
 {
   class SHA256
   {
   public:
+    static constexpr size_t kBlockSize = 64;
+    static constexpr size_t kDigestSize = 32;
+
     SHA256() { reset(); }
 
     void update(const uint8_t* data, size_t len);
 
-    void update(const std::string& str);
+    void update(std::span<const uint8_t> data) { update(data.data(), data.size()); }
+
+    void update(std::string_view str) { update(reinterpret_cast<const uint8_t*>(str.data()), str.size()); }
 
     std::array<uint8_t, 32> digest();
 
@@ -26,16 +35,33 @@ namespace cppkit::crypto
 
     void reset();
 
-    static std::string sha(const std::string& message);
+    static std::string sha(std::string_view message);
+
+    // 返回二进制哈希
+    static std::array<uint8_t, 32> shaBinary(std::span<const uint8_t> message);
+
+    static std::array<uint8_t, 32> shaBinary(std::string_view message);
+
+    // 需要对同一个密钥重复计算时请使用 Hmac<SHA256>，避免每次重新处理密钥
+    static std::string hmac(std::string_view key, std::string_view message);
 
-    static std::string hmac(const std::string& key, const std::string& message);
+    static std::array<uint8_t, 32> hmacBinary(std::string_view key, std::string_view message);
+
+    // 批量计算相互独立的消息的摘要，out 的长度不能小于 messages
+    // 使用 AVX2 实现时按 8 条一组并行压缩，长度相同的消息效果最好
+    static void hashMany(std::span<const std::string_view> messages, std::span<std::array<uint8_t, 32>> out);
+
+    // 当前使用的实现，默认按 CPU 特性选择：SHA-NI > AVX2 > 标量
+    static ShaBackend backend() noexcept;
+
+    // 切换实现（主要用于测试与基准），CPU 不支持时返回 false；对所有线程生效
+    static bool setBackend(ShaBackend backend) noexcept;
 
   private:
     void finalize();
 
-    void transform(const uint8_t block[64]);
-
-    static uint32_t rotr(uint32_t x, uint32_t n);
+    // 连续压缩 blocks 个 64 字节块
+    static void compress(uint32_t state[8], const uint8_t* data, size_t blocks);
 
     uint32_t state_[8]{};
     uint8_t buffer_[64]{};
@@ -8,25 +8,41 @@
 #include <sstream>
 #include <iomanip>
 #include <algorithm>
+#include <span>
+#include <string_view>
+#include "hex.hpp"
 
 namespace cppkit::crypto
 {
   class SHA512
   {
   public:
+    static constexpr size_t kBlockSize = 128;
+    static constexpr size_t kDigestSize = 64;
+
     SHA512() { reset(); }
 
     void update(const uint8_t* data, size_t len);
 
-    void update(const std::string& str);
+    void update(std::span<const uint8_t> data) { update(data.data(), data.size()); }
+
+    void update(std::string_view str) { update(reinterpret_cast<const uint8_t*>(str.data()), str.size()); }
 
     std::array<uint8_t, 64> digest();
 
     std::string hexDigest();
 
-    static std::string sha(const std::string& message);
+    static std::string sha(std::string_view message);
+
+    // 返回二进制哈希
+    static std::array<uint8_t, 64> shaBinary(std::span<const uint8_t> message);
+
+    static std::array<uint8_t, 64> shaBinary(std::string_view message);
+
+    // 需要对同一个密钥重复计算时请使用 Hmac<SHA512>
+    static std::string hmac(std::string_view key, std::string_view message);
 
-    static std::string hmac(const std::string& key, const std::string& message);
+    static std::array<uint8_t, 64> hmacBinary(std::string_view key, std::string_view message);
 
   private:
     void reset();
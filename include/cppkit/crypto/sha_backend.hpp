@@ -0,0 +1,19 @@
+#pragma once
+
+#include <cstdint>
+
+namespace cppkit::crypto
+{
+  // SHA 压缩函数的实现，运行时按 CPU 特性选择
+  enum class ShaBackend : uint8_t
+  {
+    Scalar, // 可移植的标量实现
+    ShaNi,  // x86 SHA 扩展指令
+    Avx2,   // AVX2 多缓冲，8 条消息并行（仅 SHA256::hashMany），单条消息退回标量实现
+  };
+
+  // 当前 CPU 是否支持该实现
+  bool isSupported(ShaBackend backend) noexcept;
+
+  const char* backendName(ShaBackend backend) noexcept;
+} // namespace cppkit::crypto
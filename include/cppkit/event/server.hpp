@@ -6,6 +6,7 @@
 #include <mutex>
 #include <string>
 #include <vector>
+#include <sys/uio.h>
 
 namespace cppkit::event
 {
@@ -39,6 +40,9 @@ namespace cppkit::event
     // 发送数据
     ssize_t send(const uint8_t* data, size_t length) const;
 
+    // 聚集写：一次系统调用发送多段数据
+    ssize_t sendv(const iovec* iov, int count) const;
+
     // 接收数据
     ssize_t recv(uint8_t* data, size_t length) const;
 
@@ -1,7 +1,196 @@
 #pragma once
 
+#include <algorithm>
+#include <array>
+#include <charconv>
+#include <concepts>
+#include <cstdint>
+#include <cstring>
 #include <iostream>
+#include <iterator>
 #include <sstream>
+#include <string>
+#include <string_view>
+#include <tuple>
+#include <type_traits>
+#include <utility>
+
+namespace cppkit
+{
+    // 格式化输出缓冲区：前 N 个字节在对象内部（通常在栈上），写满后自动转到堆上并按倍数扩容
+    template <size_t N = 256>
+    class FixedBuffer
+    {
+    public:
+        FixedBuffer() = default;
+
+        FixedBuffer(const FixedBuffer&) = delete;
+
+        FixedBuffer& operator=(const FixedBuffer&) = delete;
+
+        ~FixedBuffer()
+        {
+            if (_data != _inline)
+            {
+                delete[] _data;
+            }
+        }
+
+        void append(const char* s, const size_t n)
+        {
+            std::memcpy(prepare(n), s, n);
+            _size += n;
+        }
+
+        void append(const std::string_view s) { append(s.data(), s.size()); }
+
+        void push_back(const char c)
+        {
+            if (_size == _capacity)
+            {
+                grow(1);
+            }
+            _data[_size++] = c;
+        }
+
+        // 保证末尾至少还有 n 个可写字节，写完后用 commit 确认实际写入的长度
+        char* prepare(const size_t n)
+        {
+            if (_capacity - _size < n)
+            {
+                grow(n);
+            }
+            return _data + _size;
+        }
+
+        void commit(const size_t n) { _size += n; }
+
+        void clear() { _size = 0; }
+
+        [[nodiscard]] const char* data() const { return _data; }
+
+        [[nodiscard]] size_t size() const { return _size; }
+
+        [[nodiscard]] size_t capacity() const { return _capacity; }
+
+        // 是否还在使用内部存储
+        [[nodiscard]] bool isInline() const { return _data == _inline; }
+
+        [[nodiscard]] std::string_view view() const { return {_data, _size}; }
+
+        [[nodiscard]] std::string str() const { return {_data, _size}; }
+
+    private:
+        void grow(const size_t n)
+        {
+            const size_t capacity = std::max(_capacity * 2, _size + n);
+            auto* data = new char[capacity];
+            std::memcpy(data, _data, _size);
+            if (_data != _inline)
+            {
+                delete[] _data;
+            }
+            _data = data;
+            _capacity = capacity;
+        }
+
+        char _inline[N];
+        char* _data = _inline;
+        size_t _size = 0;
+        size_t _capacity = N;
+    };
+
+    // 把一个参数写进缓冲区。常用类型有专门的实现，其余类型退回 operator<<；
+    // 自定义类型可以特化 Formatter<T>，提供 template <typename Buffer> static void write(Buffer&, const T&)
+    template <typename T>
+    struct Formatter
+    {
+        template <typename Buffer>
+        static void write(Buffer& out, const T& value)
+        {
+            std::ostringstream oss;
+            oss << value;
+            out.append(oss.view());
+        }
+    };
+
+    template <typename T>
+        requires std::is_convertible_v<const T&, std::string_view>
+    struct Formatter<T>
+    {
+        template <typename Buffer>
+        static void write(Buffer& out, const T& value)
+        {
+            out.append(std::string_view(value));
+        }
+    };
+
+    template <std::integral T>
+    struct Formatter<T>
+    {
+        template <typename Buffer>
+        static void write(Buffer& out, const T value)
+        {
+            char* p = out.prepare(24);
+            out.commit(std::to_chars(p, p + 24, value).ptr - p);
+        }
+    };
+
+    // 最短的可往返表示，和 std::format 的 "{}" 一致
+    template <std::floating_point T>
+    struct Formatter<T>
+    {
+        template <typename Buffer>
+        static void write(Buffer& out, const T value)
+        {
+            char* p = out.prepare(64);
+            out.commit(std::to_chars(p, p + 64, value).ptr - p);
+        }
+    };
+
+    template <>
+    struct Formatter<bool>
+    {
+        template <typename Buffer>
+        static void write(Buffer& out, const bool value)
+        {
+            out.append(value ? std::string_view("true") : std::string_view("false"));
+        }
+    };
+
+    template <>
+    struct Formatter<char>
+    {
+        template <typename Buffer>
+        static void write(Buffer& out, const char value)
+        {
+            out.push_back(value);
+        }
+    };
+
+    template <typename T>
+        requires (!std::is_convertible_v<T*, std::string_view>)
+    struct Formatter<T*>
+    {
+        template <typename Buffer>
+        static void write(Buffer& out, const T* value)
+        {
+            char* p = out.prepare(2 + 2 * sizeof(void*));
+            p[0] = '0';
+            p[1] = 'x';
+            const auto end = std::to_chars(p + 2, p + 2 + 2 * sizeof(void*), reinterpret_cast<uintptr_t>(value), 16).ptr;
+            out.commit(end - p);
+        }
+    };
+
+    // format_to_n 的结果：out 为写入结束的位置，size 为完整结果的长度（可能大于写入的长度）
+    template <typename OutputIt>
+    struct FormatToNResult
+    {
+        OutputIt out;
+        size_t size;
+    };
+} // namespace cppkit
 
 namespace cppkit::inner
 {
@@ -31,6 +220,64 @@ namespace cppkit::inner
         return count;
     }
 
+    // 格式串的一段：一段字面量，或者一个参数
+    struct Segment
+    {
+        size_t offset = 0; // 字面量在格式串中的位置
+        size_t length = 0;
+        bool argument = false;
+        size_t index = 0; // 参数下标
+    };
+
+    // 把格式串切成字面量和参数交替的若干段，返回段数；out 为空时只计数。
+    // 转义的 "{{" / "}}" 只保留第一个字符，并在那里结束当前字面量
+    constexpr size_t split_segments(const char* fmt, const size_t len, Segment* out)
+    {
+        size_t count = 0;
+        size_t start = 0;
+        size_t arg = 0;
+        const auto literal = [&](const size_t end)
+        {
+            if (end > start)
+            {
+                if (out)
+                {
+                    out[count] = {start, end - start, false, 0};
+                }
+                ++count;
+            }
+        };
+
+        size_t i = 0;
+        while (i < len)
+        {
+            if (i + 1 < len && ((fmt[i] == '{' && fmt[i + 1] == '{') || (fmt[i] == '}' && fmt[i + 1] == '}')))
+            {
+                literal(i + 1);
+                i += 2;
+                start = i;
+            }
+            else if (i + 1 < len && fmt[i] == '{' && fmt[i + 1] == '}')
+            {
+                literal(i);
+                if (out)
+                {
+                    out[count] = {i, 0, true, arg};
+                }
+                ++count;
+                ++arg;
+                i += 2;
+                start = i;
+            }
+            else
+            {
+                ++i;
+            }
+        }
+        literal(len);
+        return count;
+    }
+
     template <size_t N>
     struct FormatString
     {
@@ -47,82 +294,114 @@ namespace cppkit::inner
         {
             return count_placeholders(str, N);
         }
+
+        [[nodiscard]] constexpr size_t get_segment_count() const
+        {
+            return split_segments(str, length, nullptr);
+        }
     };
 
-    inline void formatImpl(std::ostringstream& oss, const char* fmt)
+    template <FormatString Fmt>
+    consteval auto parseSegments()
     {
-        while (*fmt)
+        std::array<Segment, Fmt.get_segment_count()> segments{};
+        split_segments(Fmt.str, Fmt.length, segments.data());
+        return segments;
+    }
+
+    template <typename T>
+    using FormatterOf = Formatter<std::remove_cvref_t<T>>;
+
+    // 按编译期切好的段依次写出，没有运行期的格式串扫描
+    template <FormatString Fmt, typename Buffer, typename... Args>
+    void formatSegments(Buffer& out, const Args&... args)
+    {
+        static_assert(Fmt.get_placeholder_count() == sizeof...(Args),
+                      "Number of placeholders does not match number of arguments");
+
+        static constexpr auto segments = parseSegments<Fmt>();
+        const std::tuple<const Args&...> tuple(args...);
+        [&]<size_t... I>(std::index_sequence<I...>)
         {
-            if (fmt[0] == '{' && fmt[1] == '{')
+            ([&]
             {
-                oss << '{';
-                fmt += 2;
-                continue;
-            }
-            if (fmt[0] == '}' && fmt[1] == '}')
+                constexpr Segment segment = segments[I];
+                if constexpr (segment.argument)
+                {
+                    using Arg = std::tuple_element_t<segment.index, std::tuple<Args...>>;
+                    FormatterOf<Arg>::write(out, std::get<segment.index>(tuple));
+                }
+                else
+                {
+                    out.append(Fmt.str + segment.offset, segment.length);
+                }
+            }(), ...);
+        }(std::make_index_sequence<segments.size()>{});
+        (void)tuple;
+    }
+
+    // 运行期格式串：边扫描边写出
+    template <typename Buffer>
+    void formatImpl(Buffer& out, const char* fmt)
+    {
+        while (*fmt)
+        {
+            if ((fmt[0] == '{' && fmt[1] == '{') || (fmt[0] == '}' && fmt[1] == '}'))
             {
-                oss << '}';
+                out.push_back(*fmt);
                 fmt += 2;
                 continue;
             }
-            oss << *fmt++;
+            out.push_back(*fmt++);
         }
     }
 
-    template <typename T, typename... Args>
-    void formatImpl(std::ostringstream& oss, const char* fmt, const T& arg,
-                    const Args&... args)
+    template <typename Buffer, typename T, typename... Args>
+    void formatImpl(Buffer& out, const char* fmt, const T& arg, const Args&... args)
     {
         while (*fmt)
         {
-            if (fmt[0] == '{' && fmt[1] == '{')
-            {
-                oss << '{';
-                fmt += 2;
-                continue;
-            }
-            if (fmt[0] == '}' && fmt[1] == '}')
+            if ((fmt[0] == '{' && fmt[1] == '{') || (fmt[0] == '}' && fmt[1] == '}'))
             {
-                oss << '}';
+                out.push_back(*fmt);
                 fmt += 2;
                 continue;
             }
             if (fmt[0] == '{' && fmt[1] == '}')
             {
-                oss << arg;
-                formatImpl(oss, fmt + 2, args...);
+                FormatterOf<T>::write(out, arg);
+                formatImpl(out, fmt + 2, args...);
                 return;
             }
-            oss << *fmt++;
+            // 到下一个 '{' 或 '}' 之前的字面量整段写出
+            const size_t literal = std::max<size_t>(1, std::strcspn(fmt, "{}"));
+            out.append(fmt, literal);
+            fmt += literal;
         }
     }
 
     template <FormatString Fmt, typename... Args>
     std::string safeFmtSprintfImpl(const Args&... args)
     {
-        constexpr size_t expected = Fmt.get_placeholder_count();
-        constexpr size_t actual = sizeof...(Args);
-
-        static_assert(expected == actual,
-                      "Number of placeholders does not match number of arguments");
-
-        std::ostringstream oss;
-        formatImpl(oss, Fmt.str, args...);
-        return oss.str();
+        FixedBuffer<> buffer;
+        formatSegments<Fmt>(buffer, args...);
+        return buffer.str();
     }
 
     template <FormatString Fmt, typename... Args>
     void safeFmtPrintImpl(const Args&... args)
     {
-        std::cout << safeFmtSprintfImpl<Fmt>(args...) << std::endl;
+        FixedBuffer<> buffer;
+        formatSegments<Fmt>(buffer, args...);
+        std::cout << buffer.view() << std::endl;
     }
 
     template <typename... Args>
     std::string runtimeFmtSprintfImpl(const char* fmt, const Args&... args)
     {
-        std::ostringstream oss;
-        formatImpl(oss, fmt, args...);
-        return oss.str();
+        FixedBuffer<> buffer;
+        formatImpl(buffer, fmt, args...);
+        return buffer.str();
     }
 } // namespace cppkit::inner
 
@@ -134,7 +413,40 @@ namespace cppkit
     {
         return inner::runtimeFmtSprintfImpl(fmt, std::forward<Args>(args)...);
     }
-}
+
+    // 编译期切分的格式串，格式化到输出迭代器：cppkit::formatTo<"{}:{}">(std::back_inserter(s), host, port)
+    template <inner::FormatString Fmt, std::output_iterator<char> OutputIt, typename... Args>
+    OutputIt formatTo(OutputIt out, const Args&... args)
+    {
+        FixedBuffer<> buffer;
+        inner::formatSegments<Fmt>(buffer, args...);
+        return std::copy_n(buffer.data(), buffer.size(), out);
+    }
+
+    // 直接追加到缓冲区或字符串末尾，不经过中间缓冲区
+    template <inner::FormatString Fmt, size_t N, typename... Args>
+    void formatTo(FixedBuffer<N>& out, const Args&... args)
+    {
+        inner::formatSegments<Fmt>(out, args...);
+    }
+
+    template <inner::FormatString Fmt, typename... Args>
+    void formatTo(std::string& out, const Args&... args)
+    {
+        FixedBuffer<> buffer;
+        inner::formatSegments<Fmt>(buffer, args...);
+        out.append(buffer.view());
+    }
+
+    // 最多写出 n 个字符
+    template <inner::FormatString Fmt, std::output_iterator<char> OutputIt, typename... Args>
+    FormatToNResult<OutputIt> formatToN(OutputIt out, const size_t n, const Args&... args)
+    {
+        FixedBuffer<> buffer;
+        inner::formatSegments<Fmt>(buffer, args...);
+        return {std::copy_n(buffer.data(), std::min(n, buffer.size()), out), buffer.size()};
+    }
+} // namespace cppkit
 
 
 #define print(fmt_str, ...) inner::safeFmtPrintImpl<fmt_str>(__VA_ARGS__)
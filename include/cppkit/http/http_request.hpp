@@ -2,6 +2,7 @@
 
 #include "common.hpp"
 #include "cppkit/define.hpp"
+#include "cppkit/trace/trace.hpp"
 #include <map>
 #include <sstream>
 #include <string>
@@ -94,6 +95,9 @@ namespace cppkit::http
 
         void setContentType(const std::string& content_type) { this->headers["Content-Type"] = content_type; }
 
+        // 显式指定 traceparent；未设置时 HttpClient 发送请求时使用当前线程的追踪上下文
+        void setTraceContext(const trace::Context& context) { this->headers["traceparent"] = context.traceparent(); }
+
         void addQueryParam(const std::string& key, const std::string& value)
         {
             if (const size_t size = url.find('?'); size == std::string::npos)
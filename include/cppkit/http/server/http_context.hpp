@@ -7,6 +7,7 @@
 #include <cstdio>
 #include <filesystem>
 #include "http_request.hpp"
+#include "http_router.hpp"
 
 namespace cppkit::http::server
 {
@@ -24,15 +25,26 @@ namespace cppkit::http::server
         // 配置：超过此大小使用临时文件（默认 10MB）
         static constexpr size_t BODY_MEMORY_THRESHOLD = 10 * 1024 * 1024;
 
+        // 每次从 socket 读取的大小
+        static constexpr size_t READ_BUFFER_SIZE = 64 * 1024;
+
+        // splice 中转管道的容量
+        static constexpr int SPLICE_PIPE_SIZE = 1024 * 1024;
+
         std::string recvBuffer;                    // 用于接收 Header 的缓冲区
         std::unique_ptr<HttpRequest> request;      // 解析后的请求对象
         std::vector<uint8_t> bodyBuffer;           // Body 缓冲区（小文件）
         std::string tempFilePath;                  // 临时文件路径（大文件）
         int tempFileFd = -1;                       // 临时文件描述符
         size_t contentLength = 0;                  // Content-Length
+        size_t receivedSize = 0;                   // 已接收的 body 字节数
         bool headerParsed = false;                 // Header 是否已解析
         bool useTemporaryFile = false;             // 是否使用临时文件
 
+        // Header 解析完成、开始接收 body 前调用，可以在这里设置 stream 改为流式接收
+        std::function<void(HttpContext&)> onHeaders;
+        BodyStream stream;                         // 设置了 onData 时 body 不再缓存，按到达顺序交给它
+
         ~HttpContext()
         {
             if (tempFileFd >= 0)
@@ -40,6 +52,7 @@ namespace cppkit::http::server
                 close(tempFileFd);
                 tempFileFd = -1;
             }
+            closePipe();
             if (!tempFilePath.empty() && std::filesystem::exists(tempFilePath))
             {
                 std::filesystem::remove(tempFilePath);
@@ -48,14 +61,15 @@ namespace cppkit::http::server
 
         ParseStatus parse(const int fd)
         {
-            char buffer[DEFAULT_BUFFER_SIZE];
+            // 只在事件循环线程上使用
+            thread_local std::vector<char> buffer(READ_BUFFER_SIZE);
 
             // 解析 Header
             if (!headerParsed)
             {
                 while (true)
                 {
-                    const ssize_t len = read(fd, buffer, sizeof(buffer));
+                    const ssize_t len = read(fd, buffer.data(), buffer.size());
 
                     if (len < 0)
                     {
@@ -64,11 +78,12 @@ namespace cppkit::http::server
                     }
                     if (len == 0) return ParseStatus::Error; // 对端关闭
 
-                    recvBuffer.append(buffer, len);
+                    // 只在新数据（连同可能跨段的前 3 个字节）里查找 Header 结束标志
+                    const size_t searchFrom = recvBuffer.size() < 3 ? 0 : recvBuffer.size() - 3;
+                    recvBuffer.append(buffer.data(), len);
 
-                    // 检查 Header 结束标志
                     constexpr std::string_view delimiter = "\r\n\r\n";
-                    if (const size_t pos = recvBuffer.find(delimiter); pos != std::string::npos)
+                    if (const size_t pos = recvBuffer.find(delimiter, searchFrom); pos != std::string::npos)
                     {
                         const size_t headerEnd = pos + delimiter.size();
                         const std::string headerRaw = recvBuffer.substr(0, headerEnd);
@@ -94,119 +109,210 @@ namespace cppkit::http::server
                             return ParseStatus::Error;
                         }
 
-                        // 如果没有 body，直接完成
-                        if (contentLength == 0)
+                        if (onHeaders)
                         {
-                            return ParseStatus::BodyComplete;
+                            onHeaders(*this);
                         }
 
-                        // 判断使用内存还是临时文件
-                        if (contentLength > BODY_MEMORY_THRESHOLD)
-                        {
-                            // 大文件：使用临时文件
-                            useTemporaryFile = true;
-
-                            // 创建临时文件
-                            char tmpTemplate[] = "/tmp/cppkit_upload_XXXXXX";
-                            tempFileFd = mkstemp(tmpTemplate);
-                            if (tempFileFd < 0)
-                            {
-                                return ParseStatus::Error;
-                            }
-                            tempFilePath = tmpTemplate;
-
-                            // 将 extraData 写入临时文件
-                            if (!extraData.empty())
-                            {
-                                if (write(tempFileFd, extraData.data(), extraData.size()) < 0)
-                                {
-                                    return ParseStatus::Error;
-                                }
-                            }
-                        }
-                        else
+                        // 如果没有 body，直接完成
+                        if (contentLength == 0)
                         {
-                            // 小文件：使用内存缓冲区
-                            bodyBuffer.reserve(contentLength);
-                            bodyBuffer.insert(bodyBuffer.end(), extraData.begin(), extraData.end());
+                            return ParseStatus::BodyComplete;
                         }
 
-                        // 如果 extraData 已经包含全部 body
-                        const size_t receivedSize = useTemporaryFile ? extraData.size() : bodyBuffer.size();
-                        if (receivedSize >= contentLength)
+                        const std::span<const uint8_t> extra(reinterpret_cast<const uint8_t*>(extraData.data()),
+                                                             std::min(extraData.size(), contentLength));
+                        if (!beginBody(extra))
                         {
-                            // 已经接收完整
-                            if (useTemporaryFile)
-                            {
-                                request->setTempFilePath(tempFilePath);
-                                close(tempFileFd);
-                                tempFileFd = -1;
-                            }
-                            else
-                            {
-                                bodyBuffer.resize(contentLength);
-                                request->resetBody(bodyBuffer);
-                            }
-                            return ParseStatus::BodyComplete;
+                            return ParseStatus::Error;
                         }
-
                         break;
                     }
                 }
             }
 
             // 读取 Body
-            if (headerParsed)
+            while (receivedSize < contentLength)
             {
-                size_t receivedSize = useTemporaryFile ?
-                    (tempFileFd >= 0 ? lseek(tempFileFd, 0, SEEK_CUR) : 0) : bodyBuffer.size();
-
-                while (receivedSize < contentLength)
+                const size_t remaining = contentLength - receivedSize;
+                ssize_t len;
+                if (stream.onData)
                 {
-                    const size_t remaining = contentLength - receivedSize;
-                    const size_t toRead = std::min(remaining, static_cast<size_t>(DEFAULT_BUFFER_SIZE));
-                    const ssize_t len = read(fd, buffer, toRead);
-
-                    if (len < 0)
+                    len = read(fd, buffer.data(), std::min(remaining, buffer.size()));
+                    if (len > 0 && !stream.onData({reinterpret_cast<const uint8_t*>(buffer.data()),
+                                                   static_cast<size_t>(len)}))
                     {
-                        if (errno == EAGAIN || errno == EWOULDBLOCK)
-                        {
-                            return ParseStatus::Incomplete;
-                        }
                         return ParseStatus::Error;
                     }
-                    if (len == 0) return ParseStatus::Error; // 对端关闭
+                }
+                else if (useTemporaryFile)
+                {
+                    len = spliceToFile(fd, buffer, remaining);
+                }
+                else
+                {
+                    // 直接读到 body 的最终位置，不经过中间缓冲区
+                    len = read(fd, bodyBuffer.data() + receivedSize, remaining);
+                }
 
-                    // 根据策略写入内存或文件
-                    if (useTemporaryFile)
+                if (len < 0)
+                {
+                    if (errno == EAGAIN || errno == EWOULDBLOCK)
                     {
-                        if (write(tempFileFd, buffer, len) < 0)
-                        {
-                            return ParseStatus::Error;
-                        }
+                        return ParseStatus::Incomplete;
                     }
-                    else
+                    return ParseStatus::Error;
+                }
+                if (len == 0) return ParseStatus::Error; // 对端关闭
+                receivedSize += len;
+            }
+
+            finishBody();
+            return ParseStatus::BodyComplete;
+        }
+
+    private:
+        // 按策略安排 body 的去处，并处理随 Header 一起读到的部分
+        bool beginBody(const std::span<const uint8_t> extra)
+        {
+            receivedSize = extra.size();
+            if (stream.onData)
+            {
+                return extra.empty() || stream.onData(extra);
+            }
+
+            // 判断使用内存还是临时文件
+            if (contentLength > BODY_MEMORY_THRESHOLD)
+            {
+                // 大文件：使用临时文件
+                useTemporaryFile = true;
+
+                // 创建临时文件
+                char tmpTemplate[] = "/tmp/cppkit_upload_XXXXXX";
+                tempFileFd = mkstemp(tmpTemplate);
+                if (tempFileFd < 0)
+                {
+                    return false;
+                }
+                tempFilePath = tmpTemplate;
+
+                // 将 extraData 写入临时文件
+                return extra.empty() || writeAll(tempFileFd, extra.data(), extra.size());
+            }
+
+            // 小文件：一次分配到位，后续数据直接读进去
+            bodyBuffer.resize(contentLength);
+            std::copy(extra.begin(), extra.end(), bodyBuffer.begin());
+            return true;
+        }
+
+        // body 交给请求对象：内存中的 body 直接移动过去
+        void finishBody()
+        {
+            closePipe();
+            if (stream.onData)
+            {
+                request->readBodyFlag = true; // body 已经交给了流式处理者
+            }
+            else if (useTemporaryFile)
+            {
+                request->setTempFilePath(tempFilePath);
+                close(tempFileFd);
+                tempFileFd = -1;
+            }
+            else if (contentLength > 0)
+            {
+                request->resetBody(std::move(bodyBuffer));
+            }
+        }
+
+        // socket -> 管道 -> 临时文件，数据不经过用户态；内核不支持时退回 read + write
+        ssize_t spliceToFile(const int fd, std::vector<char>& buffer, const size_t remaining)
+        {
+#if defined(__linux__)
+            if (!spliceUnsupported && pipeFds[0] < 0)
+            {
+                if (pipe2(pipeFds, O_CLOEXEC | O_NONBLOCK) < 0)
+                {
+                    spliceUnsupported = true;
+                }
+                else
+                {
+                    (void)fcntl(pipeFds[1], F_SETPIPE_SZ, SPLICE_PIPE_SIZE);
+                }
+            }
+            if (!spliceUnsupported)
+            {
+                const ssize_t n = splice(fd, nullptr, pipeFds[1], nullptr, std::min<size_t>(remaining, SPLICE_PIPE_SIZE),
+                                         SPLICE_F_MOVE | SPLICE_F_NONBLOCK);
+                if (n < 0 && (errno == EINVAL || errno == ENOSYS))
+                {
+                    spliceUnsupported = true;
+                    closePipe();
+                }
+                else
+                {
+                    // 每次都把管道排空，管道里不会留下数据
+                    for (ssize_t left = n; left > 0;)
                     {
-                        bodyBuffer.insert(bodyBuffer.end(), buffer, buffer + len);
+                        const ssize_t m = splice(pipeFds[0], nullptr, tempFileFd, nullptr, left, SPLICE_F_MOVE);
+                        if (m < 0 && errno == EINTR)
+                        {
+                            continue;
+                        }
+                        if (m <= 0)
+                        {
+                            errno = EIO;
+                            return -1;
+                        }
+                        left -= m;
                     }
-                    receivedSize += len;
+                    return n;
                 }
+            }
+#endif
+            const ssize_t n = read(fd, buffer.data(), std::min(remaining, buffer.size()));
+            if (n > 0 && !writeAll(tempFileFd, buffer.data(), n))
+            {
+                errno = EIO;
+                return -1;
+            }
+            return n;
+        }
 
-                // Body 读取完成
-                if (useTemporaryFile)
+        static bool writeAll(const int fd, const void* data, size_t size)
+        {
+            auto p = static_cast<const char*>(data);
+            while (size > 0)
+            {
+                const ssize_t n = write(fd, p, size);
+                if (n < 0 && errno == EINTR)
                 {
-                    request->setTempFilePath(tempFilePath);
-                    close(tempFileFd);
-                    tempFileFd = -1;
+                    continue;
                 }
-                else
+                if (n <= 0)
                 {
-                    request->resetBody(bodyBuffer);
+                    return false;
                 }
-                return ParseStatus::BodyComplete;
+                p += n;
+                size -= n;
             }
+            return true;
+        }
 
-            return ParseStatus::BodyComplete;
+        void closePipe()
+        {
+            for (int& pipeFd : pipeFds)
+            {
+                if (pipeFd >= 0)
+                {
+                    close(pipeFd);
+                    pipeFd = -1;
+                }
+            }
         }
+
+        int pipeFds[2] = {-1, -1};                 // splice 中转管道
+        bool spliceUnsupported = false;
     };
 }
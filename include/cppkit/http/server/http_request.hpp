@@ -1,6 +1,7 @@
 #pragma once
 
 #include "cppkit/http/http_request.hpp"
+#include "cppkit/trace/trace.hpp"
 #include <vector>
 #include <unordered_map>
 
@@ -33,14 +34,16 @@ namespace cppkit::http::server
         [[nodiscard]]
         HttpMethod getMethod() const;
 
-        // 读取请求体
+        // 读取请求体，返回请求内部的 body，不做拷贝
         [[nodiscard]]
-        std::vector<u_int8_t> readBody() const;
+        const std::vector<u_int8_t>& readBody() const;
 
         size_t readBody(char* buffer, size_t maxLen, size_t offset = 0) const;
 
         void resetBody(const std::vector<uint8_t>& body) const;
 
+        void resetBody(std::vector<uint8_t>&& body) const;
+
         // 解析表单数据
         void parseFormData() const;
 
@@ -64,6 +67,10 @@ namespace cppkit::http::server
         [[nodiscard]]
         std::map<std::string, std::vector<std::string>> getHeaders() const;
 
+        // 解析 traceparent 请求头，没有或不合法时返回无效的上下文
+        [[nodiscard]]
+        trace::Context getTraceContext() const;
+
         // 获取查询参数
         [[nodiscard]]
         std::string getQuery(const std::string& key) const;
@@ -3,10 +3,12 @@
 #include "http_request.hpp"
 #include "http_response.hpp"
 #include <string>
+#include <string_view>
 #include <list>
 #include <unordered_map>
 #include <functional>
 #include <memory>
+#include <span>
 
 namespace cppkit::http::server
 {
@@ -17,12 +19,31 @@ namespace cppkit::http::server
     using MiddlewareHandler = std::function<void(HttpRequest&, HttpResponseWriter&,
                                                  const NextFunc&)>;
 
+    // 一个请求的流式 body 处理：onData 按到达顺序收到 body 的各段，返回 false 时断开连接；
+    // body 收完后调用 onComplete 写响应
+    struct BodyStream
+    {
+        std::function<bool(std::span<const uint8_t>)> onData;
+        HttpHandler onComplete;
+    };
+
+    // 请求头解析完成后为每个请求创建 BodyStream，请求级的状态放在返回的回调里
+    using StreamHandler = std::function<BodyStream(const HttpRequest&)>;
+
+    // 允许直接用 string_view 查找 children，匹配路径时不必为每一段构造 std::string
+    struct SegmentHash
+    {
+        using is_transparent = void;
+
+        size_t operator()(const std::string_view s) const noexcept { return std::hash<std::string_view>{}(s); }
+    };
+
     struct RouteNode
     {
         std::string segment;
         bool isParam = false;
         bool isWild = false;
-        std::unordered_map<std::string, std::unique_ptr<RouteNode>> children;
+        std::unordered_map<std::string, std::unique_ptr<RouteNode>, SegmentHash, std::equal_to<>> children;
         std::unordered_map<std::string, HttpHandler> handlers;
         std::list<MiddlewareHandler> middlewares{};
     };
@@ -56,7 +77,7 @@ namespace cppkit::http::server
 
     private:
         static RouteNode* match(RouteNode* node,
-                                const std::vector<std::string>& parts,
+                                const std::vector<std::string_view>& parts,
                                 size_t index,
                                 std::unordered_map<std::string, std::string>& params);
 
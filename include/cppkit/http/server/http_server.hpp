@@ -8,11 +8,25 @@
 #include <string>
 #include <functional>
 #include <filesystem>
+#include <span>
+#include <unordered_map>
 
 namespace cppkit::http::server
 {
     class GrouterGroup;
 
+    // 协议升级（如 WebSocket）的接管者：升级后连接上的数据与关闭事件都交给它
+    struct UpgradeHandler
+    {
+        // 接管连接：request 是已解析的升级请求，leftover 是请求头之后已经读到的数据；
+        // 由接管者负责发送 101 响应，拒绝时直接关闭连接
+        std::function<void(const event::ConnInfo&, const HttpRequest&, std::span<const uint8_t>)> onUpgrade;
+
+        event::TcpServer::OnMessage onMessage;
+
+        event::TcpServer::OnClose onClose;
+    };
+
     class HttpServer
     {
     public:
@@ -32,6 +46,17 @@ namespace cppkit::http::server
 
         void Delete(const std::string& path, const HttpHandler& handler);
 
+        // 在 path 上以 Prometheus 文本格式导出 metrics::Registry 中的所有指标
+        void Metrics(const std::string& path = "/metrics");
+
+        // 注册流式 body 路由：请求体按到达顺序分段交给 handler 创建的 BodyStream，不在内存或临时文件中缓存；
+        // 按方法和路径精确匹配；请求头到达后先执行该路径上的中间件，中间件未调用 next 时不再接收 body
+        void Stream(HttpMethod method, const std::string& path, const StreamHandler& handler);
+
+        // 注册协议升级路由：path 上带 "Upgrade: <protocol>" 的 GET 请求交给 handler，
+        // 与普通路由共用同一个端口和事件循环；其他请求照常路由
+        void Upgrade(const std::string& path, const std::string& protocol, UpgradeHandler handler);
+
         GrouterGroup group(const std::string& prefix);
 
         ~HttpServer() = default;
@@ -52,6 +77,9 @@ namespace cppkit::http::server
 
         void setStaticDir(std::string_view path, std::string_view dir);
 
+        // 服务器使用的事件循环，供升级后的连接注册事件
+        [[nodiscard]] event::EventLoop* getLoop() { return &_loop; }
+
     private:
         // 添加路由处理函数
         void addRoute(HttpMethod method, const std::string& path, const HttpHandler& handler);
@@ -59,11 +87,23 @@ namespace cppkit::http::server
         // 处理HTTP请求
         void handleRequest(HttpRequest& request, HttpResponseWriter& writer, int writerFd) const;
 
+        // 依次执行 path 上的中间件，全部调用了 next 时返回 true
+        bool runMiddlewares(HttpRequest& request, HttpResponseWriter& writer) const;
+
         // 静态文件处理
         bool staticHandler(const HttpRequest& request, HttpResponseWriter& writer, int writerFd) const;
 
         static size_t sendFile(int fd, const std::filesystem::path& filePath, uintmax_t fileSize);
 
+        // 查找与请求匹配的升级路由
+        [[nodiscard]] const UpgradeHandler* findUpgrade(const HttpRequest& request) const;
+
+        // 请求头解析完成后，匹配流式路由，执行中间件并为请求创建 BodyStream
+        void attachStream(HttpContext& ctx, int fd) const;
+
+        // 读取已升级连接的数据
+        static void readUpgraded(const event::ConnInfo& conn, const UpgradeHandler& handler);
+
         int _port;
         std::string _host;
         Router _router;
@@ -74,5 +114,8 @@ namespace cppkit::http::server
         std::string _staticDir; // 静态文件目录
         uintmax_t _maxFileSize{50 * 1024 * 1024}; // 50 MB
         std::unordered_map<int, HttpContext> contexts;
+        std::unordered_map<std::string, std::pair<std::string, UpgradeHandler>> _upgrades; // path -> (协议, 接管者)
+        std::unordered_map<int, const UpgradeHandler*> _upgraded; // 已升级的连接
+        std::unordered_map<std::string, StreamHandler> _streams; // "方法 路径" -> 流式处理
     };
 } // namespace cppkit::http
@@ -0,0 +1,83 @@
+#pragma once
+
+#include <cstdint>
+#include <functional>
+#include <map>
+#include <span>
+#include <string>
+#include <string_view>
+
+namespace cppkit::http::server
+{
+    // multipart 中一个部分的头信息
+    struct MultipartPart
+    {
+        std::map<std::string, std::string> headers; // 头名称统一为小写
+        std::string name; // Content-Disposition 中的 name
+        std::string filename; // Content-Disposition 中的 filename，普通字段为空
+        std::string contentType;
+    };
+
+    // 增量 multipart/form-data 解析器 (RFC 7578)
+    // 数据可以任意切分后依次喂入，部分内容通过回调分段交出，只缓存不足一个分隔符长度的尾部和部分头，
+    // 可以直接挂在 BodyStream::onData 上边收边写盘
+    class MultipartParser
+    {
+    public:
+        using OnPartBegin = std::function<void(const MultipartPart&)>;
+        using OnPartData = std::function<void(const MultipartPart&, std::span<const uint8_t>)>;
+        using OnPartEnd = std::function<void(const MultipartPart&)>;
+
+        // 部分头的最大长度
+        static constexpr size_t MAX_HEADER_SIZE = 16 * 1024;
+
+        // boundary 为空或超过 70 个字符时抛出 std::invalid_argument
+        explicit MultipartParser(std::string_view boundary);
+
+        // 从 Content-Type 中取出 boundary，不是 multipart 或没有 boundary 时返回空
+        static std::string boundaryFrom(std::string_view contentType);
+
+        void setOnPartBegin(OnPartBegin callback) { _onPartBegin = std::move(callback); }
+
+        void setOnPartData(OnPartData callback) { _onPartData = std::move(callback); }
+
+        void setOnPartEnd(OnPartEnd callback) { _onPartEnd = std::move(callback); }
+
+        // 喂入下一段数据，格式错误时返回 false，之后的数据都会被拒绝
+        bool feed(std::span<const uint8_t> data);
+
+        bool feed(const std::string_view data)
+        {
+            return feed({reinterpret_cast<const uint8_t*>(data.data()), data.size()});
+        }
+
+        // 是否已经读到结束分隔符
+        [[nodiscard]] bool done() const { return _state == State::Done; }
+
+    private:
+        enum class State
+        {
+            Preamble,
+            AfterDelimiter,
+            Headers,
+            Body,
+            Done,
+            Error
+        };
+
+        // 当前部分结束，进入下一个分隔符之后的状态
+        void endPart();
+
+        bool parseHeaders(std::string_view raw);
+
+        void emit(std::string_view data) const;
+
+        std::string _delimiter; // "\r\n--" + boundary
+        State _state{State::Preamble};
+        std::string _pending; // 未处理完的数据：分隔符可能的前缀或不完整的头
+        MultipartPart _part;
+        OnPartBegin _onPartBegin;
+        OnPartData _onPartData;
+        OnPartEnd _onPartEnd;
+    };
+} // namespace cppkit::http::server
@@ -0,0 +1,156 @@
+#pragma once
+
+#include "io.hpp"
+#include "cppkit/event/ae.hpp"
+#include "cppkit/concurrency/thread_pool.hpp"
+
+#include <coroutine>
+#include <cstdint>
+#include <deque>
+#include <functional>
+#include <memory>
+#include <sys/types.h>
+#include <vector>
+
+namespace cppkit::io
+{
+  // 异步 IO 完成回调，参数为传输的字节数，失败时为 -errno
+  using IoCallback = std::function<void(ssize_t result)>;
+
+  // 默认最大在途请求数
+  constexpr unsigned DEFAULT_IO_QUEUE_DEPTH = 128;
+
+  enum class IoBackend
+  {
+    AUTO, // 内核支持时用 io_uring，否则退回线程池
+    IO_URING,
+    THREAD_POOL
+  };
+
+  struct IoEngineConfig
+  {
+    // 同时提交给内核或线程池的最大请求数，超出的请求在引擎内排队
+    unsigned queueDepth{DEFAULT_IO_QUEUE_DEPTH};
+
+    IoBackend backend{IoBackend::AUTO};
+
+    // 线程池后端使用的线程池；为 nullptr 时引擎自建 fallbackThreads 个线程
+    concurrency::ThreadPool* executor{nullptr};
+
+    size_t fallbackThreads{4};
+  };
+
+  // 基于事件循环的异步文件 IO 引擎
+  // 请求先进入队列，同一轮事件循环中提交的请求合并为一次 io_uring_enter（或按线程数切分成几个线程池任务）
+  // 完成通知经 eventfd 回到事件循环线程，回调和协程都在该线程上执行；除构造外所有方法都只能在该线程调用
+  class IoEngine
+  {
+  public:
+    enum class Op : uint8_t
+    {
+      READ,
+      WRITE,
+      FSYNC,
+      FDATASYNC
+    };
+
+    // co_await 的结果与 IoCallback 的参数相同；协程在事件循环线程上恢复
+    class Awaiter
+    {
+    public:
+      Awaiter(IoEngine* engine, const Op op, const int fd, void* buffer, const size_t length, const uint64_t offset)
+        : _engine(engine), _op(op), _fd(fd), _buffer(buffer), _length(length), _offset(offset)
+      {
+      }
+
+      [[nodiscard]] bool await_ready() const noexcept { return false; }
+
+      void await_suspend(std::coroutine_handle<> handle);
+
+      [[nodiscard]] ssize_t await_resume() const noexcept { return _result; }
+
+    private:
+      IoEngine* _engine;
+      Op _op;
+      int _fd;
+      void* _buffer;
+      size_t _length;
+      uint64_t _offset;
+      ssize_t _result{0};
+    };
+
+    // io_uring 不可用且 backend 为 IO_URING 时抛出 std::runtime_error
+    explicit IoEngine(event::EventLoop* loop, const IoEngineConfig& config = {});
+
+    // 等待所有在途请求结束，未执行的回调被丢弃
+    ~IoEngine();
+
+    IoEngine(const IoEngine&) = delete;
+
+    IoEngine& operator=(const IoEngine&) = delete;
+
+    void read(int fd, void* buffer, size_t length, uint64_t offset, IoCallback callback);
+
+    void write(int fd, const void* buffer, size_t length, uint64_t offset, IoCallback callback);
+
+    // dataOnly 为 true 时相当于 fdatasync
+    void fsync(int fd, bool dataOnly, IoCallback callback);
+
+    [[nodiscard]] Awaiter read(int fd, void* buffer, size_t length, uint64_t offset);
+
+    [[nodiscard]] Awaiter write(int fd, const void* buffer, size_t length, uint64_t offset);
+
+    [[nodiscard]] Awaiter fsync(int fd, bool dataOnly = false);
+
+    // 立即提交排队的请求，不等到本轮事件循环结束
+    void submit();
+
+    [[nodiscard]] bool usingIoUring() const { return _ring != nullptr; }
+
+    [[nodiscard]] unsigned queueDepth() const { return _queueDepth; }
+
+    // 已提交尚未完成的请求数
+    [[nodiscard]] size_t inflight() const { return _inflight; }
+
+    // 因队列深度限制还在排队的请求数
+    [[nodiscard]] size_t queued() const { return _backlog.size(); }
+
+  private:
+    struct Request
+    {
+      Op op;
+      int fd;
+      void* buffer;
+      size_t length;
+      uint64_t offset;
+      IoCallback callback;
+    };
+
+    struct Ring;
+
+    struct Completions;
+
+    void enqueue(Request request);
+
+    // 事件循环线程读到 eventfd 后收割完成的请求
+    void onCompletion();
+
+    // 线程池后端同步执行一个请求
+    static ssize_t execute(const Request& request);
+
+    event::EventLoop* _loop;
+    unsigned _queueDepth;
+    int _eventFd{-1};
+    std::unique_ptr<Ring> _ring;
+    std::shared_ptr<Completions> _completions;
+    std::unique_ptr<concurrency::ThreadPool> _ownPool;
+    concurrency::ThreadPool* _pool{nullptr};
+    size_t _poolThreads{1};
+
+    std::deque<Request> _backlog;
+    std::vector<IoCallback> _slots; // 按槽位保存在途请求的回调，槽位号即 user_data
+    std::vector<uint32_t> _freeSlots;
+    size_t _inflight{0};
+    int64_t _submitEvent{-1}; // 本轮结束时提交的定时事件，-1 表示未安排
+  };
+} // namespace cppkit::io
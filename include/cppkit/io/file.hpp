@@ -1,12 +1,13 @@
 #pragma once
 
 #include "io.hpp"
+#include "mapped_file.hpp"
+#include "async_io.hpp"
 #include "cppkit/define.hpp"
 
 #include <filesystem>
 #include <string>
 #include <vector>
-#include <fstream>
 #include <functional>
 #include <mutex>
 
@@ -25,13 +26,13 @@ namespace cppkit::io
 
     File(const File&) = delete;
 
-    File(File&&) noexcept = default;
+    File(File&& other) noexcept;
 
     File& operator=(const File&) = delete;
 
-    File& operator=(File&&) noexcept = default;
+    File& operator=(File&& other) noexcept;
 
-    ~File() = default;
+    ~File();
 
     // 获取文件大小，单位字节
     [[nodiscard]] size_t size() const;
@@ -87,23 +88,43 @@ namespace cppkit::io
     // 重命名文件或目录
     [[nodiscard]] bool renameTo(const File& dest) const;
 
-    // 读取文件内容到缓冲区
+    // 读取文件内容到缓冲区，基于 pread，不改变共享的文件位置
     size_t read(char* buffer, size_t size, size_t offset = 0) const;
 
-    // 写入缓冲区内容到文件
+    // 写入缓冲区内容到文件，基于 pwrite，数据直接进入页缓存，无需 flush
     size_t write(const char* buffer, size_t size, size_t offset = 0, bool append = false) const;
 
     // 以块的形式读取文件内容，回调函数处理每块数据
+    // 内部按 DEFAULT_MAP_WINDOW 大窗口映射，回调仍按 chunk 大小切分
     size_t read(const std::function<void(const char*, ssize_t)>& fun, size_t offset = 0, int chunk = DEFAULT_BUFFER_SIZE) const;
 
+    // 提示内核预读 [offset, offset + length)，length 为 0 表示到文件末尾
+    void readahead(size_t offset, size_t length = 0) const;
+
+    // 映射整个文件，失败时抛出 std::runtime_error
+    [[nodiscard]] MappedFile map(const MapOptions& options = {}) const;
+
+    // 异步读写，经 engine 提交，回调在其事件循环线程上执行；buffer 在完成前必须保持有效
+    // 文件打开失败时结果为 -EBADF
+    void readAsync(IoEngine& engine, char* buffer, size_t size, size_t offset, IoCallback callback) const;
+
+    void writeAsync(IoEngine& engine, const char* buffer, size_t size, size_t offset, IoCallback callback) const;
+
+    void fsyncAsync(IoEngine& engine, IoCallback callback, bool dataOnly = false) const;
+
+    // 协程版本：co_await 得到与回调参数相同的结果
+    [[nodiscard]] IoEngine::Awaiter readAsync(IoEngine& engine, char* buffer, size_t size, size_t offset = 0) const;
+
+    [[nodiscard]] IoEngine::Awaiter writeAsync(IoEngine& engine, const char* buffer, size_t size, size_t offset = 0) const;
+
+    [[nodiscard]] IoEngine::Awaiter fsyncAsync(IoEngine& engine, bool dataOnly = false) const;
+
   private:
     bool open() const;
 
     void close() const;
 
     std::filesystem::path _path;
-    mutable std::ifstream _ifs;
-    mutable std::ofstream _ofs;
-    mutable bool _isOpen{false};
+    mutable int _fd{-1};
   };
 } // namespace cppkit::io
\ No newline at end of file
@@ -0,0 +1,84 @@
+#pragma once
+
+#include "io.hpp"
+
+#include <cstdint>
+#include <span>
+#include <string>
+#include <string_view>
+
+namespace cppkit::io
+{
+  // 流式读取时每次映射的窗口大小
+  constexpr size_t DEFAULT_MAP_WINDOW = 64 * 1024 * 1024; // 64MB
+
+  // 映射选项
+  struct MapOptions
+  {
+    // MADV_SEQUENTIAL：顺序访问，内核加大预读并及时回收读过的页
+    bool sequential{true};
+
+    // MADV_WILLNEED：映射后立即异步预读整个范围
+    bool willNeed{false};
+
+    // MAP_POPULATE：映射时同步读入并建立页表，之后访问不再缺页
+    bool populate{false};
+
+    // MADV_HUGEPAGE：尽量使用透明大页，文件系统不支持时忽略
+    bool hugePages{false};
+  };
+
+  // 只读内存映射文件，映射整个文件或其中一段，析构时解除映射
+  class MappedFile
+  {
+  public:
+    MappedFile() = default;
+
+    // 映射整个文件，失败时抛出 std::runtime_error
+    explicit MappedFile(const std::string& path, const MapOptions& options = {});
+
+    // 映射文件中 [offset, offset + length) 的一段，超出文件末尾的部分被截断
+    MappedFile(const std::string& path, size_t offset, size_t length, const MapOptions& options = {});
+
+    // 从已打开的描述符映射一段，不接管 fd，映射在 fd 关闭后仍然有效
+    MappedFile(int fd, size_t offset, size_t length, const MapOptions& options = {});
+
+    MappedFile(const MappedFile&) = delete;
+
+    MappedFile& operator=(const MappedFile&) = delete;
+
+    MappedFile(MappedFile&& other) noexcept;
+
+    MappedFile& operator=(MappedFile&& other) noexcept;
+
+    ~MappedFile();
+
+    [[nodiscard]] const uint8_t* data() const { return _data; }
+
+    [[nodiscard]] size_t size() const { return _size; }
+
+    [[nodiscard]] bool empty() const { return _size == 0; }
+
+    // 映射起点在文件中的偏移
+    [[nodiscard]] size_t offset() const { return _offset; }
+
+    [[nodiscard]] std::span<const uint8_t> bytes() const { return {_data, _size}; }
+
+    [[nodiscard]] std::string_view view() const { return {reinterpret_cast<const char*>(_data), _size}; }
+
+    // 提示内核预读映射内的一段（相对映射起点）
+    void willNeed(size_t offset, size_t length) const;
+
+    // 提前解除映射
+    void unmap();
+
+  private:
+    void map(int fd, size_t offset, size_t length, const MapOptions& options);
+
+    void* _base{nullptr}; // 页对齐的映射起点
+    size_t _mapLength{0};
+    const uint8_t* _data{nullptr};
+    size_t _size{0};
+    size_t _offset{0};
+  };
+} // namespace cppkit::io
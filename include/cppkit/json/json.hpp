@@ -1,17 +1,27 @@
 #pragma once
 
+#include "cppkit/arena.hpp"
 #include "cppkit/reflection/reflection.hpp"
 #include <type_traits>
 #include <cctype>
-#include <iomanip>
+#include <charconv>
+#include <cstdint>
+#include <cstring>
+#include <deque>
+#include <initializer_list>
 #include <map>
+#include <memory>
+#include <new>
 #include <set>
+#include <unordered_map>
 #include <unordered_set>
 #include <sstream>
 #include <stdexcept>
+#include <string>
+#include <string_view>
+#include <utility>
 #include <vector>
 #include <list>
-#include <variant>
 #include <functional>
 #include <iostream>
 
@@ -90,550 +100,1015 @@ namespace cppkit::json
 
         template <typename T>
         constexpr bool is_reflectable_v = is_reflectable<T>::value;
+
+        // REFLECT 注册的字段数量（不含方法）
+        template <typename T>
+        consteval size_t reflectedFieldCount()
+        {
+            return std::apply([]<typename... Items>(const Items&...)
+            {
+                return (size_t{0} + ... + size_t{reflection::internal::is_field_tag_v<Items>});
+            }, reflection::MetaData<T>::info());
+        }
     }
 
-    class Json
+    class Json;
+
+    class JsonArray;
+
+    class JsonObject;
+
+    struct JsonMember;
+
+    class JsonNumberRef;
+
+    namespace internal
     {
-    public:
-        using array = std::vector<Json>;
-        using object = std::map<std::string, Json>;
-        using value_type = std::variant<std::nullptr_t, bool, double, std::string, array, object>;
+        class JsonParser;
 
-        value_type v;
+        // 一次解析对应一个 arena；dirty 表示树中可能混入了堆上分配的节点，释放时需要遍历
+        struct JsonArena : Arena
+        {
+            bool dirty = false;
+        };
+    }
+
+    // const 访问字符串得到的视图，可隐式转换为 std::string，兼容按 const std::string& 使用的旧代码
+    class JsonString : public std::string_view
+    {
+    public:
+        using std::string_view::string_view;
 
-        Json() noexcept : v(nullptr)
+        explicit JsonString(const std::string_view s) noexcept : std::string_view(s)
         {
         }
 
-        explicit Json(std::nullptr_t) noexcept : v(nullptr)
+        operator std::string() const { return std::string(data(), size()); }
+
+        [[nodiscard]]
+        std::string str() const { return std::string(data(), size()); }
+    };
+
+    // JSON 值：16 字节的带标签节点
+    //  - 数字区分 int64 / uint64 / double
+    //  - 不超过 14 字节的字符串直接内联存储
+    //  - 数组、对象是连续存储的 JsonArray / JsonObject（对象按 key 有序）
+    // Json::parse 得到的容器和长字符串分配在同一个 arena 中，随根节点一起整体释放；
+    // 从 arena 中拷贝或移动出来的值总是会深拷贝到堆上，因此不会悬挂
+    // （Json x = std::move(doc["huge"]) 会复制整棵子树，想避免复制应保留对 doc 的引用）
+    class Json
+    {
+    public:
+        using array = JsonArray;
+        using object = JsonObject;
+
+        enum class Type : uint8_t
+        {
+            Null,
+            Bool,
+            Int,
+            Uint,
+            Double,
+            String,
+            Array,
+            Object
+        };
+
+        // 内联字符串的最大长度
+        static constexpr size_t kSmallStringSize = 14;
+
+        Json() noexcept { setNull(); }
+
+        explicit Json(std::nullptr_t) noexcept { setNull(); }
+
+        explicit Json(const bool b) noexcept { setBool(b); }
+
+        explicit Json(const int i) noexcept { setInt(i); }
+
+        explicit Json(const long l) noexcept { setInt(l); }
+
+        explicit Json(const double d) noexcept { setDouble(d); }
+
+        explicit Json(const char* s) { setString(std::string_view(s), nullptr); }
+
+        explicit Json(const std::string& s) { setString(s, nullptr); }
+
+        explicit Json(const std::string_view s) { setString(s, nullptr); }
+
+        explicit Json(const array& a);
+
+        explicit Json(array&& a);
+
+        explicit Json(const object& o);
+
+        explicit Json(object&& o);
+
+        template <typename T, typename = std::enable_if_t<
+                                  !std::is_same_v<std::decay_t<T>, Json> &&
+                                  !std::is_same_v<std::decay_t<T>, array> &&
+                                  !std::is_same_v<std::decay_t<T>, object>>>
+        explicit Json(T&& obj)
         {
+            setNull();
+            assign(std::forward<T>(obj));
         }
 
-        explicit Json(bool b) noexcept : v(b)
+        Json(const Json& other) { copyFrom(other); }
+
+        // 源节点位于 arena 中时会深拷贝整棵子树，可能抛出 std::bad_alloc，因此不是 noexcept
+        Json(Json&& other) { moveFrom(other); }
+
+        ~Json() { destroy(); }
+
+        Json& operator=(const Json& other)
         {
+            if (this != &other)
+            {
+                Json tmp(other);
+                destroy();
+                takeFrom(tmp);
+            }
+            return *this;
         }
 
-        explicit Json(const int i) noexcept : v(static_cast<double>(i))
+        Json& operator=(Json&& other)
         {
+            if (this != &other)
+            {
+                // other 可能位于 *this 的子树中，先取出再释放旧值
+                Json tmp(std::move(other));
+                destroy();
+                takeFrom(tmp);
+            }
+            return *this;
         }
 
-        explicit Json(const long l) noexcept : v(static_cast<double>(l))
+        static Json makeArray();
+
+        static Json makeObject();
+
+        [[nodiscard]]
+        Type type() const noexcept;
+
+        [[nodiscard]]
+        bool isNull() const noexcept { return kind() == kNull; }
+
+        [[nodiscard]]
+        bool isBool() const noexcept { return kind() == kBool; }
+
+        [[nodiscard]]
+        bool isNumber() const noexcept { return kind() >= kInt && kind() <= kDouble; }
+
+        // 整数（int64 或 uint64 表示）
+        [[nodiscard]]
+        bool isInteger() const noexcept { return kind() == kInt || kind() == kUint; }
+
+        [[nodiscard]]
+        bool isDouble() const noexcept { return kind() == kDouble; }
+
+        [[nodiscard]]
+        bool isString() const noexcept { return kind() >= kSmallString && kind() <= kStdString; }
+
+        [[nodiscard]]
+        bool isArray() const noexcept { return kind() == kArray; }
+
+        [[nodiscard]]
+        bool isObject() const noexcept { return kind() == kObject; }
+
+        [[nodiscard]]
+        bool asBool() const
         {
+            if (!isBool())
+                throw std::runtime_error("json: not a bool");
+            return load<bool>();
         }
 
-        explicit Json(double d) noexcept : v(d)
+        bool& asBool()
         {
+            if (!isBool())
+                throw std::runtime_error("json: not a bool");
+            return *std::launder(reinterpret_cast<bool*>(data_));
         }
 
-        explicit Json(const char* s) : v(std::string(s))
+        // 任意数字按 double 返回
+        [[nodiscard]]
+        double asNumber() const;
+
+        // 可写的数字引用：读取时不改变节点，写入（=、+= 等）后节点变为 double
+        JsonNumberRef asNumber();
+
+        [[nodiscard]]
+        int64_t asInt64() const;
+
+        [[nodiscard]]
+        uint64_t asUint64() const;
+
+        [[nodiscard]]
+        JsonString asString() const
         {
+            if (kind() == kSmallString)
+                return {reinterpret_cast<const char*>(data_), data_[kSmallLengthOffset]};
+            if (kind() == kString)
+                return {load<const char*>(), longLength()};
+            if (kind() == kStdString)
+                return JsonString(*load<const std::string*>());
+            throw std::runtime_error("json: not a string");
         }
 
-        explicit Json(const std::string& s) : v(s)
+        // 可写的字符串：第一次调用时把内联或 arena 中的字符串转为堆上的 std::string
+        std::string& asString();
+
+        array& asArray();
+
+        object& asObject();
+
+        [[nodiscard]]
+        const array& asArray() const;
+
+        [[nodiscard]]
+        const object& asObject() const;
+
+        // 非对象时会被替换为空对象，key 不存在时插入 null
+        Json& operator[](std::string_view key);
+
+        const Json& operator[](std::string_view key) const { return at(key); }
+
+        Json& operator[](size_t idx);
+
+        const Json& operator[](size_t idx) const { return at(idx); }
+
+        [[nodiscard]]
+        const Json& at(std::string_view key) const;
+
+        [[nodiscard]]
+        const Json& at(size_t idx) const;
+
+        [[nodiscard]]
+        bool contains(std::string_view key) const;
+
+        // 数组或对象的元素个数，其他类型为 0
+        [[nodiscard]]
+        size_t size() const noexcept;
+
+        void swap(Json& other)
         {
+            Json tmp(std::move(other));
+            other = std::move(*this);
+            *this = std::move(tmp);
         }
 
-        explicit Json(std::string&& s) : v(std::string(std::move(s)))
+        friend bool operator==(const Json& lhs, const Json& rhs);
+
+        // Assignment operators
+        Json& operator=(std::nullptr_t) noexcept
         {
+            destroy();
+            setNull();
+            return *this;
         }
 
-        explicit Json(const array& a) : v(a)
+        Json& operator=(const bool b) noexcept
         {
+            destroy();
+            setBool(b);
+            return *this;
         }
 
-        explicit Json(array&& a) : v(std::move(a))
+        Json& operator=(const int i) noexcept
         {
+            destroy();
+            setInt(i);
+            return *this;
         }
 
-        explicit Json(const object& o) : v(o)
+        Json& operator=(const long l) noexcept
         {
+            destroy();
+            setInt(l);
+            return *this;
         }
 
-        explicit Json(object&& o) : v(std::move(o))
+        Json& operator=(const double d) noexcept
         {
+            destroy();
+            setDouble(d);
+            return *this;
         }
 
-        static Json makeArray() { return Json(array{}); }
+        Json& operator=(const char* s) { return *this = Json(s); }
 
-        static Json makeObject() { return Json(object{}); }
+        Json& operator=(const std::string& s) { return *this = Json(s); }
 
-        [[nodiscard]]
-        bool isNull() const { return std::holds_alternative<std::nullptr_t>(v); }
+        Json& operator=(const std::string_view s) { return *this = Json(s); }
 
-        [[nodiscard]]
-        bool isBool() const { return std::holds_alternative<bool>(v); }
+        Json& operator=(const array& a) { return *this = Json(a); }
 
-        [[nodiscard]]
-        bool isNumber() const { return std::holds_alternative<double>(v); }
+        Json& operator=(array&& a) { return *this = Json(std::move(a)); }
 
-        [[nodiscard]]
-        bool isString() const { return std::holds_alternative<std::string>(v); }
+        Json& operator=(const object& o) { return *this = Json(o); }
 
-        [[nodiscard]]
-        bool isArray() const { return std::holds_alternative<array>(v); }
+        Json& operator=(object&& o) { return *this = Json(std::move(o)); }
 
-        [[nodiscard]]
-        bool isObject() const { return std::holds_alternative<object>(v); }
+        template <typename T, typename = std::enable_if_t<
+                                  !std::is_same_v<std::decay_t<T>, Json> &&
+                                  !std::is_same_v<std::decay_t<T>, array> &&
+                                  !std::is_same_v<std::decay_t<T>, object>>>
+        Json& operator=(T&& obj)
+        {
+            return *this = Json(std::forward<T>(obj));
+        }
 
-        bool& asBool() { return std::get<bool>(v); }
+        // Serialization
+        [[nodiscard]]
+        std::string dump(bool pretty = false, int indent_size = 2) const;
 
-        double& asNumber() { return std::get<double>(v); }
+        // 直接序列化到调用方提供的输出（std::string、OutputBuffer 等），见 json_writer.hpp
+        template <typename Sink>
+        void dumpTo(Sink& out, bool pretty = false, int indentSize = 2) const;
 
-        std::string& asString() { return std::get<std::string>(v); }
+        // 容器和长字符串分配在根节点持有的 arena 中
+        static Json parse(std::string_view s);
 
-        array& asArray() { return std::get<array>(v); }
+    private:
+        friend class JsonArray;
+        friend class JsonObject;
+        friend class JsonBatch;
+        friend class JsonNumberRef;
+        friend class internal::JsonParser;
 
-        object& asObject() { return std::get<object>(v); }
+        enum Kind : uint8_t
+        {
+            kNull,
+            kBool,
+            kInt,
+            kUint,
+            kDouble,
+            kSmallString,
+            kString,
+            kStdString, // asString() 的可写形式，存放 std::string*
+            kArray,
+            kObject
+        };
 
-        [[nodiscard]]
-        const bool& asBool() const { return std::get<bool>(v); }
+        static constexpr uint8_t kKindMask = 0x0F;
+        // 存储位于 arena 中，不能单独释放
+        static constexpr uint8_t kInArena = 0x40;
+        // 根节点，持有容器所在的 arena
+        static constexpr uint8_t kArenaRoot = 0x80;
+        static constexpr size_t kLengthOffset = 8;
+        static constexpr size_t kSmallLengthOffset = 14;
 
         [[nodiscard]]
-        const double& asNumber() const { return std::get<double>(v); }
+        Kind kind() const noexcept { return static_cast<Kind>(tag_ & kKindMask); }
 
-        [[nodiscard]]
-        const std::string& asString() const { return std::get<std::string>(v); }
+        template <typename T>
+        [[nodiscard]] T load() const noexcept
+        {
+            T value;
+            std::memcpy(&value, data_, sizeof(T));
+            return value;
+        }
 
-        [[nodiscard]]
-        const array& asArray() const { return std::get<array>(v); }
+        template <typename T>
+        void store(const Kind kind, const T value) noexcept
+        {
+            std::memcpy(data_, &value, sizeof(T));
+            tag_ = kind;
+        }
 
         [[nodiscard]]
-        const object& asObject() const { return std::get<object>(v); }
-
-        Json& operator[](const std::string& key)
+        uint32_t longLength() const noexcept
         {
-            if (!isObject())
-                v = object{};
-            return std::get<object>(v)[key];
+            uint32_t n;
+            std::memcpy(&n, data_ + kLengthOffset, sizeof(n));
+            return n;
         }
 
-        const Json& operator[](const std::string& key) const { return std::get<object>(v).at(key); }
+        void setNull() noexcept { store<uint64_t>(kNull, 0); }
 
-        Json& operator[](const size_t idx)
+        // bool 放在第一个字节，asBool() 可以直接返回引用
+        void setBool(const bool b) noexcept
         {
-            if (!isArray())
-                throw std::runtime_error("not an array");
-            return std::get<array>(v).at(idx);
+            store<uint64_t>(kBool, 0);
+            std::memcpy(data_, &b, sizeof(b));
         }
 
-        template <typename T, typename = std::enable_if_t<
-                                  !std::is_same_v<std::decay_t<T>, Json> &&
-                                  !std::is_same_v<std::decay_t<T>, array> &&
-                                  !std::is_same_v<std::decay_t<T>, object>>>
-        explicit Json(const T& obj)
+        void setInt(const int64_t i) noexcept { store(kInt, i); }
+
+        void setUint(const uint64_t u) noexcept
         {
-            using DecayT = std::decay_t<T>;
-            if constexpr (std::is_arithmetic_v<DecayT>)
-            {
-                if constexpr (std::is_same_v<DecayT, bool>)
-                {
-                    v = static_cast<bool>(obj);
-                }
-                else
-                {
-                    v = static_cast<double>(obj);
-                }
-            }
-            else if constexpr (std::is_convertible_v<T, std::string_view>)
-            {
-                v = std::string(obj);
-            }
-            else if constexpr (internal::is_sequence_container_v<T>)
-            {
-                array arr;
-                arr.reserve(obj.size());
-                for (const auto& item : obj)
-                {
-                    arr.emplace_back(item);
-                }
-                v = std::move(arr);
-            }
-            else if constexpr (internal::is_map_container_v<T>)
-            {
-                object objJson;
-                for (const auto& [key, value] : obj)
-                {
-                    objJson.emplace(key, Json(value));
-                }
-                v = std::move(objJson);
-            }
-            else if constexpr (internal::is_reflectable_v<DecayT>)
-            {
-                object objJson;
-                reflection::forEachField(obj, [&](const std::string_view name, const auto& value)
-                {
-                    objJson.emplace(name, Json(value));
-                });
-                v = std::move(objJson);
-            }
+            if (u <= static_cast<uint64_t>(INT64_MAX))
+                store(kInt, static_cast<int64_t>(u));
             else
-            {
-                static_assert(internal::is_reflectable_v<T>,
-                              "Type is not reflectable. Please register it using REFLECT macro.");
-            }
+                store(kUint, u);
         }
 
-        template <typename T, typename = std::enable_if_t<
-                                  !std::is_same_v<std::decay_t<T>, Json> &&
-                                  !std::is_same_v<std::decay_t<T>, array> &&
-                                  !std::is_same_v<std::decay_t<T>, object>>>
-        explicit Json(T&& obj) noexcept(std::is_nothrow_move_constructible_v<T>)
+        void setDouble(const double d) noexcept { store(kDouble, d); }
+
+        // arena 为空时长字符串分配在堆上
+        void setString(std::string_view s, internal::JsonArena* arena);
+
+        void setArray(JsonArray* a, uint8_t flags) noexcept;
+
+        void setObject(JsonObject* o, uint8_t flags) noexcept;
+
+        void copyFrom(const Json& other);
+
+        void moveFrom(Json& other);
+
+        // 按位接管 src（调用前 *this 必须已释放），src 置为 null
+        void takeFrom(Json& src) noexcept
         {
-            using DecayT = std::decay_t<T>;
-            if constexpr (std::is_arithmetic_v<DecayT>)
-            {
-                if constexpr (std::is_same_v<DecayT, bool>)
-                {
-                    v = static_cast<bool>(obj);
-                }
-                else
-                {
-                    v = static_cast<double>(obj);
-                }
-            }
-            else if constexpr (std::is_convertible_v<T, std::string_view>)
-            {
-                v = std::string(std::forward<T>(obj));
-            }
-            else if constexpr (internal::is_sequence_container_v<T>)
-            {
-                array arr;
-                arr.reserve(obj.size());
-                for (auto& item : obj)
-                {
-                    arr.emplace_back(std::move(item));
-                }
-                v = std::move(arr);
-            }
-            else if constexpr (internal::is_map_container_v<T>)
-            {
-                object objJson;
-                for (auto&& [key, value] : obj)
-                {
-                    objJson.emplace(std::move(key), Json(std::move(value)));
-                }
-                v = std::move(objJson);
-            }
-            else if constexpr (internal::is_reflectable_v<DecayT>)
-            {
-                object objJson;
-                reflection::forEachField(std::forward<T>(obj), [&]<typename T0>(const std::string_view name, T0&& value)
-                {
-                    objJson.emplace(name, Json(std::forward<T0>(value)));
-                });
-                v = std::move(objJson);
-            }
-            else
-            {
-                static_assert(internal::is_reflectable_v<T>,
-                              "Type is not reflectable. Please register it using REFLECT macro.");
-            }
+            std::memcpy(static_cast<void*>(this), static_cast<void*>(&src), sizeof(Json));
+            src.setNull();
         }
 
-        // Assignment operators
-        Json& operator=(std::nullptr_t) noexcept
+        void destroy() noexcept;
+
+        // 将子树中不属于 arena 的节点释放掉（arena 本身由调用方整体释放）
+        static void releaseForeign(Json& node) noexcept;
+
+        template <typename T>
+        void assign(T&& obj);
+
+        alignas(8) unsigned char data_[15];
+        uint8_t tag_;
+    };
+
+    static_assert(sizeof(Json) == 16, "Json node must stay 16 bytes");
+
+    // 对象的 key：与 Json 字符串相同的存储方式（短 key 内联）
+    class JsonKey
+    {
+    public:
+        JsonKey() = default;
+
+        explicit JsonKey(const std::string_view s) : node_(s)
         {
-            v = nullptr;
-            return *this;
         }
 
-        Json& operator=(bool b) noexcept
+        operator std::string_view() const noexcept { return view(); }
+
+        [[nodiscard]]
+        std::string_view view() const noexcept { return node_.isString() ? node_.asString() : std::string_view{}; }
+
+        [[nodiscard]]
+        const char* data() const noexcept { return view().data(); }
+
+        [[nodiscard]]
+        size_t size() const noexcept { return view().size(); }
+
+        [[nodiscard]]
+        std::string str() const { return std::string(view()); }
+
+        friend bool operator==(const JsonKey& lhs, const JsonKey& rhs) noexcept { return lhs.view() == rhs.view(); }
+
+        friend bool operator==(const JsonKey& lhs, const std::string_view rhs) noexcept { return lhs.view() == rhs; }
+
+        friend auto operator<=>(const JsonKey& lhs, const JsonKey& rhs) noexcept { return lhs.view() <=> rhs.view(); }
+
+        friend auto operator<=>(const JsonKey& lhs, const std::string_view rhs) noexcept { return lhs.view() <=> rhs; }
+
+        friend std::ostream& operator<<(std::ostream& os, const JsonKey& key) { return os << key.view(); }
+
+    private:
+        friend class Json;
+        friend class JsonObject;
+        friend class internal::JsonParser;
+
+        Json node_;
+    };
+
+    struct JsonMember
+    {
+        JsonKey first;
+        Json second;
+    };
+
+    // 连续存储的 JSON 数组，接口与 std::vector<Json> 保持一致
+    class JsonArray
+    {
+    public:
+        using value_type = Json;
+        using size_type = size_t;
+        using reference = Json&;
+        using const_reference = const Json&;
+        using iterator = Json*;
+        using const_iterator = const Json*;
+
+        JsonArray() noexcept = default;
+
+        JsonArray(std::initializer_list<Json> items);
+
+        JsonArray(const JsonArray& other);
+
+        // other 位于 arena 中时逐个复制元素，可能抛出 std::bad_alloc
+        JsonArray(JsonArray&& other);
+
+        ~JsonArray();
+
+        JsonArray& operator=(const JsonArray& other);
+
+        JsonArray& operator=(JsonArray&& other);
+
+        [[nodiscard]]
+        size_t size() const noexcept { return size_; }
+
+        [[nodiscard]]
+        bool empty() const noexcept { return size_ == 0; }
+
+        [[nodiscard]]
+        size_t capacity() const noexcept { return capacity_; }
+
+        void reserve(size_t n);
+
+        void clear() noexcept;
+
+        Json& operator[](const size_t i) noexcept
         {
-            v = b;
-            return *this;
+            touch();
+            return data_[i];
         }
 
-        Json& operator=(const int i) noexcept
+        const Json& operator[](const size_t i) const noexcept { return data_[i]; }
+
+        Json& at(size_t i);
+
+        [[nodiscard]]
+        const Json& at(size_t i) const;
+
+        Json& front() noexcept { return (*this)[0]; }
+
+        Json& back() noexcept { return (*this)[size_ - 1]; }
+
+        [[nodiscard]]
+        const Json& front() const noexcept { return data_[0]; }
+
+        [[nodiscard]]
+        const Json& back() const noexcept { return data_[size_ - 1]; }
+
+        iterator begin() noexcept
         {
-            v = static_cast<double>(i);
-            return *this;
+            touch();
+            return data_;
         }
 
-        Json& operator=(const long l) noexcept
+        iterator end() noexcept { return data_ + size_; }
+
+        [[nodiscard]]
+        const_iterator begin() const noexcept { return data_; }
+
+        [[nodiscard]]
+        const_iterator end() const noexcept { return data_ + size_; }
+
+        void push_back(const Json& value) { emplace_back(value); }
+
+        void push_back(Json&& value) { emplace_back(std::move(value)); }
+
+        template <typename... Args>
+        Json& emplace_back(Args&&... args)
         {
-            v = static_cast<double>(l);
-            return *this;
+            // 先构造再扩容，参数可能引用数组自身的元素
+            Json value(std::forward<Args>(args)...);
+            touch();
+            if (size_ == capacity_)
+                grow(size_ + 1);
+            Json* slot = data_ + size_;
+            slot->takeFrom(value);
+            ++size_;
+            return *slot;
         }
 
-        Json& operator=(double d) noexcept
+        void pop_back() noexcept;
+
+        iterator erase(const_iterator pos);
+
+        friend bool operator==(const JsonArray& lhs, const JsonArray& rhs);
+
+    private:
+        friend class Json;
+        friend class internal::JsonParser;
+
+        void touch() const noexcept
         {
-            v = d;
-            return *this;
+            if (arena_)
+                arena_->dirty = true;
         }
 
-        Json& operator=(const char* s)
+        void grow(size_t need);
+
+        Json* data_ = nullptr;
+        uint32_t size_ = 0;
+        uint32_t capacity_ = 0;
+        internal::JsonArena* arena_ = nullptr;
+    };
+
+    // 连续存储、按 key 排序的 JSON 对象，接口与 std::map<std::string, Json> 保持一致
+    // 成员数达到 kHashThreshold 后额外维护一个开放寻址的哈希索引
+    class JsonObject
+    {
+    public:
+        using key_type = JsonKey;
+        using mapped_type = Json;
+        using value_type = JsonMember;
+        using size_type = size_t;
+        using iterator = JsonMember*;
+        using const_iterator = const JsonMember*;
+
+        static constexpr size_t kHashThreshold = 32;
+
+        JsonObject() noexcept = default;
+
+        JsonObject(const JsonObject& other);
+
+        // other 位于 arena 中时逐个复制成员，可能抛出 std::bad_alloc
+        JsonObject(JsonObject&& other);
+
+        ~JsonObject();
+
+        JsonObject& operator=(const JsonObject& other);
+
+        JsonObject& operator=(JsonObject&& other);
+
+        [[nodiscard]]
+        size_t size() const noexcept { return size_; }
+
+        [[nodiscard]]
+        bool empty() const noexcept { return size_ == 0; }
+
+        void reserve(size_t n);
+
+        void clear() noexcept;
+
+        iterator begin() noexcept
         {
-            v = std::string(s);
-            return *this;
+            touch();
+            return data_;
         }
 
-        Json& operator=(const std::string& s)
+        iterator end() noexcept { return data_ + size_; }
+
+        [[nodiscard]]
+        const_iterator begin() const noexcept { return data_; }
+
+        [[nodiscard]]
+        const_iterator end() const noexcept { return data_ + size_; }
+
+        iterator find(const std::string_view key) noexcept
         {
-            v = s;
-            return *this;
+            touch();
+            return data_ + indexOf(key);
         }
 
-        Json& operator=(std::string&& s)
+        [[nodiscard]]
+        const_iterator find(const std::string_view key) const noexcept { return data_ + indexOf(key); }
+
+        [[nodiscard]]
+        bool contains(const std::string_view key) const noexcept { return indexOf(key) != size_; }
+
+        [[nodiscard]]
+        size_t count(const std::string_view key) const noexcept { return contains(key) ? 1 : 0; }
+
+        Json& at(std::string_view key);
+
+        [[nodiscard]]
+        const Json& at(std::string_view key) const;
+
+        Json& operator[](std::string_view key);
+
+        // key 已存在时不覆盖，与 std::map::emplace 一致
+        template <typename V>
+        std::pair<iterator, bool> emplace(const std::string_view key, V&& value)
         {
-            v = std::move(s);
-            return *this;
+            Json json(std::forward<V>(value));
+            touch();
+            const size_t pos = lowerBound(key);
+            if (pos < size_ && data_[pos].first == key)
+                return {data_ + pos, false};
+            JsonMember* member = insertAt(pos, key);
+            member->second.takeFrom(json);
+            return {member, true};
         }
 
-        Json& operator=(const array& a)
+        template <typename V>
+        std::pair<iterator, bool> insert_or_assign(const std::string_view key, V&& value)
         {
-            v = a;
-            return *this;
+            Json json(std::forward<V>(value));
+            auto [it, inserted] = emplace(key, nullptr);
+            it->second.destroy();
+            it->second.takeFrom(json);
+            return {it, inserted};
         }
 
-        Json& operator=(array&& a)
+        size_t erase(std::string_view key);
+
+        friend bool operator==(const JsonObject& lhs, const JsonObject& rhs);
+
+    private:
+        friend class Json;
+        friend class internal::JsonParser;
+
+        void touch() const noexcept
         {
-            v = std::move(a);
-            return *this;
+            if (arena_)
+                arena_->dirty = true;
         }
 
-        Json& operator=(const object& o)
+        [[nodiscard]]
+        size_t lowerBound(std::string_view key) const noexcept;
+
+        // 返回 key 所在下标，不存在时返回 size()
+        [[nodiscard]]
+        size_t indexOf(std::string_view key) const noexcept;
+
+        JsonMember* insertAt(size_t pos, std::string_view key);
+
+        void grow(size_t need);
+
+        void rebuildIndex();
+
+        JsonMember* data_ = nullptr;
+        uint32_t size_ = 0;
+        uint32_t capacity_ = 0;
+        internal::JsonArena* arena_ = nullptr;
+        // 哈希索引：槽位存放成员下标 + 1，0 表示空
+        uint32_t* index_ = nullptr;
+        uint32_t indexMask_ = 0;
+    };
+
+    // 一组共享同一个 arena 的文档，用于批量解析（如 NDJSON）
+    // clear() 之后复用 arena 和解析器的内部缓冲区；文档只能以 const 方式访问，拷贝出去的值会深拷贝到堆上
+    class JsonBatch
+    {
+    public:
+        JsonBatch();
+
+        ~JsonBatch();
+
+        JsonBatch(const JsonBatch&) = delete;
+
+        JsonBatch& operator=(const JsonBatch&) = delete;
+
+        JsonBatch(JsonBatch&& other) noexcept;
+
+        JsonBatch& operator=(JsonBatch&& other) noexcept;
+
+        // 解析一个文档并追加到末尾，失败时抛出 std::runtime_error，已解析的文档不受影响
+        const Json& parse(std::string_view s);
+
+        // 丢弃所有文档，保留已申请的内存
+        void clear() noexcept;
+
+        [[nodiscard]]
+        size_t size() const noexcept { return size_; }
+
+        [[nodiscard]]
+        bool empty() const noexcept { return size_ == 0; }
+
+        const Json& operator[](const size_t idx) const noexcept { return docs_[idx]; }
+
+        [[nodiscard]]
+        const Json* begin() const noexcept { return docs_; }
+
+        [[nodiscard]]
+        const Json* end() const noexcept { return docs_ + size_; }
+
+        // arena 向系统申请的字节数
+        [[nodiscard]]
+        size_t reserved() const noexcept { return arena_ ? arena_->reserved() : 0; }
+
+    private:
+        std::unique_ptr<internal::JsonArena> arena_;
+        std::unique_ptr<internal::JsonParser> parser_;
+        // 根节点按位搬移，不经过 Json 的移动构造（那会把 arena 中的值深拷贝出去）
+        Json* docs_ = nullptr;
+        size_t size_ = 0;
+        size_t capacity_ = 0;
+    };
+
+    // Json::asNumber() 的可写形式，兼容 j.asNumber() += 1 这类用法
+    class JsonNumberRef
+    {
+    public:
+        explicit JsonNumberRef(Json& json) noexcept : json_(json)
         {
-            v = o;
-            return *this;
         }
 
-        Json& operator=(object&& o)
+        operator double() const { return std::as_const(json_).asNumber(); }
+
+        JsonNumberRef& operator=(const double d)
         {
-            v = std::move(o);
+            json_.setDouble(d);
             return *this;
         }
 
-        template <typename T>
-        Json& operator=(const T obj)
+        JsonNumberRef& operator=(const JsonNumberRef& other) { return *this = static_cast<double>(other); }
+
+        JsonNumberRef& operator+=(const double d) { return *this = *this + d; }
+
+        JsonNumberRef& operator-=(const double d) { return *this = *this - d; }
+
+        JsonNumberRef& operator*=(const double d) { return *this = *this * d; }
+
+        JsonNumberRef& operator/=(const double d) { return *this = *this / d; }
+
+        JsonNumberRef& operator++() { return *this += 1; }
+
+        JsonNumberRef& operator--() { return *this -= 1; }
+
+        double operator++(int)
         {
-            using DecayT = std::decay_t<T>;
-            if constexpr (std::is_arithmetic_v<DecayT>)
-            {
-                if constexpr (std::is_same_v<T, bool>)
-                {
-                    v = static_cast<bool>(obj);
-                }
-                else
-                {
-                    v = static_cast<double>(obj);
-                }
-            }
-            else if constexpr (std::is_convertible_v<T, std::string_view>)
-            {
-                v = std::string(obj);
-            }
-            else if constexpr (internal::is_sequence_container_v<T>)
-            {
-                array arr;
-                arr.reserve(obj.size());
-                for (const auto& item : obj)
-                {
-                    arr.emplace_back(item);
-                }
-                v = std::move(arr);
-            }
-            else if constexpr (internal::is_map_container_v<T>)
-            {
-                object objJson;
-                for (const auto& [key, value] : obj)
-                {
-                    objJson.emplace(key, Json(value));
-                }
-                v = std::move(objJson);
-            }
-            else if constexpr (internal::is_reflectable_v<DecayT>)
-            {
-                object objJson;
-                reflection::forEachField(obj, [&](const std::string_view name, const auto& value)
-                {
-                    objJson.emplace(name, Json(value));
-                });
-                v = std::move(objJson);
-            }
-            else
-            {
-                static_assert(internal::is_reflectable_v<T>,
-                              "Type is not reflectable. Please register it using REFLECT macro.");
-            }
-            return *this;
+            const double old = *this;
+            *this += 1;
+            return old;
         }
 
-        // Serialization
-        [[nodiscard]]
-        std::string dump(bool pretty = false, int indent_size = 2) const;
+        double operator--(int)
+        {
+            const double old = *this;
+            *this -= 1;
+            return old;
+        }
 
     private:
-        static void escapeString(std::ostream& os, const std::string& s);
+        Json& json_;
+    };
 
-        void dumpCompact(std::ostream& os) const;
+    inline JsonNumberRef Json::asNumber()
+    {
+        if (!isNumber())
+            throw std::runtime_error("json: not a number");
+        return JsonNumberRef(*this);
+    }
 
-        void dumpPretty(std::ostream& os, int depth, int indentSize) const;
+    inline Json::Json(const array& a)
+    {
+        setArray(new JsonArray(a), 0);
+    }
 
-    public:
-        static Json parse(const std::string& s);
-    };
+    inline Json::Json(array&& a)
+    {
+        setArray(new JsonArray(std::move(a)), 0);
+    }
 
-    template <typename T>
-    std::string stringify(const T& obj)
+    inline Json::Json(const object& o)
     {
-        using Type = std::decay_t<T>;
+        setObject(new JsonObject(o), 0);
+    }
+
+    inline Json::Json(object&& o)
+    {
+        setObject(new JsonObject(std::move(o)), 0);
+    }
 
-        if constexpr (std::is_same_v<Type, Json>) // Json类型
+    inline Json Json::makeArray() { return Json(array{}); }
+
+    inline Json Json::makeObject() { return Json(object{}); }
+
+    inline void Json::setArray(JsonArray* a, const uint8_t flags) noexcept
+    {
+        store(kArray, a);
+        tag_ |= flags;
+    }
+
+    inline void Json::setObject(JsonObject* o, const uint8_t flags) noexcept
+    {
+        store(kObject, o);
+        tag_ |= flags;
+    }
+
+    inline Json::array& Json::asArray()
+    {
+        if (!isArray())
+            throw std::runtime_error("json: not an array");
+        return *load<JsonArray*>();
+    }
+
+    inline Json::object& Json::asObject()
+    {
+        if (!isObject())
+            throw std::runtime_error("json: not an object");
+        return *load<JsonObject*>();
+    }
+
+    inline const Json::array& Json::asArray() const
+    {
+        if (!isArray())
+            throw std::runtime_error("json: not an array");
+        return *load<const JsonArray*>();
+    }
+
+    inline const Json::object& Json::asObject() const
+    {
+        if (!isObject())
+            throw std::runtime_error("json: not an object");
+        return *load<const JsonObject*>();
+    }
+
+    inline Json& Json::operator[](const std::string_view key)
+    {
+        if (!isObject())
+            *this = makeObject();
+        return asObject()[key];
+    }
+
+    inline Json& Json::operator[](const size_t idx)
+    {
+        if (!isArray())
+            throw std::runtime_error("not an array");
+        return asArray().at(idx);
+    }
+
+    inline const Json& Json::at(const std::string_view key) const { return asObject().at(key); }
+
+    inline const Json& Json::at(const size_t idx) const { return asArray().at(idx); }
+
+    inline bool Json::contains(const std::string_view key) const { return isObject() && asObject().contains(key); }
+
+    inline size_t Json::size() const noexcept
+    {
+        if (isArray())
+            return load<const JsonArray*>()->size();
+        if (isObject())
+            return load<const JsonObject*>()->size();
+        return 0;
+    }
+
+    template <typename T>
+    void Json::assign(T&& obj)
+    {
+        using DecayT = std::decay_t<T>;
+        if constexpr (std::is_same_v<DecayT, bool>)
         {
-            return obj.dump();
+            setBool(obj);
         }
-        else if constexpr (std::is_arithmetic_v<Type>) // 算术类型
+        else if constexpr (std::is_integral_v<DecayT>)
         {
-            if constexpr (std::is_same_v<Type, bool>)
-            {
-                return obj ? "true" : "false";
-            }
+            if constexpr (std::is_signed_v<DecayT>)
+                setInt(static_cast<int64_t>(obj));
             else
-            {
-                return std::to_string(obj);
-            }
+                setUint(static_cast<uint64_t>(obj));
         }
-        else if constexpr (std::is_convertible_v<Type, std::string_view>) // 字符串类型
+        else if constexpr (std::is_floating_point_v<DecayT>)
         {
-            std::ostringstream oss;
-            oss << '"';
-            for (unsigned char c : std::string(obj))
-            {
-                switch (c)
-                {
-                case '"':
-                    oss << "\\\"";
-                    break;
-                case '\\':
-                    oss << "\\\\";
-                    break;
-                case '\b':
-                    oss << "\\b";
-                    break;
-                case '\f':
-                    oss << "\\f";
-                    break;
-                case '\n':
-                    oss << "\\n";
-                    break;
-                case '\r':
-                    oss << "\\r";
-                    break;
-                case '\t':
-                    oss << "\\t";
-                    break;
-                default:
-                    if (c < 0x20)
-                    {
-                        oss << "\\u" << std::hex << std::uppercase << std::setw(4) << std::setfill('0') << (int)c <<
-                            std::dec
-                            << std::nouppercase;
-                    }
-                    else
-                        oss << c;
-                }
-            }
-            oss << '"';
-            return oss.str();
+            setDouble(static_cast<double>(obj));
         }
-        else if constexpr (internal::is_sequence_container_v<Type> || internal::is_set_container_v<Type>) // 顺序或者set容器
+        else if constexpr (std::is_convertible_v<T, std::string_view>)
         {
-            std::string s = "[";
-            bool first = true;
-            for (auto& item : obj)
+            setString(std::string_view(obj), nullptr);
+        }
+        else if constexpr (internal::is_sequence_container_v<DecayT> || internal::is_set_container_v<DecayT>)
+        {
+            auto* arr = new JsonArray();
+            setArray(arr, 0);
+            arr->reserve(obj.size());
+            for (auto&& item : obj)
             {
-                if (!first) s += ",";
-                first = false;
-                // 递归调用
-                s += stringify(item);
+                if constexpr (std::is_rvalue_reference_v<T&&> && internal::is_sequence_container_v<DecayT>)
+                    arr->emplace_back(std::move(item));
+                else
+                    arr->emplace_back(item);
             }
-            s += "]";
-            return s;
         }
-        else if constexpr (internal::is_map_container_v<Type>) // map类型
+        else if constexpr (internal::is_map_container_v<DecayT>)
         {
-            std::string s = "{";
-            bool first = true;
-            for (const auto& [key, value] : obj)
+            auto* objJson = new JsonObject();
+            setObject(objJson, 0);
+            objJson->reserve(obj.size());
+            for (auto&& [key, value] : obj)
             {
-                if (!first) s += ",";
-                first = false;
-
-                // Key 必须转为 string
-                std::ostringstream key_oss;
-                key_oss << '"';
                 if constexpr (std::is_arithmetic_v<std::decay_t<decltype(key)>>)
                 {
-                    key_oss << std::to_string(key);
+                    // 数字 key 转为字符串
+                    char buf[32];
+                    const auto [end, ec] = std::to_chars(buf, buf + sizeof(buf), key);
+                    objJson->emplace(std::string_view(buf, end - buf), Json(value));
+                }
+                else if constexpr (std::is_rvalue_reference_v<T&&>)
+                {
+                    objJson->emplace(key, Json(std::move(value)));
                 }
                 else
                 {
-                    for (unsigned char c : std::string(key))
-                    {
-                        switch (c)
-                        {
-                        case '"':
-                            key_oss << "\\\"";
-                            break;
-                        case '\\':
-                            key_oss << "\\\\";
-                            break;
-                        case '\b':
-                            key_oss << "\\b";
-                            break;
-                        case '\f':
-                            key_oss << "\\f";
-                            break;
-                        case '\n':
-                            key_oss << "\\n";
-                            break;
-                        case '\r':
-                            key_oss << "\\r";
-                            break;
-                        case '\t':
-                            key_oss << "\\t";
-                            break;
-                        default:
-                            if (c < 0x20)
-                            {
-                                key_oss << "\\u" << std::hex << std::uppercase << std::setw(4) << std::setfill('0') << (
-                                        int)c <<
-                                    std::dec
-                                    << std::nouppercase;
-                            }
-                            else
-                                key_oss << c;
-                        }
-                    }
+                    objJson->emplace(key, Json(value));
                 }
-                key_oss << '"' << ':';
-                s += key_oss.str();
-                s += stringify(value);
             }
-            s += "}";
-            return s;
         }
-        else if constexpr (internal::is_reflectable_v<Type>) // 自定义类型
+        else if constexpr (internal::is_reflectable_v<DecayT>)
         {
-            std::string s = "{";
-            bool first = true;
-            reflection::forEachField(obj, [&first,&s](const std::string_view name, const auto& field_value)
+            auto* objJson = new JsonObject();
+            setObject(objJson, 0);
+            reflection::forEachField(std::forward<T>(obj), [&]<typename T0>(const std::string_view name, T0&& value)
             {
-                if (!first) s += ",";
-                first = false;
-                s += "\"";
-                s += name;
-                s += "\":";
-                // 递归调用
-                s += stringify(field_value);
+                objJson->emplace(name, Json(std::forward<T0>(value)));
             });
-            s += "}";
-            return s;
         }
         else
         {
-            static_assert(std::is_void_v<Type>, "Type is not registered with REFLECT macro!");
+            static_assert(internal::is_reflectable_v<DecayT>,
+                          "Type is not reflectable. Please register it using REFLECT macro.");
         }
-        return "";
     }
 } // namespace cppkit::json
+
+#include "json_writer.hpp"
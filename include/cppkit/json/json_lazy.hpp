@@ -0,0 +1,280 @@
+#pragma once
+
+#include "json.hpp"
+#include <iterator>
+
+namespace cppkit::json
+{
+    class LazyArray;
+
+    class LazyObject;
+
+    namespace internal
+    {
+        const char* skipSpace(const char* p, const char* end) noexcept;
+
+        // 跳过一个完整的 JSON 值，返回其后的位置
+        // 只做字符串与括号匹配扫描，不校验被跳过部分的内容
+        const char* skipValue(const char* p, const char* end);
+    }
+
+    // 按需访问的 JSON 值：只记录在原始缓冲区中的位置，被访问时才解析
+    // 不拥有缓冲区，调用方需保证缓冲区的生命周期覆盖所有 Lazy* 对象
+    class LazyValue
+    {
+    public:
+        LazyValue() noexcept = default;
+
+        LazyValue(const char* p, const char* end) noexcept : p_(p), end_(end)
+        {
+        }
+
+        [[nodiscard]]
+        Json::Type type() const;
+
+        [[nodiscard]]
+        bool isNull() const noexcept { return *p_ == 'n'; }
+
+        [[nodiscard]]
+        bool isBool() const noexcept { return *p_ == 't' || *p_ == 'f'; }
+
+        [[nodiscard]]
+        bool isNumber() const noexcept { return *p_ == '-' || (*p_ >= '0' && *p_ <= '9'); }
+
+        [[nodiscard]]
+        bool isString() const noexcept { return *p_ == '"'; }
+
+        [[nodiscard]]
+        bool isArray() const noexcept { return *p_ == '['; }
+
+        [[nodiscard]]
+        bool isObject() const noexcept { return *p_ == '{'; }
+
+        [[nodiscard]]
+        bool asBool() const;
+
+        [[nodiscard]]
+        int64_t asInt64() const;
+
+        [[nodiscard]]
+        uint64_t asUint64() const;
+
+        [[nodiscard]]
+        double asNumber() const;
+
+        // 解码后的字符串
+        [[nodiscard]]
+        std::string asString() const;
+
+        // 引号之间未解码的原始内容，不含转义时与 asString() 相同
+        [[nodiscard]]
+        std::string_view asRawString() const;
+
+        [[nodiscard]]
+        LazyArray asArray() const;
+
+        [[nodiscard]]
+        LazyObject asObject() const;
+
+        // 对象按 key 查找（第一个匹配项），找不到抛出 std::out_of_range
+        LazyValue operator[](std::string_view key) const;
+
+        // 数组按下标访问，越界抛出 std::out_of_range
+        LazyValue operator[](size_t idx) const;
+
+        // RFC 6901 JSON Pointer，如 "/a/b/0"；空串表示自身
+        [[nodiscard]]
+        LazyValue at_pointer(std::string_view pointer) const;
+
+        // 该值对应的完整原始文本
+        [[nodiscard]]
+        std::string_view raw() const;
+
+        // 完整解析为 Json
+        [[nodiscard]]
+        Json materialize() const { return Json::parse(raw()); }
+
+    private:
+        // 解析数字 token，用 Json 承载 int64 / uint64 / double 三种表示
+        [[nodiscard]]
+        Json number() const;
+
+        const char* p_ = nullptr;
+        const char* end_ = nullptr;
+    };
+
+    // 对象成员；key 为未解码的原始内容
+    struct LazyField
+    {
+        std::string_view key;
+        LazyValue value;
+
+        // 解码后的 key
+        [[nodiscard]]
+        std::string keyString() const;
+
+        // 与解码后的 key 比较
+        [[nodiscard]]
+        bool keyEquals(std::string_view name) const;
+    };
+
+    // 只能向前遍历的数组视图，每次前进会跳过当前元素
+    class LazyArray
+    {
+    public:
+        class iterator
+        {
+        public:
+            using iterator_category = std::forward_iterator_tag;
+            using value_type = LazyValue;
+            using difference_type = std::ptrdiff_t;
+            using pointer = const LazyValue*;
+            using reference = const LazyValue&;
+
+            iterator() noexcept = default;
+
+            iterator(const char* p, const char* end) noexcept : cur_(p, end), end_(end), p_(p)
+            {
+            }
+
+            reference operator*() const noexcept { return cur_; }
+
+            pointer operator->() const noexcept { return &cur_; }
+
+            iterator& operator++();
+
+            iterator operator++(int)
+            {
+                iterator tmp = *this;
+                ++*this;
+                return tmp;
+            }
+
+            friend bool operator==(const iterator& a, const iterator& b) noexcept { return a.p_ == b.p_; }
+
+        private:
+            LazyValue cur_;
+            const char* end_ = nullptr;
+            const char* p_ = nullptr; // 当前元素起始位置，结束时为 nullptr
+        };
+
+        LazyArray(const char* p, const char* end) noexcept : p_(p), end_(end)
+        {
+        }
+
+        [[nodiscard]]
+        iterator begin() const;
+
+        [[nodiscard]]
+        iterator end() const noexcept { return {}; }
+
+        [[nodiscard]]
+        bool empty() const { return begin() == end(); }
+
+        // 需要扫描整个数组
+        [[nodiscard]]
+        size_t size() const;
+
+        [[nodiscard]]
+        LazyValue at(size_t idx) const;
+
+    private:
+        const char* p_; // 指向 '['
+        const char* end_;
+    };
+
+    // 只能向前遍历的对象视图，成员按文档中的顺序出现
+    class LazyObject
+    {
+    public:
+        class iterator
+        {
+        public:
+            using iterator_category = std::forward_iterator_tag;
+            using value_type = LazyField;
+            using difference_type = std::ptrdiff_t;
+            using pointer = const LazyField*;
+            using reference = const LazyField&;
+
+            iterator() noexcept = default;
+
+            iterator(const char* p, const char* end) : end_(end), p_(p) { load(); }
+
+            reference operator*() const noexcept { return field_; }
+
+            pointer operator->() const noexcept { return &field_; }
+
+            iterator& operator++();
+
+            iterator operator++(int)
+            {
+                iterator tmp = *this;
+                ++*this;
+                return tmp;
+            }
+
+            friend bool operator==(const iterator& a, const iterator& b) noexcept { return a.p_ == b.p_; }
+
+        private:
+            // 从 p_（指向 key 的引号）读取当前成员
+            void load();
+
+            LazyField field_;
+            const char* end_ = nullptr;
+            const char* p_ = nullptr; // 当前成员起始位置，结束时为 nullptr
+        };
+
+        LazyObject(const char* p, const char* end) noexcept : p_(p), end_(end)
+        {
+        }
+
+        [[nodiscard]]
+        iterator begin() const;
+
+        [[nodiscard]]
+        iterator end() const noexcept { return {}; }
+
+        [[nodiscard]]
+        bool empty() const { return begin() == end(); }
+
+        // 需要扫描整个对象
+        [[nodiscard]]
+        size_t size() const;
+
+        // 返回第一个匹配的成员，找不到返回 end()
+        [[nodiscard]]
+        iterator find(std::string_view key) const;
+
+        [[nodiscard]]
+        bool contains(const std::string_view key) const { return find(key) != end(); }
+
+        [[nodiscard]]
+        LazyValue at(std::string_view key) const;
+
+    private:
+        const char* p_; // 指向 '{'
+        const char* end_;
+    };
+
+    // 按需解析的文档：构造时不解析，只在访问路径上扫描，未访问的子树只做括号匹配跳过
+    // 不拷贝输入，调用方需保证 json 的生命周期覆盖文档及其派生的所有值
+    class LazyDocument
+    {
+    public:
+        explicit LazyDocument(std::string_view json);
+
+        [[nodiscard]]
+        LazyValue root() const noexcept { return root_; }
+
+        [[nodiscard]]
+        LazyValue at_pointer(const std::string_view pointer) const { return root_.at_pointer(pointer); }
+
+        // 完整解析并校验整个文档
+        [[nodiscard]]
+        Json materialize() const { return Json::parse(json_); }
+
+    private:
+        std::string_view json_;
+        LazyValue root_;
+    };
+} // namespace cppkit::json
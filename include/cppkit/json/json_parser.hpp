@@ -1,6 +1,7 @@
 #pragma once
 
 #include "json.hpp"
+#include "json_lazy.hpp"
 
 namespace cppkit::json
 {
@@ -28,6 +29,12 @@ namespace cppkit::json
                     if (obj.isBool()) out = obj.asBool();
                     else throw std::runtime_error("Type mismatch: expected bool");
                 }
+                else if constexpr (std::is_integral_v<Type>)
+                {
+                    if (!obj.isNumber()) throw std::runtime_error("Type mismatch: expected number");
+                    if constexpr (std::is_signed_v<Type>) out = static_cast<Type>(obj.asInt64());
+                    else out = static_cast<Type>(obj.asUint64());
+                }
                 else
                 {
                     if (obj.isNumber()) out = static_cast<Type>(obj.asNumber());
@@ -36,7 +43,7 @@ namespace cppkit::json
             }
             else if constexpr (std::is_convertible_v<Type, std::string>) // 字符串
             {
-                if (obj.isString()) out = obj.asString();
+                if (obj.isString()) out = Type(obj.asString());
                 else throw std::runtime_error("Type mismatch: expected string");
             }
             else if constexpr (internal::is_sequence_container_v<Type>) // 序列容器
@@ -85,13 +92,13 @@ namespace cppkit::json
                     {
                         // 如果 Map 的 Key 是数字 (map<int, ...>)
                         if constexpr (std::is_floating_point_v<typename Type::key_type>)
-                            out.emplace(std::stod(jsonKey), std::move(mapVal));
+                            out.emplace(std::stod(jsonKey.str()), std::move(mapVal));
                         else
-                            out.emplace(std::stoll(jsonKey), std::move(mapVal));
+                            out.emplace(std::stoll(jsonKey.str()), std::move(mapVal));
                     }
                     else
                     {
-                        out.emplace(jsonKey, std::move(mapVal));
+                        out.emplace(typename Type::key_type(jsonKey.view()), std::move(mapVal));
                     }
                 }
             }
@@ -105,8 +112,7 @@ namespace cppkit::json
                 reflection::forEachField(out, [&](std::string_view name, auto& field)
                 {
                     // 在 JSON Map 中查找该字段名
-                    const std::string key(name);
-                    if (const auto it = objMap.find(key); it != objMap.end())
+                    if (const auto it = objMap.find(name); it != objMap.end())
                     {
                         // 找到后，递归转换
                         fromJson(it->second, field);
@@ -119,12 +125,124 @@ namespace cppkit::json
             }
         }
 
+        // 按需解析：只解码结构体用到的字段，未使用的子树直接跳过
+        template <typename T>
+        static void fromJson(const LazyValue& obj, T& out)
+        {
+            if (obj.isNull())
+            {
+                return;
+            }
+            using Type = std::decay_t<T>;
+
+            if constexpr (std::is_same_v<Type, Json>)
+            {
+                out = obj.materialize();
+            }
+            else if constexpr (std::is_arithmetic_v<Type>)
+            {
+                if constexpr (std::is_same_v<Type, bool>)
+                {
+                    if (obj.isBool()) out = obj.asBool();
+                    else throw std::runtime_error("Type mismatch: expected bool");
+                }
+                else if constexpr (std::is_integral_v<Type>)
+                {
+                    if (!obj.isNumber()) throw std::runtime_error("Type mismatch: expected number");
+                    if constexpr (std::is_signed_v<Type>) out = static_cast<Type>(obj.asInt64());
+                    else out = static_cast<Type>(obj.asUint64());
+                }
+                else
+                {
+                    if (obj.isNumber()) out = static_cast<Type>(obj.asNumber());
+                    else throw std::runtime_error("Type mismatch: expected number");
+                }
+            }
+            else if constexpr (std::is_convertible_v<Type, std::string>)
+            {
+                if (obj.isString()) out = Type(obj.asString());
+                else throw std::runtime_error("Type mismatch: expected string");
+            }
+            else if constexpr (internal::is_sequence_container_v<Type> || internal::is_set_container_v<Type>)
+            {
+                if (!obj.isArray()) throw std::runtime_error("Type mismatch: expected array");
+                out.clear();
+                for (const auto& item : obj.asArray())
+                {
+                    typename Type::value_type val{};
+                    fromJson(item, val);
+                    if constexpr (internal::is_set_container_v<Type>) out.insert(std::move(val));
+                    else out.push_back(std::move(val));
+                }
+            }
+            else if constexpr (internal::is_map_container_v<Type>)
+            {
+                if (!obj.isObject()) throw std::runtime_error("Type mismatch: expected object for map");
+                out.clear();
+                for (const auto& member : obj.asObject())
+                {
+                    typename Type::mapped_type mapVal{};
+                    fromJson(member.value, mapVal);
+                    const std::string key = member.keyString();
+                    if constexpr (std::is_arithmetic_v<typename Type::key_type>)
+                    {
+                        if constexpr (std::is_floating_point_v<typename Type::key_type>)
+                            out.emplace(std::stod(key), std::move(mapVal));
+                        else
+                            out.emplace(std::stoll(key), std::move(mapVal));
+                    }
+                    else
+                    {
+                        out.emplace(typename Type::key_type(key), std::move(mapVal));
+                    }
+                }
+            }
+            else if constexpr (internal::is_reflectable_v<Type>)
+            {
+                if (!obj.isObject()) throw std::runtime_error("Type mismatch: expected object for struct");
+
+                // 单次遍历 JSON 成员，按名字分派到字段；重复 key 保留第一个
+                // 所有字段都已找到后不再扫描剩余成员
+                constexpr size_t fieldCount = internal::reflectedFieldCount<Type>();
+                constexpr uint64_t all = fieldCount >= 64 ? ~uint64_t{0} : (uint64_t{1} << fieldCount) - 1;
+                uint64_t seen = 0;
+                for (const auto& member : obj.asObject())
+                {
+                    if (fieldCount <= 64 && seen == all)
+                        break;
+                    size_t index = 0;
+                    reflection::forEachField(out, [&](std::string_view name, auto& field)
+                    {
+                        const uint64_t bit = index < 64 ? uint64_t{1} << index : 0;
+                        ++index;
+                        if ((seen & bit) == 0 && member.keyEquals(name))
+                        {
+                            seen |= bit;
+                            fromJson(member.value, field);
+                        }
+                    });
+                }
+            }
+            else
+            {
+                static_assert(std::is_void_v<Type>, "Unsupported type for Json conversion");
+            }
+        }
+
+        // 完整解析并校验整个文档
         template <typename T>
         static void fromJson(const std::string_view str, T& out)
         {
-            auto obj = Json::parse(std::string(str));
+            const auto obj = Json::parse(str);
             fromJson(obj, out);
         }
+
+        // 按需解析：所有字段找到后不再检查剩余输入，格式错误只在被读到的部分才会报错
+        template <typename T>
+        static void fromJson(const LazyDocument& doc, T& out)
+        {
+            fromJson(doc.root(), out);
+        }
     };
 
     template <typename T>
@@ -134,4 +252,14 @@ namespace cppkit::json
         ReflectionParser::fromJson<T>(json, obj);
         return obj;
     }
+
+    // 只解码 T 用到的字段，适合从大文档中取少量字段；不保证拒绝格式错误的输入
+    template <typename T>
+    T fromJsonLazy(const std::string_view json)
+    {
+        T obj{};
+        const LazyDocument doc(json);
+        ReflectionParser::fromJson<T>(doc, obj);
+        return obj;
+    }
 }
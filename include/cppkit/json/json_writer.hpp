@@ -0,0 +1,481 @@
+#pragma once
+
+#include "json.hpp"
+#include <array>
+#include <charconv>
+#include <cmath>
+#include <concepts>
+#include <cstring>
+#include <memory>
+#include <string>
+#include <string_view>
+
+namespace cppkit::json
+{
+    // 序列化输出目标：std::string、OutputBuffer 或任何提供 append/push_back 的类型
+    template <typename S>
+    concept JsonSink = requires(S& s, const char* p, size_t n, char c)
+    {
+        s.append(p, n);
+        s.push_back(c);
+    };
+
+    // 可复用的输出缓冲区，clear() 只重置长度，保留已分配的容量
+    class OutputBuffer
+    {
+    public:
+        OutputBuffer() = default;
+
+        explicit OutputBuffer(const size_t capacity) { reserve(capacity); }
+
+        OutputBuffer(const OutputBuffer&) = delete;
+
+        OutputBuffer& operator=(const OutputBuffer&) = delete;
+
+        OutputBuffer(OutputBuffer&&) noexcept = default;
+
+        OutputBuffer& operator=(OutputBuffer&&) noexcept = default;
+
+        void append(const char* p, const size_t n)
+        {
+            if (size_ + n > capacity_)
+                grow(size_ + n);
+            std::memcpy(data_.get() + size_, p, n);
+            size_ += n;
+        }
+
+        void append(const std::string_view s) { append(s.data(), s.size()); }
+
+        void push_back(const char c)
+        {
+            if (size_ == capacity_)
+                grow(size_ + 1);
+            data_[size_++] = c;
+        }
+
+        void reserve(const size_t n)
+        {
+            if (n > capacity_)
+                grow(n);
+        }
+
+        void clear() noexcept { size_ = 0; }
+
+        [[nodiscard]]
+        const char* data() const noexcept { return data_.get(); }
+
+        [[nodiscard]]
+        size_t size() const noexcept { return size_; }
+
+        [[nodiscard]]
+        size_t capacity() const noexcept { return capacity_; }
+
+        [[nodiscard]]
+        bool empty() const noexcept { return size_ == 0; }
+
+        [[nodiscard]]
+        std::string_view view() const noexcept { return {data_.get(), size_}; }
+
+        [[nodiscard]]
+        std::string str() const { return std::string(view()); }
+
+    private:
+        void grow(const size_t need)
+        {
+            size_t cap = capacity_ ? capacity_ * 2 : 256;
+            while (cap < need)
+                cap *= 2;
+            auto next = std::make_unique_for_overwrite<char[]>(cap);
+            if (size_)
+                std::memcpy(next.get(), data_.get(), size_);
+            data_ = std::move(next);
+            capacity_ = cap;
+        }
+
+        std::unique_ptr<char[]> data_;
+        size_t size_ = 0;
+        size_t capacity_ = 0;
+    };
+
+    namespace internal
+    {
+        // 返回第一个需要转义的字符（'"'、'\\' 或控制字符）的下标，没有则返回 len
+        size_t findEscape(const char* data, size_t len) noexcept;
+
+        template <JsonSink S>
+        void writeEscapeChar(S& out, const unsigned char c)
+        {
+            switch (c)
+            {
+            case '"':
+                out.append("\\\"", 2);
+                break;
+            case '\\':
+                out.append("\\\\", 2);
+                break;
+            case '\b':
+                out.append("\\b", 2);
+                break;
+            case '\f':
+                out.append("\\f", 2);
+                break;
+            case '\n':
+                out.append("\\n", 2);
+                break;
+            case '\r':
+                out.append("\\r", 2);
+                break;
+            case '\t':
+                out.append("\\t", 2);
+                break;
+            default:
+                {
+                    constexpr char hex[] = "0123456789ABCDEF";
+                    const char buf[6] = {'\\', 'u', '0', '0', hex[c >> 4], hex[c & 0x0F]};
+                    out.append(buf, sizeof(buf));
+                }
+            }
+        }
+
+        // 反射结构体字段前缀，编译期生成："{\"name\":" 或 ",\"name\":"
+        template <typename T, size_t I, bool First>
+        struct FieldPrefix
+        {
+            static constexpr std::string_view name = std::get<I>(reflection::MetaData<T>::info()).name;
+
+            static constexpr auto value = []
+            {
+                std::array<char, name.size() + 4> buf{};
+                buf[0] = First ? '{' : ',';
+                buf[1] = '"';
+                for (size_t i = 0; i < name.size(); ++i)
+                    buf[i + 2] = name[i];
+                buf[name.size() + 2] = '"';
+                buf[name.size() + 3] = ':';
+                return buf;
+            }();
+        };
+
+        template <typename T>
+        consteval size_t firstFieldIndex()
+        {
+            using Items = decltype(reflection::MetaData<T>::info());
+            constexpr auto isField = []<size_t... I>(std::index_sequence<I...>)
+            {
+                return std::array<bool, sizeof...(I)>{
+                    reflection::internal::is_field_tag_v<std::decay_t<std::tuple_element_t<I, Items>>>...};
+            }(std::make_index_sequence<std::tuple_size_v<Items>>{});
+            for (size_t i = 0; i < isField.size(); ++i)
+            {
+                if (isField[i])
+                    return i;
+            }
+            return isField.size();
+        }
+    }
+
+    // 写入带引号并转义的 JSON 字符串，无需转义的连续片段整段拷贝
+    template <JsonSink S>
+    void writeString(S& out, const std::string_view s)
+    {
+        out.push_back('"');
+        const char* p = s.data();
+        size_t n = s.size();
+        while (n > 0)
+        {
+            const size_t run = internal::findEscape(p, n);
+            if (run > 0)
+                out.append(p, run);
+            if (run == n)
+                break;
+            internal::writeEscapeChar(out, static_cast<unsigned char>(p[run]));
+            p += run + 1;
+            n -= run + 1;
+        }
+        out.push_back('"');
+    }
+
+    template <JsonSink S, std::integral I>
+    void writeInteger(S& out, const I value)
+    {
+        char buf[24];
+        const auto [end, ec] = std::to_chars(buf, buf + sizeof(buf), value);
+        out.append(buf, static_cast<size_t>(end - buf));
+    }
+
+    // 整数值按整数输出，其余使用 std::to_chars 的最短可往返表示；NaN/Inf 不是合法 JSON，输出 null
+    template <JsonSink S>
+    void writeNumber(S& out, const double value)
+    {
+        if (!std::isfinite(value))
+        {
+            out.append("null", 4);
+            return;
+        }
+        if (constexpr double maxExact = 9007199254740992.0; std::trunc(value) == value && std::fabs(value) <= maxExact)
+        {
+            writeInteger(out, static_cast<int64_t>(value));
+            return;
+        }
+        char buf[32];
+        const auto [end, ec] = std::to_chars(buf, buf + sizeof(buf), value);
+        out.append(buf, static_cast<size_t>(end - buf));
+    }
+
+    namespace internal
+    {
+        template <JsonSink S>
+        void writeCompact(S& out, const Json& json)
+        {
+            switch (json.type())
+            {
+            case Json::Type::Null:
+                out.append("null", 4);
+                return;
+            case Json::Type::Bool:
+                if (json.asBool())
+                    out.append("true", 4);
+                else
+                    out.append("false", 5);
+                return;
+            case Json::Type::Int:
+                writeInteger(out, json.asInt64());
+                return;
+            case Json::Type::Uint:
+                writeInteger(out, json.asUint64());
+                return;
+            case Json::Type::Double:
+                writeNumber(out, json.asNumber());
+                return;
+            default:
+                break;
+            }
+            if (json.isString())
+            {
+                writeString(out, json.asString());
+                return;
+            }
+            if (json.isArray())
+            {
+                out.push_back('[');
+                bool first = true;
+                for (const auto& item : json.asArray())
+                {
+                    if (!first)
+                        out.push_back(',');
+                    first = false;
+                    writeCompact(out, item);
+                }
+                out.push_back(']');
+                return;
+            }
+            out.push_back('{');
+            bool first = true;
+            for (const auto& [key, value] : json.asObject())
+            {
+                if (!first)
+                    out.push_back(',');
+                first = false;
+                writeString(out, key);
+                out.push_back(':');
+                writeCompact(out, value);
+            }
+            out.push_back('}');
+        }
+
+        template <JsonSink S>
+        void writeIndent(S& out, size_t count)
+        {
+            static constexpr char spaces[] = "                                ";
+            out.push_back('\n');
+            while (count > 0)
+            {
+                const size_t n = std::min(count, sizeof(spaces) - 1);
+                out.append(spaces, n);
+                count -= n;
+            }
+        }
+
+        template <JsonSink S>
+        void writePretty(S& out, const Json& json, const int depth, const int indentSize)
+        {
+            const auto inner = static_cast<size_t>((depth + 1) * indentSize);
+            if (json.isArray())
+            {
+                const auto& a = json.asArray();
+                if (a.empty())
+                {
+                    out.append("[]", 2);
+                    return;
+                }
+                out.push_back('[');
+                for (size_t i = 0; i < a.size(); ++i)
+                {
+                    if (i)
+                        out.push_back(',');
+                    writeIndent(out, inner);
+                    writePretty(out, a[i], depth + 1, indentSize);
+                }
+                writeIndent(out, inner - indentSize);
+                out.push_back(']');
+                return;
+            }
+            if (json.isObject())
+            {
+                const auto& o = json.asObject();
+                if (o.empty())
+                {
+                    out.append("{}", 2);
+                    return;
+                }
+                out.push_back('{');
+                bool first = true;
+                for (const auto& [key, value] : o)
+                {
+                    if (!first)
+                        out.push_back(',');
+                    first = false;
+                    writeIndent(out, inner);
+                    writeString(out, key);
+                    out.append(": ", 2);
+                    writePretty(out, value, depth + 1, indentSize);
+                }
+                writeIndent(out, inner - indentSize);
+                out.push_back('}');
+                return;
+            }
+            writeCompact(out, json);
+        }
+    }
+
+    template <typename Sink>
+    void Json::dumpTo(Sink& out, const bool pretty, const int indentSize) const
+    {
+        static_assert(JsonSink<Sink>, "Sink must provide append(const char*, size_t) and push_back(char)");
+        if (pretty)
+            internal::writePretty(out, *this, 0, indentSize);
+        else
+            internal::writeCompact(out, *this);
+    }
+
+    template <JsonSink S, typename T>
+    void stringifyTo(S& out, const T& obj);
+
+    namespace internal
+    {
+        template <typename T, size_t I, size_t First, JsonSink S>
+        void writeField(S& out, const T& obj)
+        {
+            using ItemType = std::decay_t<std::tuple_element_t<I, decltype(reflection::MetaData<T>::info())>>;
+            if constexpr (reflection::internal::is_field_tag_v<ItemType>)
+            {
+                constexpr auto& prefix = FieldPrefix<T, I, I == First>::value;
+                constexpr auto ptr = std::get<I>(reflection::MetaData<T>::info()).ptr;
+                out.append(prefix.data(), prefix.size());
+                stringifyTo(out, obj.*ptr);
+            }
+        }
+
+        template <typename T, JsonSink S, size_t... I>
+        void writeFields(S& out, const T& obj, std::index_sequence<I...>)
+        {
+            constexpr size_t first = firstFieldIndex<T>();
+            (writeField<T, I, first>(out, obj), ...);
+        }
+    }
+
+    // 将任意可序列化对象直接写入 out，不产生中间字符串
+    template <JsonSink S, typename T>
+    void stringifyTo(S& out, const T& obj)
+    {
+        using Type = std::decay_t<T>;
+
+        if constexpr (std::is_same_v<Type, Json>) // Json类型
+        {
+            obj.dumpTo(out);
+        }
+        else if constexpr (std::is_same_v<Type, bool>)
+        {
+            if (obj)
+                out.append("true", 4);
+            else
+                out.append("false", 5);
+        }
+        else if constexpr (std::is_integral_v<Type>)
+        {
+            writeInteger(out, obj);
+        }
+        else if constexpr (std::is_floating_point_v<Type>)
+        {
+            writeNumber(out, static_cast<double>(obj));
+        }
+        else if constexpr (std::is_convertible_v<Type, std::string_view>) // 字符串类型
+        {
+            writeString(out, std::string_view(obj));
+        }
+        else if constexpr (internal::is_sequence_container_v<Type> || internal::is_set_container_v<Type>) // 顺序或者set容器
+        {
+            out.push_back('[');
+            bool first = true;
+            for (const auto& item : obj)
+            {
+                if (!first)
+                    out.push_back(',');
+                first = false;
+                stringifyTo(out, item);
+            }
+            out.push_back(']');
+        }
+        else if constexpr (internal::is_map_container_v<Type>) // map类型
+        {
+            out.push_back('{');
+            bool first = true;
+            for (const auto& [key, value] : obj)
+            {
+                if (!first)
+                    out.push_back(',');
+                first = false;
+
+                // Key 必须转为 string
+                if constexpr (std::is_arithmetic_v<std::decay_t<decltype(key)>>)
+                {
+                    out.push_back('"');
+                    stringifyTo(out, key);
+                    out.push_back('"');
+                }
+                else
+                {
+                    writeString(out, std::string_view(key));
+                }
+                out.push_back(':');
+                stringifyTo(out, value);
+            }
+            out.push_back('}');
+        }
+        else if constexpr (internal::is_reflectable_v<Type>) // 自定义类型
+        {
+            constexpr size_t count = std::tuple_size_v<decltype(reflection::MetaData<Type>::info())>;
+            if constexpr (internal::firstFieldIndex<Type>() == count)
+            {
+                out.append("{}", 2);
+            }
+            else
+            {
+                internal::writeFields(out, obj, std::make_index_sequence<count>{});
+                out.push_back('}');
+            }
+        }
+        else
+        {
+            static_assert(std::is_void_v<Type>, "Type is not registered with REFLECT macro!");
+        }
+    }
+
+    template <typename T>
+    std::string stringify(const T& obj)
+    {
+        std::string out;
+        stringifyTo(out, obj);
+        return out;
+    }
+} // namespace cppkit::json
@@ -0,0 +1,131 @@
+#pragma once
+
+#include "json.hpp"
+#include "cppkit/concurrency/thread_pool.hpp"
+#include "cppkit/io/file.hpp"
+
+namespace cppkit::json
+{
+    // NDJSON（每行一个 JSON 文档）读取器
+    // 按 batchBytes 大小成批读取输入，先按行切分，再把每批切成若干块交给线程池并行解析；
+    // 解析下一批的同时读取再下一批。每块使用独立的 JsonBatch，内存在批次之间复用
+    class NdjsonReader
+    {
+    public:
+        static constexpr size_t kDefaultBatchBytes = 4 << 20;
+
+        // pool 为 nullptr 时在调用线程中解析
+        explicit NdjsonReader(const std::string& path, concurrency::ThreadPool* pool = nullptr,
+                              size_t batchBytes = kDefaultBatchBytes);
+
+        explicit NdjsonReader(const io::File& file, concurrency::ThreadPool* pool = nullptr,
+                              size_t batchBytes = kDefaultBatchBytes);
+
+        // 从已打开的文件描述符读取，不接管 fd
+        explicit NdjsonReader(int fd, concurrency::ThreadPool* pool = nullptr, size_t batchBytes = kDefaultBatchBytes);
+
+        ~NdjsonReader();
+
+        NdjsonReader(const NdjsonReader&) = delete;
+
+        NdjsonReader& operator=(const NdjsonReader&) = delete;
+
+        // 按文件顺序在调用线程中逐个回调每个文档，空行会被跳过；返回文档数量
+        // 文档只在回调期间有效，需要保留时拷贝即可
+        // 解析失败抛出 std::runtime_error，消息中包含行号
+        size_t forEach(const std::function<void(const Json&)>& fn);
+
+        // 已读取的字节数
+        [[nodiscard]]
+        size_t bytesRead() const noexcept { return bytesRead_; }
+
+    private:
+        struct Chunk
+        {
+            std::string_view text;
+            JsonBatch docs;
+            std::string error;
+            const char* errorAt = nullptr; // 出错行的起始位置
+        };
+
+        // 一批输入：buffer 中 [0, size) 为完整的行
+        struct Batch
+        {
+            std::unique_ptr<char[]> buffer;
+            size_t capacity = 0;
+            size_t size = 0;
+            size_t firstLine = 0;
+            std::vector<Chunk> chunks; // 跨批次复用
+            size_t chunkCount = 0;
+        };
+
+        // 把 carry 中剩余的半行和新读取的数据填入 batch，返回 false 表示没有更多数据
+        bool fill(Batch& batch);
+
+        void split(Batch& batch) const;
+
+        static void parseChunk(Chunk& chunk) noexcept;
+
+        int fd_;
+        bool ownsFd_;
+        concurrency::ThreadPool* pool_;
+        size_t batchBytes_;
+        std::string carry_; // 上一批末尾不完整的行
+        size_t nextLine_ = 1;
+        size_t bytesRead_ = 0;
+        bool eof_ = false;
+    };
+
+    // NDJSON 写入器：记录先序列化到内存缓冲区，累计到 flushBytes 后一次性写出
+    class NdjsonWriter
+    {
+    public:
+        static constexpr size_t kDefaultFlushBytes = 1 << 20;
+
+        explicit NdjsonWriter(const std::string& path, bool append = false, size_t flushBytes = kDefaultFlushBytes);
+
+        explicit NdjsonWriter(const io::File& file, bool append = false, size_t flushBytes = kDefaultFlushBytes);
+
+        // 写入已打开的文件描述符，不接管 fd
+        explicit NdjsonWriter(int fd, size_t flushBytes = kDefaultFlushBytes);
+
+        // 析构时写出剩余数据，写出失败会被忽略，需要感知错误时请先调用 flush()
+        ~NdjsonWriter();
+
+        NdjsonWriter(const NdjsonWriter&) = delete;
+
+        NdjsonWriter& operator=(const NdjsonWriter&) = delete;
+
+        // 写入一条记录：Json 或任何可以 stringify 的类型
+        template <typename T>
+        void write(const T& record)
+        {
+            if constexpr (std::is_same_v<T, Json>)
+                record.dumpTo(buffer_);
+            else
+                stringifyTo(buffer_, record);
+            buffer_.push_back('\n');
+            ++records_;
+            if (buffer_.size() >= flushBytes_)
+                flush();
+        }
+
+        // 写出缓冲区中的全部数据，失败抛出 std::runtime_error
+        void flush();
+
+        [[nodiscard]]
+        size_t records() const noexcept { return records_; }
+
+        // 已写出到文件的字节数
+        [[nodiscard]]
+        size_t bytesWritten() const noexcept { return bytesWritten_; }
+
+    private:
+        int fd_;
+        bool ownsFd_;
+        size_t flushBytes_;
+        OutputBuffer buffer_;
+        size_t records_ = 0;
+        size_t bytesWritten_ = 0;
+    };
+} // namespace cppkit::json
@@ -17,6 +17,7 @@
 #include <source_location>
 #include <atomic>
 #include "cppkit/concurrency/ring_buffer.hpp"
+#include "cppkit/metrics/metrics.hpp"
 #if defined(__cpp_lib_format)
 #include <format>
 #else
@@ -135,15 +136,20 @@ namespace cppkit::log
             }
 
             const std::string logLine = oss.str();
+            CK_COUNTER_INC("cppkit_log_messages_total", "Log lines produced");
 
             // 只在将日志写入队列时持有锁，减少锁持有时间
             {
                 std::unique_lock lk(queue_mtx_);
-                log_queue_.push(logLine);
-
-                // 如果是异步模式，通知后台线程
+                // 异步模式交给后台线程；同步模式直接写，不再入队，避免切回异步时重复输出
                 if (is_async_)
                 {
+                    if (!log_queue_.push(logLine))
+                    {
+                        // 队列已满，丢弃这一行
+                        CK_COUNTER_INC("cppkit_log_dropped_total", "Log lines dropped because the queue was full");
+                        return;
+                    }
                     queue_cv_.notify_one();
                     return; // 异步模式直接返回，不需要后续操作
                 }
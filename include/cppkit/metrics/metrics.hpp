@@ -0,0 +1,250 @@
+#pragma once
+
+#include <array>
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+#include <map>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <string_view>
+#include <utility>
+#include <vector>
+
+namespace cppkit::metrics
+{
+    // 计数器的分片数，每个线程固定写其中一片
+    constexpr size_t COUNTER_SHARDS = 16;
+
+    // 直方图每个 2 的幂区间内的子桶数，相对误差不超过 1/16
+    constexpr size_t HISTOGRAM_SUB_BUCKETS = 16;
+
+    // 覆盖整个 uint64_t 范围所需的桶数
+    constexpr size_t HISTOGRAM_BUCKETS = (64 - 3) * HISTOGRAM_SUB_BUCKETS;
+
+    // 导出时默认的 le 边界（秒）
+    inline const std::vector<double> DEFAULT_LATENCY_BOUNDS = {
+        0.0001, 0.00025, 0.0005, 0.001, 0.0025, 0.005, 0.01, 0.025, 0.05, 0.1, 0.25, 0.5, 1, 2.5, 5, 10
+    };
+
+    using Labels = std::vector<std::pair<std::string, std::string>>;
+
+    namespace inner
+    {
+        // 当前线程使用的分片，首次调用时按轮转分配
+        inline size_t shardIndex()
+        {
+            static std::atomic<size_t> next{0};
+            thread_local const size_t index = next.fetch_add(1, std::memory_order_relaxed) % COUNTER_SHARDS;
+            return index;
+        }
+    }
+
+    // 单调递增的计数器：按线程分片累加，读取时求和，写入路径没有跨核争用
+    class Counter
+    {
+    public:
+        Counter() = default;
+
+        Counter(const Counter&) = delete;
+
+        Counter& operator=(const Counter&) = delete;
+
+        void inc(const uint64_t n = 1)
+        {
+            _shards[inner::shardIndex()].value.fetch_add(n, std::memory_order_relaxed);
+        }
+
+        [[nodiscard]] uint64_t value() const;
+
+    private:
+        struct alignas(64) Shard
+        {
+            std::atomic<uint64_t> value{0};
+        };
+
+        std::array<Shard, COUNTER_SHARDS> _shards{};
+    };
+
+    // 可增可减的瞬时值，如连接数、队列长度
+    class Gauge
+    {
+    public:
+        Gauge() = default;
+
+        Gauge(const Gauge&) = delete;
+
+        Gauge& operator=(const Gauge&) = delete;
+
+        void set(const int64_t v) { _value.store(v, std::memory_order_relaxed); }
+
+        void add(const int64_t n) { _value.fetch_add(n, std::memory_order_relaxed); }
+
+        void inc() { add(1); }
+
+        void dec() { add(-1); }
+
+        [[nodiscard]] int64_t value() const { return _value.load(std::memory_order_relaxed); }
+
+    private:
+        alignas(64) std::atomic<int64_t> _value{0};
+    };
+
+    // HDR 风格的对数线性直方图，记录纳秒：小于 32 的值精确计数，
+    // 之后每个 2 的幂区间均分为 16 个桶。记录只有两次 relaxed fetch_add，不加锁
+    class Histogram
+    {
+    public:
+        explicit Histogram(std::vector<double> bounds = DEFAULT_LATENCY_BOUNDS);
+
+        Histogram(const Histogram&) = delete;
+
+        Histogram& operator=(const Histogram&) = delete;
+
+        void record(const uint64_t ns)
+        {
+            _buckets[bucketIndex(ns)].fetch_add(1, std::memory_order_relaxed);
+            _sum.fetch_add(ns, std::memory_order_relaxed);
+        }
+
+        void record(const std::chrono::nanoseconds d)
+        {
+            record(d.count() > 0 ? static_cast<uint64_t>(d.count()) : 0);
+        }
+
+        [[nodiscard]] uint64_t count() const;
+
+        // 所有记录值之和（纳秒）
+        [[nodiscard]] uint64_t sum() const { return _sum.load(std::memory_order_relaxed); }
+
+        // 分位数 q ∈ [0, 1]，返回所在桶的上界（纳秒），没有记录时返回 0
+        [[nodiscard]] uint64_t percentile(double q) const;
+
+        // 导出用的 le 边界（秒）
+        [[nodiscard]] const std::vector<double>& bounds() const { return _bounds; }
+
+        // 各桶计数的快照
+        [[nodiscard]] std::vector<uint64_t> snapshot() const;
+
+        static size_t bucketIndex(const uint64_t v)
+        {
+            if (v < 2 * HISTOGRAM_SUB_BUCKETS)
+            {
+                return static_cast<size_t>(v);
+            }
+            const int exp = 63 - __builtin_clzll(v);
+            const size_t sub = (v >> (exp - 4)) & (HISTOGRAM_SUB_BUCKETS - 1);
+            return static_cast<size_t>(exp - 3) * HISTOGRAM_SUB_BUCKETS + sub;
+        }
+
+        // 桶 i 中的最大值
+        static uint64_t bucketUpper(size_t i);
+
+    private:
+        std::vector<double> _bounds;
+        std::unique_ptr<std::atomic<uint64_t>[]> _buckets;
+        alignas(64) std::atomic<uint64_t> _sum{0};
+    };
+
+    // 作用域计时：析构时把耗时记入直方图
+    class ScopedTimer
+    {
+    public:
+        explicit ScopedTimer(Histogram& histogram) : _histogram(histogram), _start(std::chrono::steady_clock::now())
+        {
+        }
+
+        ScopedTimer(const ScopedTimer&) = delete;
+
+        ScopedTimer& operator=(const ScopedTimer&) = delete;
+
+        ~ScopedTimer()
+        {
+            _histogram.record(std::chrono::steady_clock::now() - _start);
+        }
+
+    private:
+        Histogram& _histogram;
+        std::chrono::steady_clock::time_point _start;
+    };
+
+    // 进程内的指标注册表。同名同标签返回同一个对象，引用在进程生命周期内有效，
+    // 调用方应缓存引用，不要在热路径上反复查找
+    class Registry
+    {
+    public:
+        static Registry& instance();
+
+        Registry();
+
+        ~Registry();
+
+        Registry(const Registry&) = delete;
+
+        Registry& operator=(const Registry&) = delete;
+
+        // 名称已注册为其他类型时抛出 std::runtime_error
+        Counter& counter(const std::string& name, const std::string& help, const Labels& labels = {});
+
+        Gauge& gauge(const std::string& name, const std::string& help, const Labels& labels = {});
+
+        Histogram& histogram(const std::string& name, const std::string& help, const Labels& labels = {},
+                             const std::vector<double>& bounds = DEFAULT_LATENCY_BOUNDS);
+
+        // Prometheus 文本格式（0.0.4），按指标名排序
+        [[nodiscard]] std::string exportPrometheus() const;
+
+        void exportPrometheus(std::string& out) const;
+
+    private:
+        struct Family;
+
+        Family& family(const std::string& name, const std::string& help, int type);
+
+        mutable std::mutex _mutex;
+        std::map<std::string, std::unique_ptr<Family>, std::less<>> _families;
+    };
+} // namespace cppkit::metrics
+
+// 埋点宏：定义 CPPKIT_ENABLE_METRICS（CMake 选项 ENABLE_METRICS）时生效，
+// 否则全部展开为空语句，参数不会被求值
+#if defined(CPPKIT_ENABLE_METRICS)
+#define CK_METRIC_CONCAT_(a, b) a##b
+#define CK_METRIC_CONCAT(a, b) CK_METRIC_CONCAT_(a, b)
+
+#define CK_COUNTER_ADD(name, help, n) do { \
+        static auto& ck_counter_ = ::cppkit::metrics::Registry::instance().counter(name, help); \
+        ck_counter_.inc(n); \
+    } while (0)
+
+#define CK_COUNTER_INC(name, help) CK_COUNTER_ADD(name, help, 1)
+
+#define CK_GAUGE_ADD(name, help, n) do { \
+        static auto& ck_gauge_ = ::cppkit::metrics::Registry::instance().gauge(name, help); \
+        ck_gauge_.add(n); \
+    } while (0)
+
+#define CK_GAUGE_SET(name, help, v) do { \
+        static auto& ck_gauge_ = ::cppkit::metrics::Registry::instance().gauge(name, help); \
+        ck_gauge_.set(v); \
+    } while (0)
+
+#define CK_HISTOGRAM_RECORD(name, help, ns) do { \
+        static auto& ck_histogram_ = ::cppkit::metrics::Registry::instance().histogram(name, help); \
+        ck_histogram_.record(ns); \
+    } while (0)
+
+// 记录当前作用域的耗时
+#define CK_HISTOGRAM_TIMER(name, help) \
+    static auto& CK_METRIC_CONCAT(ck_histogram_, __LINE__) = \
+        ::cppkit::metrics::Registry::instance().histogram(name, help); \
+    const ::cppkit::metrics::ScopedTimer CK_METRIC_CONCAT(ck_timer_, __LINE__)(CK_METRIC_CONCAT(ck_histogram_, __LINE__))
+#else
+#define CK_COUNTER_ADD(name, help, n) ((void)0)
+#define CK_COUNTER_INC(name, help) ((void)0)
+#define CK_GAUGE_ADD(name, help, n) ((void)0)
+#define CK_GAUGE_SET(name, help, v) ((void)0)
+#define CK_HISTOGRAM_RECORD(name, help, ns) ((void)0)
+#define CK_HISTOGRAM_TIMER(name, help) ((void)0)
+#endif
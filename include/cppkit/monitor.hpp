@@ -3,6 +3,7 @@
 #include <string>
 #include <vector>
 #include <cstdint>
+#include <chrono>
 
 namespace cppkit
 {
@@ -24,6 +25,50 @@ namespace cppkit
         double usage_percent;            // 使用率 (0.0-100.0)
     };
 
+    // 后台采样时最多记录的线程数
+    constexpr size_t MAX_SAMPLED_THREADS = 64;
+
+    // 当前进程中一个线程的资源使用
+    struct ThreadMetrics
+    {
+        int tid;                         // 线程 ID
+        char name[16];                   // 线程名
+        double cpu_usage_percent;        // 上一个采样间隔内占一个核的百分比
+        uint64_t cpu_time_ns;            // 累计 CPU 时间 (ns)
+        uint64_t voluntary_ctx_switches; // 主动让出 CPU 的次数
+        uint64_t involuntary_ctx_switches; // 被抢占的次数
+    };
+
+    // 当前进程的资源使用
+    struct ProcessMetrics
+    {
+        double cpu_usage_percent;        // 上一个采样间隔内占一个核的百分比，多线程时可超过 100
+        uint64_t cpu_user_us;            // 累计用户态 CPU 时间 (us)
+        uint64_t cpu_system_us;          // 累计内核态 CPU 时间 (us)
+        uint64_t rss_kb;                 // 常驻内存 (KB)
+        uint64_t voluntary_ctx_switches;
+        uint64_t involuntary_ctx_switches;
+        uint32_t fd_count;               // 打开的文件描述符数（不含 Monitor 自己常驻打开的 /proc 文件）
+        uint32_t thread_count;           // 线程数
+        uint64_t io_read_bytes;          // read 类调用读到的字节数（包括 socket 和页缓存命中）
+        uint64_t io_write_bytes;         // write 类调用写出的字节数
+        uint64_t disk_read_bytes;        // 实际从块设备读取的字节数
+        uint64_t disk_write_bytes;       // 实际写往块设备的字节数
+    };
+
+    // 后台采样的一次结果，可以按值拷贝
+    struct MonitorSnapshot
+    {
+        uint64_t sequence;               // 第几次采样，0 表示还没有采样
+        int64_t timestamp_ns;            // 采样时间 (steady_clock)
+        SystemMetrics system;
+        double load_average[3];
+        ProcessMetrics process;
+        uint64_t sampler_cpu_ns;         // 采样线程自身累计消耗的 CPU 时间
+        uint32_t thread_count;           // threads 中有效的个数
+        ThreadMetrics threads[MAX_SAMPLED_THREADS];
+    };
+
     // 系统监控类
     class Monitor
     {
@@ -36,7 +81,7 @@ namespace cppkit
         Monitor& operator=(const Monitor&) = delete;
 
         // 获取CPU使用率 (百分比)
-        // 需要调用两次来计算差值，第一次调用返回0
+        // 后台采样运行时直接返回最近一个采样间隔的值；否则需要调用两次来计算差值，第一次调用返回0
         [[nodiscard]] double GetCpuUsage() const;
 
         // 获取内存使用率 (百分比)
@@ -66,6 +111,21 @@ namespace cppkit
         // 获取系统运行时间 (秒)
         [[nodiscard]] uint64_t GetSystemUptime() const;
 
+        // 立即采集一次当前进程的指标；cpu_usage_percent 为自上次调用以来的值，第一次调用为 0
+        [[nodiscard]] ProcessMetrics GetProcessMetrics() const;
+
+        // 启动后台采样线程，每 interval 采样一次，per_thread 为 true 时同时采集各线程的指标；
+        // 采样期间 /proc 下的文件保持打开，每次用 pread 重新读取。已经在运行时什么也不做
+        void StartSampling(std::chrono::milliseconds interval = std::chrono::milliseconds(100), bool per_thread = true);
+
+        // 停止后台采样，最后一次的结果仍可读取
+        void StopSampling();
+
+        [[nodiscard]] bool IsSampling() const;
+
+        // 最近一次采样的结果，不加锁，可以在任意线程高频调用
+        [[nodiscard]] MonitorSnapshot GetSnapshot() const;
+
     private:
         class Impl;
         Impl* impl_;
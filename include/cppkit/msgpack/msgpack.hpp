@@ -0,0 +1,521 @@
+#pragma once
+
+#include "cppkit/json/json.hpp"
+#include <array>
+#include <bit>
+#include <cstddef>
+#include <limits>
+#include <span>
+
+namespace cppkit::msgpack
+{
+    // MessagePack 编解码
+    //  - REFLECT 注册的结构体编码为以字段名为 key 的 map，字段头部（fixstr + 名字）在编译期生成
+    //  - 直接写入任意满足 json::JsonSink 的缓冲区（std::string、json::OutputBuffer 等）
+    //  - 解码时 std::string_view / std::span<const std::byte> 字段直接引用输入，不做拷贝
+    //  - std::vector<std::byte> 与 std::span<const std::byte> 编码为 bin，其余序列编码为 array
+
+    namespace internal
+    {
+        template <json::JsonSink S, typename U>
+        void writeBigEndian(S& out, const uint8_t marker, const U value)
+        {
+            char buf[1 + sizeof(U)];
+            buf[0] = static_cast<char>(marker);
+            for (size_t i = 0; i < sizeof(U); ++i)
+                buf[1 + i] = static_cast<char>(static_cast<uint64_t>(value) >> (8 * (sizeof(U) - 1 - i)));
+            out.append(buf, sizeof(buf));
+        }
+
+        // fixstr 头部 + 字段名，编译期生成
+        template <typename T, size_t I>
+        struct KeyPrefix
+        {
+            static constexpr std::string_view name = std::get<I>(reflection::MetaData<T>::info()).name;
+            static_assert(name.size() < 32, "msgpack: field name must be shorter than 32 bytes");
+
+            static constexpr auto value = []
+            {
+                std::array<char, name.size() + 1> buf{};
+                buf[0] = static_cast<char>(0xA0 | name.size());
+                for (size_t i = 0; i < name.size(); ++i)
+                    buf[i + 1] = name[i];
+                return buf;
+            }();
+        };
+
+        template <typename T>
+        inline constexpr bool is_byte_sequence_v =
+            std::is_same_v<T, std::vector<std::byte>> || std::is_same_v<T, std::span<const std::byte>>;
+    }
+
+    template <json::JsonSink S>
+    void writeNil(S& out) { out.push_back(static_cast<char>(0xC0)); }
+
+    template <json::JsonSink S>
+    void writeBool(S& out, const bool b) { out.push_back(static_cast<char>(b ? 0xC3 : 0xC2)); }
+
+    template <json::JsonSink S>
+    void writeUint(S& out, const uint64_t v)
+    {
+        if (v < 0x80)
+            out.push_back(static_cast<char>(v));
+        else if (v <= UINT8_MAX)
+            internal::writeBigEndian(out, 0xCC, static_cast<uint8_t>(v));
+        else if (v <= UINT16_MAX)
+            internal::writeBigEndian(out, 0xCD, static_cast<uint16_t>(v));
+        else if (v <= UINT32_MAX)
+            internal::writeBigEndian(out, 0xCE, static_cast<uint32_t>(v));
+        else
+            internal::writeBigEndian(out, 0xCF, v);
+    }
+
+    template <json::JsonSink S>
+    void writeInt(S& out, const int64_t v)
+    {
+        if (v >= 0)
+            msgpack::writeUint(out, static_cast<uint64_t>(v));
+        else if (v >= -32)
+            out.push_back(static_cast<char>(v));
+        else if (v >= INT8_MIN)
+            internal::writeBigEndian(out, 0xD0, static_cast<uint8_t>(v));
+        else if (v >= INT16_MIN)
+            internal::writeBigEndian(out, 0xD1, static_cast<uint16_t>(v));
+        else if (v >= INT32_MIN)
+            internal::writeBigEndian(out, 0xD2, static_cast<uint32_t>(v));
+        else
+            internal::writeBigEndian(out, 0xD3, static_cast<uint64_t>(v));
+    }
+
+    template <json::JsonSink S>
+    void writeFloat(S& out, const float v) { internal::writeBigEndian(out, 0xCA, std::bit_cast<uint32_t>(v)); }
+
+    template <json::JsonSink S>
+    void writeDouble(S& out, const double v) { internal::writeBigEndian(out, 0xCB, std::bit_cast<uint64_t>(v)); }
+
+    template <json::JsonSink S>
+    void writeString(S& out, const std::string_view s)
+    {
+        if (s.size() < 32)
+            out.push_back(static_cast<char>(0xA0 | s.size()));
+        else if (s.size() <= UINT8_MAX)
+            internal::writeBigEndian(out, 0xD9, static_cast<uint8_t>(s.size()));
+        else if (s.size() <= UINT16_MAX)
+            internal::writeBigEndian(out, 0xDA, static_cast<uint16_t>(s.size()));
+        else
+            internal::writeBigEndian(out, 0xDB, static_cast<uint32_t>(s.size()));
+        out.append(s.data(), s.size());
+    }
+
+    template <json::JsonSink S>
+    void writeBinary(S& out, const std::span<const std::byte> bytes)
+    {
+        if (bytes.size() <= UINT8_MAX)
+            internal::writeBigEndian(out, 0xC4, static_cast<uint8_t>(bytes.size()));
+        else if (bytes.size() <= UINT16_MAX)
+            internal::writeBigEndian(out, 0xC5, static_cast<uint16_t>(bytes.size()));
+        else
+            internal::writeBigEndian(out, 0xC6, static_cast<uint32_t>(bytes.size()));
+        out.append(reinterpret_cast<const char*>(bytes.data()), bytes.size());
+    }
+
+    template <json::JsonSink S>
+    void writeArrayHeader(S& out, const size_t n)
+    {
+        if (n < 16)
+            out.push_back(static_cast<char>(0x90 | n));
+        else if (n <= UINT16_MAX)
+            internal::writeBigEndian(out, 0xDC, static_cast<uint16_t>(n));
+        else
+            internal::writeBigEndian(out, 0xDD, static_cast<uint32_t>(n));
+    }
+
+    template <json::JsonSink S>
+    void writeMapHeader(S& out, const size_t n)
+    {
+        if (n < 16)
+            out.push_back(static_cast<char>(0x80 | n));
+        else if (n <= UINT16_MAX)
+            internal::writeBigEndian(out, 0xDE, static_cast<uint16_t>(n));
+        else
+            internal::writeBigEndian(out, 0xDF, static_cast<uint32_t>(n));
+    }
+
+    template <json::JsonSink S>
+    void encodeJson(S& out, const json::Json& json);
+
+    template <json::JsonSink S, typename T>
+    void encodeTo(S& out, const T& obj);
+
+    namespace internal
+    {
+        template <typename T, size_t I, json::JsonSink S>
+        void encodeField(S& out, const T& obj)
+        {
+            using ItemType = std::decay_t<std::tuple_element_t<I, decltype(reflection::MetaData<T>::info())>>;
+            if constexpr (reflection::internal::is_field_tag_v<ItemType>)
+            {
+                constexpr auto& prefix = KeyPrefix<T, I>::value;
+                constexpr auto ptr = std::get<I>(reflection::MetaData<T>::info()).ptr;
+                out.append(prefix.data(), prefix.size());
+                encodeTo(out, obj.*ptr);
+            }
+        }
+
+        template <typename T, json::JsonSink S, size_t... I>
+        void encodeFields(S& out, const T& obj, std::index_sequence<I...>)
+        {
+            (encodeField<T, I>(out, obj), ...);
+        }
+    }
+
+    // 将对象编码为 MessagePack 写入 out
+    template <json::JsonSink S, typename T>
+    void encodeTo(S& out, const T& obj)
+    {
+        using Type = std::decay_t<T>;
+
+        if constexpr (std::is_same_v<Type, json::Json>)
+        {
+            encodeJson(out, obj);
+        }
+        else if constexpr (std::is_same_v<Type, bool>)
+        {
+            msgpack::writeBool(out, obj);
+        }
+        else if constexpr (std::is_integral_v<Type>)
+        {
+            if constexpr (std::is_signed_v<Type>)
+                msgpack::writeInt(out, obj);
+            else
+                msgpack::writeUint(out, obj);
+        }
+        else if constexpr (std::is_same_v<Type, float>)
+        {
+            msgpack::writeFloat(out, obj);
+        }
+        else if constexpr (std::is_floating_point_v<Type>)
+        {
+            msgpack::writeDouble(out, static_cast<double>(obj));
+        }
+        else if constexpr (std::is_convertible_v<Type, std::string_view>)
+        {
+            msgpack::writeString(out, std::string_view(obj));
+        }
+        else if constexpr (internal::is_byte_sequence_v<Type>)
+        {
+            msgpack::writeBinary(out, std::span<const std::byte>(obj));
+        }
+        else if constexpr (json::internal::is_sequence_container_v<Type> || json::internal::is_set_container_v<Type>)
+        {
+            msgpack::writeArrayHeader(out, obj.size());
+            for (const auto& item : obj)
+                encodeTo(out, item);
+        }
+        else if constexpr (json::internal::is_map_container_v<Type>)
+        {
+            msgpack::writeMapHeader(out, obj.size());
+            for (const auto& [key, value] : obj)
+            {
+                encodeTo(out, key);
+                encodeTo(out, value);
+            }
+        }
+        else if constexpr (json::internal::is_reflectable_v<Type>)
+        {
+            constexpr size_t count = std::tuple_size_v<decltype(reflection::MetaData<Type>::info())>;
+            msgpack::writeMapHeader(out, json::internal::reflectedFieldCount<Type>());
+            internal::encodeFields(out, obj, std::make_index_sequence<count>{});
+        }
+        else
+        {
+            static_assert(std::is_void_v<Type>, "Type is not registered with REFLECT macro!");
+        }
+    }
+
+    template <typename T>
+    std::string encode(const T& obj)
+    {
+        std::string out;
+        encodeTo(out, obj);
+        return out;
+    }
+
+    template <json::JsonSink S>
+    void encodeJson(S& out, const json::Json& json)
+    {
+        switch (json.type())
+        {
+        case json::Json::Type::Null:
+            msgpack::writeNil(out);
+            return;
+        case json::Json::Type::Bool:
+            msgpack::writeBool(out, json.asBool());
+            return;
+        case json::Json::Type::Int:
+            msgpack::writeInt(out, json.asInt64());
+            return;
+        case json::Json::Type::Uint:
+            msgpack::writeUint(out, json.asUint64());
+            return;
+        case json::Json::Type::Double:
+            msgpack::writeDouble(out, json.asNumber());
+            return;
+        case json::Json::Type::String:
+            msgpack::writeString(out, json.asString());
+            return;
+        case json::Json::Type::Array:
+            msgpack::writeArrayHeader(out, json.size());
+            for (const auto& item : json.asArray())
+                encodeJson(out, item);
+            return;
+        case json::Json::Type::Object:
+            msgpack::writeMapHeader(out, json.size());
+            for (const auto& [key, value] : json.asObject())
+            {
+                msgpack::writeString(out, key.view());
+                encodeJson(out, value);
+            }
+            return;
+        }
+    }
+
+    // 顺序读取 MessagePack 数据，字符串与二进制直接引用输入缓冲区
+    // 数据不合法或类型不匹配时抛出 std::runtime_error
+    class Reader
+    {
+    public:
+        enum class Type : uint8_t
+        {
+            Nil,
+            Bool,
+            Int,
+            Uint,
+            Float,
+            String,
+            Binary,
+            Array,
+            Map,
+            Extension
+        };
+
+        explicit Reader(const std::string_view data) noexcept
+            : p_(reinterpret_cast<const uint8_t*>(data.data())), end_(p_ + data.size())
+        {
+        }
+
+        explicit Reader(const std::span<const std::byte> data) noexcept
+            : p_(reinterpret_cast<const uint8_t*>(data.data())), end_(p_ + data.size())
+        {
+        }
+
+        [[nodiscard]]
+        bool atEnd() const noexcept { return p_ == end_; }
+
+        [[nodiscard]]
+        size_t remaining() const noexcept { return static_cast<size_t>(end_ - p_); }
+
+        // 下一个值的类型
+        [[nodiscard]]
+        Type peek() const;
+
+        // 下一个值为 nil 时消费它并返回 true
+        bool tryNil();
+
+        bool readBool();
+
+        int64_t readInt64();
+
+        uint64_t readUint64();
+
+        // 任意数字按 double 返回
+        double readDouble();
+
+        std::string_view readString();
+
+        std::span<const std::byte> readBinary();
+
+        uint32_t readArrayHeader();
+
+        uint32_t readMapHeader();
+
+        // 跳过一个完整的值
+        void skip();
+
+    private:
+        uint8_t next();
+
+        const uint8_t* take(size_t n);
+
+        template <typename U>
+        U readBigEndian()
+        {
+            const uint8_t* p = take(sizeof(U));
+            uint64_t v = 0;
+            for (size_t i = 0; i < sizeof(U); ++i)
+                v = (v << 8) | p[i];
+            return static_cast<U>(v);
+        }
+
+        void skip(int depth);
+
+        const uint8_t* p_;
+        const uint8_t* end_;
+    };
+
+    // 读取一个值并转换为 Json；非字符串 key 转为其文本形式，bin 转为字符串
+    json::Json readJson(Reader& in);
+
+    template <typename T>
+    void decodeFrom(Reader& in, T& out);
+
+    namespace internal
+    {
+        template <typename T>
+        void decodeStruct(Reader& in, T& out)
+        {
+            const uint32_t n = in.readMapHeader();
+            for (uint32_t i = 0; i < n; ++i)
+            {
+                const std::string_view key = in.readString();
+                bool found = false;
+                reflection::forEachField(out, [&](const std::string_view name, auto& field)
+                {
+                    if (!found && name == key)
+                    {
+                        found = true;
+                        decodeFrom(in, field);
+                    }
+                });
+                if (!found)
+                    in.skip();
+            }
+        }
+    }
+
+    // 从 in 中解码一个值到 out；nil 保持 out 不变
+    template <typename T>
+    void decodeFrom(Reader& in, T& out)
+    {
+        using Type = std::decay_t<T>;
+
+        if constexpr (std::is_same_v<Type, json::Json>)
+        {
+            out = readJson(in);
+        }
+        else if (in.tryNil())
+        {
+        }
+        else if constexpr (std::is_same_v<Type, bool>)
+        {
+            out = in.readBool();
+        }
+        else if constexpr (std::is_integral_v<Type>)
+        {
+            if constexpr (std::is_signed_v<Type>)
+            {
+                const int64_t v = in.readInt64();
+                if (v < std::numeric_limits<Type>::min() || v > std::numeric_limits<Type>::max())
+                    throw std::runtime_error("msgpack: integer out of range");
+                out = static_cast<Type>(v);
+            }
+            else
+            {
+                const uint64_t v = in.readUint64();
+                if (v > std::numeric_limits<Type>::max())
+                    throw std::runtime_error("msgpack: integer out of range");
+                out = static_cast<Type>(v);
+            }
+        }
+        else if constexpr (std::is_floating_point_v<Type>)
+        {
+            out = static_cast<Type>(in.readDouble());
+        }
+        else if constexpr (std::is_same_v<Type, std::string_view>)
+        {
+            out = in.readString();
+        }
+        else if constexpr (std::is_same_v<Type, std::span<const std::byte>>)
+        {
+            out = in.readBinary();
+        }
+        else if constexpr (std::is_same_v<Type, std::vector<std::byte>>)
+        {
+            const auto bytes = in.readBinary();
+            out.assign(bytes.begin(), bytes.end());
+        }
+        else if constexpr (std::is_convertible_v<Type, std::string>)
+        {
+            out = Type(in.readString());
+        }
+        else if constexpr (json::internal::is_sequence_container_v<Type> || json::internal::is_set_container_v<Type>)
+        {
+            const uint32_t n = in.readArrayHeader();
+            out.clear();
+            if constexpr (std::is_same_v<Type, std::vector<typename Type::value_type>>)
+            {
+                out.reserve(std::min<size_t>(n, in.remaining()));
+            }
+            for (uint32_t i = 0; i < n; ++i)
+            {
+                typename Type::value_type val{};
+                decodeFrom(in, val);
+                if constexpr (json::internal::is_set_container_v<Type>)
+                    out.insert(std::move(val));
+                else
+                    out.push_back(std::move(val));
+            }
+        }
+        else if constexpr (json::internal::is_map_container_v<Type>)
+        {
+            const uint32_t n = in.readMapHeader();
+            out.clear();
+            for (uint32_t i = 0; i < n; ++i)
+            {
+                typename Type::key_type key{};
+                decodeFrom(in, key);
+                typename Type::mapped_type value{};
+                decodeFrom(in, value);
+                out.emplace(std::move(key), std::move(value));
+            }
+        }
+        else if constexpr (json::internal::is_reflectable_v<Type>)
+        {
+            internal::decodeStruct(in, out);
+        }
+        else
+        {
+            static_assert(std::is_void_v<Type>, "Type is not registered with REFLECT macro!");
+        }
+    }
+
+    // 解码整个缓冲区，结尾有多余数据时抛出异常
+    // 若 T 含 std::string_view / std::span 字段，它们引用 data，需保证 data 的生命周期
+    template <typename T>
+    void decode(const std::string_view data, T& out)
+    {
+        Reader in(data);
+        decodeFrom(in, out);
+        if (!in.atEnd())
+            throw std::runtime_error("msgpack: extra bytes after value");
+    }
+
+    template <typename T>
+    T decode(const std::string_view data)
+    {
+        T obj{};
+        decode(data, obj);
+        return obj;
+    }
+
+    // MessagePack 转 Json
+    json::Json toJson(std::string_view data);
+
+    // Json 转 MessagePack
+    inline std::string fromJson(const json::Json& json)
+    {
+        std::string out;
+        encodeJson(out, json);
+        return out;
+    }
+} // namespace cppkit::msgpack
@@ -1,14 +1,20 @@
 #pragma once
 
 #include <string>
+#include <string_view>
 #include <vector>
 #include <algorithm>
+#include <cstddef>
+#include <iterator>
 
 namespace cppkit
 {
     // Trims whitespace from both ends of the string
     std::string trim(std::string_view s);
 
+    // Same as trim() but returns a view into s instead of a copy
+    std::string_view trimView(std::string_view s);
+
     // Joins a vector of strings into a single string with the given separator
     std::string join(const std::vector<std::string>& list, std::string_view sep);
 
@@ -18,12 +24,117 @@ namespace cppkit
     // Checks if the string ends with the given suffix
     bool endsWith(std::string_view s, std::string_view suffix);
 
-    // Converts the string to lowercase
+    // Converts the string to lowercase (ASCII only, other bytes are left untouched)
     std::string toLower(std::string s);
 
-    // Converts the string to uppercase
+    // Converts the string to uppercase (ASCII only, other bytes are left untouched)
     std::string toUpper(std::string s);
 
+    // In-place variants of toLower/toUpper, folded 16/32 bytes at a time with SSE2/AVX2
+    void toLowerInPlace(std::string& s);
+    void toUpperInPlace(std::string& s);
+
+    // Appends the lowercase/uppercase form of s to out without a temporary string
+    void appendLower(std::string& out, std::string_view s);
+    void appendUpper(std::string& out, std::string_view s);
+
+    // ASCII case-insensitive comparison, e.g. for HTTP header names and tokens
+    bool iequals(std::string_view a, std::string_view b);
+
+    // Returns the position of the first byte in s[pos..] that is one of chars, or npos
+    // Up to 8 chars are matched 16/32 bytes at a time with SSE2/AVX2
+    size_t findFirstOf(std::string_view s, std::string_view chars, size_t pos = 0);
+
+    // Forward range over the pieces of s separated by delimiter, yielding the same pieces as split()
+    // (including empty ones); pieces are views into s, so s must outlive the range
+    class SplitView
+    {
+    public:
+        class iterator
+        {
+        public:
+            using iterator_category = std::forward_iterator_tag;
+            using value_type = std::string_view;
+            using difference_type = std::ptrdiff_t;
+            using pointer = const std::string_view*;
+            using reference = std::string_view;
+
+            iterator() = default;
+
+            iterator(const std::string_view s, const char delimiter) : _rest(s), _delimiter(delimiter), _done(false)
+            {
+                next();
+            }
+
+            std::string_view operator*() const { return _piece; }
+
+            const std::string_view* operator->() const { return &_piece; }
+
+            iterator& operator++()
+            {
+                if (_last)
+                {
+                    _done = true;
+                }
+                else
+                {
+                    next();
+                }
+                return *this;
+            }
+
+            iterator operator++(int)
+            {
+                iterator old = *this;
+                ++*this;
+                return old;
+            }
+
+            bool operator==(const iterator& other) const
+            {
+                return _done == other._done && (_done || _piece.data() == other._piece.data());
+            }
+
+            bool operator==(std::default_sentinel_t) const { return _done; }
+
+        private:
+            void next()
+            {
+                const size_t pos = _rest.find(_delimiter);
+                _last = pos == std::string_view::npos;
+                _piece = _rest.substr(0, pos);
+                _rest.remove_prefix(_last ? _rest.size() : pos + 1);
+            }
+
+            std::string_view _rest;
+            std::string_view _piece;
+            char _delimiter = 0;
+            bool _last = false;
+            bool _done = true;
+        };
+
+        SplitView(const std::string_view s, const char delimiter) : _s(s), _delimiter(delimiter)
+        {
+        }
+
+        [[nodiscard]] iterator begin() const { return {_s, _delimiter}; }
+
+        [[nodiscard]] iterator end() const { return {}; }
+
+    private:
+        std::string_view _s;
+        char _delimiter;
+    };
+
+    // Splits s lazily: for (std::string_view part : splitView(path, '/')) ...
+    inline SplitView splitView(const std::string_view s, const char delimiter)
+    {
+        return {s, delimiter};
+    }
+
+    // Splits s into views appended to out (out is cleared first, its capacity is reused)
+    void splitInto(std::string_view s, char delimiter, std::vector<std::string_view>& out);
+
     // Splits the string by the given delimiter into a vector of strings
     std::vector<std::string> split(std::string_view s, char delimiter);
 
@@ -36,6 +147,9 @@ namespace cppkit
     // Escapes HTML special characters in the string
     std::string escapeHtml(std::string_view s);
 
+    // Appends the HTML-escaped form of s to out; runs without special characters are copied in bulk
+    void appendEscapedHtml(std::string& out, std::string_view s);
+
     // Unescapes HTML special characters in the string
     std::string unescapeHtml(std::string_view s);
 
@@ -45,6 +159,16 @@ namespace cppkit
     // URL decodes the string
     std::string urlDecode(std::string_view s, bool spaceAsPlus = true);
 
+    // Appends the URL-decoded form of s to out
+    void appendUrlDecoded(std::string& out, std::string_view s, bool spaceAsPlus = true);
+
+    // URL decodes s in place (the decoded form is never longer)
+    void urlDecodeInPlace(std::string& s, bool spaceAsPlus = true);
+
+    // Checks whether the bytes are well-formed UTF-8 (RFC 3629: no overlongs, surrogates or code points > U+10FFFF)
+    // ASCII runs are skipped 16/32 bytes at a time with SSE2/AVX2
+    bool isValidUtf8(std::string_view s);
+
     // 寻找路径分隔符并返回文件名或相对路径
     consteval const char* shortFilename(const char* path)
     {
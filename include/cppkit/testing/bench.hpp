@@ -0,0 +1,483 @@
+#pragma once
+
+#include <algorithm>
+#include <barrier>
+#include <chrono>
+#include <cstdint>
+#include <cstdio>
+#include <ctime>
+#include <exception>
+#include <fstream>
+#include <functional>
+#include <iomanip>
+#include <iostream>
+#include <mutex>
+#include <string>
+#include <string_view>
+#include <thread>
+#include <type_traits>
+#include <vector>
+
+namespace cppkit::bench
+{
+    // 阻止编译器把 value 的计算当作无用代码删掉
+    template <typename T>
+    inline void DoNotOptimize(const T& value)
+    {
+        asm volatile("" : : "r,m"(value) : "memory");
+    }
+
+    template <typename T>
+    inline void DoNotOptimize(T& value)
+    {
+        if constexpr (std::is_trivially_copyable_v<T> && sizeof(T) <= sizeof(void*))
+        {
+            asm volatile("" : "+r,m"(value) : : "memory");
+        }
+        else
+        {
+            asm volatile("" : "+m"(value) : : "memory");
+        }
+    }
+
+    // 强制之前的写入对内存可见，阻止编译器跨过这一点合并或消除读写
+    inline void ClobberMemory()
+    {
+        asm volatile("" : : : "memory");
+    }
+
+    // 基准函数的运行状态，用法：for (auto _ : state) { ... }
+    class State
+    {
+    public:
+        struct [[maybe_unused]] Value
+        {
+        };
+
+        class Iterator
+        {
+        public:
+            Iterator(State* state, const uint64_t remaining) : state_(state), remaining_(remaining)
+            {
+            }
+
+            Value operator*() const { return {}; }
+
+            Iterator& operator++()
+            {
+                --remaining_;
+                return *this;
+            }
+
+            bool operator!=(const Iterator&) const
+            {
+                if (remaining_ != 0) [[likely]]
+                {
+                    return true;
+                }
+                state_->StopTiming();
+                return false;
+            }
+
+        private:
+            State* state_;
+            uint64_t remaining_;
+        };
+
+        State(const uint64_t iterations, const int threadIndex, const int threads, std::barrier<>* startLine)
+            : iterations_(iterations), threadIndex_(threadIndex), threads_(threads), startLine_(startLine)
+        {
+        }
+
+        Iterator begin()
+        {
+            if (startLine_ != nullptr)
+            {
+                startLine_->arrive_and_wait(); // 多线程模式下所有线程同时开始
+            }
+            ResumeTiming();
+            return {this, iterations_};
+        }
+
+        Iterator end() { return {this, 0}; }
+
+        // 暂停计时，用于排除每轮的准备工作
+        void PauseTiming()
+        {
+            elapsed_ += std::chrono::steady_clock::now() - start_;
+            running_ = false;
+        }
+
+        void ResumeTiming()
+        {
+            running_ = true;
+            start_ = std::chrono::steady_clock::now();
+        }
+
+        [[nodiscard]] uint64_t Iterations() const { return iterations_; }
+
+        // 多线程模式下的线程序号，从 0 开始
+        [[nodiscard]] int ThreadIndex() const { return threadIndex_; }
+
+        [[nodiscard]] int Threads() const { return threads_; }
+
+        // 本线程在整个循环中处理的字节数 / 条目数，用于计算吞吐
+        void SetBytesProcessed(const uint64_t bytes) { bytes_ = bytes; }
+
+        void SetItemsProcessed(const uint64_t items) { items_ = items; }
+
+        [[nodiscard]] std::chrono::nanoseconds Elapsed() const { return elapsed_; }
+
+        [[nodiscard]] uint64_t BytesProcessed() const { return bytes_; }
+
+        [[nodiscard]] uint64_t ItemsProcessed() const { return items_; }
+
+    private:
+        void StopTiming()
+        {
+            if (running_)
+            {
+                PauseTiming();
+            }
+        }
+
+        uint64_t iterations_;
+        int threadIndex_;
+        int threads_;
+        std::barrier<>* startLine_;
+        bool running_ = false;
+        std::chrono::steady_clock::time_point start_{};
+        std::chrono::nanoseconds elapsed_{0};
+        uint64_t bytes_ = 0;
+        uint64_t items_ = 0;
+    };
+
+    using BenchFunction = std::function<void(State&)>;
+
+    class BenchRegistry
+    {
+    public:
+        struct BenchInfo
+        {
+            std::string name;
+            BenchFunction fn;
+            int threads; // 0 表示使用全部硬件线程
+        };
+
+        static BenchRegistry& GetInstance()
+        {
+            static BenchRegistry instance;
+            return instance;
+        }
+
+        void RegisterBench(const std::string& suite_name, const std::string& bench_name, const BenchFunction& fn,
+                           const int threads = 1)
+        {
+            benches_.push_back({suite_name + "." + bench_name, fn, threads});
+        }
+
+        const std::vector<BenchInfo>& GetBenches() const { return benches_; }
+
+    private:
+        std::vector<BenchInfo> benches_;
+    };
+
+    struct Options
+    {
+        std::string filter; // 名称包含该子串的才运行
+        double min_time = 0.5; // 每次测量至少运行的秒数
+        double warmup_time = 0.1; // 正式测量前的预热秒数
+        int repetitions = 1; // 重复测量次数，报告中位数
+        std::string json_path; // 非空时写出 JSON 报告
+        bool list = false;
+    };
+
+    struct Result
+    {
+        std::string name;
+        int threads;
+        uint64_t iterations; // 每个线程的迭代次数
+        double ns_per_op; // 多次测量的中位数
+        double ns_per_op_min;
+        double ns_per_op_max;
+        double bytes_per_second;
+        double items_per_second;
+    };
+
+    namespace inner
+    {
+        struct Sample
+        {
+            double seconds; // 最慢线程的计时
+            uint64_t bytes;
+            uint64_t items;
+        };
+
+        inline Sample RunOnce(const BenchFunction& fn, const uint64_t iterations, const int threads)
+        {
+            if (threads == 1)
+            {
+                State state(iterations, 0, 1, nullptr);
+                fn(state);
+                return {std::chrono::duration<double>(state.Elapsed()).count(), state.BytesProcessed(),
+                        state.ItemsProcessed()};
+            }
+
+            std::barrier<> startLine(threads);
+            std::vector<State> states;
+            states.reserve(threads);
+            for (int i = 0; i < threads; ++i)
+            {
+                states.emplace_back(iterations, i, threads, &startLine);
+            }
+            std::vector<std::thread> workers;
+            std::exception_ptr error;
+            std::mutex errorMutex;
+            for (int i = 0; i < threads; ++i)
+            {
+                workers.emplace_back([&, i]
+                {
+                    try
+                    {
+                        fn(states[i]);
+                    }
+                    catch (...)
+                    {
+                        std::lock_guard lock(errorMutex);
+                        error = std::current_exception();
+                    }
+                });
+            }
+            for (auto& worker : workers)
+            {
+                worker.join();
+            }
+            if (error)
+            {
+                std::rethrow_exception(error);
+            }
+
+            Sample sample{0, 0, 0};
+            for (const auto& state : states)
+            {
+                sample.seconds = std::max(sample.seconds, std::chrono::duration<double>(state.Elapsed()).count());
+                sample.bytes += state.BytesProcessed();
+                sample.items += state.ItemsProcessed();
+            }
+            return sample;
+        }
+
+        // 预热后逐步放大迭代次数，直到一次运行超过 min_time
+        inline uint64_t Calibrate(const BenchFunction& fn, const int threads, const Options& options)
+        {
+            constexpr uint64_t MAX_ITERATIONS = 1000000000;
+            uint64_t iterations = 1;
+            double warmed = 0;
+            while (warmed < options.warmup_time && iterations < MAX_ITERATIONS)
+            {
+                warmed += RunOnce(fn, iterations, threads).seconds;
+                iterations *= 2;
+            }
+
+            iterations = 1;
+            while (true)
+            {
+                const double seconds = RunOnce(fn, iterations, threads).seconds;
+                if (seconds >= options.min_time || iterations >= MAX_ITERATIONS)
+                {
+                    return iterations;
+                }
+                // 按已测耗时预测所需次数，多留 40% 余量；耗时太短时预测不可靠，只放大 10 倍
+                double multiplier = seconds / options.min_time > 0.1 ? options.min_time * 1.4 / seconds : 10.0;
+                multiplier = std::clamp(multiplier, 1.5, 10.0);
+                iterations = std::min(MAX_ITERATIONS, static_cast<uint64_t>(static_cast<double>(iterations) * multiplier));
+            }
+        }
+
+        inline Result Run(const BenchRegistry::BenchInfo& info, const Options& options)
+        {
+            const int threads = info.threads > 0
+                                    ? info.threads
+                                    : static_cast<int>(std::max(1u, std::thread::hardware_concurrency()));
+            const uint64_t iterations = Calibrate(info.fn, threads, options);
+
+            std::vector<Sample> samples;
+            for (int r = 0; r < std::max(1, options.repetitions); ++r)
+            {
+                samples.push_back(RunOnce(info.fn, iterations, threads));
+            }
+            std::ranges::sort(samples, {}, &Sample::seconds);
+            const Sample& median = samples[samples.size() / 2];
+
+            const auto perOp = [&](const Sample& s) { return s.seconds * 1e9 / static_cast<double>(iterations); };
+            Result result{};
+            result.name = info.name + (info.threads == 1 ? "" : "/threads:" + std::to_string(threads));
+            result.threads = threads;
+            result.iterations = iterations;
+            result.ns_per_op = perOp(median);
+            result.ns_per_op_min = perOp(samples.front());
+            result.ns_per_op_max = perOp(samples.back());
+            result.bytes_per_second = median.seconds > 0 ? static_cast<double>(median.bytes) / median.seconds : 0;
+            result.items_per_second = median.seconds > 0 ? static_cast<double>(median.items) / median.seconds : 0;
+            return result;
+        }
+
+        inline std::string FormatNumber(const char* fmt, const double v)
+        {
+            char buf[64];
+            std::snprintf(buf, sizeof(buf), fmt, v);
+            return buf;
+        }
+
+        // 每个基准一行，键顺序固定，方便直接 diff 两次报告
+        inline std::string ToJson(const std::vector<Result>& results)
+        {
+            const std::time_t now = std::time(nullptr);
+            char date[32];
+            std::strftime(date, sizeof(date), "%Y-%m-%dT%H:%M:%SZ", std::gmtime(&now));
+
+            std::string out = "{\n  \"context\": {\"date\": \"";
+            out.append(date).append("\", \"cpus\": ");
+            out.append(std::to_string(std::thread::hardware_concurrency()));
+#if defined(NDEBUG)
+            out.append(", \"build\": \"release\"");
+#else
+            out.append(", \"build\": \"debug\"");
+#endif
+#if defined(__VERSION__)
+            out.append(", \"compiler\": \"").append(__VERSION__).append("\"");
+#endif
+            out.append("},\n  \"benchmarks\": [");
+            for (size_t i = 0; i < results.size(); ++i)
+            {
+                const Result& r = results[i];
+                out.append(i == 0 ? "\n    " : ",\n    ");
+                out.append("{\"name\": \"").append(r.name).append("\"");
+                out.append(", \"threads\": ").append(std::to_string(r.threads));
+                out.append(", \"iterations\": ").append(std::to_string(r.iterations));
+                out.append(", \"ns_per_op\": ").append(FormatNumber("%.3f", r.ns_per_op));
+                out.append(", \"ns_per_op_min\": ").append(FormatNumber("%.3f", r.ns_per_op_min));
+                out.append(", \"ns_per_op_max\": ").append(FormatNumber("%.3f", r.ns_per_op_max));
+                out.append(", \"bytes_per_second\": ").append(FormatNumber("%.0f", r.bytes_per_second));
+                out.append(", \"items_per_second\": ").append(FormatNumber("%.0f", r.items_per_second));
+                out.append("}");
+            }
+            out.append("\n  ]\n}\n");
+            return out;
+        }
+
+        inline bool ParseArgs(const int argc, char** argv, Options& options)
+        {
+            for (int i = 1; i < argc; ++i)
+            {
+                const std::string_view arg = argv[i];
+                const auto value = [&](const std::string_view key) -> const char*
+                {
+                    return arg.starts_with(key) ? argv[i] + key.size() : nullptr;
+                };
+                try
+                {
+                    if (const char* v = value("--filter="))
+                        options.filter = v;
+                    else if (const char* v = value("--min-time="))
+                        options.min_time = std::stod(v);
+                    else if (const char* v = value("--warmup="))
+                        options.warmup_time = std::stod(v);
+                    else if (const char* v = value("--repetitions="))
+                        options.repetitions = std::stoi(v);
+                    else if (const char* v = value("--json="))
+                        options.json_path = v;
+                    else if (arg == "--list")
+                        options.list = true;
+                    else
+                        return false;
+                }
+                catch (const std::exception&)
+                {
+                    return false;
+                }
+            }
+            return true;
+        }
+    }
+
+    inline int RunAllBenchmarks(const Options& options)
+    {
+        std::vector<Result> results;
+        int failed_count = 0;
+
+        for (const auto& info : BenchRegistry::GetInstance().GetBenches())
+        {
+            if (!options.filter.empty() && info.name.find(options.filter) == std::string::npos)
+            {
+                continue;
+            }
+            if (options.list)
+            {
+                std::cout << info.name << std::endl;
+                continue;
+            }
+            if (results.empty() && failed_count == 0)
+            {
+                std::cout << std::left << std::setw(48) << "Benchmark" << std::right << std::setw(14) << "Iterations"
+                    << std::setw(14) << "ns/op" << std::setw(12) << "MB/s" << std::setw(14) << "items/s" << std::endl;
+            }
+            try
+            {
+                const Result r = inner::Run(info, options);
+                std::cout << std::left << std::setw(48) << r.name << std::right << std::setw(14) << r.iterations
+                    << std::fixed << std::setprecision(2) << std::setw(14) << r.ns_per_op << std::setprecision(1)
+                    << std::setw(12) << r.bytes_per_second / (1024 * 1024) << std::setprecision(0)
+                    << std::setw(14) << r.items_per_second << std::endl;
+                results.push_back(r);
+            }
+            catch (const std::exception& e)
+            {
+                std::cerr << "[  FAILED  ] " << info.name << ": " << e.what() << std::endl;
+                failed_count++;
+            }
+        }
+
+        if (!options.json_path.empty() && !options.list)
+        {
+            std::ofstream ofs(options.json_path, std::ios::trunc);
+            ofs << inner::ToJson(results);
+            if (!ofs)
+            {
+                std::cerr << "Failed to write " << options.json_path << std::endl;
+                return 1;
+            }
+        }
+        return failed_count > 0 ? 1 : 0;
+    }
+
+    inline int RunAllBenchmarks(const int argc, char** argv)
+    {
+        Options options;
+        if (!inner::ParseArgs(argc, argv, options))
+        {
+            std::cerr << "usage: " << argv[0] << " [--filter=<substr>] [--min-time=<s>] [--warmup=<s>]"
+                " [--repetitions=<n>] [--json=<path>] [--list]" << std::endl;
+            return 2;
+        }
+        return RunAllBenchmarks(options);
+    }
+
+#define BENCH_THREADS(suite, name, threads)                                    \
+  namespace {                                                                  \
+  class Bench_##suite##_##name {                                               \
+  public:                                                                      \
+    static void Body(::cppkit::bench::State& state);                           \
+  };                                                                           \
+                                                                               \
+  [[maybe_unused]] bool Bench_##suite##_##name##_registered = []() {           \
+    ::cppkit::bench::BenchRegistry::GetInstance().RegisterBench(               \
+        #suite, #name, Bench_##suite##_##name::Body, threads);                 \
+    return true;                                                               \
+  }();                                                                         \
+  }                                                                            \
+  void Bench_##suite##_##name::Body(::cppkit::bench::State& state)
+
+// 注册单线程基准；BENCH_THREADS 的 threads 为 0 时使用全部硬件线程
+#define BENCH(suite, name) BENCH_THREADS(suite, name, 1)
+} // namespace cppkit::bench
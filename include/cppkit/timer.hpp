@@ -1,68 +1,84 @@
 #pragma once
 
+#include "cppkit/concurrency/thread_pool.hpp"
+#include <array>
 #include <vector>
-#include <list>
-#include <unordered_map>
+#include <deque>
 #include <memory>
 #include <atomic>
 #include <thread>
 #include <mutex>
+#include <condition_variable>
 #include <functional>
 #include <chrono>
-#include <iostream>
 
 namespace cppkit
 {
     using TimerId = uint64_t;
 
-    // 默认轮子大小
-    constexpr size_t DEFAULT_WHEEL_SIZE = 512;
+    // 默认时间精度 (微秒)
+    constexpr size_t DEFAULT_TICK_DURATION_US = 100;
 
-    // 默认时间精度 (毫秒)
-    constexpr size_t DEFAULT_TICK_DURATION_MS = 100;
+    // 默认分片数
+    constexpr size_t DEFAULT_TIMER_SHARDS = 8;
 
-    // 定时器配置
+    // 定时器配置，建议用指定初始化器：WheelConfig{.tickDuration = 1ms, .shards = 4}
+    // 旧版的第二个字段是 wheel_size，executor 放在第二位使 WheelConfig{100ms, 512} 这类旧写法无法编译
     struct WheelConfig
     {
-        std::chrono::milliseconds tickDuration{DEFAULT_TICK_DURATION_MS};
-        size_t wheel_size{DEFAULT_WHEEL_SIZE};
+        std::chrono::microseconds tickDuration{DEFAULT_TICK_DURATION_US};
+
+        // 执行回调的线程池；为 nullptr 时在定时器线程中执行，回调应尽量短
+        concurrency::ThreadPool* executor{nullptr};
+
+        // 分片数：每个分片一把锁、一组时间轮，不同线程添加任务时落在不同分片上
+        size_t shards{DEFAULT_TIMER_SHARDS};
     };
 
+    // 分层时间轮定时器
+    // 4 层、每层 256 格，共覆盖 2^32 个 tick，更远的任务先放在最高层，降级时重新计算位置
+    // 工作线程只在下一个到期（或降级）时间醒来，更早的任务加入时被唤醒；空闲时不会按 tick 空转
     class Timer
     {
-        // 内部任务节点
+        static constexpr size_t WHEEL_BITS = 8;
+        static constexpr size_t WHEEL_SIZE = 1 << WHEEL_BITS;
+        static constexpr size_t WHEEL_LEVELS = 4;
+
+        // 内部任务节点，从分片的节点池分配，通过侵入式链表挂在槽位上
         struct TimerNode
         {
-            TimerId id; // 任务ID
+            TimerNode* next{nullptr};
+            TimerNode** pprev{nullptr}; // 指向前一个节点的 next（或槽位头指针），O(1) 摘除
+            uint64_t expiry{0}; // 到期 tick
+            uint64_t interval{0}; // 周期 tick，0 表示一次性任务
+            uint32_t generation{0}; // 节点复用时加一，使旧 ID 失效
+            uint32_t index{0}; // 在节点池中的下标
+            uint8_t level{0};
+            uint8_t slot{0};
             std::function<void()> callback; // 任务回调
-            size_t rounds; // 剩余圈数
-            bool periodic; // 是否是周期性任务
-            std::chrono::milliseconds interval; // 周期时间
-            bool canceled{false}; // 惰性删除标记
-
-            TimerNode(const TimerId id, std::function<void()> cb, size_t r, bool p, std::chrono::milliseconds i)
-                : id(id), callback(std::move(cb)), rounds(r), periodic(p), interval(i)
-            {
-            }
         };
 
-        using TaskPtr = std::shared_ptr<TimerNode>;
-        using Slot = std::list<TaskPtr>;
+        // 每个分片独占缓存行，避免分片之间伪共享
+        struct alignas(64) Shard
+        {
+            std::mutex mutex;
+            uint64_t current{0}; // 已推进到的 tick
+            std::array<std::array<TimerNode*, WHEEL_SIZE>, WHEEL_LEVELS> wheels{};
+            std::array<std::array<uint64_t, WHEEL_SIZE / 64>, WHEEL_LEVELS> occupied{}; // 非空槽位位图
+            std::deque<TimerNode> nodes; // 节点池，deque 扩容时已有节点地址不变
+            std::vector<uint32_t> freeNodes;
+            size_t pending{0};
+        };
 
     public:
-        explicit Timer(const WheelConfig config = WheelConfig{})
-            : tickDuration(config.tickDuration),
-              wheelSize(config.wheel_size),
-              slots(config.wheel_size),
-              currentSlot(0),
-              running(false),
-              nextId(1)
-        {
-            start();
-        }
+        explicit Timer(const WheelConfig& config = WheelConfig{});
 
         ~Timer();
 
+        Timer(const Timer&) = delete;
+
+        Timer& operator=(const Timer&) = delete;
+
         /**
          * @brief 添加一次性任务
          * @return TimerId 用于取消
@@ -70,7 +86,8 @@ namespace cppkit
         template <typename Rep, typename Period>
         TimerId setTimeout(std::chrono::duration<Rep, Period> delay, std::function<void()> task)
         {
-            return addTimer(delay, std::chrono::duration<Rep, Period>::zero(), std::move(task));
+            return addTimer(std::chrono::duration_cast<std::chrono::nanoseconds>(delay),
+                            std::chrono::nanoseconds::zero(), std::move(task));
         }
 
         /**
@@ -79,74 +96,66 @@ namespace cppkit
         template <typename Rep, typename Period>
         TimerId setInterval(std::chrono::duration<Rep, Period> interval, std::function<void()> task)
         {
-            return addTimer(interval, interval, std::move(task));
+            const auto ns = std::chrono::duration_cast<std::chrono::nanoseconds>(interval);
+            return addTimer(ns, ns, std::move(task));
         }
 
         /**
-         * @brief 取消任务 (O(1))
+         * @brief 取消任务 (O(1))，任务已触发（一次性）或不存在时返回 false
          */
-        void cancel(TimerId id);
+        bool cancel(TimerId id);
 
+        // 停止工作线程，未触发的任务不再执行
         void stop();
 
+        // 尚未触发的任务数
+        [[nodiscard]]
+        size_t pending() const;
+
     private:
         void start();
 
-        template <typename Rep, typename Period>
-        TimerId addTimer(std::chrono::duration<Rep, Period> delay,
-                         std::chrono::duration<Rep, Period> interval,
-                         std::function<void()> task)
-        {
-            std::lock_guard lock(mutex);
+        TimerId addTimer(std::chrono::nanoseconds delay, std::chrono::nanoseconds interval,
+                         std::function<void()> task);
 
-            TimerId id = nextId++;
+        // 当前时间对应的 tick
+        [[nodiscard]]
+        uint64_t nowTick() const;
 
-            // 计算需要多少个 tick
-            auto delay_ms = std::chrono::duration_cast<std::chrono::milliseconds>(delay);
-            if (delay_ms < tickDuration) delay_ms = tickDuration;
+        // 把节点挂到与 shard.current 距离对应的层和槽位
+        static void link(Shard& shard, TimerNode* node);
 
-            const size_t ticks = delay_ms.count() / tickDuration.count();
+        static void unlink(Shard& shard, TimerNode* node);
 
-            // 计算圈数和槽位
-            size_t rounds = ticks / wheelSize;
-            const size_t target_slot = (currentSlot + ticks) % wheelSize;
+        static void releaseNode(Shard& shard, TimerNode* node);
 
-            auto node = std::make_shared<TimerNode>(
-                id,
-                std::move(task),
-                rounds,
-                interval.count(),
-                std::chrono::duration_cast<std::chrono::milliseconds>(interval)
-            );
+        // 下一个需要处理（到期或降级）的 tick，没有任务时返回 UINT64_MAX
+        [[nodiscard]]
+        static uint64_t nextEventTick(const Shard& shard);
 
-            // 放入槽位
-            slots[target_slot].push_back(node);
+        // 推进到 target，取出到期任务的回调，返回分片下一个事件的 tick
+        uint64_t advance(Shard& shard, uint64_t target, std::vector<std::function<void()>>& due) const;
 
-            // 记录 ID 映射 (用于快速取消)
-            timerMap[id] = node;
+        // 执行或派发到期回调
+        void dispatch(std::vector<std::function<void()>>& due) const;
 
-            return id;
-        }
+        // 有更早的任务加入时唤醒工作线程
+        void wake();
 
         void runLoop();
 
-        void processCurrentSlot();
-
-        void reschedulePeriodic(const TaskPtr& task);
-
-        std::chrono::milliseconds tickDuration;
-        size_t wheelSize;
+        std::chrono::microseconds tickDuration;
+        std::chrono::steady_clock::time_point epoch; // tick 0 对应的时间
+        concurrency::ThreadPool* executor;
 
-        // 环形数组：每个元素是一个链表
-        std::vector<Slot> slots;
-        size_t currentSlot;
+        std::vector<std::unique_ptr<Shard>> shards;
 
         std::atomic<bool> running;
         std::thread worker;
-        std::mutex mutex;
 
-        std::atomic<TimerId> nextId;
-        // ID -> Node 的弱引用映射，用于 Cancel
-        std::unordered_map<TimerId, std::weak_ptr<TimerNode>> timerMap;
+        std::mutex wakeMutex;
+        std::condition_variable wakeCv;
+        bool wakeRequested{false};
+        std::atomic<uint64_t> sleepUntil{UINT64_MAX}; // 工作线程计划醒来的 tick，处理中为 UINT64_MAX
     };
 }
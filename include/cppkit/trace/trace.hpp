@@ -0,0 +1,190 @@
+#pragma once
+
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+#include <new>
+#include <string>
+#include <string_view>
+#include <vector>
+
+namespace cppkit::trace
+{
+    // 每个线程环形缓冲区默认可容纳的 span 数，写满后覆盖最旧的记录
+    constexpr size_t DEFAULT_BUFFER_CAPACITY = 8192;
+
+    // W3C Trace Context 中的一个位置：trace-id、当前 span-id 和 trace-flags
+    struct Context
+    {
+        uint64_t traceHigh = 0;
+        uint64_t traceLow = 0;
+        uint64_t spanId = 0;
+        uint8_t flags = 0; // 0x01 表示采样
+
+        [[nodiscard]] bool valid() const { return (traceHigh | traceLow) != 0 && spanId != 0; }
+
+        [[nodiscard]] bool sampled() const { return flags & 0x01; }
+
+        // 生成 traceparent 头的值：00-<trace-id>-<span-id>-<flags>
+        [[nodiscard]] std::string traceparent() const;
+
+        // 解析 traceparent 头，格式不合法时返回无效的 Context
+        static Context fromTraceparent(std::string_view header);
+    };
+
+    // 一条已结束的 span
+    struct SpanRecord
+    {
+        const char* name;
+        Context context;
+        uint64_t parentSpanId; // 0 表示根 span
+        uint64_t startNs; // steady_clock 时间戳
+        uint64_t durationNs;
+        int tid;
+    };
+
+    namespace inner
+    {
+        inline std::atomic<bool> enabled{false};
+
+        inline thread_local Context current{};
+
+        void begin(Context& context, Context& previous, uint64_t& parentId, uint64_t& startNs,
+                   const Context& parent);
+
+        void finish(const char* name, const Context& context, const Context& previous, uint64_t parentId,
+                    uint64_t startNs, uint64_t endNs);
+    }
+
+    // 关闭时所有埋点只剩一次分支判断
+    inline bool enabled() { return inner::enabled.load(std::memory_order_relaxed); }
+
+    void setEnabled(bool on);
+
+    // 之后新建的线程缓冲区的容量（向上取整到 2 的幂）
+    void setBufferCapacity(size_t spans);
+
+    inline uint64_t nowNs()
+    {
+        return static_cast<uint64_t>(std::chrono::duration_cast<std::chrono::nanoseconds>(
+            std::chrono::steady_clock::now().time_since_epoch()).count());
+    }
+
+    // 当前线程的上下文
+    inline const Context& current() { return inner::current; }
+
+    inline void setCurrent(const Context& context) { inner::current = context; }
+
+    // 在作用域内把 context 设为当前上下文，用于把上下文带到其他线程或协程
+    class ContextScope
+    {
+    public:
+        explicit ContextScope(const Context& context) : _previous(inner::current)
+        {
+            inner::current = context;
+        }
+
+        ContextScope(const ContextScope&) = delete;
+
+        ContextScope& operator=(const ContextScope&) = delete;
+
+        ~ContextScope() { inner::current = _previous; }
+
+    private:
+        Context _previous;
+    };
+
+    // 作用域 span：构造时成为当前上下文的子 span，析构时写入本线程的环形缓冲区并恢复上下文。
+    // name 只保存指针，必须是字符串字面量或生命周期更长的字符串
+    class Span
+    {
+    public:
+        // 关闭时只读一次 enabled()、写 _active，其余状态在 start() 中才初始化
+        explicit Span(const char* name) : _name(name)
+        {
+            if (enabled())
+            {
+                start(inner::current, 0);
+            }
+        }
+
+        // 以 parent 为父（如请求头中的远端上下文），startNs 非 0 时作为开始时间
+        Span(const char* name, const Context& parent, const uint64_t startNs = 0) : _name(name)
+        {
+            if (enabled())
+            {
+                start(parent, startNs);
+            }
+        }
+
+        Span(const Span&) = delete;
+
+        Span& operator=(const Span&) = delete;
+
+        ~Span() { end(); }
+
+        // 提前结束，之后的调用无效
+        void end()
+        {
+            if (_active == ACTIVE)
+            {
+                _active = ENDED;
+                inner::finish(_name, _state.context, _state.previous, _state.parentId, _state.startNs, nowNs());
+            }
+        }
+
+        // 本 span 的上下文，未启用时无效
+        [[nodiscard]] const Context& context() const
+        {
+            static constexpr Context none{};
+            return _active == IDLE ? none : _state.context;
+        }
+
+    private:
+        enum : uint8_t
+        {
+            IDLE, // 未启用，_state 未初始化
+            ACTIVE,
+            ENDED
+        };
+
+        struct State
+        {
+            Context context;
+            Context previous;
+            uint64_t parentId;
+            uint64_t startNs;
+        };
+
+        void start(const Context& parent, const uint64_t startNs)
+        {
+            ::new(&_state) State;
+            inner::begin(_state.context, _state.previous, _state.parentId, _state.startNs, parent);
+            if (startNs != 0)
+            {
+                _state.startNs = startNs;
+            }
+            _active = ACTIVE;
+        }
+
+        const char* _name;
+        uint8_t _active = IDLE;
+
+        union
+        {
+            State _state;
+        };
+    };
+
+    // 记录一段已经结束的区间，作为当前上下文的子 span
+    void record(const char* name, uint64_t startNs, uint64_t endNs);
+
+    // 取出所有线程缓冲区中尚未导出的 span
+    std::vector<SpanRecord> collect();
+
+    // 取出所有 span 并生成 Chrome trace-event JSON，可直接用 Perfetto 或 chrome://tracing 打开
+    std::string chromeTraceJson();
+
+    // 同上，写入文件，失败时抛出 std::runtime_error
+    void writeChromeTrace(const std::string& path);
+} // namespace cppkit::trace
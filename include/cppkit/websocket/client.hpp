@@ -1,44 +1,90 @@
 #pragma once
 
 #include "frame.hpp"
+#include "conn.hpp"
+#include "deflate.hpp"
 #include "cppkit/event/server.hpp"
 #include <string>
+#include <string_view>
 #include <vector>
 #include <functional>
+#include <memory>
+#include <netinet/in.h>
 
 namespace cppkit::websocket
 {
+  // 断线重连策略：指数退避，每次实际等待时间在 [delay/2, delay] 之间随机，避免大量连接同时重连
+  struct ReconnectOptions
+  {
+    bool enabled = false;
+
+    int64_t initialDelayMs = 100; // 第一次重连前的等待时间
+
+    int64_t maxDelayMs = 30000; // 等待时间上限
+
+    double multiplier = 2.0; // 每次失败后等待时间的增长倍数
+
+    size_t maxAttempts = 0; // 连续失败次数上限，0 表示不限
+  };
+
   // WebSocket client
+  // 默认构造为阻塞模式：connect 同步完成握手，只能发送
+  // 传入事件循环时为非阻塞模式：connect 立即返回，连接、握手、收发、重连都在事件循环线程中进行，
+  // 所有接口也只能在该线程中调用；多个客户端共享一个事件循环，不需要额外线程
   class WebSocketClient
   {
   public:
     using OnConnectHandler = std::function<void()>;
-    using OnMessageHandler = std::function<void(const std::vector<uint8_t>&)>;
+
+    // 消息负载指向接收缓冲区，只在回调期间有效
+    using OnMessageHandler = std::function<void(std::span<const uint8_t>, MessageType)>;
+
     using OnCloseHandler = std::function<void()>;
     using OnErrorHandler = std::function<void(const std::string&)>;
 
     WebSocketClient() = default;
 
+    explicit WebSocketClient(event::EventLoop* loop);
+
     ~WebSocketClient();
 
     WebSocketClient(WebSocketClient const&) = delete;
 
     WebSocketClient(WebSocketClient&&) = delete;
 
-    // 连接服务器
+    // 连接服务器；非阻塞模式下只表示连接已经发起，结果通过回调通知
     [[nodiscard]]
     bool connect(const std::string& url);
 
-    // 断开连接
+    // 断开连接，不再自动重连
     void disconnect();
 
+    // 握手时提议 permessage-deflate，需在 connect 之前调用
+    void enableDeflate(const DeflateOptions& options = {});
+
+    // 是否协商成功压缩扩展
+    [[nodiscard]]
+    bool deflateNegotiated() const { return _deflate != nullptr; }
+
+    // 非阻塞模式：连接断开（非主动断开）或连接失败后自动重连
+    void setReconnect(const ReconnectOptions& options);
+
+    // 非阻塞模式：输出队列上限与超限策略
+    void setOutboxLimits(const OutboxLimits& limits);
+
+    // 非阻塞模式：TCP 连接加握手的超时时间
+    void setConnectTimeout(int64_t timeoutMs);
+
+    // 非阻塞模式：单条消息的大小上限，超过时以 1009 关闭连接
+    void setMaxMessageSize(size_t size);
+
     // 发送文本消息
     [[nodiscard]]
-    bool send(const std::string& message, MessageType type = MessageType::TEXT) const;
+    bool send(std::string_view message, MessageType type = MessageType::TEXT);
 
-    // 发送二进制消息
+    // 发送二进制消息；非阻塞模式下写不完的部分进入输出队列
     [[nodiscard]]
-    bool send(const std::vector<uint8_t>& message, MessageType type = MessageType::BINARY) const;
+    bool send(std::span<const uint8_t> message, MessageType type = MessageType::BINARY);
 
     // Handlers
     void setOnConnect(OnConnectHandler handler);
@@ -55,13 +101,44 @@ namespace cppkit::websocket
     enum class ClientState
     {
       DISCONNECTED,
-      CONNECTING,
+      CONNECTING, // TCP 连接中
+      HANDSHAKING, // 等待握手响应
       CONNECTED
     };
 
+    // 解析 URL 并解析主机地址
+    bool resolve(const std::string& url);
+
+    // 阻塞模式的连接与握手
+    bool connectBlocking();
+
+    // 构造握手请求
+    [[nodiscard]]
+    std::string handshakeRequest();
+
     // WebSocket 握手处理
     [[nodiscard]]
-    bool handleHandshake(const std::vector<uint8_t>& data) const;
+    bool handleHandshake(const std::vector<uint8_t>& data);
+
+    // 非阻塞模式
+    void startConnect();
+    void onReadable();
+    void onWritable();
+    void onConnected();
+    void handleFrames();
+
+    // 发送掩码后的帧
+    bool sendFrame(std::span<const uint8_t> payload, MessageType type, uint8_t rsv = 0);
+
+    // 关闭 socket 与相关事件
+    void closeSocket();
+
+    // 连接意外断开或失败：通知回调并按策略重连
+    void fail(const std::string& reason, bool wasConnected);
+
+    void scheduleReconnect();
+
+    void cancelTimer(int64_t& id) const;
 
     // Connection info
     std::string _url;
@@ -69,16 +146,34 @@ namespace cppkit::websocket
     std::string _path;
     uint16_t _port = 80;
     bool _ssl = false;
+    sockaddr_in _addr{};
 
     ClientState _state = ClientState::DISCONNECTED;
     int _socketFd = -1;
 
     std::string secWebSocketKey;
 
+    bool _deflateEnabled = false;
+    DeflateOptions _deflateOptions;
+    std::unique_ptr<PerMessageDeflate> _deflate;
+
+    // 非阻塞模式
+    event::EventLoop* _loop = nullptr;
+    MessageReader _reader{false};
+    OutboxLimits _outboxLimits;
+    std::unique_ptr<Outbox> _outbox;
+    ReconnectOptions _reconnect;
+    size_t _attempts = 0; // 连续失败次数
+    int64_t _connectTimeoutMs = 10000;
+    int64_t _timeoutTimer = -1;
+    int64_t _reconnectTimer = -1;
+    uint64_t _generation = 0; // 每次关闭连接加一，回调返回后据此判断连接是否还是原来那个
+    bool _userClosed = false;
+
     // Handlers
     OnConnectHandler _onConnect;
     OnMessageHandler _onMessage;
     OnCloseHandler _onClose;
     OnErrorHandler _onError;
   };
-}
\ No newline at end of file
+}
@@ -1,17 +1,106 @@
 #pragma once
 
 #include "frame.hpp"
+#include "deflate.hpp"
 #include "cppkit/event/server.hpp"
+#include <deque>
+#include <memory>
+#include <string_view>
 
 namespace cppkit::websocket
 {
+  // 已成帧的消息，广播时所有订阅者共享同一份
+  using SharedFrame = std::shared_ptr<const std::vector<uint8_t>>;
+
+  // 只成帧一次，供多个连接共享；compressed 表示负载已经过 permessage-deflate 压缩
+  SharedFrame makeSharedFrame(std::span<const uint8_t> payload, MessageType type = MessageType::BINARY,
+                              bool compressed = false);
+
+  // 慢消费者策略：输出队列超过上限时如何处理
+  enum class SlowConsumerPolicy : uint8_t
+  {
+    DROP_NEWEST, // 丢弃新消息
+
+    DROP_OLDEST, // 丢弃队列中还没开始发送的旧消息，为新消息腾出空间
+
+    DISCONNECT // 断开连接
+  };
+
+  struct OutboxLimits
+  {
+    size_t maxQueuedBytes = 8 * 1024 * 1024; // 每个连接排队等待发送的字节上限
+
+    SlowConsumerPolicy policy = SlowConsumerPolicy::DROP_NEWEST;
+  };
+
+  // 连接的输出队列：队列为空时直接写 socket，写不完的部分排队，等可写事件再用 writev 批量发送
+  // 只能在事件循环线程中使用
+  class Outbox
+  {
+  public:
+    Outbox(event::EventLoop* loop, int fd, const OutboxLimits& limits, event::FileEventCallback onWritable);
+
+    Outbox(const Outbox&) = delete;
+
+    Outbox& operator=(const Outbox&) = delete;
+
+    // 发送帧头 + 负载，只有写不完或需要排队时才拷贝负载；被丢弃或连接已损坏时返回 false
+    bool send(const FrameHeader& header, std::span<const uint8_t> payload);
+
+    // 发送共享帧，排队时只保存引用
+    bool send(const SharedFrame& frame);
+
+    // 可写时调用，尽量发送队列中的数据；写出错时返回 false
+    bool flush();
+
+    // 写出错，或 DISCONNECT 策略下队列超限，需要关闭连接
+    [[nodiscard]]
+    bool broken() const noexcept { return broken_; }
+
+    [[nodiscard]]
+    size_t queuedBytes() const noexcept { return queuedBytes_; }
+
+    // 因队列超限被丢弃的消息数
+    [[nodiscard]]
+    size_t droppedMessages() const noexcept { return dropped_; }
+
+  private:
+    struct Entry
+    {
+      SharedFrame frame;
+
+      size_t offset; // 已发送的字节数，只有队首可能非 0
+    };
+
+    // 按策略检查能否再排队 size 字节
+    bool admit(size_t size);
+
+    void enqueue(SharedFrame frame, size_t offset);
+
+    event::EventLoop* loop_;
+    int fd_;
+    const OutboxLimits& limits_;
+    event::FileEventCallback onWritable_;
+
+    std::deque<Entry> queue_;
+    size_t queuedBytes_ = 0;
+    size_t dropped_ = 0;
+    bool broken_ = false;
+    bool watching_ = false; // 是否已注册可写事件
+  };
+
   // WebSocket 连接信息
   class ConnInfo
   {
     const event::ConnInfo& _connInfo;
 
+    Outbox* _outbox; // 服务端连接的输出队列，为空时直接写 socket
+
+    PerMessageDeflate* _deflate; // 协商了 permessage-deflate 时的压缩状态
+
   public:
-    explicit ConnInfo(const event::ConnInfo& connInfo) : _connInfo(connInfo)
+    explicit ConnInfo(const event::ConnInfo& connInfo, Outbox* outbox = nullptr, PerMessageDeflate* deflate = nullptr)
+      : _connInfo(connInfo), _outbox(outbox), _deflate(deflate)
     {
     }
 
@@ -22,20 +111,29 @@ namespace cppkit::websocket
     // 关闭连接
     void close() const;
 
+    // 先发送关闭帧再关闭连接
+    void close(CloseCode code, std::string_view reason = {}) const;
+
     // 获取底层连接信息
     [[nodiscard]]
     const event::ConnInfo& getRawConnInfo() const;
 
     // 发送文本消息
     [[nodiscard]]
-    ssize_t sendTextMessage(const std::string& message) const;
+    ssize_t sendTextMessage(std::string_view message) const;
 
     // 发送二进制消息
     [[nodiscard]]
-    ssize_t sendBinaryMessage(const std::vector<uint8_t>& message) const;
+    ssize_t sendBinaryMessage(std::span<const uint8_t> message) const;
+
+    // 发送消息（文本或二进制），帧头与负载通过 writev 一起发送，不拷贝负载
+    // 有输出队列时按顺序排队，返回接受的字节数，被丢弃时返回 -1
+    // 协商了压缩时，达到阈值的数据消息先压缩再发送
+    [[nodiscard]]
+    ssize_t sendMessage(std::span<const uint8_t> message, MessageType type = MessageType::BINARY) const;
 
-    // 发送消息（文本或二进制）
+    // 发送预先成帧的共享消息
     [[nodiscard]]
-    ssize_t sendMessage(const std::vector<uint8_t>& message, MessageType type = MessageType::BINARY) const;
+    ssize_t sendFrame(const SharedFrame& frame) const;
   };
-}
\ No newline at end of file
+}
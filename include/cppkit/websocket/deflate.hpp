@@ -0,0 +1,117 @@
+#pragma once
+
+#include <cstdint>
+#include <memory>
+#include <optional>
+#include <span>
+#include <string>
+#include <string_view>
+#include <vector>
+
+namespace cppkit::websocket
+{
+  // permessage-deflate 扩展配置 (RFC 7692)
+  struct DeflateOptions
+  {
+    // 服务端发送的消息每条单独压缩，不沿用上一条的字典
+    // 压缩率稍低，但省去每个连接常驻的压缩窗口，且广播时所有连接可以共享同一份压缩结果
+    bool serverNoContextTakeover = false;
+
+    // 客户端发送的消息每条单独压缩
+    bool clientNoContextTakeover = false;
+
+    // 服务端压缩窗口大小 2^bits，9..15（zlib 不支持 8）
+    int serverMaxWindowBits = 15;
+
+    // 客户端压缩窗口大小 2^bits，8..15；服务端可以借此限制解压窗口占用的内存
+    int clientMaxWindowBits = 15;
+
+    // zlib 压缩级别 1..9
+    int level = 6;
+
+    // zlib 内存级别 1..9，压缩器占用约 2^(windowBits+2) + 2^(memLevel+9) 字节
+    int memLevel = 8;
+
+    // 小于该大小的消息不压缩
+    size_t minSize = 128;
+  };
+
+  // 协商结果
+  struct DeflateParams
+  {
+    bool serverNoContextTakeover = false;
+
+    bool clientNoContextTakeover = false;
+
+    int serverMaxWindowBits = 15;
+
+    int clientMaxWindowBits = 15;
+  };
+
+  // 是否编译了 zlib 支持，没有时不协商该扩展
+  bool deflateAvailable() noexcept;
+
+  // 服务端：从客户端的 Sec-WebSocket-Extensions 中选出第一个可接受的 permessage-deflate 提议
+  // 接受时填充 params 并返回响应头的值
+  std::optional<std::string> negotiateDeflate(std::string_view offers, const DeflateOptions& options,
+                                              DeflateParams& params);
+
+  // 客户端：生成 Sec-WebSocket-Extensions 请求头的值
+  std::string deflateOffer(const DeflateOptions& options);
+
+  // 客户端：校验服务端的响应，与提议不符时返回 false（应断开连接）
+  bool acceptDeflateResponse(std::string_view response, const DeflateOptions& options, DeflateParams& params);
+
+  enum class InflateStatus
+  {
+    OK,
+
+    TOO_BIG, // 解压后超过上限
+
+    CORRUPT // 压缩数据损坏
+  };
+
+  // 一个连接两个方向的压缩状态，zlib 流在第一次使用时才创建
+  class PerMessageDeflate
+  {
+  public:
+    // isServer 决定用协商结果中哪一侧的参数压缩、哪一侧的参数解压
+    PerMessageDeflate(const DeflateParams& params, bool isServer, const DeflateOptions& options);
+
+    ~PerMessageDeflate();
+
+    PerMessageDeflate(const PerMessageDeflate&) = delete;
+
+    PerMessageDeflate& operator=(const PerMessageDeflate&) = delete;
+
+    // 小于阈值的消息原样发送
+    [[nodiscard]]
+    bool shouldCompress(const size_t size) const noexcept { return size >= minSize_; }
+
+    // 压缩一条完整消息，结果覆盖 out，已去掉结尾的 00 00 FF FF
+    void compress(std::span<const uint8_t> in, std::vector<uint8_t>& out);
+
+    // 解压一条完整消息，结果覆盖 out，超过 maxSize 时停止
+    InflateStatus decompress(std::span<const uint8_t> in, std::vector<uint8_t>& out, size_t maxSize);
+
+    // 压缩方向每条消息独立，结果只取决于负载与窗口大小，可以在连接之间共享
+    [[nodiscard]]
+    bool compressesIndependently() const noexcept { return !compressTakeover_; }
+
+    [[nodiscard]]
+    int compressWindowBits() const noexcept { return compressBits_; }
+
+  private:
+    struct Streams;
+
+    std::unique_ptr<Streams> streams_;
+
+    bool compressTakeover_;
+    bool decompressTakeover_;
+    int compressBits_;
+    int decompressBits_;
+    int level_;
+    int memLevel_;
+    size_t minSize_;
+  };
+}
@@ -1,10 +1,8 @@
 #pragma once
 
 #include "cppkit/define.hpp"
-#include "cppkit/random.hpp"
 #include <vector>
 #include <span>
-#include <random>
 #include <cstring>
 #include <stdexcept>
 
@@ -26,11 +24,39 @@ namespace cppkit::websocket
     PONG = 0xA // 心跳响应
   };
 
+  // 关闭帧状态码 (RFC 6455 7.4.1)
+  enum class CloseCode : uint16_t
+  {
+    NORMAL = 1000, // 正常关闭
+
+    GOING_AWAY = 1001, // 服务端下线或页面离开
+
+    PROTOCOL_ERROR = 1002, // 协议错误
+
+    UNSUPPORTED_DATA = 1003, // 不支持的数据类型
+
+    INVALID_PAYLOAD = 1007, // 数据与消息类型不符，例如非法 UTF-8 文本
+
+    POLICY_VIOLATION = 1008, // 违反策略
+
+    MESSAGE_TOO_BIG = 1009, // 消息过大
+
+    INTERNAL_ERROR = 1011 // 服务端内部错误
+  };
+
+  // 最大允许的 payload 大小 (16 MB)
+  constexpr uint64_t MAX_PAYLOAD_SIZE = 16 * 1024 * 1024;
+
+  // 帧头最长 14 字节：2 字节基础头 + 8 字节扩展长度 + 4 字节掩码密钥
+  constexpr size_t MAX_FRAME_HEADER_SIZE = 14;
+
   // WebSocket 帧结构
   struct Frame
   {
     bool fin; // FIN 位
 
+    uint8_t rsv; // RSV1-3 位（高位在前），未协商扩展时必须为 0
+
     MessageType opCode; // 操作码
 
     bool mask; // 掩码标志
@@ -39,181 +65,116 @@ namespace cppkit::websocket
 
     uint8_t maskingKey[4]; // 掩码密钥
 
-    std::vector<uint8_t> payload; // 负载数据
+    // 负载数据：指向被解析缓冲区的视图（已原地去掉掩码），缓冲区被修改前有效
+    std::span<uint8_t> payload;
   };
 
-  // 连接状态枚举
-  enum class ConnState
-  {
-    HAND_SHAKING, // 握手中
+  // 首字节中的 RSV1 位，permessage-deflate 用它标记压缩消息
+  constexpr uint8_t FRAME_RSV1 = 0x40;
 
-    CONNECTED // 已连接
-  };
+  class PerMessageDeflate;
 
-  struct ConnData
+  // 栈上的帧头，与负载一起通过 writev 发送
+  struct FrameHeader
   {
-    ConnState state; // 连接状态
+    uint8_t data[MAX_FRAME_HEADER_SIZE];
 
-    std::vector<uint8_t> buffer; // 数据缓冲区
+    size_t size = 0;
   };
 
-  inline std::vector<uint8_t> buildFrame(const std::vector<uint8_t>& payload,
-      MessageType type,
-      const bool fin = true,
-      const bool mask = false)
-  {
-    std::vector<uint8_t> frame;
-    const uint64_t payloadLength = payload.size();
+  // 构造帧头，maskingKey 为空时不设置 MASK 位
+  FrameHeader makeFrameHeader(uint64_t payloadLength, MessageType type, bool fin = true,
+                              const uint8_t* maskingKey = nullptr) noexcept;
 
-    std::vector<uint8_t> maskedPayload = payload;
+  // 用 4 字节密钥对数据做异或掩码（掩码与去掩码相同），in 与 out 可以是同一块内存
+  void maskPayload(const uint8_t* in, uint8_t* out, size_t size, const uint8_t maskingKey[4]) noexcept;
 
-    uint8_t byte0 = 0;
-    if (fin)
-    {
-      byte0 |= 0x80; // 设置 FIN 位
-    }
-    byte0 |= static_cast<uint8_t>(type) & 0x0F; // 设置 Opcode
-    frame.push_back(byte0);
+  // 生成随机掩码密钥
+  void randomMaskingKey(uint8_t maskingKey[4]) noexcept;
 
-    uint8_t lenByte1 = mask ? 0x80 : 0x00; // 设置 MASK 位
+  // 构造完整的帧（帧头 + 负载），mask 为 true 时使用随机密钥
+  std::vector<uint8_t> buildFrame(std::span<const uint8_t> payload,
+                                  MessageType type,
+                                  bool fin = true,
+                                  bool mask = false);
 
-    if (payloadLength <= 125)
-    {
-      lenByte1 |= static_cast<uint8_t>(payloadLength);
-      frame.push_back(lenByte1);
-    }
-    else if (payloadLength <= 65535)
-    {
-      lenByte1 |= 126;
-      frame.push_back(lenByte1);
+  // 只解析帧头（不含负载），数据不完整时返回 0，否则返回帧头长度；负载超过 MAX_PAYLOAD_SIZE 时抛异常
+  size_t parseFrameHeader(std::span<const uint8_t> data, Frame& frame);
 
-      frame.push_back(static_cast<uint8_t>(payloadLength >> 8 & 0xFF));
-      frame.push_back(static_cast<uint8_t>(payloadLength & 0xFF));
-    }
-    else
+  // 解析一帧，数据不完整时返回 0，否则返回该帧占用的字节数
+  // 负载不做拷贝：原地去掉掩码后由 frame.payload 指向 data 内部
+  size_t parseFrame(std::span<uint8_t> data, Frame& frame);
+
+  // 把连续到达的字节流还原成消息：重组分片、校验控制帧、限制消息大小、校验文本消息的 UTF-8
+  // 服务端与客户端共用，协议错误时停止解析并给出应发送的关闭码
+  class MessageReader
+  {
+  public:
+    struct Message
     {
-      lenByte1 |= 127;
-      frame.push_back(lenByte1);
+      MessageType type; // TEXT / BINARY 或控制帧 CLOSE / PING / PONG
 
-      for (int i = 7; i >= 0; --i)
-      {
-        frame.push_back(static_cast<uint8_t>(payloadLength >> (i * 8) & 0xFF));
-      }
-    }
+      // 指向读取器内部缓冲区，下一次调用 next() 或 append() 前有效
+      std::span<const uint8_t> payload;
+    };
 
-    // 处理掩码
-    if (mask)
+    // requireMask：服务端要求收到的帧带掩码，客户端要求不带
+    explicit MessageReader(bool requireMask, size_t maxMessageSize = MAX_PAYLOAD_SIZE)
+      : requireMask_(requireMask), maxMessageSize_(maxMessageSize)
     {
-      std::vector<uint8_t> maskingKey(4);
-
-      for (size_t i = 0; i < 4; ++i)
-      {
-        maskingKey[i] = static_cast<uint8_t>(Random::nextInt(0, 255));
-      }
+    }
 
-      frame.insert(frame.end(), maskingKey.begin(), maskingKey.end());
+    // 追加收到的数据，顺便回收已经解析过的空间
+    void append(std::span<const uint8_t> data);
 
-      for (size_t i = 0; i < maskedPayload.size(); ++i)
-      {
-        maskedPayload[i] ^= maskingKey[i % 4];
-      }
+    // 尚未解析的数据
+    [[nodiscard]]
+    std::span<const uint8_t> pending() const noexcept
+    {
+      return {buffer_.data() + readPos_, buffer_.size() - readPos_};
     }
 
-    frame.insert(frame.end(), maskedPayload.begin(), maskedPayload.end());
-    return frame;
-  }
+    // 丢弃前 n 字节未解析的数据（例如握手请求头）
+    void discard(size_t n) noexcept;
 
-  inline size_t parseFrame(std::span<const uint8_t> data, Frame& frame)
-  {
-    // 最大允许的 payload 大小 (16 MB)
-    constexpr uint64_t MAX_PAYLOAD_SIZE = 16 * 1024 * 1024;
+    // 取出下一条完整消息；数据不足或出错时返回 false
+    bool next(Message& message);
 
-    if (data.size() < 2)
-    {
-      return 0;
-    }
+    // 是否遇到协议错误，出错后不再解析
+    [[nodiscard]]
+    bool failed() const noexcept { return failed_; }
 
-    size_t offset = 0;
+    // 出错时应发送的关闭码
+    [[nodiscard]]
+    CloseCode error() const noexcept { return error_; }
 
-    // Parse FIN and Opcode
-    frame.fin = (data[offset] & 0x80) != 0;
-    frame.opCode = static_cast<MessageType>(data[offset] & 0x0F);
-    offset++;
+    void setMaxMessageSize(const size_t size) noexcept { maxMessageSize_ = size; }
 
-    // Parse Mask and Payload Length
-    frame.mask = (data[offset] & 0x80) != 0;
-    uint8_t payloadLenByte = data[offset] & 0x7F;
-    offset++;
+    // 协商了 permessage-deflate 后设置：允许数据消息带 RSV1，并在交付前解压
+    void setDeflate(PerMessageDeflate* deflate) noexcept { deflate_ = deflate; }
 
-    if (payloadLenByte <= 125)
-    {
-      frame.payloadLength = payloadLenByte;
-    }
-    else if (payloadLenByte == 126)
-    {
-      if (data.size() < offset + 2)
-      {
-        return 0;
-      }
-      frame.payloadLength = (static_cast<uint16_t>(data[offset]) << 8) | static_cast<uint16_t>(data[offset + 1]);
-      offset += 2;
-    }
-    else
-    {
-      // 127
-      if (data.size() < offset + 8)
-      {
-        return 0;
-      }
-      frame.payloadLength = 0;
-      for (int i = 0; i < 8; ++i)
-      {
-        frame.payloadLength = frame.payloadLength << 8 | static_cast<uint64_t>(data[offset + i]);
-      }
-      offset += 8;
-    }
+    [[nodiscard]]
+    size_t maxMessageSize() const noexcept { return maxMessageSize_; }
 
-    // 安全检查：防止内存耗尽攻击
-    if (frame.payloadLength > MAX_PAYLOAD_SIZE)
-    {
-      throw std::runtime_error("WebSocket payload too large: " + std::to_string(frame.payloadLength) +
-                               " bytes (max: " + std::to_string(MAX_PAYLOAD_SIZE) + " bytes)");
-    }
+  private:
+    bool fail(CloseCode code) noexcept;
 
-    // Parse Masking Key
-    if (frame.mask)
-    {
-      if (data.size() < offset + 4)
-      {
-        return 0;
-      }
-      std::memcpy(frame.maskingKey, &data[offset], 4);
-      offset += 4;
-    }
+    bool requireMask_;
+    size_t maxMessageSize_;
 
-    // Check if payload is available
-    if (data.size() < offset + frame.payloadLength)
-    {
-      return 0;
-    }
+    std::vector<uint8_t> buffer_; // 输入缓冲区，readPos_ 之前的数据已解析
+    size_t readPos_ = 0;
 
-    // Parse Payload
-    frame.payload.resize(frame.payloadLength);
-    if (frame.payloadLength > 0)
-    {
-      std::memcpy(frame.payload.data(), &data[offset], frame.payloadLength);
-
-      // Unmask payload if needed
-      if (frame.mask)
-      {
-        for (uint64_t i = 0; i < frame.payloadLength; ++i)
-        {
-          frame.payload[i] ^= frame.maskingKey[i % 4];
-        }
-      }
-    }
+    std::vector<uint8_t> fragments_; // 分片消息重组缓冲区
+    MessageType fragmentType_ = MessageType::BINARY;
+    bool fragmented_ = false; // 正在接收分片消息
+    bool fragmentsDelivered_ = false; // 重组结果已交付，下次调用 next() 时清空
+    bool fragmentCompressed_ = false; // 分片消息的第一帧带 RSV1
 
-    // 返回解析的总字节数：offset + payloadLength
-    return offset + static_cast<size_t>(frame.payloadLength);
-  }
-} // namespace cppkit::websocket
\ No newline at end of file
+    PerMessageDeflate* deflate_ = nullptr;
+    std::vector<uint8_t> inflated_; // 解压结果
+
+    bool failed_ = false;
+    CloseCode error_ = CloseCode::NORMAL;
+  };
+} // namespace cppkit::websocket
@@ -4,8 +4,10 @@
 #include "conn.hpp"
 #include "cppkit/event/server.hpp"
 #include "cppkit/http/server/http_request.hpp"
+#include "cppkit/http/server/http_server.hpp"
 #include "cppkit/http/http_client.hpp"
 #include <string>
+#include <string_view>
 #include <vector>
 #include <functional>
 #include <unordered_map>
@@ -13,7 +15,41 @@
 
 namespace cppkit::websocket
 {
+  // 连接状态枚举
+  enum class ConnState
+  {
+    HAND_SHAKING, // 握手中
+
+    CONNECTED // 已连接
+  };
+
+  struct ConnData
+  {
+    ConnData(const event::ConnInfo& raw, event::EventLoop* loop, const size_t maxMessageSize,
+             const OutboxLimits& limits, event::FileEventCallback onWritable)
+      : raw(raw), reader(true, maxMessageSize), outbox(loop, raw.getFd(), limits, std::move(onWritable))
+    {
+    }
+
+    event::ConnInfo raw; // 底层连接信息，连接关闭前有效
+
+    ConnState state = ConnState::HAND_SHAKING; // 连接状态
+
+    MessageReader reader; // 输入缓冲区与消息重组
+
+    Outbox outbox; // 输出队列
+
+    std::unique_ptr<PerMessageDeflate> deflate; // 协商了 permessage-deflate 时的压缩状态
+
+    std::vector<std::string> topics; // 已订阅的主题
+
+    bool dispatching = false; // 正在处理该连接的数据
+
+    bool closed = false; // 处理过程中连接被关闭，处理结束后再释放
+  };
+
   // WebSocket 服务器
+  // 可以独立监听端口（start），也可以挂到 HttpServer 的升级路由上与 HTTP 共用端口和事件循环（attach）
   class WebSocketServer
   {
   public:
@@ -24,7 +60,8 @@ namespace cppkit::websocket
     // Handlers
     using OnConnectHandler = std::function<void(const http::server::HttpRequest&, const ConnInfo&)>;
 
-    using OnMessageHandler = std::function<void(const ConnInfo&, const std::vector<uint8_t>&, MessageType)>;
+    // 消息负载指向连接缓冲区，只在回调期间有效
+    using OnMessageHandler = std::function<void(const ConnInfo&, std::span<const uint8_t>, MessageType)>;
 
     using OnCloseHandler = std::function<void(const ConnInfo&)>;
 
@@ -34,7 +71,38 @@ namespace cppkit::websocket
 
     void setOnClose(OnCloseHandler handler);
 
-    bool send(const std::string& clientId, const std::vector<uint8_t>& message, MessageType type = MessageType::BINARY);
+    // 单条消息（分片重组后）的大小上限，超过时以 1009 关闭连接
+    void setMaxMessageSize(size_t size);
+
+    // 启用 permessage-deflate，只影响之后握手的连接
+    void enableDeflate(const DeflateOptions& options = {});
+
+    // 每个连接输出队列的上限与慢消费者策略，对所有连接生效
+    void setOutboxLimits(const OutboxLimits& limits);
+
+    // 以下发送与订阅接口只能在事件循环线程中调用（例如在回调里）
+
+    // 经输出队列发送给单个连接，被丢弃时返回 false；DISCONNECT 策略下超限的连接会被关闭
+    bool send(const ConnInfo& conn, std::span<const uint8_t> message, MessageType type = MessageType::BINARY);
+
+    // 订阅主题，重复订阅无效果；连接关闭时自动退订
+    void subscribe(const ConnInfo& conn, const std::string& topic);
+
+    void unsubscribe(const ConnInfo& conn, const std::string& topic);
+
+    // 发布到主题：只成帧一次，所有订阅者共享同一份数据；返回成功交付（发送或排队）的连接数
+    size_t publish(const std::string& topic, std::span<const uint8_t> message,
+                   MessageType type = MessageType::BINARY);
+
+    // 发送给所有已完成握手的连接
+    size_t broadcast(std::span<const uint8_t> message, MessageType type = MessageType::BINARY);
+
+    [[nodiscard]]
+    size_t subscriberCount(const std::string& topic) const;
+
+    // 挂到 HttpServer 的 path 上：握手请求由 HttpServer 解析一次后交过来，之后由它的事件循环驱动；
+    // 需在 HttpServer::start 之前调用，挂上后不再调用 start/stop
+    void attach(http::server::HttpServer& server, const std::string& path);
 
     void start();
 
@@ -47,17 +115,49 @@ namespace cppkit::websocket
     ~WebSocketServer();
 
   private:
-    // 处理握手请求
-    static bool handleHandshake(const event::ConnInfo& connInfo, const std::vector<uint8_t>& data);
+    // 一次发布中按需生成的共享帧
+    struct Fanout;
+
+    // 处理握手请求，顺便协商扩展
+    bool handleHandshake(const event::ConnInfo& connInfo, const http::server::HttpRequest& request,
+                         ConnData& conn) const;
+
+    // 握手成功后切换为已连接并通知回调，连接被关闭时返回 false
+    bool upgrade(const event::ConnInfo& connInfo, ConnData& conn, const http::server::HttpRequest& request);
+
+    // 处理 HttpServer 交过来的升级请求
+    void onHttpUpgrade(const event::ConnInfo& connInfo, const http::server::HttpRequest& request,
+                       std::span<const uint8_t> leftover);
 
     // TCP 事件处理
     void onTcpConnect(const event::ConnInfo& connInfo);
     void onTcpMessage(const event::ConnInfo& connInfo, const std::vector<uint8_t>& data);
+    void onTcpClose(const event::ConnInfo& connInfo);
+    void onTcpWritable(int fd);
+
+    // 处理一次读到的数据，连接在回调中被关闭时立即返回
+    void handleData(const event::ConnInfo& connInfo, ConnData& conn, const std::vector<uint8_t>& data);
+
+    // 处理缓冲区中完整的消息
+    void handleMessages(ConnData& conn);
 
-    event::EventLoop _loop; // Event loop
+    // 按 fd 查找连接状态
+    ConnData* findConn(int fd) const;
+
+    // 把消息交给一个连接，连接损坏时记下 fd 稍后关闭
+    static bool deliver(ConnData& conn, Fanout& fanout, std::vector<int>& broken);
+
+    // 关闭发送时损坏或超限的连接
+    void closeBroken(const std::vector<int>& broken);
+
+    event::EventLoop _ownLoop; // 独立运行时的事件循环
+
+    event::EventLoop* _loop = &_ownLoop; // 实际使用的事件循环，attach 后指向 HttpServer 的
 
     event::TcpServer _tcpServer; // Underlying TCP server
 
+    bool _attached = false; // 是否挂在 HttpServer 上
+
     std::string _host;
     uint16_t _port;
 
@@ -66,7 +166,17 @@ namespace cppkit::websocket
     OnMessageHandler _onMessage;
     OnCloseHandler _onClose;
 
-    // Connection states
-    std::unordered_map<std::string, ConnData> _connStates;
+    size_t _maxMessageSize = MAX_PAYLOAD_SIZE;
+
+    OutboxLimits _outboxLimits;
+
+    bool _deflateEnabled = false;
+    DeflateOptions _deflateOptions;
+
+    // Connection states，按 fd 索引
+    std::vector<std::unique_ptr<ConnData>> _conns;
+
+    // 主题 -> 订阅者 fd
+    std::unordered_map<std::string, std::vector<int>> _topics;
   };
 }
\ No newline at end of file
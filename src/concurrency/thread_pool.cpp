@@ -14,7 +14,7 @@ namespace cppkit::concurrency
                 {
                     for (;;)
                     {
-                        std::function<void()> task;
+                        QueuedTask task;
                         {
                             std::unique_lock<std::mutex> lock(this->mtx);
                             this->cv.wait(
@@ -24,8 +24,19 @@ namespace cppkit::concurrency
                                 return;
                             task = std::move(this->tasks.front());
                             this->tasks.pop();
+                            CK_GAUGE_ADD("cppkit_thread_pool_queue_depth", "Tasks waiting in thread pool queues", -1);
                         }
-                        task();
+                        CK_COUNTER_INC("cppkit_thread_pool_tasks_total", "Tasks run by thread pools");
+                        if (task.enqueuedNs == 0)
+                        {
+                            task.fn();
+                            continue;
+                        }
+                        // 在提交者的上下文中记录排队时间和执行时间
+                        trace::ContextScope scope(task.context);
+                        trace::record("thread_pool.queue", task.enqueuedNs, trace::nowNs());
+                        trace::Span span("thread_pool.task");
+                        task.fn();
                     }
                 });
         }
@@ -64,6 +75,8 @@ namespace cppkit::concurrency
         stop.store(true, std::memory_order_release);
         {
             std::lock_guard lock(mtx);
+            CK_GAUGE_ADD("cppkit_thread_pool_queue_depth", "Tasks waiting in thread pool queues",
+                         -static_cast<int64_t>(tasks.size()));
             while (!tasks.empty())
                 tasks.pop();
         }
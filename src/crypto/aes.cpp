@@ -1 +1,665 @@
-#include "cppkit/crypto/aes.hpp"
\ No newline at end of file
+#include "cppkit/crypto/aes.hpp"
+#include <atomic>
+#include <stdexcept>
+
+#if defined(__x86_64__) || defined(__i386__)
+#include <cpuid.h>
+#include <immintrin.h>
+#define CPPKIT_AES_X86 1
+#endif
+
+namespace cppkit::crypto
+{
+  static uint32_t loadBe32(const uint8_t* p)
+  {
+    return (static_cast<uint32_t>(p[0]) << 24) | (static_cast<uint32_t>(p[1]) << 16) |
+        (static_cast<uint32_t>(p[2]) << 8) | p[3];
+  }
+
+  static void storeBe32(uint8_t* p, const uint32_t v)
+  {
+    p[0] = static_cast<uint8_t>(v >> 24);
+    p[1] = static_cast<uint8_t>(v >> 16);
+    p[2] = static_cast<uint8_t>(v >> 8);
+    p[3] = static_cast<uint8_t>(v);
+  }
+
+  static uint64_t loadBe64(const uint8_t* p)
+  {
+    return (static_cast<uint64_t>(loadBe32(p)) << 32) | loadBe32(p + 4);
+  }
+
+  static void storeBe64(uint8_t* p, const uint64_t v)
+  {
+    storeBe32(p, static_cast<uint32_t>(v >> 32));
+    storeBe32(p + 4, static_cast<uint32_t>(v));
+  }
+
+  // 计数器加 n：inc32 时只在低 32 位内回绕，否则向高位进位
+  static void addCounter(uint8_t counter[16], const bool inc32, const uint32_t n)
+  {
+    const uint32_t lo = loadBe32(counter + 12);
+    const uint32_t sum = lo + n;
+    storeBe32(counter + 12, sum);
+    if (!inc32 && sum < lo)
+      for (int i = 11; i >= 0 && ++counter[i] == 0; --i)
+      {
+      }
+  }
+
+  static bool detectHardware() noexcept
+  {
+#ifdef CPPKIT_AES_X86
+    unsigned a, b, c, d;
+    if (!__get_cpuid(1, &a, &b, &c, &d))
+      return false;
+    return (c & bit_AES) && (c & bit_PCLMUL) && (c & bit_SSSE3) && (c & bit_SSE4_1);
+#else
+    return false;
+#endif
+  }
+
+  static std::atomic<bool>& hardwareEnabled() noexcept
+  {
+    static std::atomic<bool> enabled{detectHardware()};
+    return enabled;
+  }
+
+  bool Aes::hardwareAccelerated() noexcept { return hardwareEnabled().load(std::memory_order_relaxed); }
+
+  bool Aes::setHardwareAccelerated(const bool enabled) noexcept
+  {
+    if (enabled && !detectHardware())
+      return false;
+    hardwareEnabled().store(enabled, std::memory_order_relaxed);
+    return true;
+  }
+
+  // T 表：Te[i][x] 为 S 盒与 MixColumns 一列的合并结果，依次循环右移 8 位
+  struct TeTables
+  {
+    uint32_t te[4][256];
+  };
+
+  static const TeTables& teTables()
+  {
+    static const TeTables tables = []
+    {
+      TeTables t{};
+      for (int x = 0; x < 256; ++x)
+      {
+        const uint32_t s = sbox[x];
+        const uint32_t s2 = xtime(static_cast<uint8_t>(s));
+        const uint32_t s3 = s2 ^ s;
+        const uint32_t w = (s2 << 24) | (s << 16) | (s << 8) | s3;
+        t.te[0][x] = w;
+        t.te[1][x] = (w >> 8) | (w << 24);
+        t.te[2][x] = (w >> 16) | (w << 16);
+        t.te[3][x] = (w >> 24) | (w << 8);
+      }
+      return t;
+    }();
+    return tables;
+  }
+
+  static void encryptBlockTable(const uint32_t* rk, const int rounds, const uint8_t in[16], uint8_t out[16])
+  {
+    const auto& T = teTables().te;
+    uint32_t s0 = loadBe32(in) ^ rk[0];
+    uint32_t s1 = loadBe32(in + 4) ^ rk[1];
+    uint32_t s2 = loadBe32(in + 8) ^ rk[2];
+    uint32_t s3 = loadBe32(in + 12) ^ rk[3];
+    for (int r = 1; r < rounds; ++r)
+    {
+      rk += 4;
+      const uint32_t t0 = T[0][s0 >> 24] ^ T[1][(s1 >> 16) & 0xFF] ^ T[2][(s2 >> 8) & 0xFF] ^ T[3][s3 & 0xFF] ^ rk[0];
+      const uint32_t t1 = T[0][s1 >> 24] ^ T[1][(s2 >> 16) & 0xFF] ^ T[2][(s3 >> 8) & 0xFF] ^ T[3][s0 & 0xFF] ^ rk[1];
+      const uint32_t t2 = T[0][s2 >> 24] ^ T[1][(s3 >> 16) & 0xFF] ^ T[2][(s0 >> 8) & 0xFF] ^ T[3][s1 & 0xFF] ^ rk[2];
+      const uint32_t t3 = T[0][s3 >> 24] ^ T[1][(s0 >> 16) & 0xFF] ^ T[2][(s1 >> 8) & 0xFF] ^ T[3][s2 & 0xFF] ^ rk[3];
+      s0 = t0;
+      s1 = t1;
+      s2 = t2;
+      s3 = t3;
+    }
+    rk += 4;
+    auto last = [](const uint32_t a, const uint32_t b, const uint32_t c, const uint32_t d)
+    {
+      return (static_cast<uint32_t>(sbox[a >> 24]) << 24) | (static_cast<uint32_t>(sbox[(b >> 16) & 0xFF]) << 16) |
+          (static_cast<uint32_t>(sbox[(c >> 8) & 0xFF]) << 8) | sbox[d & 0xFF];
+    };
+    storeBe32(out, last(s0, s1, s2, s3) ^ rk[0]);
+    storeBe32(out + 4, last(s1, s2, s3, s0) ^ rk[1]);
+    storeBe32(out + 8, last(s2, s3, s0, s1) ^ rk[2]);
+    storeBe32(out + 12, last(s3, s0, s1, s2) ^ rk[3]);
+  }
+
+#ifdef CPPKIT_AES_X86
+  // 同时加密 N 个块，交错发射以隐藏 aesenc 的延迟
+  template <int N>
+  __attribute__((target("aes,sse4.1"), always_inline)) inline void aesRounds(__m128i (&x)[N], const __m128i* k,
+                                                                            const int rounds)
+  {
+    for (int i = 0; i < N; ++i)
+      x[i] = _mm_xor_si128(x[i], k[0]);
+    for (int r = 1; r < rounds; ++r)
+      for (int i = 0; i < N; ++i)
+        x[i] = _mm_aesenc_si128(x[i], k[r]);
+    for (int i = 0; i < N; ++i)
+      x[i] = _mm_aesenclast_si128(x[i], k[rounds]);
+  }
+
+  __attribute__((target("aes,sse4.1"))) static void encryptBlocksNi(const uint8_t* roundKeys, const int rounds,
+                                                                   const uint8_t* in, uint8_t* out, size_t blocks)
+  {
+    __m128i k[15];
+    for (int r = 0; r <= rounds; ++r)
+      k[r] = _mm_load_si128(reinterpret_cast<const __m128i*>(roundKeys + r * 16));
+    for (; blocks >= 8; blocks -= 8, in += 128, out += 128)
+    {
+      __m128i x[8];
+      for (int i = 0; i < 8; ++i)
+        x[i] = _mm_loadu_si128(reinterpret_cast<const __m128i*>(in + i * 16));
+      aesRounds(x, k, rounds);
+      for (int i = 0; i < 8; ++i)
+        _mm_storeu_si128(reinterpret_cast<__m128i*>(out + i * 16), x[i]);
+    }
+    for (; blocks > 0; --blocks, in += 16, out += 16)
+    {
+      __m128i x[1] = {_mm_loadu_si128(reinterpret_cast<const __m128i*>(in))};
+      aesRounds(x, k, rounds);
+      _mm_storeu_si128(reinterpret_cast<__m128i*>(out), x[0]);
+    }
+  }
+
+  __attribute__((target("aes,sse4.1"))) static void ctrNi(const uint8_t* roundKeys, const int rounds,
+                                                         uint8_t counter[16], const bool inc32, const uint8_t* in,
+                                                         uint8_t* out, size_t blocks)
+  {
+    __m128i k[15];
+    for (int r = 0; r <= rounds; ++r)
+      k[r] = _mm_load_si128(reinterpret_cast<const __m128i*>(roundKeys + r * 16));
+    for (; blocks >= 8; blocks -= 8, in += 128, out += 128)
+    {
+      __m128i x[8];
+      const uint32_t c32 = loadBe32(counter + 12);
+      if (c32 <= 0xFFFFFFFFu - 7)
+      {
+        // 8 个计数器只在低 32 位不同：直接替换最后一个双字
+        const __m128i base = _mm_loadu_si128(reinterpret_cast<const __m128i*>(counter));
+        for (int i = 0; i < 8; ++i)
+          x[i] = _mm_insert_epi32(base, static_cast<int>(__builtin_bswap32(c32 + i)), 3);
+        addCounter(counter, inc32, 8);
+      }
+      else
+      {
+        for (auto& v : x)
+        {
+          v = _mm_loadu_si128(reinterpret_cast<const __m128i*>(counter));
+          addCounter(counter, inc32, 1);
+        }
+      }
+      aesRounds(x, k, rounds);
+      for (int i = 0; i < 8; ++i)
+      {
+        const __m128i p = _mm_loadu_si128(reinterpret_cast<const __m128i*>(in + i * 16));
+        _mm_storeu_si128(reinterpret_cast<__m128i*>(out + i * 16), _mm_xor_si128(p, x[i]));
+      }
+    }
+    for (; blocks > 0; --blocks, in += 16, out += 16)
+    {
+      __m128i x[1] = {_mm_loadu_si128(reinterpret_cast<const __m128i*>(counter))};
+      addCounter(counter, inc32, 1);
+      aesRounds(x, k, rounds);
+      const __m128i p = _mm_loadu_si128(reinterpret_cast<const __m128i*>(in));
+      _mm_storeu_si128(reinterpret_cast<__m128i*>(out), _mm_xor_si128(p, x[0]));
+    }
+  }
+
+  // GHASH 使用字节反序的表示（Intel GCM 白皮书的做法）：先做不约简的无进位乘法，累加后统一约简
+  __attribute__((target("pclmul,sse4.1"), always_inline)) inline void clmulAcc(
+      const __m128i a, const __m128i b, __m128i& lo, __m128i& mid, __m128i& hi)
+  {
+    lo = _mm_xor_si128(lo, _mm_clmulepi64_si128(a, b, 0x00));
+    hi = _mm_xor_si128(hi, _mm_clmulepi64_si128(a, b, 0x11));
+    mid = _mm_xor_si128(mid, _mm_xor_si128(_mm_clmulepi64_si128(a, b, 0x10), _mm_clmulepi64_si128(a, b, 0x01)));
+  }
+
+  __attribute__((target("pclmul,sse4.1"), always_inline)) inline __m128i gfReduce(__m128i lo, __m128i mid,
+                                                                                 __m128i hi)
+  {
+    lo = _mm_xor_si128(lo, _mm_slli_si128(mid, 8));
+    hi = _mm_xor_si128(hi, _mm_srli_si128(mid, 8));
+
+    // 256 位乘积整体左移一位
+    __m128i t7 = _mm_srli_epi32(lo, 31);
+    __m128i t8 = _mm_srli_epi32(hi, 31);
+    lo = _mm_slli_epi32(lo, 1);
+    hi = _mm_slli_epi32(hi, 1);
+    const __m128i t9 = _mm_srli_si128(t7, 12);
+    t8 = _mm_slli_si128(t8, 4);
+    t7 = _mm_slli_si128(t7, 4);
+    lo = _mm_or_si128(lo, t7);
+    hi = _mm_or_si128(_mm_or_si128(hi, t8), t9);
+
+    // 模 x^128 + x^7 + x^2 + x + 1 约简
+    t7 = _mm_xor_si128(_mm_xor_si128(_mm_slli_epi32(lo, 31), _mm_slli_epi32(lo, 30)), _mm_slli_epi32(lo, 25));
+    t8 = _mm_srli_si128(t7, 4);
+    lo = _mm_xor_si128(lo, _mm_slli_si128(t7, 12));
+    __m128i t2 = _mm_xor_si128(_mm_xor_si128(_mm_srli_epi32(lo, 1), _mm_srli_epi32(lo, 2)), _mm_srli_epi32(lo, 7));
+    t2 = _mm_xor_si128(t2, t8);
+    lo = _mm_xor_si128(lo, t2);
+    return _mm_xor_si128(hi, lo);
+  }
+
+  __attribute__((target("pclmul,sse4.1"), always_inline)) inline __m128i gfMul(const __m128i a, const __m128i b)
+  {
+    __m128i lo = _mm_setzero_si128(), mid = _mm_setzero_si128(), hi = _mm_setzero_si128();
+    clmulAcc(a, b, lo, mid, hi);
+    return gfReduce(lo, mid, hi);
+  }
+
+  __attribute__((target("pclmul,sse4.1"), always_inline)) inline __m128i byteSwap(const __m128i v)
+  {
+    return _mm_shuffle_epi8(v, _mm_set_epi8(0, 1, 2, 3, 4, 5, 6, 7, 8, 9, 10, 11, 12, 13, 14, 15));
+  }
+
+  __attribute__((target("pclmul,sse4.1"))) static void ghashPowersNi(const uint8_t h[16], uint8_t powers[8][16])
+  {
+    const __m128i h1 = byteSwap(_mm_loadu_si128(reinterpret_cast<const __m128i*>(h)));
+    __m128i p = h1;
+    for (int i = 0; i < 8; ++i)
+    {
+      _mm_store_si128(reinterpret_cast<__m128i*>(powers[i]), p);
+      p = gfMul(p, h1);
+    }
+  }
+
+  __attribute__((target("pclmul,sse4.1"))) static void ghashNi(const uint8_t powers[8][16], uint8_t state[16],
+                                                              const uint8_t* data, size_t blocks)
+  {
+    __m128i h[8];
+    for (int i = 0; i < 8; ++i)
+      h[i] = _mm_load_si128(reinterpret_cast<const __m128i*>(powers[i]));
+    __m128i x = byteSwap(_mm_loadu_si128(reinterpret_cast<const __m128i*>(state)));
+
+    // 8 块聚合：X' = (X ^ B0)·H^8 ^ B1·H^7 ^ ... ^ B7·H
+    for (; blocks >= 8; blocks -= 8, data += 128)
+    {
+      __m128i lo = _mm_setzero_si128(), mid = _mm_setzero_si128(), hi = _mm_setzero_si128();
+      for (int i = 0; i < 8; ++i)
+      {
+        __m128i b = byteSwap(_mm_loadu_si128(reinterpret_cast<const __m128i*>(data + i * 16)));
+        if (i == 0)
+          b = _mm_xor_si128(b, x);
+        clmulAcc(b, h[7 - i], lo, mid, hi);
+      }
+      x = gfReduce(lo, mid, hi);
+    }
+    for (; blocks > 0; --blocks, data += 16)
+    {
+      const __m128i b = byteSwap(_mm_loadu_si128(reinterpret_cast<const __m128i*>(data)));
+      x = gfMul(_mm_xor_si128(x, b), h[0]);
+    }
+    _mm_storeu_si128(reinterpret_cast<__m128i*>(state), byteSwap(x));
+  }
+#endif
+
+  // 标量 GHASH：4 位查表（Shoup），每次处理半个字节，last4 为移出 4 位后的约简值
+  static constexpr uint64_t kLast4[16] = {0x0000, 0x1c20, 0x3840, 0x2460, 0x7080, 0x6ca0, 0x48c0, 0x54e0,
+                                          0xe100, 0xfd20, 0xd940, 0xc560, 0x9180, 0x8da0, 0xa9c0, 0xb5e0};
+
+  static void ghashTable(const uint64_t h, const uint64_t l, uint64_t hh[16], uint64_t hl[16])
+  {
+    uint64_t vh = h, vl = l;
+    hh[0] = hl[0] = 0;
+    hh[8] = vh;
+    hl[8] = vl;
+    for (int i = 4; i > 0; i >>= 1)
+    {
+      const uint64_t t = (vl & 1) * 0xE1000000ULL;
+      vl = (vh << 63) | (vl >> 1);
+      vh = (vh >> 1) ^ (t << 32);
+      hh[i] = vh;
+      hl[i] = vl;
+    }
+    for (int i = 2; i <= 8; i *= 2)
+      for (int j = 1; j < i; ++j)
+      {
+        hh[i + j] = hh[i] ^ hh[j];
+        hl[i + j] = hl[i] ^ hl[j];
+      }
+  }
+
+  static void gfMulTable(const uint64_t hh[16], const uint64_t hl[16], uint8_t x[16])
+  {
+    uint64_t zh = hh[x[15] & 0xF], zl = hl[x[15] & 0xF];
+    auto shift4 = [&](const uint8_t nibble)
+    {
+      const uint8_t rem = zl & 0xF;
+      zl = (zh << 60) | (zl >> 4);
+      zh = (zh >> 4) ^ (kLast4[rem] << 48) ^ hh[nibble];
+      zl ^= hl[nibble];
+    };
+    for (int i = 15; i >= 0; --i)
+    {
+      if (i != 15)
+        shift4(x[i] & 0xF);
+      shift4(x[i] >> 4);
+    }
+    storeBe64(x, zh);
+    storeBe64(x + 8, zl);
+  }
+
+  Aes::Aes(const std::span<const uint8_t> key)
+  {
+    const size_t nk = key.size() / 4;
+    if (key.size() != 16 && key.size() != 24 && key.size() != 32)
+      throw std::runtime_error("aes: key must be 16, 24 or 32 bytes");
+    rounds_ = static_cast<int>(nk) + 6;
+    hardware_ = hardwareAccelerated();
+
+    // FIPS-197 密钥扩展，AES-NI 与 T 表共用同一份轮密钥
+    const size_t total = 4 * (rounds_ + 1);
+    for (size_t i = 0; i < nk; ++i)
+      roundWords_[i] = loadBe32(key.data() + i * 4);
+    for (size_t i = nk; i < total; ++i)
+    {
+      uint32_t temp = roundWords_[i - 1];
+      auto subWord = [](const uint32_t w)
+      {
+        return (static_cast<uint32_t>(sbox[w >> 24]) << 24) | (static_cast<uint32_t>(sbox[(w >> 16) & 0xFF]) << 16) |
+            (static_cast<uint32_t>(sbox[(w >> 8) & 0xFF]) << 8) | sbox[w & 0xFF];
+      };
+      if (i % nk == 0)
+        temp = subWord((temp << 8) | (temp >> 24)) ^ (static_cast<uint32_t>(Rcon[i / nk]) << 24);
+      else if (nk > 6 && i % nk == 4)
+        temp = subWord(temp);
+      roundWords_[i] = roundWords_[i - nk] ^ temp;
+    }
+    for (size_t i = 0; i < total; ++i)
+      storeBe32(roundKeys_ + i * 4, roundWords_[i]);
+  }
+
+  void Aes::encryptBlock(const uint8_t in[16], uint8_t out[16]) const
+  {
+    encryptBlocks(in, out, 1);
+  }
+
+  void Aes::encryptBlocks(const uint8_t* in, uint8_t* out, size_t blocks) const
+  {
+#ifdef CPPKIT_AES_X86
+    if (hardware_)
+      return encryptBlocksNi(roundKeys_, rounds_, in, out, blocks);
+#endif
+    for (; blocks > 0; --blocks, in += 16, out += 16)
+      encryptBlockTable(roundWords_, rounds_, in, out);
+  }
+
+  void Aes::ctr(uint8_t counter[16], const bool inc32, const uint8_t* in, uint8_t* out, size_t blocks) const
+  {
+#ifdef CPPKIT_AES_X86
+    if (hardware_)
+      return ctrNi(roundKeys_, rounds_, counter, inc32, in, out, blocks);
+#endif
+    uint8_t ks[16];
+    for (; blocks > 0; --blocks, in += 16, out += 16)
+    {
+      encryptBlockTable(roundWords_, rounds_, counter, ks);
+      addCounter(counter, inc32, 1);
+      for (int i = 0; i < 16; ++i)
+        out[i] = in[i] ^ ks[i];
+    }
+  }
+
+  static constexpr uint8_t kZeroBlock[16] = {};
+
+  AesCtr::AesCtr(const std::span<const uint8_t> key, const std::span<const uint8_t, 16> iv)
+      : aes_(key)
+  {
+    std::memcpy(counter_, iv.data(), 16);
+  }
+
+  void AesCtr::update(const std::span<uint8_t> data)
+  {
+    update(data, data);
+  }
+
+  void AesCtr::update(const std::span<const uint8_t> in, const std::span<uint8_t> out)
+  {
+    if (out.size() < in.size())
+      throw std::runtime_error("aes-ctr: output span is smaller than input");
+    const uint8_t* src = in.data();
+    uint8_t* dst = out.data();
+    size_t n = in.size();
+    while (n > 0 && used_ < 16)
+    {
+      *dst++ = *src++ ^ keystream_[used_++];
+      --n;
+    }
+    if (const size_t blocks = n / 16; blocks > 0)
+    {
+      aes_.ctr(counter_, false, src, dst, blocks);
+      src += blocks * 16;
+      dst += blocks * 16;
+      n -= blocks * 16;
+    }
+    if (n > 0)
+    {
+      aes_.ctr(counter_, false, kZeroBlock, keystream_, 1);
+      for (used_ = 0; used_ < n; ++used_)
+        dst[used_] = src[used_] ^ keystream_[used_];
+    }
+  }
+
+  AesGcm::AesGcm(const std::span<const uint8_t> key)
+      : aes_(key)
+  {
+    uint8_t h[16];
+    aes_.encryptBlock(kZeroBlock, h);
+    ghashTable(loadBe64(h), loadBe64(h + 8), hh_, hl_);
+#ifdef CPPKIT_AES_X86
+    if (aes_.hardware_)
+      ghashPowersNi(h, hPowers_);
+#endif
+  }
+
+  void AesGcm::ghash(const uint8_t* data, size_t blocks)
+  {
+#ifdef CPPKIT_AES_X86
+    if (aes_.hardware_)
+      return ghashNi(hPowers_, x_, data, blocks);
+#endif
+    for (; blocks > 0; --blocks, data += 16)
+    {
+      for (int i = 0; i < 16; ++i)
+        x_[i] ^= data[i];
+      gfMulTable(hh_, hl_, x_);
+    }
+  }
+
+  void AesGcm::flushGhash()
+  {
+    if (partialLen_ == 0)
+      return;
+    std::memset(partial_ + partialLen_, 0, 16 - partialLen_);
+    ghash(partial_, 1);
+    partialLen_ = 0;
+  }
+
+  void AesGcm::start(const std::span<const uint8_t> iv)
+  {
+    if (iv.empty())
+      throw std::runtime_error("aes-gcm: empty iv");
+    std::memset(x_, 0, sizeof(x_));
+    partialLen_ = 0;
+    aadLen_ = 0;
+    textLen_ = 0;
+    used_ = 16;
+
+    if (iv.size() == 12)
+    {
+      std::memcpy(j0_, iv.data(), 12);
+      storeBe32(j0_ + 12, 1);
+    }
+    else
+    {
+      // J0 = GHASH(IV || 0* || [len(IV)]64)
+      const size_t full = iv.size() / 16;
+      ghash(iv.data(), full);
+      if (const size_t rest = iv.size() - full * 16; rest > 0)
+      {
+        uint8_t block[16] = {};
+        std::memcpy(block, iv.data() + full * 16, rest);
+        ghash(block, 1);
+      }
+      uint8_t lenBlock[16] = {};
+      storeBe64(lenBlock + 8, static_cast<uint64_t>(iv.size()) * 8);
+      ghash(lenBlock, 1);
+      std::memcpy(j0_, x_, 16);
+      std::memset(x_, 0, sizeof(x_));
+    }
+    std::memcpy(counter_, j0_, 16);
+    addCounter(counter_, true, 1);
+    stage_ = Stage::Aad;
+  }
+
+  void AesGcm::aad(const std::span<const uint8_t> data)
+  {
+    if (stage_ != Stage::Aad)
+      throw std::runtime_error("aes-gcm: aad must be passed after start() and before any data");
+    aadLen_ += data.size();
+    const uint8_t* p = data.data();
+    size_t n = data.size();
+    if (partialLen_ > 0)
+    {
+      const size_t take = std::min(n, 16 - partialLen_);
+      std::memcpy(partial_ + partialLen_, p, take);
+      partialLen_ += take;
+      p += take;
+      n -= take;
+      if (partialLen_ < 16)
+        return;
+      ghash(partial_, 1);
+      partialLen_ = 0;
+    }
+    const size_t blocks = n / 16;
+    ghash(p, blocks);
+    std::memcpy(partial_, p + blocks * 16, n - blocks * 16);
+    partialLen_ = n - blocks * 16;
+  }
+
+  void AesGcm::encrypt(const std::span<uint8_t> data)
+  {
+    crypt(data, true);
+  }
+
+  void AesGcm::decrypt(const std::span<uint8_t> data)
+  {
+    crypt(data, false);
+  }
+
+  void AesGcm::crypt(const std::span<uint8_t> data, const bool encrypting)
+  {
+    if (stage_ == Stage::Idle)
+      throw std::runtime_error("aes-gcm: start() must be called first");
+    if (stage_ == Stage::Aad)
+    {
+      flushGhash();
+      stage_ = Stage::Text;
+    }
+    // SP 800-38D 限制单条消息不超过 2^39 - 256 位
+    if (textLen_ + data.size() > (uint64_t{1} << 36) - 32)
+      throw std::runtime_error("aes-gcm: message too long");
+    textLen_ += data.size();
+
+    uint8_t* p = data.data();
+    size_t n = data.size();
+    // 密文需要进入 GHASH：加密时先异或再吸收，解密时先吸收再异或
+    auto crossByte = [&](uint8_t& b)
+    {
+      if (encrypting)
+        b ^= keystream_[used_++];
+      partial_[partialLen_++] = b;
+      if (!encrypting)
+        b ^= keystream_[used_++];
+      if (partialLen_ == 16)
+      {
+        ghash(partial_, 1);
+        partialLen_ = 0;
+      }
+    };
+    for (; n > 0 && used_ < 16; --n)
+      crossByte(*p++);
+
+    // 按 L1 友好的分段把 CTR 与 GHASH 交替进行
+    constexpr size_t kChunkBlocks = 256;
+    for (size_t blocks = n / 16; blocks > 0;)
+    {
+      const size_t step = std::min(blocks, kChunkBlocks);
+      if (!encrypting)
+        ghash(p, step);
+      aes_.ctr(counter_, true, p, p, step);
+      if (encrypting)
+        ghash(p, step);
+      p += step * 16;
+      n -= step * 16;
+      blocks -= step;
+    }
+
+    if (n > 0)
+    {
+      aes_.ctr(counter_, true, kZeroBlock, keystream_, 1);
+      used_ = 0;
+      for (; n > 0; --n)
+        crossByte(*p++);
+    }
+  }
+
+  std::array<uint8_t, AesGcm::kTagSize> AesGcm::finish()
+  {
+    if (stage_ == Stage::Idle)
+      throw std::runtime_error("aes-gcm: start() must be called first");
+    flushGhash();
+    uint8_t lenBlock[16];
+    storeBe64(lenBlock, aadLen_ * 8);
+    storeBe64(lenBlock + 8, textLen_ * 8);
+    ghash(lenBlock, 1);
+
+    std::array<uint8_t, kTagSize> tag{};
+    aes_.encryptBlock(j0_, tag.data());
+    for (size_t i = 0; i < kTagSize; ++i)
+      tag[i] ^= x_[i];
+    stage_ = Stage::Idle;
+    return tag;
+  }
+
+  bool AesGcm::verify(const std::span<const uint8_t> tag)
+  {
+    const auto expected = finish();
+    if (tag.size() < 12 || tag.size() > kTagSize)
+      return false;
+    uint8_t diff = 0;
+    for (size_t i = 0; i < tag.size(); ++i)
+      diff |= expected[i] ^ tag[i];
+    return diff == 0;
+  }
+
+  std::array<uint8_t, AesGcm::kTagSize> AesGcm::seal(const std::span<const uint8_t> iv,
+                                                      const std::span<const uint8_t> aad,
+                                                      const std::span<uint8_t> data)
+  {
+    start(iv);
+    this->aad(aad);
+    encrypt(data);
+    return finish();
+  }
+
+  bool AesGcm::open(const std::span<const uint8_t> iv, const std::span<const uint8_t> aad,
+                    const std::span<uint8_t> data, const std::span<const uint8_t> tag)
+  {
+    start(iv);
+    this->aad(aad);
+    decrypt(data);
+    return verify(tag);
+  }
+} // namespace cppkit::crypto
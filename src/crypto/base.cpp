@@ -1,101 +1,442 @@
 #include "cppkit/crypto/base.hpp"
 
+#include <atomic>
+
+#if defined(__x86_64__) || defined(__i386__)
+#include <cpuid.h>
+#include <immintrin.h>
+#endif
+
 namespace cppkit::crypto
 {
-  static constexpr char b64_table[] =
-      "ABCDEFGHIJKLMNOPQRSTUVWXYZabcdefghijklmnopqrstuvwxyz0123456789+/";
-
-  static constexpr int b64_index[256] = {
-      -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1,
-      -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1,
-      -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, 62, -1, -1, -1, 63,
-      52, 53, 54, 55, 56, 57, 58, 59, 60, 61, -1, -1, -1, -1, -1, -1,
-      -1, 0, 1, 2, 3, 4, 5, 6, 7, 8, 9, 10, 11, 12, 13, 14,
-      15, 16, 17, 18, 19, 20, 21, 22, 23, 24, 25, -1, -1, -1, -1, -1,
-      -1, 26, 27, 28, 29, 30, 31, 32, 33, 34, 35, 36, 37, 38, 39, 40,
-      41, 42, 43, 44, 45, 46, 47, 48, 49, 50, 51
+  struct B64Alphabet
+  {
+    char chars[64];
+    int8_t index[256]; // 非法字符为 -1
   };
 
-  std::string Base64::encode(const std::vector<uint8_t>& data)
+  static constexpr B64Alphabet makeAlphabet(const char c62, const char c63)
+  {
+    constexpr char base[] = "ABCDEFGHIJKLMNOPQRSTUVWXYZabcdefghijklmnopqrstuvwxyz0123456789";
+    B64Alphabet alphabet{};
+    for (int i = 0; i < 62; ++i)
+      alphabet.chars[i] = base[i];
+    alphabet.chars[62] = c62;
+    alphabet.chars[63] = c63;
+    for (auto& v : alphabet.index)
+      v = -1;
+    for (int i = 0; i < 64; ++i)
+      alphabet.index[static_cast<unsigned char>(alphabet.chars[i])] = static_cast<int8_t>(i);
+    return alphabet;
+  }
+
+  static constexpr B64Alphabet b64_standard = makeAlphabet('+', '/');
+  static constexpr B64Alphabet b64_url = makeAlphabet('-', '_');
+
+  static const B64Alphabet& alphabetOf(const Base64Alphabet alphabet) noexcept
+  {
+    return alphabet == Base64Alphabet::Url ? b64_url : b64_standard;
+  }
+
+  static bool isSpace(const char c) noexcept
+  {
+    return c == ' ' || c == '\t' || c == '\r' || c == '\n';
+  }
+
+#if defined(__x86_64__) || defined(__i386__)
+  // 向量化算法参考 W. Muła / D. Lemire, "Faster Base64 Encoding and Decoding using AVX2 Instructions"
+  // 编码：每 3 字节重排到一个 32 位字里，再用乘法把 4 个 6 位索引移到各自字节的低位
+  __attribute__((target("ssse3"))) static __m128i encodeIndices(const __m128i in)
+  {
+    const __m128i v = _mm_shuffle_epi8(in, _mm_set_epi8(10, 11, 9, 10, 7, 8, 6, 7, 4, 5, 3, 4, 1, 2, 0, 1));
+    const __m128i t0 = _mm_mulhi_epu16(_mm_and_si128(v, _mm_set1_epi32(0x0fc0fc00)), _mm_set1_epi32(0x04000040));
+    const __m128i t1 = _mm_mullo_epi16(_mm_and_si128(v, _mm_set1_epi32(0x003f03f0)), _mm_set1_epi32(0x01000010));
+    return _mm_or_si128(t0, t1);
+  }
+
+  // 索引 -> 字符：按区间 (A-Z / a-z / 0-9 / 62 / 63) 算出查表下标，查出需要加上的偏移
+  __attribute__((target("ssse3"))) static __m128i encodeLookup(const __m128i indices, const __m128i shiftLut)
+  {
+    __m128i lut = _mm_subs_epu8(indices, _mm_set1_epi8(51));
+    lut = _mm_or_si128(lut, _mm_and_si128(_mm_cmpgt_epi8(_mm_set1_epi8(26), indices), _mm_set1_epi8(13)));
+    return _mm_add_epi8(indices, _mm_shuffle_epi8(shiftLut, lut));
+  }
+
+  __attribute__((target("ssse3"))) static __m128i encodeShiftLut(const char c62, const char c63)
+  {
+    constexpr char digit = '0' - 52;
+    return _mm_setr_epi8('a' - 26, digit, digit, digit, digit, digit, digit, digit, digit, digit, digit,
+                         static_cast<char>(c62 - 62), static_cast<char>(c63 - 63), 'A', 0, 0);
+  }
+
+  // 返回已处理的字节数（3 的倍数）
+  __attribute__((target("ssse3")))
+  static size_t encodeSsse3(const uint8_t* in, const size_t n, char* out, const B64Alphabet& alphabet)
+  {
+    const __m128i shiftLut = encodeShiftLut(alphabet.chars[62], alphabet.chars[63]);
+    size_t i = 0;
+    // 每次读 16 字节只用前 12 字节，不能越过输入末尾
+    for (; i + 16 <= n; i += 12, out += 16)
+    {
+      const __m128i in16 = _mm_loadu_si128(reinterpret_cast<const __m128i*>(in + i));
+      _mm_storeu_si128(reinterpret_cast<__m128i*>(out), encodeLookup(encodeIndices(in16), shiftLut));
+    }
+    return i;
+  }
+
+  __attribute__((target("avx2")))
+  static size_t encodeAvx2(const uint8_t* in, const size_t n, char* out, const B64Alphabet& alphabet)
+  {
+    const __m256i shuffle = _mm256_broadcastsi128_si256(
+        _mm_set_epi8(10, 11, 9, 10, 7, 8, 6, 7, 4, 5, 3, 4, 1, 2, 0, 1));
+    const __m256i shiftLut = _mm256_broadcastsi128_si256(encodeShiftLut(alphabet.chars[62], alphabet.chars[63]));
+    size_t i = 0;
+    for (; i + 28 <= n; i += 24, out += 32)
+    {
+      // 两个 128 位通道各取 12 字节
+      const __m128i lo = _mm_loadu_si128(reinterpret_cast<const __m128i*>(in + i));
+      const __m128i hi = _mm_loadu_si128(reinterpret_cast<const __m128i*>(in + i + 12));
+      const __m256i v = _mm256_shuffle_epi8(_mm256_inserti128_si256(_mm256_castsi128_si256(lo), hi, 1), shuffle);
+      const __m256i t0 = _mm256_mulhi_epu16(_mm256_and_si256(v, _mm256_set1_epi32(0x0fc0fc00)),
+                                            _mm256_set1_epi32(0x04000040));
+      const __m256i t1 = _mm256_mullo_epi16(_mm256_and_si256(v, _mm256_set1_epi32(0x003f03f0)),
+                                            _mm256_set1_epi32(0x01000010));
+      const __m256i indices = _mm256_or_si256(t0, t1);
+      __m256i lut = _mm256_subs_epu8(indices, _mm256_set1_epi8(51));
+      lut = _mm256_or_si256(lut, _mm256_and_si256(_mm256_cmpgt_epi8(_mm256_set1_epi8(26), indices),
+                                                  _mm256_set1_epi8(13)));
+      const __m256i chars = _mm256_add_epi8(indices, _mm256_shuffle_epi8(shiftLut, lut));
+      _mm256_storeu_si256(reinterpret_cast<__m256i*>(out), chars);
+    }
+    return i;
+  }
+
+  // 解码：按字符区间算出每个字节要加的偏移，任一字节不在字母表内则整块交给标量路径
+  // 返回已处理的字符数（16 的倍数），遇到非法字符、空白或 '=' 时提前停下
+  __attribute__((target("ssse3")))
+  static size_t decodeSsse3(const char* in, const size_t n, uint8_t* out, const size_t cap,
+                            const B64Alphabet& alphabet)
   {
-    std::string out;
-    out.reserve(((data.size() + 2) / 3) * 4);
+    const char c62 = alphabet.chars[62];
+    const char c63 = alphabet.chars[63];
+    size_t i = 0;
+    // 每块写 16 字节（有效 12 字节）
+    for (size_t o = 0; i + 16 <= n && o + 16 <= cap; i += 16, o += 12)
+    {
+      const __m128i v = _mm_loadu_si128(reinterpret_cast<const __m128i*>(in + i));
+      const __m128i upper = _mm_and_si128(_mm_cmpgt_epi8(v, _mm_set1_epi8('A' - 1)),
+                                          _mm_cmpgt_epi8(_mm_set1_epi8('Z' + 1), v));
+      const __m128i lower = _mm_and_si128(_mm_cmpgt_epi8(v, _mm_set1_epi8('a' - 1)),
+                                          _mm_cmpgt_epi8(_mm_set1_epi8('z' + 1), v));
+      const __m128i digit = _mm_and_si128(_mm_cmpgt_epi8(v, _mm_set1_epi8('0' - 1)),
+                                          _mm_cmpgt_epi8(_mm_set1_epi8('9' + 1), v));
+      const __m128i is62 = _mm_cmpeq_epi8(v, _mm_set1_epi8(c62));
+      const __m128i is63 = _mm_cmpeq_epi8(v, _mm_set1_epi8(c63));
+      const __m128i valid = _mm_or_si128(_mm_or_si128(upper, lower), _mm_or_si128(digit, _mm_or_si128(is62, is63)));
+      if (_mm_movemask_epi8(valid) != 0xFFFF)
+        break;
+      __m128i shift = _mm_and_si128(upper, _mm_set1_epi8(-'A'));
+      shift = _mm_or_si128(shift, _mm_and_si128(lower, _mm_set1_epi8(26 - 'a')));
+      shift = _mm_or_si128(shift, _mm_and_si128(digit, _mm_set1_epi8(52 - '0')));
+      shift = _mm_or_si128(shift, _mm_and_si128(is62, _mm_set1_epi8(static_cast<char>(62 - c62))));
+      shift = _mm_or_si128(shift, _mm_and_si128(is63, _mm_set1_epi8(static_cast<char>(63 - c63))));
+      // 4 个 6 位值合并成 24 位，再按大端取出 3 字节
+      __m128i s = _mm_maddubs_epi16(_mm_add_epi8(v, shift), _mm_set1_epi32(0x01400140));
+      s = _mm_madd_epi16(s, _mm_set1_epi32(0x00011000));
+      s = _mm_shuffle_epi8(s, _mm_setr_epi8(2, 1, 0, 6, 5, 4, 10, 9, 8, 14, 13, 12, -1, -1, -1, -1));
+      _mm_storeu_si128(reinterpret_cast<__m128i*>(out + o), s);
+    }
+    return i;
+  }
 
+  __attribute__((target("avx2")))
+  static size_t decodeAvx2(const char* in, const size_t n, uint8_t* out, const size_t cap,
+                           const B64Alphabet& alphabet)
+  {
+    const char c62 = alphabet.chars[62];
+    const char c63 = alphabet.chars[63];
     size_t i = 0;
-    while (i + 3 <= data.size())
+    // 每块写 32 字节（有效 24 字节）
+    for (size_t o = 0; i + 32 <= n && o + 32 <= cap; i += 32, o += 24)
     {
-      const uint32_t n = (data[i] << 16) | (data[i + 1] << 8) | data[i + 2];
-      out.push_back(b64_table[(n >> 18) & 63]);
-      out.push_back(b64_table[(n >> 12) & 63]);
-      out.push_back(b64_table[(n >> 6) & 63]);
-      out.push_back(b64_table[n & 63]);
-      i += 3;
+      const __m256i v = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(in + i));
+      const __m256i upper = _mm256_and_si256(_mm256_cmpgt_epi8(v, _mm256_set1_epi8('A' - 1)),
+                                             _mm256_cmpgt_epi8(_mm256_set1_epi8('Z' + 1), v));
+      const __m256i lower = _mm256_and_si256(_mm256_cmpgt_epi8(v, _mm256_set1_epi8('a' - 1)),
+                                             _mm256_cmpgt_epi8(_mm256_set1_epi8('z' + 1), v));
+      const __m256i digit = _mm256_and_si256(_mm256_cmpgt_epi8(v, _mm256_set1_epi8('0' - 1)),
+                                             _mm256_cmpgt_epi8(_mm256_set1_epi8('9' + 1), v));
+      const __m256i is62 = _mm256_cmpeq_epi8(v, _mm256_set1_epi8(c62));
+      const __m256i is63 = _mm256_cmpeq_epi8(v, _mm256_set1_epi8(c63));
+      const __m256i valid = _mm256_or_si256(_mm256_or_si256(upper, lower),
+                                            _mm256_or_si256(digit, _mm256_or_si256(is62, is63)));
+      if (_mm256_movemask_epi8(valid) != -1)
+        break;
+      __m256i shift = _mm256_and_si256(upper, _mm256_set1_epi8(-'A'));
+      shift = _mm256_or_si256(shift, _mm256_and_si256(lower, _mm256_set1_epi8(26 - 'a')));
+      shift = _mm256_or_si256(shift, _mm256_and_si256(digit, _mm256_set1_epi8(52 - '0')));
+      shift = _mm256_or_si256(shift, _mm256_and_si256(is62, _mm256_set1_epi8(static_cast<char>(62 - c62))));
+      shift = _mm256_or_si256(shift, _mm256_and_si256(is63, _mm256_set1_epi8(static_cast<char>(63 - c63))));
+      __m256i s = _mm256_maddubs_epi16(_mm256_add_epi8(v, shift), _mm256_set1_epi32(0x01400140));
+      s = _mm256_madd_epi16(s, _mm256_set1_epi32(0x00011000));
+      s = _mm256_shuffle_epi8(s, _mm256_broadcastsi128_si256(
+                                  _mm_setr_epi8(2, 1, 0, 6, 5, 4, 10, 9, 8, 14, 13, 12, -1, -1, -1, -1)));
+      // 两个通道各 12 字节，拼到低 24 字节
+      s = _mm256_permutevar8x32_epi32(s, _mm256_setr_epi32(0, 1, 2, 4, 5, 6, 7, 7));
+      _mm256_storeu_si256(reinterpret_cast<__m256i*>(out + o), s);
     }
+    return i;
+  }
+
+  struct B64CpuFeatures
+  {
+    bool ssse3 = false;
+    bool avx2 = false;
+  };
 
-    // 2. 处理剩余的 1 字节或 2 字节 (填充逻辑)
-    if (const size_t remainder = data.size() - i; remainder == 1)
+  static B64CpuFeatures detectCpu() noexcept
+  {
+    B64CpuFeatures features;
+    unsigned a, b, c, d;
+    if (!__get_cpuid(1, &a, &b, &c, &d))
+      return features;
+    features.ssse3 = c & bit_SSSE3;
+    const bool avx = (c & bit_OSXSAVE) && (c & bit_AVX);
+    if (__get_cpuid_max(0, nullptr) < 7)
+      return features;
+    __cpuid_count(7, 0, a, b, c, d);
+    if (avx && (b & bit_AVX2))
     {
-      // 剩余 1 字节：输出 XX==
-      const uint32_t n = (data[i] << 16);
-      out.push_back(b64_table[(n >> 18) & 63]);
-      out.push_back(b64_table[(n >> 12) & 63]);
-      out.push_back('='); // 填充第三位
-      out.push_back('='); // 填充第四位
+      // 操作系统需要保存 YMM 寄存器状态
+      uint32_t lo, hi;
+      __asm__("xgetbv" : "=a"(lo), "=d"(hi) : "c"(0));
+      features.avx2 = (lo & 0x6) == 0x6;
     }
-    else if (remainder == 2)
+    return features;
+  }
+#endif
+
+  static bool isSupported(const Base64::Backend backend) noexcept
+  {
+#if defined(__x86_64__) || defined(__i386__)
+    static const B64CpuFeatures features = detectCpu();
+    switch (backend)
     {
-      // 剩余 2 字节：输出 XXX=
-      const uint32_t n = (data[i] << 16) | (data[i + 1] << 8);
-      out.push_back(b64_table[(n >> 18) & 63]);
-      out.push_back(b64_table[(n >> 12) & 63]);
-      out.push_back(b64_table[(n >> 6) & 63]);
-      out.push_back('='); // 填充第四位
+    case Base64::Backend::Scalar:
+      return true;
+    case Base64::Backend::Ssse3:
+      return features.ssse3;
+    case Base64::Backend::Avx2:
+      return features.avx2;
     }
-    return out;
+    return false;
+#else
+    return backend == Base64::Backend::Scalar;
+#endif
   }
 
-  std::string Base64::encode(const std::string& data)
+  static Base64::Backend detectBackend() noexcept
   {
-    return encode(std::vector<uint8_t>(data.begin(), data.end()));
+    if (isSupported(Base64::Backend::Avx2))
+      return Base64::Backend::Avx2;
+    if (isSupported(Base64::Backend::Ssse3))
+      return Base64::Backend::Ssse3;
+    return Base64::Backend::Scalar;
   }
 
-  std::vector<uint8_t> Base64::decode(const std::string& input)
+  static std::atomic<Base64::Backend>& currentBackend() noexcept
   {
-    if (input.size() % 4 != 0)
-      throw std::runtime_error("Invalid Base64 input length");
+    static std::atomic<Base64::Backend> backend{detectBackend()};
+    return backend;
+  }
+
+  Base64::Backend Base64::backend() noexcept { return currentBackend().load(std::memory_order_relaxed); }
+
+  bool Base64::setBackend(const Backend backend) noexcept
+  {
+    if (!isSupported(backend))
+      return false;
+    currentBackend().store(backend, std::memory_order_relaxed);
+    return true;
+  }
+
+  const char* Base64::backendName(const Backend backend) noexcept
+  {
+    switch (backend)
+    {
+    case Backend::Scalar:
+      return "scalar";
+    case Backend::Ssse3:
+      return "ssse3";
+    case Backend::Avx2:
+      return "avx2";
+    }
+    return "unknown";
+  }
+
+  // out 的长度已由调用方保证
+  static size_t encodeTo(const uint8_t* in, const size_t n, char* out, const Base64Options& options) noexcept
+  {
+    const B64Alphabet& alphabet = alphabetOf(options.alphabet);
+    size_t i = 0;
+#if defined(__x86_64__) || defined(__i386__)
+    switch (Base64::backend())
+    {
+    case Base64::Backend::Avx2:
+      i = encodeAvx2(in, n, out, alphabet);
+      break;
+    case Base64::Backend::Ssse3:
+      i = encodeSsse3(in, n, out, alphabet);
+      break;
+    case Base64::Backend::Scalar:
+      break;
+    }
+#endif
+    char* p = out + i / 3 * 4;
+    const char* table = alphabet.chars;
+    for (; i + 3 <= n; i += 3, p += 4)
+    {
+      const uint32_t v = (in[i] << 16) | (in[i + 1] << 8) | in[i + 2];
+      p[0] = table[v >> 18];
+      p[1] = table[(v >> 12) & 63];
+      p[2] = table[(v >> 6) & 63];
+      p[3] = table[v & 63];
+    }
 
-    size_t pad = 0;
-    if (!input.empty() && input[input.size() - 1] == '=')
-      pad++;
-    if (input.size() > 1 && input[input.size() - 2] == '=')
-      pad++;
+    // 剩余 1 字节输出 XX==，剩余 2 字节输出 XXX=
+    if (const size_t remainder = n - i; remainder != 0)
+    {
+      const uint32_t v = (in[i] << 16) | (remainder == 2 ? in[i + 1] << 8 : 0);
+      *p++ = table[v >> 18];
+      *p++ = table[(v >> 12) & 63];
+      if (remainder == 2)
+        *p++ = table[(v >> 6) & 63];
+      if (options.padding)
+      {
+        *p++ = '=';
+        if (remainder == 1)
+          *p++ = '=';
+      }
+    }
+    return p - out;
+  }
 
-    std::vector<uint8_t> out;
-    out.reserve(input.size() / 4 * 3 - pad);
+  static std::optional<size_t> decodeTo(const std::string_view input, uint8_t* out, const size_t cap,
+                                        const Base64Options& options) noexcept
+  {
+    const B64Alphabet& alphabet = alphabetOf(options.alphabet);
+    const Base64::Backend backend = Base64::backend();
+    const char* in = input.data();
+    const size_t n = input.size();
+    size_t i = 0;
+    size_t o = 0;
+    size_t simdFrom = 0; // 向量路径停下后，跳过当前块或遇到空白再重试，避免在同一处反复尝试
+    uint32_t acc = 0;
+    int count = 0;
+    int pad = 0;
 
-    for (size_t i = 0; i < input.size(); i += 4)
+    while (i < n)
     {
-      uint32_t n = 0;
-      for (int j = 0; j < 4; ++j)
+#if defined(__x86_64__) || defined(__i386__)
+      if (count == 0 && pad == 0 && i >= simdFrom && backend != Base64::Backend::Scalar)
       {
-        if (input[i + j] == '=')
-          n <<= 6;
-        else
+        const size_t done = backend == Base64::Backend::Avx2
+                              ? decodeAvx2(in + i, n - i, out + o, cap - o, alphabet)
+                              : decodeSsse3(in + i, n - i, out + o, cap - o, alphabet);
+        i += done;
+        o += done / 4 * 3;
+        simdFrom = i + 32;
+        if (i == n)
+          break;
+      }
+#endif
+      const char c = in[i++];
+      if (const int8_t v = alphabet.index[static_cast<unsigned char>(c)]; v >= 0)
+      {
+        if (pad != 0)
+          return std::nullopt;
+        acc = (acc << 6) | static_cast<uint32_t>(v);
+        if (++count == 4)
         {
-          const int val = b64_index[static_cast<unsigned char>(input[i + j])];
-          if (val == -1)
-            throw std::runtime_error("Invalid Base64 character");
-          n = (n << 6) | val;
+          if (cap - o < 3)
+            return std::nullopt;
+          out[o] = static_cast<uint8_t>(acc >> 16);
+          out[o + 1] = static_cast<uint8_t>(acc >> 8);
+          out[o + 2] = static_cast<uint8_t>(acc);
+          o += 3;
+          acc = 0;
+          count = 0;
         }
       }
+      else if (c == '=')
+      {
+        // '=' 只能出现在 2 或 3 个有效字符之后，补齐到 4 个
+        if (count < 2 || count + ++pad > 4)
+          return std::nullopt;
+      }
+      else if (!options.ignoreWhitespace || !isSpace(c))
+        return std::nullopt;
+      else
+        simdFrom = i; // 换行之后通常就是整行的有效字符
+    }
 
-      out.push_back((n >> 16) & 0xFF);
-      if (input[i + 2] != '=')
-        out.push_back((n >> 8) & 0xFF);
-      if (input[i + 3] != '=')
-        out.push_back(n & 0xFF);
+    if (pad != 0 ? count + pad != 4 : count == 1 || (count != 0 && options.padding))
+      return std::nullopt;
+    if (count >= 2)
+    {
+      const size_t tail = count - 1;
+      if (cap - o < tail)
+        return std::nullopt;
+      acc <<= 6 * (4 - count);
+      out[o++] = static_cast<uint8_t>(acc >> 16);
+      if (tail == 2)
+        out[o++] = static_cast<uint8_t>(acc >> 8);
     }
+    return o;
+  }
+
+  std::string Base64::encode(const std::span<const uint8_t> data, const Base64Options& options)
+  {
+    std::string out(encodedLength(data.size(), options.padding), '\0');
+    encodeTo(data.data(), data.size(), out.data(), options);
+    return out;
+  }
+
+  std::string Base64::encode(const std::string_view data, const Base64Options& options)
+  {
+    return encode(std::span(reinterpret_cast<const uint8_t*>(data.data()), data.size()), options);
+  }
+
+  size_t Base64::encode(const std::span<const uint8_t> data, const std::span<char> out, const Base64Options& options)
+  {
+    if (out.size() < encodedLength(data.size(), options.padding))
+      throw std::runtime_error("Base64 output buffer too small");
+    return encodeTo(data.data(), data.size(), out.data(), options);
+  }
 
+  std::vector<uint8_t> Base64::decode(const std::string_view input, const Base64Options& options)
+  {
+    std::vector<uint8_t> out(decodedMaxLength(input.size()));
+    const auto size = decodeTo(input, out.data(), out.size(), options);
+    if (!size)
+      throw std::runtime_error("Invalid Base64 input");
+    out.resize(*size);
     return out;
   }
-} // namespace cppkit::crypto
\ No newline at end of file
+
+  size_t Base64::decode(const std::string_view input, const std::span<uint8_t> out, const Base64Options& options)
+  {
+    const auto size = decodeTo(input, out.data(), out.size(), options);
+    if (!size)
+      throw std::runtime_error(out.size() < decodedMaxLength(input.size())
+                                 ? "Invalid Base64 input or output buffer too small"
+                                 : "Invalid Base64 input");
+    return *size;
+  }
+
+  std::optional<size_t> Base64::tryDecode(const std::string_view input, const std::span<uint8_t> out,
+                                          const Base64Options& options) noexcept
+  {
+    return decodeTo(input, out.data(), out.size(), options);
+  }
+} // namespace cppkit::crypto
@@ -74,11 +74,6 @@ namespace cppkit::crypto
     std::memcpy(&buffer_[i], &data[offset], len - offset);
   }
 
-  void MD5::update(const std::string& data)
-  {
-    update(reinterpret_cast<const uint8_t*>(data.data()), data.size());
-  }
-
   void MD5::finalize()
   {
     if (finalized_)
@@ -160,27 +155,28 @@ namespace cppkit::crypto
 
   std::string MD5::hexDigest()
   {
-    const auto d = digest();
-    std::ostringstream oss;
-    for (const auto b : d)
-      oss << std::hex << std::setw(2) << std::setfill('0') << static_cast<int>(b);
-    return oss.str();
+    return hexEncode(digest());
   }
 
   std::string MD5::base64Digest()
   {
-    auto d = digest();
-    return Base64::encode(std::vector(d.begin(), d.end()));
+    const auto d = digest();
+    return Base64::encode(d);
+  }
+
+  std::string MD5::hash(const std::string_view data)
+  {
+    return hexEncode(hashBinary(data));
   }
 
-  std::string MD5::hash(const std::string& data)
+  std::array<uint8_t, 16> MD5::hashBinary(const std::string_view data)
   {
     MD5 ctx;
     ctx.update(data);
-    return ctx.hexDigest();
+    return ctx.digest();
   }
 
-  std::string MD5::hashBase64(const std::string& data)
+  std::string MD5::hashBase64(const std::string_view data)
   {
     MD5 ctx;
     ctx.update(data);
@@ -1,30 +1,181 @@
 #include "cppkit/crypto/sha1.hpp"
+#include "cppkit/crypto/hmac.hpp"
+#include <atomic>
+#include <utility>
 #include <vector>
 
+#if defined(__x86_64__) || defined(__i386__)
+#include <immintrin.h>
+#endif
+
 namespace cppkit::crypto
 {
+  static uint32_t leftRotate(const uint32_t x, const uint32_t n)
+  {
+    return (x << n) | (x >> (32 - n));
+  }
+
+  static void compressScalar(uint32_t state[5], const uint8_t* data, size_t blocks)
+  {
+    for (; blocks > 0; --blocks, data += 64)
+    {
+      uint32_t w[80];
+      for (int i = 0; i < 16; ++i)
+        w[i] = (data[i * 4] << 24) | (data[i * 4 + 1] << 16) | (data[i * 4 + 2] << 8) | data[i * 4 + 3];
+      for (int i = 16; i < 80; ++i)
+        w[i] = leftRotate(w[i - 3] ^ w[i - 8] ^ w[i - 14] ^ w[i - 16], 1);
+
+      uint32_t a = state[0], b = state[1], c = state[2], d = state[3], e = state[4];
+
+      for (int i = 0; i < 80; ++i)
+      {
+        uint32_t f, k;
+        if (i < 20)
+        {
+          f = (b & c) | ((~b) & d);
+          k = 0x5A827999;
+        }
+        else if (i < 40)
+        {
+          f = b ^ c ^ d;
+          k = 0x6ED9EBA1;
+        }
+        else if (i < 60)
+        {
+          f = (b & c) | (b & d) | (c & d);
+          k = 0x8F1BBCDC;
+        }
+        else
+        {
+          f = b ^ c ^ d;
+          k = 0xCA62C1D6;
+        }
+
+        const uint32_t temp = leftRotate(a, 5) + f + e + k + w[i];
+        e = d;
+        d = c;
+        c = leftRotate(b, 30);
+        b = a;
+        a = temp;
+      }
+
+      state[0] += a;
+      state[1] += b;
+      state[2] += c;
+      state[3] += d;
+      state[4] += e;
+    }
+  }
+
+#if defined(__x86_64__) || defined(__i386__)
+#define CPPKIT_SHA_X86 1
+  // 每 4 轮一组，G 为组号；E 值在 e0/e1 之间交替，msg[G % 4] 为当前组的消息字
+  template <int G>
+  __attribute__((target("sha,sse4.1"), always_inline)) inline void shaNiGroup(
+      __m128i& abcd, __m128i& e0, __m128i& e1, __m128i (&msg)[4], const uint8_t* data, const __m128i& bswap)
+  {
+    __m128i& cur = msg[G & 3];
+    if constexpr (G < 4)
+      cur = _mm_shuffle_epi8(_mm_loadu_si128(reinterpret_cast<const __m128i*>(data + G * 16)), bswap);
+    __m128i& in = G % 2 == 0 ? e0 : e1;
+    __m128i& out = G % 2 == 0 ? e1 : e0;
+    if constexpr (G == 0)
+      in = _mm_add_epi32(in, cur);
+    else
+      in = _mm_sha1nexte_epu32(in, cur);
+    out = abcd;
+    if constexpr (G >= 3 && G <= 18)
+      msg[(G + 1) & 3] = _mm_sha1msg2_epu32(msg[(G + 1) & 3], cur);
+    abcd = _mm_sha1rnds4_epu32(abcd, in, G / 5);
+    if constexpr (G >= 1 && G <= 16)
+      msg[(G + 3) & 3] = _mm_sha1msg1_epu32(msg[(G + 3) & 3], cur);
+    if constexpr (G >= 2 && G <= 17)
+      msg[(G + 2) & 3] = _mm_xor_si128(msg[(G + 2) & 3], cur);
+  }
+
+  template <int... G>
+  __attribute__((target("sha,sse4.1"), always_inline)) inline void shaNiRounds(
+      std::integer_sequence<int, G...>, __m128i& abcd, __m128i& e0, const uint8_t* data, const __m128i& bswap)
+  {
+    __m128i msg[4];
+    __m128i e1;
+    (shaNiGroup<G>(abcd, e0, e1, msg, data, bswap), ...);
+  }
+
+  __attribute__((target("sha,sse4.1"))) static void compressShaNi(uint32_t state[5], const uint8_t* data,
+                                                                 size_t blocks)
+  {
+    const __m128i bswap = _mm_set_epi64x(0x0001020304050607ULL, 0x08090a0b0c0d0e0fULL);
+    __m128i abcd = _mm_shuffle_epi32(_mm_loadu_si128(reinterpret_cast<const __m128i*>(state)), 0x1B);
+    __m128i e0 = _mm_set_epi32(static_cast<int>(state[4]), 0, 0, 0);
+
+    for (; blocks > 0; --blocks, data += 64)
+    {
+      const __m128i abcdSave = abcd;
+      const __m128i eSave = e0;
+      shaNiRounds(std::make_integer_sequence<int, 20>(), abcd, e0, data, bswap);
+      e0 = _mm_sha1nexte_epu32(e0, eSave);
+      abcd = _mm_add_epi32(abcd, abcdSave);
+    }
+
+    _mm_storeu_si128(reinterpret_cast<__m128i*>(state), _mm_shuffle_epi32(abcd, 0x1B));
+    state[4] = static_cast<uint32_t>(_mm_extract_epi32(e0, 3));
+  }
+#endif
+
+  static std::atomic<ShaBackend>& currentBackend() noexcept
+  {
+    static std::atomic<ShaBackend> backend{
+        isSupported(ShaBackend::ShaNi) ? ShaBackend::ShaNi : ShaBackend::Scalar};
+    return backend;
+  }
+
+  ShaBackend SHA1::backend() noexcept { return currentBackend().load(std::memory_order_relaxed); }
+
+  bool SHA1::setBackend(const ShaBackend backend) noexcept
+  {
+    if (backend == ShaBackend::Avx2 || !isSupported(backend))
+      return false;
+    currentBackend().store(backend, std::memory_order_relaxed);
+    return true;
+  }
+
+  void SHA1::compress(uint32_t state[5], const uint8_t* data, const size_t blocks)
+  {
+#ifdef CPPKIT_SHA_X86
+    if (backend() == ShaBackend::ShaNi)
+      return compressShaNi(state, data, blocks);
+#endif
+    compressScalar(state, data, blocks);
+  }
+
   void SHA1::update(const uint8_t* data, size_t len)
   {
-    while (len > 0)
+    if (bufferLen_ > 0)
     {
       const size_t toCopy = std::min(len, 64 - bufferLen_);
       std::memcpy(buffer_ + bufferLen_, data, toCopy);
       bufferLen_ += toCopy;
       data += toCopy;
       len -= toCopy;
+      if (bufferLen_ < 64)
+        return;
+      compress(state_, buffer_, 1);
+      totalBits_ += 512;
+      bufferLen_ = 0;
+    }
 
-      if (bufferLen_ == 64)
-      {
-        transform(buffer_);
-        totalBits_ += 512;
-        bufferLen_ = 0;
-      }
+    // 完整的块直接从输入压缩，不经过 buffer_
+    if (const size_t blocks = len / 64; blocks > 0)
+    {
+      compress(state_, data, blocks);
+      totalBits_ += blocks * 512;
+      data += blocks * 64;
+      len -= blocks * 64;
     }
-  }
 
-  void SHA1::update(const std::string& str)
-  {
-    update(reinterpret_cast<const uint8_t*>(str.data()), str.size());
+    std::memcpy(buffer_, data, len);
+    bufferLen_ = len;
   }
 
   std::array<uint8_t, 20> SHA1::digest()
@@ -43,11 +194,7 @@ namespace cppkit::crypto
 
   std::string SHA1::hexDigest()
   {
-    const auto d = digest();
-    std::ostringstream oss;
-    for (const auto b : d)
-      oss << std::hex << std::setw(2) << std::setfill('0') << static_cast<int>(b);
-    return oss.str();
+    return hexEncode(digest());
   }
 
   void SHA1::reset()
@@ -63,52 +210,33 @@ namespace cppkit::crypto
     finalized_ = false;
   }
 
-  std::string SHA1::sha(const std::string& message)
+  std::string SHA1::sha(const std::string_view message)
+  {
+    return hexEncode(shaBinary(message));
+  }
+
+  std::array<uint8_t, 20> SHA1::shaBinary(const std::string_view message)
   {
     SHA1 sha1;
     sha1.update(message);
-    return sha1.hexDigest();
+    return sha1.digest();
   }
 
-  std::array<uint8_t, 20> SHA1::shaBinary(const std::string& message)
+  std::array<uint8_t, 20> SHA1::shaBinary(const std::span<const uint8_t> message)
   {
     SHA1 sha1;
     sha1.update(message);
     return sha1.digest();
   }
 
-  std::string SHA1::hmac(const std::string& key, const std::string& message)
+  std::string SHA1::hmac(const std::string_view key, const std::string_view message)
   {
-    std::vector<uint8_t> keyBytes(key.begin(), key.end());
-    if (constexpr size_t blockSize = 64; keyBytes.size() > blockSize)
-    {
-      SHA1 sha1;
-      sha1.update(key);
-      auto hashedKey = sha1.digest();
-      keyBytes = std::vector<uint8_t>(hashedKey.begin(), hashedKey.end());
-    }
-    constexpr size_t blockSize = 64;
-    keyBytes.resize(blockSize, 0x00);
-    std::vector<uint8_t> oKeyPad(blockSize);
-    std::vector<uint8_t> iKeyPad(blockSize);
-    for (size_t i = 0; i < blockSize; ++i)
-    {
-      oKeyPad[i] = keyBytes[i] ^ 0x5c;
-      iKeyPad[i] = keyBytes[i] ^ 0x36;
-    }
+    return hexEncode(hmacBinary(key, message));
+  }
 
-    SHA1 innerSha1;
-    innerSha1.update(iKeyPad.data(), iKeyPad.size());
-    innerSha1.update(reinterpret_cast<const uint8_t*>(message.data()), message.size());
-    auto innerHash = innerSha1.digest();
-    SHA1 outerSha1;
-    outerSha1.update(oKeyPad.data(), oKeyPad.size());
-    outerSha1.update(innerHash.data(), innerHash.size());
-    auto hmacHash = outerSha1.digest();
-    std::ostringstream oss;
-    for (const auto b : hmacHash)
-      oss << std::hex << std::setw(2) << std::setfill('0') << static_cast<int>(b);
-    return oss.str();
+  std::array<uint8_t, 20> SHA1::hmacBinary(const std::string_view key, const std::string_view message)
+  {
+    return Hmac<SHA1>(key).mac(message);
   }
 
   void SHA1::finalize()
@@ -125,7 +253,7 @@ namespace cppkit::crypto
     // 如果剩余空间不足8字节存放长度，则处理当前块并创建一个新的全零块
     if (bufferLen_ > 56) {
         std::memset(buffer_ + bufferLen_, 0, 64 - bufferLen_);
-        transform(buffer_);
+        compress(state_, buffer_, 1);
         std::memset(buffer_, 0, sizeof(buffer_));
         bufferLen_ = 0;
     }
@@ -144,62 +272,8 @@ namespace cppkit::crypto
     buffer_[63] = bitLength & 0xFF;
 
     // 处理最后一个块
-    transform(buffer_);
+    compress(state_, buffer_, 1);
 
     finalized_ = true;
   }
-
-  void SHA1::transform(const uint8_t block[64])
-  {
-    uint32_t w[80];
-    for (int i = 0; i < 16; ++i)
-      w[i] = (block[i * 4] << 24) | (block[i * 4 + 1] << 16) | (block[i * 4 + 2] << 8) | block[i * 4 + 3];
-    for (int i = 16; i < 80; ++i)
-      w[i] = leftRotate(w[i - 3] ^ w[i - 8] ^ w[i - 14] ^ w[i - 16], 1);
-
-    uint32_t a = state_[0], b = state_[1], c = state_[2], d = state_[3], e = state_[4];
-
-    for (int i = 0; i < 80; ++i)
-    {
-      uint32_t f, k;
-      if (i < 20)
-      {
-        f = (b & c) | ((~b) & d);
-        k = 0x5A827999;
-      }
-      else if (i < 40)
-      {
-        f = b ^ c ^ d;
-        k = 0x6ED9EBA1;
-      }
-      else if (i < 60)
-      {
-        f = (b & c) | (b & d) | (c & d);
-        k = 0x8F1BBCDC;
-      }
-      else
-      {
-        f = b ^ c ^ d;
-        k = 0xCA62C1D6;
-      }
-
-      const uint32_t temp = leftRotate(a, 5) + f + e + k + w[i];
-      e = d;
-      d = c;
-      c = leftRotate(b, 30);
-      b = a;
-      a = temp;
-    }
-
-    state_[0] += a;
-    state_[1] += b;
-    state_[2] += c;
-    state_[3] += d;
-    state_[4] += e;
-  }
-
-  uint32_t SHA1::leftRotate(const uint32_t x, const uint32_t n)
-  {
-    return (x << n) | (x >> (32 - n));
-  }
-}
\ No newline at end of file
+}
@@ -1,4 +1,12 @@
 #include "cppkit/crypto/sha256.hpp"
+#include "cppkit/crypto/hmac.hpp"
+#include <atomic>
+#include <stdexcept>
+#include <utility>
+
+#if defined(__x86_64__) || defined(__i386__)
+#include <immintrin.h>
+#endif
 
 namespace cppkit::crypto
 {
@@ -16,48 +24,403 @@ namespace cppkit::crypto
                                      0x682e6ff3, 0x748f82ee, 0x78a5636f, 0x84c87814, 0x8cc70208,
                                      0x90befffa, 0xa4506ceb, 0xbef9a3f7, 0xc67178f2};
 
+  static uint32_t rotr(const uint32_t x, const uint32_t n)
+  {
+    return (x >> n) | (x << (32 - n));
+  }
+
+  static void compressScalar(uint32_t state[8], const uint8_t* data, size_t blocks)
+  {
+    for (; blocks > 0; --blocks, data += 64)
+    {
+      uint32_t w[64];
+      for (int i = 0; i < 16; i++)
+        w[i] = (data[i * 4] << 24) | (data[i * 4 + 1] << 16) | (data[i * 4 + 2] << 8) | data[i * 4 + 3];
+      for (int i = 16; i < 64; i++)
+      {
+        const uint32_t s0 = rotr(w[i - 15], 7) ^ rotr(w[i - 15], 18) ^ (w[i - 15] >> 3);
+        const uint32_t s1 = rotr(w[i - 2], 17) ^ rotr(w[i - 2], 19) ^ (w[i - 2] >> 10);
+        w[i] = w[i - 16] + s0 + w[i - 7] + s1;
+      }
+
+      uint32_t a = state[0], b = state[1], c = state[2], d = state[3];
+      uint32_t e = state[4], f = state[5], g = state[6], h = state[7];
+
+      for (int i = 0; i < 64; i++)
+      {
+        const uint32_t S1 = rotr(e, 6) ^ rotr(e, 11) ^ rotr(e, 25);
+        const uint32_t ch = (e & f) ^ ((~e) & g);
+        const uint32_t temp1 = h + S1 + ch + K[i] + w[i];
+        const uint32_t S0 = rotr(a, 2) ^ rotr(a, 13) ^ rotr(a, 22);
+        const uint32_t maj = (a & b) ^ (a & c) ^ (b & c);
+        const uint32_t temp2 = S0 + maj;
+
+        h = g;
+        g = f;
+        f = e;
+        e = d + temp1;
+        d = c;
+        c = b;
+        b = a;
+        a = temp1 + temp2;
+      }
+
+      state[0] += a;
+      state[1] += b;
+      state[2] += c;
+      state[3] += d;
+      state[4] += e;
+      state[5] += f;
+      state[6] += g;
+      state[7] += h;
+    }
+  }
+
+#if defined(__x86_64__) || defined(__i386__)
+#define CPPKIT_SHA_X86 1
+  // 每 4 轮一组，G 为组号；msg[G % 4] 保存当前组的消息字，其余三个在流水线中提前扩展
+  template <int G>
+  __attribute__((target("sha,sse4.1"), always_inline)) inline void shaNiGroup(
+      __m128i& abef, __m128i& cdgh, __m128i (&msg)[4], const uint8_t* data, const __m128i& bswap)
+  {
+    __m128i& cur = msg[G & 3];
+    if constexpr (G < 4)
+      cur = _mm_shuffle_epi8(_mm_loadu_si128(reinterpret_cast<const __m128i*>(data + G * 16)), bswap);
+    __m128i wk = _mm_add_epi32(cur, _mm_loadu_si128(reinterpret_cast<const __m128i*>(K + G * 4)));
+    cdgh = _mm_sha256rnds2_epu32(cdgh, abef, wk);
+    if constexpr (G >= 3 && G <= 14)
+    {
+      __m128i& next = msg[(G + 1) & 3];
+      next = _mm_add_epi32(next, _mm_alignr_epi8(cur, msg[(G + 3) & 3], 4));
+      next = _mm_sha256msg2_epu32(next, cur);
+    }
+    wk = _mm_shuffle_epi32(wk, 0x0E);
+    abef = _mm_sha256rnds2_epu32(abef, cdgh, wk);
+    if constexpr (G >= 1 && G <= 12)
+      msg[(G + 3) & 3] = _mm_sha256msg1_epu32(msg[(G + 3) & 3], cur);
+  }
+
+  template <int... G>
+  __attribute__((target("sha,sse4.1"), always_inline)) inline void shaNiRounds(
+      std::integer_sequence<int, G...>, __m128i& abef, __m128i& cdgh, const uint8_t* data, const __m128i& bswap)
+  {
+    __m128i msg[4];
+    (shaNiGroup<G>(abef, cdgh, msg, data, bswap), ...);
+  }
+
+  __attribute__((target("sha,sse4.1"))) static void compressShaNi(uint32_t state[8], const uint8_t* data,
+                                                                 size_t blocks)
+  {
+    const __m128i bswap = _mm_set_epi64x(0x0c0d0e0f08090a0bULL, 0x0405060700010203ULL);
+
+    // 指令要求的寄存器布局：ABEF 与 CDGH
+    __m128i tmp = _mm_shuffle_epi32(_mm_loadu_si128(reinterpret_cast<const __m128i*>(state)), 0xB1);
+    __m128i cdgh = _mm_shuffle_epi32(_mm_loadu_si128(reinterpret_cast<const __m128i*>(state + 4)), 0x1B);
+    __m128i abef = _mm_alignr_epi8(tmp, cdgh, 8);
+    cdgh = _mm_blend_epi16(cdgh, tmp, 0xF0);
+
+    for (; blocks > 0; --blocks, data += 64)
+    {
+      const __m128i abefSave = abef;
+      const __m128i cdghSave = cdgh;
+      shaNiRounds(std::make_integer_sequence<int, 16>(), abef, cdgh, data, bswap);
+      abef = _mm_add_epi32(abef, abefSave);
+      cdgh = _mm_add_epi32(cdgh, cdghSave);
+    }
+
+    tmp = _mm_shuffle_epi32(abef, 0x1B);
+    cdgh = _mm_shuffle_epi32(cdgh, 0xB1);
+    _mm_storeu_si128(reinterpret_cast<__m128i*>(state), _mm_blend_epi16(tmp, cdgh, 0xF0));
+    _mm_storeu_si128(reinterpret_cast<__m128i*>(state + 4), _mm_alignr_epi8(cdgh, tmp, 8));
+  }
+
+  __attribute__((target("avx2"))) static inline __m256i rotr8(const __m256i x, const int n)
+  {
+    return _mm256_or_si256(_mm256_srli_epi32(x, n), _mm256_slli_epi32(x, 32 - n));
+  }
+
+  // 8 路转置：输入 r[i] 为第 i 路的 8 个字，输出 r[j] 为 8 路的第 j 个字
+  __attribute__((target("avx2"))) static inline void transpose8(__m256i r[8])
+  {
+    __m256i t[8], u[8];
+    for (int i = 0; i < 8; i += 2)
+    {
+      t[i] = _mm256_unpacklo_epi32(r[i], r[i + 1]);
+      t[i + 1] = _mm256_unpackhi_epi32(r[i], r[i + 1]);
+    }
+    for (int i = 0; i < 8; i += 4)
+    {
+      u[i] = _mm256_unpacklo_epi64(t[i], t[i + 2]);
+      u[i + 1] = _mm256_unpackhi_epi64(t[i], t[i + 2]);
+      u[i + 2] = _mm256_unpacklo_epi64(t[i + 1], t[i + 3]);
+      u[i + 3] = _mm256_unpackhi_epi64(t[i + 1], t[i + 3]);
+    }
+    for (int i = 0; i < 4; ++i)
+    {
+      r[i] = _mm256_permute2x128_si256(u[i], u[i + 4], 0x20);
+      r[i + 4] = _mm256_permute2x128_si256(u[i], u[i + 4], 0x31);
+    }
+  }
+
+  // 8 条消息同时压缩：state 按字交错存放，state[word * 8 + lane]；第 lane 路从 data[lane] 读取 blocks 个块
+  __attribute__((target("avx2"))) static void compressX8Avx2(uint32_t state[64], const uint8_t* const data[8],
+                                                             const size_t blocks)
+  {
+    const __m256i bswap = _mm256_set_epi64x(0x0c0d0e0f08090a0bULL, 0x0405060700010203ULL, 0x0c0d0e0f08090a0bULL,
+                                            0x0405060700010203ULL);
+    __m256i s[8];
+    for (int i = 0; i < 8; ++i)
+      s[i] = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(state + i * 8));
+
+    for (size_t block = 0; block < blocks; ++block)
+    {
+      __m256i w[16];
+      for (int half = 0; half < 2; ++half)
+      {
+        for (int lane = 0; lane < 8; ++lane)
+          w[half * 8 + lane] = _mm256_loadu_si256(
+              reinterpret_cast<const __m256i*>(data[lane] + block * 64 + half * 32));
+        transpose8(w + half * 8);
+      }
+      for (auto& x : w)
+        x = _mm256_shuffle_epi8(x, bswap);
+
+      __m256i a = s[0], b = s[1], c = s[2], d = s[3], e = s[4], f = s[5], g = s[6], h = s[7];
+      for (int i = 0; i < 64; ++i)
+      {
+        if (i >= 16)
+        {
+          const __m256i w15 = w[(i + 1) & 15], w2 = w[(i + 14) & 15];
+          const __m256i s0 = _mm256_xor_si256(_mm256_xor_si256(rotr8(w15, 7), rotr8(w15, 18)),
+                                              _mm256_srli_epi32(w15, 3));
+          const __m256i s1 = _mm256_xor_si256(_mm256_xor_si256(rotr8(w2, 17), rotr8(w2, 19)),
+                                              _mm256_srli_epi32(w2, 10));
+          w[i & 15] = _mm256_add_epi32(_mm256_add_epi32(w[i & 15], s0), _mm256_add_epi32(w[(i + 9) & 15], s1));
+        }
+        const __m256i S1 = _mm256_xor_si256(_mm256_xor_si256(rotr8(e, 6), rotr8(e, 11)), rotr8(e, 25));
+        const __m256i ch = _mm256_xor_si256(_mm256_and_si256(e, f), _mm256_andnot_si256(e, g));
+        const __m256i temp1 = _mm256_add_epi32(_mm256_add_epi32(h, S1),
+                                               _mm256_add_epi32(ch, _mm256_add_epi32(
+                                                                    _mm256_set1_epi32(static_cast<int>(K[i])),
+                                                                    w[i & 15])));
+        const __m256i S0 = _mm256_xor_si256(_mm256_xor_si256(rotr8(a, 2), rotr8(a, 13)), rotr8(a, 22));
+        const __m256i ab = _mm256_xor_si256(a, b);
+        const __m256i maj = _mm256_xor_si256(_mm256_and_si256(a, b), _mm256_and_si256(c, ab));
+        h = g;
+        g = f;
+        f = e;
+        e = _mm256_add_epi32(d, temp1);
+        d = c;
+        c = b;
+        b = a;
+        a = _mm256_add_epi32(temp1, _mm256_add_epi32(S0, maj));
+      }
+      s[0] = _mm256_add_epi32(s[0], a);
+      s[1] = _mm256_add_epi32(s[1], b);
+      s[2] = _mm256_add_epi32(s[2], c);
+      s[3] = _mm256_add_epi32(s[3], d);
+      s[4] = _mm256_add_epi32(s[4], e);
+      s[5] = _mm256_add_epi32(s[5], f);
+      s[6] = _mm256_add_epi32(s[6], g);
+      s[7] = _mm256_add_epi32(s[7], h);
+    }
+
+    for (int i = 0; i < 8; ++i)
+      _mm256_storeu_si256(reinterpret_cast<__m256i*>(state + i * 8), s[i]);
+  }
+#endif
+
+  static ShaBackend detectBackend() noexcept
+  {
+    if (isSupported(ShaBackend::ShaNi))
+      return ShaBackend::ShaNi;
+    if (isSupported(ShaBackend::Avx2))
+      return ShaBackend::Avx2;
+    return ShaBackend::Scalar;
+  }
+
+  static std::atomic<ShaBackend>& currentBackend() noexcept
+  {
+    static std::atomic<ShaBackend> backend{detectBackend()};
+    return backend;
+  }
+
+  ShaBackend SHA256::backend() noexcept { return currentBackend().load(std::memory_order_relaxed); }
+
+  bool SHA256::setBackend(const ShaBackend backend) noexcept
+  {
+    if (!isSupported(backend))
+      return false;
+    currentBackend().store(backend, std::memory_order_relaxed);
+    return true;
+  }
+
+  void SHA256::compress(uint32_t state[8], const uint8_t* data, const size_t blocks)
+  {
+#ifdef CPPKIT_SHA_X86
+    if (backend() == ShaBackend::ShaNi)
+      return compressShaNi(state, data, blocks);
+#endif
+    compressScalar(state, data, blocks);
+  }
+
   void SHA256::update(const uint8_t* data, size_t len)
   {
-    while (len > 0)
+    if (bufferLen_ > 0)
     {
       const size_t toCopy = std::min(len, 64 - bufferLen_);
       std::memcpy(buffer_ + bufferLen_, data, toCopy);
       bufferLen_ += toCopy;
       data += toCopy;
       len -= toCopy;
+      if (bufferLen_ < 64)
+        return;
+      compress(state_, buffer_, 1);
+      totalBits_ += 512;
+      bufferLen_ = 0;
+    }
+
+    // 完整的块直接从输入压缩，不经过 buffer_
+    if (const size_t blocks = len / 64; blocks > 0)
+    {
+      compress(state_, data, blocks);
+      totalBits_ += blocks * 512;
+      data += blocks * 64;
+      len -= blocks * 64;
+    }
+
+    std::memcpy(buffer_, data, len);
+    bufferLen_ = len;
+  }
+
+  static void storeDigest(const uint32_t state[8], std::array<uint8_t, 32>& out)
+  {
+    for (int i = 0; i < 8; ++i)
+    {
+      out[i * 4] = (state[i] >> 24) & 0xFF;
+      out[i * 4 + 1] = (state[i] >> 16) & 0xFF;
+      out[i * 4 + 2] = (state[i] >> 8) & 0xFF;
+      out[i * 4 + 3] = state[i] & 0xFF;
+    }
+  }
+
+  void SHA256::hashMany(const std::span<const std::string_view> messages, const std::span<std::array<uint8_t, 32>> out)
+  {
+    if (out.size() < messages.size())
+      throw std::runtime_error("sha256: output span is smaller than input");
 
-      if (bufferLen_ == 64)
+#ifdef CPPKIT_SHA_X86
+    if (backend() == ShaBackend::Avx2)
+    {
+      // 每路先压缩消息中的完整块，再压缩带填充的尾部（1 或 2 块）
+      struct Lane
+      {
+        const uint8_t* p;
+        size_t left; // 当前区间剩余块数
+        bool inTail;
+        size_t tailBlocks;
+        uint8_t tail[128];
+      };
+      static constexpr uint32_t iv[8] = {0x6a09e667, 0xbb67ae85, 0x3c6ef372, 0xa54ff53a,
+                                         0x510e527f, 0x9b05688c, 0x1f83d9ab, 0x5be0cd19};
+      Lane lanes[8];
+      for (size_t base = 0; base < messages.size(); base += 8)
       {
-        transform(buffer_);
-        totalBits_ += 512;
-        bufferLen_ = 0;
+        const size_t n = std::min<size_t>(8, messages.size() - base);
+        for (size_t i = 0; i < n; ++i)
+        {
+          const std::string_view msg = messages[base + i];
+          Lane& lane = lanes[i];
+          const size_t full = msg.size() / 64;
+          const size_t rest = msg.size() - full * 64;
+          lane.p = reinterpret_cast<const uint8_t*>(msg.data());
+          lane.left = full;
+          lane.inTail = false;
+          lane.tailBlocks = rest < 56 ? 1 : 2;
+          std::memcpy(lane.tail, msg.data() + full * 64, rest);
+          lane.tail[rest] = 0x80;
+          const size_t tailSize = lane.tailBlocks * 64;
+          std::memset(lane.tail + rest + 1, 0, tailSize - rest - 1);
+          const uint64_t bits = static_cast<uint64_t>(msg.size()) * 8;
+          for (int j = 0; j < 8; ++j)
+            lane.tail[tailSize - 1 - j] = (bits >> (j * 8)) & 0xFF;
+        }
+        // 不足 8 路时用第 0 路补齐，结果丢弃
+        for (size_t i = n; i < 8; ++i)
+          lanes[i] = lanes[0];
+
+        uint32_t state[64];
+        for (int w = 0; w < 8; ++w)
+          std::fill_n(state + w * 8, 8, iv[w]);
+
+        // 所有路都还有数据时并行压缩；某一路的尾部处理完就停下，剩余的逐路完成
+        while (true)
+        {
+          bool done = false;
+          for (auto& lane : lanes)
+          {
+            if (lane.left > 0)
+              continue;
+            if (lane.inTail)
+            {
+              done = true;
+              break;
+            }
+            lane.p = lane.tail;
+            lane.left = lane.tailBlocks;
+            lane.inTail = true;
+          }
+          if (done)
+            break;
+          size_t run = lanes[0].left;
+          for (const auto& lane : lanes)
+            run = std::min(run, lane.left);
+          const uint8_t* ptrs[8];
+          for (int i = 0; i < 8; ++i)
+            ptrs[i] = lanes[i].p;
+          compressX8Avx2(state, ptrs, run);
+          for (auto& lane : lanes)
+          {
+            lane.p += run * 64;
+            lane.left -= run;
+          }
+        }
+
+        for (size_t i = 0; i < n; ++i)
+        {
+          Lane& lane = lanes[i];
+          uint32_t h[8];
+          for (int w = 0; w < 8; ++w)
+            h[w] = state[w * 8 + i];
+          compressScalar(h, lane.p, lane.left);
+          if (!lane.inTail)
+            compressScalar(h, lane.tail, lane.tailBlocks);
+          storeDigest(h, out[base + i]);
+        }
       }
+      return;
     }
-  }
+#endif
 
-  void SHA256::update(const std::string& str) { update(reinterpret_cast<const uint8_t*>(str.data()), str.size()); }
+    for (size_t i = 0; i < messages.size(); ++i)
+    {
+      SHA256 sha256;
+      sha256.update(reinterpret_cast<const uint8_t*>(messages[i].data()), messages[i].size());
+      out[i] = sha256.digest();
+    }
+  }
 
   std::array<uint8_t, 32> SHA256::digest()
   {
     finalize();
     std::array<uint8_t, 32> out{};
-    for (int i = 0; i < 8; ++i)
-    {
-      out[i * 4] = (state_[i] >> 24) & 0xFF;
-      out[i * 4 + 1] = (state_[i] >> 16) & 0xFF;
-      out[i * 4 + 2] = (state_[i] >> 8) & 0xFF;
-      out[i * 4 + 3] = state_[i] & 0xFF;
-    }
+    storeDigest(state_, out);
     return out;
   }
 
   std::string SHA256::hexDigest()
   {
-    const auto d = digest();
-    std::ostringstream oss;
-    for (const auto b : d)
-      oss << std::hex << std::setw(2) << std::setfill('0') << static_cast<int>(b);
-    return oss.str();
+    return hexEncode(digest());
   }
 
   void SHA256::reset()
@@ -76,116 +439,55 @@ namespace cppkit::crypto
     finalized_ = false;
   }
 
-  std::string SHA256::sha(const std::string& message)
+  std::string SHA256::sha(const std::string_view message)
+  {
+    return hexEncode(shaBinary(message));
+  }
+
+  std::array<uint8_t, 32> SHA256::shaBinary(const std::span<const uint8_t> message)
   {
     SHA256 sha256;
     sha256.update(message);
-    return sha256.hexDigest();
+    return sha256.digest();
   }
 
-  std::string SHA256::hmac(const std::string& key, const std::string& message)
+  std::array<uint8_t, 32> SHA256::shaBinary(const std::string_view message)
   {
-    constexpr size_t blockSize = 64;
-    std::vector<uint8_t> keyBytes(key.begin(), key.end());
-
-    if (keyBytes.size() > blockSize)
-    {
-      SHA256 sha256;
-      sha256.update(keyBytes.data(), keyBytes.size());
-      auto hashedKey = sha256.digest();
-      keyBytes = std::vector<uint8_t>(hashedKey.begin(), hashedKey.end());
-    }
-
-    keyBytes.resize(blockSize, 0x00);
-
-    std::vector<uint8_t> oKeyPad(blockSize);
-    std::vector<uint8_t> iKeyPad(blockSize);
-    for (size_t i = 0; i < blockSize; ++i)
-    {
-      oKeyPad[i] = keyBytes[i] ^ 0x5c;
-      iKeyPad[i] = keyBytes[i] ^ 0x36;
-    }
-
-    SHA256 innerSha256;
-    innerSha256.update(iKeyPad.data(), iKeyPad.size());
-    innerSha256.update(reinterpret_cast<const uint8_t*>(message.data()), message.size());
-    auto innerHash = innerSha256.digest();
+    SHA256 sha256;
+    sha256.update(message);
+    return sha256.digest();
+  }
 
-    SHA256 outerSha256;
-    outerSha256.update(oKeyPad.data(), oKeyPad.size());
-    outerSha256.update(innerHash.data(), innerHash.size());
-    auto hmacHash = outerSha256.digest();
+  std::string SHA256::hmac(const std::string_view key, const std::string_view message)
+  {
+    return hexEncode(hmacBinary(key, message));
+  }
 
-    std::ostringstream oss;
-    for (const auto b : hmacHash)
-      oss << std::hex << std::setw(2) << std::setfill('0') << static_cast<int>(b);
-    return oss.str();
+  std::array<uint8_t, 32> SHA256::hmacBinary(const std::string_view key, const std::string_view message)
+  {
+    return Hmac<SHA256>(key).mac(message);
   }
 
   void SHA256::finalize()
   {
     if (finalized_)
       return;
-    totalBits_ += bufferLen_ * 8;
-
-    uint8_t pad[64] = {0x80};
-    size_t padLen = (bufferLen_ < 56) ? (56 - bufferLen_) : (120 - bufferLen_);
-    update(pad, padLen);
+    const uint64_t bitLength = totalBits_ + bufferLen_ * 8;
 
-    uint8_t lenBytes[8];
-    for (int i = 0; i < 8; ++i)
-      lenBytes[7 - i] = (totalBits_ >> (i * 8)) & 0xFF;
-    update(lenBytes, 8);
-
-    finalized_ = true;
-  }
-
-  void SHA256::transform(const uint8_t block[64])
-  {
-    uint32_t w[64];
-    for (int i = 0; i < 16; i++)
-      w[i] = (block[i * 4] << 24) | (block[i * 4 + 1] << 16) | (block[i * 4 + 2] << 8) | block[i * 4 + 3];
-    for (int i = 16; i < 64; i++)
+    // 直接在 buffer_ 中填充，长度放不下时多压缩一个块
+    buffer_[bufferLen_++] = 0x80;
+    if (bufferLen_ > 56)
     {
-      const uint32_t s0 = rotr(w[i - 15], 7) ^ rotr(w[i - 15], 18) ^ (w[i - 15] >> 3);
-      const uint32_t s1 = rotr(w[i - 2], 17) ^ rotr(w[i - 2], 19) ^ (w[i - 2] >> 10);
-      w[i] = w[i - 16] + s0 + w[i - 7] + s1;
+      std::memset(buffer_ + bufferLen_, 0, 64 - bufferLen_);
+      compress(state_, buffer_, 1);
+      bufferLen_ = 0;
     }
+    std::memset(buffer_ + bufferLen_, 0, 56 - bufferLen_);
+    for (int i = 0; i < 8; ++i)
+      buffer_[63 - i] = (bitLength >> (i * 8)) & 0xFF;
+    compress(state_, buffer_, 1);
+    bufferLen_ = 0;
 
-    uint32_t a = state_[0], b = state_[1], c = state_[2], d = state_[3];
-    uint32_t e = state_[4], f = state_[5], g = state_[6], h = state_[7];
-
-    for (int i = 0; i < 64; i++)
-    {
-      const uint32_t S1 = rotr(e, 6) ^ rotr(e, 11) ^ rotr(e, 25);
-      const uint32_t ch = (e & f) ^ ((~e) & g);
-      const uint32_t temp1 = h + S1 + ch + K[i] + w[i];
-      const uint32_t S0 = rotr(a, 2) ^ rotr(a, 13) ^ rotr(a, 22);
-      const uint32_t maj = (a & b) ^ (a & c) ^ (b & c);
-      const uint32_t temp2 = S0 + maj;
-
-      h = g;
-      g = f;
-      f = e;
-      e = d + temp1;
-      d = c;
-      c = b;
-      b = a;
-      a = temp1 + temp2;
-    }
-
-    state_[0] += a;
-    state_[1] += b;
-    state_[2] += c;
-    state_[3] += d;
-    state_[4] += e;
-    state_[5] += f;
-    state_[6] += g;
-    state_[7] += h;
-  }
-
-  uint32_t SHA256::rotr(const uint32_t x, const uint32_t n)
-  {
-    return (x >> n) | (x << (32 - n));
+    finalized_ = true;
   }
-}
\ No newline at end of file
+}
@@ -1,4 +1,5 @@
 #include "cppkit/crypto/sha512.hpp"
+#include "cppkit/crypto/hmac.hpp"
 #include <vector>
 
 namespace cppkit::crypto
@@ -48,28 +49,31 @@ namespace cppkit::crypto
     buffer_.fill(0);
   }
 
-  void SHA512::update(const uint8_t* data, const size_t len)
+  void SHA512::update(const uint8_t* data, size_t len)
   {
-    size_t i = 0;
-    while (i < len)
+    if (bufferLen_ > 0)
     {
-      size_t toCopy = std::min(len - i, static_cast<size_t>(128 - bufferLen_));
-      std::memcpy(buffer_.data() + bufferLen_, data + i, toCopy);
+      const size_t toCopy = std::min(len, static_cast<size_t>(128 - bufferLen_));
+      std::memcpy(buffer_.data() + bufferLen_, data, toCopy);
       bufferLen_ += toCopy;
-      i += toCopy;
-
-      if (bufferLen_ == 128)
-      {
-        transform(buffer_.data());
-        bitLen_ += 1024;
-        bufferLen_ = 0;
-      }
+      data += toCopy;
+      len -= toCopy;
+      if (bufferLen_ < 128)
+        return;
+      transform(buffer_.data());
+      bitLen_ += 1024;
+      bufferLen_ = 0;
     }
-  }
 
-  void SHA512::update(const std::string& str)
-  {
-    update(reinterpret_cast<const uint8_t*>(str.data()), str.size());
+    // 完整的块直接从输入压缩，不经过 buffer_
+    for (; len >= 128; data += 128, len -= 128)
+    {
+      transform(data);
+      bitLen_ += 1024;
+    }
+
+    std::memcpy(buffer_.data(), data, len);
+    bufferLen_ = len;
   }
 
   void SHA512::finalize()
@@ -167,52 +171,35 @@ namespace cppkit::crypto
 
   std::string SHA512::hexDigest()
   {
-    const auto d = digest();
-    std::ostringstream oss;
-    for (const auto b : d)
-      oss << std::hex << std::setw(2) << std::setfill('0') << static_cast<int>(b);
-    return oss.str();
+    return hexEncode(digest());
   }
 
-  std::string SHA512::sha(const std::string& message)
+  std::string SHA512::sha(const std::string_view message)
+  {
+    return hexEncode(shaBinary(message));
+  }
+
+  std::array<uint8_t, 64> SHA512::shaBinary(const std::span<const uint8_t> message)
   {
     SHA512 sha512;
     sha512.update(message);
-    return sha512.hexDigest();
+    return sha512.digest();
   }
 
-  std::string SHA512::hmac(const std::string& key, const std::string& message)
+  std::array<uint8_t, 64> SHA512::shaBinary(const std::string_view message)
   {
-    constexpr size_t blockSize = 128;
-    std::vector<uint8_t> keyBytes(key.begin(), key.end());
-    if (keyBytes.size() > blockSize)
-    {
-      SHA512 sha512;
-      sha512.update(key);
-      auto hashedKey = sha512.digest();
-      keyBytes = std::vector(hashedKey.begin(), hashedKey.end());
-    }
-    keyBytes.resize(blockSize, 0x00);
-    std::vector<uint8_t> oKeyPad(blockSize);
-    std::vector<uint8_t> iKeyPad(blockSize);
-    for (size_t i = 0; i < blockSize; ++i)
-    {
-      oKeyPad[i] = keyBytes[i] ^ 0x5c;
-      iKeyPad[i] = keyBytes[i] ^ 0x36;
-    }
+    SHA512 sha512;
+    sha512.update(message);
+    return sha512.digest();
+  }
 
-    SHA512 innerSha512;
-    innerSha512.update(iKeyPad.data(), iKeyPad.size());
-    innerSha512.update(message);
-    auto innerHash = innerSha512.digest();
-
-    SHA512 outerSha512;
-    outerSha512.update(oKeyPad.data(), oKeyPad.size());
-    outerSha512.update(innerHash.data(), innerHash.size());
-    auto hmacHash = outerSha512.digest();
-    std::ostringstream oss;
-    for (const auto b : hmacHash)
-      oss << std::hex << std::setw(2) << std::setfill('0') << static_cast<int>(b);
-    return oss.str();
+  std::string SHA512::hmac(const std::string_view key, const std::string_view message)
+  {
+    return hexEncode(hmacBinary(key, message));
+  }
+
+  std::array<uint8_t, 64> SHA512::hmacBinary(const std::string_view key, const std::string_view message)
+  {
+    return Hmac<SHA512>(key).mac(message);
   }
-}
\ No newline at end of file
+}
@@ -0,0 +1,67 @@
+#include "cppkit/crypto/sha_backend.hpp"
+
+#if defined(__x86_64__) || defined(__i386__)
+#include <cpuid.h>
+#endif
+
+namespace cppkit::crypto
+{
+  struct CpuFeatures
+  {
+    bool sha = false;
+    bool avx2 = false;
+  };
+
+  static CpuFeatures detectCpu() noexcept
+  {
+    CpuFeatures features;
+#if defined(__x86_64__) || defined(__i386__)
+    unsigned a, b, c, d;
+    if (!__get_cpuid(1, &a, &b, &c, &d))
+      return features;
+    const bool sse41 = (c & bit_SSSE3) && (c & bit_SSE4_1);
+    const bool avx = (c & bit_OSXSAVE) && (c & bit_AVX);
+    if (__get_cpuid_max(0, nullptr) < 7)
+      return features;
+    __cpuid_count(7, 0, a, b, c, d);
+    features.sha = sse41 && (b & bit_SHA);
+    if (avx && (b & bit_AVX2))
+    {
+      // 操作系统需要保存 YMM 寄存器状态
+      uint32_t lo, hi;
+      __asm__("xgetbv" : "=a"(lo), "=d"(hi) : "c"(0));
+      features.avx2 = (lo & 0x6) == 0x6;
+    }
+#endif
+    return features;
+  }
+
+  bool isSupported(const ShaBackend backend) noexcept
+  {
+    static const CpuFeatures features = detectCpu();
+    switch (backend)
+    {
+    case ShaBackend::Scalar:
+      return true;
+    case ShaBackend::ShaNi:
+      return features.sha;
+    case ShaBackend::Avx2:
+      return features.avx2;
+    }
+    return false;
+  }
+
+  const char* backendName(const ShaBackend backend) noexcept
+  {
+    switch (backend)
+    {
+    case ShaBackend::Scalar:
+      return "scalar";
+    case ShaBackend::ShaNi:
+      return "sha-ni";
+    case ShaBackend::Avx2:
+      return "avx2-x8";
+    }
+    return "unknown";
+  }
+} // namespace cppkit::crypto
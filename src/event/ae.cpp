@@ -1,4 +1,5 @@
 #include "cppkit/event/ae.hpp"
+#include "cppkit/metrics/metrics.hpp"
 
 #include <iostream>
 
@@ -82,7 +83,8 @@ namespace cppkit::event
   {
     if (fd < 0)
       return false;
-    auto fe = impl_->fevents[fd];
+    // 原地修改：回调执行期间追加另一种事件时，不能替换正在执行的回调
+    FileEvent& fe = impl_->fevents[fd];
 
     fe.mask |= mask;
     if (mask & AE_READABLE)
@@ -90,8 +92,6 @@ namespace cppkit::event
     if (mask & AE_WRITABLE)
       fe.wfileProc = cb;
 
-    impl_->fevents[fd] = fe;
-
 #ifdef AE_USE_EPOLL
     struct epoll_event ev{};
     ev.events = 0;
@@ -256,6 +256,8 @@ namespace cppkit::event
           continue;
         throw std::runtime_error(std::string("epoll_wait: ") + strerror(errno));
       }
+      CK_COUNTER_INC("cppkit_event_loop_iterations_total", "Event loop wakeups");
+      CK_COUNTER_ADD("cppkit_event_loop_file_events_total", "File events returned by the poller", nfds);
       for (int i = 0; i < nfds; ++i)
       {
         int fd = events[i].data.fd;
@@ -267,11 +269,11 @@ namespace cppkit::event
         auto it = impl_->fevents.find(fd);
         if (it == impl_->fevents.end())
           continue;
-        FileEvent& fe = it->second;
-        if ((mask & AE_READABLE) && fe.rfileProc)
-          fe.rfileProc(fd, mask);
-        if ((mask & AE_WRITABLE) && fe.wfileProc)
-          fe.wfileProc(fd, mask);
+        if ((mask & AE_READABLE) && it->second.rfileProc)
+          it->second.rfileProc(fd, mask);
+        // 读回调可能已经关闭连接并删除了该 fd 的事件
+        if ((mask & AE_WRITABLE) && (it = impl_->fevents.find(fd)) != impl_->fevents.end() && it->second.wfileProc)
+          it->second.wfileProc(fd, mask);
       }
 #elif defined(AE_USE_KQUEUE)
       timespec ts{};
@@ -289,6 +291,8 @@ namespace cppkit::event
           continue;
         throw std::runtime_error(std::string("kevent: ") + strerror(errno));
       }
+      CK_COUNTER_INC("cppkit_event_loop_iterations_total", "Event loop wakeups");
+      CK_COUNTER_ADD("cppkit_event_loop_file_events_total", "File events returned by the poller", nf_ds);
       for (int i = 0; i < nf_ds; ++i)
       {
         int fd = static_cast<int>(events[i].ident);
@@ -300,12 +304,11 @@ namespace cppkit::event
         auto it = impl_->fevents.find(fd);
         if (it == impl_->fevents.end())
           continue;
-        FileEvent& fe = it->second;
-
-        if ((mask & AE_READABLE) && fe.rfileProc)
-          fe.rfileProc(fd, mask);
-        if ((mask & AE_WRITABLE) && fe.wfileProc)
-          fe.wfileProc(fd, mask);
+        if ((mask & AE_READABLE) && it->second.rfileProc)
+          it->second.rfileProc(fd, mask);
+        // 读回调可能已经关闭连接并删除了该 fd 的事件
+        if ((mask & AE_WRITABLE) && (it = impl_->fevents.find(fd)) != impl_->fevents.end() && it->second.wfileProc)
+          it->second.wfileProc(fd, mask);
       }
 #else
       throw std::runtime_error("no epoll or kqueue implementation");
@@ -324,6 +327,7 @@ namespace cppkit::event
           continue;
         }
 
+        CK_COUNTER_INC("cppkit_event_loop_time_events_total", "Time event callbacks run");
         // 执行回调，如果返回值>0则重新调度
         if (const int64_t next = te.cb(te.id); next > 0)
         {
@@ -1,5 +1,6 @@
 #include "cppkit/event/server.hpp"
 #include "cppkit/define.hpp"
+#include "cppkit/metrics/metrics.hpp"
 #include <arpa/inet.h>
 #include <fcntl.h>
 #include <iostream>
@@ -126,10 +127,13 @@ namespace cppkit::event
                                        {
                                            if (errno == EAGAIN || errno == EWOULDBLOCK)
                                                break;
+                                           CK_COUNTER_INC("cppkit_tcp_accept_errors_total", "Failed accept calls");
                                            std::cerr << "accept error: " << strerror(errno) << "\n";
                                            break;
                                        }
                                        setNonBlock(c);
+                                       CK_COUNTER_INC("cppkit_tcp_connections_accepted_total", "Accepted TCP connections");
+                                       CK_GAUGE_ADD("cppkit_tcp_connections", "Open TCP connections", 1);
 
                                        char ipBuf[64];
                                        uint16_t port = 0;
@@ -248,6 +252,11 @@ namespace cppkit::event
                 found = true;
             }
         }
+        if (found)
+        {
+            CK_COUNTER_INC("cppkit_tcp_connections_closed_total", "Closed TCP connections");
+            CK_GAUGE_ADD("cppkit_tcp_connections", "Open TCP connections", -1);
+        }
 
         if (found && onClose_)
         {
@@ -275,6 +284,11 @@ namespace cppkit::event
         return ::send(this->fd, data, length, 0);
     }
 
+    ssize_t ConnInfo::sendv(const iovec* iov, const int count) const
+    {
+        return ::writev(this->fd, iov, count);
+    }
+
     ssize_t ConnInfo::recv(uint8_t* data, const size_t length) const
     {
         return ::recv(this->fd, data, length, 0);
@@ -1,5 +1,7 @@
 #include "cppkit/http/http_client.hpp"
 #include "cppkit/strings.hpp"
+#include "cppkit/metrics/metrics.hpp"
+#include "cppkit/trace/trace.hpp"
 #include <netdb.h>
 #include <stdexcept>
 #include <unistd.h>
@@ -59,11 +61,15 @@ namespace cppkit::http
             throw std::runtime_error("HTTPS is not supported yet");
         }
 
+        trace::Span span("http.client");
+
         // 解析 URL
         parseUrl(request.url, host, path, port, https);
 
         // 获取连接
+        trace::Span connectSpan("http.client.connect");
         auto conn = getConnection(host, port);
+        connectSpan.end();
 
         // 设置 TCP_NODELAY
         constexpr int flag = 1;
@@ -92,7 +98,7 @@ namespace cppkit::http
         // HTTP/1.1 默认 Keep-Alive，除非 Connection: close
         bool keepAlive = true;
 
-        if (startsWith(toUpper(connHeader), toUpper("close")))
+        if (iequals(std::string_view(connHeader).substr(0, 5), "close"))
         {
             keepAlive = false;
         }
@@ -386,9 +392,11 @@ namespace cppkit::http
 
                 if (isConnectionAlive(conn->fd))
                 {
+                    CK_COUNTER_INC("cppkit_http_client_pool_hits_total", "Requests served by a pooled connection");
                     conn->lastUsed = std::chrono::steady_clock::now();
                     return conn;
                 }
+                CK_COUNTER_INC("cppkit_http_client_pool_stale_total", "Pooled connections found closed on reuse");
             }
         }
 
@@ -401,6 +409,7 @@ namespace cppkit::http
 
         lock.unlock();
 
+        CK_COUNTER_INC("cppkit_http_client_pool_misses_total", "Requests that had to open a new connection");
         int fd = connect2host(host, port, connectionTimeout);
         if (fd < 0)
         {
@@ -25,6 +25,12 @@ namespace cppkit::http
       req << "Connection: close\r\n";
     }
 
+    // 把当前 span 作为下游服务的父 span
+    if (const auto& context = trace::current(); context.valid() && !headers.contains("traceparent"))
+    {
+      req << "traceparent: " << context.traceparent() << "\r\n";
+    }
+
     for (const auto& [fst, snd] : headers)
     {
       req << fst << ": " << snd << "\r\n";
@@ -79,10 +79,8 @@ namespace cppkit::http::server
                         const size_t eq_pos = pair.find('=');
                         if (eq_pos != std::string_view::npos)
                         {
-                            std::string key(pair.substr(0, eq_pos));
-                            std::string value(pair.substr(eq_pos + 1));
                             // url解码
-                            request.query[std::move(urlDecode(key))].push_back(std::move(urlDecode(value)));
+                            request.query[urlDecode(pair.substr(0, eq_pos))].push_back(urlDecode(pair.substr(eq_pos + 1)));
                         }
                     }
                 }
@@ -111,7 +109,8 @@ namespace cppkit::http::server
 
             if (const size_t colon_pos = header_line.find(':'); colon_pos != std::string_view::npos)
             {
-                const std::string key(header_line.substr(0, colon_pos));
+                std::string key;
+                appendLower(key, header_line.substr(0, colon_pos));
                 std::string_view value_view = header_line.substr(colon_pos + 1);
                 while (!value_view.empty() && (value_view.front() == ' ' || value_view.front() == '\t'))
                 {
@@ -119,7 +118,7 @@ namespace cppkit::http::server
                 }
                 // HTTP 协议标准（RFC 7230）明确规定Header字段名是大小写不敏感
                 // 统一转换为小写以简化后续处理
-                request.headers[std::move(toLower(key))].emplace_back(value_view);
+                request.headers[std::move(key)].emplace_back(value_view);
             }
         }
         return request;
@@ -130,7 +129,7 @@ namespace cppkit::http::server
         return method;
     }
 
-    std::vector<u_int8_t> HttpRequest::readBody() const
+    const std::vector<u_int8_t>& HttpRequest::readBody() const
     {
         if (readBodyFlag)
         {
@@ -276,6 +275,12 @@ namespace cppkit::http::server
         _body = body;
     }
 
+    void HttpRequest::resetBody(std::vector<uint8_t>&& body) const
+    {
+        readBodyFlag = true;
+        _body = std::move(body);
+    }
+
     void HttpRequest::parseFormData() const
     {
         // 获取请求格式
@@ -284,7 +289,7 @@ namespace cppkit::http::server
         {
             return;
         }
-        auto body = readBody();
+        const auto& body = readBody();
         std::istringstream stream(std::string(body.begin(), body.end()));
         std::string pair;
         while (std::getline(stream, pair, '&'))
@@ -325,6 +330,13 @@ namespace cppkit::http::server
         return headers;
     }
 
+    trace::Context HttpRequest::getTraceContext() const
+    {
+        if (const auto it = headers.find("traceparent"); it != headers.end() && !it->second.empty())
+            return trace::Context::fromTraceparent(it->second[0]);
+        return {};
+    }
+
     std::string HttpRequest::getQuery(const std::string& key) const
     {
         if (const auto it = query.find(key); it != query.end() && !it->second.empty())
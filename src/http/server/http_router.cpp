@@ -7,16 +7,15 @@ namespace cppkit::http::server
 {
     void Router::addRoute(const HttpMethod method, const std::string& path, const HttpHandler& handler)
     {
-        const auto parts = split(path, '/');
         RouteNode* node = root.get();
 
-        for (const auto& part : parts)
+        for (const std::string_view part : splitView(path, '/'))
         {
             if (part.empty())
             {
                 continue;
             }
-            std::string key = part;
+            std::string key(part);
             bool isParam = false, isWild = false;
 
             if (!part.empty() && part[0] == ':')
@@ -44,16 +43,15 @@ namespace cppkit::http::server
 
     void Router::addMiddleware(const std::string& path, const MiddlewareHandler& middleware)
     {
-        const auto parts = split(path, '/');
         RouteNode* node = root.get();
 
-        for (const auto& part : parts)
+        for (const std::string_view part : splitView(path, '/'))
         {
             if (part.empty())
             {
                 continue;
             }
-            std::string key = part;
+            std::string key(part);
             bool isParam = false, isWild = false;
 
             if (!part.empty() && part[0] == ':')
@@ -81,7 +79,8 @@ namespace cppkit::http::server
 
     bool Router::exists(const HttpMethod method, const std::string& path) const
     {
-        const auto parts = split(path, '/');
+        std::vector<std::string_view> parts;
+        splitInto(path, '/', parts);
         std::unordered_map<std::string, std::string> params;
         const RouteNode* node = match(root.get(), parts, 0, params);
         return node && node->handlers.contains(httpMethodValue(method));
@@ -90,12 +89,11 @@ namespace cppkit::http::server
     std::list<MiddlewareHandler> Router::getMiddlewares(const std::string& path) const
     {
         std::list<MiddlewareHandler> collected;
-        const auto parts = split(path, '/');
         RouteNode* current_node = root.get();
 
         collected.insert(collected.end(), current_node->middlewares.begin(), current_node->middlewares.end());
 
-        for (const auto& part : parts)
+        for (const std::string_view part : splitView(path, '/'))
         {
             if (part.empty())
             {
@@ -103,7 +101,7 @@ namespace cppkit::http::server
             }
 
             bool found = false;
-            std::string key = part;
+            std::string_view key = part;
             // bool isParam = false, isWild = false;
 
             if (!part.empty() && part[0] == ':')
@@ -117,9 +115,9 @@ namespace cppkit::http::server
                 // isWild = true;
             }
 
-            if (current_node->children.contains(key))
+            if (const auto it = current_node->children.find(key); it != current_node->children.end())
             {
-                current_node = current_node->children[key].get();
+                current_node = it->second.get();
                 collected.insert(collected.end(), current_node->middlewares.begin(), current_node->middlewares.end());
                 found = true;
             }
@@ -163,7 +161,8 @@ namespace cppkit::http::server
                              const std::string& path,
                              std::unordered_map<std::string, std::string>& params) const
     {
-        const auto parts = split(path, '/');
+        std::vector<std::string_view> parts;
+        splitInto(path, '/', parts);
         if (const RouteNode* node = match(root.get(), parts, 0, params);
             node && node->handlers.contains(httpMethodValue(method)))
         {
@@ -173,7 +172,7 @@ namespace cppkit::http::server
     }
 
     RouteNode* Router::match(RouteNode* node,
-                             const std::vector<std::string>& parts,
+                             const std::vector<std::string_view>& parts,
                              const size_t index,
                              std::unordered_map<std::string, std::string>& params)
     {
@@ -193,12 +192,11 @@ namespace cppkit::http::server
             return node;
         }
 
-        const std::string& part = parts[currentIndex];
+        const std::string_view part = parts[currentIndex];
 
-        if (node->children.contains(part))
+        if (const auto it = node->children.find(part); it != node->children.end())
         {
-            RouteNode* child = node->children[part].get();
-            if (RouteNode* result = match(child, parts, currentIndex + 1, params))
+            if (RouteNode* result = match(it->second.get(), parts, currentIndex + 1, params))
             {
                 return result;
             }
@@ -208,7 +206,7 @@ namespace cppkit::http::server
         {
             if (RouteNode* child = childPtr.get(); child->isParam)
             {
-                params[child->segment.substr(1)] = part;
+                params[child->segment.substr(1)] = std::string(part);
                 if (RouteNode* result = match(child, parts, currentIndex + 1, params))
                 {
                     return result;
@@ -217,9 +215,10 @@ namespace cppkit::http::server
             }
             else if (child->isWild)
             {
-                params[child->segment.substr(1)] = join(
-                    std::vector(parts.begin() + static_cast<long>(index), parts.end()),
-                    "/");
+                // 各段都是 path 上的视图，剩余部分按 "/" 拼接就是 path 从 parts[index] 开始的后缀
+                const std::string_view& last = parts.back();
+                params[child->segment.substr(1)] = std::string(parts[index].data(),
+                                                               last.data() + last.size() - parts[index].data());
                 return child;
             }
         }
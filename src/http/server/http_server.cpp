@@ -4,6 +4,8 @@
 #include "cppkit/strings.hpp"
 #include "cppkit/platform.hpp"
 #include "cppkit/http/server/router_group.hpp"
+#include "cppkit/metrics/metrics.hpp"
+#include "cppkit/trace/trace.hpp"
 #include <iostream>
 #include <fstream>
 #include <filesystem>
@@ -43,17 +45,55 @@ namespace cppkit::http::server
         {
             const int fd = conn.getFd();
 
-            HttpContext& ctx = contexts[fd];
+            // 已升级的连接不再按 HTTP 解析
+            if (const auto it = _upgraded.find(fd); it != _upgraded.end())
+            {
+                readUpgraded(conn, *it->second);
+                return 0;
+            }
+
+            const auto [it, created] = contexts.try_emplace(fd);
+            HttpContext& ctx = it->second;
+            if (created && !_streams.empty())
+            {
+                ctx.onHeaders = [this, fd](HttpContext& c) { attachStream(c, fd); };
+            }
 
             // 尝试解析（包括 header 和 body）
+            const uint64_t parseStart = trace::enabled() ? trace::nowNs() : 0;
             const ParseStatus status = ctx.parse(fd);
 
             if (status == ParseStatus::BodyComplete)
             {
+                // 升级请求：连接连同请求头之后已读到的数据一起交给接管者，请求只解析这一次
+                if (const UpgradeHandler* upgrade = findUpgrade(*ctx.request))
+                {
+                    const std::unique_ptr<HttpRequest> request = std::move(ctx.request);
+                    contexts.erase(fd);
+                    _upgraded[fd] = upgrade;
+                    upgrade->onUpgrade(conn, *request, request->extraData);
+                    return 0;
+                }
+
+                // 请求 span 以请求头中的 traceparent 为父，从最后一次读事件的解析开始计时
+                trace::Span requestSpan("http.request",
+                                        parseStart ? ctx.request->getTraceContext() : trace::Context{}, parseStart);
+                if (parseStart)
+                {
+                    trace::record("http.parse", parseStart, trace::nowNs());
+                }
+
                 // Body 完全接收，可以调用业务回调
                 HttpResponseWriter writer(fd);
 
-                handleRequest(*ctx.request, writer, fd);
+                if (ctx.stream.onComplete)
+                {
+                    ctx.stream.onComplete(*ctx.request, writer);
+                }
+                else
+                {
+                    handleRequest(*ctx.request, writer, fd);
+                }
 
                 // 根据Connection头决定是否关闭连接
                 const std::string connectionHeader = ctx.request->getHeader("Connection");
@@ -62,8 +102,10 @@ namespace cppkit::http::server
 
                 if (shouldClose)
                 {
+                    // 直接关闭：返回 -1 时 errno 可能还是读 body 时留下的 EAGAIN，会被当作暂无数据而忽略
                     contexts.erase(fd);
-                    return -1; // 关闭连接
+                    conn.close();
+                    return 0;
                 }
                 // 重置，准备处理下一个请求
                 contexts.erase(fd);
@@ -77,10 +119,21 @@ namespace cppkit::http::server
             {
                 // 解析错误，关闭连接
                 contexts.erase(fd);
-                return -1;
+                conn.close();
+                return 0;
             }
             return 0;
         });
+        this->_server.setOnClose([this](const event::ConnInfo& conn)
+        {
+            contexts.erase(conn.getFd());
+            if (const auto it = _upgraded.find(conn.getFd()); it != _upgraded.end())
+            {
+                const UpgradeHandler* upgrade = it->second;
+                _upgraded.erase(it);
+                upgrade->onClose(conn);
+            }
+        });
         this->_server.start();
         std::cout << "Started http server on " << this->_host << ":" << this->_port << std::endl;
         this->_loop.run();
@@ -112,6 +165,103 @@ namespace cppkit::http::server
         this->addRoute(HttpMethod::Delete, path, handler);
     }
 
+    void HttpServer::Metrics(const std::string& path)
+    {
+        this->addRoute(HttpMethod::Get, path, [](const HttpRequest&, HttpResponseWriter& writer)
+        {
+            writer.setHeader("Content-Type", "text/plain; version=0.0.4; charset=utf-8");
+            writer.write(metrics::Registry::instance().exportPrometheus());
+        });
+    }
+
+    void HttpServer::Stream(const HttpMethod method, const std::string& path, const StreamHandler& handler)
+    {
+        if (!handler)
+        {
+            throw std::invalid_argument("Stream handler is empty: " + path);
+        }
+        if (!_streams.emplace(httpMethodValue(method) + " " + path, handler).second)
+        {
+            throw std::runtime_error("Stream route already exists: " + httpMethodValue(method) + " " + path);
+        }
+        std::cout << "Added stream route: " << httpMethodValue(method) << " " << path << std::endl;
+    }
+
+    void HttpServer::attachStream(HttpContext& ctx, const int fd) const
+    {
+        const auto it = _streams.find(httpMethodValue(ctx.request->getMethod()) + " " + ctx.request->getPath());
+        if (it == _streams.end())
+        {
+            return;
+        }
+        // 鉴权、限流等中间件在接收 body 之前执行
+        HttpResponseWriter writer(fd);
+        if (!runMiddlewares(*ctx.request, writer))
+        {
+            // 中间件已写出响应：收到 body 数据时断开连接，没有 body 时不再调用处理函数
+            ctx.stream.onData = [](std::span<const uint8_t>) { return false; };
+            ctx.stream.onComplete = [](const HttpRequest&, HttpResponseWriter&) {};
+            return;
+        }
+        ctx.stream = it->second(*ctx.request);
+        if (!ctx.stream.onData)
+        {
+            // 不接收数据时直接丢弃 body
+            ctx.stream.onData = [](std::span<const uint8_t>) { return true; };
+        }
+    }
+
+    void HttpServer::Upgrade(const std::string& path, const std::string& protocol, UpgradeHandler handler)
+    {
+        if (!handler.onUpgrade || !handler.onMessage || !handler.onClose)
+        {
+            throw std::invalid_argument("Upgrade handler is incomplete: " + path);
+        }
+        if (_upgrades.contains(path))
+        {
+            throw std::runtime_error("Upgrade route already exists: " + path);
+        }
+        _upgrades.emplace(path, std::make_pair(toLower(protocol), std::move(handler)));
+        std::cout << "Added upgrade route: " << protocol << " " << path << std::endl;
+    }
+
+    const UpgradeHandler* HttpServer::findUpgrade(const HttpRequest& request) const
+    {
+        if (_upgrades.empty() || request.getMethod() != HttpMethod::Get)
+        {
+            return nullptr;
+        }
+        const auto it = _upgrades.find(request.getPath());
+        if (it == _upgrades.end() || !iequals(trimView(request.getHeader("Upgrade")), it->second.first))
+        {
+            return nullptr;
+        }
+
+        // Connection 是逗号分隔的列表，例如 "keep-alive, Upgrade"
+        const std::string connection = request.getHeader("Connection");
+        for (const std::string_view token : splitView(connection, ','))
+        {
+            if (iequals(trimView(token), "upgrade"))
+            {
+                return &it->second.second;
+            }
+        }
+        return nullptr;
+    }
+
+    void HttpServer::readUpgraded(const event::ConnInfo& conn, const UpgradeHandler& handler)
+    {
+        char buf[DEFAULT_BUFFER_SIZE];
+        if (const ssize_t n = read(conn.getFd(), buf, sizeof(buf)); n > 0)
+        {
+            handler.onMessage(conn, std::vector<uint8_t>(buf, buf + n));
+        }
+        else if (n == 0 || (errno != EAGAIN && errno != EWOULDBLOCK))
+        {
+            conn.close();
+        }
+    }
+
     GrouterGroup HttpServer::group(const std::string& prefix)
     {
         return {this, prefix};
@@ -154,12 +304,17 @@ namespace cppkit::http::server
 
     void HttpServer::handleRequest(HttpRequest& request, HttpResponseWriter& writer, const int writerFd) const
     {
+        CK_COUNTER_INC("cppkit_http_requests_total", "HTTP requests handled");
+        CK_HISTOGRAM_TIMER("cppkit_http_request_duration_seconds", "Time spent routing and handling a request");
         std::unordered_map<std::string, std::string> params;
+        trace::Span routeSpan("http.route");
         const auto handler = _router.find(request.getMethod(), request.getPath(), params);
+        routeSpan.end();
         if (handler == nullptr)
         {
             if (const auto isStatic = staticHandler(request, writer, writerFd); !isStatic)
             {
+                CK_COUNTER_INC("cppkit_http_not_found_total", "HTTP requests that matched no route");
                 writer.setStatusCode(HTTP_NOT_FOUND);
                 writer.setHeader("Content-Type", "text/plain");
                 writer.write("404 Not Found");
@@ -168,14 +323,18 @@ namespace cppkit::http::server
         }
         request.setParams(params);
 
-        const auto middlewares = _middleware.getMiddlewares(request.getPath());
-
-        if (middlewares.empty())
+        if (!runMiddlewares(request, writer))
         {
-            // 调用路由处理函数
-            handler(request, writer);
             return;
         }
+        // 调用路由处理函数
+        trace::Span handlerSpan("http.handler");
+        handler(request, writer);
+    }
+
+    bool HttpServer::runMiddlewares(HttpRequest& request, HttpResponseWriter& writer) const
+    {
+        const auto middlewares = _middleware.getMiddlewares(request.getPath());
 
         bool nextCalled = false;
         const NextFunc next = [&nextCalled]()
@@ -186,15 +345,16 @@ namespace cppkit::http::server
         // 处理中间件
         for (const auto& middleware : middlewares)
         {
+            trace::Span middlewareSpan("http.middleware");
             middleware(request, writer, next);
             if (!nextCalled)
             {
                 // 中间件没有调用next，停止处理
-                return;
+                return false;
             }
             nextCalled = false;
         }
-        handler(request, writer);
+        return true;
     }
 
     bool HttpServer::staticHandler(const HttpRequest& request, HttpResponseWriter& writer, int writerFd) const
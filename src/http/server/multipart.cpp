@@ -0,0 +1,270 @@
+#include "cppkit/http/server/multipart.hpp"
+#include "cppkit/strings.hpp"
+#include <algorithm>
+#include <stdexcept>
+
+namespace cppkit::http::server
+{
+    MultipartParser::MultipartParser(const std::string_view boundary)
+    {
+        if (boundary.empty() || boundary.size() > 70)
+        {
+            throw std::invalid_argument("Invalid multipart boundary");
+        }
+        _delimiter = "\r\n--";
+        _delimiter.append(boundary);
+        // 第一个分隔符前面可以没有换行，预先放一个换行让所有分隔符形式一致
+        _pending = "\r\n";
+    }
+
+    std::string MultipartParser::boundaryFrom(const std::string_view contentType)
+    {
+        std::string lower;
+        appendLower(lower, contentType);
+        if (!lower.starts_with("multipart/"))
+        {
+            return "";
+        }
+        size_t pos = lower.find("boundary=");
+        if (pos == std::string::npos)
+        {
+            return "";
+        }
+        pos += 9;
+        if (pos < contentType.size() && contentType[pos] == '"')
+        {
+            const size_t end = contentType.find('"', pos + 1);
+            return end == std::string_view::npos ? "" : std::string(contentType.substr(pos + 1, end - pos - 1));
+        }
+        const size_t end = contentType.find_first_of("; \t", pos);
+        return std::string(contentType.substr(pos, end == std::string_view::npos ? end : end - pos));
+    }
+
+    bool MultipartParser::feed(const std::span<const uint8_t> data)
+    {
+        std::string_view in(reinterpret_cast<const char*>(data.data()), data.size());
+        std::string carry; // 切换状态时剩下的数据
+        const size_t d = _delimiter.size();
+
+        while (true)
+        {
+            switch (_state)
+            {
+            case State::Done:
+                return true; // 忽略结尾之后的内容
+            case State::Error:
+                return false;
+            case State::Body:
+                {
+                    if (in.empty())
+                    {
+                        return true;
+                    }
+
+                    // 上一段留下的尾部可能和这一段开头拼成分隔符
+                    if (!_pending.empty())
+                    {
+                        if (in.size() < d)
+                        {
+                            _pending.append(in);
+                            in = {};
+                            if (const size_t pos = _pending.find(_delimiter); pos != std::string::npos)
+                            {
+                                emit(std::string_view(_pending).substr(0, pos));
+                                carry = _pending.substr(pos + d);
+                                _pending.clear();
+                                endPart();
+                                in = carry;
+                                continue;
+                            }
+                            const size_t keep = std::min(_pending.size(), d - 1);
+                            emit(std::string_view(_pending).substr(0, _pending.size() - keep));
+                            _pending.erase(0, _pending.size() - keep);
+                            return true;
+                        }
+
+                        const std::string joined = _pending + std::string(in.substr(0, d));
+                        if (const size_t pos = joined.find(_delimiter); pos < _pending.size())
+                        {
+                            emit(std::string_view(joined).substr(0, pos));
+                            in.remove_prefix(pos + d - _pending.size());
+                            _pending.clear();
+                            endPart();
+                            continue;
+                        }
+                        emit(_pending);
+                        _pending.clear();
+                    }
+
+                    // 直接在输入上查找，内容不经过内部缓冲区
+                    if (const size_t pos = in.find(_delimiter); pos != std::string_view::npos)
+                    {
+                        emit(in.substr(0, pos));
+                        in.remove_prefix(pos + d);
+                        endPart();
+                        continue;
+                    }
+                    const size_t keep = std::min(in.size(), d - 1);
+                    emit(in.substr(0, in.size() - keep));
+                    _pending.assign(in.substr(in.size() - keep));
+                    return true;
+                }
+            default:
+                {
+                    // 分隔符、分隔符后的行尾和部分头都不长，缓存起来整体处理
+                    _pending.append(in);
+                    in = {};
+                    const std::string_view buffered = _pending;
+                    size_t consumed;
+                    if (_state == State::Preamble)
+                    {
+                        const size_t pos = buffered.find(_delimiter);
+                        if (pos == std::string_view::npos)
+                        {
+                            _pending.erase(0, _pending.size() - std::min(_pending.size(), d - 1));
+                            return true;
+                        }
+                        consumed = pos + d;
+                        _state = State::AfterDelimiter;
+                    }
+                    else if (_state == State::AfterDelimiter)
+                    {
+                        if (buffered.size() < 2)
+                        {
+                            return true;
+                        }
+                        if (buffered.starts_with("--"))
+                        {
+                            _state = State::Done;
+                            _pending.clear();
+                            return true;
+                        }
+                        const size_t eol = buffered.find("\r\n");
+                        if (eol == std::string_view::npos)
+                        {
+                            if (buffered.size() > 1024)
+                            {
+                                _state = State::Error;
+                            }
+                            return _state != State::Error;
+                        }
+                        // 分隔符和换行之间只允许空白
+                        if (buffered.substr(0, eol).find_first_not_of(" \t") != std::string_view::npos)
+                        {
+                            _state = State::Error;
+                            return false;
+                        }
+                        consumed = eol + 2;
+                        _state = State::Headers;
+                    }
+                    else
+                    {
+                        if (buffered.starts_with("\r\n"))
+                        {
+                            consumed = 2; // 没有任何头
+                            _part = {};
+                        }
+                        else
+                        {
+                            const size_t pos = buffered.find("\r\n\r\n");
+                            if (pos == std::string_view::npos)
+                            {
+                                if (buffered.size() > MAX_HEADER_SIZE)
+                                {
+                                    _state = State::Error;
+                                }
+                                return _state != State::Error;
+                            }
+                            if (!parseHeaders(buffered.substr(0, pos + 2)))
+                            {
+                                _state = State::Error;
+                                return false;
+                            }
+                            consumed = pos + 4;
+                        }
+                        if (_onPartBegin)
+                        {
+                            _onPartBegin(_part);
+                        }
+                        _state = State::Body;
+                    }
+                    carry = std::string(buffered.substr(consumed));
+                    _pending.clear();
+                    in = carry;
+                }
+            }
+        }
+    }
+
+    void MultipartParser::endPart()
+    {
+        if (_onPartEnd)
+        {
+            _onPartEnd(_part);
+        }
+        _state = State::AfterDelimiter;
+    }
+
+    bool MultipartParser::parseHeaders(const std::string_view raw)
+    {
+        _part = {};
+        size_t cursor = 0;
+        while (cursor < raw.size())
+        {
+            const size_t eol = raw.find("\r\n", cursor);
+            const std::string_view line = raw.substr(cursor, eol - cursor);
+            cursor = eol + 2;
+            const size_t colon = line.find(':');
+            if (colon == std::string_view::npos)
+            {
+                return false;
+            }
+            std::string name;
+            appendLower(name, trimView(line.substr(0, colon)));
+            _part.headers[std::move(name)] = trim(line.substr(colon + 1));
+        }
+
+        if (const auto it = _part.headers.find("content-type"); it != _part.headers.end())
+        {
+            _part.contentType = it->second;
+        }
+
+        // Content-Disposition: form-data; name="field"; filename="a.txt"
+        const auto it = _part.headers.find("content-disposition");
+        if (it == _part.headers.end())
+        {
+            return true;
+        }
+        for (const std::string_view param : splitView(it->second, ';'))
+        {
+            const size_t eq = param.find('=');
+            if (eq == std::string_view::npos)
+            {
+                continue;
+            }
+            const std::string_view key = trimView(param.substr(0, eq));
+            std::string_view value = trimView(param.substr(eq + 1));
+            if (value.size() >= 2 && value.front() == '"' && value.back() == '"')
+            {
+                value = value.substr(1, value.size() - 2);
+            }
+            if (iequals(key, "name"))
+            {
+                _part.name = value;
+            }
+            else if (iequals(key, "filename"))
+            {
+                _part.filename = value;
+            }
+        }
+        return true;
+    }
+
+    void MultipartParser::emit(const std::string_view data) const
+    {
+        if (!data.empty() && _onPartData)
+        {
+            _onPartData(_part, {reinterpret_cast<const uint8_t*>(data.data()), data.size()});
+        }
+    }
+} // namespace cppkit::http::server
@@ -0,0 +1,434 @@
+#include "cppkit/io/async_io.hpp"
+#include <algorithm>
+#include <cerrno>
+#include <condition_variable>
+#include <cstring>
+#include <mutex>
+#include <stdexcept>
+#include <string>
+#include <linux/io_uring.h>
+#include <sys/eventfd.h>
+#include <sys/mman.h>
+#include <sys/syscall.h>
+#include <unistd.h>
+
+namespace cppkit::io
+{
+    // 直接使用系统调用，不依赖 liburing
+    struct IoEngine::Ring
+    {
+        int fd{-1};
+        void* sqPtr{MAP_FAILED};
+        size_t sqSize{0};
+        void* cqPtr{MAP_FAILED};
+        size_t cqSize{0};
+        io_uring_sqe* sqes{static_cast<io_uring_sqe*>(MAP_FAILED)};
+        size_t sqesSize{0};
+
+        unsigned* sqHead{nullptr};
+        unsigned* sqTail{nullptr};
+        unsigned sqMask{0};
+        unsigned* sqArray{nullptr};
+        unsigned* cqHead{nullptr};
+        unsigned* cqTail{nullptr};
+        unsigned cqMask{0};
+        io_uring_cqe* cqes{nullptr};
+
+        ~Ring()
+        {
+            if (sqes != MAP_FAILED)
+                ::munmap(sqes, sqesSize);
+            if (cqPtr != MAP_FAILED && cqPtr != sqPtr)
+                ::munmap(cqPtr, cqSize);
+            if (sqPtr != MAP_FAILED)
+                ::munmap(sqPtr, sqSize);
+            if (fd >= 0)
+                ::close(fd);
+        }
+
+        // 建立 entries 深度的环并检查需要的操作码，失败时返回 nullptr
+        static std::unique_ptr<Ring> create(const unsigned entries, const int eventFd)
+        {
+            io_uring_params params{};
+            auto ring = std::make_unique<Ring>();
+            ring->fd = static_cast<int>(::syscall(__NR_io_uring_setup, entries, &params));
+            if (ring->fd < 0)
+                return nullptr;
+
+            ring->sqSize = params.sq_off.array + params.sq_entries * sizeof(unsigned);
+            ring->cqSize = params.cq_off.cqes + params.cq_entries * sizeof(io_uring_cqe);
+            const bool single = params.features & IORING_FEAT_SINGLE_MMAP;
+            if (single)
+                ring->sqSize = ring->cqSize = std::max(ring->sqSize, ring->cqSize);
+            ring->sqPtr = ::mmap(nullptr, ring->sqSize, PROT_READ | PROT_WRITE, MAP_SHARED | MAP_POPULATE, ring->fd,
+                                 IORING_OFF_SQ_RING);
+            if (ring->sqPtr == MAP_FAILED)
+                return nullptr;
+            ring->cqPtr = single
+                              ? ring->sqPtr
+                              : ::mmap(nullptr, ring->cqSize, PROT_READ | PROT_WRITE, MAP_SHARED | MAP_POPULATE,
+                                       ring->fd, IORING_OFF_CQ_RING);
+            if (ring->cqPtr == MAP_FAILED)
+                return nullptr;
+            ring->sqesSize = params.sq_entries * sizeof(io_uring_sqe);
+            ring->sqes = static_cast<io_uring_sqe*>(::mmap(nullptr, ring->sqesSize, PROT_READ | PROT_WRITE,
+                                                           MAP_SHARED | MAP_POPULATE, ring->fd, IORING_OFF_SQES));
+            if (ring->sqes == MAP_FAILED)
+                return nullptr;
+
+            const auto sq = static_cast<char*>(ring->sqPtr);
+            ring->sqHead = reinterpret_cast<unsigned*>(sq + params.sq_off.head);
+            ring->sqTail = reinterpret_cast<unsigned*>(sq + params.sq_off.tail);
+            ring->sqMask = *reinterpret_cast<unsigned*>(sq + params.sq_off.ring_mask);
+            ring->sqArray = reinterpret_cast<unsigned*>(sq + params.sq_off.array);
+            const auto cq = static_cast<char*>(ring->cqPtr);
+            ring->cqHead = reinterpret_cast<unsigned*>(cq + params.cq_off.head);
+            ring->cqTail = reinterpret_cast<unsigned*>(cq + params.cq_off.tail);
+            ring->cqMask = *reinterpret_cast<unsigned*>(cq + params.cq_off.ring_mask);
+            ring->cqes = reinterpret_cast<io_uring_cqe*>(cq + params.cq_off.cqes);
+
+            // 老内核没有 IORING_OP_READ/WRITE，探测不到时退回线程池
+            std::vector<char> buffer(sizeof(io_uring_probe) + 256 * sizeof(io_uring_probe_op), 0);
+            const auto probe = reinterpret_cast<io_uring_probe*>(buffer.data());
+            if (::syscall(__NR_io_uring_register, ring->fd, IORING_REGISTER_PROBE, probe, 256) < 0)
+                return nullptr;
+            for (const int op : {IORING_OP_READ, IORING_OP_WRITE, IORING_OP_FSYNC})
+            {
+                if (op > probe->last_op || !(probe->ops[op].flags & IO_URING_OP_SUPPORTED))
+                    return nullptr;
+            }
+            if (::syscall(__NR_io_uring_register, ring->fd, IORING_REGISTER_EVENTFD, &eventFd, 1) < 0)
+                return nullptr;
+            return ring;
+        }
+
+        // 在途请求数不超过 SQ 深度，这里不会写满
+        void prepare(const Request& request, const uint32_t slot) const
+        {
+            const unsigned tail = *sqTail;
+            const unsigned index = tail & sqMask;
+            io_uring_sqe* sqe = &sqes[index];
+            std::memset(sqe, 0, sizeof(*sqe));
+            sqe->fd = request.fd;
+            sqe->user_data = slot;
+            switch (request.op)
+            {
+            case Op::READ:
+                sqe->opcode = IORING_OP_READ;
+                break;
+            case Op::WRITE:
+                sqe->opcode = IORING_OP_WRITE;
+                break;
+            case Op::FSYNC:
+                sqe->opcode = IORING_OP_FSYNC;
+                break;
+            case Op::FDATASYNC:
+                sqe->opcode = IORING_OP_FSYNC;
+                sqe->fsync_flags = IORING_FSYNC_DATASYNC;
+                break;
+            }
+            if (request.op == Op::READ || request.op == Op::WRITE)
+            {
+                sqe->addr = reinterpret_cast<uint64_t>(request.buffer);
+                // 长度字段只有 32 位，超出部分表现为短读写
+                sqe->len = static_cast<uint32_t>(std::min<size_t>(request.length, 1u << 30));
+                sqe->off = request.offset;
+            }
+            sqArray[index] = index;
+            __atomic_store_n(sqTail, tail + 1, __ATOMIC_RELEASE);
+        }
+
+        // 把内核还没取走的 SQE 全部提交，wait 为等待完成的个数
+        int enter(const unsigned wait) const
+        {
+            const unsigned pending = *sqTail - __atomic_load_n(sqHead, __ATOMIC_ACQUIRE);
+            const unsigned flags = wait > 0 ? IORING_ENTER_GETEVENTS : 0;
+            return static_cast<int>(::syscall(__NR_io_uring_enter, fd, pending, wait, flags, nullptr, 0));
+        }
+
+        template <typename Fn>
+        void reap(Fn&& fn) const
+        {
+            unsigned head = *cqHead;
+            const unsigned tail = __atomic_load_n(cqTail, __ATOMIC_ACQUIRE);
+            for (; head != tail; ++head)
+            {
+                const io_uring_cqe& cqe = cqes[head & cqMask];
+                fn(static_cast<uint32_t>(cqe.user_data), static_cast<ssize_t>(cqe.res));
+            }
+            __atomic_store_n(cqHead, head, __ATOMIC_RELEASE);
+        }
+    };
+
+    // 线程池后端的完成队列，工作线程写入后通过 eventfd 通知事件循环
+    struct IoEngine::Completions
+    {
+        std::mutex mutex;
+        std::condition_variable idle;
+        std::vector<std::pair<uint32_t, ssize_t>> done;
+        size_t outstanding{0}; // 已交给线程池尚未写回的请求数
+        int eventFd{-1};
+    };
+
+    void IoEngine::Awaiter::await_suspend(const std::coroutine_handle<> handle)
+    {
+        _engine->enqueue(Request{_op, _fd, _buffer, _length, _offset, [this, handle](const ssize_t result)
+        {
+            _result = result;
+            handle.resume();
+        }});
+    }
+
+    IoEngine::IoEngine(event::EventLoop* loop, const IoEngineConfig& config)
+        : _loop(loop), _queueDepth(std::clamp(config.queueDepth, 1u, 4096u))
+    {
+        _eventFd = ::eventfd(0, EFD_NONBLOCK | EFD_CLOEXEC);
+        if (_eventFd < 0)
+        {
+            throw std::runtime_error(std::string("eventfd failed: ") + std::strerror(errno));
+        }
+
+        if (config.backend != IoBackend::THREAD_POOL)
+        {
+            _ring = Ring::create(_queueDepth, _eventFd);
+            if (!_ring && config.backend == IoBackend::IO_URING)
+            {
+                ::close(_eventFd);
+                throw std::runtime_error("io_uring is not available");
+            }
+        }
+        if (!_ring)
+        {
+            _completions = std::make_shared<Completions>();
+            _completions->eventFd = _eventFd;
+            _pool = config.executor;
+            if (!_pool)
+            {
+                _ownPool = std::make_unique<concurrency::ThreadPool>(std::max<size_t>(config.fallbackThreads, 1));
+                _pool = _ownPool.get();
+            }
+            _poolThreads = std::max<size_t>(_pool->workerCount(), 1);
+        }
+
+        _slots.resize(_queueDepth);
+        _freeSlots.reserve(_queueDepth);
+        for (uint32_t slot = _queueDepth; slot > 0; --slot)
+        {
+            _freeSlots.push_back(slot - 1);
+        }
+        _loop->createFileEvent(_eventFd, event::AE_READABLE, [this](int, int) { this->onCompletion(); });
+    }
+
+    IoEngine::~IoEngine()
+    {
+        if (_submitEvent >= 0)
+        {
+            _loop->deleteTimeEvent(_submitEvent);
+        }
+        _loop->deleteFileEvent(_eventFd, event::AE_READABLE);
+
+        // 内核或工作线程还可能在写调用方的缓冲区，必须等它们结束
+        if (_ring)
+        {
+            size_t remaining = _inflight;
+            while (remaining > 0)
+            {
+                if (_ring->enter(1) < 0 && errno != EINTR)
+                    break;
+                _ring->reap([&remaining](uint32_t, ssize_t) { --remaining; });
+            }
+        }
+        else
+        {
+            std::unique_lock lock(_completions->mutex);
+            _completions->idle.wait(lock, [this] { return _completions->outstanding == 0; });
+        }
+        _ring.reset();
+        ::close(_eventFd);
+    }
+
+    void IoEngine::read(const int fd, void* buffer, const size_t length, const uint64_t offset, IoCallback callback)
+    {
+        enqueue(Request{Op::READ, fd, buffer, length, offset, std::move(callback)});
+    }
+
+    void IoEngine::write(const int fd, const void* buffer, const size_t length, const uint64_t offset,
+                         IoCallback callback)
+    {
+        enqueue(Request{Op::WRITE, fd, const_cast<void*>(buffer), length, offset, std::move(callback)});
+    }
+
+    void IoEngine::fsync(const int fd, const bool dataOnly, IoCallback callback)
+    {
+        enqueue(Request{dataOnly ? Op::FDATASYNC : Op::FSYNC, fd, nullptr, 0, 0, std::move(callback)});
+    }
+
+    IoEngine::Awaiter IoEngine::read(const int fd, void* buffer, const size_t length, const uint64_t offset)
+    {
+        return {this, Op::READ, fd, buffer, length, offset};
+    }
+
+    IoEngine::Awaiter IoEngine::write(const int fd, const void* buffer, const size_t length, const uint64_t offset)
+    {
+        return {this, Op::WRITE, fd, const_cast<void*>(buffer), length, offset};
+    }
+
+    IoEngine::Awaiter IoEngine::fsync(const int fd, const bool dataOnly)
+    {
+        return {this, dataOnly ? Op::FDATASYNC : Op::FSYNC, fd, nullptr, 0, 0};
+    }
+
+    void IoEngine::enqueue(Request request)
+    {
+        _backlog.push_back(std::move(request));
+        // 本轮事件循环中的请求在结束前一起提交
+        if (_submitEvent < 0)
+        {
+            _submitEvent = _loop->createTimeEvent(0, [this](int64_t) -> int64_t
+            {
+                _submitEvent = -1;
+                this->submit();
+                return 0;
+            });
+        }
+    }
+
+    void IoEngine::submit()
+    {
+        std::vector<std::pair<uint32_t, Request>> batch;
+        unsigned prepared = 0;
+        while (!_backlog.empty() && _inflight < _queueDepth)
+        {
+            Request request = std::move(_backlog.front());
+            _backlog.pop_front();
+            const uint32_t slot = _freeSlots.back();
+            _freeSlots.pop_back();
+            _slots[slot] = std::move(request.callback);
+            ++_inflight;
+            if (_ring)
+            {
+                _ring->prepare(request, slot);
+                ++prepared;
+            }
+            else
+            {
+                batch.emplace_back(slot, std::move(request));
+            }
+        }
+
+        if (_ring)
+        {
+            // 提交失败的 SQE 留在环里，下一次 enter 会一起提交
+            if (prepared > 0 && _ring->enter(0) < 0 && _submitEvent < 0)
+            {
+                _submitEvent = _loop->createTimeEvent(1, [this](int64_t) -> int64_t
+                {
+                    _submitEvent = -1;
+                    this->submit();
+                    return 0;
+                });
+            }
+            return;
+        }
+        if (batch.empty())
+        {
+            return;
+        }
+
+        // 按线程数切成几个任务，避免每个小请求一次入队和唤醒
+        {
+            std::lock_guard lock(_completions->mutex);
+            _completions->outstanding += batch.size();
+        }
+        const size_t per = (batch.size() + _poolThreads - 1) / _poolThreads;
+        for (size_t begin = 0; begin < batch.size(); begin += per)
+        {
+            auto part = std::make_shared<std::vector<std::pair<uint32_t, Request>>>(
+                std::make_move_iterator(batch.begin() + static_cast<ptrdiff_t>(begin)),
+                std::make_move_iterator(batch.begin() + static_cast<ptrdiff_t>(std::min(begin + per, batch.size()))));
+            (void)_pool->enqueue([part, completions = _completions]
+            {
+                std::vector<std::pair<uint32_t, ssize_t>> results;
+                results.reserve(part->size());
+                for (const auto& [slot, request] : *part)
+                {
+                    results.emplace_back(slot, execute(request));
+                }
+                std::lock_guard lock(completions->mutex);
+                const bool wasEmpty = completions->done.empty();
+                completions->done.insert(completions->done.end(), results.begin(), results.end());
+                if (wasEmpty)
+                {
+                    constexpr uint64_t one = 1;
+                    (void)::write(completions->eventFd, &one, sizeof(one));
+                }
+                completions->outstanding -= results.size();
+                completions->idle.notify_all();
+            });
+        }
+    }
+
+    ssize_t IoEngine::execute(const Request& request)
+    {
+        ssize_t n;
+        do
+        {
+            switch (request.op)
+            {
+            case Op::READ:
+                n = ::pread(request.fd, request.buffer, request.length, static_cast<off_t>(request.offset));
+                break;
+            case Op::WRITE:
+                n = ::pwrite(request.fd, request.buffer, request.length, static_cast<off_t>(request.offset));
+                break;
+            case Op::FSYNC:
+                n = ::fsync(request.fd);
+                break;
+            default:
+                n = ::fdatasync(request.fd);
+                break;
+            }
+        }
+        while (n < 0 && errno == EINTR);
+        return n < 0 ? -errno : n;
+    }
+
+    void IoEngine::onCompletion()
+    {
+        uint64_t count;
+        (void)::read(_eventFd, &count, sizeof(count));
+
+        std::vector<std::pair<uint32_t, ssize_t>> done;
+        if (_ring)
+        {
+            _ring->reap([&done](const uint32_t slot, const ssize_t result) { done.emplace_back(slot, result); });
+        }
+        else
+        {
+            std::lock_guard lock(_completions->mutex);
+            done.swap(_completions->done);
+        }
+
+        // 先释放槽位并补充排队的请求，再执行回调，回调里新提交的请求留到本轮结束时合并提交
+        std::vector<std::pair<IoCallback, ssize_t>> callbacks;
+        callbacks.reserve(done.size());
+        for (const auto& [slot, result] : done)
+        {
+            callbacks.emplace_back(std::move(_slots[slot]), result);
+            _slots[slot] = nullptr;
+            _freeSlots.push_back(slot);
+            --_inflight;
+        }
+        if (!_backlog.empty())
+        {
+            submit();
+        }
+        for (auto& [callback, result] : callbacks)
+        {
+            if (callback)
+            {
+                callback(result);
+            }
+        }
+    }
+} // namespace cppkit::io
@@ -1,12 +1,14 @@
 #include "cppkit/io/file.hpp"
+#include <cerrno>
 #include <filesystem>
 #include <fstream>
 #include <iostream>
 #include <string>
+#include <utility>
 #include <vector>
-#include <sys/fcntl.h>
-#include <sys/mman.h>
+#include <fcntl.h>
 #include <sys/stat.h>
+#include <unistd.h>
 
 namespace cppkit::io
 {
@@ -198,113 +200,197 @@ namespace cppkit::io
         }
     }
 
-    size_t File::read(char* buffer, const size_t size, const size_t offset) const
+    File::File(File&& other) noexcept : _path(std::move(other._path)), _fd(std::exchange(other._fd, -1))
     {
-        if (!this->open())
+    }
+
+    File& File::operator=(File&& other) noexcept
+    {
+        if (this != &other)
         {
-            return -1;
+            this->close();
+            _path = std::move(other._path);
+            _fd = std::exchange(other._fd, -1);
         }
+        return *this;
+    }
 
-        const auto fileSize = this->size();
+    File::~File()
+    {
+        this->close();
+    }
 
-        if (offset >= fileSize)
+    size_t File::read(char* buffer, const size_t size, const size_t offset) const
+    {
+        if (!this->open())
         {
-            return 0;
+            return -1;
         }
 
-        if (static_cast<size_t>(_ifs.tellg()) != offset)
+        size_t total = 0;
+        while (total < size)
         {
-            _ifs.seekg(static_cast<std::streamoff>(offset), std::ios::beg);
+            const ssize_t n = ::pread(_fd, buffer + total, size - total, static_cast<off_t>(offset + total));
+            if (n < 0)
+            {
+                if (errno == EINTR)
+                    continue;
+                return -1;
+            }
+            if (n == 0) // 到达文件末尾
+                break;
+            total += n;
         }
-
-        _ifs.read(buffer, static_cast<std::streamsize>(std::min(fileSize - offset, size)));
-        if (!_ifs && !_ifs.eof())
-            return -1;
-
-        return _ifs.gcount();
+        return total;
     }
 
-    size_t File::write(const char* buffer, const size_t size, const size_t offset, const bool append) const
+    size_t File::write(const char* buffer, const size_t size, size_t offset, const bool append) const
     {
         if (!this->open())
         {
             return -1;
         }
         if (append)
-            _ofs.seekp(static_cast<std::streamsize>(offset), std::ios::end);
-        else
-            _ofs.seekp(static_cast<std::streamsize>(offset), std::ios::beg);
-        _ofs.write(buffer, static_cast<std::streamsize>(size));
-        if (!_ofs)
-            return -1;
-        _ofs.flush();
-        return static_cast<ssize_t>(size);
+        {
+            struct stat st{};
+            if (::fstat(_fd, &st) < 0)
+                return -1;
+            offset += st.st_size;
+        }
+
+        size_t total = 0;
+        while (total < size)
+        {
+            const ssize_t n = ::pwrite(_fd, buffer + total, size - total, static_cast<off_t>(offset + total));
+            if (n < 0)
+            {
+                if (errno == EINTR)
+                    continue;
+                return -1;
+            }
+            total += n;
+        }
+        return total;
     }
 
     size_t File::read(const std::function<void(const char*, ssize_t)>& fun, size_t offset, const int chunk) const
     {
-        const int fd = ::open(this->getAbsolutePath().c_str(), O_RDONLY);
-        if (fd < 0)
+        if (!this->open())
         {
-            return fd;
+            return -1;
         }
         struct stat st{};
-        fstat(fd, &st);
-        const size_t filesize = st.st_size;
+        if (::fstat(_fd, &st) < 0)
+        {
+            return -1;
+        }
+        const auto filesize = static_cast<size_t>(st.st_size);
+        if (offset >= filesize)
+        {
+            return 0;
+        }
+        (void)::posix_fadvise(_fd, static_cast<off_t>(offset), 0, POSIX_FADV_SEQUENTIAL);
 
-        const long page_size = sysconf(_SC_PAGE_SIZE);
+        // 每个窗口只做一次 mmap/munmap，窗口大小取 chunk 的整数倍，回调的分块与逐块映射时一致
+        const size_t step = chunk > 0 ? static_cast<size_t>(chunk) : DEFAULT_BUFFER_SIZE;
+        const size_t window = std::max(step, DEFAULT_MAP_WINDOW / step * step);
         size_t total{};
 
         while (offset < filesize)
         {
-            const size_t bytes = std::min(static_cast<size_t>(chunk), filesize - offset);
-
-            // 计算页对齐的偏移
-            const size_t page_offset = offset & ~(page_size - 1);
-            const size_t delta = offset - page_offset;
-
-            // mmap 需要映射的大小 = delta + chunk
-            const size_t map_length = delta + bytes;
-
-            void* addr = mmap(nullptr, map_length, PROT_READ, MAP_PRIVATE, fd, static_cast<ssize_t>(page_offset));
-            if (addr == MAP_FAILED)
+            MappedFile mapped;
+            try
             {
-                perror("mmap fail");
-                ::close(fd);
+                mapped = MappedFile(_fd, offset, std::min(window, filesize - offset));
+            }
+            catch (const std::runtime_error& e)
+            {
+                std::cerr << e.what() << std::endl;
                 return -1;
             }
+            if (mapped.empty()) // 读取过程中文件被截断
+            {
+                break;
+            }
 
-            // 取真正需要的数据位置
-            const char* data = static_cast<char*>(addr) + delta;
-            fun(data, static_cast<ssize_t>(bytes));
-
-            munmap(addr, map_length);
-            offset += bytes;
-            total += bytes;
+            const auto data = reinterpret_cast<const char*>(mapped.data());
+            for (size_t pos = 0; pos < mapped.size(); pos += step)
+            {
+                fun(data + pos, static_cast<ssize_t>(std::min(step, mapped.size() - pos)));
+            }
+            offset += mapped.size();
+            total += mapped.size();
         }
-        ::close(fd);
         return total;
     }
 
+    void File::readahead(const size_t offset, const size_t length) const
+    {
+        if (this->open())
+        {
+            (void)::posix_fadvise(_fd, static_cast<off_t>(offset), static_cast<off_t>(length), POSIX_FADV_WILLNEED);
+        }
+    }
+
+    MappedFile File::map(const MapOptions& options) const
+    {
+        return MappedFile(_path.string(), options);
+    }
+
+    void File::readAsync(IoEngine& engine, char* buffer, const size_t size, const size_t offset,
+                         IoCallback callback) const
+    {
+        engine.read(this->open() ? _fd : -1, buffer, size, offset, std::move(callback));
+    }
+
+    void File::writeAsync(IoEngine& engine, const char* buffer, const size_t size, const size_t offset,
+                          IoCallback callback) const
+    {
+        engine.write(this->open() ? _fd : -1, buffer, size, offset, std::move(callback));
+    }
+
+    void File::fsyncAsync(IoEngine& engine, IoCallback callback, const bool dataOnly) const
+    {
+        engine.fsync(this->open() ? _fd : -1, dataOnly, std::move(callback));
+    }
+
+    IoEngine::Awaiter File::readAsync(IoEngine& engine, char* buffer, const size_t size, const size_t offset) const
+    {
+        return engine.read(this->open() ? _fd : -1, buffer, size, offset);
+    }
+
+    IoEngine::Awaiter File::writeAsync(IoEngine& engine, const char* buffer, const size_t size,
+                                       const size_t offset) const
+    {
+        return engine.write(this->open() ? _fd : -1, buffer, size, offset);
+    }
+
+    IoEngine::Awaiter File::fsyncAsync(IoEngine& engine, const bool dataOnly) const
+    {
+        return engine.fsync(this->open() ? _fd : -1, dataOnly);
+    }
+
     bool File::open() const
     {
-        if (_isOpen) // 已经打开
+        if (_fd >= 0) // 已经打开
         {
             return true;
         }
-        _ifs.open(_path, std::ios::binary);
-        _ofs.open(_path, std::ios::binary | std::ios::in | std::ios::out);
-
-        _isOpen = _ifs.is_open() && _ofs.is_open();
-        return _isOpen;
+        // 优先读写打开，没有写权限时退化为只读，此时 write 返回 -1
+        _fd = ::open(_path.c_str(), O_RDWR | O_CLOEXEC);
+        if (_fd < 0 && (errno == EACCES || errno == EROFS || errno == ETXTBSY))
+        {
+            _fd = ::open(_path.c_str(), O_RDONLY | O_CLOEXEC);
+        }
+        return _fd >= 0;
     }
 
     void File::close() const
     {
-        if (_ifs.is_open())
-            _ifs.close();
-        if (_ofs.is_open())
-            _ofs.close();
-        _isOpen = false;
+        if (_fd >= 0)
+        {
+            ::close(_fd);
+            _fd = -1;
+        }
     }
 } // namespace cppkit::io
@@ -0,0 +1,153 @@
+#include "cppkit/io/mapped_file.hpp"
+#include <algorithm>
+#include <cerrno>
+#include <cstring>
+#include <stdexcept>
+#include <utility>
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+namespace cppkit::io
+{
+    static size_t pageSize()
+    {
+        static const auto size = static_cast<size_t>(sysconf(_SC_PAGE_SIZE));
+        return size;
+    }
+
+    static int openReadOnly(const std::string& path)
+    {
+        const int fd = ::open(path.c_str(), O_RDONLY | O_CLOEXEC);
+        if (fd < 0)
+        {
+            throw std::runtime_error("Failed to open " + path + ": " + std::strerror(errno));
+        }
+        return fd;
+    }
+
+    MappedFile::MappedFile(const std::string& path, const MapOptions& options)
+        : MappedFile(path, 0, SIZE_MAX, options)
+    {
+    }
+
+    MappedFile::MappedFile(const std::string& path, const size_t offset, const size_t length,
+                           const MapOptions& options)
+    {
+        const int fd = openReadOnly(path);
+        try
+        {
+            map(fd, offset, length, options);
+        }
+        catch (...)
+        {
+            ::close(fd);
+            throw;
+        }
+        ::close(fd);
+    }
+
+    MappedFile::MappedFile(const int fd, const size_t offset, const size_t length, const MapOptions& options)
+    {
+        map(fd, offset, length, options);
+    }
+
+    MappedFile::MappedFile(MappedFile&& other) noexcept
+        : _base(std::exchange(other._base, nullptr)),
+          _mapLength(std::exchange(other._mapLength, 0)),
+          _data(std::exchange(other._data, nullptr)),
+          _size(std::exchange(other._size, 0)),
+          _offset(std::exchange(other._offset, 0))
+    {
+    }
+
+    MappedFile& MappedFile::operator=(MappedFile&& other) noexcept
+    {
+        if (this != &other)
+        {
+            unmap();
+            _base = std::exchange(other._base, nullptr);
+            _mapLength = std::exchange(other._mapLength, 0);
+            _data = std::exchange(other._data, nullptr);
+            _size = std::exchange(other._size, 0);
+            _offset = std::exchange(other._offset, 0);
+        }
+        return *this;
+    }
+
+    MappedFile::~MappedFile()
+    {
+        unmap();
+    }
+
+    void MappedFile::map(const int fd, const size_t offset, size_t length, const MapOptions& options)
+    {
+        struct stat st{};
+        if (::fstat(fd, &st) < 0)
+        {
+            throw std::runtime_error(std::string("fstat failed: ") + std::strerror(errno));
+        }
+        const auto fileSize = static_cast<size_t>(st.st_size);
+        _offset = offset;
+        if (offset >= fileSize)
+        {
+            return; // 空文件或越界：空映射
+        }
+        length = std::min(length, fileSize - offset);
+
+        // mmap 的偏移必须页对齐，多映射前面的 delta 字节
+        const size_t pageOffset = offset & ~(pageSize() - 1);
+        const size_t delta = offset - pageOffset;
+        const int flags = MAP_PRIVATE | (options.populate ? MAP_POPULATE : 0);
+        void* addr = ::mmap(nullptr, delta + length, PROT_READ, flags, fd, static_cast<off_t>(pageOffset));
+        if (addr == MAP_FAILED)
+        {
+            throw std::runtime_error(std::string("mmap failed: ") + std::strerror(errno));
+        }
+        _base = addr;
+        _mapLength = delta + length;
+        _data = static_cast<const uint8_t*>(addr) + delta;
+        _size = length;
+
+        // 提示失败不影响映射本身，忽略返回值
+        if (options.sequential)
+        {
+            (void)::madvise(_base, _mapLength, MADV_SEQUENTIAL);
+        }
+        if (options.willNeed)
+        {
+            (void)::madvise(_base, _mapLength, MADV_WILLNEED);
+        }
+#ifdef MADV_HUGEPAGE
+        if (options.hugePages)
+        {
+            (void)::madvise(_base, _mapLength, MADV_HUGEPAGE);
+        }
+#endif
+    }
+
+    void MappedFile::willNeed(const size_t offset, size_t length) const
+    {
+        if (offset >= _size)
+        {
+            return;
+        }
+        length = std::min(length, _size - offset);
+        const auto begin = reinterpret_cast<uintptr_t>(_data + offset);
+        const uintptr_t aligned = begin & ~(pageSize() - 1);
+        (void)::madvise(reinterpret_cast<void*>(aligned), begin + length - aligned, MADV_WILLNEED);
+    }
+
+    void MappedFile::unmap()
+    {
+        if (_base)
+        {
+            ::munmap(_base, _mapLength);
+        }
+        _base = nullptr;
+        _mapLength = 0;
+        _data = nullptr;
+        _size = 0;
+    }
+} // namespace cppkit::io
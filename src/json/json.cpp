@@ -1,439 +1,1152 @@
 #include "cppkit/json/json.hpp"
+#include <algorithm>
+#include <memory>
 
 namespace cppkit::json
 {
-    std::string Json::dump(const bool pretty, const int indent_size) const
+    Json::Type Json::type() const noexcept
     {
-        std::ostringstream oss;
-        if (pretty)
-            dumpPretty(oss, 0, indent_size);
-        else
-            dumpCompact(oss);
-        return oss.str();
+        static constexpr Type types[] = {Type::Null, Type::Bool, Type::Int, Type::Uint, Type::Double,
+                                         Type::String, Type::String, Type::String, Type::Array, Type::Object};
+        return types[kind()];
     }
 
-    void Json::escapeString(std::ostream& os, const std::string& s)
+    double Json::asNumber() const
     {
-        os << '"';
-        for (unsigned char c : s)
+        switch (kind())
         {
-            switch (c)
-            {
-            case '"':
-                os << "\\\"";
-                break;
-            case '\\':
-                os << "\\\\";
-                break;
-            case '\b':
-                os << "\\b";
-                break;
-            case '\f':
-                os << "\\f";
-                break;
-            case '\n':
-                os << "\\n";
-                break;
-            case '\r':
-                os << "\\r";
-                break;
-            case '\t':
-                os << "\\t";
-                break;
-            default:
-                if (c < 0x20)
-                {
-                    os << "\\u" << std::hex << std::uppercase << std::setw(4) << std::setfill('0') << (int)c <<
-                        std::dec
-                        << std::nouppercase;
-                }
-                else
-                    os << c;
-            }
+        case kInt:
+            return static_cast<double>(load<int64_t>());
+        case kUint:
+            return static_cast<double>(load<uint64_t>());
+        case kDouble:
+            return load<double>();
+        default:
+            throw std::runtime_error("json: not a number");
         }
-        os << '"';
     }
 
-    void Json::dumpCompact(std::ostream& os) const
+    int64_t Json::asInt64() const
     {
-        if (isNull())
+        switch (kind())
         {
-            os << "null";
-            return;
+        case kInt:
+            return load<int64_t>();
+        case kUint:
+            return static_cast<int64_t>(load<uint64_t>());
+        case kDouble:
+            return static_cast<int64_t>(load<double>());
+        default:
+            throw std::runtime_error("json: not a number");
         }
-        if (isBool())
+    }
+
+    uint64_t Json::asUint64() const
+    {
+        switch (kind())
         {
-            os << (asBool() ? "true" : "false");
-            return;
+        case kInt:
+            return static_cast<uint64_t>(load<int64_t>());
+        case kUint:
+            return load<uint64_t>();
+        case kDouble:
+            return static_cast<uint64_t>(load<double>());
+        default:
+            throw std::runtime_error("json: not a number");
         }
-        if (isNumber())
+    }
+
+    std::string& Json::asString()
+    {
+        if (kind() != kStdString)
         {
-            double d = asNumber();
-            // write minimal representation
-            std::ostringstream tmp;
-            tmp << std::setprecision(15) << d;
-            os << tmp.str();
+            // 原存储在 arena 中时不释放，所在容器取得可写引用时已把 arena 标记为 dirty，会随根节点释放
+            auto* s = new std::string(std::as_const(*this).asString());
+            destroy();
+            store(kStdString, s);
+        }
+        return *load<std::string*>();
+    }
+
+    void Json::setString(const std::string_view s, internal::JsonArena* arena)
+    {
+        if (s.size() <= kSmallStringSize)
+        {
+            std::memset(data_, 0, sizeof(data_));
+            std::memcpy(data_, s.data(), s.size());
+            data_[kSmallLengthOffset] = static_cast<unsigned char>(s.size());
+            tag_ = kSmallString;
             return;
         }
-        if (isString())
+        if (s.size() > UINT32_MAX)
+            throw std::length_error("json: string too long");
+        char* p;
+        if (arena)
+        {
+            p = arena->copyString(s);
+        }
+        else
         {
-            escapeString(os, asString());
+            p = new char[s.size() + 1];
+            std::memcpy(p, s.data(), s.size());
+            p[s.size()] = '\0';
+        }
+        store(kString, p);
+        const auto n = static_cast<uint32_t>(s.size());
+        std::memcpy(data_ + kLengthOffset, &n, sizeof(n));
+        if (arena)
+            tag_ |= kInArena;
+    }
+
+    void Json::copyFrom(const Json& other)
+    {
+        switch (other.kind())
+        {
+        case kString:
+        case kStdString:
+            setString(other.asString(), nullptr);
+            break;
+        case kArray:
+            setNull();
+            setArray(new JsonArray(*other.load<const JsonArray*>()), 0);
+            break;
+        case kObject:
+            setNull();
+            setObject(new JsonObject(*other.load<const JsonObject*>()), 0);
+            break;
+        default:
+            std::memcpy(data_, other.data_, sizeof(data_));
+            tag_ = other.kind();
+        }
+    }
+
+    void Json::moveFrom(Json& other)
+    {
+        // arena 中的存储不能被转移所有权，只能深拷贝
+        if ((other.tag_ & kInArena) != 0)
+        {
+            copyFrom(other);
             return;
         }
-        if (isArray())
+        std::memcpy(static_cast<void*>(this), static_cast<void*>(&other), sizeof(Json));
+        other.setNull();
+    }
+
+    void Json::destroy() noexcept
+    {
+        if ((tag_ & kInArena) != 0)
+            return;
+        switch (kind())
         {
-            os << '[';
-            const auto& a = asArray();
-            for (size_t i = 0; i < a.size(); ++i)
+        case kString:
+            delete[] load<char*>();
+            break;
+        case kStdString:
+            delete load<std::string*>();
+            break;
+        case kArray:
+            if ((tag_ & kArenaRoot) != 0)
             {
-                if (i)
-                    os << ',';
-                a[i].dumpCompact(os);
+                internal::JsonArena* arena = load<JsonArray*>()->arena_;
+                if (arena->dirty)
+                    releaseForeign(*this);
+                delete arena;
             }
-            os << ']';
-            return;
+            else
+            {
+                delete load<JsonArray*>();
+            }
+            break;
+        case kObject:
+            if ((tag_ & kArenaRoot) != 0)
+            {
+                internal::JsonArena* arena = load<JsonObject*>()->arena_;
+                if (arena->dirty)
+                    releaseForeign(*this);
+                delete arena;
+            }
+            else
+            {
+                delete load<JsonObject*>();
+            }
+            break;
+        default:
+            break;
         }
-        if (isObject())
+        setNull();
+    }
+
+    void Json::releaseForeign(Json& node) noexcept
+    {
+        auto release = [](Json& child)
+        {
+            if ((child.tag_ & kInArena) == 0)
+                child.destroy();
+            else if (child.isArray() || child.isObject())
+                releaseForeign(child);
+        };
+        if (node.isArray())
         {
-            os << '{';
-            const auto& o = asObject();
-            bool first = true;
-            for (const auto& p : o)
+            for (auto& child : *node.load<JsonArray*>())
+                release(child);
+        }
+        else if (node.isObject())
+        {
+            for (auto& [key, value] : *node.load<JsonObject*>())
             {
-                if (!first)
-                    os << ',';
-                first = false;
-                escapeString(os, p.first);
-                os << ':';
-                p.second.dumpCompact(os);
+                release(key.node_);
+                release(value);
             }
-            os << '}';
         }
     }
 
-    void Json::dumpPretty(std::ostream& os, const int depth, const int indentSize) const
+    bool operator==(const Json& lhs, const Json& rhs)
     {
-        const std::string indent(depth * indentSize, ' ');
-        if (isNull())
+        if (lhs.isNumber() && rhs.isNumber())
         {
-            os << "null";
-            return;
+            if (lhs.isDouble() || rhs.isDouble())
+                return lhs.asNumber() == rhs.asNumber();
+            return lhs.kind() == rhs.kind() && lhs.asInt64() == rhs.asInt64();
         }
-        if (isBool())
+        if (lhs.type() != rhs.type())
+            return false;
+        switch (lhs.type())
         {
-            os << (asBool() ? "true" : "false");
-            return;
+        case Json::Type::Null:
+            return true;
+        case Json::Type::Bool:
+            return lhs.asBool() == rhs.asBool();
+        case Json::Type::String:
+            return lhs.asString() == rhs.asString();
+        case Json::Type::Array:
+            return lhs.asArray() == rhs.asArray();
+        case Json::Type::Object:
+            return lhs.asObject() == rhs.asObject();
+        default:
+            return false;
         }
-        if (isNumber())
+    }
+
+    // ---------------- JsonArray ----------------
+
+    JsonArray::JsonArray(const std::initializer_list<Json> items)
+    {
+        reserve(items.size());
+        for (const auto& item : items)
+            emplace_back(item);
+    }
+
+    JsonArray::JsonArray(const JsonArray& other)
+    {
+        reserve(other.size_);
+        for (const auto& item : other)
+            new(data_ + size_++) Json(item);
+    }
+
+    JsonArray::JsonArray(JsonArray&& other)
+    {
+        if (other.arena_)
         {
-            std::ostringstream tmp;
-            tmp << std::setprecision(15) << asNumber();
-            os << tmp.str();
+            reserve(other.size_);
+            for (const auto& item : std::as_const(other))
+                new(data_ + size_++) Json(item);
+            return;
+        }
+        data_ = other.data_;
+        size_ = other.size_;
+        capacity_ = other.capacity_;
+        other.data_ = nullptr;
+        other.size_ = other.capacity_ = 0;
+    }
+
+    JsonArray::~JsonArray()
+    {
+        if (arena_)
             return;
+        for (uint32_t i = 0; i < size_; ++i)
+            data_[i].~Json();
+        ::operator delete(data_);
+    }
+
+    JsonArray& JsonArray::operator=(const JsonArray& other)
+    {
+        if (this != &other)
+        {
+            JsonArray tmp(other);
+            *this = std::move(tmp);
+        }
+        return *this;
+    }
+
+    JsonArray& JsonArray::operator=(JsonArray&& other)
+    {
+        if (this == &other)
+            return *this;
+        clear();
+        if (!arena_ && !other.arena_)
+        {
+            ::operator delete(data_);
+            data_ = other.data_;
+            size_ = other.size_;
+            capacity_ = other.capacity_;
+            other.data_ = nullptr;
+            other.size_ = other.capacity_ = 0;
+            return *this;
+        }
+        reserve(other.size_);
+        for (auto& item : other)
+            new(data_ + size_++) Json(std::move(item));
+        return *this;
+    }
+
+    void JsonArray::reserve(const size_t n)
+    {
+        if (n > capacity_)
+            grow(n);
+    }
+
+    void JsonArray::clear() noexcept
+    {
+        touch();
+        for (uint32_t i = 0; i < size_; ++i)
+            data_[i].~Json();
+        size_ = 0;
+    }
+
+    Json& JsonArray::at(const size_t i)
+    {
+        if (i >= size_)
+            throw std::out_of_range("json: array index out of range");
+        return (*this)[i];
+    }
+
+    const Json& JsonArray::at(const size_t i) const
+    {
+        if (i >= size_)
+            throw std::out_of_range("json: array index out of range");
+        return data_[i];
+    }
+
+    void JsonArray::pop_back() noexcept
+    {
+        touch();
+        data_[--size_].~Json();
+    }
+
+    JsonArray::iterator JsonArray::erase(const const_iterator pos)
+    {
+        touch();
+        const auto idx = static_cast<size_t>(pos - data_);
+        data_[idx].~Json();
+        std::memmove(static_cast<void*>(data_ + idx), data_ + idx + 1, (size_ - idx - 1) * sizeof(Json));
+        --size_;
+        return data_ + idx;
+    }
+
+    void JsonArray::grow(const size_t need)
+    {
+        if (need > UINT32_MAX)
+            throw std::length_error("json: array too large");
+        const size_t cap = std::max<size_t>({need, static_cast<size_t>(capacity_) * 2, 4});
+        Json* next = arena_
+                         ? arena_->allocateArray<Json>(cap)
+                         : static_cast<Json*>(::operator new(cap * sizeof(Json)));
+        if (size_)
+            std::memcpy(static_cast<void*>(next), static_cast<void*>(data_), size_ * sizeof(Json));
+        if (!arena_)
+            ::operator delete(data_);
+        data_ = next;
+        capacity_ = static_cast<uint32_t>(std::min<size_t>(cap, UINT32_MAX));
+    }
+
+    bool operator==(const JsonArray& lhs, const JsonArray& rhs)
+    {
+        return std::equal(lhs.begin(), lhs.end(), rhs.begin(), rhs.end());
+    }
+
+    // ---------------- JsonObject ----------------
+
+    JsonObject::JsonObject(const JsonObject& other)
+    {
+        reserve(other.size_);
+        for (const auto& [key, value] : other)
+        {
+            auto* member = new(data_ + size_++) JsonMember();
+            member->first.node_.setString(key.view(), nullptr);
+            member->second = value;
         }
-        if (isString())
+        rebuildIndex();
+    }
+
+    JsonObject::JsonObject(JsonObject&& other)
+    {
+        if (other.arena_)
         {
-            escapeString(os, asString());
+            *this = std::as_const(other);
             return;
         }
-        if (isArray())
+        data_ = other.data_;
+        size_ = other.size_;
+        capacity_ = other.capacity_;
+        index_ = other.index_;
+        indexMask_ = other.indexMask_;
+        other.data_ = nullptr;
+        other.index_ = nullptr;
+        other.size_ = other.capacity_ = other.indexMask_ = 0;
+    }
+
+    JsonObject::~JsonObject()
+    {
+        if (arena_)
+            return;
+        for (uint32_t i = 0; i < size_; ++i)
+            data_[i].~JsonMember();
+        ::operator delete(data_);
+        delete[] index_;
+    }
+
+    JsonObject& JsonObject::operator=(const JsonObject& other)
+    {
+        if (this != &other)
+        {
+            JsonObject tmp(other);
+            *this = std::move(tmp);
+        }
+        return *this;
+    }
+
+    JsonObject& JsonObject::operator=(JsonObject&& other)
+    {
+        if (this == &other)
+            return *this;
+        clear();
+        if (!arena_ && !other.arena_)
+        {
+            ::operator delete(data_);
+            delete[] index_;
+            data_ = other.data_;
+            size_ = other.size_;
+            capacity_ = other.capacity_;
+            index_ = other.index_;
+            indexMask_ = other.indexMask_;
+            other.data_ = nullptr;
+            other.index_ = nullptr;
+            other.size_ = other.capacity_ = other.indexMask_ = 0;
+            return *this;
+        }
+        reserve(other.size_);
+        for (auto& [key, value] : other)
         {
-            os << "[\n";
-            const auto& a = asArray();
-            for (size_t i = 0; i < a.size(); ++i)
+            auto* member = new(data_ + size_++) JsonMember();
+            member->first.node_.setString(key.view(), nullptr);
+            member->second = std::move(value);
+        }
+        rebuildIndex();
+        return *this;
+    }
+
+    void JsonObject::reserve(const size_t n)
+    {
+        if (n > capacity_)
+            grow(n);
+    }
+
+    void JsonObject::clear() noexcept
+    {
+        touch();
+        for (uint32_t i = 0; i < size_; ++i)
+            data_[i].~JsonMember();
+        size_ = 0;
+        rebuildIndex();
+    }
+
+    Json& JsonObject::at(const std::string_view key)
+    {
+        const size_t i = indexOf(key);
+        if (i == size_)
+            throw std::out_of_range("json: key not found: " + std::string(key));
+        touch();
+        return data_[i].second;
+    }
+
+    const Json& JsonObject::at(const std::string_view key) const
+    {
+        const size_t i = indexOf(key);
+        if (i == size_)
+            throw std::out_of_range("json: key not found: " + std::string(key));
+        return data_[i].second;
+    }
+
+    Json& JsonObject::operator[](const std::string_view key)
+    {
+        touch();
+        const size_t pos = lowerBound(key);
+        if (pos < size_ && data_[pos].first == key)
+            return data_[pos].second;
+        return insertAt(pos, key)->second;
+    }
+
+    size_t JsonObject::erase(const std::string_view key)
+    {
+        const size_t i = indexOf(key);
+        if (i == size_)
+            return 0;
+        touch();
+        data_[i].~JsonMember();
+        std::memmove(static_cast<void*>(data_ + i), data_ + i + 1, (size_ - i - 1) * sizeof(JsonMember));
+        --size_;
+        rebuildIndex();
+        return 1;
+    }
+
+    size_t JsonObject::lowerBound(const std::string_view key) const noexcept
+    {
+        size_t lo = 0;
+        size_t hi = size_;
+        while (lo < hi)
+        {
+            const size_t mid = (lo + hi) / 2;
+            if (data_[mid].first.view() < key)
+                lo = mid + 1;
+            else
+                hi = mid;
+        }
+        return lo;
+    }
+
+    size_t JsonObject::indexOf(const std::string_view key) const noexcept
+    {
+        if (index_)
+        {
+            for (size_t slot = std::hash<std::string_view>{}(key) & indexMask_;; slot = (slot + 1) & indexMask_)
             {
-                if (i)
-                    os << ",\n";
-                os << std::string((depth + 1) * indentSize, ' ');
-                a[i].dumpPretty(os, depth + 1, indentSize);
+                const uint32_t entry = index_[slot];
+                if (entry == 0)
+                    return size_;
+                if (data_[entry - 1].first == key)
+                    return entry - 1;
             }
-            os << '\n' << indent << ']';
+        }
+        const size_t pos = lowerBound(key);
+        return pos < size_ && data_[pos].first == key ? pos : size_;
+    }
+
+    JsonMember* JsonObject::insertAt(const size_t pos, const std::string_view key)
+    {
+        // key 可能指向本对象内联存储的 key，扩容前先拷贝
+        JsonKey owned(key);
+        if (size_ == capacity_)
+            grow(size_ + 1);
+        std::memmove(static_cast<void*>(data_ + pos + 1), data_ + pos, (size_ - pos) * sizeof(JsonMember));
+        auto* member = new(data_ + pos) JsonMember();
+        member->first.node_.takeFrom(owned.node_);
+        ++size_;
+        rebuildIndex();
+        return member;
+    }
+
+    void JsonObject::grow(const size_t need)
+    {
+        if (need > UINT32_MAX)
+            throw std::length_error("json: object too large");
+        const size_t cap = std::max<size_t>({need, static_cast<size_t>(capacity_) * 2, 4});
+        JsonMember* next = arena_
+                               ? arena_->allocateArray<JsonMember>(cap)
+                               : static_cast<JsonMember*>(::operator new(cap * sizeof(JsonMember)));
+        if (size_)
+            std::memcpy(static_cast<void*>(next), static_cast<void*>(data_), size_ * sizeof(JsonMember));
+        if (!arena_)
+            ::operator delete(data_);
+        data_ = next;
+        capacity_ = static_cast<uint32_t>(std::min<size_t>(cap, UINT32_MAX));
+    }
+
+    void JsonObject::rebuildIndex()
+    {
+        if (size_ < kHashThreshold)
+        {
+            if (!arena_)
+                delete[] index_;
+            index_ = nullptr;
+            indexMask_ = 0;
             return;
         }
-        if (isObject())
+        size_t slots = 64;
+        while (slots < static_cast<size_t>(size_) * 2)
+            slots *= 2;
+        if (slots - 1 != indexMask_ || index_ == nullptr)
         {
-            os << "{\n";
-            const auto& o = asObject();
-            bool first = true;
-            for (const auto& p : o)
-            {
-                if (!first)
-                    os << ",\n";
-                first = false;
-                os << std::string((depth + 1) * indentSize, ' ');
-                escapeString(os, p.first);
-                os << ": ";
-                p.second.dumpPretty(os, depth + 1, indentSize);
-            }
-            os << '\n' << indent << '}';
+            if (!arena_)
+                delete[] index_;
+            index_ = arena_ ? arena_->allocateArray<uint32_t>(slots) : new uint32_t[slots];
+            indexMask_ = static_cast<uint32_t>(slots - 1);
+        }
+        std::memset(index_, 0, slots * sizeof(uint32_t));
+        for (uint32_t i = 0; i < size_; ++i)
+        {
+            size_t slot = std::hash<std::string_view>{}(data_[i].first.view()) & indexMask_;
+            while (index_[slot] != 0)
+                slot = (slot + 1) & indexMask_;
+            index_[slot] = i + 1;
         }
     }
 
-    Json Json::parse(const std::string& s)
+    bool operator==(const JsonObject& lhs, const JsonObject& rhs)
     {
-        size_t idx = 0;
-        auto skip = [&]()
+        return std::equal(lhs.begin(), lhs.end(), rhs.begin(), rhs.end(), [](const auto& a, const auto& b)
         {
-            while (idx < s.size() && std::isspace(static_cast<unsigned char>(s[idx])))
-                ++idx;
-        };
+            return a.first == b.first && a.second == b.second;
+        });
+    }
 
-        std::function<Json()> parse_value;
+    // ---------------- Serialization ----------------
 
-        const std::function parseString = [&]() -> std::string
+    std::string Json::dump(const bool pretty, const int indent_size) const
+    {
+        std::string out;
+        dumpTo(out, pretty, indent_size);
+        return out;
+    }
+
+    // ---------------- Parser ----------------
+
+    namespace internal
+    {
+        // 解析过程中的临时栈：节点按位搬移，不调用构造/析构（节点只引用 arena 中的内存）
+        template <typename T>
+        class NodeStack
         {
-            if (s[idx] != '"')
-                throw std::runtime_error("expected string\n");
-            ++idx; // skip '"'
-            std::string res;
-            while (idx < s.size())
+        public:
+            [[nodiscard]] size_t size() const noexcept { return size_; }
+
+            T* at(const size_t i) noexcept { return reinterpret_cast<T*>(buf_.get()) + i; }
+
+            void push(T& node)
             {
-                const char c = s[idx++];
-                if (c == '"')
-                    break;
-                if (c == '\\')
+                if (size_ == capacity_)
                 {
-                    if (idx >= s.size())
+                    const size_t cap = capacity_ ? capacity_ * 2 : 64;
+                    auto next = std::make_unique_for_overwrite<unsigned char[]>(cap * sizeof(T));
+                    if (size_)
+                        std::memcpy(next.get(), buf_.get(), size_ * sizeof(T));
+                    buf_ = std::move(next);
+                    capacity_ = cap;
+                }
+                std::memcpy(static_cast<void*>(at(size_++)), static_cast<void*>(&node), sizeof(T));
+            }
+
+            void truncate(const size_t n) noexcept { size_ = n; }
+
+        private:
+            std::unique_ptr<unsigned char[]> buf_;
+            size_t size_ = 0;
+            size_t capacity_ = 0;
+        };
+
+        class JsonParser
+        {
+        public:
+            explicit JsonParser(JsonArena* arena) : arena_(arena)
+            {
+            }
+
+            // 同一个解析器可以依次解析多个文档，内部缓冲区会被复用
+            void parseDocument(const std::string_view s, Json& root)
+            {
+                s_ = s;
+                idx_ = 0;
+                values_.truncate(0);
+                members_.truncate(0);
+                parseValue(root, 0);
+                skip();
+                if (idx_ != s_.size())
+                    throw std::runtime_error("extra characters after JSON value");
+            }
+
+        private:
+            static constexpr int kMaxDepth = 1024;
+
+            void skip() noexcept
+            {
+                while (idx_ < s_.size())
+                {
+                    const char c = s_[idx_];
+                    if (c != ' ' && c != '\n' && c != '\r' && c != '\t')
+                        break;
+                    ++idx_;
+                }
+            }
+
+            void expectLiteral(const std::string_view literal)
+            {
+                if (s_.compare(idx_, literal.size(), literal) != 0)
+                    throw std::runtime_error("invalid token");
+                idx_ += literal.size();
+            }
+
+            void parseValue(Json& out, const int depth)
+            {
+                skip();
+                if (idx_ >= s_.size())
+                    throw std::runtime_error("unexpected end");
+                switch (const char c = s_[idx_])
+                {
+                case 'n':
+                    expectLiteral("null");
+                    out.setNull();
+                    return;
+                case 't':
+                    expectLiteral("true");
+                    out.setBool(true);
+                    return;
+                case 'f':
+                    expectLiteral("false");
+                    out.setBool(false);
+                    return;
+                case '"':
+                    out.setString(parseString(), arena_);
+                    return;
+                case '[':
+                    parseArray(out, depth + 1);
+                    return;
+                case '{':
+                    parseObject(out, depth + 1);
+                    return;
+                default:
+                    if (c == '-' || (c >= '0' && c <= '9'))
+                    {
+                        parseNumber(out);
+                        return;
+                    }
+                    throw std::runtime_error(std::string("unexpected char: ") + c);
+                }
+            }
+
+            void parseArray(Json& out, const int depth)
+            {
+                if (depth > kMaxDepth)
+                    throw std::runtime_error("json: nesting too deep");
+                ++idx_; // skip '['
+                const size_t start = values_.size();
+                skip();
+                if (idx_ < s_.size() && s_[idx_] == ']')
+                {
+                    ++idx_;
+                }
+                else
+                {
+                    while (true)
+                    {
+                        Json value;
+                        parseValue(value, depth);
+                        values_.push(value);
+                        value.setNull();
+                        skip();
+                        if (idx_ >= s_.size())
+                            throw std::runtime_error("unexpected end in array");
+                        if (s_[idx_] == ',')
+                        {
+                            ++idx_;
+                            continue;
+                        }
+                        if (s_[idx_] == ']')
+                        {
+                            ++idx_;
+                            break;
+                        }
+                        throw std::runtime_error("expected ',' or ']' in array");
+                    }
+                }
+
+                auto* arr = arena_->create<JsonArray>();
+                arr->arena_ = arena_;
+                const size_t n = values_.size() - start;
+                if (n > 0)
+                {
+                    arr->data_ = arena_->allocateArray<Json>(n);
+                    std::memcpy(static_cast<void*>(arr->data_), values_.at(start), n * sizeof(Json));
+                    arr->size_ = arr->capacity_ = static_cast<uint32_t>(n);
+                }
+                values_.truncate(start);
+                out.setArray(arr, Json::kInArena);
+            }
+
+            void parseObject(Json& out, const int depth)
+            {
+                if (depth > kMaxDepth)
+                    throw std::runtime_error("json: nesting too deep");
+                ++idx_; // skip '{'
+                const size_t start = members_.size();
+                skip();
+                if (idx_ < s_.size() && s_[idx_] == '}')
+                {
+                    ++idx_;
+                }
+                else
+                {
+                    while (true)
+                    {
+                        skip();
+                        if (idx_ >= s_.size() || s_[idx_] != '"')
+                            throw std::runtime_error("expected string key in object");
+                        JsonMember member;
+                        member.first.node_.setString(parseString(), arena_);
+                        skip();
+                        if (idx_ >= s_.size() || s_[idx_] != ':')
+                            throw std::runtime_error("expected ':' after key");
+                        ++idx_;
+                        parseValue(member.second, depth);
+                        members_.push(member);
+                        member.first.node_.setNull();
+                        member.second.setNull();
+                        skip();
+                        if (idx_ >= s_.size())
+                            throw std::runtime_error("unexpected end in object");
+                        if (s_[idx_] == ',')
+                        {
+                            ++idx_;
+                            continue;
+                        }
+                        if (s_[idx_] == '}')
+                        {
+                            ++idx_;
+                            break;
+                        }
+                        throw std::runtime_error("expected ',' or '}' in object");
+                    }
+                }
+
+                auto* obj = arena_->create<JsonObject>();
+                obj->arena_ = arena_;
+                const size_t n = members_.size() - start;
+                if (n > 0)
+                {
+                    obj->data_ = arena_->allocateArray<JsonMember>(n);
+                    obj->capacity_ = static_cast<uint32_t>(n);
+                    JsonMember* first = members_.at(start);
+                    bool sorted = true;
+                    for (size_t i = 1; i < n && sorted; ++i)
+                        sorted = first[i - 1].first.view() < first[i].first.view();
+                    if (sorted)
+                    {
+                        std::memcpy(static_cast<void*>(obj->data_), first, n * sizeof(JsonMember));
+                        obj->size_ = static_cast<uint32_t>(n);
+                    }
+                    else
+                    {
+                        // 按 key 稳定排序，重复 key 保留第一个
+                        order_.resize(n);
+                        for (uint32_t i = 0; i < n; ++i)
+                            order_[i] = i;
+                        std::stable_sort(order_.begin(), order_.end(), [first](const uint32_t a, const uint32_t b)
+                        {
+                            return first[a].first.view() < first[b].first.view();
+                        });
+                        uint32_t size = 0;
+                        for (const uint32_t i : order_)
+                        {
+                            if (size > 0 && obj->data_[size - 1].first.view() == first[i].first.view())
+                                continue;
+                            std::memcpy(static_cast<void*>(obj->data_ + size++), first + i, sizeof(JsonMember));
+                        }
+                        obj->size_ = size;
+                    }
+                    obj->rebuildIndex();
+                }
+                members_.truncate(start);
+                out.setObject(obj, Json::kInArena);
+            }
+
+            // 返回解码后的字符串，不含转义时直接引用输入
+            std::string_view parseString()
+            {
+                ++idx_; // skip '"'
+                const size_t begin = idx_;
+                size_t pos = idx_;
+                while (true)
+                {
+                    pos += findEscape(s_.data() + pos, s_.size() - pos);
+                    if (pos >= s_.size())
+                        throw std::runtime_error("unterminated string");
+                    if (s_[pos] == '"')
+                    {
+                        idx_ = pos + 1;
+                        return s_.substr(begin, pos - begin);
+                    }
+                    if (s_[pos] == '\\')
+                        break;
+                    ++pos; // 控制字符按原样接受
+                }
+
+                unescaped_.assign(s_.data() + begin, pos - begin);
+                idx_ = pos;
+                while (true)
+                {
+                    if (idx_ >= s_.size())
+                        throw std::runtime_error("unterminated string");
+                    const char c = s_[idx_++];
+                    if (c == '"')
+                        break;
+                    if (c != '\\')
+                    {
+                        unescaped_.push_back(c);
+                        continue;
+                    }
+                    if (idx_ >= s_.size())
                         throw std::runtime_error("unterminated escape");
-                    switch (const char e = s[idx++])
+                    switch (const char e = s_[idx_++])
                     {
                     case '"':
-                        res.push_back('"');
+                        unescaped_.push_back('"');
                         break;
                     case '\\':
-                        res.push_back('\\');
+                        unescaped_.push_back('\\');
                         break;
                     case '/':
-                        res.push_back('/');
+                        unescaped_.push_back('/');
                         break;
                     case 'b':
-                        res.push_back('\b');
+                        unescaped_.push_back('\b');
                         break;
                     case 'f':
-                        res.push_back('\f');
+                        unescaped_.push_back('\f');
                         break;
                     case 'n':
-                        res.push_back('\n');
+                        unescaped_.push_back('\n');
                         break;
                     case 'r':
-                        res.push_back('\r');
+                        unescaped_.push_back('\r');
                         break;
                     case 't':
-                        res.push_back('\t');
+                        unescaped_.push_back('\t');
                         break;
                     case 'u':
-                        {
-                            if (idx + 4 > s.size())
-                                throw std::runtime_error("invalid unicode escape");
-                            int code = 0;
-                            for (int i = 0; i < 4; ++i)
-                            {
-                                const char ch = s[idx++];
-                                code <<= 4;
-                                if (ch >= '0' && ch <= '9')
-                                    code += ch - '0';
-                                else if (ch >= 'a' && ch <= 'f')
-                                    code += 10 + ch - 'a';
-                                else if (ch >= 'A' && ch <= 'F')
-                                    code += 10 + ch - 'A';
-                                else
-                                    throw std::runtime_error("invalid unicode hex");
-                            }
-                            if (code < 0x80)
-                                res.push_back(static_cast<char>(code));
-                            else
-                            {
-                                if (code <= 0x7FF)
-                                {
-                                    res.push_back(static_cast<char>(0xC0 | ((code >> 6) & 0x1F)));
-                                    res.push_back(static_cast<char>(0x80 | (code & 0x3F)));
-                                }
-                                else
-                                {
-                                    res.push_back(static_cast<char>(0xE0 | ((code >> 12) & 0x0F)));
-                                    res.push_back(static_cast<char>(0x80 | ((code >> 6) & 0x3F)));
-                                    res.push_back(static_cast<char>(0x80 | (code & 0x3F)));
-                                }
-                            }
-                        }
+                        appendUnicode();
                         break;
                     default:
                         throw std::runtime_error(std::string("invalid escape: ") + e);
                     }
                 }
-                else
-                {
-                    res.push_back(c);
-                }
+                return unescaped_;
             }
-            return res;
-        };
 
-        const std::function parseNumber = [&]() -> double
-        {
-            const size_t start = idx;
-            if (s[idx] == '-')
-                ++idx;
-            if (idx < s.size() && s[idx] == '0')
-                ++idx;
-            else
-            {
-                if (idx >= s.size() || !std::isdigit((unsigned char)s[idx]))
-                    throw std::runtime_error("invalid number");
-                while (idx < s.size() && std::isdigit((unsigned char)s[idx]))
-                    ++idx;
-            }
-            if (idx < s.size() && s[idx] == '.')
-            {
-                ++idx;
-                if (idx >= s.size() || !std::isdigit(static_cast<unsigned char>(s[idx])))
-                    throw std::runtime_error("invalid number");
-                while (idx < s.size() && std::isdigit(static_cast<unsigned char>(s[idx])))
-                    ++idx;
-            }
-            if (idx < s.size() && (s[idx] == 'e' || s[idx] == 'E'))
+            uint32_t parseHex4()
             {
-                ++idx;
-                if (idx < s.size() && (s[idx] == '+' || s[idx] == '-'))
-                    ++idx;
-                if (idx >= s.size() || !std::isdigit(static_cast<unsigned char>(s[idx])))
-                    throw std::runtime_error("invalid number");
-                while (idx < s.size() && std::isdigit(static_cast<unsigned char>(s[idx])))
-                    ++idx;
-            }
-            double val = 0.0;
-            try
-            {
-                val = std::stod(s.substr(start, idx - start));
-            }
-            catch (...)
-            {
-                throw std::runtime_error("bad number conversion");
+                if (idx_ + 4 > s_.size())
+                    throw std::runtime_error("invalid unicode escape");
+                uint32_t code = 0;
+                for (int i = 0; i < 4; ++i)
+                {
+                    const char ch = s_[idx_++];
+                    code <<= 4;
+                    if (ch >= '0' && ch <= '9')
+                        code += ch - '0';
+                    else if (ch >= 'a' && ch <= 'f')
+                        code += 10 + ch - 'a';
+                    else if (ch >= 'A' && ch <= 'F')
+                        code += 10 + ch - 'A';
+                    else
+                        throw std::runtime_error("invalid unicode hex");
+                }
+                return code;
             }
-            return val;
-        };
 
-        parse_value = [&]() -> Json
-        {
-            skip();
-            if (idx >= s.size())
-                throw std::runtime_error("unexpected end");
-            char c = s[idx];
-            if (c == 'n')
+            void appendUnicode()
             {
-                if (s.compare(idx, 4, "null") == 0)
+                uint32_t code = parseHex4();
+                // UTF-16 代理对
+                if (code >= 0xD800 && code <= 0xDBFF && s_.compare(idx_, 2, "\\u") == 0)
                 {
-                    idx += 4;
-                    return Json(nullptr);
+                    const size_t save = idx_;
+                    idx_ += 2;
+                    if (const uint32_t low = parseHex4(); low >= 0xDC00 && low <= 0xDFFF)
+                        code = 0x10000 + ((code - 0xD800) << 10) + (low - 0xDC00);
+                    else
+                        idx_ = save;
                 }
-                throw std::runtime_error("invalid token");
-            }
-            if (c == 't')
-            {
-                if (s.compare(idx, 4, "true") == 0)
+                if (code < 0x80)
                 {
-                    idx += 4;
-                    return Json(true);
+                    unescaped_.push_back(static_cast<char>(code));
                 }
-                throw std::runtime_error("invalid token");
-            }
-            if (c == 'f')
-            {
-                if (s.compare(idx, 5, "false") == 0)
+                else if (code <= 0x7FF)
                 {
-                    idx += 5;
-                    return Json(false);
+                    unescaped_.push_back(static_cast<char>(0xC0 | (code >> 6)));
+                    unescaped_.push_back(static_cast<char>(0x80 | (code & 0x3F)));
                 }
-                throw std::runtime_error("invalid token");
-            }
-            if (c == '"')
-            {
-                std::string str = parseString();
-                return Json(str);
-            }
-            if (c == '[')
-            {
-                ++idx; // skip '['
-                array arr;
-                skip();
-                if (idx < s.size() && s[idx] == ']')
+                else if (code <= 0xFFFF)
                 {
-                    ++idx;
-                    return Json(arr);
+                    unescaped_.push_back(static_cast<char>(0xE0 | (code >> 12)));
+                    unescaped_.push_back(static_cast<char>(0x80 | ((code >> 6) & 0x3F)));
+                    unescaped_.push_back(static_cast<char>(0x80 | (code & 0x3F)));
                 }
-                while (true)
+                else
                 {
-                    arr.emplace_back(parse_value());
-                    skip();
-                    if (idx >= s.size())
-                        throw std::runtime_error("unexpected end in array");
-                    if (s[idx] == ',')
-                    {
-                        ++idx;
-                        continue;
-                    }
-                    if (s[idx] == ']')
-                    {
-                        ++idx;
-                        break;
-                    }
-                    throw std::runtime_error("expected ',' or ']' in array");
+                    unescaped_.push_back(static_cast<char>(0xF0 | (code >> 18)));
+                    unescaped_.push_back(static_cast<char>(0x80 | ((code >> 12) & 0x3F)));
+                    unescaped_.push_back(static_cast<char>(0x80 | ((code >> 6) & 0x3F)));
+                    unescaped_.push_back(static_cast<char>(0x80 | (code & 0x3F)));
                 }
-                return Json(std::move(arr));
             }
-            if (c == '{')
+
+            bool isDigit(const size_t i) const noexcept { return i < s_.size() && s_[i] >= '0' && s_[i] <= '9'; }
+
+            void parseNumber(Json& out)
             {
-                ++idx; // skip '{'
-                object obj;
-                skip();
-                if (idx < s.size() && s[idx] == '}')
+                const size_t start = idx_;
+                bool integral = true;
+                if (s_[idx_] == '-')
+                    ++idx_;
+                if (idx_ < s_.size() && s_[idx_] == '0')
+                    ++idx_;
+                else
                 {
-                    ++idx;
-                    return Json(obj);
+                    if (!isDigit(idx_))
+                        throw std::runtime_error("invalid number");
+                    while (isDigit(idx_))
+                        ++idx_;
                 }
-                while (true)
+                if (idx_ < s_.size() && s_[idx_] == '.')
                 {
-                    skip();
-                    if (idx >= s.size() || s[idx] != '"')
-                        throw std::runtime_error("expected string key in object");
-                    std::string key = parseString();
-                    skip();
-                    if (idx >= s.size() || s[idx] != ':')
-                        throw std::runtime_error("expected ':' after key");
-                    ++idx;
-                    Json val = parse_value();
-                    obj.emplace(std::move(key), std::move(val));
-                    skip();
-                    if (idx >= s.size())
-                        throw std::runtime_error("unexpected end in object");
-                    if (s[idx] == ',')
+                    integral = false;
+                    ++idx_;
+                    if (!isDigit(idx_))
+                        throw std::runtime_error("invalid number");
+                    while (isDigit(idx_))
+                        ++idx_;
+                }
+                if (idx_ < s_.size() && (s_[idx_] == 'e' || s_[idx_] == 'E'))
+                {
+                    integral = false;
+                    ++idx_;
+                    if (idx_ < s_.size() && (s_[idx_] == '+' || s_[idx_] == '-'))
+                        ++idx_;
+                    if (!isDigit(idx_))
+                        throw std::runtime_error("invalid number");
+                    while (isDigit(idx_))
+                        ++idx_;
+                }
+
+                const char* first = s_.data() + start;
+                const char* last = s_.data() + idx_;
+                if (integral)
+                {
+                    if (int64_t i; std::from_chars(first, last, i).ec == std::errc())
                     {
-                        ++idx;
-                        continue;
+                        out.setInt(i);
+                        return;
                     }
-                    if (s[idx] == '}')
+                    if (uint64_t u; *first != '-' && std::from_chars(first, last, u).ec == std::errc())
                     {
-                        ++idx;
-                        break;
+                        out.setUint(u);
+                        return;
                     }
-                    throw std::runtime_error("expected ',' or '}' in object");
                 }
-                return Json(std::move(obj));
-            }
-            // number
-            if (c == '-' || std::isdigit(static_cast<unsigned char>(c)))
-            {
-                double d = parseNumber();
-                return Json(d);
+                double d;
+                if (const auto [ptr, ec] = std::from_chars(first, last, d); ec != std::errc() || ptr != last)
+                    throw std::runtime_error("bad number conversion");
+                out.setDouble(d);
             }
-            throw std::runtime_error(std::string("unexpected char: ") + c);
+
+            std::string_view s_;
+            size_t idx_ = 0;
+            JsonArena* arena_;
+            NodeStack<Json> values_;
+            NodeStack<JsonMember> members_;
+            std::vector<uint32_t> order_;
+            std::string unescaped_;
         };
+    }
+
+    Json Json::parse(const std::string_view s)
+    {
+        auto arena = std::make_unique<internal::JsonArena>();
+        Json root;
+        internal::JsonParser(arena.get()).parseDocument(s, root);
+        if (root.isArray() || root.isObject())
+        {
+            // 根节点接管 arena
+            root.tag_ = static_cast<uint8_t>((root.tag_ & ~kInArena) | kArenaRoot);
+            arena.release();
+            return root;
+        }
+        // 标量根节点不需要 arena
+        return Json(root);
+    }
+
+    JsonBatch::JsonBatch() : arena_(std::make_unique<internal::JsonArena>()),
+                             parser_(std::make_unique<internal::JsonParser>(arena_.get()))
+    {
+    }
+
+    JsonBatch::~JsonBatch()
+    {
+        clear();
+        ::operator delete(docs_);
+    }
 
-        Json root = parse_value();
-        while (idx < s.size() && std::isspace(static_cast<unsigned char>(s[idx])))
-            ++idx;
-        if (idx != s.size())
-            throw std::runtime_error("extra characters after JSON value");
-        return root;
+    JsonBatch::JsonBatch(JsonBatch&& other) noexcept
+        : arena_(std::move(other.arena_)), parser_(std::move(other.parser_)),
+          docs_(std::exchange(other.docs_, nullptr)), size_(std::exchange(other.size_, 0)),
+          capacity_(std::exchange(other.capacity_, 0))
+    {
+    }
+
+    JsonBatch& JsonBatch::operator=(JsonBatch&& other) noexcept
+    {
+        if (this != &other)
+        {
+            clear();
+            ::operator delete(docs_);
+            arena_ = std::move(other.arena_);
+            parser_ = std::move(other.parser_);
+            docs_ = std::exchange(other.docs_, nullptr);
+            size_ = std::exchange(other.size_, 0);
+            capacity_ = std::exchange(other.capacity_, 0);
+        }
+        return *this;
+    }
+
+    const Json& JsonBatch::parse(const std::string_view s)
+    {
+        if (!parser_)
+        {
+            arena_ = std::make_unique<internal::JsonArena>();
+            parser_ = std::make_unique<internal::JsonParser>(arena_.get());
+        }
+        if (size_ == capacity_)
+        {
+            const size_t cap = capacity_ ? capacity_ * 2 : 64;
+            auto* next = static_cast<Json*>(::operator new(cap * sizeof(Json)));
+            if (size_)
+                std::memcpy(static_cast<void*>(next), static_cast<void*>(docs_), size_ * sizeof(Json));
+            ::operator delete(docs_);
+            docs_ = next;
+            capacity_ = cap;
+        }
+        Json* root = new(docs_ + size_) Json();
+        try
+        {
+            parser_->parseDocument(s, *root);
+        }
+        catch (...)
+        {
+            // 半成品节点都在 arena 中，直接丢弃
+            root->setNull();
+            throw;
+        }
+        return docs_[size_++];
+    }
+
+    void JsonBatch::clear() noexcept
+    {
+        // 文档都在 arena 中，析构不会释放任何东西
+        for (size_t i = 0; i < size_; ++i)
+            docs_[i].~Json();
+        size_ = 0;
+        if (arena_)
+        {
+            arena_->reset();
+            arena_->dirty = false;
+        }
     }
 }
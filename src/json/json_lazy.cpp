@@ -0,0 +1,548 @@
+#include "cppkit/json/json_lazy.hpp"
+
+#if defined(__SSE2__)
+#include <emmintrin.h>
+#elif defined(__ARM_NEON)
+#include <arm_neon.h>
+#endif
+
+namespace cppkit::json
+{
+    namespace internal
+    {
+        static constexpr int kMaxDepth = 1024;
+
+        // 返回 [p, end) 中第一个 '"' 或 '\\' 的位置
+        static const char* findQuote(const char* p, const char* end) noexcept
+        {
+#if defined(__SSE2__)
+            const __m128i quote = _mm_set1_epi8('"');
+            const __m128i backslash = _mm_set1_epi8('\\');
+            for (; p + 16 <= end; p += 16)
+            {
+                const __m128i chunk = _mm_loadu_si128(reinterpret_cast<const __m128i*>(p));
+                const __m128i hit = _mm_or_si128(_mm_cmpeq_epi8(chunk, quote), _mm_cmpeq_epi8(chunk, backslash));
+                if (const int mask = _mm_movemask_epi8(hit); mask != 0)
+                    return p + __builtin_ctz(static_cast<unsigned>(mask));
+            }
+#elif defined(__ARM_NEON)
+            const uint8x16_t quote = vdupq_n_u8('"');
+            const uint8x16_t backslash = vdupq_n_u8('\\');
+            for (; p + 16 <= end; p += 16)
+            {
+                const uint8x16_t chunk = vld1q_u8(reinterpret_cast<const uint8_t*>(p));
+                if (vmaxvq_u8(vorrq_u8(vceqq_u8(chunk, quote), vceqq_u8(chunk, backslash))) != 0)
+                    break;
+            }
+#endif
+            while (p < end && *p != '"' && *p != '\\')
+                ++p;
+            return p;
+        }
+
+        // p 指向开头的引号，返回结尾引号之后的位置
+        static const char* skipString(const char* p, const char* end)
+        {
+            ++p;
+            while (true)
+            {
+                p = findQuote(p, end);
+                if (p >= end)
+                    throw std::runtime_error("unterminated string");
+                if (*p == '"')
+                    return p + 1;
+                p += 2; // 跳过转义字符
+            }
+        }
+
+        // 括号匹配扫描器：逐块取出引号、反斜杠和括号的位掩码，按位处理，
+        // 字符串内部只关心引号与转义
+        class BracketScanner
+        {
+        public:
+            enum Action { kContinue, kDone, kSkipNext };
+
+            // c 是一个引号、反斜杠或括号
+            Action visit(const char c)
+            {
+                if (inString_)
+                {
+                    if (c == '\\')
+                        return kSkipNext;
+                    if (c == '"')
+                        inString_ = false;
+                    return kContinue;
+                }
+                switch (c)
+                {
+                case '"':
+                    inString_ = true;
+                    return kContinue;
+                case '[':
+                case '{':
+                    if (depth_ == kMaxDepth)
+                        throw std::runtime_error("json: nesting too deep");
+                    if (c == '{')
+                        kinds_[depth_ / 64] |= uint64_t{1} << (depth_ % 64);
+                    else
+                        kinds_[depth_ / 64] &= ~(uint64_t{1} << (depth_ % 64));
+                    ++depth_;
+                    return kContinue;
+                case ']':
+                case '}':
+                    {
+                        --depth_;
+                        const bool object = (kinds_[depth_ / 64] >> (depth_ % 64)) & 1;
+                        if (object != (c == '}'))
+                            throw std::runtime_error("json: mismatched bracket");
+                        return depth_ == 0 ? kDone : kContinue;
+                    }
+                default:
+                    return kContinue; // 字符串外的反斜杠
+                }
+            }
+
+        private:
+            uint64_t kinds_[kMaxDepth / 64] = {}; // 每层一位：1 表示对象
+            int depth_ = 0;
+            bool inString_ = false;
+        };
+
+        static bool isBracketOrQuote(const char c)
+        {
+            return c == '"' || c == '\\' || c == '[' || c == ']' || c == '{' || c == '}';
+        }
+
+        // p 指向 '[' 或 '{'，用括号匹配找到对应的结尾
+        static const char* skipContainer(const char* p, const char* end)
+        {
+            BracketScanner scanner;
+#if defined(__SSE2__)
+            const __m128i quote = _mm_set1_epi8('"');
+            const __m128i backslash = _mm_set1_epi8('\\');
+            // '[' 0x5B 与 '{' 0x7B、']' 0x5D 与 '}' 0x7D 只差 0x20，置位后合并比较
+            const __m128i caseBit = _mm_set1_epi8(0x20);
+            const __m128i open = _mm_set1_epi8('{');
+            const __m128i close = _mm_set1_epi8('}');
+            while (p + 16 <= end)
+            {
+                const __m128i chunk = _mm_loadu_si128(reinterpret_cast<const __m128i*>(p));
+                const __m128i folded = _mm_or_si128(chunk, caseBit);
+                const __m128i hit = _mm_or_si128(
+                    _mm_or_si128(_mm_cmpeq_epi8(chunk, quote), _mm_cmpeq_epi8(chunk, backslash)),
+                    _mm_or_si128(_mm_cmpeq_epi8(folded, open), _mm_cmpeq_epi8(folded, close)));
+                auto mask = static_cast<unsigned>(_mm_movemask_epi8(hit));
+                size_t advance = 16;
+                while (mask != 0)
+                {
+                    const unsigned i = __builtin_ctz(mask);
+                    mask &= mask - 1;
+                    const auto action = scanner.visit(p[i]);
+                    if (action == BracketScanner::kDone)
+                        return p + i + 1;
+                    if (action == BracketScanner::kSkipNext)
+                    {
+                        if (i == 15)
+                            advance = 17;
+                        else
+                            mask &= ~(1u << (i + 1));
+                    }
+                }
+                p += advance;
+            }
+#endif
+            for (; p < end; ++p)
+            {
+                if (!isBracketOrQuote(*p))
+                    continue;
+                const auto action = scanner.visit(*p);
+                if (action == BracketScanner::kDone)
+                    return p + 1;
+                if (action == BracketScanner::kSkipNext)
+                    ++p;
+            }
+            throw std::runtime_error("unexpected end");
+        }
+
+        const char* skipSpace(const char* p, const char* end) noexcept
+        {
+            while (p < end && (*p == ' ' || *p == '\n' || *p == '\r' || *p == '\t'))
+                ++p;
+            return p;
+        }
+
+        // 按 JSON 语法检查 [p, last) 是否是一个完整的数字：-?(0|[1-9]\d*)(\.\d+)?([eE][+-]?\d+)?
+        static bool isNumberToken(const char* p, const char* last) noexcept
+        {
+            const auto digits = [&]
+            {
+                const char* start = p;
+                while (p < last && *p >= '0' && *p <= '9')
+                    ++p;
+                return p != start;
+            };
+            if (p < last && *p == '-')
+                ++p;
+            if (p < last && *p == '0')
+                ++p;
+            else if (!digits())
+                return false;
+            if (p < last && *p == '.')
+            {
+                ++p;
+                if (!digits())
+                    return false;
+            }
+            if (p < last && (*p == 'e' || *p == 'E'))
+            {
+                ++p;
+                if (p < last && (*p == '+' || *p == '-'))
+                    ++p;
+                if (!digits())
+                    return false;
+            }
+            return p == last;
+        }
+
+        const char* skipValue(const char* p, const char* end)
+        {
+            if (p >= end)
+                throw std::runtime_error("unexpected end");
+            switch (*p)
+            {
+            case '"':
+                return skipString(p, end);
+            case '[':
+            case '{':
+                return skipContainer(p, end);
+            default:
+                {
+                    // 数字或字面量：读到分隔符为止
+                    const char* begin = p;
+                    while (p < end && *p != ',' && *p != ']' && *p != '}' && *p != ' ' && *p != '\n' &&
+                        *p != '\r' && *p != '\t')
+                        ++p;
+                    if (p == begin)
+                        throw std::runtime_error(std::string("unexpected char: ") + *p);
+                    return p;
+                }
+            }
+        }
+
+        // 解码 JSON Pointer 的一段：~1 -> '/'，~0 -> '~'
+        static std::string decodePointerToken(const std::string_view token)
+        {
+            std::string out;
+            out.reserve(token.size());
+            for (size_t i = 0; i < token.size(); ++i)
+            {
+                if (token[i] != '~')
+                {
+                    out.push_back(token[i]);
+                    continue;
+                }
+                if (i + 1 < token.size() && token[i + 1] == '0')
+                    out.push_back('~');
+                else if (i + 1 < token.size() && token[i + 1] == '1')
+                    out.push_back('/');
+                else
+                    throw std::runtime_error("json: invalid pointer escape");
+                ++i;
+            }
+            return out;
+        }
+    }
+
+    Json LazyValue::number() const
+    {
+        if (!isNumber())
+            throw std::runtime_error("json: not a number");
+        const char* last = internal::skipValue(p_, end_);
+        if (!internal::isNumberToken(p_, last))
+            throw std::runtime_error("invalid number");
+        bool integral = true;
+        for (const char* q = p_; q < last; ++q)
+        {
+            if (*q == '.' || *q == 'e' || *q == 'E')
+            {
+                integral = false;
+                break;
+            }
+        }
+        if (integral)
+        {
+            // 超出范围时 from_chars 同样会前进到 last 但不写入结果，必须同时检查 ec 和 ptr
+            int64_t i;
+            if (const auto [ptr, ec] = std::from_chars(p_, last, i); ec == std::errc() && ptr == last)
+                return Json(static_cast<long>(i));
+            uint64_t u;
+            if (const auto [ptr, ec] = std::from_chars(p_, last, u); *p_ != '-' && ec == std::errc() && ptr == last)
+                return Json(u);
+        }
+        double d;
+        if (const auto [ptr, ec] = std::from_chars(p_, last, d); ec != std::errc() || ptr != last)
+            throw std::runtime_error("bad number conversion");
+        return Json(d);
+    }
+
+    Json::Type LazyValue::type() const
+    {
+        switch (*p_)
+        {
+        case 'n':
+            return Json::Type::Null;
+        case 't':
+        case 'f':
+            return Json::Type::Bool;
+        case '"':
+            return Json::Type::String;
+        case '[':
+            return Json::Type::Array;
+        case '{':
+            return Json::Type::Object;
+        default:
+            return number().type();
+        }
+    }
+
+    bool LazyValue::asBool() const
+    {
+        const std::string_view token(p_, internal::skipValue(p_, end_) - p_);
+        if (token == "true")
+            return true;
+        if (token == "false")
+            return false;
+        throw std::runtime_error("json: not a bool");
+    }
+
+    int64_t LazyValue::asInt64() const { return number().asInt64(); }
+
+    uint64_t LazyValue::asUint64() const { return number().asUint64(); }
+
+    double LazyValue::asNumber() const { return number().asNumber(); }
+
+    std::string_view LazyValue::asRawString() const
+    {
+        if (!isString())
+            throw std::runtime_error("json: not a string");
+        const char* last = internal::skipString(p_, end_);
+        return {p_ + 1, static_cast<size_t>(last - p_ - 2)};
+    }
+
+    std::string LazyValue::asString() const
+    {
+        const std::string_view s = asRawString();
+        if (s.find('\\') == std::string_view::npos)
+            return std::string(s);
+        return std::string(Json::parse({s.data() - 1, s.size() + 2}).asString());
+    }
+
+    LazyArray LazyValue::asArray() const
+    {
+        if (!isArray())
+            throw std::runtime_error("json: not an array");
+        return {p_, end_};
+    }
+
+    LazyObject LazyValue::asObject() const
+    {
+        if (!isObject())
+            throw std::runtime_error("json: not an object");
+        return {p_, end_};
+    }
+
+    LazyValue LazyValue::operator[](const std::string_view key) const { return asObject().at(key); }
+
+    LazyValue LazyValue::operator[](const size_t idx) const { return asArray().at(idx); }
+
+    std::string_view LazyValue::raw() const
+    {
+        return {p_, static_cast<size_t>(internal::skipValue(p_, end_) - p_)};
+    }
+
+    LazyValue LazyValue::at_pointer(const std::string_view pointer) const
+    {
+        if (!pointer.empty() && pointer.front() != '/')
+            throw std::runtime_error("json: invalid pointer: " + std::string(pointer));
+        LazyValue cur = *this;
+        size_t pos = 0;
+        while (pos < pointer.size())
+        {
+            const size_t next = std::min(pointer.find('/', pos + 1), pointer.size());
+            const std::string_view token = pointer.substr(pos + 1, next - pos - 1);
+            if (cur.isObject())
+            {
+                const LazyObject obj = cur.asObject();
+                const auto it = token.find('~') == std::string_view::npos
+                                    ? obj.find(token)
+                                    : obj.find(internal::decodePointerToken(token));
+                if (it == obj.end())
+                    break;
+                cur = it->value;
+                pos = next;
+                continue;
+            }
+            // 数组下标：不允许前导零，"-" 指向末尾之后，总是不存在
+            size_t idx = 0;
+            if (!cur.isArray() || token.empty() || (token.size() > 1 && token.front() == '0'))
+                break;
+            if (const auto [ptr, ec] = std::from_chars(token.data(), token.data() + token.size(), idx);
+                ec != std::errc() || ptr != token.data() + token.size())
+                break;
+            const LazyArray arr = cur.asArray();
+            auto it = arr.begin();
+            for (; it != arr.end() && idx > 0; --idx)
+                ++it;
+            if (it == arr.end())
+                break;
+            cur = *it;
+            pos = next;
+        }
+        if (pos < pointer.size())
+            throw std::out_of_range("json: pointer not found: " + std::string(pointer));
+        return cur;
+    }
+
+    std::string LazyField::keyString() const
+    {
+        if (key.find('\\') == std::string_view::npos)
+            return std::string(key);
+        return std::string(Json::parse({key.data() - 1, key.size() + 2}).asString());
+    }
+
+    bool LazyField::keyEquals(const std::string_view name) const
+    {
+        if (key.find('\\') == std::string_view::npos)
+            return key == name;
+        return Json::parse({key.data() - 1, key.size() + 2}).asString() == name;
+    }
+
+    LazyArray::iterator& LazyArray::iterator::operator++()
+    {
+        const char* p = internal::skipSpace(internal::skipValue(p_, end_), end_);
+        if (p >= end_)
+            throw std::runtime_error("unexpected end in array");
+        if (*p == ']')
+        {
+            p_ = nullptr;
+            return *this;
+        }
+        if (*p != ',')
+            throw std::runtime_error("expected ',' or ']' in array");
+        p = internal::skipSpace(p + 1, end_);
+        if (p >= end_)
+            throw std::runtime_error("unexpected end in array");
+        p_ = p;
+        cur_ = LazyValue(p, end_);
+        return *this;
+    }
+
+    LazyArray::iterator LazyArray::begin() const
+    {
+        const char* p = internal::skipSpace(p_ + 1, end_);
+        if (p >= end_)
+            throw std::runtime_error("unexpected end in array");
+        if (*p == ']')
+            return {};
+        return {p, end_};
+    }
+
+    size_t LazyArray::size() const
+    {
+        size_t n = 0;
+        for (auto it = begin(); it != end(); ++it)
+            ++n;
+        return n;
+    }
+
+    LazyValue LazyArray::at(size_t idx) const
+    {
+        for (auto it = begin(); it != end(); ++it, --idx)
+        {
+            if (idx == 0)
+                return *it;
+        }
+        throw std::out_of_range("json: array index out of range");
+    }
+
+    void LazyObject::iterator::load()
+    {
+        if (*p_ != '"')
+            throw std::runtime_error("expected string key in object");
+        const char* keyEnd = internal::skipString(p_, end_);
+        field_.key = {p_ + 1, static_cast<size_t>(keyEnd - p_ - 2)};
+        const char* p = internal::skipSpace(keyEnd, end_);
+        if (p >= end_ || *p != ':')
+            throw std::runtime_error("expected ':' after key");
+        p = internal::skipSpace(p + 1, end_);
+        if (p >= end_)
+            throw std::runtime_error("unexpected end in object");
+        field_.value = LazyValue(p, end_);
+    }
+
+    LazyObject::iterator& LazyObject::iterator::operator++()
+    {
+        const std::string_view value = field_.value.raw();
+        const char* p = internal::skipSpace(value.data() + value.size(), end_);
+        if (p >= end_)
+            throw std::runtime_error("unexpected end in object");
+        if (*p == '}')
+        {
+            p_ = nullptr;
+            return *this;
+        }
+        if (*p != ',')
+            throw std::runtime_error("expected ',' or '}' in object");
+        p = internal::skipSpace(p + 1, end_);
+        if (p >= end_)
+            throw std::runtime_error("unexpected end in object");
+        p_ = p;
+        load();
+        return *this;
+    }
+
+    LazyObject::iterator LazyObject::begin() const
+    {
+        const char* p = internal::skipSpace(p_ + 1, end_);
+        if (p >= end_)
+            throw std::runtime_error("unexpected end in object");
+        if (*p == '}')
+            return {};
+        return {p, end_};
+    }
+
+    size_t LazyObject::size() const
+    {
+        size_t n = 0;
+        for (auto it = begin(); it != end(); ++it)
+            ++n;
+        return n;
+    }
+
+    LazyObject::iterator LazyObject::find(const std::string_view key) const
+    {
+        for (auto it = begin(); it != end(); ++it)
+        {
+            if (it->keyEquals(key))
+                return it;
+        }
+        return end();
+    }
+
+    LazyValue LazyObject::at(const std::string_view key) const
+    {
+        const auto it = find(key);
+        if (it == end())
+            throw std::out_of_range("json: key not found: " + std::string(key));
+        return it->value;
+    }
+
+    LazyDocument::LazyDocument(const std::string_view json) : json_(json)
+    {
+        const char* end = json.data() + json.size();
+        const char* p = internal::skipSpace(json.data(), end);
+        if (p >= end)
+            throw std::runtime_error("unexpected end");
+        root_ = LazyValue(p, end);
+    }
+}
@@ -0,0 +1,57 @@
+#include "cppkit/json/json_writer.hpp"
+
+#if defined(__SSE2__)
+#include <emmintrin.h>
+#elif defined(__ARM_NEON)
+#include <arm_neon.h>
+#endif
+
+namespace cppkit::json::internal
+{
+    static bool needsEscape(const unsigned char c)
+    {
+        return c < 0x20 || c == '"' || c == '\\';
+    }
+
+    size_t findEscape(const char* data, const size_t len) noexcept
+    {
+        size_t i = 0;
+#if defined(__SSE2__)
+        const __m128i quote = _mm_set1_epi8('"');
+        const __m128i backslash = _mm_set1_epi8('\\');
+        const __m128i ctrl = _mm_set1_epi8(0x1F);
+        for (; i + 16 <= len; i += 16)
+        {
+            const __m128i chunk = _mm_loadu_si128(reinterpret_cast<const __m128i*>(data + i));
+            // min(c, 0x1F) == c 即 c <= 0x1F（无符号比较）
+            const __m128i hit = _mm_or_si128(
+                _mm_or_si128(_mm_cmpeq_epi8(chunk, quote), _mm_cmpeq_epi8(chunk, backslash)),
+                _mm_cmpeq_epi8(_mm_min_epu8(chunk, ctrl), chunk));
+            if (const int mask = _mm_movemask_epi8(hit); mask != 0)
+            {
+                return i + static_cast<size_t>(__builtin_ctz(static_cast<unsigned>(mask)));
+            }
+        }
+#elif defined(__ARM_NEON)
+        const uint8x16_t quote = vdupq_n_u8('"');
+        const uint8x16_t backslash = vdupq_n_u8('\\');
+        const uint8x16_t ctrl = vdupq_n_u8(0x1F);
+        for (; i + 16 <= len; i += 16)
+        {
+            const uint8x16_t chunk = vld1q_u8(reinterpret_cast<const uint8_t*>(data + i));
+            const uint8x16_t hit = vorrq_u8(vorrq_u8(vceqq_u8(chunk, quote), vceqq_u8(chunk, backslash)),
+                                            vcleq_u8(chunk, ctrl));
+            if (vmaxvq_u8(hit) != 0)
+            {
+                break;
+            }
+        }
+#endif
+        for (; i < len; ++i)
+        {
+            if (needsEscape(static_cast<unsigned char>(data[i])))
+                return i;
+        }
+        return len;
+    }
+}
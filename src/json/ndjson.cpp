@@ -0,0 +1,254 @@
+#include "cppkit/json/ndjson.hpp"
+#include <algorithm>
+#include <cerrno>
+#include <cstring>
+#include <fcntl.h>
+#include <unistd.h>
+
+namespace cppkit::json
+{
+    // 每块至少这么多字节，避免小批次被切得过碎
+    static constexpr size_t kMinChunkBytes = 64 * 1024;
+
+    static int openOrThrow(const std::string& path, const int flags)
+    {
+        const int fd = ::open(path.c_str(), flags | O_CLOEXEC, 0644);
+        if (fd < 0)
+            throw std::runtime_error("ndjson: open " + path + " failed: " + std::strerror(errno));
+        return fd;
+    }
+
+    NdjsonReader::NdjsonReader(const std::string& path, concurrency::ThreadPool* pool, const size_t batchBytes)
+        : fd_(openOrThrow(path, O_RDONLY)), ownsFd_(true), pool_(pool), batchBytes_(std::max<size_t>(batchBytes, 1))
+    {
+    }
+
+    NdjsonReader::NdjsonReader(const io::File& file, concurrency::ThreadPool* pool, const size_t batchBytes)
+        : NdjsonReader(file.getAbsolutePath(), pool, batchBytes)
+    {
+    }
+
+    NdjsonReader::NdjsonReader(const int fd, concurrency::ThreadPool* pool, const size_t batchBytes)
+        : fd_(fd), ownsFd_(false), pool_(pool), batchBytes_(std::max<size_t>(batchBytes, 1))
+    {
+    }
+
+    NdjsonReader::~NdjsonReader()
+    {
+        if (ownsFd_)
+            ::close(fd_);
+    }
+
+    static void growBuffer(std::unique_ptr<char[]>& buffer, size_t& capacity, const size_t size, const size_t need)
+    {
+        if (capacity >= need)
+            return;
+        auto next = std::make_unique_for_overwrite<char[]>(need);
+        if (size)
+            std::memcpy(next.get(), buffer.get(), size);
+        buffer = std::move(next);
+        capacity = need;
+    }
+
+    bool NdjsonReader::fill(Batch& batch)
+    {
+        growBuffer(batch.buffer, batch.capacity, 0, std::max(batchBytes_, carry_.size() * 2));
+        char* buf = batch.buffer.get();
+        std::memcpy(buf, carry_.data(), carry_.size());
+        size_t size = carry_.size();
+        carry_.clear();
+
+        while (true)
+        {
+            while (!eof_ && size < batch.capacity)
+            {
+                const ssize_t n = ::read(fd_, batch.buffer.get() + size, batch.capacity - size);
+                if (n < 0)
+                {
+                    if (errno == EINTR)
+                        continue;
+                    throw std::runtime_error(std::string("ndjson: read failed: ") + std::strerror(errno));
+                }
+                if (n == 0)
+                    eof_ = true;
+                size += static_cast<size_t>(n);
+                bytesRead_ += static_cast<size_t>(n);
+            }
+            if (eof_)
+                break;
+
+            // 只处理完整的行，最后一个换行之后的部分留到下一批
+            buf = batch.buffer.get();
+            size_t end = size;
+            while (end > 0 && buf[end - 1] != '\n')
+                --end;
+            if (end > 0)
+            {
+                carry_.assign(buf + end, size - end);
+                size = end;
+                break;
+            }
+            // 单行超过了缓冲区，扩容后继续读
+            growBuffer(batch.buffer, batch.capacity, size, batch.capacity * 2);
+        }
+
+        buf = batch.buffer.get();
+        batch.size = size;
+        batch.firstLine = nextLine_;
+        nextLine_ += static_cast<size_t>(std::count(buf, buf + size, '\n'));
+        return size > 0;
+    }
+
+    void NdjsonReader::split(Batch& batch) const
+    {
+        size_t n = 1;
+        if (pool_)
+            n = std::clamp(batch.size / kMinChunkBytes, static_cast<size_t>(1), pool_->workerCount() * 2);
+        if (batch.chunks.size() < n)
+            batch.chunks.resize(n);
+
+        const char* p = batch.buffer.get();
+        const char* end = p + batch.size;
+        size_t count = 0;
+        for (size_t i = 0; i < n && p < end; ++i)
+        {
+            // 目标边界之后的第一个换行
+            const char* cut = i + 1 == n ? end : std::min(end, p + (end - p) / (n - i));
+            while (cut < end && cut[-1] != '\n')
+                ++cut;
+            batch.chunks[count++].text = std::string_view(p, cut - p);
+            p = cut;
+        }
+        batch.chunkCount = count;
+    }
+
+    void NdjsonReader::parseChunk(Chunk& chunk) noexcept
+    {
+        chunk.docs.clear();
+        chunk.error.clear();
+        chunk.errorAt = nullptr;
+        const char* p = chunk.text.data();
+        const char* end = p + chunk.text.size();
+        while (p < end)
+        {
+            const auto* nl = static_cast<const char*>(std::memchr(p, '\n', end - p));
+            const char* lineEnd = nl ? nl : end;
+            const char* q = p;
+            while (q < lineEnd && (*q == ' ' || *q == '\t' || *q == '\r'))
+                ++q;
+            if (q < lineEnd)
+            {
+                try
+                {
+                    chunk.docs.parse(std::string_view(q, lineEnd - q));
+                }
+                catch (const std::exception& e)
+                {
+                    chunk.error = e.what();
+                    chunk.errorAt = p;
+                    return;
+                }
+            }
+            p = lineEnd + 1;
+        }
+    }
+
+    size_t NdjsonReader::forEach(const std::function<void(const Json&)>& fn)
+    {
+        Batch batches[2];
+        size_t count = 0;
+        size_t cur = 0;
+        bool more = fill(batches[cur]);
+        std::vector<std::future<void>> pending;
+        while (more)
+        {
+            Batch& batch = batches[cur];
+            split(batch);
+
+            // 第一块在当前线程解析，其余交给线程池；等待期间预读下一批
+            pending.clear();
+            for (size_t i = 1; i < batch.chunkCount; ++i)
+                pending.push_back(pool_->enqueue(&NdjsonReader::parseChunk, std::ref(batch.chunks[i])));
+            try
+            {
+                more = fill(batches[cur ^ 1]);
+            }
+            catch (...)
+            {
+                for (auto& f : pending)
+                    f.wait();
+                throw;
+            }
+            parseChunk(batch.chunks[0]);
+            for (auto& f : pending)
+                f.wait();
+
+            for (size_t i = 0; i < batch.chunkCount; ++i)
+            {
+                const Chunk& chunk = batch.chunks[i];
+                for (const Json& doc : chunk.docs)
+                    fn(doc);
+                count += chunk.docs.size();
+                if (chunk.errorAt)
+                {
+                    const size_t line = batch.firstLine +
+                        static_cast<size_t>(std::count(static_cast<const char*>(batch.buffer.get()), chunk.errorAt, '\n'));
+                    throw std::runtime_error("ndjson: line " + std::to_string(line) + ": " + chunk.error);
+                }
+            }
+            cur ^= 1;
+        }
+        return count;
+    }
+
+    NdjsonWriter::NdjsonWriter(const std::string& path, const bool append, const size_t flushBytes)
+        : fd_(openOrThrow(path, O_WRONLY | O_CREAT | (append ? O_APPEND : O_TRUNC))), ownsFd_(true),
+          flushBytes_(flushBytes)
+    {
+        buffer_.reserve(flushBytes_ + flushBytes_ / 8);
+    }
+
+    NdjsonWriter::NdjsonWriter(const io::File& file, const bool append, const size_t flushBytes)
+        : NdjsonWriter(file.getAbsolutePath(), append, flushBytes)
+    {
+    }
+
+    NdjsonWriter::NdjsonWriter(const int fd, const size_t flushBytes)
+        : fd_(fd), ownsFd_(false), flushBytes_(flushBytes)
+    {
+        buffer_.reserve(flushBytes_ + flushBytes_ / 8);
+    }
+
+    NdjsonWriter::~NdjsonWriter()
+    {
+        try
+        {
+            flush();
+        }
+        catch (...)
+        {
+        }
+        if (ownsFd_)
+            ::close(fd_);
+    }
+
+    void NdjsonWriter::flush()
+    {
+        const char* p = buffer_.data();
+        size_t left = buffer_.size();
+        while (left > 0)
+        {
+            const ssize_t n = ::write(fd_, p, left);
+            if (n < 0)
+            {
+                if (errno == EINTR)
+                    continue;
+                throw std::runtime_error(std::string("ndjson: write failed: ") + std::strerror(errno));
+            }
+            p += n;
+            left -= static_cast<size_t>(n);
+            bytesWritten_ += static_cast<size_t>(n);
+        }
+        buffer_.clear();
+    }
+} // namespace cppkit::json
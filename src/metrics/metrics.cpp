@@ -0,0 +1,337 @@
+#include "cppkit/metrics/metrics.hpp"
+#include <algorithm>
+#include <charconv>
+#include <cmath>
+#include <stdexcept>
+
+namespace cppkit::metrics
+{
+    namespace
+    {
+        enum MetricType
+        {
+            TYPE_COUNTER,
+            TYPE_GAUGE,
+            TYPE_HISTOGRAM
+        };
+
+        const char* typeName(const int type)
+        {
+            switch (type)
+            {
+            case TYPE_COUNTER: return "counter";
+            case TYPE_GAUGE: return "gauge";
+            default: return "histogram";
+            }
+        }
+
+        void appendNumber(std::string& out, const uint64_t v)
+        {
+            char buf[24];
+            const auto res = std::to_chars(buf, buf + sizeof(buf), v);
+            out.append(buf, res.ptr);
+        }
+
+        void appendNumber(std::string& out, const int64_t v)
+        {
+            char buf[24];
+            const auto res = std::to_chars(buf, buf + sizeof(buf), v);
+            out.append(buf, res.ptr);
+        }
+
+        void appendNumber(std::string& out, const double v)
+        {
+            if (std::isinf(v))
+            {
+                out.append(v > 0 ? "+Inf" : "-Inf");
+                return;
+            }
+            char buf[32];
+            const auto res = std::to_chars(buf, buf + sizeof(buf), v);
+            out.append(buf, res.ptr);
+        }
+
+        // 标签值中的 \ " 和换行需要转义
+        void appendLabelValue(std::string& out, const std::string_view v)
+        {
+            for (const char c : v)
+            {
+                switch (c)
+                {
+                case '\\': out.append("\\\\");
+                    break;
+                case '"': out.append("\\\"");
+                    break;
+                case '\n': out.append("\\n");
+                    break;
+                default: out.push_back(c);
+                    break;
+                }
+            }
+        }
+
+        // 生成 a="1",b="2" 形式的标签文本，同时作为同一指标下各时间序列的键
+        std::string labelText(const Labels& labels)
+        {
+            std::string out;
+            for (const auto& [key, value] : labels)
+            {
+                if (!out.empty())
+                {
+                    out.push_back(',');
+                }
+                out.append(key).append("=\"");
+                appendLabelValue(out, value);
+                out.push_back('"');
+            }
+            return out;
+        }
+
+        // 写出 name{labels,extra} 部分
+        void appendSeries(std::string& out, const std::string_view name, const std::string_view suffix,
+                          const std::string& labels, const std::string_view extra = {})
+        {
+            out.append(name).append(suffix);
+            if (!labels.empty() || !extra.empty())
+            {
+                out.push_back('{');
+                out.append(labels);
+                if (!labels.empty() && !extra.empty())
+                {
+                    out.push_back(',');
+                }
+                out.append(extra);
+                out.push_back('}');
+            }
+            out.push_back(' ');
+        }
+    }
+
+    uint64_t Counter::value() const
+    {
+        uint64_t total = 0;
+        for (const auto& shard : _shards)
+        {
+            total += shard.value.load(std::memory_order_relaxed);
+        }
+        return total;
+    }
+
+    Histogram::Histogram(std::vector<double> bounds) : _bounds(std::move(bounds)),
+                                                       _buckets(new std::atomic<uint64_t>[HISTOGRAM_BUCKETS])
+    {
+        for (size_t i = 0; i < HISTOGRAM_BUCKETS; ++i)
+        {
+            _buckets[i].store(0, std::memory_order_relaxed);
+        }
+    }
+
+    uint64_t Histogram::bucketUpper(const size_t i)
+    {
+        if (i < 2 * HISTOGRAM_SUB_BUCKETS)
+        {
+            return i;
+        }
+        const size_t exp = i / HISTOGRAM_SUB_BUCKETS + 3;
+        const uint64_t sub = i % HISTOGRAM_SUB_BUCKETS;
+        if (i == HISTOGRAM_BUCKETS - 1)
+        {
+            return UINT64_MAX;
+        }
+        return ((HISTOGRAM_SUB_BUCKETS + sub + 1) << (exp - 4)) - 1;
+    }
+
+    uint64_t Histogram::count() const
+    {
+        uint64_t total = 0;
+        for (size_t i = 0; i < HISTOGRAM_BUCKETS; ++i)
+        {
+            total += _buckets[i].load(std::memory_order_relaxed);
+        }
+        return total;
+    }
+
+    std::vector<uint64_t> Histogram::snapshot() const
+    {
+        std::vector<uint64_t> counts(HISTOGRAM_BUCKETS);
+        for (size_t i = 0; i < HISTOGRAM_BUCKETS; ++i)
+        {
+            counts[i] = _buckets[i].load(std::memory_order_relaxed);
+        }
+        return counts;
+    }
+
+    uint64_t Histogram::percentile(double q) const
+    {
+        const auto counts = snapshot();
+        uint64_t total = 0;
+        for (const uint64_t c : counts)
+        {
+            total += c;
+        }
+        if (total == 0)
+        {
+            return 0;
+        }
+        q = std::min(1.0, std::max(0.0, q));
+        // 第 rank 个记录值（从 1 开始）所在的桶
+        const auto rank = std::max<uint64_t>(1, static_cast<uint64_t>(std::ceil(q * static_cast<double>(total))));
+        uint64_t seen = 0;
+        for (size_t i = 0; i < HISTOGRAM_BUCKETS; ++i)
+        {
+            seen += counts[i];
+            if (seen >= rank)
+            {
+                return bucketUpper(i);
+            }
+        }
+        return bucketUpper(HISTOGRAM_BUCKETS - 1);
+    }
+
+    struct Registry::Family
+    {
+        std::string help;
+        int type;
+        // 标签文本 -> 指标对象，只有与 type 对应的那个 map 非空
+        std::map<std::string, std::unique_ptr<Counter>> counters;
+        std::map<std::string, std::unique_ptr<Gauge>> gauges;
+        std::map<std::string, std::unique_ptr<Histogram>> histograms;
+    };
+
+    Registry& Registry::instance()
+    {
+        // 故意不析构：静态对象析构后仍可能有线程在更新缓存的指标引用
+        static auto* inst = new Registry();
+        return *inst;
+    }
+
+    Registry::Registry() = default;
+
+    Registry::~Registry() = default;
+
+    Registry::Family& Registry::family(const std::string& name, const std::string& help, const int type)
+    {
+        auto it = _families.find(name);
+        if (it == _families.end())
+        {
+            auto f = std::make_unique<Family>();
+            f->help = help;
+            f->type = type;
+            it = _families.emplace(name, std::move(f)).first;
+        }
+        else if (it->second->type != type)
+        {
+            throw std::runtime_error("metric " + name + " already registered as " + typeName(it->second->type));
+        }
+        return *it->second;
+    }
+
+    Counter& Registry::counter(const std::string& name, const std::string& help, const Labels& labels)
+    {
+        std::lock_guard lock(_mutex);
+        auto& slot = family(name, help, TYPE_COUNTER).counters[labelText(labels)];
+        if (!slot)
+        {
+            slot = std::make_unique<Counter>();
+        }
+        return *slot;
+    }
+
+    Gauge& Registry::gauge(const std::string& name, const std::string& help, const Labels& labels)
+    {
+        std::lock_guard lock(_mutex);
+        auto& slot = family(name, help, TYPE_GAUGE).gauges[labelText(labels)];
+        if (!slot)
+        {
+            slot = std::make_unique<Gauge>();
+        }
+        return *slot;
+    }
+
+    Histogram& Registry::histogram(const std::string& name, const std::string& help, const Labels& labels,
+                                   const std::vector<double>& bounds)
+    {
+        std::lock_guard lock(_mutex);
+        auto& slot = family(name, help, TYPE_HISTOGRAM).histograms[labelText(labels)];
+        if (!slot)
+        {
+            slot = std::make_unique<Histogram>(bounds);
+        }
+        return *slot;
+    }
+
+    std::string Registry::exportPrometheus() const
+    {
+        std::string out;
+        exportPrometheus(out);
+        return out;
+    }
+
+    void Registry::exportPrometheus(std::string& out) const
+    {
+        std::lock_guard lock(_mutex);
+        for (const auto& [name, f] : _families)
+        {
+            out.append("# HELP ").append(name).push_back(' ');
+            for (const char c : f->help)
+            {
+                if (c == '\\')
+                    out.append("\\\\");
+                else if (c == '\n')
+                    out.append("\\n");
+                else
+                    out.push_back(c);
+            }
+            out.append("\n# TYPE ").append(name).push_back(' ');
+            out.append(typeName(f->type)).push_back('\n');
+
+            for (const auto& [labels, c] : f->counters)
+            {
+                appendSeries(out, name, "", labels);
+                appendNumber(out, c->value());
+                out.push_back('\n');
+            }
+            for (const auto& [labels, g] : f->gauges)
+            {
+                appendSeries(out, name, "", labels);
+                appendNumber(out, g->value());
+                out.push_back('\n');
+            }
+            for (const auto& [labels, h] : f->histograms)
+            {
+                // 内部桶边界与 le 边界不对齐：桶内最大值不超过 le 时才计入，误差在一个子桶（6.25%）以内
+                const auto counts = h->snapshot();
+                uint64_t cumulative = 0;
+                size_t i = 0;
+                std::string le;
+                for (const double bound : h->bounds())
+                {
+                    const double limit = bound * 1e9;
+                    while (i < HISTOGRAM_BUCKETS && static_cast<double>(Histogram::bucketUpper(i)) <= limit)
+                    {
+                        cumulative += counts[i++];
+                    }
+                    le.assign("le=\"");
+                    appendNumber(le, bound);
+                    le.push_back('"');
+                    appendSeries(out, name, "_bucket", labels, le);
+                    appendNumber(out, cumulative);
+                    out.push_back('\n');
+                }
+                while (i < HISTOGRAM_BUCKETS)
+                {
+                    cumulative += counts[i++];
+                }
+                appendSeries(out, name, "_bucket", labels, "le=\"+Inf\"");
+                appendNumber(out, cumulative);
+                out.push_back('\n');
+                appendSeries(out, name, "_sum", labels);
+                appendNumber(out, static_cast<double>(h->sum()) / 1e9);
+                out.push_back('\n');
+                appendSeries(out, name, "_count", labels);
+                appendNumber(out, cumulative);
+                out.push_back('\n');
+            }
+        }
+    }
+} // namespace cppkit::metrics
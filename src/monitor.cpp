@@ -1,9 +1,19 @@
 #include "cppkit/monitor.hpp"
 #include "cppkit/platform.hpp"
+#include "cppkit/concurrency/seqlock.hpp"
 #include <sstream>
 #include <fstream>
 #include <filesystem>
 #include <algorithm>
+#include <condition_variable>
+#include <cstring>
+#include <map>
+#include <memory>
+#include <ranges>
+#include <mutex>
+#include <string_view>
+#include <thread>
+#include <utility>
 
 #ifdef _WIN32
     #define WIN32_LEAN_AND_MEAN
@@ -22,10 +32,367 @@
 #else
     #include <sys/statvfs.h>
     #include <unistd.h>
+    #include <fcntl.h>
+    #include <pthread.h>
+    #include <sys/syscall.h>
+    #include <ctime>
+#endif
+
+#ifndef _WIN32
+    #include <sys/resource.h>
 #endif
 
 namespace cppkit
 {
+    static int64_t SteadyNowNs()
+    {
+        return std::chrono::duration_cast<std::chrono::nanoseconds>(
+            std::chrono::steady_clock::now().time_since_epoch()).count();
+    }
+
+#if !defined(_WIN32) && !defined(__APPLE__)
+    // 常驻打开的 /proc 文件，每次从偏移 0 用 pread 重新读取，内容由内核重新生成
+    class ProcFile
+    {
+    public:
+        ProcFile() = default;
+
+        explicit ProcFile(const char* path) : fd_(open(path, O_RDONLY | O_CLOEXEC))
+        {
+        }
+
+        ~ProcFile()
+        {
+            if (fd_ >= 0)
+            {
+                close(fd_);
+            }
+        }
+
+        ProcFile(ProcFile&& other) noexcept : fd_(std::exchange(other.fd_, -1))
+        {
+        }
+
+        ProcFile& operator=(ProcFile&& other) noexcept
+        {
+            if (this != &other)
+            {
+                if (fd_ >= 0)
+                {
+                    close(fd_);
+                }
+                fd_ = std::exchange(other.fd_, -1);
+            }
+            return *this;
+        }
+
+        [[nodiscard]] bool IsOpen() const { return fd_ >= 0; }
+
+        // 读到 buffer 中并返回读到的内容，失败时为空；超出 buffer 的部分被截断
+        template <size_t N>
+        std::string_view Read(char (&buffer)[N]) const
+        {
+            if (fd_ < 0)
+            {
+                return {};
+            }
+            const ssize_t n = pread(fd_, buffer, N, 0);
+            return n > 0 ? std::string_view(buffer, n) : std::string_view();
+        }
+
+    private:
+        int fd_ = -1;
+    };
+
+    // 跳过非数字字符后解析一个无符号整数，s 前移到数字之后
+    static uint64_t ParseU64(std::string_view& s)
+    {
+        size_t i = 0;
+        while (i < s.size() && (s[i] < '0' || s[i] > '9'))
+        {
+            ++i;
+        }
+        uint64_t value = 0;
+        for (; i < s.size() && s[i] >= '0' && s[i] <= '9'; ++i)
+        {
+            value = value * 10 + (s[i] - '0');
+        }
+        s.remove_prefix(i);
+        return value;
+    }
+
+    // 解析 "1.25" 这样的小数，s 前移到数字之后
+    static double ParseDouble(std::string_view& s)
+    {
+        double value = static_cast<double>(ParseU64(s));
+        if (!s.empty() && s[0] == '.')
+        {
+            s.remove_prefix(1);
+            double scale = 0.1;
+            for (; !s.empty() && s[0] >= '0' && s[0] <= '9'; s.remove_prefix(1), scale /= 10)
+            {
+                value += (s[0] - '0') * scale;
+            }
+        }
+        return value;
+    }
+
+    // 找到以 key 开头的行并解析其后的数值，找不到时返回 0
+    static uint64_t ParseField(const std::string_view text, const std::string_view key)
+    {
+        for (size_t pos = text.find(key); pos != std::string_view::npos; pos = text.find(key, pos + 1))
+        {
+            if (pos == 0 || text[pos - 1] == '\n')
+            {
+                std::string_view rest = text.substr(pos + key.size());
+                return ParseU64(rest);
+            }
+        }
+        return 0;
+    }
+
+    // /proc/stat 第一行：cpu user nice system idle iowait irq softirq steal ...
+    static bool ParseCpuLine(std::string_view text, uint64_t& total, uint64_t& idle)
+    {
+        if (!text.starts_with("cpu "))
+        {
+            return false;
+        }
+        text = text.substr(0, text.find('\n'));
+        uint64_t fields[8]{};
+        for (uint64_t& field : fields)
+        {
+            field = ParseU64(text);
+        }
+        total = 0;
+        for (const uint64_t field : fields)
+        {
+            total += field;
+        }
+        idle = fields[3];
+        return true;
+    }
+
+    // 遍历目录中的数字名称（pid / tid / fd），目录 fd 保持打开，每次从头重新读取
+    template <typename F>
+    static void ForEachNumericEntry(const int dir_fd, F&& f)
+    {
+        struct LinuxDirent64
+        {
+            uint64_t d_ino;
+            int64_t d_off;
+            unsigned short d_reclen;
+            unsigned char d_type;
+            char d_name[1];
+        };
+
+        if (dir_fd < 0 || lseek(dir_fd, 0, SEEK_SET) < 0)
+        {
+            return;
+        }
+        alignas(8) char buffer[8192];
+        long n;
+        while ((n = syscall(SYS_getdents64, dir_fd, buffer, sizeof(buffer))) > 0)
+        {
+            for (long offset = 0; offset < n;)
+            {
+                const auto* entry = reinterpret_cast<const LinuxDirent64*>(buffer + offset);
+                offset += entry->d_reclen;
+                std::string_view name(entry->d_name);
+                if (!name.empty() && name[0] >= '0' && name[0] <= '9')
+                {
+                    f(static_cast<int>(ParseU64(name)));
+                }
+            }
+        }
+    }
+
+    // 同一进程内任意线程的 CPU 时钟（与 pthread_getcpuclockid 的构造方式相同，但只需要 tid）
+    static uint64_t ThreadCpuNs(const int tid)
+    {
+        const clockid_t clock = static_cast<clockid_t>((~static_cast<unsigned>(tid) << 3) | 6);
+        timespec ts{};
+        if (clock_gettime(clock, &ts) != 0)
+        {
+            return 0;
+        }
+        return static_cast<uint64_t>(ts.tv_sec) * 1000000000ULL + ts.tv_nsec;
+    }
+#endif
+
+    // 采集当前进程和各线程的指标，保存上一次的累计值用来计算使用率
+    class ProcessSampler
+    {
+    public:
+        // extra_fds: 调用方常驻打开、不应计入进程 fd 数的文件个数
+        explicit ProcessSampler(const uint32_t extra_fds = 0) : extra_fds_(extra_fds)
+#if !defined(_WIN32) && !defined(__APPLE__)
+            , statm_("/proc/self/statm"), io_("/proc/self/io"),
+              fd_dir_(open("/proc/self/fd", O_RDONLY | O_DIRECTORY | O_CLOEXEC)),
+              task_dir_(open("/proc/self/task", O_RDONLY | O_DIRECTORY | O_CLOEXEC))
+#endif
+        {
+        }
+
+        ~ProcessSampler()
+        {
+#if !defined(_WIN32) && !defined(__APPLE__)
+            for (const int fd : {fd_dir_, task_dir_})
+            {
+                if (fd >= 0)
+                {
+                    close(fd);
+                }
+            }
+#endif
+        }
+
+        ProcessSampler(const ProcessSampler&) = delete;
+        ProcessSampler& operator=(const ProcessSampler&) = delete;
+
+        // threads 为空时不采集线程指标；第一次采样只记录基准，使用率为 0
+        void Sample(ProcessMetrics& process, ThreadMetrics* threads, uint32_t& thread_count)
+        {
+            process = {};
+            thread_count = 0;
+            const int64_t now = SteadyNowNs();
+            const int64_t wall = std::max<int64_t>(now - last_wall_ns_, 1);
+
+            const uint64_t cpu_ns = ProcessCpuNs();
+            if (last_wall_ns_ != 0)
+            {
+                process.cpu_usage_percent = 100.0 * static_cast<double>(cpu_ns - last_cpu_ns_) / static_cast<double>(wall);
+            }
+            last_cpu_ns_ = cpu_ns;
+
+#ifndef _WIN32
+            rusage usage{};
+            if (getrusage(RUSAGE_SELF, &usage) == 0)
+            {
+                process.cpu_user_us = usage.ru_utime.tv_sec * 1000000ULL + usage.ru_utime.tv_usec;
+                process.cpu_system_us = usage.ru_stime.tv_sec * 1000000ULL + usage.ru_stime.tv_usec;
+                process.voluntary_ctx_switches = usage.ru_nvcsw;
+                process.involuntary_ctx_switches = usage.ru_nivcsw;
+            }
+#endif
+
+#if !defined(_WIN32) && !defined(__APPLE__)
+            char buffer[4096];
+
+            // statm: size resident shared ...（单位为页）
+            std::string_view statm = statm_.Read(buffer);
+            ParseU64(statm);
+            static const uint64_t page_kb = sysconf(_SC_PAGESIZE) / 1024;
+            process.rss_kb = ParseU64(statm) * page_kb;
+
+            const std::string_view io = io_.Read(buffer);
+            process.io_read_bytes = ParseField(io, "rchar:");
+            process.io_write_bytes = ParseField(io, "wchar:");
+            process.disk_read_bytes = ParseField(io, "read_bytes:");
+            process.disk_write_bytes = ParseField(io, "write_bytes:");
+
+            // 自己打开的 fd 不计入
+            uint32_t fds = 0;
+            ForEachNumericEntry(fd_dir_, [&](int) { ++fds; });
+            process.fd_count = fds > OwnedFds() ? fds - OwnedFds() : 0;
+
+            for (auto& state : threads_ | std::views::values)
+            {
+                state.seen = false;
+            }
+            ForEachNumericEntry(task_dir_, [&](const int tid)
+            {
+                ++process.thread_count;
+                if (!threads || thread_count == MAX_SAMPLED_THREADS)
+                {
+                    return;
+                }
+
+                auto [it, inserted] = threads_.try_emplace(tid);
+                ThreadState& state = it->second;
+                const uint64_t thread_cpu = ThreadCpuNs(tid);
+                if (inserted)
+                {
+                    const std::string path = "/proc/self/task/" + std::to_string(tid) + "/status";
+                    state.status = ProcFile(path.c_str());
+                    state.last_cpu_ns = thread_cpu;
+                }
+                state.seen = true;
+
+                ThreadMetrics& metrics = threads[thread_count++];
+                metrics = {};
+                metrics.tid = tid;
+                metrics.cpu_time_ns = thread_cpu;
+                metrics.cpu_usage_percent = 100.0 * static_cast<double>(thread_cpu - std::min(thread_cpu, state.last_cpu_ns))
+                    / static_cast<double>(wall);
+                state.last_cpu_ns = thread_cpu;
+
+                const std::string_view status = state.status.Read(buffer);
+                if (status.starts_with("Name:"))
+                {
+                    std::string_view name = status.substr(5, status.find('\n') - 5);
+                    name.remove_prefix(std::min(name.find_first_not_of(" \t"), name.size()));
+                    const size_t len = std::min(name.size(), sizeof(metrics.name) - 1);
+                    std::memcpy(metrics.name, name.data(), len);
+                }
+                metrics.voluntary_ctx_switches = ParseField(status, "voluntary_ctxt_switches:");
+                metrics.involuntary_ctx_switches = ParseField(status, "nonvoluntary_ctxt_switches:");
+            });
+
+            // 已经退出的线程关闭对应的文件
+            std::erase_if(threads_, [](const auto& entry) { return !entry.second.seen; });
+#endif
+            last_wall_ns_ = now;
+        }
+
+    private:
+        static uint64_t ProcessCpuNs()
+        {
+#ifndef _WIN32
+            timespec ts{};
+            if (clock_gettime(CLOCK_PROCESS_CPUTIME_ID, &ts) == 0)
+            {
+                return static_cast<uint64_t>(ts.tv_sec) * 1000000000ULL + ts.tv_nsec;
+            }
+#endif
+            return 0;
+        }
+
+        uint32_t extra_fds_;
+
+#if !defined(_WIN32) && !defined(__APPLE__)
+        struct ThreadState
+        {
+            ProcFile status;
+            uint64_t last_cpu_ns = 0;
+            bool seen = false;
+        };
+
+        [[nodiscard]] uint32_t OwnedFds() const
+        {
+            uint32_t count = extra_fds_;
+            for (const int fd : {fd_dir_, task_dir_})
+            {
+                count += fd >= 0;
+            }
+            count += statm_.IsOpen() + io_.IsOpen();
+            for (const auto& state : threads_ | std::views::values)
+            {
+                count += state.status.IsOpen();
+            }
+            return count;
+        }
+
+        ProcFile statm_;
+        ProcFile io_;
+        int fd_dir_ = -1;
+        int task_dir_ = -1;
+        std::map<int, ThreadState> threads_;
+#endif
+        int64_t last_wall_ns_ = 0;
+        uint64_t last_cpu_ns_ = 0;
+    };
+
     // 跨平台实现
     class Monitor::Impl
     {
@@ -36,8 +403,18 @@ namespace cppkit
             [[maybe_unused]] const bool success = ReadCpuStats(last_cpu_total_, last_cpu_idle_);
         }
 
+        ~Impl()
+        {
+            StopSampling();
+        }
+
         [[nodiscard]] double GetCpuUsage() const
         {
+            if (sampling_.load(std::memory_order_acquire))
+            {
+                return snapshot_.load().system.cpu_usage_percent;
+            }
+
             uint64_t cpu_total = 0, cpu_idle = 0;
 
             if (!ReadCpuStats(cpu_total, cpu_idle))
@@ -165,6 +542,10 @@ namespace cppkit
         {
 #ifdef _WIN32
             return {0.0, 0.0, 0.0};
+#elif !defined(__APPLE__)
+            std::vector<double> loadavg(3);
+            ReadLoadAverageLinux(loadavg.data());
+            return loadavg;
 #else
             std::vector<double> loadavg(3);
             if (getloadavg(loadavg.data(), 3) != 3)
@@ -191,19 +572,13 @@ namespace cppkit
             sysctl(mib, 4, nullptr, &len, nullptr, 0);
             return static_cast<int>(len / sizeof(struct kinfo_proc));
 #else
-            // Linux: 遍历/proc目录
+            // Linux: 统计/proc下的数字目录，只读目录项，不对每一项做 stat
+            const int proc_fd = open("/proc", O_RDONLY | O_DIRECTORY | O_CLOEXEC);
             int count = 0;
-            const std::string proc_path = "/proc";
-            for (const auto& entry : std::filesystem::directory_iterator(proc_path))
+            ForEachNumericEntry(proc_fd, [&](int) { ++count; });
+            if (proc_fd >= 0)
             {
-                if (entry.is_directory())
-                {
-                    const std::string name = entry.path().filename().string();
-                    if (std::all_of(name.begin(), name.end(), ::isdigit))
-                    {
-                        ++count;
-                    }
-                }
+                close(proc_fd);
             }
             return count;
 #endif
@@ -227,17 +602,163 @@ namespace cppkit
             return static_cast<uint64_t>(now_sec - boot_sec);
 #else
             // Linux: 读取/proc/uptime
-            std::ifstream uptime("/proc/uptime");
-            double up = 0.0;
-            uptime >> up;
-            return static_cast<uint64_t>(up);
+            char buffer[128];
+            std::string_view uptime = uptime_file_.Read(buffer);
+            return ParseU64(uptime);
 #endif
         }
 
+        [[nodiscard]] ProcessMetrics GetProcessMetrics() const
+        {
+            std::lock_guard lock(process_mutex_);
+            if (!process_sampler_)
+            {
+                process_sampler_ = std::make_unique<ProcessSampler>(OpenProcFiles());
+            }
+            ProcessMetrics metrics;
+            uint32_t thread_count = 0;
+            process_sampler_->Sample(metrics, nullptr, thread_count);
+            return metrics;
+        }
+
+        void StartSampling(const std::chrono::milliseconds interval, const bool per_thread)
+        {
+            std::lock_guard lock(sampling_mutex_);
+            if (sampling_thread_.joinable())
+            {
+                return;
+            }
+            stop_sampling_ = false;
+            sampling_thread_ = std::thread([this, interval, per_thread] { SamplingLoop(interval, per_thread); });
+            sampling_.store(true, std::memory_order_release);
+        }
+
+        void StopSampling()
+        {
+            std::unique_lock lock(sampling_mutex_);
+            if (!sampling_thread_.joinable())
+            {
+                return;
+            }
+            stop_sampling_ = true;
+            sampling_cv_.notify_all();
+            std::thread thread = std::move(sampling_thread_);
+            lock.unlock();
+            thread.join();
+            sampling_.store(false, std::memory_order_release);
+        }
+
+        [[nodiscard]] bool IsSampling() const
+        {
+            return sampling_.load(std::memory_order_acquire);
+        }
+
+        [[nodiscard]] MonitorSnapshot GetSnapshot() const
+        {
+            return snapshot_.load();
+        }
+
     private:
+        // 每次采样都重新读取这些文件，保持打开避免反复 open/close
+#if !defined(_WIN32) && !defined(__APPLE__)
+        ProcFile stat_file_{"/proc/stat"};
+        ProcFile meminfo_file_{"/proc/meminfo"};
+        ProcFile uptime_file_{"/proc/uptime"};
+        ProcFile loadavg_file_{"/proc/loadavg"};
+#endif
+
         mutable uint64_t last_cpu_total_;
         mutable uint64_t last_cpu_idle_;
 
+        // GetProcessMetrics 第一次调用时创建，与后台采样线程各自保存上一次的累计值
+        mutable std::mutex process_mutex_;
+        mutable std::unique_ptr<ProcessSampler> process_sampler_;
+
+        // 后台采样
+        std::mutex sampling_mutex_;
+        std::condition_variable sampling_cv_;
+        std::thread sampling_thread_;
+        bool stop_sampling_ = false;
+        std::atomic<bool> sampling_{false};
+        concurrency::SeqLock<MonitorSnapshot> snapshot_;
+
+        void SamplingLoop(const std::chrono::milliseconds interval, const bool per_thread)
+        {
+#if !defined(_WIN32) && !defined(__APPLE__)
+            pthread_setname_np(pthread_self(), "cppkit-monitor");
+#endif
+            // 采样线程自己的状态，只在这个线程上使用
+            ProcessSampler process(OpenProcFiles());
+            uint64_t last_total = 0, last_idle = 0;
+            [[maybe_unused]] const bool success = ReadCpuStats(last_total, last_idle);
+            MonitorSnapshot snapshot{};
+
+            auto next = std::chrono::steady_clock::now();
+            std::unique_lock lock(sampling_mutex_);
+            while (!stop_sampling_)
+            {
+                lock.unlock();
+                next += interval;
+
+                snapshot.sequence += 1;
+                snapshot.timestamp_ns = SteadyNowNs();
+
+                uint64_t total = 0, idle = 0;
+                if (ReadCpuStats(total, idle) && total > last_total)
+                {
+                    const double busy = 1.0 - static_cast<double>(idle - last_idle) / static_cast<double>(total - last_total);
+                    snapshot.system.cpu_usage_percent = std::clamp(100.0 * busy, 0.0, 100.0);
+                    last_total = total;
+                    last_idle = idle;
+                }
+                const auto [used, total_mb] = GetMemoryInfo();
+                snapshot.system.memory_used_mb = used;
+                snapshot.system.memory_total_mb = total_mb;
+                snapshot.system.memory_usage_percent = total_mb ? 100.0 * static_cast<double>(used) / static_cast<double>(total_mb) : 0.0;
+#if !defined(_WIN32) && !defined(__APPLE__)
+                ReadLoadAverageLinux(snapshot.load_average);
+#else
+                const std::vector<double> load = GetLoadAverage();
+                std::copy_n(load.begin(), std::min<size_t>(load.size(), 3), snapshot.load_average);
+#endif
+
+                process.Sample(snapshot.process, per_thread ? snapshot.threads : nullptr, snapshot.thread_count);
+
+#ifndef _WIN32
+                timespec ts{};
+                clock_gettime(CLOCK_THREAD_CPUTIME_ID, &ts);
+                snapshot.sampler_cpu_ns = static_cast<uint64_t>(ts.tv_sec) * 1000000000ULL + ts.tv_nsec;
+#endif
+                snapshot_.store(snapshot);
+
+                lock.lock();
+                sampling_cv_.wait_until(lock, next, [this] { return stop_sampling_; });
+            }
+        }
+
+        // Monitor 自己常驻打开的 /proc 文件个数
+        [[nodiscard]] uint32_t OpenProcFiles() const
+        {
+#if !defined(_WIN32) && !defined(__APPLE__)
+            return stat_file_.IsOpen() + meminfo_file_.IsOpen() + uptime_file_.IsOpen() + loadavg_file_.IsOpen();
+#else
+            return 0;
+#endif
+        }
+
+#if !defined(_WIN32) && !defined(__APPLE__)
+        // /proc/loadavg: "0.52 0.58 0.59 2/345 6789"
+        void ReadLoadAverageLinux(double out[3]) const
+        {
+            char buffer[128];
+            std::string_view text = loadavg_file_.Read(buffer);
+            for (int i = 0; i < 3; ++i)
+            {
+                out[i] = ParseDouble(text);
+            }
+        }
+#endif
+
         // 读取CPU统计信息
         [[nodiscard]] bool ReadCpuStats(uint64_t& total, uint64_t& idle) const
         {
@@ -299,25 +820,9 @@ namespace cppkit
 #ifndef __APPLE__
         [[nodiscard]] bool ReadCpuStatsLinux(uint64_t& total, uint64_t& idle) const
         {
-            std::ifstream stat("/proc/stat");
-            std::string line;
-            if (!std::getline(stat, line))
-            {
-                return false;
-            }
-
-            std::istringstream iss(line);
-            std::string cpu_label;
-            iss >> cpu_label;
-
-            uint64_t user = 0, nice = 0, system_time = 0, idle_time = 0;
-            uint64_t iowait = 0, irq = 0, softirq = 0, steal = 0;
-
-            iss >> user >> nice >> system_time >> idle_time >> iowait >> irq >> softirq >> steal;
-
-            total = user + nice + system_time + idle_time + iowait + irq + softirq + steal;
-            idle = idle_time;
-            return true;
+            // 只需要第一行，不读取后面很长的各 CPU 和中断统计
+            char buffer[1024];
+            return ParseCpuLine(stat_file_.Read(buffer), total, idle);
         }
 #endif
 #endif
@@ -397,31 +902,12 @@ namespace cppkit
 #ifndef __APPLE__
         [[nodiscard]] std::pair<uint64_t, uint64_t> GetMemoryInfoLinux() const
         {
-            std::ifstream meminfo("/proc/meminfo");
-            std::string line;
-            uint64_t total = 0, available = 0;
-
-            while (std::getline(meminfo, line))
-            {
-                std::istringstream iss(line);
-                std::string key;
-                uint64_t value;
-                std::string unit;
-
-                iss >> key >> value >> unit;
-
-                if (key == "MemTotal:")
-                {
-                    total = value / 1024; // KB to MB
-                }
-                else if (key == "MemAvailable:")
-                {
-                    available = value / 1024; // KB to MB
-                }
-            }
-
-            const uint64_t used = total - available;
-            return {used, total};
+            // MemTotal 和 MemAvailable 都在开头几行
+            char buffer[1024];
+            const std::string_view meminfo = meminfo_file_.Read(buffer);
+            const uint64_t total = ParseField(meminfo, "MemTotal:") / 1024; // KB to MB
+            const uint64_t available = ParseField(meminfo, "MemAvailable:") / 1024; // KB to MB
+            return {total - std::min(total, available), total};
         }
 #endif
 #endif
@@ -533,4 +1019,29 @@ namespace cppkit
     {
         return impl_->GetSystemUptime();
     }
+
+    ProcessMetrics Monitor::GetProcessMetrics() const
+    {
+        return impl_->GetProcessMetrics();
+    }
+
+    void Monitor::StartSampling(const std::chrono::milliseconds interval, const bool per_thread)
+    {
+        impl_->StartSampling(interval, per_thread);
+    }
+
+    void Monitor::StopSampling()
+    {
+        impl_->StopSampling();
+    }
+
+    bool Monitor::IsSampling() const
+    {
+        return impl_->IsSampling();
+    }
+
+    MonitorSnapshot Monitor::GetSnapshot() const
+    {
+        return impl_->GetSnapshot();
+    }
 }
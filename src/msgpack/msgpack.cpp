@@ -0,0 +1,361 @@
+#include "cppkit/msgpack/msgpack.hpp"
+
+namespace cppkit::msgpack
+{
+    static constexpr int kMaxDepth = 1024;
+
+    uint8_t Reader::next()
+    {
+        if (p_ == end_)
+            throw std::runtime_error("msgpack: unexpected end");
+        return *p_++;
+    }
+
+    const uint8_t* Reader::take(const size_t n)
+    {
+        if (static_cast<size_t>(end_ - p_) < n)
+            throw std::runtime_error("msgpack: unexpected end");
+        const uint8_t* p = p_;
+        p_ += n;
+        return p;
+    }
+
+    Reader::Type Reader::peek() const
+    {
+        if (p_ == end_)
+            throw std::runtime_error("msgpack: unexpected end");
+        const uint8_t b = *p_;
+        if (b <= 0x7F || b >= 0xE0)
+            return b <= 0x7F ? Type::Uint : Type::Int;
+        if (b <= 0x8F)
+            return Type::Map;
+        if (b <= 0x9F)
+            return Type::Array;
+        if (b <= 0xBF)
+            return Type::String;
+        switch (b)
+        {
+        case 0xC0:
+            return Type::Nil;
+        case 0xC2:
+        case 0xC3:
+            return Type::Bool;
+        case 0xC4:
+        case 0xC5:
+        case 0xC6:
+            return Type::Binary;
+        case 0xCA:
+        case 0xCB:
+            return Type::Float;
+        case 0xCC:
+        case 0xCD:
+        case 0xCE:
+        case 0xCF:
+            return Type::Uint;
+        case 0xD0:
+        case 0xD1:
+        case 0xD2:
+        case 0xD3:
+            return Type::Int;
+        case 0xD9:
+        case 0xDA:
+        case 0xDB:
+            return Type::String;
+        case 0xDC:
+        case 0xDD:
+            return Type::Array;
+        case 0xDE:
+        case 0xDF:
+            return Type::Map;
+        case 0xC7:
+        case 0xC8:
+        case 0xC9:
+        case 0xD4:
+        case 0xD5:
+        case 0xD6:
+        case 0xD7:
+        case 0xD8:
+            return Type::Extension;
+        default:
+            throw std::runtime_error("msgpack: invalid type byte");
+        }
+    }
+
+    bool Reader::tryNil()
+    {
+        if (p_ != end_ && *p_ == 0xC0)
+        {
+            ++p_;
+            return true;
+        }
+        return false;
+    }
+
+    bool Reader::readBool()
+    {
+        switch (next())
+        {
+        case 0xC2:
+            return false;
+        case 0xC3:
+            return true;
+        default:
+            throw std::runtime_error("msgpack: expected bool");
+        }
+    }
+
+    int64_t Reader::readInt64()
+    {
+        const uint8_t b = next();
+        if (b <= 0x7F)
+            return b;
+        if (b >= 0xE0)
+            return static_cast<int8_t>(b);
+        switch (b)
+        {
+        case 0xCC:
+            return readBigEndian<uint8_t>();
+        case 0xCD:
+            return readBigEndian<uint16_t>();
+        case 0xCE:
+            return readBigEndian<uint32_t>();
+        case 0xCF:
+            {
+                const auto v = readBigEndian<uint64_t>();
+                if (v > static_cast<uint64_t>(INT64_MAX))
+                    throw std::runtime_error("msgpack: integer out of range");
+                return static_cast<int64_t>(v);
+            }
+        case 0xD0:
+            return readBigEndian<int8_t>();
+        case 0xD1:
+            return readBigEndian<int16_t>();
+        case 0xD2:
+            return readBigEndian<int32_t>();
+        case 0xD3:
+            return readBigEndian<int64_t>();
+        default:
+            throw std::runtime_error("msgpack: expected integer");
+        }
+    }
+
+    uint64_t Reader::readUint64()
+    {
+        if (p_ != end_ && *p_ == 0xCF)
+        {
+            ++p_;
+            return readBigEndian<uint64_t>();
+        }
+        const int64_t v = readInt64();
+        if (v < 0)
+            throw std::runtime_error("msgpack: integer out of range");
+        return static_cast<uint64_t>(v);
+    }
+
+    double Reader::readDouble()
+    {
+        switch (peek())
+        {
+        case Type::Float:
+            if (next() == 0xCA)
+                return std::bit_cast<float>(readBigEndian<uint32_t>());
+            return std::bit_cast<double>(readBigEndian<uint64_t>());
+        case Type::Uint:
+            return static_cast<double>(readUint64());
+        case Type::Int:
+            return static_cast<double>(readInt64());
+        default:
+            throw std::runtime_error("msgpack: expected number");
+        }
+    }
+
+    std::string_view Reader::readString()
+    {
+        const uint8_t b = next();
+        size_t n;
+        if (b >= 0xA0 && b <= 0xBF)
+            n = b & 0x1F;
+        else if (b == 0xD9)
+            n = readBigEndian<uint8_t>();
+        else if (b == 0xDA)
+            n = readBigEndian<uint16_t>();
+        else if (b == 0xDB)
+            n = readBigEndian<uint32_t>();
+        else
+            throw std::runtime_error("msgpack: expected string");
+        return {reinterpret_cast<const char*>(take(n)), n};
+    }
+
+    std::span<const std::byte> Reader::readBinary()
+    {
+        size_t n;
+        switch (next())
+        {
+        case 0xC4:
+            n = readBigEndian<uint8_t>();
+            break;
+        case 0xC5:
+            n = readBigEndian<uint16_t>();
+            break;
+        case 0xC6:
+            n = readBigEndian<uint32_t>();
+            break;
+        default:
+            throw std::runtime_error("msgpack: expected binary");
+        }
+        return {reinterpret_cast<const std::byte*>(take(n)), n};
+    }
+
+    uint32_t Reader::readArrayHeader()
+    {
+        const uint8_t b = next();
+        if (b >= 0x90 && b <= 0x9F)
+            return b & 0x0F;
+        if (b == 0xDC)
+            return readBigEndian<uint16_t>();
+        if (b == 0xDD)
+            return readBigEndian<uint32_t>();
+        throw std::runtime_error("msgpack: expected array");
+    }
+
+    uint32_t Reader::readMapHeader()
+    {
+        const uint8_t b = next();
+        if (b >= 0x80 && b <= 0x8F)
+            return b & 0x0F;
+        if (b == 0xDE)
+            return readBigEndian<uint16_t>();
+        if (b == 0xDF)
+            return readBigEndian<uint32_t>();
+        throw std::runtime_error("msgpack: expected map");
+    }
+
+    void Reader::skip()
+    {
+        skip(0);
+    }
+
+    void Reader::skip(const int depth)
+    {
+        if (depth > kMaxDepth)
+            throw std::runtime_error("msgpack: nesting too deep");
+        switch (peek())
+        {
+        case Type::Nil:
+        case Type::Bool:
+            ++p_;
+            return;
+        case Type::Int:
+            readInt64();
+            return;
+        case Type::Uint:
+            readUint64();
+            return;
+        case Type::Float:
+            readDouble();
+            return;
+        case Type::String:
+            readString();
+            return;
+        case Type::Binary:
+            readBinary();
+            return;
+        case Type::Array:
+            for (uint32_t n = readArrayHeader(); n > 0; --n)
+                skip(depth + 1);
+            return;
+        case Type::Map:
+            for (uint32_t n = readMapHeader(); n > 0; --n)
+            {
+                skip(depth + 1);
+                skip(depth + 1);
+            }
+            return;
+        case Type::Extension:
+            {
+                static constexpr uint8_t fixedSize[] = {1, 2, 4, 8, 16}; // 0xD4 - 0xD8
+                const uint8_t b = next();
+                size_t n;
+                if (b >= 0xD4)
+                    n = fixedSize[b - 0xD4];
+                else if (b == 0xC7)
+                    n = readBigEndian<uint8_t>();
+                else if (b == 0xC8)
+                    n = readBigEndian<uint16_t>();
+                else
+                    n = readBigEndian<uint32_t>();
+                take(n + 1); // 类型字节 + 数据
+                return;
+            }
+        }
+    }
+
+    static json::Json readJson(Reader& in, const int depth)
+    {
+        if (depth > kMaxDepth)
+            throw std::runtime_error("msgpack: nesting too deep");
+        switch (in.peek())
+        {
+        case Reader::Type::Nil:
+            in.tryNil();
+            return json::Json();
+        case Reader::Type::Bool:
+            return json::Json(in.readBool());
+        case Reader::Type::Int:
+            return json::Json(static_cast<long>(in.readInt64()));
+        case Reader::Type::Uint:
+            return json::Json(in.readUint64());
+        case Reader::Type::Float:
+            return json::Json(in.readDouble());
+        case Reader::Type::String:
+            return json::Json(in.readString());
+        case Reader::Type::Binary:
+            {
+                const auto bytes = in.readBinary();
+                return json::Json(std::string_view(reinterpret_cast<const char*>(bytes.data()), bytes.size()));
+            }
+        case Reader::Type::Array:
+            {
+                json::Json::array arr;
+                const uint32_t n = in.readArrayHeader();
+                arr.reserve(std::min<size_t>(n, in.remaining()));
+                for (uint32_t i = 0; i < n; ++i)
+                    arr.push_back(readJson(in, depth + 1));
+                return json::Json(std::move(arr));
+            }
+        case Reader::Type::Map:
+            {
+                json::Json::object obj;
+                const uint32_t n = in.readMapHeader();
+                for (uint32_t i = 0; i < n; ++i)
+                {
+                    json::Json key = readJson(in, depth + 1);
+                    json::Json value = readJson(in, depth + 1);
+                    if (key.isString())
+                        obj.emplace(std::as_const(key).asString(), std::move(value));
+                    else
+                        obj.emplace(key.dump(), std::move(value));
+                }
+                return json::Json(std::move(obj));
+            }
+        case Reader::Type::Extension:
+            in.skip();
+            return json::Json();
+        }
+        return json::Json();
+    }
+
+    json::Json readJson(Reader& in)
+    {
+        return readJson(in, 0);
+    }
+
+    json::Json toJson(const std::string_view data)
+    {
+        Reader in(data);
+        json::Json json = readJson(in);
+        if (!in.atEnd())
+            throw std::runtime_error("msgpack: extra bytes after value");
+        return json;
+    }
+} // namespace cppkit::msgpack
@@ -1,17 +1,237 @@
 #include "cppkit/strings.hpp"
+#include <cstdint>
+#include <cstring>
 #include <sstream>
 
+#if defined(__x86_64__) || defined(__i386__)
+#include <immintrin.h>
+#endif
+
 namespace cppkit
 {
-    std::string trim(const std::string_view s)
+#if defined(__x86_64__) || defined(__i386__)
+    static bool useAvx2()
+    {
+        static const bool avx2 = __builtin_cpu_supports("avx2");
+        return avx2;
+    }
+
+    // 大小写转换：[first, first + 25] 范围内的字节异或 0x20，返回处理过的字节数（32 的整数倍）
+    __attribute__((target("avx2")))
+    static size_t foldCaseAvx2(char* dst, const char* src, const size_t n, const char first)
+    {
+        const __m256i lo = _mm256_set1_epi8(static_cast<char>(first - 1));
+        const __m256i hi = _mm256_set1_epi8(static_cast<char>(first + 26));
+        const __m256i flip = _mm256_set1_epi8(0x20);
+        size_t i = 0;
+        for (; i + 32 <= n; i += 32)
+        {
+            const __m256i v = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(src + i));
+            const __m256i letters = _mm256_and_si256(_mm256_cmpgt_epi8(v, lo), _mm256_cmpgt_epi8(hi, v));
+            _mm256_storeu_si256(reinterpret_cast<__m256i*>(dst + i),
+                                _mm256_xor_si256(v, _mm256_and_si256(letters, flip)));
+        }
+        return i;
+    }
+
+    __attribute__((target("avx2")))
+    static __m256i lower256(const __m256i v)
+    {
+        const __m256i letters = _mm256_and_si256(_mm256_cmpgt_epi8(v, _mm256_set1_epi8('A' - 1)),
+                                                 _mm256_cmpgt_epi8(_mm256_set1_epi8('Z' + 1), v));
+        return _mm256_or_si256(v, _mm256_and_si256(letters, _mm256_set1_epi8(0x20)));
+    }
+
+    // 按 32 字节一组比较小写形式，遇到不同的组返回 false；*done 为比较过的字节数
+    __attribute__((target("avx2")))
+    static bool iequalsAvx2(const char* a, const char* b, const size_t n, size_t* done)
+    {
+        size_t i = 0;
+        for (; i + 32 <= n; i += 32)
+        {
+            const __m256i x = lower256(_mm256_loadu_si256(reinterpret_cast<const __m256i*>(a + i)));
+            const __m256i y = lower256(_mm256_loadu_si256(reinterpret_cast<const __m256i*>(b + i)));
+            if (static_cast<unsigned>(_mm256_movemask_epi8(_mm256_cmpeq_epi8(x, y))) != 0xFFFFFFFFu)
+            {
+                return false;
+            }
+        }
+        *done = i;
+        return true;
+    }
+
+    // 在 [p, end) 中按 32 字节一组查找 chars（最多 8 个）中的任意一个，找不到时返回 nullptr，p 停在剩余不足一组处
+    __attribute__((target("avx2")))
+    static const char* scanAvx2(const char*& p, const char* end, const std::string_view chars)
+    {
+        __m256i needles[8];
+        for (size_t k = 0; k < chars.size(); ++k)
+        {
+            needles[k] = _mm256_set1_epi8(chars[k]);
+        }
+        for (; end - p >= 32; p += 32)
+        {
+            const __m256i v = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(p));
+            __m256i hit = _mm256_cmpeq_epi8(v, needles[0]);
+            for (size_t k = 1; k < chars.size(); ++k)
+            {
+                hit = _mm256_or_si256(hit, _mm256_cmpeq_epi8(v, needles[k]));
+            }
+            if (const int mask = _mm256_movemask_epi8(hit); mask != 0)
+            {
+                return p + __builtin_ctz(static_cast<unsigned>(mask));
+            }
+        }
+        return nullptr;
+    }
+#endif
+
+#if defined(__SSE2__)
+    static __m128i lower128(const __m128i v)
+    {
+        const __m128i letters = _mm_and_si128(_mm_cmpgt_epi8(v, _mm_set1_epi8('A' - 1)),
+                                              _mm_cmplt_epi8(v, _mm_set1_epi8('Z' + 1)));
+        return _mm_or_si128(v, _mm_and_si128(letters, _mm_set1_epi8(0x20)));
+    }
+#endif
+
+    // dst 可以和 src 相同（原地转换）
+    static void foldCase(char* dst, const char* src, const size_t n, const char first)
+    {
+        size_t i = 0;
+#if defined(__x86_64__) || defined(__i386__)
+        if (n >= 64 && useAvx2())
+        {
+            i = foldCaseAvx2(dst, src, n, first);
+        }
+#endif
+#if defined(__SSE2__)
+        const __m128i lo = _mm_set1_epi8(static_cast<char>(first - 1));
+        const __m128i hi = _mm_set1_epi8(static_cast<char>(first + 26));
+        const __m128i flip = _mm_set1_epi8(0x20);
+        for (; i + 16 <= n; i += 16)
+        {
+            const __m128i v = _mm_loadu_si128(reinterpret_cast<const __m128i*>(src + i));
+            const __m128i letters = _mm_and_si128(_mm_cmpgt_epi8(v, lo), _mm_cmplt_epi8(v, hi));
+            _mm_storeu_si128(reinterpret_cast<__m128i*>(dst + i), _mm_xor_si128(v, _mm_and_si128(letters, flip)));
+        }
+#endif
+        for (; i < n; ++i)
+        {
+            const auto c = static_cast<unsigned char>(src[i]);
+            dst[i] = static_cast<char>(static_cast<unsigned char>(c - first) < 26 ? c ^ 0x20 : c);
+        }
+    }
+
+    size_t findFirstOf(const std::string_view s, const std::string_view chars, const size_t pos)
+    {
+        if (pos >= s.size() || chars.empty())
+        {
+            return std::string_view::npos;
+        }
+        if (chars.size() == 1)
+        {
+            return s.find(chars[0], pos); // memchr 本身已经向量化
+        }
+        if (chars.size() > 8)
+        {
+            return s.find_first_of(chars, pos);
+        }
+
+        const char* p = s.data() + pos;
+        const char* end = s.data() + s.size();
+#if defined(__x86_64__) || defined(__i386__)
+        if (end - p >= 64 && useAvx2())
+        {
+            if (const char* hit = scanAvx2(p, end, chars))
+            {
+                return hit - s.data();
+            }
+        }
+#endif
+#if defined(__SSE2__)
+        __m128i needles[8];
+        for (size_t k = 0; k < chars.size(); ++k)
+        {
+            needles[k] = _mm_set1_epi8(chars[k]);
+        }
+        for (; end - p >= 16; p += 16)
+        {
+            const __m128i v = _mm_loadu_si128(reinterpret_cast<const __m128i*>(p));
+            __m128i hit = _mm_cmpeq_epi8(v, needles[0]);
+            for (size_t k = 1; k < chars.size(); ++k)
+            {
+                hit = _mm_or_si128(hit, _mm_cmpeq_epi8(v, needles[k]));
+            }
+            if (const int mask = _mm_movemask_epi8(hit); mask != 0)
+            {
+                return p - s.data() + __builtin_ctz(static_cast<unsigned>(mask));
+            }
+        }
+#endif
+        for (; p < end; ++p)
+        {
+            if (std::memchr(chars.data(), *p, chars.size()))
+            {
+                return p - s.data();
+            }
+        }
+        return std::string_view::npos;
+    }
+
+    bool iequals(const std::string_view a, const std::string_view b)
+    {
+        if (a.size() != b.size())
+        {
+            return false;
+        }
+        const size_t n = a.size();
+        size_t i = 0;
+#if defined(__x86_64__) || defined(__i386__)
+        if (n >= 64 && useAvx2() && !iequalsAvx2(a.data(), b.data(), n, &i))
+        {
+            return false;
+        }
+#endif
+#if defined(__SSE2__)
+        for (; i + 16 <= n; i += 16)
+        {
+            const __m128i x = lower128(_mm_loadu_si128(reinterpret_cast<const __m128i*>(a.data() + i)));
+            const __m128i y = lower128(_mm_loadu_si128(reinterpret_cast<const __m128i*>(b.data() + i)));
+            if (_mm_movemask_epi8(_mm_cmpeq_epi8(x, y)) != 0xFFFF)
+            {
+                return false;
+            }
+        }
+#endif
+        for (; i < n; ++i)
+        {
+            auto x = static_cast<unsigned char>(a[i]);
+            auto y = static_cast<unsigned char>(b[i]);
+            x |= static_cast<unsigned>(x - 'A') < 26u ? 0x20 : 0;
+            y |= static_cast<unsigned>(y - 'A') < 26u ? 0x20 : 0;
+            if (x != y)
+            {
+                return false;
+            }
+        }
+        return true;
+    }
+
+    std::string_view trimView(const std::string_view s)
     {
         const auto start = s.find_first_not_of(" \t\n\r");
-        const auto end = s.find_last_not_of(" \t\n\r");
-        if (start == std::string::npos)
+        if (start == std::string_view::npos)
         {
-            return "";
+            return {};
         }
-        return std::string(s.substr(start, end - start + 1));
+        const auto end = s.find_last_not_of(" \t\n\r");
+        return s.substr(start, end - start + 1);
+    }
+
+    std::string trim(const std::string_view s)
+    {
+        return std::string(trimView(s));
     }
 
     std::string join(const std::vector<std::string>& list, const std::string_view sep)
@@ -35,31 +255,58 @@ namespace cppkit
         return s.size() >= suffix.size() && s.compare(s.size() - suffix.size(), suffix.size(), suffix) == 0;
     }
 
+    void toLowerInPlace(std::string& s)
+    {
+        foldCase(s.data(), s.data(), s.size(), 'A');
+    }
+
+    void toUpperInPlace(std::string& s)
+    {
+        foldCase(s.data(), s.data(), s.size(), 'a');
+    }
+
+    void appendLower(std::string& out, const std::string_view s)
+    {
+        const size_t old = out.size();
+        out.resize(old + s.size());
+        foldCase(out.data() + old, s.data(), s.size(), 'A');
+    }
+
+    void appendUpper(std::string& out, const std::string_view s)
+    {
+        const size_t old = out.size();
+        out.resize(old + s.size());
+        foldCase(out.data() + old, s.data(), s.size(), 'a');
+    }
+
     std::string toLower(std::string s)
     {
-        std::ranges::transform(s, s.begin(), [](const unsigned char c) { return std::tolower(c); });
+        toLowerInPlace(s);
         return s;
     }
 
     std::string toUpper(std::string s)
     {
-        std::ranges::transform(s, s.begin(), [](const unsigned char c) { return std::toupper(c); });
+        toUpperInPlace(s);
         return s;
     }
 
-    std::vector<std::string> split(std::string_view s, const char delimiter)
+    void splitInto(const std::string_view s, const char delimiter, std::vector<std::string_view>& out)
     {
-        std::vector<std::string> result;
-        size_t start = 0;
-        size_t end = 0;
-
-        while ((end = s.find(delimiter, start)) != std::string::npos)
+        out.clear();
+        for (const std::string_view part : splitView(s, delimiter))
         {
-            result.emplace_back(s.substr(start, end - start));
-            start = end + 1;
+            out.push_back(part);
         }
+    }
 
-        result.emplace_back(s.substr(start));
+    std::vector<std::string> split(const std::string_view s, const char delimiter)
+    {
+        std::vector<std::string> result;
+        for (const std::string_view part : splitView(s, delimiter))
+        {
+            result.emplace_back(part);
+        }
         return result;
     }
 
@@ -75,6 +322,25 @@ namespace cppkit
             return s;
         }
 
+        if (to.size() <= from.size())
+        {
+            // 替换后不会变长：在 s 上原地前移，不再分配新字符串
+            size_t write = 0;
+            size_t read = 0;
+            size_t findPos;
+            for (size_t count = 0; count < maxReplaces && (findPos = s.find(from, read)) != std::string::npos; ++count)
+            {
+                std::memmove(s.data() + write, s.data() + read, findPos - read);
+                write += findPos - read;
+                std::memcpy(s.data() + write, to.data(), to.size());
+                write += to.size();
+                read = findPos + from.size();
+            }
+            std::memmove(s.data() + write, s.data() + read, s.size() - read);
+            s.resize(write + s.size() - read);
+            return s;
+        }
+
         std::string result;
         result.reserve(s.size());
 
@@ -97,30 +363,39 @@ namespace cppkit
         return result;
     }
 
-    std::string escapeHtml(const std::string_view s)
+    void appendEscapedHtml(std::string& out, const std::string_view s)
     {
-        std::string result;
-        result.reserve(s.size());
-
-        for (char c : s)
+        out.reserve(out.size() + s.size());
+        size_t start = 0;
+        while (true)
         {
-            switch (c)
+            const size_t pos = findFirstOf(s, "&<>\"'", start);
+            out.append(s.substr(start, pos - start));
+            if (pos == std::string_view::npos)
             {
-            case '&': result.append("&amp;");
                 break;
-            case '<': result.append("&lt;");
+            }
+            switch (s[pos])
+            {
+            case '&': out.append("&amp;");
                 break;
-            case '>': result.append("&gt;");
+            case '<': out.append("&lt;");
                 break;
-            case '"': result.append("&quot;");
+            case '>': out.append("&gt;");
                 break;
-            case '\'': result.append("&#39;");
+            case '"': out.append("&quot;");
                 break;
-            default: result.push_back(c);
+            default: out.append("&#39;");
                 break;
             }
+            start = pos + 1;
         }
+    }
 
+    std::string escapeHtml(const std::string_view s)
+    {
+        std::string result;
+        appendEscapedHtml(result, s);
         return result;
     }
 
@@ -179,44 +454,60 @@ namespace cppkit
         return -1;
     }
 
-    std::string urlDecode(const std::string_view s, const bool spaceAsPlus)
+    // 把 s 解码后写到 dst，返回写入的长度；写入位置从不超过读取位置，所以 dst 可以就是 s.data()
+    static size_t urlDecodeTo(char* dst, const std::string_view s, const bool spaceAsPlus)
     {
-        std::string result;
-        result.reserve(s.size());
-
-        for (size_t i = 0; i < s.size(); ++i)
+        const std::string_view special = spaceAsPlus ? "%+" : "%";
+        size_t out = 0;
+        size_t i = 0;
+        while (i < s.size())
         {
-            if (spaceAsPlus && s[i] == '+')
+            // 不需要解码的部分整段复制
+            const size_t pos = std::min(findFirstOf(s, special, i), s.size());
+            std::memmove(dst + out, s.data() + i, pos - i);
+            out += pos - i;
+            if (pos == s.size())
             {
-                result += ' ';
+                break;
             }
-            else if (s[i] == '%')
+
+            i = pos + 1;
+            if (s[pos] == '+')
             {
-                if (i + 2 < s.size())
-                {
-                    const int high = hexToInt(s[i + 1]);
-                    if (const int low = hexToInt(s[i + 2]); high != -1 && low != -1)
-                    {
-                        const unsigned char decodedChar = static_cast<unsigned char>(high) << 4
-                            | static_cast<unsigned char>(low);
-                        result += static_cast<char>(decodedChar);
-                        i += 2; // 跳过后面两个字符
-                    }
-                    else
-                    {
-                        result += '%';
-                    }
-                }
-                else
-                {
-                    result += '%';
-                }
+                dst[out++] = ' ';
+                continue;
             }
-            else
+            if (pos + 2 < s.size())
             {
-                result += s[i];
+                const int high = hexToInt(s[pos + 1]);
+                if (const int low = hexToInt(s[pos + 2]); high != -1 && low != -1)
+                {
+                    dst[out++] = static_cast<char>(static_cast<unsigned char>(high) << 4 | static_cast<unsigned char>(low));
+                    i += 2; // 跳过后面两个字符
+                    continue;
+                }
             }
+            dst[out++] = '%';
         }
+        return out;
+    }
+
+    void appendUrlDecoded(std::string& out, const std::string_view s, const bool spaceAsPlus)
+    {
+        const size_t old = out.size();
+        out.resize(old + s.size());
+        out.resize(old + urlDecodeTo(out.data() + old, s, spaceAsPlus));
+    }
+
+    void urlDecodeInPlace(std::string& s, const bool spaceAsPlus)
+    {
+        s.resize(urlDecodeTo(s.data(), s, spaceAsPlus));
+    }
+
+    std::string urlDecode(const std::string_view s, const bool spaceAsPlus)
+    {
+        std::string result;
+        appendUrlDecoded(result, s, spaceAsPlus);
         return result;
     }
 
@@ -263,4 +554,125 @@ namespace cppkit
         }
         return result;
     }
+
+#if defined(__x86_64__) || defined(__i386__)
+    __attribute__((target("avx2")))
+    static const uint8_t* skipAsciiAvx2(const uint8_t* p, const uint8_t* end)
+    {
+        for (; end - p >= 32; p += 32)
+        {
+            if (const int mask = _mm256_movemask_epi8(_mm256_loadu_si256(reinterpret_cast<const __m256i*>(p))); mask != 0)
+            {
+                return p + __builtin_ctz(static_cast<unsigned>(mask));
+            }
+        }
+        return p;
+    }
+#endif
+
+    // 跳过连续的 ASCII 字节，返回第一个非 ASCII 字节（或剩余不足一组时的位置）
+    static const uint8_t* skipAscii(const uint8_t* p, const uint8_t* end)
+    {
+#if defined(__x86_64__) || defined(__i386__)
+        if (end - p >= 64 && useAvx2())
+        {
+            // 遇到非 ASCII 字节时，下面的循环会在第一组立即停下
+            p = skipAsciiAvx2(p, end);
+        }
+#endif
+#if defined(__SSE2__)
+        for (; end - p >= 16; p += 16)
+        {
+            if (const int mask = _mm_movemask_epi8(_mm_loadu_si128(reinterpret_cast<const __m128i*>(p))); mask != 0)
+            {
+                return p + __builtin_ctz(static_cast<unsigned>(mask));
+            }
+        }
+#endif
+        for (; end - p >= 8; p += 8)
+        {
+            uint64_t v;
+            std::memcpy(&v, p, 8);
+            if (v & 0x8080808080808080ULL)
+            {
+                break;
+            }
+        }
+        return p;
+    }
+
+    bool isValidUtf8(const std::string_view s)
+    {
+        auto p = reinterpret_cast<const uint8_t*>(s.data());
+        const auto end = p + s.size();
+        while (p < end)
+        {
+            p = skipAscii(p, end);
+            if (p == end)
+            {
+                break;
+            }
+
+            const uint8_t c = *p;
+            if (c < 0x80)
+            {
+                ++p;
+                continue;
+            }
+
+            // 首字节决定后续字节数，以及第二个字节的合法范围（排除过长编码、代理区和超出 U+10FFFF 的码点）
+            size_t n;
+            uint8_t lo = 0x80, hi = 0xBF;
+            if (c >= 0xC2 && c <= 0xDF)
+            {
+                n = 1;
+            }
+            else if (c == 0xE0)
+            {
+                n = 2;
+                lo = 0xA0;
+            }
+            else if (c == 0xED)
+            {
+                n = 2;
+                hi = 0x9F;
+            }
+            else if (c >= 0xE1 && c <= 0xEF)
+            {
+                n = 2;
+            }
+            else if (c == 0xF0)
+            {
+                n = 3;
+                lo = 0x90;
+            }
+            else if (c == 0xF4)
+            {
+                n = 3;
+                hi = 0x8F;
+            }
+            else if (c >= 0xF1 && c <= 0xF3)
+            {
+                n = 3;
+            }
+            else
+            {
+                return false;
+            }
+
+            if (static_cast<size_t>(end - p) <= n || p[1] < lo || p[1] > hi)
+            {
+                return false;
+            }
+            for (size_t i = 2; i <= n; ++i)
+            {
+                if ((p[i] & 0xC0) != 0x80)
+                {
+                    return false;
+                }
+            }
+            p += n + 1;
+        }
+        return true;
+    }
 } // namespace cppkit
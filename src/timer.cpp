@@ -1,129 +1,377 @@
 #include "cppkit/timer.hpp"
+#include <algorithm>
+#include <bit>
+#include <stdexcept>
+#include <utility>
 
 namespace cppkit
 {
-    Timer::~Timer()
+    // 每个线程固定落在一个分片上，多线程添加任务时互不争锁
+    static size_t threadShardSlot()
     {
-        stop();
+        static std::atomic<size_t> nextSlot{0};
+        thread_local const size_t slot = nextSlot.fetch_add(1, std::memory_order_relaxed);
+        return slot;
     }
 
-    void Timer::cancel(const TimerId id)
+    // 在 256 位的位图中从 start 开始循环查找第一个置位，返回与 start 的距离，没有时返回 -1
+    template <size_t Words>
+    static int findNextSet(const std::array<uint64_t, Words>& bits, const size_t start)
     {
-        std::lock_guard lock(mutex);
-        if (const auto it = timerMap.find(id); it != timerMap.end())
+        constexpr size_t size = Words * 64;
+        for (size_t scanned = 0; scanned < size + 64;)
         {
-            // 标记为取消，下次 tick 遇到时会移除
-            // 这里使用 weak_ptr 防止在 callback 执行时被销毁
-            if (const auto ptr = it->second.lock())
+            const size_t pos = (start + scanned) % size;
+            const uint64_t word = bits[pos / 64] >> (pos % 64);
+            if (word != 0)
             {
-                ptr->canceled = true;
+                const size_t offset = scanned + static_cast<size_t>(std::countr_zero(word));
+                return offset < size ? static_cast<int>(offset) : -1;
             }
-            timerMap.erase(it);
+            scanned += 64 - pos % 64;
+        }
+        return -1;
+    }
+
+    Timer::Timer(const WheelConfig& config)
+        : tickDuration(std::max(config.tickDuration, std::chrono::microseconds(1))),
+          epoch(std::chrono::steady_clock::now()),
+          executor(config.executor),
+          running(false)
+    {
+        const size_t count = std::max<size_t>(config.shards, 1);
+        shards.reserve(count);
+        for (size_t i = 0; i < count; ++i)
+        {
+            shards.push_back(std::make_unique<Shard>());
         }
+        start();
+    }
+
+    Timer::~Timer()
+    {
+        stop();
+    }
+
+    void Timer::start()
+    {
+        running = true;
+        worker = std::thread([this] { this->runLoop(); });
     }
 
     void Timer::stop()
     {
         running = false;
+        wake();
         if (worker.joinable())
         {
             worker.join();
         }
     }
 
-    void Timer::start()
+    size_t Timer::pending() const
     {
-        running = true;
-        worker = std::thread([this] { this->runLoop(); });
+        size_t total = 0;
+        for (const auto& shard : shards)
+        {
+            std::lock_guard lock(shard->mutex);
+            total += shard->pending;
+        }
+        return total;
     }
 
-    void Timer::runLoop()
+    uint64_t Timer::nowTick() const
     {
-        while (running)
+        return static_cast<uint64_t>((std::chrono::steady_clock::now() - epoch) / tickDuration);
+    }
+
+    TimerId Timer::addTimer(const std::chrono::nanoseconds delay, const std::chrono::nanoseconds interval,
+                            std::function<void()> task)
+    {
+        // 向上取整，保证不会提前触发
+        const int64_t tickNs = std::chrono::duration_cast<std::chrono::nanoseconds>(tickDuration).count();
+        const int64_t at = (std::chrono::steady_clock::now() - epoch + std::max(delay, {})).count();
+        uint64_t expiry = static_cast<uint64_t>((at + tickNs - 1) / tickNs);
+        const uint64_t intervalTicks = interval.count() > 0
+                                           ? std::max<uint64_t>((interval.count() + tickNs - 1) / tickNs, 1)
+                                           : 0;
+
+        // 周期任务每次触发都要拷贝回调，包一层共享指针让拷贝不分配内存
+        if (intervalTicks > 0)
+        {
+            task = [fn = std::make_shared<std::function<void()>>(std::move(task))] { (*fn)(); };
+        }
+
+        const size_t shardIndex = threadShardSlot() % shards.size();
+        Shard& shard = *shards[shardIndex];
+        TimerId id;
         {
-            auto start_time = std::chrono::steady_clock::now();
+            std::lock_guard lock(shard.mutex);
 
+            TimerNode* node;
+            if (shard.freeNodes.empty())
             {
-                std::lock_guard<std::mutex> lock(mutex);
-                processCurrentSlot();
+                const auto index = static_cast<uint32_t>(shard.nodes.size());
+                if ((static_cast<uint64_t>(index) + 1) * shards.size() > UINT32_MAX)
+                {
+                    throw std::runtime_error("Too many pending timers");
+                }
+                node = &shard.nodes.emplace_back();
+                node->index = index;
+                node->generation = 1;
             }
-
-            // 计算下一格时间，补偿执行耗时
-            auto end_time = std::chrono::steady_clock::now();
-            auto elapsed = end_time - start_time;
-
-            if (auto sleepTime = tickDuration - elapsed; sleepTime.count() > 0)
+            else
             {
-                std::this_thread::sleep_for(sleepTime);
+                node = &shard.nodes[shard.freeNodes.back()];
+                shard.freeNodes.pop_back();
             }
 
-            // 指针前移
+            // 工作线程可能还没推进到当前时间，但不能排到已经处理过的 tick 上
+            expiry = std::max(expiry, shard.current + 1);
+            node->expiry = expiry;
+            node->interval = intervalTicks;
+            node->callback = std::move(task);
+            link(shard, node);
+            ++shard.pending;
+
+            id = static_cast<TimerId>(node->generation) << 32 | (node->index * shards.size() + shardIndex);
+        }
+
+        // 只有把计划醒来时间提前的那次插入去唤醒，避免并发插入都去抢唤醒锁
+        uint64_t planned = sleepUntil.load();
+        while (expiry < planned)
+        {
+            if (sleepUntil.compare_exchange_weak(planned, expiry))
             {
-                std::lock_guard<std::mutex> lock(mutex);
-                currentSlot = (currentSlot + 1) % wheelSize;
+                wake();
+                break;
             }
         }
+        return id;
+    }
+
+    bool Timer::cancel(const TimerId id)
+    {
+        const uint64_t low = id & UINT32_MAX;
+        Shard& shard = *shards[low % shards.size()];
+        const uint64_t index = low / shards.size();
+
+        std::lock_guard lock(shard.mutex);
+        if (index >= shard.nodes.size())
+        {
+            return false;
+        }
+        TimerNode* node = &shard.nodes[index];
+        if (node->generation != id >> 32 || node->pprev == nullptr)
+        {
+            return false;
+        }
+        unlink(shard, node);
+        releaseNode(shard, node);
+        return true;
     }
 
-    void Timer::processCurrentSlot()
+    void Timer::link(Shard& shard, TimerNode* node)
     {
-        auto& slot_list = slots[currentSlot];
+        const uint64_t delta = node->expiry > shard.current ? node->expiry - shard.current : 0;
 
-        auto it = slot_list.begin();
-        while (it != slot_list.end())
+        // 距离决定层级：第 l 层每格 256^l 个 tick；超出范围的先放在最高层最远处
+        size_t level = 0;
+        uint64_t position = node->expiry;
+        while (level < WHEEL_LEVELS - 1 && delta >> (WHEEL_BITS * (level + 1)) != 0)
         {
-            auto& task = *it;
+            ++level;
+        }
+        if (delta >> (WHEEL_BITS * WHEEL_LEVELS) != 0)
+        {
+            position = shard.current + (uint64_t{1} << WHEEL_BITS * WHEEL_LEVELS) - 1;
+        }
+        const size_t slot = position >> WHEEL_BITS * level & (WHEEL_SIZE - 1);
+
+        TimerNode*& head = shard.wheels[level][slot];
+        node->next = head;
+        if (head)
+        {
+            head->pprev = &node->next;
+        }
+        head = node;
+        node->pprev = &head;
+        node->level = static_cast<uint8_t>(level);
+        node->slot = static_cast<uint8_t>(slot);
+        shard.occupied[level][slot / 64] |= uint64_t{1} << slot % 64;
+    }
 
-            // 1. 如果任务已被取消，直接删除
-            if (task->canceled)
+    void Timer::unlink(Shard& shard, TimerNode* node)
+    {
+        *node->pprev = node->next;
+        if (node->next)
+        {
+            node->next->pprev = node->pprev;
+        }
+        if (shard.wheels[node->level][node->slot] == nullptr)
+        {
+            shard.occupied[node->level][node->slot / 64] &= ~(uint64_t{1} << node->slot % 64);
+        }
+        node->next = nullptr;
+        node->pprev = nullptr;
+    }
+
+    void Timer::releaseNode(Shard& shard, TimerNode* node)
+    {
+        node->callback = nullptr;
+        node->pprev = nullptr;
+        // 跳过 0，保证 ID 非 0
+        if (++node->generation == 0)
+        {
+            node->generation = 1;
+        }
+        shard.freeNodes.push_back(node->index);
+        --shard.pending;
+    }
+
+    uint64_t Timer::nextEventTick(const Shard& shard)
+    {
+        uint64_t next = UINT64_MAX;
+        for (size_t level = 0; level < WHEEL_LEVELS; ++level)
+        {
+            // 第 0 层是到期时间，更高层是降级时间（所在格的起点）
+            const size_t shift = WHEEL_BITS * level;
+            const uint64_t base = shard.current >> shift;
+            const int offset = findNextSet(shard.occupied[level], (base + 1) & (WHEEL_SIZE - 1));
+            if (offset >= 0)
             {
-                timerMap.erase(task->id); // 确保 map 也清理
-                it = slot_list.erase(it);
-                continue;
+                next = std::min(next, (base + static_cast<uint64_t>(offset) + 1) << shift);
             }
+        }
+        return next;
+    }
 
-            // 2. 检查圈数
-            if (task->rounds > 0)
+    uint64_t Timer::advance(Shard& shard, const uint64_t target, std::vector<std::function<void()>>& due) const
+    {
+        while (true)
+        {
+            // 中间没有任务的 tick 直接跳过
+            const uint64_t tick = nextEventTick(shard);
+            if (tick > target)
             {
-                task->rounds--; // 还没到时间，圈数减一，跳过
-                ++it;
+                shard.current = std::max(shard.current, target);
+                return tick;
             }
-            else
+            shard.current = tick;
+
+            // 从高层到低层降级：重新按距离挂到更低的层
+            for (size_t level = WHEEL_LEVELS - 1; level > 0; --level)
             {
-                try
+                const size_t shift = WHEEL_BITS * level;
+                if ((tick & ((uint64_t{1} << shift) - 1)) != 0)
                 {
-                    task->callback();
+                    continue;
                 }
-                catch (...)
+                const size_t slot = tick >> shift & (WHEEL_SIZE - 1);
+                TimerNode* node = std::exchange(shard.wheels[level][slot], nullptr);
+                shard.occupied[level][slot / 64] &= ~(uint64_t{1} << slot % 64);
+                while (node)
                 {
+                    TimerNode* next = node->next;
+                    link(shard, node);
+                    node = next;
                 }
+            }
 
-                if (task->periodic && !task->canceled)
+            // 第 0 层当前格里的任务都在这个 tick 到期
+            const size_t slot = tick & (WHEEL_SIZE - 1);
+            TimerNode* node = std::exchange(shard.wheels[0][slot], nullptr);
+            shard.occupied[0][slot / 64] &= ~(uint64_t{1} << slot % 64);
+            while (node)
+            {
+                TimerNode* next = node->next;
+                if (node->interval == 0)
                 {
-                    // 周期任务：重新计算位置并插入
-                    reschedulePeriodic(task);
-                    it = slot_list.erase(it); // 从当前位置移除 (已经移到新位置了)
+                    due.push_back(std::move(node->callback));
+                    releaseNode(shard, node);
                 }
                 else
                 {
-                    // 一次性任务：彻底移除
-                    timerMap.erase(task->id);
-                    it = slot_list.erase(it);
+                    // 周期任务按原相位排下一次，落后太多时跳过错过的周期，不补触发
+                    due.push_back(node->callback);
+                    uint64_t expiry = node->expiry + node->interval;
+                    if (expiry <= target)
+                    {
+                        expiry += ((target - expiry) / node->interval + 1) * node->interval;
+                    }
+                    node->expiry = expiry;
+                    link(shard, node);
                 }
+                node = next;
             }
         }
     }
 
-    void Timer::reschedulePeriodic(const TaskPtr& task)
+    void Timer::dispatch(std::vector<std::function<void()>>& due) const
     {
-        // 重新计算
-        size_t ticks = task->interval.count() / tickDuration.count();
-        if (ticks == 0) ticks = 1;
+        for (auto& callback : due)
+        {
+            try
+            {
+                if (executor)
+                {
+                    (void)executor->enqueue(std::move(callback));
+                }
+                else
+                {
+                    callback();
+                }
+            }
+            catch (...)
+            {
+            }
+        }
+        due.clear();
+    }
 
-        const size_t rounds = ticks / wheelSize;
-        const size_t targetSlot = (currentSlot + ticks) % wheelSize;
+    void Timer::wake()
+    {
+        {
+            std::lock_guard lock(wakeMutex);
+            wakeRequested = true;
+        }
+        wakeCv.notify_one();
+    }
 
-        task->rounds = rounds;
-        slots[targetSlot].push_back(task);
+    void Timer::runLoop()
+    {
+        std::vector<std::function<void()>> due;
+        while (running)
+        {
+            // 处理期间加入的任务都会请求唤醒，处理完后重新检查
+            sleepUntil.store(UINT64_MAX);
+
+            const uint64_t target = nowTick();
+            uint64_t next = UINT64_MAX;
+            for (const auto& shard : shards)
+            {
+                std::lock_guard lock(shard->mutex);
+                next = std::min(next, advance(*shard, target, due));
+            }
+
+            // 回调在分片锁之外执行，回调里可以添加或取消任务
+            dispatch(due);
+
+            std::unique_lock lock(wakeMutex);
+            if (!wakeRequested && running)
+            {
+                sleepUntil.store(next);
+                const auto woken = [this] { return wakeRequested || !running; };
+                if (next == UINT64_MAX)
+                {
+                    wakeCv.wait(lock, woken);
+                }
+                else
+                {
+                    wakeCv.wait_until(lock, epoch + next * tickDuration, woken);
+                }
+            }
+            wakeRequested = false;
+        }
     }
 }
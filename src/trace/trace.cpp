@@ -0,0 +1,435 @@
+#include "cppkit/trace/trace.hpp"
+#include <algorithm>
+#include <bit>
+#include <fstream>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <random>
+#include <stdexcept>
+#include <thread>
+
+#if !defined(_WIN32)
+#include <pthread.h>
+#include <unistd.h>
+#endif
+#if defined(__linux__)
+#include <sys/syscall.h>
+#endif
+
+namespace cppkit::trace
+{
+    namespace
+    {
+        // 每条记录占 8 个字：name、traceHigh、traceLow、spanId、parentId、startNs、durationNs、flags
+        constexpr size_t RECORD_WORDS = 8;
+
+        // 单写者环形缓冲区。写者先公布 started 再写数据，最后公布 committed；
+        // 读者读完数据后再看 started，被新记录覆盖过的槽位直接丢弃，读写都是原子操作
+        struct ThreadBuffer
+        {
+            explicit ThreadBuffer(const size_t capacity) : capacity(capacity),
+                                                           words(new std::atomic<uint64_t>[capacity * RECORD_WORDS])
+            {
+                for (size_t i = 0; i < capacity * RECORD_WORDS; ++i)
+                {
+                    words[i].store(0, std::memory_order_relaxed);
+                }
+            }
+
+            void push(const uint64_t (&record)[RECORD_WORDS])
+            {
+                const uint64_t index = started.load(std::memory_order_relaxed);
+                started.store(index + 1, std::memory_order_relaxed);
+                std::atomic_thread_fence(std::memory_order_release);
+                std::atomic<uint64_t>* slot = &words[(index & (capacity - 1)) * RECORD_WORDS];
+                for (size_t i = 0; i < RECORD_WORDS; ++i)
+                {
+                    slot[i].store(record[i], std::memory_order_relaxed);
+                }
+                committed.store(index + 1, std::memory_order_release);
+            }
+
+            // 只由导出者调用（持有全局锁）
+            void drain(std::vector<SpanRecord>& out)
+            {
+                const uint64_t end = committed.load(std::memory_order_acquire);
+                const uint64_t begin = std::max(readPos, end > capacity ? end - capacity : 0);
+                const size_t first = out.size();
+                for (uint64_t index = begin; index < end; ++index)
+                {
+                    const std::atomic<uint64_t>* slot = &words[(index & (capacity - 1)) * RECORD_WORDS];
+                    uint64_t w[RECORD_WORDS];
+                    for (size_t i = 0; i < RECORD_WORDS; ++i)
+                    {
+                        w[i] = slot[i].load(std::memory_order_relaxed);
+                    }
+                    out.push_back(SpanRecord{
+                        reinterpret_cast<const char*>(w[0]),
+                        Context{w[1], w[2], w[3], static_cast<uint8_t>(w[7])},
+                        w[4], w[5], w[6], tid
+                    });
+                }
+                std::atomic_thread_fence(std::memory_order_acquire);
+                // 读的过程中写者可能已经开始覆盖最旧的几条
+                if (const uint64_t s = started.load(std::memory_order_relaxed); s > capacity && s - capacity > begin)
+                {
+                    const uint64_t lost = std::min(s - capacity, end) - begin;
+                    out.erase(out.begin() + static_cast<std::ptrdiff_t>(first),
+                              out.begin() + static_cast<std::ptrdiff_t>(first + lost));
+                }
+                readPos = end;
+            }
+
+            const size_t capacity;
+            std::unique_ptr<std::atomic<uint64_t>[]> words;
+            alignas(64) std::atomic<uint64_t> started{0};
+            std::atomic<uint64_t> committed{0};
+            alignas(64) uint64_t readPos = 0;
+            int tid = 0;
+            std::string threadName;
+            std::atomic<bool> exited{false};
+        };
+
+        struct BufferRegistry
+        {
+            std::mutex mutex;
+            std::vector<std::shared_ptr<ThreadBuffer>> buffers;
+            std::atomic<size_t> capacity{DEFAULT_BUFFER_CAPACITY};
+        };
+
+        BufferRegistry& registry()
+        {
+            // 故意不析构：线程退出时仍会访问
+            static auto* inst = new BufferRegistry();
+            return *inst;
+        }
+
+        int currentTid()
+        {
+#if defined(__linux__)
+            return static_cast<int>(syscall(SYS_gettid));
+#else
+            return static_cast<int>(std::hash<std::thread::id>{}(std::this_thread::get_id()));
+#endif
+        }
+
+        // 线程退出时标记缓冲区，导出一次后移除
+        struct BufferHolder
+        {
+            std::shared_ptr<ThreadBuffer> buffer;
+
+            ~BufferHolder()
+            {
+                if (buffer)
+                {
+                    buffer->exited.store(true, std::memory_order_release);
+                }
+            }
+        };
+
+        ThreadBuffer& threadBuffer()
+        {
+            thread_local BufferHolder holder;
+            if (!holder.buffer)
+            {
+                auto& reg = registry();
+                auto buffer = std::make_shared<ThreadBuffer>(reg.capacity.load(std::memory_order_relaxed));
+                buffer->tid = currentTid();
+#if !defined(_WIN32)
+                char name[16] = {};
+                pthread_getname_np(pthread_self(), name, sizeof(name));
+                buffer->threadName = name;
+#endif
+                std::lock_guard lock(reg.mutex);
+                reg.buffers.push_back(buffer);
+                holder.buffer = std::move(buffer);
+            }
+            return *holder.buffer;
+        }
+
+        uint64_t randomId()
+        {
+            // splitmix64，每个线程独立的种子
+            thread_local uint64_t state = (static_cast<uint64_t>(std::random_device{}()) << 32) ^
+                std::random_device{}() ^ static_cast<uint64_t>(currentTid());
+            uint64_t id;
+            do
+            {
+                uint64_t z = (state += 0x9e3779b97f4a7c15ULL);
+                z = (z ^ (z >> 30)) * 0xbf58476d1ce4e5b9ULL;
+                z = (z ^ (z >> 27)) * 0x94d049bb133111ebULL;
+                id = z ^ (z >> 31);
+            }
+            while (id == 0);
+            return id;
+        }
+
+        constexpr char HEX[] = "0123456789abcdef";
+
+        void appendHex(std::string& out, const uint64_t v)
+        {
+            for (int shift = 60; shift >= 0; shift -= 4)
+            {
+                out.push_back(HEX[(v >> shift) & 0xF]);
+            }
+        }
+
+        int hexValue(const char c)
+        {
+            if (c >= '0' && c <= '9') return c - '0';
+            if (c >= 'a' && c <= 'f') return c - 'a' + 10;
+            return -1; // W3C 要求小写
+        }
+
+        bool parseHex(const std::string_view s, uint64_t& out)
+        {
+            out = 0;
+            for (const char c : s)
+            {
+                const int v = hexValue(c);
+                if (v < 0)
+                {
+                    return false;
+                }
+                out = out << 4 | static_cast<uint64_t>(v);
+            }
+            return true;
+        }
+
+        // 微秒，保留 3 位小数
+        void appendMicros(std::string& out, const uint64_t ns)
+        {
+            out.append(std::to_string(ns / 1000));
+            out.push_back('.');
+            const uint64_t frac = ns % 1000;
+            out.push_back(static_cast<char>('0' + frac / 100));
+            out.push_back(static_cast<char>('0' + frac / 10 % 10));
+            out.push_back(static_cast<char>('0' + frac % 10));
+        }
+
+        void appendJsonString(std::string& out, const std::string_view s)
+        {
+            out.push_back('"');
+            for (const char c : s)
+            {
+                if (c == '"' || c == '\\')
+                {
+                    out.push_back('\\');
+                    out.push_back(c);
+                }
+                else if (static_cast<unsigned char>(c) < 0x20)
+                {
+                    out.append("\\u00");
+                    out.push_back(HEX[(c >> 4) & 0xF]);
+                    out.push_back(HEX[c & 0xF]);
+                }
+                else
+                {
+                    out.push_back(c);
+                }
+            }
+            out.push_back('"');
+        }
+    }
+
+    std::string Context::traceparent() const
+    {
+        std::string out;
+        out.reserve(55);
+        out.append("00-");
+        appendHex(out, traceHigh);
+        appendHex(out, traceLow);
+        out.push_back('-');
+        appendHex(out, spanId);
+        out.push_back('-');
+        out.push_back(HEX[flags >> 4]);
+        out.push_back(HEX[flags & 0xF]);
+        return out;
+    }
+
+    Context Context::fromTraceparent(std::string_view header)
+    {
+        // 版本 00 长度固定为 55；更高版本可以在后面追加字段，ff 保留不用
+        while (!header.empty() && (header.front() == ' ' || header.front() == '\t'))
+            header.remove_prefix(1);
+        while (!header.empty() && (header.back() == ' ' || header.back() == '\t'))
+            header.remove_suffix(1);
+        if (header.size() < 55 || header[2] != '-' || header[35] != '-' || header[52] != '-')
+        {
+            return {};
+        }
+        uint64_t version;
+        if (!parseHex(header.substr(0, 2), version) || version == 0xff ||
+            (version == 0 && header.size() != 55) || (header.size() > 55 && header[55] != '-'))
+        {
+            return {};
+        }
+        Context ctx;
+        uint64_t flags;
+        if (!parseHex(header.substr(3, 16), ctx.traceHigh) || !parseHex(header.substr(19, 16), ctx.traceLow) ||
+            !parseHex(header.substr(36, 16), ctx.spanId) || !parseHex(header.substr(53, 2), flags))
+        {
+            return {};
+        }
+        ctx.flags = static_cast<uint8_t>(flags);
+        return ctx.valid() ? ctx : Context{};
+    }
+
+    void setEnabled(const bool on)
+    {
+        inner::enabled.store(on, std::memory_order_relaxed);
+    }
+
+    void setBufferCapacity(const size_t spans)
+    {
+        registry().capacity.store(std::bit_ceil(std::max<size_t>(spans, 2)), std::memory_order_relaxed);
+    }
+
+    void inner::begin(Context& context, Context& previous, uint64_t& parentId, uint64_t& startNs,
+                      const Context& parent)
+    {
+        previous = current;
+        if (parent.valid())
+        {
+            context = parent;
+            parentId = parent.spanId;
+        }
+        else
+        {
+            context.traceHigh = randomId();
+            context.traceLow = randomId();
+            context.flags = 0x01;
+            parentId = 0;
+        }
+        context.spanId = randomId();
+        current = context;
+        startNs = nowNs();
+    }
+
+    void inner::finish(const char* name, const Context& context, const Context& previous, const uint64_t parentId,
+                       const uint64_t startNs, const uint64_t endNs)
+    {
+        current = previous;
+        if (!context.sampled())
+        {
+            return;
+        }
+        const uint64_t record[RECORD_WORDS] = {
+            reinterpret_cast<uint64_t>(name), context.traceHigh, context.traceLow, context.spanId, parentId,
+            startNs, endNs > startNs ? endNs - startNs : 0, context.flags
+        };
+        threadBuffer().push(record);
+    }
+
+    void record(const char* name, const uint64_t startNs, const uint64_t endNs)
+    {
+        if (!enabled())
+        {
+            return;
+        }
+        Context context;
+        Context previous;
+        uint64_t parentId;
+        uint64_t ignored;
+        inner::begin(context, previous, parentId, ignored, inner::current);
+        inner::finish(name, context, previous, parentId, startNs, endNs);
+    }
+
+    std::vector<SpanRecord> collect()
+    {
+        auto& reg = registry();
+        std::vector<SpanRecord> out;
+        std::lock_guard lock(reg.mutex);
+        for (const auto& buffer : reg.buffers)
+        {
+            buffer->drain(out);
+        }
+        // 已退出线程的缓冲区取空后不再需要
+        std::erase_if(reg.buffers, [](const std::shared_ptr<ThreadBuffer>& b)
+        {
+            return b->exited.load(std::memory_order_acquire) &&
+                b->readPos == b->committed.load(std::memory_order_acquire);
+        });
+        return out;
+    }
+
+    std::string chromeTraceJson()
+    {
+        // 线程名在 collect 之前取，退出的线程在 collect 之后就被移除了
+        std::vector<std::pair<int, std::string>> threads;
+        {
+            auto& reg = registry();
+            std::lock_guard lock(reg.mutex);
+            for (const auto& buffer : reg.buffers)
+            {
+                threads.emplace_back(buffer->tid, buffer->threadName);
+            }
+        }
+        const auto spans = collect();
+
+#if !defined(_WIN32)
+        const std::string pid = std::to_string(getpid());
+#else
+        const std::string pid = "0";
+#endif
+        std::string out;
+        out.reserve(256 + spans.size() * 256);
+        out.append("{\"displayTimeUnit\":\"ns\",\"traceEvents\":[");
+        bool first = true;
+        for (const auto& [tid, name] : threads)
+        {
+            if (name.empty())
+            {
+                continue;
+            }
+            out.append(first ? "\n" : ",\n");
+            first = false;
+            out.append("{\"name\":\"thread_name\",\"ph\":\"M\",\"pid\":").append(pid);
+            out.append(",\"tid\":").append(std::to_string(tid)).append(",\"args\":{\"name\":");
+            appendJsonString(out, name);
+            out.append("}}");
+        }
+        for (const auto& span : spans)
+        {
+            out.append(first ? "\n" : ",\n");
+            first = false;
+            out.append("{\"name\":");
+            appendJsonString(out, span.name ? span.name : "");
+            out.append(",\"cat\":\"cppkit\",\"ph\":\"X\",\"pid\":").append(pid);
+            out.append(",\"tid\":").append(std::to_string(span.tid));
+            out.append(",\"ts\":");
+            appendMicros(out, span.startNs);
+            out.append(",\"dur\":");
+            appendMicros(out, span.durationNs);
+            out.append(",\"args\":{\"trace_id\":\"");
+            appendHex(out, span.context.traceHigh);
+            appendHex(out, span.context.traceLow);
+            out.append("\",\"span_id\":\"");
+            appendHex(out, span.context.spanId);
+            out.append("\",\"parent_span_id\":\"");
+            if (span.parentSpanId != 0)
+            {
+                appendHex(out, span.parentSpanId);
+            }
+            out.append("\"}}");
+        }
+        out.append("\n]}\n");
+        return out;
+    }
+
+    void writeChromeTrace(const std::string& path)
+    {
+        std::ofstream ofs(path, std::ios::binary | std::ios::trunc);
+        if (!ofs)
+        {
+            throw std::runtime_error("Failed to open trace file: " + path);
+        }
+        const std::string json = chromeTraceJson();
+        ofs.write(json.data(), static_cast<std::streamsize>(json.size()));
+        if (!ofs)
+        {
+            throw std::runtime_error("Failed to write trace file: " + path);
+        }
+    }
+} // namespace cppkit::trace
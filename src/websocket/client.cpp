@@ -3,28 +3,52 @@
 #include "cppkit/log/log.hpp"
 #include "cppkit/crypto/base.hpp"
 #include "cppkit/crypto/sha1.hpp"
+#include <algorithm>
+#include <cmath>
+#include <random>
 #include <sstream>
 #include <cstring>
+#include <fcntl.h>
+#include <netdb.h>
 #include <netinet/tcp.h>
 #include <arpa/inet.h>
+#include <sys/uio.h>
 
 #include "cppkit/random.hpp"
 #include "cppkit/http/http_response.hpp"
 
 namespace cppkit::websocket
 {
+  // 握手响应头大小限制 (防止内存耗尽攻击)
+  constexpr size_t MAX_HANDSHAKE_SIZE = 64 * 1024;
+
+  // 非阻塞模式每次读取的大小
+  constexpr size_t READ_BUFFER_SIZE = 64 * 1024;
+
+  static void notifyError(const WebSocketClient::OnErrorHandler& handler, const std::string& message)
+  {
+    if (handler)
+    {
+      handler(message);
+    }
+  }
+
+  WebSocketClient::WebSocketClient(event::EventLoop* loop) : _loop(loop)
+  {
+  }
+
   WebSocketClient::~WebSocketClient()
   {
     disconnect();
   }
 
-  bool WebSocketClient::connect(const std::string& url)
+  bool WebSocketClient::resolve(const std::string& url)
   {
     _url = url;
     size_t schemeEnd = url.find("://");
     if (schemeEnd == std::string::npos)
     {
-      _onError("Invalid URL format");
+      notifyError(_onError, "Invalid URL format");
       return false;
     }
 
@@ -40,7 +64,7 @@ namespace cppkit::websocket
     }
     else
     {
-      _onError("Unsupported scheme");
+      notifyError(_onError, "Unsupported scheme");
       return false;
     }
 
@@ -63,94 +87,125 @@ namespace cppkit::websocket
       _host = _host.substr(0, portSep);
     }
 
-    // Create socket
-    _socketFd = socket(AF_INET, SOCK_STREAM, 0);
-    if (_socketFd < 0)
-    {
-      _onError("Failed to create socket");
-      return false;
-    }
-
-    // Set socket options
-    int optVal = 1;
-    setsockopt(_socketFd, SOL_SOCKET, SO_REUSEADDR, &optVal, sizeof(optVal));
-    setsockopt(_socketFd, IPPROTO_TCP, TCP_NODELAY, &optVal, sizeof(optVal));
-
-    // Resolve host
-    sockaddr_in addr{};
-    addr.sin_family = AF_INET;
-    addr.sin_port = htons(_port);
-
-    if (inet_pton(AF_INET, _host.c_str(), &addr.sin_addr) <= 0)
+    // Resolve host（只在 connect 时解析一次，重连沿用同一个地址）
+    _addr = {};
+    _addr.sin_family = AF_INET;
+    _addr.sin_port = htons(_port);
+    if (inet_pton(AF_INET, _host.c_str(), &_addr.sin_addr) <= 0)
     {
       // Try to resolve hostname
       hostent* hp = gethostbyname(_host.c_str());
       if (!hp)
       {
-        _onError("Failed to resolve host");
-        close(_socketFd);
-        _socketFd = -1;
+        notifyError(_onError, "Failed to resolve host");
         return false;
       }
-      std::memcpy(&addr.sin_addr, hp->h_addr_list[0], hp->h_length);
+      std::memcpy(&_addr.sin_addr, hp->h_addr_list[0], hp->h_length);
     }
+    return true;
+  }
 
-    // Connect to server
-    if (::connect(_socketFd, reinterpret_cast<sockaddr*>(&addr), sizeof(addr)) < 0)
+  bool WebSocketClient::connect(const std::string& url)
+  {
+    if (!resolve(url))
     {
-      _onError("Failed to connect to server");
-      close(_socketFd);
-      _socketFd = -1;
       return false;
     }
 
-    _state = ClientState::CONNECTING;
+    _userClosed = false;
+    if (!_loop)
+    {
+      return connectBlocking();
+    }
 
+    // 重复调用时先丢弃旧连接
+    cancelTimer(_reconnectTimer);
+    closeSocket();
+    _attempts = 0;
+    startConnect();
+    return true;
+  }
+
+  std::string WebSocketClient::handshakeRequest()
+  {
     // 生成 Sec-WebSocket-Key
     secWebSocketKey = Random::randomString(16, std::string(lowerChars) + std::string(upperChars) + std::string(digitChars));
     // base64 编码
     secWebSocketKey = crypto::Base64::encode(secWebSocketKey);
 
-    // Send WebSocket handshake
     std::stringstream handshake;
     handshake << "GET " << _path << " HTTP/1.1\r\n";
     handshake << "Host: " << _host << ":" << _port << "\r\n";
     handshake << "Upgrade: websocket\r\n";
     handshake << "Connection: Upgrade\r\n";
     handshake << "Sec-WebSocket-Key: " << secWebSocketKey << "\r\n";
-    handshake << "Sec-WebSocket-Version: 13\r\n\r\n";
+    handshake << "Sec-WebSocket-Version: 13\r\n";
+    if (_deflateEnabled && deflateAvailable())
+    {
+      handshake << "Sec-WebSocket-Extensions: " << deflateOffer(_deflateOptions) << "\r\n";
+    }
+    handshake << "\r\n";
+    return handshake.str();
+  }
 
-    std::string handshakeStr = handshake.str();
+  bool WebSocketClient::connectBlocking()
+  {
+    // Create socket
+    _socketFd = socket(AF_INET, SOCK_STREAM, 0);
+    if (_socketFd < 0)
+    {
+      notifyError(_onError, "Failed to create socket");
+      return false;
+    }
+
+    // Set socket options
+    int optVal = 1;
+    setsockopt(_socketFd, SOL_SOCKET, SO_REUSEADDR, &optVal, sizeof(optVal));
+    setsockopt(_socketFd, IPPROTO_TCP, TCP_NODELAY, &optVal, sizeof(optVal));
+
+    // Connect to server
+    if (::connect(_socketFd, reinterpret_cast<sockaddr*>(&_addr), sizeof(_addr)) < 0)
+    {
+      notifyError(_onError, "Failed to connect to server");
+      closeSocket();
+      return false;
+    }
+
+    _state = ClientState::HANDSHAKING;
+
+    // Send WebSocket handshake
+    const std::string handshakeStr = handshakeRequest();
     if (ssize_t sent = ::send(_socketFd, handshakeStr.c_str(), handshakeStr.size(), 0);
       sent != static_cast<ssize_t>(handshakeStr.size()))
     {
-      _onError("Failed to send handshake");
-      close(_socketFd);
-      _socketFd = -1;
-      _state = ClientState::DISCONNECTED;
+      notifyError(_onError, "Failed to send handshake");
+      closeSocket();
       return false;
     }
 
-    // Read response
-    char buffer[1024] = {};
-    ssize_t readBytes = recv(_socketFd, buffer, sizeof(buffer) - 1, 0);
-    if (readBytes <= 0)
+    // Read response：响应头可能分多次到达
+    std::vector<uint8_t> responseData;
+    size_t headerEnd = std::string_view::npos;
+    while (headerEnd == std::string_view::npos)
     {
-      _onError("Failed to read handshake response");
-      close(_socketFd);
-      _socketFd = -1;
-      _state = ClientState::DISCONNECTED;
-      return false;
+      char buffer[4096];
+      const ssize_t readBytes = recv(_socketFd, buffer, sizeof(buffer), 0);
+      if (readBytes <= 0 || responseData.size() > MAX_HANDSHAKE_SIZE)
+      {
+        notifyError(_onError, "Failed to read handshake response");
+        closeSocket();
+        return false;
+      }
+      responseData.insert(responseData.end(), buffer, buffer + readBytes);
+      headerEnd = std::string_view(reinterpret_cast<const char*>(responseData.data()), responseData.size())
+          .find("\r\n\r\n");
     }
 
-    std::vector responseData(reinterpret_cast<uint8_t*>(buffer),
-        reinterpret_cast<uint8_t*>(buffer + readBytes));
+    responseData.resize(headerEnd + 4);
     if (!handleHandshake(responseData))
     {
-      _onError("WebSocket handshake failed");
-      close(_socketFd);
-      _socketFd = -1;
-      _state = ClientState::DISCONNECTED;
+      notifyError(_onError, "WebSocket handshake failed");
+      closeSocket();
       return false;
     }
 
@@ -163,46 +218,371 @@ namespace cppkit::websocket
     return true;
   }
 
-  void WebSocketClient::disconnect()
+  void WebSocketClient::startConnect()
   {
-    if (_socketFd >= 0)
+    _socketFd = ::socket(AF_INET, SOCK_STREAM, 0);
+    if (_socketFd < 0)
     {
-      // Send close frame
-      Frame closeFrame;
-      closeFrame.fin = true;
-      closeFrame.opCode = MessageType::CLOSE;
-      closeFrame.payloadLength = 0;
-      const std::vector<uint8_t> frame = buildFrame({}, MessageType::CLOSE);
-      ::send(_socketFd, frame.data(), frame.size(), 0);
+      fail("Failed to create socket", false);
+      return;
+    }
+    int optVal = 1;
+    setsockopt(_socketFd, IPPROTO_TCP, TCP_NODELAY, &optVal, sizeof(optVal));
+    fcntl(_socketFd, F_SETFL, fcntl(_socketFd, F_GETFL) | O_NONBLOCK);
 
+    // 新连接从干净的状态开始
+    _reader = MessageReader(false, _reader.maxMessageSize());
+    _deflate.reset();
+    _state = ClientState::CONNECTING;
+
+    if (::connect(_socketFd, reinterpret_cast<sockaddr*>(&_addr), sizeof(_addr)) < 0 && errno != EINPROGRESS)
+    {
+      fail(std::string("Failed to connect to server: ") + strerror(errno), false);
+      return;
+    }
+
+    _outbox = std::make_unique<Outbox>(_loop, _socketFd, _outboxLimits, [this](int, int)
+    {
+      onWritable();
+    });
+
+    // 连接完成时可写；连接失败时 epoll 可能只报告错误，所以两个方向都要监听
+    _loop->createFileEvent(_socketFd, event::AE_READABLE, [this](int, int)
+    {
+      onReadable();
+    });
+    _loop->createFileEvent(_socketFd, event::AE_WRITABLE, [this](int, int)
+    {
+      onWritable();
+    });
+
+    _timeoutTimer = _loop->createTimeEvent(_connectTimeoutMs, [this](int64_t) -> int64_t
+    {
+      _timeoutTimer = -1;
+      fail("Connection timed out", false);
+      return 0;
+    });
+  }
+
+  void WebSocketClient::onConnected()
+  {
+    int err = 0;
+    socklen_t len = sizeof(err);
+    if (getsockopt(_socketFd, SOL_SOCKET, SO_ERROR, &err, &len) < 0)
+    {
+      err = errno;
+    }
+    if (err != 0)
+    {
+      fail(std::string("Failed to connect to server: ") + strerror(err), false);
+      return;
+    }
+
+    // 之后只在输出队列有积压时才关心可写事件
+    _loop->deleteFileEvent(_socketFd, event::AE_WRITABLE);
+    _state = ClientState::HANDSHAKING;
+
+    const std::string request = handshakeRequest();
+    if (!_outbox->send(std::make_shared<const std::vector<uint8_t>>(request.begin(), request.end())))
+    {
+      fail("Failed to send handshake", false);
+    }
+  }
+
+  void WebSocketClient::onWritable()
+  {
+    if (_state == ClientState::CONNECTING)
+    {
+      onConnected();
+      return;
+    }
+    if (_outbox && !_outbox->flush())
+    {
+      fail("Failed to send data", _state == ClientState::CONNECTED);
+    }
+  }
+
+  void WebSocketClient::onReadable()
+  {
+    if (_state == ClientState::CONNECTING)
+    {
+      onConnected();
+      return;
+    }
+
+    uint8_t buffer[READ_BUFFER_SIZE];
+    const ssize_t n = ::read(_socketFd, buffer, sizeof(buffer));
+    if (n == 0)
+    {
+      fail("Connection closed by server", _state == ClientState::CONNECTED);
+      return;
+    }
+    if (n < 0)
+    {
+      if (errno != EAGAIN && errno != EWOULDBLOCK && errno != EINTR)
+      {
+        fail(std::string("Failed to read: ") + strerror(errno), _state == ClientState::CONNECTED);
+      }
+      return;
+    }
+    _reader.append(std::span(buffer, static_cast<size_t>(n)));
+
+    if (_state == ClientState::HANDSHAKING)
+    {
+      const auto pending = _reader.pending();
+      const std::string_view buffered(reinterpret_cast<const char*>(pending.data()), pending.size());
+      const size_t headerEnd = buffered.find("\r\n\r\n");
+      if (headerEnd == std::string_view::npos)
+      {
+        if (buffered.size() > MAX_HANDSHAKE_SIZE)
+        {
+          fail("WebSocket handshake response too large", false);
+        }
+        return;
+      }
+
+      if (!handleHandshake(std::vector(pending.begin(), pending.begin() + static_cast<ptrdiff_t>(headerEnd + 4))))
+      {
+        fail("WebSocket handshake failed", false);
+        return;
+      }
+
+      // 响应头之后可能已经跟着数据帧
+      _reader.discard(headerEnd + 4);
+      _reader.setDeflate(_deflate.get());
+      _state = ClientState::CONNECTED;
+      _attempts = 0;
+      cancelTimer(_timeoutTimer);
+
+      if (_onConnect)
+      {
+        const uint64_t generation = _generation;
+        _onConnect();
+        if (generation != _generation)
+        {
+          return;
+        }
+      }
+    }
+
+    handleFrames();
+  }
+
+  void WebSocketClient::handleFrames()
+  {
+    const uint64_t generation = _generation;
+    MessageReader::Message message{};
+    while (_reader.next(message))
+    {
+      switch (message.type)
+      {
+      case MessageType::PING:
+        // 自动回复相同负载的 PONG
+        sendFrame(message.payload, MessageType::PONG);
+        break;
+      case MessageType::PONG:
+        break;
+      case MessageType::CLOSE:
+        // 回送对方的状态码后关闭，服务端主动关闭不算错误
+        sendFrame(message.payload.first(std::min<size_t>(message.payload.size(), 2)), MessageType::CLOSE);
+        fail("", true);
+        return;
+      default:
+        if (_onMessage)
+        {
+          _onMessage(message.payload, message.type);
+          if (generation != _generation)
+          {
+            return;
+          }
+        }
+        break;
+      }
+    }
+
+    if (_reader.failed())
+    {
+      const auto code = static_cast<uint16_t>(_reader.error());
+      const uint8_t payload[2] = {static_cast<uint8_t>(code >> 8), static_cast<uint8_t>(code)};
+      sendFrame(payload, MessageType::CLOSE);
+      fail("WebSocket protocol error: " + std::to_string(code), true);
+    }
+    else if (_outbox && _outbox->broken())
+    {
+      fail("Failed to send data", true);
+    }
+  }
+
+  void WebSocketClient::closeSocket()
+  {
+    cancelTimer(_timeoutTimer);
+    if (_socketFd >= 0)
+    {
+      if (_loop)
+      {
+        _loop->deleteFileEvent(_socketFd, event::AE_READABLE | event::AE_WRITABLE);
+      }
       close(_socketFd);
       _socketFd = -1;
     }
-
+    _outbox.reset();
     _state = ClientState::DISCONNECTED;
+    ++_generation;
+  }
+
+  void WebSocketClient::fail(const std::string& reason, const bool wasConnected)
+  {
+    closeSocket();
+    if (!reason.empty())
+    {
+      notifyError(_onError, reason);
+    }
+    if (wasConnected && _onClose)
+    {
+      _onClose();
+    }
+    scheduleReconnect();
+  }
+
+  void WebSocketClient::scheduleReconnect()
+  {
+    // 回调里可能已经主动断开或重新连接
+    if (!_loop || !_reconnect.enabled || _userClosed || _state != ClientState::DISCONNECTED || _reconnectTimer >= 0)
+    {
+      return;
+    }
+    if (_reconnect.maxAttempts > 0 && _attempts >= _reconnect.maxAttempts)
+    {
+      notifyError(_onError, "Reconnect attempts exhausted");
+      return;
+    }
 
-    if (_onClose)
+    const double delay = std::min(static_cast<double>(_reconnect.maxDelayMs),
+                                  static_cast<double>(_reconnect.initialDelayMs) *
+                                  std::pow(_reconnect.multiplier, static_cast<double>(_attempts)));
+    thread_local std::mt19937 gen(std::random_device{}());
+    std::uniform_real_distribution jitter(delay / 2, delay);
+    ++_attempts;
+
+    _reconnectTimer = _loop->createTimeEvent(std::max<int64_t>(1, static_cast<int64_t>(jitter(gen))),
+                                             [this](int64_t) -> int64_t
+                                             {
+                                               _reconnectTimer = -1;
+                                               startConnect();
+                                               return 0;
+                                             });
+  }
+
+  void WebSocketClient::cancelTimer(int64_t& id) const
+  {
+    if (id >= 0 && _loop)
+    {
+      _loop->deleteTimeEvent(id);
+    }
+    id = -1;
+  }
+
+  void WebSocketClient::disconnect()
+  {
+    _userClosed = true;
+    cancelTimer(_reconnectTimer);
+
+    const bool wasConnected = _state == ClientState::CONNECTED;
+    if (wasConnected)
+    {
+      // Send close frame（1000 正常关闭）
+      constexpr uint8_t payload[2] = {0x03, 0xE8};
+      sendFrame(payload, MessageType::CLOSE);
+    }
+    closeSocket();
+
+    if (wasConnected && _onClose)
     {
       _onClose();
     }
   }
 
-  bool WebSocketClient::send(const std::string& message, const MessageType type) const
+  void WebSocketClient::enableDeflate(const DeflateOptions& options)
   {
-    return send(std::vector<uint8_t>(message.begin(), message.end()), type);
+    _deflateEnabled = true;
+    _deflateOptions = options;
   }
 
-  bool WebSocketClient::send(const std::vector<uint8_t>& message, const MessageType type) const
+  void WebSocketClient::setReconnect(const ReconnectOptions& options)
+  {
+    _reconnect = options;
+  }
+
+  void WebSocketClient::setOutboxLimits(const OutboxLimits& limits)
+  {
+    _outboxLimits = limits;
+  }
+
+  void WebSocketClient::setConnectTimeout(const int64_t timeoutMs)
+  {
+    _connectTimeoutMs = timeoutMs;
+  }
+
+  void WebSocketClient::setMaxMessageSize(const size_t size)
+  {
+    _reader.setMaxMessageSize(size);
+  }
+
+  bool WebSocketClient::send(const std::string_view message, const MessageType type)
+  {
+    return send(std::span(reinterpret_cast<const uint8_t*>(message.data()), message.size()), type);
+  }
+
+  bool WebSocketClient::send(const std::span<const uint8_t> message, const MessageType type)
   {
     if (_state != ClientState::CONNECTED || _socketFd < 0)
     {
       return false;
     }
 
-    const std::vector<uint8_t> frame = buildFrame(message, type,true,true);
-    const ssize_t sent = ::send(_socketFd, frame.data(), frame.size(), 0);
+    // 协商了压缩时先压缩，再对压缩结果掩码
+    std::span<const uint8_t> payload = message;
+    uint8_t rsv = 0;
+    if (_deflate && (type == MessageType::TEXT || type == MessageType::BINARY) &&
+        _deflate->shouldCompress(message.size()))
+    {
+      thread_local std::vector<uint8_t> compressed;
+      _deflate->compress(message, compressed);
+      if (!_deflate->compressesIndependently() || compressed.size() < message.size())
+      {
+        payload = compressed;
+        rsv = FRAME_RSV1;
+      }
+    }
+
+    const bool sent = sendFrame(payload, type, rsv);
+    if (_outbox && _outbox->broken())
+    {
+      fail("Failed to send data", true);
+    }
+    return sent;
+  }
+
+  bool WebSocketClient::sendFrame(const std::span<const uint8_t> payload, const MessageType type, const uint8_t rsv)
+  {
+    // 客户端必须掩码：帧头在栈上，掩码后的负载写入复用的线程局部缓冲区
+    uint8_t maskingKey[4];
+    randomMaskingKey(maskingKey);
+    FrameHeader header = makeFrameHeader(payload.size(), type, true, maskingKey);
+    header.data[0] |= rsv;
+    thread_local std::vector<uint8_t> masked;
+    masked.resize(payload.size());
+    maskPayload(payload.data(), masked.data(), payload.size(), maskingKey);
+
+    // 非阻塞模式：写不完的部分进入输出队列
+    if (_outbox)
+    {
+      return _outbox->send(header, masked);
+    }
 
-    return sent == static_cast<ssize_t>(frame.size());
+    const iovec iov[2] = {{header.data, header.size}, {masked.data(), masked.size()}};
+    const ssize_t sent = ::writev(_socketFd, iov, masked.empty() ? 1 : 2);
+    return sent == static_cast<ssize_t>(header.size + masked.size());
   }
 
   void WebSocketClient::setOnConnect(OnConnectHandler handler)
@@ -230,7 +610,7 @@ namespace cppkit::websocket
     return _state == ClientState::CONNECTED;
   }
 
-  bool WebSocketClient::handleHandshake(const std::vector<uint8_t>& data) const
+  bool WebSocketClient::handleHandshake(const std::vector<uint8_t>& data)
   {
     const auto response = http::HttpResponse::parse(data);
 
@@ -250,11 +630,22 @@ namespace cppkit::websocket
     const std::string expectedKey = secWebSocketKey;
     const std::string magicString = expectedKey + "258EAFA5-E914-47DA-95CA-C5AB0DC85B11";
     const auto sha1Binary = crypto::SHA1::shaBinary(magicString);
-    const std::vector sha1Bytes(sha1Binary.begin(), sha1Binary.end());
-    if (const std::string accept = crypto::Base64::encode(sha1Bytes); response.getHeader("Sec-WebSocket-Accept") != accept)
+    if (const std::string accept = crypto::Base64::encode(sha1Binary); response.getHeader("Sec-WebSocket-Accept") != accept)
     {
       return false;
     }
+
+    // 服务端可以不接受压缩；接受了就必须符合我们的提议
+    _deflate.reset();
+    if (const std::string extensions = response.getHeader("Sec-WebSocket-Extensions"); !extensions.empty())
+    {
+      DeflateParams params;
+      if (!_deflateEnabled || !acceptDeflateResponse(extensions, _deflateOptions, params))
+      {
+        return false;
+      }
+      _deflate = std::make_unique<PerMessageDeflate>(params, false, _deflateOptions);
+    }
     return true;
   }
-}
\ No newline at end of file
+}
@@ -1,8 +1,225 @@
 #include "cppkit/websocket/conn.hpp"
 #include "cppkit/websocket/frame.hpp"
+#include <algorithm>
+#include <cerrno>
+#include <sys/socket.h>
 
 namespace cppkit::websocket
 {
+  SharedFrame makeSharedFrame(const std::span<const uint8_t> payload, const MessageType type, const bool compressed)
+  {
+    auto frame = buildFrame(payload, type);
+    if (compressed)
+    {
+      frame[0] |= FRAME_RSV1;
+    }
+    return std::make_shared<const std::vector<uint8_t>>(std::move(frame));
+  }
+
+  // 写多段数据，返回写出的字节数；暂时不可写时返回 0，出错时返回 -1
+  static ssize_t writeSome(const int fd, iovec* iov, const int count)
+  {
+    ssize_t n;
+    if (count == 1)
+    {
+      n = ::send(fd, iov->iov_base, iov->iov_len, MSG_NOSIGNAL);
+    }
+    else
+    {
+      msghdr msg{};
+      msg.msg_iov = iov;
+      msg.msg_iovlen = count;
+      n = ::sendmsg(fd, &msg, MSG_NOSIGNAL);
+    }
+    if (n >= 0)
+    {
+      return n;
+    }
+    return errno == EAGAIN || errno == EWOULDBLOCK || errno == EINTR ? 0 : -1;
+  }
+
+  Outbox::Outbox(event::EventLoop* loop, const int fd, const OutboxLimits& limits,
+                 event::FileEventCallback onWritable)
+    : loop_(loop), fd_(fd), limits_(limits), onWritable_(std::move(onWritable))
+  {
+  }
+
+  bool Outbox::send(const FrameHeader& header, const std::span<const uint8_t> payload)
+  {
+    if (broken_)
+    {
+      return false;
+    }
+
+    const size_t total = header.size + payload.size();
+    size_t written = 0;
+    if (queue_.empty())
+    {
+      iovec iov[2] = {
+          {const_cast<uint8_t*>(header.data), header.size},
+          {const_cast<uint8_t*>(payload.data()), payload.size()},
+      };
+      const ssize_t n = writeSome(fd_, iov, payload.empty() ? 1 : 2);
+      if (n < 0)
+      {
+        broken_ = true;
+        return false;
+      }
+      written = static_cast<size_t>(n);
+      if (written == total)
+      {
+        return true;
+      }
+    }
+    else if (!admit(total))
+    {
+      return false;
+    }
+
+    // 只拷贝还没写出去的部分
+    auto rest = std::make_shared<std::vector<uint8_t>>();
+    rest->reserve(total - written);
+    if (written < header.size)
+    {
+      rest->insert(rest->end(), header.data + written, header.data + header.size);
+    }
+    const size_t payloadOffset = written > header.size ? written - header.size : 0;
+    rest->insert(rest->end(), payload.begin() + static_cast<ptrdiff_t>(payloadOffset), payload.end());
+    enqueue(std::move(rest), 0);
+    return true;
+  }
+
+  bool Outbox::send(const SharedFrame& frame)
+  {
+    if (broken_)
+    {
+      return false;
+    }
+
+    size_t written = 0;
+    if (queue_.empty())
+    {
+      iovec iov{const_cast<uint8_t*>(frame->data()), frame->size()};
+      const ssize_t n = writeSome(fd_, &iov, 1);
+      if (n < 0)
+      {
+        broken_ = true;
+        return false;
+      }
+      written = static_cast<size_t>(n);
+      if (written == frame->size())
+      {
+        return true;
+      }
+    }
+    else if (!admit(frame->size()))
+    {
+      return false;
+    }
+
+    enqueue(frame, written);
+    return true;
+  }
+
+  bool Outbox::admit(const size_t size)
+  {
+    if (queuedBytes_ + size <= limits_.maxQueuedBytes)
+    {
+      return true;
+    }
+
+    switch (limits_.policy)
+    {
+    case SlowConsumerPolicy::DROP_OLDEST:
+      {
+        // 队首可能已经发出一部分，必须保留，否则对端会收到半个帧
+        auto it = queue_.begin();
+        if (it != queue_.end() && it->offset > 0)
+        {
+          ++it;
+        }
+        while (it != queue_.end() && queuedBytes_ + size > limits_.maxQueuedBytes)
+        {
+          queuedBytes_ -= it->frame->size();
+          it = queue_.erase(it);
+          ++dropped_;
+        }
+        if (queuedBytes_ + size <= limits_.maxQueuedBytes)
+        {
+          return true;
+        }
+        break;
+      }
+    case SlowConsumerPolicy::DISCONNECT:
+      broken_ = true;
+      break;
+    case SlowConsumerPolicy::DROP_NEWEST:
+      break;
+    }
+    ++dropped_;
+    return false;
+  }
+
+  void Outbox::enqueue(SharedFrame frame, const size_t offset)
+  {
+    queuedBytes_ += frame->size() - offset;
+    queue_.push_back({std::move(frame), offset});
+    if (!watching_ && loop_)
+    {
+      loop_->createFileEvent(fd_, event::AE_WRITABLE, onWritable_);
+      watching_ = true;
+    }
+  }
+
+  bool Outbox::flush()
+  {
+    constexpr int MAX_IOV = 64;
+    while (!queue_.empty())
+    {
+      iovec iov[MAX_IOV];
+      int count = 0;
+      for (auto it = queue_.begin(); it != queue_.end() && count < MAX_IOV; ++it, ++count)
+      {
+        iov[count] = {const_cast<uint8_t*>(it->frame->data() + it->offset), it->frame->size() - it->offset};
+      }
+
+      const ssize_t n = writeSome(fd_, iov, count);
+      if (n < 0)
+      {
+        broken_ = true;
+        return false;
+      }
+      if (n == 0)
+      {
+        return true; // 暂时不可写，等下一次可写事件
+      }
+
+      auto left = static_cast<size_t>(n);
+      queuedBytes_ -= left;
+      while (left > 0)
+      {
+        Entry& front = queue_.front();
+        if (const size_t rest = front.frame->size() - front.offset; left >= rest)
+        {
+          left -= rest;
+          queue_.pop_front();
+        }
+        else
+        {
+          front.offset += left;
+          left = 0;
+        }
+      }
+    }
+
+    if (watching_ && loop_)
+    {
+      loop_->deleteFileEvent(fd_, event::AE_WRITABLE);
+      watching_ = false;
+    }
+    return true;
+  }
+
   std::string ConnInfo::getClientId() const
   {
     return _connInfo.getClientId();
@@ -13,24 +230,72 @@ namespace cppkit::websocket
     _connInfo.close();
   }
 
+  void ConnInfo::close(const CloseCode code, const std::string_view reason) const
+  {
+    // 关闭帧负载：2 字节状态码 + 原因，总长不超过 125 字节
+    uint8_t payload[125];
+    payload[0] = static_cast<uint8_t>(static_cast<uint16_t>(code) >> 8);
+    payload[1] = static_cast<uint8_t>(code);
+    const size_t reasonSize = std::min(reason.size(), sizeof(payload) - 2);
+    std::memcpy(payload + 2, reason.data(), reasonSize);
+    (void)sendMessage(std::span(payload, reasonSize + 2), MessageType::CLOSE);
+    if (_outbox)
+    {
+      _outbox->flush(); // 关闭前尽量把排队的数据发出去
+    }
+    _connInfo.close();
+  }
+
   const event::ConnInfo& ConnInfo::getRawConnInfo() const
   {
     return _connInfo;
   }
 
-  ssize_t ConnInfo::sendTextMessage(const std::string& message) const
+  ssize_t ConnInfo::sendTextMessage(const std::string_view message) const
   {
-    return sendMessage(std::vector<uint8_t>(message.begin(), message.end()), MessageType::TEXT);
+    return sendMessage(std::span(reinterpret_cast<const uint8_t*>(message.data()), message.size()), MessageType::TEXT);
   }
 
-  ssize_t ConnInfo::sendBinaryMessage(const std::vector<uint8_t>& message) const
+  ssize_t ConnInfo::sendBinaryMessage(const std::span<const uint8_t> message) const
   {
     return sendMessage(message, MessageType::BINARY);
   }
 
-  ssize_t ConnInfo::sendMessage(const std::vector<uint8_t>& message, const MessageType type) const
+  ssize_t ConnInfo::sendMessage(std::span<const uint8_t> message, const MessageType type) const
+  {
+    uint8_t rsv = 0;
+    if (_deflate && (type == MessageType::TEXT || type == MessageType::BINARY) &&
+        _deflate->shouldCompress(message.size()))
+    {
+      thread_local std::vector<uint8_t> compressed;
+      _deflate->compress(message, compressed);
+      // 每条消息独立压缩时，压缩后没有变小就直接发原文
+      if (!_deflate->compressesIndependently() || compressed.size() < message.size())
+      {
+        message = compressed;
+        rsv = FRAME_RSV1;
+      }
+    }
+
+    FrameHeader header = makeFrameHeader(message.size(), type);
+    header.data[0] |= rsv;
+    if (_outbox)
+    {
+      return _outbox->send(header, message) ? static_cast<ssize_t>(header.size + message.size()) : -1;
+    }
+    const iovec iov[2] = {
+        {header.data, header.size},
+        {const_cast<uint8_t*>(message.data()), message.size()},
+    };
+    return _connInfo.sendv(iov, message.empty() ? 1 : 2);
+  }
+
+  ssize_t ConnInfo::sendFrame(const SharedFrame& frame) const
   {
-    const auto body = buildFrame(message, type);
-    return _connInfo.send(body.data(), body.size());
+    if (_outbox)
+    {
+      return _outbox->send(frame) ? static_cast<ssize_t>(frame->size()) : -1;
+    }
+    return _connInfo.send(frame->data(), frame->size());
   }
 }
\ No newline at end of file
@@ -0,0 +1,460 @@
+#include "cppkit/websocket/deflate.hpp"
+#include <algorithm>
+#include <charconv>
+#include <stdexcept>
+
+#ifdef CPPKIT_HAS_ZLIB
+#include <zlib.h>
+#endif
+
+namespace cppkit::websocket
+{
+  namespace
+  {
+    struct Extension
+    {
+      std::string_view name;
+
+      // 参数名与值，没有值的参数 value 为空
+      std::vector<std::pair<std::string_view, std::optional<std::string_view>>> params;
+    };
+
+    std::string_view trimView(std::string_view s)
+    {
+      while (!s.empty() && (s.front() == ' ' || s.front() == '\t'))
+        s.remove_prefix(1);
+      while (!s.empty() && (s.back() == ' ' || s.back() == '\t'))
+        s.remove_suffix(1);
+      return s;
+    }
+
+    // 扩展之间用逗号分隔，参数之间用分号分隔，参数值可以带引号
+    std::vector<Extension> parseExtensions(const std::string_view header)
+    {
+      std::vector<Extension> extensions;
+      size_t start = 0;
+      while (start <= header.size())
+      {
+        size_t end = header.find(',', start);
+        if (end == std::string_view::npos)
+          end = header.size();
+        std::string_view item = header.substr(start, end - start);
+        start = end + 1;
+
+        Extension extension;
+        size_t pos = 0;
+        bool first = true;
+        while (pos <= item.size())
+        {
+          size_t semi = item.find(';', pos);
+          if (semi == std::string_view::npos)
+            semi = item.size();
+          const std::string_view token = trimView(item.substr(pos, semi - pos));
+          pos = semi + 1;
+          if (first)
+          {
+            extension.name = token;
+            first = false;
+            continue;
+          }
+          if (const size_t eq = token.find('='); eq == std::string_view::npos)
+          {
+            extension.params.emplace_back(token, std::nullopt);
+          }
+          else
+          {
+            std::string_view value = trimView(token.substr(eq + 1));
+            if (value.size() >= 2 && value.front() == '"' && value.back() == '"')
+              value = value.substr(1, value.size() - 2);
+            extension.params.emplace_back(trimView(token.substr(0, eq)), value);
+          }
+        }
+        if (!extension.name.empty())
+          extensions.push_back(std::move(extension));
+      }
+      return extensions;
+    }
+
+    // 窗口参数必须是 8..15 的十进制数，不能有前导零
+    std::optional<int> parseWindowBits(const std::string_view value)
+    {
+      int bits = 0;
+      const auto [ptr, ec] = std::from_chars(value.data(), value.data() + value.size(), bits);
+      if (ec != std::errc() || ptr != value.data() + value.size() || value.front() == '0' || bits < 8 || bits > 15)
+        return std::nullopt;
+      return bits;
+    }
+
+    bool hasDuplicate(const Extension& extension)
+    {
+      for (size_t i = 0; i < extension.params.size(); ++i)
+      {
+        for (size_t j = i + 1; j < extension.params.size(); ++j)
+        {
+          if (extension.params[i].first == extension.params[j].first)
+            return true;
+        }
+      }
+      return false;
+    }
+
+    constexpr std::string_view EXTENSION_NAME = "permessage-deflate";
+  }
+
+  bool deflateAvailable() noexcept
+  {
+#ifdef CPPKIT_HAS_ZLIB
+    return true;
+#else
+    return false;
+#endif
+  }
+
+  std::optional<std::string> negotiateDeflate(const std::string_view offers, const DeflateOptions& options,
+                                              DeflateParams& params)
+  {
+    if (!deflateAvailable())
+    {
+      return std::nullopt;
+    }
+
+    const int serverLimit = std::clamp(options.serverMaxWindowBits, 9, 15);
+    const int clientLimit = std::clamp(options.clientMaxWindowBits, 8, 15);
+    for (const auto& offer : parseExtensions(offers))
+    {
+      if (offer.name != EXTENSION_NAME || hasDuplicate(offer))
+      {
+        continue;
+      }
+
+      DeflateParams accepted;
+      accepted.serverNoContextTakeover = options.serverNoContextTakeover;
+      accepted.clientNoContextTakeover = options.clientNoContextTakeover;
+      accepted.serverMaxWindowBits = serverLimit;
+      bool clientBitsOffered = false;
+      bool valid = true;
+      for (const auto& [name, value] : offer.params)
+      {
+        if (name == "server_no_context_takeover" && !value)
+        {
+          accepted.serverNoContextTakeover = true;
+        }
+        else if (name == "client_no_context_takeover" && !value)
+        {
+          accepted.clientNoContextTakeover = true;
+        }
+        else if (name == "server_max_window_bits" && value)
+        {
+          // zlib 的 raw deflate 不支持 8 位窗口，只能拒绝该提议
+          const auto bits = parseWindowBits(*value);
+          valid = bits && *bits >= 9;
+          if (valid)
+          {
+            accepted.serverMaxWindowBits = std::min(accepted.serverMaxWindowBits, *bits);
+          }
+        }
+        else if (name == "client_max_window_bits")
+        {
+          clientBitsOffered = true;
+          if (value)
+          {
+            const auto bits = parseWindowBits(*value);
+            valid = bits.has_value();
+            if (valid)
+            {
+              accepted.clientMaxWindowBits = *bits;
+            }
+          }
+        }
+        else
+        {
+          valid = false;
+        }
+        if (!valid)
+        {
+          break;
+        }
+      }
+
+      // 客户端没有声明支持 client_max_window_bits 时无法限制它的窗口
+      if (!valid || (clientLimit < 15 && !clientBitsOffered))
+      {
+        continue;
+      }
+      accepted.clientMaxWindowBits = std::min(accepted.clientMaxWindowBits, clientLimit);
+
+      std::string response(EXTENSION_NAME);
+      if (accepted.serverNoContextTakeover)
+      {
+        response += "; server_no_context_takeover";
+      }
+      if (accepted.clientNoContextTakeover)
+      {
+        response += "; client_no_context_takeover";
+      }
+      if (accepted.serverMaxWindowBits < 15)
+      {
+        response += "; server_max_window_bits=" + std::to_string(accepted.serverMaxWindowBits);
+      }
+      if (clientBitsOffered && accepted.clientMaxWindowBits < 15)
+      {
+        response += "; client_max_window_bits=" + std::to_string(accepted.clientMaxWindowBits);
+      }
+      params = accepted;
+      return response;
+    }
+    return std::nullopt;
+  }
+
+  std::string deflateOffer(const DeflateOptions& options)
+  {
+    std::string offer(EXTENSION_NAME);
+    if (options.serverNoContextTakeover)
+    {
+      offer += "; server_no_context_takeover";
+    }
+    if (options.clientNoContextTakeover)
+    {
+      offer += "; client_no_context_takeover";
+    }
+    if (const int serverBits = std::clamp(options.serverMaxWindowBits, 8, 15); serverBits < 15)
+    {
+      offer += "; server_max_window_bits=" + std::to_string(serverBits);
+    }
+    offer += "; client_max_window_bits";
+    if (const int clientBits = std::clamp(options.clientMaxWindowBits, 9, 15); clientBits < 15)
+    {
+      offer += "=" + std::to_string(clientBits);
+    }
+    return offer;
+  }
+
+  bool acceptDeflateResponse(const std::string_view response, const DeflateOptions& options, DeflateParams& params)
+  {
+    if (!deflateAvailable())
+    {
+      return false;
+    }
+
+    const auto extensions = parseExtensions(response);
+    if (extensions.size() != 1 || extensions[0].name != EXTENSION_NAME || hasDuplicate(extensions[0]))
+    {
+      return false;
+    }
+
+    DeflateParams accepted;
+    accepted.clientMaxWindowBits = std::clamp(options.clientMaxWindowBits, 9, 15);
+    for (const auto& [name, value] : extensions[0].params)
+    {
+      if (name == "server_no_context_takeover" && !value)
+      {
+        accepted.serverNoContextTakeover = true;
+      }
+      else if (name == "client_no_context_takeover" && !value)
+      {
+        accepted.clientNoContextTakeover = true;
+      }
+      else if (name == "server_max_window_bits" && value)
+      {
+        const auto bits = parseWindowBits(*value);
+        if (!bits)
+        {
+          return false;
+        }
+        accepted.serverMaxWindowBits = *bits;
+      }
+      else if (name == "client_max_window_bits" && value)
+      {
+        // 同样受限于 zlib 不支持 8 位压缩窗口
+        const auto bits = parseWindowBits(*value);
+        if (!bits || *bits < 9)
+        {
+          return false;
+        }
+        accepted.clientMaxWindowBits = std::min(accepted.clientMaxWindowBits, *bits);
+      }
+      else
+      {
+        return false;
+      }
+    }
+
+    // 服务端必须遵守我们对它提出的限制
+    if ((options.serverNoContextTakeover && !accepted.serverNoContextTakeover) ||
+        accepted.serverMaxWindowBits > std::clamp(options.serverMaxWindowBits, 8, 15))
+    {
+      return false;
+    }
+    accepted.clientNoContextTakeover = accepted.clientNoContextTakeover || options.clientNoContextTakeover;
+    params = accepted;
+    return true;
+  }
+
+#ifdef CPPKIT_HAS_ZLIB
+  struct PerMessageDeflate::Streams
+  {
+    z_stream deflater{};
+    bool deflaterReady = false;
+
+    z_stream inflater{};
+    bool inflaterReady = false;
+
+    ~Streams()
+    {
+      if (deflaterReady)
+        deflateEnd(&deflater);
+      if (inflaterReady)
+        inflateEnd(&inflater);
+    }
+  };
+#else
+  struct PerMessageDeflate::Streams
+  {
+  };
+#endif
+
+  PerMessageDeflate::PerMessageDeflate(const DeflateParams& params, const bool isServer,
+                                       const DeflateOptions& options)
+    : streams_(std::make_unique<Streams>()),
+      compressTakeover_(isServer ? !params.serverNoContextTakeover : !params.clientNoContextTakeover),
+      decompressTakeover_(isServer ? !params.clientNoContextTakeover : !params.serverNoContextTakeover),
+      compressBits_(std::clamp(isServer ? params.serverMaxWindowBits : params.clientMaxWindowBits, 9, 15)),
+      decompressBits_(std::clamp(isServer ? params.clientMaxWindowBits : params.serverMaxWindowBits, 8, 15)),
+      level_(std::clamp(options.level, 1, 9)),
+      memLevel_(std::clamp(options.memLevel, 1, 9)),
+      minSize_(options.minSize)
+  {
+  }
+
+  PerMessageDeflate::~PerMessageDeflate() = default;
+
+#ifdef CPPKIT_HAS_ZLIB
+  void PerMessageDeflate::compress(const std::span<const uint8_t> in, std::vector<uint8_t>& out)
+  {
+    z_stream& d = streams_->deflater;
+    if (!streams_->deflaterReady)
+    {
+      if (deflateInit2(&d, level_, Z_DEFLATED, -compressBits_, memLevel_, Z_DEFAULT_STRATEGY) != Z_OK)
+      {
+        throw std::runtime_error("deflateInit2 failed");
+      }
+      streams_->deflaterReady = true;
+    }
+
+    d.next_in = const_cast<Bytef*>(in.data());
+    d.avail_in = static_cast<uInt>(in.size());
+    out.resize(deflateBound(&d, in.size()) + 8);
+    size_t produced = 0;
+    do
+    {
+      if (produced == out.size())
+      {
+        out.resize(out.size() * 2);
+      }
+      d.next_out = out.data() + produced;
+      d.avail_out = static_cast<uInt>(out.size() - produced);
+      if (const int rc = deflate(&d, Z_SYNC_FLUSH); rc != Z_OK && rc != Z_BUF_ERROR)
+      {
+        throw std::runtime_error("deflate failed");
+      }
+      produced = out.size() - d.avail_out;
+    }
+    while (d.avail_out == 0);
+
+    // 同步刷新以空的存储块 00 00 FF FF 结尾，按 RFC 7692 去掉
+    if (produced >= 4 && out[produced - 4] == 0x00 && out[produced - 3] == 0x00 && out[produced - 2] == 0xFF &&
+        out[produced - 1] == 0xFF)
+    {
+      produced -= 4;
+    }
+    out.resize(produced);
+
+    if (!compressTakeover_)
+    {
+      deflateReset(&d);
+    }
+  }
+
+  InflateStatus PerMessageDeflate::decompress(const std::span<const uint8_t> in, std::vector<uint8_t>& out,
+                                              const size_t maxSize)
+  {
+    z_stream& s = streams_->inflater;
+    if (!streams_->inflaterReady)
+    {
+      if (inflateInit2(&s, -decompressBits_) != Z_OK)
+      {
+        throw std::runtime_error("inflateInit2 failed");
+      }
+      streams_->inflaterReady = true;
+    }
+
+    // 多给 1 字节用来发现超限，内存占用不会超过 maxSize + 1
+    const size_t limit = std::min(maxSize, SIZE_MAX - 1) + 1;
+    out.resize(std::min(std::max<size_t>(in.size() * 4, 1024), limit));
+    size_t produced = 0;
+    bool streamEnd = false;
+
+    static constexpr uint8_t TAIL[4] = {0x00, 0x00, 0xFF, 0xFF};
+    for (const auto chunk : {in, std::span<const uint8_t>(TAIL)})
+    {
+      s.next_in = const_cast<Bytef*>(chunk.data());
+      s.avail_in = static_cast<uInt>(chunk.size());
+      while (!streamEnd && (s.avail_in > 0 || produced == out.size()))
+      {
+        if (produced == out.size())
+        {
+          if (out.size() >= limit)
+          {
+            inflateReset(&s);
+            return InflateStatus::TOO_BIG;
+          }
+          out.resize(std::min(out.size() * 2, limit));
+        }
+        s.next_out = out.data() + produced;
+        s.avail_out = static_cast<uInt>(out.size() - produced);
+        const int rc = inflate(&s, Z_SYNC_FLUSH);
+        produced = out.size() - s.avail_out;
+        if (rc == Z_STREAM_END)
+        {
+          // 发送方用了 BFINAL 块，之后的数据（包括补上的结尾）都不再属于这条消息
+          streamEnd = true;
+        }
+        else if (rc == Z_BUF_ERROR)
+        {
+          if (s.avail_out > 0)
+          {
+            break; // 输入已经用完
+          }
+        }
+        else if (rc != Z_OK)
+        {
+          inflateReset(&s);
+          return InflateStatus::CORRUPT;
+        }
+      }
+    }
+    if (produced > maxSize)
+    {
+      inflateReset(&s);
+      return InflateStatus::TOO_BIG;
+    }
+    out.resize(produced);
+
+    if (!decompressTakeover_ || streamEnd)
+    {
+      inflateReset(&s);
+    }
+    return InflateStatus::OK;
+  }
+#else
+  void PerMessageDeflate::compress(std::span<const uint8_t>, std::vector<uint8_t>&)
+  {
+    throw std::runtime_error("permessage-deflate requires zlib");
+  }
+
+  InflateStatus PerMessageDeflate::decompress(std::span<const uint8_t>, std::vector<uint8_t>&, size_t)
+  {
+    throw std::runtime_error("permessage-deflate requires zlib");
+  }
+#endif
+}
@@ -0,0 +1,411 @@
+#include "cppkit/websocket/frame.hpp"
+#include "cppkit/websocket/deflate.hpp"
+#include "cppkit/strings.hpp"
+#include <algorithm>
+#include <random>
+#include <string>
+
+#if defined(__x86_64__) || defined(__i386__)
+#include <immintrin.h>
+#endif
+
+namespace cppkit::websocket
+{
+  FrameHeader makeFrameHeader(const uint64_t payloadLength, const MessageType type, const bool fin,
+                              const uint8_t* maskingKey) noexcept
+  {
+    FrameHeader header;
+    uint8_t* p = header.data;
+
+    // FIN 位与 Opcode
+    *p++ = static_cast<uint8_t>((fin ? 0x80 : 0x00) | (static_cast<uint8_t>(type) & 0x0F));
+
+    const uint8_t maskBit = maskingKey ? 0x80 : 0x00;
+    if (payloadLength <= 125)
+    {
+      *p++ = maskBit | static_cast<uint8_t>(payloadLength);
+    }
+    else if (payloadLength <= 65535)
+    {
+      *p++ = maskBit | 126;
+      *p++ = static_cast<uint8_t>(payloadLength >> 8);
+      *p++ = static_cast<uint8_t>(payloadLength);
+    }
+    else
+    {
+      *p++ = maskBit | 127;
+      for (int i = 7; i >= 0; --i)
+      {
+        *p++ = static_cast<uint8_t>(payloadLength >> (i * 8));
+      }
+    }
+
+    if (maskingKey)
+    {
+      std::memcpy(p, maskingKey, 4);
+      p += 4;
+    }
+
+    header.size = static_cast<size_t>(p - header.data);
+    return header;
+  }
+
+#if defined(__x86_64__) || defined(__i386__)
+  // 每次处理 32 字节，返回已处理的字节数
+  __attribute__((target("avx2")))
+  static size_t maskAvx2(const uint8_t* in, uint8_t* out, const size_t size, const uint32_t key) noexcept
+  {
+    const __m256i k = _mm256_set1_epi32(static_cast<int>(key));
+    size_t i = 0;
+    for (; i + 32 <= size; i += 32)
+    {
+      const __m256i v = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(in + i));
+      _mm256_storeu_si256(reinterpret_cast<__m256i*>(out + i), _mm256_xor_si256(v, k));
+    }
+    return i;
+  }
+
+  static bool hasAvx2() noexcept
+  {
+    static const bool supported = __builtin_cpu_supports("avx2");
+    return supported;
+  }
+#endif
+
+  void maskPayload(const uint8_t* in, uint8_t* out, const size_t size, const uint8_t maskingKey[4]) noexcept
+  {
+    // 每一步都按 4 的倍数推进，密钥相位始终对齐，可以直接按字重复密钥
+    uint32_t key;
+    std::memcpy(&key, maskingKey, 4);
+    size_t i = 0;
+
+#if defined(__x86_64__) || defined(__i386__)
+    if (size >= 64 && hasAvx2())
+    {
+      i = maskAvx2(in, out, size, key);
+    }
+#endif
+#if defined(__SSE2__)
+    const __m128i k = _mm_set1_epi32(static_cast<int>(key));
+    for (; i + 16 <= size; i += 16)
+    {
+      const __m128i v = _mm_loadu_si128(reinterpret_cast<const __m128i*>(in + i));
+      _mm_storeu_si128(reinterpret_cast<__m128i*>(out + i), _mm_xor_si128(v, k));
+    }
+#endif
+
+    const uint64_t key64 = static_cast<uint64_t>(key) << 32 | key;
+    for (; i + 8 <= size; i += 8)
+    {
+      uint64_t v;
+      std::memcpy(&v, in + i, 8);
+      v ^= key64;
+      std::memcpy(out + i, &v, 8);
+    }
+    for (; i < size; ++i)
+    {
+      out[i] = in[i] ^ maskingKey[i & 3];
+    }
+  }
+
+  void randomMaskingKey(uint8_t maskingKey[4]) noexcept
+  {
+    thread_local std::mt19937 gen(std::random_device{}());
+    const uint32_t key = gen();
+    std::memcpy(maskingKey, &key, 4);
+  }
+
+  std::vector<uint8_t> buildFrame(const std::span<const uint8_t> payload,
+                                  const MessageType type,
+                                  const bool fin,
+                                  const bool mask)
+  {
+    uint8_t maskingKey[4];
+    if (mask)
+    {
+      randomMaskingKey(maskingKey);
+    }
+    const FrameHeader header = makeFrameHeader(payload.size(), type, fin, mask ? maskingKey : nullptr);
+
+    // 一次分配，掩码直接写入目标位置
+    std::vector<uint8_t> frame(header.size + payload.size());
+    std::memcpy(frame.data(), header.data, header.size);
+    if (mask)
+    {
+      maskPayload(payload.data(), frame.data() + header.size, payload.size(), maskingKey);
+    }
+    else if (!payload.empty())
+    {
+      std::memcpy(frame.data() + header.size, payload.data(), payload.size());
+    }
+    return frame;
+  }
+
+  size_t parseFrameHeader(const std::span<const uint8_t> data, Frame& frame)
+  {
+    if (data.size() < 2)
+    {
+      return 0;
+    }
+
+    size_t offset = 0;
+
+    // Parse FIN, RSV and Opcode
+    frame.fin = (data[offset] & 0x80) != 0;
+    frame.rsv = (data[offset] >> 4) & 0x07;
+    frame.opCode = static_cast<MessageType>(data[offset] & 0x0F);
+    offset++;
+
+    // Parse Mask and Payload Length
+    frame.mask = (data[offset] & 0x80) != 0;
+    const uint8_t payloadLenByte = data[offset] & 0x7F;
+    offset++;
+
+    if (payloadLenByte <= 125)
+    {
+      frame.payloadLength = payloadLenByte;
+    }
+    else if (payloadLenByte == 126)
+    {
+      if (data.size() < offset + 2)
+      {
+        return 0;
+      }
+      frame.payloadLength = (static_cast<uint16_t>(data[offset]) << 8) | static_cast<uint16_t>(data[offset + 1]);
+      offset += 2;
+    }
+    else
+    {
+      // 127
+      if (data.size() < offset + 8)
+      {
+        return 0;
+      }
+      frame.payloadLength = 0;
+      for (int i = 0; i < 8; ++i)
+      {
+        frame.payloadLength = frame.payloadLength << 8 | static_cast<uint64_t>(data[offset + i]);
+      }
+      offset += 8;
+    }
+
+    // 安全检查：防止内存耗尽攻击
+    if (frame.payloadLength > MAX_PAYLOAD_SIZE)
+    {
+      throw std::runtime_error("WebSocket payload too large: " + std::to_string(frame.payloadLength) +
+                               " bytes (max: " + std::to_string(MAX_PAYLOAD_SIZE) + " bytes)");
+    }
+
+    // Parse Masking Key
+    if (frame.mask)
+    {
+      if (data.size() < offset + 4)
+      {
+        return 0;
+      }
+      std::memcpy(frame.maskingKey, &data[offset], 4);
+      offset += 4;
+    }
+
+    return offset;
+  }
+
+  size_t parseFrame(const std::span<uint8_t> data, Frame& frame)
+  {
+    const size_t offset = parseFrameHeader(data, frame);
+    if (offset == 0 || data.size() - offset < frame.payloadLength)
+    {
+      return 0;
+    }
+
+    // 负载指向原缓冲区，需要时原地去掉掩码
+    frame.payload = data.subspan(offset, static_cast<size_t>(frame.payloadLength));
+    if (frame.mask)
+    {
+      maskPayload(frame.payload.data(), frame.payload.data(), frame.payload.size(), frame.maskingKey);
+    }
+
+    // 返回解析的总字节数：offset + payloadLength
+    return offset + static_cast<size_t>(frame.payloadLength);
+  }
+
+  // 可以出现在关闭帧中的状态码
+  static bool isValidCloseCode(const uint16_t code)
+  {
+    return (code >= 1000 && code <= 1003) || (code >= 1007 && code <= 1014) || (code >= 3000 && code <= 4999);
+  }
+
+  void MessageReader::append(const std::span<const uint8_t> data)
+  {
+    // 已解析的部分超过一半时才搬移剩余数据，搬移开销摊还到每个字节是常数
+    if (readPos_ == buffer_.size())
+    {
+      buffer_.clear();
+      readPos_ = 0;
+    }
+    else if (readPos_ > 0 && readPos_ >= buffer_.size() / 2)
+    {
+      buffer_.erase(buffer_.begin(), buffer_.begin() + static_cast<ptrdiff_t>(readPos_));
+      readPos_ = 0;
+    }
+    buffer_.insert(buffer_.end(), data.begin(), data.end());
+  }
+
+  void MessageReader::discard(const size_t n) noexcept
+  {
+    readPos_ += std::min(n, buffer_.size() - readPos_);
+  }
+
+  bool MessageReader::fail(const CloseCode code) noexcept
+  {
+    failed_ = true;
+    error_ = code;
+    return false;
+  }
+
+  bool MessageReader::next(Message& message)
+  {
+    // 上一次交付的是重组后的分片消息
+    if (fragmentsDelivered_)
+    {
+      fragments_.clear();
+      fragmentsDelivered_ = false;
+    }
+
+    while (!failed_)
+    {
+      const auto data = std::span(buffer_).subspan(readPos_);
+      Frame frame{};
+      size_t headerSize;
+      try
+      {
+        headerSize = parseFrameHeader(data, frame);
+      }
+      catch (const std::runtime_error&)
+      {
+        return fail(CloseCode::MESSAGE_TOO_BIG);
+      }
+      if (headerSize == 0)
+      {
+        return false;
+      }
+
+      const auto opCode = static_cast<uint8_t>(frame.opCode);
+      const bool control = (opCode & 0x08) != 0;
+      // 只有数据消息的第一帧可以用 RSV1 标记压缩
+      const bool compressed = frame.rsv == (FRAME_RSV1 >> 4) && deflate_ && !control &&
+                              frame.opCode != MessageType::CONTINUATION;
+      if ((frame.rsv != 0 && !compressed) || frame.mask != requireMask_)
+      {
+        return fail(CloseCode::PROTOCOL_ERROR);
+      }
+      if (control)
+      {
+        // 控制帧不能分片，负载不超过 125 字节
+        if (opCode > static_cast<uint8_t>(MessageType::PONG) || !frame.fin || frame.payloadLength > 125)
+        {
+          return fail(CloseCode::PROTOCOL_ERROR);
+        }
+      }
+      else
+      {
+        if (opCode > static_cast<uint8_t>(MessageType::BINARY))
+        {
+          return fail(CloseCode::PROTOCOL_ERROR);
+        }
+        // 在负载到齐之前就拒绝过大的消息
+        const size_t buffered = frame.opCode == MessageType::CONTINUATION ? fragments_.size() : 0;
+        if (frame.payloadLength > maxMessageSize_ - std::min(buffered, maxMessageSize_))
+        {
+          return fail(CloseCode::MESSAGE_TOO_BIG);
+        }
+      }
+      if (data.size() - headerSize < frame.payloadLength)
+      {
+        return false;
+      }
+
+      const auto payload = data.subspan(headerSize, static_cast<size_t>(frame.payloadLength));
+      if (frame.mask)
+      {
+        maskPayload(payload.data(), payload.data(), payload.size(), frame.maskingKey);
+      }
+      readPos_ += headerSize + payload.size();
+
+      if (control)
+      {
+        if (frame.opCode == MessageType::CLOSE && !payload.empty())
+        {
+          // 关闭帧负载：2 字节状态码 + UTF-8 原因
+          if (payload.size() < 2 || !isValidCloseCode(static_cast<uint16_t>(payload[0] << 8 | payload[1])))
+          {
+            return fail(CloseCode::PROTOCOL_ERROR);
+          }
+          if (!isValidUtf8({reinterpret_cast<const char*>(payload.data()) + 2, payload.size() - 2}))
+          {
+            return fail(CloseCode::INVALID_PAYLOAD);
+          }
+        }
+        message = {frame.opCode, payload};
+        return true;
+      }
+
+      bool deflated = compressed;
+      if (frame.opCode == MessageType::CONTINUATION)
+      {
+        if (!fragmented_)
+        {
+          return fail(CloseCode::PROTOCOL_ERROR);
+        }
+        fragments_.insert(fragments_.end(), payload.begin(), payload.end());
+        if (!frame.fin)
+        {
+          continue;
+        }
+        fragmented_ = false;
+        fragmentsDelivered_ = true;
+        deflated = fragmentCompressed_;
+        message = {fragmentType_, fragments_};
+      }
+      else
+      {
+        // 上一条分片消息还没结束
+        if (fragmented_)
+        {
+          return fail(CloseCode::PROTOCOL_ERROR);
+        }
+        if (!frame.fin)
+        {
+          fragmented_ = true;
+          fragmentType_ = frame.opCode;
+          fragmentCompressed_ = compressed;
+          fragments_.assign(payload.begin(), payload.end());
+          continue;
+        }
+        message = {frame.opCode, payload};
+      }
+
+      if (deflated)
+      {
+        switch (deflate_->decompress(message.payload, inflated_, maxMessageSize_))
+        {
+        case InflateStatus::TOO_BIG:
+          return fail(CloseCode::MESSAGE_TOO_BIG);
+        case InflateStatus::CORRUPT:
+          return fail(CloseCode::INVALID_PAYLOAD);
+        case InflateStatus::OK:
+          break;
+        }
+        message.payload = inflated_;
+      }
+
+      if (message.type == MessageType::TEXT &&
+          !isValidUtf8({reinterpret_cast<const char*>(message.payload.data()), message.payload.size()}))
+      {
+        return fail(CloseCode::INVALID_PAYLOAD);
+      }
+      return true;
+    }
+    return false;
+  }
+} // namespace cppkit::websocket
@@ -3,6 +3,7 @@
 #include "cppkit/log/log.hpp"
 #include "cppkit/crypto/base.hpp"
 #include "cppkit/crypto/sha1.hpp"
+#include "cppkit/strings.hpp"
 #include <algorithm>
 #include <sstream>
 #include <stdexcept>
@@ -11,7 +12,7 @@
 namespace cppkit::websocket
 {
     WebSocketServer::WebSocketServer(const std::string& host, const uint16_t port)
-        : _tcpServer(&_loop, host, port), _host(host), _port(port)
+        : _tcpServer(&_ownLoop, host, port), _host(host), _port(port)
     {
     }
 
@@ -32,8 +33,50 @@ namespace cppkit::websocket
         _onClose = std::move(handler);
     }
 
+    void WebSocketServer::setMaxMessageSize(const size_t size)
+    {
+        _maxMessageSize = size;
+    }
+
+    void WebSocketServer::enableDeflate(const DeflateOptions& options)
+    {
+        _deflateEnabled = true;
+        _deflateOptions = options;
+    }
+
+    void WebSocketServer::setOutboxLimits(const OutboxLimits& limits)
+    {
+        _outboxLimits = limits;
+    }
+
+    void WebSocketServer::attach(http::server::HttpServer& server, const std::string& path)
+    {
+        _loop = server.getLoop();
+        _attached = true;
+        server.Upgrade(path, "websocket", {
+                           [this](const event::ConnInfo& connInfo, const http::server::HttpRequest& request,
+                                  const std::span<const uint8_t> leftover)
+                           {
+                               this->onHttpUpgrade(connInfo, request, leftover);
+                           },
+                           [this](const event::ConnInfo& connInfo, const std::vector<uint8_t>& data)
+                           {
+                               this->onTcpMessage(connInfo, data);
+                           },
+                           [this](const event::ConnInfo& connInfo)
+                           {
+                               this->onTcpClose(connInfo);
+                           }
+                       });
+    }
+
     void WebSocketServer::start()
     {
+        if (_attached)
+        {
+            throw std::runtime_error("WebSocket server is attached to an HttpServer");
+        }
+
         // 设置回调函数
         _tcpServer.setOnConnection([this](const event::ConnInfo& connInfo)
         {
@@ -47,26 +90,21 @@ namespace cppkit::websocket
 
         _tcpServer.setOnClose([this](const event::ConnInfo& connInfo)
         {
-            if (const std::string clientId = connInfo.getClientId(); _connStates.contains(clientId))
-            {
-                _connStates.erase(clientId);
-            }
-
-            if (_onClose)
-            {
-                const ConnInfo wsConnInfo(connInfo);
-                _onClose(wsConnInfo);
-            }
+            this->onTcpClose(connInfo);
         });
 
         _tcpServer.start();
         std::cout << "Started ws server on " << this->_host << ":" << this->_port << std::endl;
-        _loop.run();
+        _ownLoop.run();
     }
 
     void WebSocketServer::stop()
     {
-        _loop.stop();
+        if (_attached)
+        {
+            return;
+        }
+        _ownLoop.stop();
         _tcpServer.stop();
     }
 
@@ -80,146 +118,389 @@ namespace cppkit::websocket
         return _port;
     }
 
+    ConnData* WebSocketServer::findConn(const int fd) const
+    {
+        if (fd < 0 || static_cast<size_t>(fd) >= _conns.size())
+        {
+            return nullptr;
+        }
+        return _conns[fd].get();
+    }
+
     void WebSocketServer::onTcpConnect(const event::ConnInfo& connInfo)
     {
         // 初始状态为握手中
-        const std::string clientId = connInfo.getClientId();
-        _connStates[clientId] = ConnData{ConnState::HAND_SHAKING, {}};
+        const int fd = connInfo.getFd();
+        if (static_cast<size_t>(fd) >= _conns.size())
+        {
+            _conns.resize(fd + 1);
+        }
+        _conns[fd] = std::make_unique<ConnData>(connInfo, _loop, _maxMessageSize, _outboxLimits,
+                                                [this](const int cfd, int)
+                                                {
+                                                    this->onTcpWritable(cfd);
+                                                });
     }
 
-    void WebSocketServer::onTcpMessage(const event::ConnInfo& connInfo, const std::vector<uint8_t>& data)
+    void WebSocketServer::onTcpWritable(const int fd)
     {
-        // 最大缓冲区大小限制 (防止内存耗尽攻击)
-        constexpr size_t MAX_BUFFER_SIZE = 16 * 1024 * 1024; // 16 MB
+        ConnData* conn = findConn(fd);
+        if (conn && !conn->closed && !conn->outbox.flush())
+        {
+            conn->raw.close();
+        }
+    }
 
-        const std::string clientId = connInfo.getClientId();
-        const auto it = _connStates.find(clientId);
+    void WebSocketServer::onTcpClose(const event::ConnInfo& connInfo)
+    {
+        if (ConnData* conn = findConn(connInfo.getFd()))
+        {
+            // 立即退订，避免之后的发布再发给它
+            for (const auto& topic : conn->topics)
+            {
+                if (const auto it = _topics.find(topic); it != _topics.end())
+                {
+                    std::erase(it->second, connInfo.getFd());
+                    if (it->second.empty())
+                    {
+                        _topics.erase(it);
+                    }
+                }
+            }
+            conn->topics.clear();
 
-        if (it == _connStates.end())
+            // 正在处理该连接的数据时（例如在回调里关闭），等处理结束再释放
+            if (conn->dispatching)
+            {
+                conn->closed = true;
+            }
+            else
+            {
+                _conns[connInfo.getFd()].reset();
+            }
+        }
+
+        if (_onClose)
+        {
+            const ConnInfo wsConnInfo(connInfo);
+            _onClose(wsConnInfo);
+        }
+    }
+
+    void WebSocketServer::onTcpMessage(const event::ConnInfo& connInfo, const std::vector<uint8_t>& data)
+    {
+        ConnData* conn = findConn(connInfo.getFd());
+        if (!conn || conn->closed)
         {
             return; // 找不到连接状态，忽略消息
         }
 
-        if (auto& [state, buffer] = it->second; state == ConnState::HAND_SHAKING)
+        conn->dispatching = true;
+        handleData(connInfo, *conn, data);
+        conn->dispatching = false;
+
+        if (conn->closed)
+        {
+            _conns[connInfo.getFd()].reset();
+        }
+    }
+
+    void WebSocketServer::handleData(const event::ConnInfo& connInfo, ConnData& conn,
+                                     const std::vector<uint8_t>& data)
+    {
+        // 握手请求头大小限制 (防止内存耗尽攻击)
+        constexpr size_t MAX_HANDSHAKE_SIZE = 64 * 1024;
+
+        MessageReader& reader = conn.reader;
+        reader.append(data);
+
+        if (conn.state == ConnState::HAND_SHAKING)
         {
-            // 检查缓冲区大小
-            if (buffer.size() + data.size() > MAX_BUFFER_SIZE)
+            // 收集数据直到找到完整的HTTP请求头（以\r\n\r\n结尾）
+            const auto pending = reader.pending();
+            const std::string_view buffered(reinterpret_cast<const char*>(pending.data()), pending.size());
+            const size_t headerEnd = buffered.find("\r\n\r\n");
+            if (headerEnd == std::string_view::npos)
             {
-                std::cerr << "WebSocket handshake buffer too large, closing connection" << std::endl;
-                connInfo.close();
+                if (buffered.size() > MAX_HANDSHAKE_SIZE)
+                {
+                    std::cerr << "WebSocket handshake buffer too large, closing connection" << std::endl;
+                    connInfo.close();
+                }
                 return;
             }
 
-            // 收集数据直到找到完整的HTTP请求头
-            buffer.insert(buffer.end(), data.begin(), data.end());
+            const auto req = http::server::HttpRequest::parse(connInfo.getFd(),
+                                                              std::string(buffered.substr(0, headerEnd + 4)), "");
 
-            // 检查是否收到完整的HTTP头（以\r\n\r\n结尾）
-            std::string bufferStr(buffer.begin(), buffer.end());
+            // 请求头之后可能已经跟着数据帧
+            reader.discard(headerEnd + 4);
+            if (!upgrade(connInfo, conn, req))
+            {
+                return;
+            }
+        }
+
+        handleMessages(conn);
+    }
+
+    bool WebSocketServer::upgrade(const event::ConnInfo& connInfo, ConnData& conn,
+                                  const http::server::HttpRequest& request)
+    {
+        if (!handleHandshake(connInfo, request, conn))
+        {
+            connInfo.close();
+            return false;
+        }
+        conn.state = ConnState::CONNECTED;
+
+        // 通知连接已建立
+        if (_onConnect)
+        {
+            _onConnect(request, ConnInfo(conn.raw, &conn.outbox, conn.deflate.get()));
+        }
+        return !conn.closed;
+    }
+
+    void WebSocketServer::onHttpUpgrade(const event::ConnInfo& connInfo, const http::server::HttpRequest& request,
+                                        const std::span<const uint8_t> leftover)
+    {
+        onTcpConnect(connInfo);
+        ConnData& conn = *findConn(connInfo.getFd());
+
+        conn.dispatching = true;
+        if (upgrade(connInfo, conn, request))
+        {
+            conn.reader.append(leftover);
+            handleMessages(conn);
+        }
+        conn.dispatching = false;
+
+        if (conn.closed)
+        {
+            _conns[connInfo.getFd()].reset();
+        }
+    }
 
-            if (const size_t headerEnd = bufferStr.find("\r\n\r\n"); headerEnd != std::string::npos)
+    void WebSocketServer::handleMessages(ConnData& conn)
+    {
+        MessageReader& reader = conn.reader;
+        const ConnInfo wsConnInfo(conn.raw, &conn.outbox, conn.deflate.get());
+        MessageReader::Message message{};
+        while (reader.next(message))
+        {
+            switch (message.type)
             {
-                // 完成握手
-                if (handleHandshake(connInfo, buffer))
+            case MessageType::PING:
+                // 自动回复相同负载的 PONG
+                (void)wsConnInfo.sendMessage(message.payload, MessageType::PONG);
+                break;
+            case MessageType::PONG:
+                break;
+            case MessageType::CLOSE:
                 {
-                    state = ConnState::CONNECTED;
-
-                    // 通知连接已建立
-                    if (_onConnect)
+                    // 回送对方的状态码后关闭
+                    const auto code = message.payload.size() >= 2
+                                          ? static_cast<CloseCode>(message.payload[0] << 8 | message.payload[1])
+                                          : CloseCode::NORMAL;
+                    wsConnInfo.close(code);
+                    return;
+                }
+            default:
+                if (_onMessage)
+                {
+                    _onMessage(wsConnInfo, message.payload, message.type);
+                    if (conn.closed)
                     {
-                        const auto req =
-                            http::server::HttpRequest::parse(connInfo.getFd(),
-                                                             std::string(buffer.begin(), buffer.end()), "");
-                        _onConnect(req, ConnInfo(connInfo));
+                        return;
                     }
-
-                    buffer.clear();
                 }
+                break;
             }
         }
-        else if (state == ConnState::CONNECTED) // 已连接状态
+
+        if (reader.failed())
+        {
+            wsConnInfo.close(reader.error());
+        }
+    }
+
+    bool WebSocketServer::send(const ConnInfo& conn, const std::span<const uint8_t> message, const MessageType type)
+    {
+        ConnData* data = findConn(conn.getRawConnInfo().getFd());
+        if (!data || data->closed || data->state != ConnState::CONNECTED)
+        {
+            return false;
+        }
+        const bool sent = ConnInfo(data->raw, &data->outbox, data->deflate.get()).sendMessage(message, type) >= 0;
+        if (data->outbox.broken())
+        {
+            data->raw.close();
+        }
+        return sent;
+    }
+
+    void WebSocketServer::subscribe(const ConnInfo& conn, const std::string& topic)
+    {
+        const int fd = conn.getRawConnInfo().getFd();
+        ConnData* data = findConn(fd);
+        if (!data || data->closed || std::ranges::find(data->topics, topic) != data->topics.end())
+        {
+            return;
+        }
+        data->topics.push_back(topic);
+        _topics[topic].push_back(fd);
+    }
+
+    void WebSocketServer::unsubscribe(const ConnInfo& conn, const std::string& topic)
+    {
+        const int fd = conn.getRawConnInfo().getFd();
+        ConnData* data = findConn(fd);
+        if (!data || std::erase(data->topics, topic) == 0)
         {
-            // 检查缓冲区大小
-            if (buffer.size() + data.size() > MAX_BUFFER_SIZE)
+            return;
+        }
+        if (const auto it = _topics.find(topic); it != _topics.end())
+        {
+            std::erase(it->second, fd);
+            if (it->second.empty())
             {
-                std::cerr << "WebSocket message buffer too large, closing connection" << std::endl;
-                connInfo.close();
-                return;
+                _topics.erase(it);
             }
+        }
+    }
+
+    size_t WebSocketServer::subscriberCount(const std::string& topic) const
+    {
+        const auto it = _topics.find(topic);
+        return it == _topics.end() ? 0 : it->second.size();
+    }
 
-            // 追加数据到缓冲区
-            buffer.insert(buffer.end(), data.begin(), data.end());
+    struct WebSocketServer::Fanout
+    {
+        std::span<const uint8_t> message;
+        MessageType type;
 
-            Frame frame;
-            size_t parsedOffset = 0;
+        SharedFrame plain{}; // 未压缩的帧
 
-            while (true)
-            {
-                if (buffer.size() < parsedOffset + 2)
-                {
-                    break; // 不完整的帧头
-                }
+        // 每条消息独立压缩的连接按压缩窗口共享压缩结果
+        SharedFrame compressed[16]{};
+    };
 
-                // 尝试解析帧
-                if (const size_t parsedBytes = parseFrame(
-                    std::span<const uint8_t>(buffer.data() + parsedOffset, buffer.size() - parsedOffset),
-                    frame);
-                    parsedBytes > 0)
-                {
-                    parsedOffset += parsedBytes;
+    bool WebSocketServer::deliver(ConnData& conn, Fanout& fanout, std::vector<int>& broken)
+    {
+        if (conn.closed || conn.state != ConnState::CONNECTED)
+        {
+            return false;
+        }
 
-                    // 处理消息
-                    if (_onMessage)
+        bool sent;
+        if (PerMessageDeflate* deflate = conn.deflate.get(); deflate && deflate->shouldCompress(fanout.message.size()))
+        {
+            if (deflate->compressesIndependently())
+            {
+                // 压缩结果只取决于负载与窗口大小（级别与内存级别全服务器相同）
+                SharedFrame& frame = fanout.compressed[deflate->compressWindowBits()];
+                if (!frame)
+                {
+                    std::vector<uint8_t> compressed;
+                    deflate->compress(fanout.message, compressed);
+                    if (compressed.size() < fanout.message.size())
+                    {
+                        frame = makeSharedFrame(compressed, fanout.type, true);
+                    }
+                    else
                     {
-                        if (frame.opCode == MessageType::CLOSE)
+                        // 压缩后没有变小：与 sendMessage 一致发送未压缩的帧，同一窗口的其他连接也复用它
+                        if (!fanout.plain)
                         {
-                            // 关闭连接
-                            connInfo.close();
-                            return;
+                            fanout.plain = makeSharedFrame(fanout.message, fanout.type);
                         }
-                        ConnInfo wsConnInfo(connInfo);
-                        _onMessage(wsConnInfo, frame.payload, frame.opCode);
+                        frame = fanout.plain;
                     }
                 }
-                else
-                {
-                    break; // 无法解析完整帧，等待更多数据
-                }
+                sent = conn.outbox.send(frame);
+            }
+            else
+            {
+                // 沿用上下文的压缩流每个连接各不相同，只能逐个压缩
+                sent = ConnInfo(conn.raw, &conn.outbox, deflate).sendMessage(fanout.message, fanout.type) >= 0;
+            }
+        }
+        else
+        {
+            if (!fanout.plain)
+            {
+                fanout.plain = makeSharedFrame(fanout.message, fanout.type);
             }
+            sent = conn.outbox.send(fanout.plain);
+        }
+
+        if (conn.outbox.broken())
+        {
+            broken.push_back(conn.raw.getFd());
+        }
+        return sent;
+    }
 
-            // 移除已解析的数据
-            if (parsedOffset > 0)
+    void WebSocketServer::closeBroken(const std::vector<int>& broken)
+    {
+        for (const int fd : broken)
+        {
+            if (ConnData* conn = findConn(fd); conn && !conn->closed)
             {
-                if (parsedOffset < buffer.size())
-                {
-                    buffer = std::vector<uint8_t>(buffer.begin() + static_cast<ptrdiff_t>(parsedOffset), buffer.end());
-                }
-                else
-                {
-                    buffer.clear();
-                }
+                std::cerr << "WebSocket client " << conn->raw.getClientId()
+                          << " is too slow or broken, closing connection" << std::endl;
+                conn->raw.close();
             }
         }
     }
 
-    bool WebSocketServer::handleHandshake(const event::ConnInfo& connInfo, const std::vector<uint8_t>& data)
+    size_t WebSocketServer::publish(const std::string& topic, const std::span<const uint8_t> message,
+                                    const MessageType type)
     {
-        std::string request(reinterpret_cast<const char*>(data.data()), data.size());
+        const auto it = _topics.find(topic);
+        if (it == _topics.end())
+        {
+            return 0;
+        }
 
-        // 提取 Sec-WebSocket-Key
-        std::string key;
-        size_t keyPos = request.find("Sec-WebSocket-Key: ");
-        if (keyPos == std::string::npos)
+        // 关闭连接会修改订阅列表，先发送，遍历结束后再关闭
+        Fanout fanout{message, type};
+        std::vector<int> broken;
+        size_t delivered = 0;
+        for (const int fd : it->second)
         {
-            return false;
+            if (ConnData* conn = findConn(fd); conn && deliver(*conn, fanout, broken))
+            {
+                ++delivered;
+            }
         }
+        closeBroken(broken);
+        return delivered;
+    }
 
-        size_t keyEnd = request.find("\r\n", keyPos);
-        if (keyEnd == std::string::npos)
+    size_t WebSocketServer::broadcast(const std::span<const uint8_t> message, const MessageType type)
+    {
+        Fanout fanout{message, type};
+        std::vector<int> broken;
+        size_t delivered = 0;
+        for (const auto& conn : _conns)
         {
-            return false;
+            if (conn && deliver(*conn, fanout, broken))
+            {
+                ++delivered;
+            }
         }
+        closeBroken(broken);
+        return delivered;
+    }
 
-        key = request.substr(keyPos + 19, keyEnd - (keyPos + 19));
+    bool WebSocketServer::handleHandshake(const event::ConnInfo& connInfo, const http::server::HttpRequest& request,
+                                          ConnData& conn) const
+    {
+        // 提取 Sec-WebSocket-Key
+        const std::string key = request.getHeader("Sec-WebSocket-Key");
 
         // 验证 WebSocket Key 长度 (应该是 24 字节的 base64 编码)
         if (key.empty() || key.length() > 100)
@@ -232,15 +513,31 @@ namespace cppkit::websocket
         const std::string magic = "258EAFA5-E914-47DA-95CA-C5AB0DC85B11";
         std::string combined = key + magic;
         const auto sha1Binary = crypto::SHA1::shaBinary(combined);
-        std::vector<uint8_t> sha1Bytes(sha1Binary.begin(), sha1Binary.end());
-        std::string accept = crypto::Base64::encode(sha1Bytes);
+        std::string accept = crypto::Base64::encode(sha1Binary);
 
         // 构建响应
         std::stringstream response;
         response << "HTTP/1.1 101 Switching Protocols\r\n";
         response << "Upgrade: websocket\r\n";
         response << "Connection: Upgrade\r\n";
-        response << "Sec-WebSocket-Accept: " << accept << "\r\n\r\n";
+        response << "Sec-WebSocket-Accept: " << accept << "\r\n";
+
+        // 扩展头可能出现多次，合并后协商
+        if (_deflateEnabled)
+        {
+            const auto headers = request.getHeaders();
+            if (const auto it = headers.find("sec-websocket-extensions"); it != headers.end())
+            {
+                DeflateParams params;
+                if (const auto accepted = negotiateDeflate(join(it->second, ", "), _deflateOptions, params))
+                {
+                    conn.deflate = std::make_unique<PerMessageDeflate>(params, true, _deflateOptions);
+                    conn.reader.setDeflate(conn.deflate.get());
+                    response << "Sec-WebSocket-Extensions: " << *accepted << "\r\n";
+                }
+            }
+        }
+        response << "\r\n";
 
         std::string respStr = response.str();
         ssize_t sent = connInfo.send(reinterpret_cast<const uint8_t*>(respStr.c_str()), respStr.size());
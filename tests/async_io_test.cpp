@@ -0,0 +1,156 @@
+#include "cppkit/io/file.hpp"
+#include "cppkit/concurrency/coroutine.hpp"
+#include "cppkit/testing/test.hpp"
+#include <fstream>
+#include <unistd.h>
+
+using namespace cppkit;
+using namespace cppkit::io;
+using namespace cppkit::testing;
+
+static std::string tempPath(const std::string& name)
+{
+  return (std::filesystem::temp_directory_path() / (name + "_" + std::to_string(getpid()))).string();
+}
+
+// 运行事件循环直到 done 为真，最多 3 秒
+template <typename Fn>
+static bool runUntil(event::EventLoop& loop, Fn&& done)
+{
+  const auto deadline = std::chrono::steady_clock::now() + std::chrono::seconds(3);
+  const int64_t check = loop.createTimeEvent(1, [&](int64_t) -> int64_t
+  {
+    if (done() || std::chrono::steady_clock::now() > deadline)
+    {
+      loop.stop();
+      return 0;
+    }
+    return 1;
+  });
+  loop.run();
+  if (!done())
+    loop.deleteTimeEvent(check);
+  return done();
+}
+
+static std::vector<IoBackend> backends()
+{
+  std::vector<IoBackend> result{IoBackend::THREAD_POOL};
+  event::EventLoop loop;
+  if (IoEngine(&loop).usingIoUring())
+    result.push_back(IoBackend::IO_URING);
+  return result;
+}
+
+TEST(AsyncIoTest, WriteSyncThenBatchedReads)
+{
+  for (const IoBackend backend : backends())
+  {
+    const std::string path = tempPath("cppkit_async_rw");
+    std::ofstream(path).close();
+    event::EventLoop loop;
+    IoEngine engine(&loop, IoEngineConfig{.queueDepth = 8, .backend = backend, .fallbackThreads = 2});
+    ASSERT_EQ(engine.usingIoUring(), backend == IoBackend::IO_URING);
+    const File file(path);
+
+    std::string data(64 * 1024, '\0');
+    for (size_t i = 0; i < data.size(); ++i)
+      data[i] = static_cast<char>(i * 7 % 251);
+    ssize_t written = 0;
+    bool synced = false;
+    file.writeAsync(engine, data.data(), data.size(), 0, [&](const ssize_t n)
+    {
+      written = n;
+      file.fsyncAsync(engine, [&](const ssize_t result) { synced = result == 0; }, true);
+    });
+    ASSERT_TRUE(runUntil(loop, [&] { return synced; }));
+    ASSERT_EQ(written, static_cast<ssize_t>(data.size()));
+
+    // 1024 个 64 字节的小读，队列深度 8：多余的请求排队，在途数不超过深度
+    constexpr size_t count = 1024;
+    std::vector<char> buffer(count * 64);
+    size_t completed = 0;
+    size_t maxInflight = 0;
+    bool ok = true;
+    for (size_t i = 0; i < count; ++i)
+    {
+      file.readAsync(engine, buffer.data() + i * 64, 64, i * 64, [&, i](const ssize_t n)
+      {
+        ok = ok && n == 64 && std::memcmp(buffer.data() + i * 64, data.data() + i * 64, 64) == 0;
+        maxInflight = std::max(maxInflight, engine.inflight());
+        ++completed;
+      });
+    }
+    ASSERT_EQ(engine.queued(), count);
+    ASSERT_TRUE(runUntil(loop, [&] { return completed == count; }));
+    ASSERT_TRUE(ok);
+    ASSERT_TRUE(maxInflight <= 8);
+    ASSERT_EQ(engine.inflight(), 0u);
+
+    // 错误以 -errno 返回
+    ssize_t bad = 0;
+    engine.read(-1, buffer.data(), 1, 0, [&](const ssize_t n) { bad = n; });
+    ASSERT_TRUE(runUntil(loop, [&] { return bad != 0; }));
+    ASSERT_EQ(bad, static_cast<ssize_t>(-EBADF));
+    std::filesystem::remove(path);
+  }
+}
+
+static concurrency::Task<void> appendExclamation(IoEngine& engine, const File& file, std::string& out, bool& finished)
+{
+  char buffer[64];
+  const ssize_t n = co_await file.readAsync(engine, buffer, sizeof(buffer));
+  out.assign(buffer, n > 0 ? n : 0);
+  const ssize_t w = co_await file.writeAsync(engine, "!", 1, n);
+  finished = w == 1 && co_await file.fsyncAsync(engine) == 0;
+}
+
+TEST(AsyncIoTest, AwaitFromTask)
+{
+  for (const IoBackend backend : backends())
+  {
+    const std::string path = tempPath("cppkit_async_task");
+    std::ofstream(path) << "hello";
+    event::EventLoop loop;
+    IoEngine engine(&loop, IoEngineConfig{.backend = backend});
+    const File file(path);
+    std::string out;
+    bool finished = false;
+
+    // 调度器只负责启动协程，之后由事件循环在 IO 完成时恢复
+    concurrency::Scheduler scheduler;
+    auto task = appendExclamation(engine, file, out, finished);
+    task.schedule_on(scheduler);
+    scheduler.run();
+    ASSERT_TRUE(runUntil(loop, [&] { return finished; }));
+    ASSERT_EQ(out, std::string("hello"));
+    ASSERT_EQ(file.size(), 6u);
+    std::filesystem::remove(path);
+  }
+}
+
+TEST(AsyncIoTest, DestructorWaitsForInflight)
+{
+  for (const IoBackend backend : backends())
+  {
+    const std::string path = tempPath("cppkit_async_dtor");
+    std::ofstream(path) << std::string(4096, 'x');
+    const File file(path);
+    std::vector<char> buffer(4096 * 16);
+    event::EventLoop loop;
+    {
+      IoEngine engine(&loop, IoEngineConfig{.queueDepth = 4, .backend = backend});
+      for (size_t i = 0; i < 16; ++i)
+        file.readAsync(engine, buffer.data() + i * 4096, 4096, 0, [](ssize_t) {});
+      engine.submit();
+      ASSERT_EQ(engine.inflight(), 4u);
+      ASSERT_EQ(engine.queued(), 12u);
+    }
+    std::filesystem::remove(path);
+  }
+}
+
+int main()
+{
+  return RunAllTests();
+}
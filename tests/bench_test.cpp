@@ -0,0 +1,128 @@
+#include "cppkit/testing/bench.hpp"
+#include "cppkit/json/json.hpp"
+#include "cppkit/testing/test.hpp"
+#include <atomic>
+#include <fstream>
+#include <sstream>
+
+using namespace cppkit::testing;
+using namespace cppkit;
+
+static std::atomic<uint64_t> loopCount{0};
+static std::atomic<int> maxThreads{0};
+
+BENCH(BenchSelf, Loop)
+{
+  uint64_t n = 0;
+  for (auto _ : state)
+  {
+    ++n;
+    bench::DoNotOptimize(n);
+  }
+  loopCount += n;
+  state.SetItemsProcessed(n);
+  state.SetBytesProcessed(n * 8);
+}
+
+BENCH_THREADS(BenchSelf, Threads, 3)
+{
+  for (auto _ : state)
+  {
+    bench::ClobberMemory();
+  }
+  int seen = maxThreads.load();
+  while (seen < state.Threads() && !maxThreads.compare_exchange_weak(seen, state.Threads()))
+  {
+  }
+  state.SetItemsProcessed(state.Iterations());
+}
+
+TEST(BenchTest, StateIterations)
+{
+  bench::State state(1000, 0, 1, nullptr);
+  uint64_t n = 0;
+  for (auto _ : state)
+  {
+    ++n;
+  }
+  ASSERT_EQ(n, static_cast<uint64_t>(1000));
+  ASSERT_EQ(state.Iterations(), static_cast<uint64_t>(1000));
+  ASSERT_TRUE(state.Elapsed().count() >= 0);
+}
+
+TEST(BenchTest, PauseExcludesSetup)
+{
+  bench::State state(3, 0, 1, nullptr);
+  for (auto _ : state)
+  {
+    state.PauseTiming();
+    std::this_thread::sleep_for(std::chrono::milliseconds(20));
+    state.ResumeTiming();
+  }
+  ASSERT_TRUE(state.Elapsed() < std::chrono::milliseconds(30));
+}
+
+TEST(BenchTest, CalibrateReachesMinTime)
+{
+  bench::Options options;
+  options.min_time = 0.02;
+  options.warmup_time = 0;
+  const auto fn = [](bench::State& state)
+  {
+    for (auto _ : state)
+    {
+      std::this_thread::sleep_for(std::chrono::microseconds(100));
+    }
+  };
+  const uint64_t iterations = bench::inner::Calibrate(fn, 1, options);
+  ASSERT_TRUE(iterations >= 2);
+  ASSERT_TRUE(bench::inner::RunOnce(fn, iterations, 1).seconds >= 0.02);
+}
+
+TEST(BenchTest, ParseArgs)
+{
+  const char* argv[] = {"bench", "--filter=Json", "--min-time=0.25", "--repetitions=3", "--json=out.json"};
+  bench::Options options;
+  ASSERT_TRUE(bench::inner::ParseArgs(5, const_cast<char**>(argv), options));
+  ASSERT_EQ(options.filter, std::string("Json"));
+  ASSERT_EQ(options.min_time, 0.25);
+  ASSERT_EQ(options.repetitions, 3);
+  ASSERT_EQ(options.json_path, std::string("out.json"));
+
+  const char* bad[] = {"bench", "--min-time=abc"};
+  ASSERT_TRUE(!bench::inner::ParseArgs(2, const_cast<char**>(bad), options));
+  const char* unknown[] = {"bench", "--unknown"};
+  ASSERT_TRUE(!bench::inner::ParseArgs(2, const_cast<char**>(unknown), options));
+}
+
+TEST(BenchTest, JsonReport)
+{
+  bench::Options options;
+  options.filter = "BenchSelf.";
+  options.min_time = 0.01;
+  options.warmup_time = 0;
+  options.repetitions = 3;
+  options.json_path = "/tmp/cppkit_bench_test.json";
+  ASSERT_EQ(bench::RunAllBenchmarks(options), 0);
+  ASSERT_TRUE(loopCount.load() > 0);
+  ASSERT_EQ(maxThreads.load(), 3);
+
+  std::ifstream ifs(options.json_path);
+  std::stringstream ss;
+  ss << ifs.rdbuf();
+  const auto report = json::Json::parse(ss.str());
+  const auto& results = report["benchmarks"].asArray();
+  ASSERT_EQ(results.size(), static_cast<size_t>(2));
+  ASSERT_EQ(results[0]["name"].asString(), std::string_view("BenchSelf.Loop"));
+  ASSERT_EQ(results[1]["name"].asString(), std::string_view("BenchSelf.Threads/threads:3"));
+  ASSERT_EQ(results[1]["threads"].asInt64(), static_cast<int64_t>(3));
+  ASSERT_TRUE(results[0]["ns_per_op"].asNumber() > 0);
+  ASSERT_TRUE(results[0]["ns_per_op_min"].asNumber() <= results[0]["ns_per_op_max"].asNumber());
+  ASSERT_TRUE(results[0]["items_per_second"].asNumber() > 0);
+  ASSERT_TRUE(results[0]["bytes_per_second"].asNumber() > results[0]["items_per_second"].asNumber());
+}
+
+int main()
+{
+  return RunAllTests();
+}
@@ -1,30 +1,104 @@
 #include "cppkit/crypto/crypto.hpp"
 #include "cppkit/random.hpp"
+#include "cppkit/testing/test.hpp"
+#include <algorithm>
 #include <iostream>
 
-int main()
+using namespace cppkit::crypto;
+using namespace cppkit::testing;
+
+template <typename Hash>
+static std::string hashWith(const ShaBackend backend, const std::string& message, const size_t chunk)
+{
+  const ShaBackend saved = Hash::backend();
+  Hash::setBackend(backend);
+  Hash hash;
+  for (size_t i = 0; i < message.size(); i += chunk)
+    hash.update(reinterpret_cast<const uint8_t*>(message.data()) + i, std::min(chunk, message.size() - i));
+  Hash::setBackend(saved);
+  return hash.hexDigest();
+}
+
+static std::string toHexString(const std::array<uint8_t, 32>& digest)
+{
+  return toHex(std::vector<uint8_t>(digest.begin(), digest.end()));
+}
+
+TEST(CryptoTest, KnownVectors)
 {
   const std::string str = "hello world";
   const std::string key = "today";
 
-  assert(cppkit::crypto::MD5::hash(str) == "5eb63bbbe01eeed093cb22bb8f5acdc3");
+  ASSERT_EQ(MD5::hash(str), "5eb63bbbe01eeed093cb22bb8f5acdc3");
+  ASSERT_EQ(SHA1::sha(str), "2aae6c35c94fcfb415dbe95f408b9ce91ee846ed");
+  ASSERT_EQ(SHA256::sha(str), "b94d27b9934d3e08a52e52d7da7dabfac484efe37a5380ee9088f7ace2efcde9");
+  ASSERT_EQ(SHA256::hmac(key, str), "49263232009275ea7b06a79aabe5949acdafcd4f3b0f2300bef802aa5847a7e6");
+
+  // 填充跨越两个块
+  ASSERT_EQ(SHA256::sha(std::string(56, 'a')), "b35439a4ac6f0948b6d6f9e3c6af0f5f590ce20f1bde7090ef7970686ec6738a");
+  ASSERT_EQ(SHA1::sha(std::string(56, 'a')), "c2db330f6083854c99d4b5bfb6e8f29f201be699");
+  ASSERT_EQ(SHA256::sha(std::string(1000, 'a')), "41edece42d63e8d9bf515a9ba6932e1c20cbc9f5a5d134645adb5db1b9737ea3");
+  ASSERT_EQ(SHA1::sha(std::string(1000, 'a')), "291e9a6c66994949b57ba5e650361e98fc36b1ba");
+
+  SHA512 sha512;
+  sha512.update(str);
+  ASSERT_EQ(sha512.hexDigest(),
+            "309ecc489c12d6eb4cc40f50c902f2b4d0ed77ee511a7c7a9bcd3ca86d4cd86f989dd35bc5ff499670da34255b45b0cfd830e81f605dcf7dc5542e93ae9cd76f");
+}
 
-  cppkit::crypto::SHA1 sha1;
-  sha1.update(str);
-  assert(sha1.hexDigest()=="2aae6c35c94fcfb415dbe95f408b9ce91ee846ed");
+TEST(CryptoTest, BackendsAgree)
+{
+  std::string message(700, '\0');
+  for (size_t i = 0; i < message.size(); ++i)
+    message[i] = static_cast<char>(i * 131 + 7);
 
-  cppkit::crypto::SHA256 sha256;
-  sha256.update(str);
-  assert(sha256.hexDigest()=="b94d27b9934d3e08a52e52d7da7dabfac484efe37a5380ee9088f7ace2efcde9");
+  for (const auto backend : {ShaBackend::ShaNi, ShaBackend::Avx2})
+  {
+    if (!isSupported(backend))
+    {
+      std::cout << "skip " << backendName(backend) << std::endl;
+      continue;
+    }
+    for (size_t len = 0; len <= message.size(); len += 13)
+    {
+      const std::string part = message.substr(0, len);
+      for (const size_t chunk : {size_t{1}, size_t{7}, size_t{64}, size_t{1000}})
+      {
+        ASSERT_EQ(hashWith<SHA256>(backend, part, chunk), hashWith<SHA256>(ShaBackend::Scalar, part, 1000));
+        if (backend == ShaBackend::ShaNi)
+          ASSERT_EQ(hashWith<SHA1>(backend, part, chunk), hashWith<SHA1>(ShaBackend::Scalar, part, 1000));
+      }
+    }
+  }
+  ASSERT_TRUE(!SHA1::setBackend(ShaBackend::Avx2));
+}
 
-  assert(cppkit::crypto::SHA256::hmac(key, str)=="49263232009275ea7b06a79aabe5949acdafcd4f3b0f2300bef802aa5847a7e6");
+TEST(CryptoTest, HashMany)
+{
+  std::vector<std::string> storage;
+  for (size_t i = 0; i < 21; ++i)
+    storage.push_back(std::string(i * 29 % 200 + (i % 3 == 0 ? 64 : 0), static_cast<char>('a' + i)));
+  // 长度相同的一组
+  for (size_t i = 0; i < 8; ++i)
+    storage.push_back(std::string(100, static_cast<char>('A' + i)));
+  const std::vector<std::string_view> messages(storage.begin(), storage.end());
 
-  cppkit::crypto::SHA512 sha512;
-  sha512.update(str);
-  assert(
-      sha512.hexDigest()==
-      "309ecc489c12d6eb4cc40f50c902f2b4d0ed77ee511a7c7a9bcd3ca86d4cd86f989dd35bc5ff499670da34255b45b0cfd830e81f605dcf7dc5542e93ae9cd76f");
+  for (const auto backend : {ShaBackend::Scalar, ShaBackend::ShaNi, ShaBackend::Avx2})
+  {
+    if (!isSupported(backend))
+      continue;
+    const ShaBackend saved = SHA256::backend();
+    SHA256::setBackend(backend);
+    std::vector<std::array<uint8_t, 32>> digests(messages.size());
+    SHA256::hashMany(messages, digests);
+    SHA256::setBackend(saved);
+    for (size_t i = 0; i < messages.size(); ++i)
+      ASSERT_EQ(toHexString(digests[i]), SHA256::sha(storage[i]));
+  }
+}
 
+TEST(CryptoTest, AesCbcRoundTrip)
+{
   // 随机生成IV
   std::string iv(16, '\0');
   for (auto& c : iv)
@@ -35,16 +109,318 @@ int main()
   auto key_bytes = reinterpret_cast<const uint8_t*>(AESkey.data());
   const auto* iv_bytes = reinterpret_cast<const uint8_t*>(iv.data());
 
-  // Encrypt CBC
-  std::vector<uint8_t> cipher = cppkit::crypto::AES_Encrypt_CBC(
-      std::vector<uint8_t>(plaintext.begin(), plaintext.end()),
-      key_bytes,
-      iv_bytes);
-  std::cout << "加密后数据 (hex): " << cppkit::crypto::toHex(cipher) << "\n";
-
-  // Decrypt CBC
-  std::vector<uint8_t> decrypted = cppkit::crypto::AES_Decrypt_CBC(cipher, key_bytes, iv_bytes);
-  std::string recovered(decrypted.begin(), decrypted.end());
-  std::cout << "加密前数据: " << recovered << "\n";
-  return 0;
-}
\ No newline at end of file
+  std::vector<uint8_t> cipher = AES_Encrypt_CBC(std::vector<uint8_t>(plaintext.begin(), plaintext.end()), key_bytes,
+                                                iv_bytes);
+  std::vector<uint8_t> decrypted = AES_Decrypt_CBC(cipher, key_bytes, iv_bytes);
+  ASSERT_EQ(std::string(decrypted.begin(), decrypted.end()), plaintext);
+}
+
+TEST(HmacTest, Rfc4231Vectors)
+{
+  const std::string key = "Jefe";
+  const std::string message = "what do ya want for nothing?";
+  ASSERT_EQ(Hmac<MD5>(key).update(message).hexDigest(), "750c783e6ab0b503eaa86e310a5db738");
+  ASSERT_EQ(SHA1::hmac(key, message), "effcdf6ae5eb2fa2d27416d5f184df9c259a7c79");
+  ASSERT_EQ(SHA256::hmac(key, message), "5bdcc146bf60754e6a042426089575c75a003f089d2739839dec58b964ec3843");
+  ASSERT_EQ(SHA512::hmac(key, message),
+            "164b7a7bfcf819e2e395fbe73b56e0a387bd64222e831fd610270cd7ea2505549758bf75c05a994a6d034f65f8f0e6fdcaeab1a34d4a6b4b636e070a38bce737");
+
+  // 密钥超过块大小时先哈希
+  ASSERT_EQ(hexEncode(Hmac<SHA256>(std::string(200, 'k')).mac(std::string(300, 'x'))),
+            "6b79abd28b0d3674fd5a4b93e668d5f50317163cc001771c4690207c687e8268");
+}
+
+TEST(HmacTest, StreamingAndReuse)
+{
+  Hmac<SHA256> keyed("secret");
+  const auto expected = keyed.mac("GET /orders?id=42");
+
+  // 流式追加与一次性结果相同，digest 之后自动回到密钥状态
+  for (int round = 0; round < 3; ++round)
+  {
+    keyed.update("GET ").update(std::string_view("/orders")).update("?id=42");
+    ASSERT_TRUE(keyed.digest() == expected);
+  }
+
+  // 拷贝保留预计算状态，互不影响
+  Hmac<SHA256> copy = keyed;
+  copy.update("partial");
+  copy.reset();
+  copy.update("GET /orders?id=42");
+  ASSERT_TRUE(copy.digest() == expected);
+  ASSERT_TRUE(SHA256::hmacBinary("secret", "GET /orders?id=42") == expected);
+
+  const uint8_t bytes[] = {0x00, 0x0f, 0xa5, 0xff};
+  ASSERT_EQ(hexEncode(bytes), "000fa5ff");
+  ASSERT_EQ(hexEncode(MD5::hashBinary("hello world")), MD5::hash("hello world"));
+}
+
+static std::vector<uint8_t> fromHex(const std::string& hex)
+{
+  std::vector<uint8_t> out;
+  for (size_t i = 0; i + 1 < hex.size(); i += 2)
+    out.push_back(static_cast<uint8_t>(std::stoi(hex.substr(i, 2), nullptr, 16)));
+  return out;
+}
+
+// 分别用 AES-NI 与 T 表实现运行 fn
+template <typename Fn>
+static void forEachAesBackend(Fn&& fn)
+{
+  const bool saved = Aes::hardwareAccelerated();
+  for (const bool hardware : {false, true})
+  {
+    if (!Aes::setHardwareAccelerated(hardware))
+      continue;
+    fn();
+  }
+  Aes::setHardwareAccelerated(saved);
+}
+
+TEST(AesTest, BlockVectors)
+{
+  forEachAesBackend([]
+  {
+    const auto plain = fromHex("00112233445566778899aabbccddeeff");
+    const std::pair<const char*, const char*> cases[] = {
+        {"000102030405060708090a0b0c0d0e0f", "69c4e0d86a7b0430d8cdb78070b4c55a"},
+        {"000102030405060708090a0b0c0d0e0f1011121314151617", "dda97ca4864cdfe06eaf70a0ec0d7191"},
+        {"000102030405060708090a0b0c0d0e0f101112131415161718191a1b1c1d1e1f", "8ea2b7ca516745bfeafc49904b496089"},
+    };
+    for (const auto& [key, cipher] : cases)
+    {
+      const Aes aes(fromHex(key));
+      std::vector<uint8_t> out(16);
+      aes.encryptBlock(plain.data(), out.data());
+      ASSERT_EQ(toHex(out), cipher);
+    }
+  });
+}
+
+TEST(AesTest, CtrStreaming)
+{
+  forEachAesBackend([]
+  {
+    const auto key = fromHex("2b7e151628aed2a6abf7158809cf4f3c");
+    const auto iv = fromHex("f0f1f2f3f4f5f6f7f8f9fafbfcfdfeff");
+    const auto plain = fromHex("6bc1bee22e409f96e93d7e117393172aae2d8a571e03ac9c9eb76fac45af8e51"
+        "30c81c46a35ce411e5fbc1191a0a52eff69f2445df4f9b17ad2b417be66c3710");
+    const std::string expected = "874d6191b620e3261bef6864990db6ce9806f66b7970fdff8617187bb9fffdff"
+        "5ae4df3edbd5d35e5b4f09020db03eab1e031dda2fbe03d1792170a0f3009cee";
+
+    for (const size_t chunk : {size_t{1}, size_t{5}, size_t{16}, size_t{64}})
+    {
+      auto data = plain;
+      AesCtr ctr(key, std::span<const uint8_t, 16>(iv.data(), 16));
+      for (size_t i = 0; i < data.size(); i += chunk)
+        ctr.update(std::span(data).subspan(i, std::min(chunk, data.size() - i)));
+      ASSERT_EQ(toHex(data), expected);
+    }
+
+    // 计数器跨过低 32 位时向高位进位
+    const auto key256 = fromHex("000102030405060708090a0b0c0d0e0f101112131415161718191a1b1c1d1e1f");
+    const auto iv2 = fromHex("00000000000000000000000ffffffffa");
+    std::string zeros(1000, '\0');
+    AesCtr ctr(key256, std::span<const uint8_t, 16>(iv2.data(), 16));
+    ctr.update(std::span(reinterpret_cast<uint8_t*>(zeros.data()), zeros.size()));
+    ASSERT_EQ(SHA256::sha(zeros), "ce5a60aace78e08cf508f8f778e1ef5c5185717db2151f3e918a86a86c90cde4");
+  });
+}
+
+TEST(AesTest, GcmVectors)
+{
+  forEachAesBackend([]
+  {
+    const auto key = fromHex("feffe9928665731c6d6a8f9467308308");
+    const auto aad = fromHex("feedfacedeadbeeffeedfacedeadbeefabaddad2");
+    const auto plain = fromHex("d9313225f88406e5a55909c5aff5269a86a7a9531534f7da2e4c303d8a318a72"
+        "1c3c0c95956809532fcf0e2449a6b525b16aedf5aa0de657ba637b39");
+    AesGcm gcm(key);
+
+    // 12 字节 IV
+    auto data = plain;
+    const auto iv = fromHex("cafebabefacedbaddecaf888");
+    const auto tag = gcm.seal(iv, aad, data);
+    ASSERT_EQ(toHex(data), "42831ec2217774244b7221b784d0d49ce3aa212f2c02a4e035c17e2329aca12e"
+              "21d514b25466931c7d8f6a5aac84aa051ba30b396a0aac973d58e091");
+    ASSERT_EQ(toHex(std::vector<uint8_t>(tag.begin(), tag.end())), "5bc94fbc3221a5db94fae95ae7121a47");
+
+    ASSERT_TRUE(gcm.open(iv, aad, data, tag));
+    ASSERT_TRUE(data == plain);
+
+    // 60 字节 IV
+    data = plain;
+    const auto longIv = fromHex("9313225df88406e555909c5aff5269aa6a7a9538534f7da1e4c303d2a318a728"
+        "c3c0c95156809539fcf0e2429a6b525416aedbf5a0de6a57a637b39b");
+    const auto tag2 = gcm.seal(longIv, aad, data);
+    ASSERT_EQ(toHex(data), "8ce24998625615b603a033aca13fb894be9112a5c3a211a8ba262a3cca7e2ca7"
+              "01e4a9a4fba43c90ccdcb281d48c7c6fd62875d2aca417034c34aee5");
+    ASSERT_EQ(toHex(std::vector<uint8_t>(tag2.begin(), tag2.end())), "619cc5aefffe0bfa462af43c1699d050");
+  });
+}
+
+TEST(AesTest, GcmStreamingAndTamper)
+{
+  std::vector<uint8_t> plain(1000);
+  for (size_t i = 0; i < plain.size(); ++i)
+    plain[i] = static_cast<uint8_t>(i * 7 + 3);
+  const std::vector<uint8_t> key(32, 0x42);
+  const std::vector<uint8_t> iv(12, 0x24);
+  const std::vector<uint8_t> aad(37, 0x11);
+
+  std::string reference;
+  forEachAesBackend([&]
+  {
+    AesGcm gcm(key);
+    auto oneShot = plain;
+    const auto tag = gcm.seal(iv, aad, oneShot);
+    const std::string result = toHex(oneShot) + toHex(std::vector<uint8_t>(tag.begin(), tag.end()));
+    if (reference.empty())
+      reference = result;
+    ASSERT_EQ(result, reference);
+
+    // 任意切分的流式调用与一次性结果相同
+    for (const size_t chunk : {size_t{1}, size_t{15}, size_t{16}, size_t{129}})
+    {
+      auto data = plain;
+      gcm.start(iv);
+      gcm.aad(std::span(aad).first(10));
+      gcm.aad(std::span(aad).subspan(10));
+      for (size_t i = 0; i < data.size(); i += chunk)
+        gcm.encrypt(std::span(data).subspan(i, std::min(chunk, data.size() - i)));
+      ASSERT_TRUE(data == oneShot);
+      ASSERT_TRUE(gcm.finish() == tag);
+    }
+
+    auto tampered = oneShot;
+    tampered[500] ^= 1;
+    ASSERT_TRUE(!gcm.open(iv, aad, tampered, tag));
+    auto data = oneShot;
+    ASSERT_TRUE(gcm.open(iv, aad, data, tag));
+    ASSERT_TRUE(data == plain);
+  });
+}
+
+// 分别用各个 Base64 实现运行 fn
+template <typename Fn>
+static void forEachBase64Backend(Fn&& fn)
+{
+  const auto saved = Base64::backend();
+  for (const auto backend : {Base64::Backend::Scalar, Base64::Backend::Ssse3, Base64::Backend::Avx2})
+  {
+    if (!Base64::setBackend(backend))
+      continue;
+    fn();
+  }
+  Base64::setBackend(saved);
+}
+
+static std::string toString(const std::vector<uint8_t>& bytes)
+{
+  return {bytes.begin(), bytes.end()};
+}
+
+TEST(Base64Test, Rfc4648Vectors)
+{
+  forEachBase64Backend([]
+  {
+    const std::pair<std::string, std::string> vectors[] = {
+        {"", ""}, {"f", "Zg=="}, {"fo", "Zm8="}, {"foo", "Zm9v"},
+        {"foob", "Zm9vYg=="}, {"fooba", "Zm9vYmE="}, {"foobar", "Zm9vYmFy"},
+    };
+    for (const auto& [plain, encoded] : vectors)
+    {
+      ASSERT_EQ(Base64::encode(plain), encoded);
+      ASSERT_EQ(toString(Base64::decode(encoded)), plain);
+      const std::string unpadded = encoded.substr(0, encoded.find('='));
+      ASSERT_EQ(Base64::encode(plain, Base64::kUrlNoPadding), unpadded);
+      ASSERT_EQ(toString(Base64::decode(unpadded, Base64::kUrlNoPadding)), plain);
+    }
+
+    // 62/63 号字符在两种字母表中不同
+    const std::vector<uint8_t> high = {0xfb, 0xff, 0xbf};
+    ASSERT_EQ(Base64::encode(high), std::string("+/+/"));
+    ASSERT_EQ(Base64::encode(high, Base64::kUrl), std::string("-_-_"));
+    ASSERT_TRUE(Base64::decode("-_-_", Base64::kUrl) == high);
+    ASSERT_EQ(Base64::encode("hello world, this is a longer base64 input!!"),
+              std::string("aGVsbG8gd29ybGQsIHRoaXMgaXMgYSBsb25nZXIgYmFzZTY0IGlucHV0ISE="));
+  });
+}
+
+TEST(Base64Test, BackendsAgree)
+{
+  std::vector<uint8_t> data(1000);
+  for (auto& b : data)
+    b = static_cast<uint8_t>(cppkit::Random::nextInt(1000) % 256);
+
+  for (const auto& options : {Base64::kStandard, Base64::kUrlNoPadding})
+  {
+    for (size_t size = 0; size < 200; ++size)
+    {
+      const auto input = std::span<const uint8_t>(data).first(size);
+      Base64::setBackend(Base64::Backend::Scalar);
+      const std::string expected = Base64::encode(input, options);
+      forEachBase64Backend([&]
+      {
+        // 输出缓冲区恰好等于所需长度，末尾放哨兵检查越界写
+        std::vector<char> out(Base64::encodedLength(size, options.padding) + 1, '#');
+        const size_t written = Base64::encode(input, std::span(out).first(out.size() - 1), options);
+        ASSERT_EQ(std::string(out.data(), written), expected);
+        ASSERT_EQ(out.back(), '#');
+
+        std::vector<uint8_t> decoded(size + 1, 0xAA);
+        const auto n = Base64::tryDecode(expected, std::span(decoded).first(size), options);
+        ASSERT_TRUE(n.has_value());
+        ASSERT_EQ(*n, size);
+        ASSERT_TRUE(std::equal(input.begin(), input.end(), decoded.begin()));
+        ASSERT_EQ(decoded.back(), 0xAA);
+      });
+    }
+  }
+}
+
+TEST(Base64Test, WhitespaceAndErrors)
+{
+  std::string data(300, '\0');
+  for (size_t i = 0; i < data.size(); ++i)
+    data[i] = static_cast<char>(i * 7);
+  const std::string encoded = Base64::encode(data);
+
+  // 每 76 个字符折行
+  std::string mime;
+  for (size_t i = 0; i < encoded.size(); i += 76)
+    mime += encoded.substr(i, 76) + "\r\n";
+
+  forEachBase64Backend([&]
+  {
+    ASSERT_EQ(toString(Base64::decode(mime, Base64::kMime)), data);
+    ASSERT_EQ(toString(Base64::decode(" Zm9v\tYmE=\n", Base64::kMime)), std::string("fooba"));
+    ASSERT_TRUE(!Base64::tryDecode(mime, {}, Base64::kStandard).has_value());
+
+    uint8_t out[64];
+    for (const char* bad : {"Zm9vY", "Zm9vYg", "Zm9v*mFy", "Zg=a", "Z===", "=Zg=", "Zg==Zg==", "Zm9vYmFy-_"})
+      ASSERT_TRUE(!Base64::tryDecode(bad, out).has_value());
+    // 无填充模式下填充可省略，但给出时必须正确
+    ASSERT_EQ(Base64::tryDecode("Zg", out, Base64::kUrlNoPadding).value_or(0), 1u);
+    ASSERT_EQ(Base64::tryDecode("Zg==", out, Base64::kUrlNoPadding).value_or(0), 1u);
+    ASSERT_TRUE(!Base64::tryDecode("Zg=", out, Base64::kUrlNoPadding).has_value());
+
+    // 输出缓冲区不足
+    ASSERT_TRUE(!Base64::tryDecode("Zm9vYmFy", std::span(out, 5)).has_value());
+    bool threw = false;
+    try
+    {
+      Base64::decode("Zm9v!", std::span(out));
+    }
+    catch (const std::runtime_error&)
+    {
+      threw = true;
+    }
+    ASSERT_TRUE(threw);
+  });
+}
+
+int main()
+{
+  return RunAllTests();
+}
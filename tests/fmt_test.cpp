@@ -1,29 +1,118 @@
 #include "cppkit/fmt.hpp"
 #include "cppkit/strings.hpp"
+#include "cppkit/testing/test.hpp"
+#include <limits>
+#include <vector>
 
-int main()
+using namespace cppkit::testing;
+
+struct Point
+{
+  int x;
+  int y;
+};
+
+// 只提供 operator<< 的类型走通用路径
+struct Streamable
+{
+  int id;
+};
+
+std::ostream& operator<<(std::ostream& os, const Streamable& s)
+{
+  return os << "S#" << s.id;
+}
+
+template <>
+struct cppkit::Formatter<Point>
+{
+  template <typename Buffer>
+  static void write(Buffer& out, const Point& p)
+  {
+    out.push_back('(');
+    Formatter<int>::write(out, p.x);
+    out.append(", ");
+    Formatter<int>::write(out, p.y);
+    out.push_back(')');
+  }
+};
+
+TEST(FmtTest, Print)
+{
+  // 无占位符
+  cppkit::print("hello bob");
+
+  // 占位符
+  cppkit::print("hello {}", "bob");
+
+  // 多个占位符
+  cppkit::print("hello {} {}", 2025, "bob");
+
+  // 转义
+  cppkit::print("转义效果{{}");
+
+  const auto str = cppkit::sprintf("hello {}", "bob");
+  ASSERT_EQ(str, std::string("hello bob"));
+  ASSERT_EQ(cppkit::replaceAll(str, "l", "L"), std::string("heLLo bob"));
+  ASSERT_EQ(cppkit::replace(str, "l", "L", 1), std::string("heLlo bob"));
+
+  const auto escaped = cppkit::escapeHtml("<html></html>");
+  ASSERT_EQ(cppkit::unescapeHtml(escaped), std::string("<html></html>"));
+}
+
+TEST(FmtTest, CommonTypes)
 {
-    // 无占位符
-    cppkit::print("hello bob");
+  const std::string name = "cppkit";
+  const std::string_view view = "view";
+  const char* cstr = "cstr";
+  ASSERT_EQ(cppkit::sprintf("{}|{}|{}|{}|{}", name, view, cstr, 'c', true),
+            std::string("cppkit|view|cstr|c|true"));
+  ASSERT_EQ(cppkit::sprintf("{} {} {}", std::numeric_limits<int64_t>::min(), std::numeric_limits<uint64_t>::max(), -0),
+            std::string("-9223372036854775808 18446744073709551615 0"));
+  ASSERT_EQ(cppkit::sprintf("{} {} {} {}", 0.1, 1.5f, 1e300, -2.0), std::string("0.1 1.5 1e+300 -2"));
+  ASSERT_EQ(cppkit::sprintf("{}", static_cast<const void*>(nullptr)), std::string("0x0"));
+  ASSERT_EQ(cppkit::sprintf("{} and {}", Point{1, -2}, Streamable{7}), std::string("(1, -2) and S#7"));
+}
 
-    // 占位符
-    cppkit::print("hello {}", "bob");
+TEST(FmtTest, Escapes)
+{
+  ASSERT_EQ(cppkit::sprintf("{{}}"), std::string("{}"));
+  ASSERT_EQ(cppkit::sprintf("{{{}}}", 1), std::string("{1}"));
+  ASSERT_EQ(cppkit::sprintf("a{b}c{}", 2), std::string("a{b}c2"));
+  ASSERT_EQ(cppkit::sprintf("{}{}", 1, 2), std::string("12"));
+  ASSERT_EQ(cppkit::sprintf(""), std::string(""));
 
-    // 多个占位符
-    cppkit::print("hello {} {}", 2025, "bob");
+  // 运行期格式串的结果与编译期一致
+  ASSERT_EQ(cppkit::format("{{{}}} a{b}c{}", 1, 2), std::string("{1} a{b}c2"));
+  ASSERT_EQ(cppkit::format("{} {} {}", 1.25, false, "x"), std::string("1.25 false x"));
+}
 
-    // 转义
-    cppkit::print("转义效果{{}");
+TEST(FmtTest, FormatTo)
+{
+  std::string out = "addr=";
+  cppkit::formatTo<"{}:{}">(std::back_inserter(out), "localhost", 8080);
+  ASSERT_EQ(out, std::string("addr=localhost:8080"));
 
-    const auto str = cppkit::sprintf("hello {}", "bob");
-    std::cout << str << std::endl;
+  cppkit::formatTo<" [{}]">(out, 42);
+  ASSERT_EQ(out, std::string("addr=localhost:8080 [42]"));
 
-    std::cout << cppkit::replaceAll(str, "l", "L") << std::endl;
+  char small[8];
+  const auto result = cppkit::formatToN<"{}-{}">(small, sizeof(small), "abcdef", 12345);
+  ASSERT_EQ(result.size, static_cast<size_t>(12));
+  ASSERT_EQ(result.out - small, 8);
+  ASSERT_EQ(std::string(small, 8), std::string("abcdef-1"));
 
-    std::cout << cppkit::replace(str, "l", "L", 1) << std::endl;
+  // 超过内部容量后转到堆上，内容保持完整
+  cppkit::FixedBuffer<16> buffer;
+  cppkit::formatTo<"{}">(buffer, "0123456789");
+  ASSERT_TRUE(buffer.isInline());
+  const std::string longText(1000, 'x');
+  cppkit::formatTo<"|{}|{}">(buffer, longText, 3.5);
+  ASSERT_TRUE(!buffer.isInline());
+  ASSERT_EQ(buffer.str(), "0123456789|" + longText + "|3.5");
+}
 
-    const auto escaped = cppkit::escapeHtml("<html></html>");
-    std::cout << escaped << std::endl;
-    std::cout << cppkit::unescapeHtml(escaped) << std::endl;
-    return 0;
+int main()
+{
+  return RunAllTests();
 }
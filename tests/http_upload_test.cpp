@@ -0,0 +1,252 @@
+#include "cppkit/http/server/http_server.hpp"
+#include "cppkit/http/server/multipart.hpp"
+#include "cppkit/testing/test.hpp"
+#include <arpa/inet.h>
+#include <atomic>
+#include <random>
+#include <thread>
+#include <unistd.h>
+
+using cppkit::http::HttpMethod;
+using namespace cppkit::http::server;
+using namespace cppkit::testing;
+
+constexpr uint16_t PORT = 18761;
+
+// 三个部分：普通字段、带二进制内容的文件（内容里有形似分隔符的片段）、空文件
+static std::string multipartBody(const std::string& boundary, const std::string& file)
+{
+  return "preamble\r\n--" + boundary + "\r\n"
+      "Content-Disposition: form-data; name=\"title\"\r\n\r\n"
+      "hello\r\n--" + boundary + "  \r\n"
+      "Content-Disposition: form-data; name=\"file\"; filename=\"a.bin\"\r\n"
+      "Content-Type: application/octet-stream\r\n\r\n" + file + "\r\n--" + boundary + "\r\n"
+      "Content-Disposition: form-data; name=\"empty\"; filename=\"\"\r\n\r\n"
+      "\r\n--" + boundary + "--\r\nepilogue";
+}
+
+static std::string sampleFile(const std::string& boundary, const size_t size)
+{
+  std::string file;
+  std::mt19937 gen(3);
+  while (file.size() < size)
+  {
+    file.push_back(static_cast<char>(gen()));
+    // 分隔符的不完整前缀，后面跟一个不会出现在 boundary 里的字节
+    if (gen() % 1000 == 0)
+      file += "\r\n--" + boundary.substr(0, gen() % boundary.size()) + '\x01';
+  }
+  return file;
+}
+
+// 把 body 按 splits 切开依次喂入，返回 "名称:文件名:内容" 的列表
+static std::vector<std::string> parseAll(const std::string& boundary, const std::string& body,
+                                         const std::vector<size_t>& splits, bool& done)
+{
+  std::vector<std::string> parts;
+  MultipartParser parser(boundary);
+  parser.setOnPartBegin([&](const MultipartPart& part) { parts.push_back(part.name + ":" + part.filename + ":"); });
+  parser.setOnPartData([&](const MultipartPart&, const std::span<const uint8_t> data)
+  {
+    parts.back().append(data.begin(), data.end());
+  });
+  size_t begin = 0;
+  for (const size_t end : splits)
+  {
+    if (!parser.feed(std::string_view(body).substr(begin, end - begin)))
+      return {};
+    begin = end;
+  }
+  done = parser.feed(std::string_view(body).substr(begin)) && parser.done();
+  return parts;
+}
+
+TEST(MultipartTest, AnySplitGivesSameParts)
+{
+  const std::string boundary = "----cppkitBoundary7MA4YWxk";
+  const std::string file = sampleFile(boundary, 5000);
+  const std::string body = multipartBody(boundary, file);
+  const std::vector<std::string> expected = {"title::hello", "file:a.bin:" + file, "empty::"};
+
+  bool done = false;
+  ASSERT_TRUE(parseAll(boundary, body, {}, done) == expected);
+  ASSERT_TRUE(done);
+
+  // 逐字节喂入
+  std::vector<size_t> every(body.size());
+  for (size_t i = 0; i < body.size(); ++i)
+    every[i] = i;
+  done = false;
+  ASSERT_TRUE(parseAll(boundary, body, every, done) == expected);
+  ASSERT_TRUE(done);
+
+  // 随机切分
+  std::mt19937 gen(11);
+  for (int round = 0; round < 50; ++round)
+  {
+    std::vector<size_t> splits;
+    for (size_t pos = gen() % 64; pos < body.size(); pos += 1 + gen() % 200)
+      splits.push_back(pos);
+    done = false;
+    ASSERT_TRUE(parseAll(boundary, body, splits, done) == expected);
+    ASSERT_TRUE(done);
+  }
+
+  ASSERT_EQ(MultipartParser::boundaryFrom("multipart/form-data; boundary=abc"), std::string("abc"));
+  ASSERT_EQ(MultipartParser::boundaryFrom("Multipart/Form-Data; boundary=\"a b\"; x=1"), std::string("a b"));
+  ASSERT_EQ(MultipartParser::boundaryFrom("text/plain; boundary=abc"), std::string(""));
+
+  MultipartParser broken("b");
+  ASSERT_TRUE(!broken.feed(std::string_view("--b\r\nno colon here\r\n\r\n")));
+  ASSERT_TRUE(!broken.feed(std::string_view("more")));
+}
+
+static int dial()
+{
+  sockaddr_in addr{};
+  addr.sin_family = AF_INET;
+  addr.sin_port = htons(PORT);
+  inet_pton(AF_INET, "127.0.0.1", &addr.sin_addr);
+  for (int i = 0; i < 200; ++i)
+  {
+    const int fd = ::socket(AF_INET, SOCK_STREAM, 0);
+    if (::connect(fd, reinterpret_cast<sockaddr*>(&addr), sizeof(addr)) == 0)
+    {
+      const timeval tv{5, 0};
+      setsockopt(fd, SOL_SOCKET, SO_RCVTIMEO, &tv, sizeof(tv));
+      return fd;
+    }
+    ::close(fd);
+    usleep(10 * 1000);
+  }
+  return -1;
+}
+
+// 分几次写出请求，读到对端关闭为止，返回响应体
+static std::string post(const std::string& path, const std::string& body, const std::string& contentType = "")
+{
+  const int fd = dial();
+  std::string request = "POST " + path + " HTTP/1.1\r\nHost: 127.0.0.1\r\nConnection: close\r\n";
+  if (!contentType.empty())
+    request += "Content-Type: " + contentType + "\r\n";
+  request += "Content-Length: " + std::to_string(body.size()) + "\r\n\r\n";
+  // 请求头和 body 开头一起发出，剩下的分块发出
+  const size_t first = std::min<size_t>(body.size(), 100);
+  request.append(body, 0, first);
+  bool ok = ::write(fd, request.data(), request.size()) == static_cast<ssize_t>(request.size());
+  for (size_t offset = first; ok && offset < body.size();)
+  {
+    const ssize_t n = ::write(fd, body.data() + offset, std::min<size_t>(body.size() - offset, 300000));
+    ok = n > 0;
+    offset += ok ? n : 0;
+  }
+  std::string response;
+  char buf[4096];
+  ssize_t n;
+  while ((n = ::read(fd, buf, sizeof(buf))) > 0)
+    response.append(buf, n);
+  ::close(fd);
+  const size_t end = response.find("\r\n\r\n");
+  return end == std::string::npos ? "" : response.substr(end + 4);
+}
+
+TEST(HttpUploadTest, MemoryTempFileAndStream)
+{
+  std::atomic<bool> stopped = false;
+  HttpServer http("127.0.0.1", PORT);
+  http.Post("/echo", [](const HttpRequest& req, HttpResponseWriter& writer)
+  {
+    const auto& body = req.readBody();
+    writer.write(std::to_string(body.size()) + ":" + std::string(body.begin(), body.begin() + 5));
+  });
+  http.Post("/big", [](const HttpRequest& req, HttpResponseWriter& writer)
+  {
+    writer.write(req.hasBodyInTempFile() ? std::to_string(std::filesystem::file_size(req.getTempFilePath())) : "memory");
+  });
+  http.Stream(HttpMethod::Post, "/upload", [](const HttpRequest& req)
+  {
+    auto parser = std::make_shared<MultipartParser>(MultipartParser::boundaryFrom(req.getHeader("Content-Type")));
+    auto sizes = std::make_shared<std::map<std::string, size_t>>();
+    parser->setOnPartBegin([sizes](const MultipartPart& part) { (*sizes)[part.name] = 0; });
+    parser->setOnPartData([sizes](const MultipartPart& part, const std::span<const uint8_t> data)
+    {
+      (*sizes)[part.name] += data.size();
+    });
+    return BodyStream{
+      [parser](const std::span<const uint8_t> data) { return parser->feed(data); },
+      [parser, sizes](const HttpRequest&, HttpResponseWriter& writer)
+      {
+        std::string out = parser->done() ? "done" : "partial";
+        for (const auto& [name, size] : *sizes)
+          out += " " + name + "=" + std::to_string(size);
+        writer.write(out);
+      }};
+  });
+  // 流式路由同样经过中间件，未通过鉴权的上传在接收 body 之前就被拒绝
+  std::atomic<int> checked = 0;
+  std::atomic<int> rejectedStreams = 0;
+  http.addMiddleware("/upload", [&checked](HttpRequest& req, HttpResponseWriter& writer, const NextFunc& next)
+  {
+    ++checked;
+    if (req.getQuery("token") != "secret")
+    {
+      writer.setStatusCode(401);
+      writer.write("unauthorized");
+      return;
+    }
+    next();
+  });
+  http.Stream(HttpMethod::Post, "/upload/denied", [&rejectedStreams](const HttpRequest&)
+  {
+    ++rejectedStreams;
+    return BodyStream{};
+  });
+  http.Stream(HttpMethod::Post, "/stop", [&http](const HttpRequest&)
+  {
+    return BodyStream{nullptr, [&http](const HttpRequest&, HttpResponseWriter& writer)
+    {
+      writer.write("bye");
+      http.stop();
+    }};
+  });
+  std::thread server([&]
+  {
+    http.start();
+    stopped = true;
+  });
+
+  // 小 body 读进内存，一次分配后直接读到位
+  std::string small(1 << 20, 'x');
+  small.replace(0, 5, "abcde");
+  ASSERT_EQ(post("/echo", small), std::string("1048576:abcde"));
+
+  // 超过阈值的 body 写入临时文件
+  const std::string big(HttpContext::BODY_MEMORY_THRESHOLD + 12345, 'y');
+  ASSERT_EQ(post("/big", big), std::to_string(big.size()));
+
+  // 流式 multipart：比内存阈值大的文件也不会被整体缓存
+  const std::string boundary = "cppkitStreamBoundary";
+  const std::string file = sampleFile(boundary, HttpContext::BODY_MEMORY_THRESHOLD + 100);
+  ASSERT_EQ(post("/upload?token=secret", multipartBody(boundary, file), "multipart/form-data; boundary=" + boundary),
+            "done empty=0 file=" + std::to_string(file.size()) + " title=5");
+
+  // 格式错误时断开连接
+  ASSERT_EQ(post("/upload?token=secret", "--x\r\nbad header\r\n\r\n", "multipart/form-data; boundary=x"),
+            std::string(""));
+  ASSERT_EQ(checked.load(), 2);
+
+  // 中间件拒绝：返回中间件的响应，不创建 BodyStream
+  ASSERT_EQ(post("/upload", "--x\r\n", "multipart/form-data; boundary=x"), std::string("unauthorized"));
+  ASSERT_EQ(post("/upload/denied", ""), std::string("unauthorized"));
+  ASSERT_EQ(checked.load(), 4);
+  ASSERT_EQ(rejectedStreams.load(), 0);
+
+  ASSERT_EQ(post("/stop", "ignored body"), std::string("bye"));
+  server.join();
+  ASSERT_TRUE(stopped);
+}
+
+int main()
+{
+  return RunAllTests();
+}
@@ -1,9 +1,15 @@
 #include "cppkit/json/json.hpp"
+#include "cppkit/testing/test.hpp"
 #include <iostream>
 
 #include "cppkit/json/json_parser.hpp"
+#include "cppkit/json/json_lazy.hpp"
+#include "cppkit/json/ndjson.hpp"
+#include <fstream>
 
 using namespace cppkit::json;
+using namespace cppkit::testing;
+using namespace cppkit;
 
 struct Address
 {
@@ -25,6 +31,13 @@ struct User
     std::map<std::string, int> loginLog;
 };
 
+struct Counter
+{
+    uint64_t id{};
+};
+
+REFLECT(Counter, FIELD(id))
+
 // 注册 User
 REFLECT(User,
         FIELD(id),
@@ -36,6 +49,303 @@ REFLECT(User,
         FIELD(loginLog)
 )
 
+TEST(JsonWriterTest, DumpCompact)
+{
+    auto j = Json::parse(R"({"b":[1,2.5,-3e-7,true,null],"a":"x\"y\\z\n\u0001"})");
+    ASSERT_EQ(std::string(R"({"a":"x\"y\\z\n\u0001","b":[1,2.5,-3e-07,true,null]})"), j.dump());
+    ASSERT_EQ(std::string("{\n  \"a\": [],\n  \"b\": {\n    \"c\": 1\n  }\n}"),
+              Json::parse(R"({"a":[],"b":{"c":1}})").dump(true));
+}
+
+TEST(JsonWriterTest, NumbersRoundTrip)
+{
+    for (const double d : {0.1, 1.0 / 3, 1765609508.0, 1e21, -2.5e-300, 123456789012345678.0})
+    {
+        ASSERT_EQ(d, Json::parse(Json(d).dump()).asNumber());
+    }
+    ASSERT_EQ(std::string("100000"), Json(100000).dump());
+}
+
+TEST(JsonWriterTest, LongStringEscape)
+{
+    std::string s(100, 'a');
+    s[40] = '"';
+    s[77] = '\t';
+    const auto out = stringify(s);
+    ASSERT_EQ(s, Json::parse(out).asString());
+    ASSERT_EQ(std::string(40, 'a') + "\\\"", out.substr(1, 42));
+}
+
+TEST(JsonWriterTest, StringifyToReusedBuffer)
+{
+    const Address addr{"Bei\"jing", 100086};
+    OutputBuffer buffer;
+    for (int i = 0; i < 3; ++i)
+    {
+        buffer.clear();
+        stringifyTo(buffer, addr);
+        ASSERT_EQ(std::string(R"({"city":"Bei\"jing","zip":100086})"), buffer.str());
+    }
+    ASSERT_EQ(std::string(R"({"1":[0.5],"2":[]})"),
+              stringify(std::map<int, std::vector<double>>{{1, {0.5}}, {2, {}}}));
+}
+
+TEST(JsonValueTest, CompactNumbers)
+{
+    ASSERT_EQ(16, sizeof(Json));
+    const auto j = Json::parse(R"([9007199254740993,-9223372036854775808,18446744073709551615,1.5,-0.25])");
+    ASSERT_EQ(9007199254740993LL, j[0].asInt64());
+    ASSERT_TRUE(j[1].type() == Json::Type::Int);
+    ASSERT_TRUE(j[2].type() == Json::Type::Uint);
+    ASSERT_EQ(18446744073709551615ULL, j[2].asUint64());
+    ASSERT_TRUE(j[3].isDouble());
+    ASSERT_EQ(std::string("[9007199254740993,-9223372036854775808,18446744073709551615,1.5,-0.25]"), j.dump());
+}
+
+TEST(JsonValueTest, FlatObject)
+{
+    auto j = Json::parse(R"({"b":1,"a":2,"b":3,"c":{"long key for heap storage":"value that does not fit inline"}})");
+    ASSERT_EQ(3, j.size());
+    ASSERT_EQ(1, j["b"].asInt64());
+    ASSERT_EQ(std::string("a"), std::string(j.asObject().begin()->first));
+    ASSERT_EQ(std::string("value that does not fit inline"), std::string(j["c"]["long key for heap storage"].asString()));
+
+    Json big = Json::makeObject();
+    for (int i = 0; i < 100; ++i)
+        big["key" + std::to_string(i)] = i;
+    ASSERT_EQ(100, big.size());
+    ASSERT_EQ(57, big.at("key57").asInt64());
+    ASSERT_EQ(1, big.asObject().erase("key57"));
+    ASSERT_TRUE(!big.contains("key57"));
+    ASSERT_EQ(58, big.at("key58").asInt64());
+    ASSERT_TRUE(Json::parse(big.dump()) == big);
+}
+
+TEST(JsonValueTest, ArenaOwnership)
+{
+    Json sub;
+    Json copy;
+    {
+        auto doc = Json::parse(R"({"a":{"list":[1,2,3],"name":"a string longer than fourteen bytes"},"b":[]})");
+        copy = doc;
+        doc["a"]["extra"] = "another string longer than fourteen bytes";
+        doc["b"].asArray().push_back(Json("pushed into an arena-owned array"));
+        sub = std::move(doc["a"]);
+        ASSERT_TRUE(doc["a"].isObject());
+        doc = std::move(doc["b"]);
+        ASSERT_EQ(std::string("pushed into an arena-owned array"), std::string(doc[0].asString()));
+    }
+    ASSERT_EQ(3, sub["list"].size());
+    ASSERT_EQ(std::string("another string longer than fourteen bytes"), std::string(sub["extra"].asString()));
+    ASSERT_EQ(std::string("a string longer than fourteen bytes"), std::string(copy["a"]["name"].asString()));
+    ASSERT_TRUE(!copy["a"].contains("extra"));
+}
+
+template <typename E, typename Fn>
+static bool throws(Fn&& fn)
+{
+    try
+    {
+        fn();
+    }
+    catch (const E&)
+    {
+        return true;
+    }
+    return false;
+}
+
+TEST(JsonValueTest, MutableAccessors)
+{
+    auto doc = Json::parse(R"({"n":5,"f":true,"s":"short","l":"a string longer than fourteen bytes","a":[1]})");
+    doc["n"].asNumber() += 1.5;
+    doc["f"].asBool() = !doc["f"].asBool();
+    doc["s"].asString().append("er");
+    doc["l"].asString() += "!";
+    doc["a"].asArray().push_back(Json(2));
+    ASSERT_EQ(6.5, doc["n"].asNumber());
+    ASSERT_TRUE(!doc["f"].asBool());
+    ASSERT_EQ(std::string(R"({"a":[1,2],"f":false,"l":"a string longer than fourteen bytes!","n":6.5,"s":"shorter"})"),
+              doc.dump());
+
+    // 只读取可写引用不会改变节点类型
+    const double n = doc["a"][0].asNumber();
+    ASSERT_EQ(1.0, n);
+    ASSERT_TRUE(doc["a"][0].type() == Json::Type::Int);
+
+    // const 访问得到的字符串可以当作 const std::string& 使用
+    const Json& view = doc;
+    const std::string& s = view["s"].asString();
+    ASSERT_EQ(std::string("shorter"), s);
+    ASSERT_TRUE(view["l"].asString() == std::string("a string longer than fourteen bytes!"));
+
+    // 修改过的字符串可以照常拷贝、比较和移动
+    Json copy = doc;
+    ASSERT_TRUE(copy == doc);
+    Json moved = std::move(doc["l"]);
+    ASSERT_EQ(std::string("a string longer than fourteen bytes!"), std::string(moved.asString()));
+    ASSERT_TRUE(throws<std::runtime_error>([&] { (void)doc["a"].asString(); }));
+}
+
+TEST(LazyJsonTest, Pointer)
+{
+    const std::string text = R"({"a":{"b":[10,{"c":"x\"y"},-3.5]},"m~n":{"k/l":true},"skip":[[{"x":"]}"}]]})";
+    const LazyDocument doc(text);
+    ASSERT_EQ(10, doc.at_pointer("/a/b/0").asInt64());
+    ASSERT_EQ(std::string("x\"y"), doc.at_pointer("/a/b/1/c").asString());
+    ASSERT_EQ(-3.5, doc.at_pointer("/a/b/2").asNumber());
+    ASSERT_TRUE(doc.at_pointer("/m~0n/k~1l").asBool());
+    ASSERT_EQ(std::string(R"([[{"x":"]}"}]])"), std::string(doc.at_pointer("/skip").raw()));
+    ASSERT_TRUE(doc.at_pointer("").materialize() == Json::parse(text));
+    ASSERT_TRUE(throws<std::out_of_range>([&] { (void)doc.at_pointer("/a/b/3"); }));
+    ASSERT_TRUE(throws<std::out_of_range>([&] { (void)doc.at_pointer("/a/b/01"); }));
+}
+
+TEST(LazyJsonTest, BigIntegers)
+{
+    const std::string text =
+        R"({"over":9223372036854775808,"max":18446744073709551615,"huge":100000000000000000000000,"arr":[1,2]})";
+    const LazyDocument doc(text);
+    const Json eager = Json::parse(text);
+
+    // 超出 int64 的正整数按 uint64 保存
+    ASSERT_TRUE(doc.at_pointer("/over").type() == eager["over"].type());
+    ASSERT_EQ(9223372036854775808ULL, doc.at_pointer("/over").asUint64());
+    ASSERT_EQ(18446744073709551615ULL, doc.at_pointer("/max").asUint64());
+    ASSERT_TRUE(doc.at_pointer("/max").materialize() == eager["max"]);
+
+    // 超出 uint64 的整数退回 double
+    ASSERT_TRUE(doc.at_pointer("/huge").type() == Json::Type::Double);
+    ASSERT_EQ(1e23, doc.at_pointer("/huge").asNumber());
+    ASSERT_TRUE(doc.at_pointer("").materialize() == eager);
+
+    // 溢出的数组下标不存在
+    ASSERT_TRUE(throws<std::out_of_range>([&] { (void)doc.at_pointer("/arr/99999999999999999999999"); }));
+
+    ASSERT_EQ(18446744073709551615ULL, fromJsonLazy<Counter>(R"({"id":18446744073709551615})").id);
+    ASSERT_EQ(9223372036854775808ULL, fromJsonLazy<Counter>(R"({"id":9223372036854775808})").id);
+    ASSERT_EQ(18446744073709551615ULL, fromJson<Counter>(R"({"id":18446744073709551615})").id);
+
+    // 数字后面跟着非法字符时不能只取前缀，与 Json::parse 一样报错
+    for (const char* bad : {R"({"id":12abc})", R"({"id":1-2})", R"({"id":01})", R"({"id":1.})", R"({"id":-inf})"})
+    {
+        ASSERT_TRUE(throws<std::runtime_error>([&] { (void)fromJsonLazy<Counter>(bad); }));
+        ASSERT_TRUE(throws<std::runtime_error>([&] { (void)LazyDocument(bad).at_pointer("/id").materialize(); }));
+        ASSERT_TRUE(throws<std::runtime_error>([&] { (void)fromJson<Counter>(bad); }));
+    }
+}
+
+TEST(LazyJsonTest, ForwardIteration)
+{
+    const LazyDocument doc(R"( { "k1" : [ 1 , "two" , [ ] , { } ] , "k2" : null } )");
+    std::vector<std::string> keys;
+    for (const auto& field : doc.root().asObject())
+        keys.emplace_back(field.key);
+    ASSERT_EQ(2, keys.size());
+    ASSERT_EQ(std::string("k2"), keys[1]);
+
+    const auto arr = doc.root()["k1"].asArray();
+    ASSERT_EQ(4, arr.size());
+    auto it = arr.begin();
+    ASSERT_TRUE(it->type() == Json::Type::Int);
+    ++it;
+    ASSERT_EQ(std::string("two"), it->asString());
+    ASSERT_TRUE((++it)->asArray().empty());
+    ASSERT_TRUE((++it)->asObject().empty());
+    ASSERT_TRUE(++it == arr.end());
+    ASSERT_TRUE(doc.root()["k2"].isNull());
+}
+
+TEST(LazyJsonTest, ReflectionSkipsUnusedFields)
+{
+    // 未使用的字段只做括号匹配，其中的非法字面量不会被解析
+    const auto addr = fromJsonLazy<Address>(R"({"unused":{"deep":[tru,{"a":"}"}]},"zip":7,"city":"Xi'an","zip":8})");
+    ASSERT_EQ(std::string("Xi'an"), addr.city);
+    ASSERT_EQ(7, addr.zip);
+    ASSERT_TRUE(throws<std::runtime_error>([&] { (void)fromJsonLazy<Address>(R"({"unused":[1,2},"zip":7})"); }));
+
+    // 默认入口校验整个文档，字段之后的错误也会被发现
+    ASSERT_TRUE(throws<std::runtime_error>([&] { (void)fromJson<Counter>(R"({"id":12,"x":[})"); }));
+    ASSERT_TRUE(throws<std::runtime_error>([&] { (void)fromJson<Address>(R"({"unused":{"deep":[tru]},"zip":7})"); }));
+}
+
+TEST(JsonBatchTest, ReuseArena)
+{
+    JsonBatch batch;
+    for (int round = 0; round < 3; ++round)
+    {
+        batch.clear();
+        for (int i = 0; i < 100; ++i)
+            batch.parse(R"({"id":)" + std::to_string(i) + R"(,"name":"a name that lives in the arena"})");
+        ASSERT_TRUE(!throws<std::runtime_error>([&] { (void)batch.parse(R"({"ok":true})"); }));
+        ASSERT_TRUE(throws<std::runtime_error>([&] { (void)batch.parse("{\"broken\":"); }));
+        ASSERT_EQ(101, batch.size());
+        ASSERT_EQ(99, batch[99]["id"].asInt64());
+    }
+    const Json copy = batch[5];
+    batch.clear();
+    ASSERT_EQ(std::string("a name that lives in the arena"), std::string(copy["name"].asString()));
+}
+
+TEST(NdjsonTest, RoundTrip)
+{
+    const std::string path = "/tmp/cppkit_ndjson_test.ndjson";
+    {
+        NdjsonWriter writer(path, false, 256);
+        for (int i = 0; i < 5000; ++i)
+            writer.write(Address{"city-" + std::to_string(i), i});
+        writer.write(Json::parse(R"({"last":true})"));
+        writer.flush();
+        ASSERT_EQ(5001, writer.records());
+    }
+
+    concurrency::ThreadPool pool(4);
+    for (concurrency::ThreadPool* p : {static_cast<concurrency::ThreadPool*>(nullptr), &pool})
+    {
+        // 小批次强制跨批次的半行拼接
+        NdjsonReader reader(path, p, 1000);
+        int64_t expected = 0;
+        const size_t n = reader.forEach([&](const Json& doc)
+        {
+            if (doc.contains("zip"))
+            {
+                ASSERT_EQ(expected, doc["zip"].asInt64());
+                ++expected;
+            }
+        });
+        ASSERT_EQ(5001, n);
+        ASSERT_EQ(5000, expected);
+    }
+    std::remove(path.c_str());
+}
+
+TEST(NdjsonTest, ErrorReportsLine)
+{
+    const std::string path = "/tmp/cppkit_ndjson_error.ndjson";
+    {
+        NdjsonWriter writer(path);
+        writer.write(Json::parse("[1]"));
+    }
+    {
+        std::ofstream out(path, std::ios::app);
+        out << "\n  \r\n{\"a\":}\n[2]\n";
+    }
+    NdjsonReader reader(path);
+    std::string message;
+    size_t seen = 0;
+    try
+    {
+        reader.forEach([&](const Json&) { ++seen; });
+    }
+    catch (const std::runtime_error& e)
+    {
+        message = e.what();
+    }
+    ASSERT_EQ(1, seen);
+    ASSERT_TRUE(message.find("line 4") != std::string::npos);
+    std::remove(path.c_str());
+}
+
 void unmanagedJsonExample()
 {
     const auto jsonStr = R"({})";
@@ -116,5 +426,5 @@ int main(int argc, char* argv[])
     j["name"] = "hello";
     j["age"] = 30;
     std::cout << stringify(j) << std::endl;
-    return 0;
+    return RunAllTests();
 }
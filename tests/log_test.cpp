@@ -1,5 +1,6 @@
 #include "cppkit/log/log.hpp"
 #include "cppkit/time.hpp"
+#include <filesystem>
 
 void logger()
 {
@@ -7,7 +8,9 @@ void logger()
     logger.setRotationSize(1024 * 1024 * 10);
     logger.setRotation(cppkit::log::Rotation::Daily);
     logger.setMaxFiles(5);
-    logger.setFileNamePattern("{year}-{month}/access-{date}.log");
+    // 写到临时目录，不受运行时工作目录影响
+    const auto dir = std::filesystem::temp_directory_path() / "cppkit_log_test";
+    logger.setFileNamePattern((dir / "{year}-{month}/access-{date}.log").string());
 
     CK_LOG_INFO("program started...");
 
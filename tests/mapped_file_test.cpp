@@ -0,0 +1,141 @@
+#include "cppkit/io/file.hpp"
+#include "cppkit/io/mapped_file.hpp"
+#include "cppkit/testing/test.hpp"
+#include <fstream>
+#include <unistd.h>
+
+using namespace cppkit::io;
+using namespace cppkit::testing;
+
+// 在临时目录生成 size 字节的文件，第 i 个字节为 i * 31 % 251
+static std::string makeFile(const std::string& name, const size_t size)
+{
+  const std::string path = (std::filesystem::temp_directory_path() / (name + "_" + std::to_string(getpid()))).string();
+  std::string data(size, '\0');
+  for (size_t i = 0; i < size; ++i)
+    data[i] = static_cast<char>(i * 31 % 251);
+  std::ofstream(path, std::ios::binary).write(data.data(), static_cast<std::streamsize>(data.size()));
+  return path;
+}
+
+static uint8_t expected(const size_t i)
+{
+  return static_cast<uint8_t>(i * 31 % 251);
+}
+
+TEST(MappedFileTest, WholeFileAndRange)
+{
+  const std::string path = makeFile("cppkit_mapped_whole", 10000);
+  {
+    const MappedFile whole(path, MapOptions{.willNeed = true, .populate = true});
+    ASSERT_EQ(whole.size(), 10000u);
+    bool same = true;
+    for (size_t i = 0; i < whole.size(); ++i)
+      same = same && whole.bytes()[i] == expected(i);
+    ASSERT_TRUE(same);
+
+    // 非页对齐的偏移，长度超出末尾时被截断
+    MappedFile range(path, 4097, 100000);
+    ASSERT_EQ(range.offset(), 4097u);
+    ASSERT_EQ(range.size(), 10000u - 4097);
+    ASSERT_EQ(range.data()[0], expected(4097));
+    ASSERT_EQ(range.view().back(), static_cast<char>(expected(9999)));
+    range.willNeed(10, 1 << 20);
+
+    // 移动后原对象为空
+    MappedFile moved = std::move(range);
+    ASSERT_TRUE(range.empty());
+    ASSERT_EQ(moved.size(), 10000u - 4097);
+    moved.unmap();
+    ASSERT_TRUE(moved.empty());
+
+    const MappedFile beyond(path, 20000, 10);
+    ASSERT_TRUE(beyond.empty());
+  }
+  std::filesystem::remove(path);
+
+  const std::string emptyPath = makeFile("cppkit_mapped_empty", 0);
+  ASSERT_TRUE(MappedFile(emptyPath).empty());
+  std::filesystem::remove(emptyPath);
+
+  bool thrown = false;
+  try
+  {
+    const MappedFile missing("/nonexistent/cppkit_mapped");
+  }
+  catch (const std::runtime_error&)
+  {
+    thrown = true;
+  }
+  ASSERT_TRUE(thrown);
+}
+
+TEST(MappedFileTest, ChunkedReadCrossesWindows)
+{
+  // 比一个映射窗口大，且 chunk 不整除窗口：回调的分块必须与逐块读取一致
+  const size_t size = DEFAULT_MAP_WINDOW + 300000;
+  const std::string path = makeFile("cppkit_mapped_chunks", size);
+  const File file(path);
+  constexpr int chunk = 1000003;
+  const size_t offset = 12345;
+  size_t next = offset;
+  size_t calls = 0;
+  bool ok = true;
+  const size_t total = file.read([&](const char* data, const ssize_t n)
+  {
+    ok = ok && (n == chunk || next + n == size);
+    ok = ok && static_cast<uint8_t>(data[0]) == expected(next) && static_cast<uint8_t>(data[n - 1]) == expected(next + n - 1);
+    next += n;
+    ++calls;
+  }, offset, chunk);
+  ASSERT_TRUE(ok);
+  ASSERT_EQ(total, size - offset);
+  ASSERT_EQ(next, size);
+  ASSERT_EQ(calls, (size - offset + chunk - 1) / chunk);
+  ASSERT_EQ(file.read([](const char*, ssize_t) {}, size), 0u);
+
+  const MappedFile mapped = file.map();
+  ASSERT_EQ(mapped.size(), size);
+  ASSERT_EQ(mapped.bytes()[DEFAULT_MAP_WINDOW], expected(DEFAULT_MAP_WINDOW));
+  std::filesystem::remove(path);
+}
+
+TEST(MappedFileTest, PreadPwrite)
+{
+  const std::string path = makeFile("cppkit_mapped_rw", 0);
+  {
+    File file(path);
+    ASSERT_EQ(file.write("hello", 5), 5u);
+    ASSERT_EQ(file.write(" world", 6, 0, true), 6u);
+    ASSERT_EQ(file.write("W", 1, 6), 1u);
+    file.readahead(0);
+
+    char buffer[32] = {};
+    ASSERT_EQ(file.read(buffer, sizeof(buffer)), 11u);
+    ASSERT_EQ(std::string(buffer, 11), std::string("hello World"));
+    ASSERT_EQ(file.read(buffer, 3, 8), 3u);
+    ASSERT_EQ(std::string(buffer, 3), std::string("rld"));
+    ASSERT_EQ(file.read(buffer, 3, 100), 0u);
+
+    // 移动后描述符归新对象所有
+    const File moved = std::move(file);
+    ASSERT_EQ(moved.read(buffer, 5), 5u);
+    ASSERT_EQ(moved.size(), 11u);
+  }
+
+  // 只读文件仍可读取，写入失败
+  std::filesystem::permissions(path, std::filesystem::perms::owner_read);
+  if (::geteuid() != 0)
+  {
+    const File readonly(path);
+    char buffer[5];
+    ASSERT_EQ(readonly.read(buffer, 5), 5u);
+    ASSERT_EQ(readonly.write("x", 1), static_cast<size_t>(-1));
+  }
+  std::filesystem::remove(path);
+}
+
+int main()
+{
+  return RunAllTests();
+}
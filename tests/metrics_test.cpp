@@ -0,0 +1,156 @@
+#include "cppkit/metrics/metrics.hpp"
+#include "cppkit/concurrency/thread_pool.hpp"
+#include "cppkit/testing/test.hpp"
+#include <stdexcept>
+#include <thread>
+#include <vector>
+
+using namespace cppkit::testing;
+using namespace cppkit::metrics;
+
+TEST(MetricsTest, CounterAcrossThreads)
+{
+  Counter counter;
+  std::vector<std::thread> threads;
+  for (int t = 0; t < 8; ++t)
+  {
+    threads.emplace_back([&counter]
+    {
+      for (int i = 0; i < 10000; ++i)
+      {
+        counter.inc();
+      }
+    });
+  }
+  for (auto& th : threads)
+  {
+    th.join();
+  }
+  counter.inc(5);
+  ASSERT_EQ(counter.value(), static_cast<uint64_t>(80005));
+}
+
+TEST(MetricsTest, Gauge)
+{
+  Gauge gauge;
+  gauge.inc();
+  gauge.add(10);
+  gauge.dec();
+  ASSERT_EQ(gauge.value(), static_cast<int64_t>(10));
+  gauge.set(-3);
+  ASSERT_EQ(gauge.value(), static_cast<int64_t>(-3));
+}
+
+TEST(MetricsTest, HistogramBuckets)
+{
+  // 桶下标单调、连续，且每个值都落在 [上一个桶上界 + 1, 本桶上界] 内
+  for (const uint64_t v : {0ull, 1ull, 31ull, 32ull, 33ull, 1000ull, 123456789ull, 1ull << 40, ~0ull})
+  {
+    const size_t i = Histogram::bucketIndex(v);
+    ASSERT_TRUE(i < HISTOGRAM_BUCKETS);
+    ASSERT_TRUE(v <= Histogram::bucketUpper(i));
+    ASSERT_TRUE(i == 0 || v > Histogram::bucketUpper(i - 1));
+  }
+  for (size_t i = 1; i < HISTOGRAM_BUCKETS; ++i)
+  {
+    ASSERT_EQ(Histogram::bucketIndex(Histogram::bucketUpper(i - 1) + 1), i);
+  }
+}
+
+TEST(MetricsTest, HistogramPercentile)
+{
+  Histogram h;
+  ASSERT_EQ(h.percentile(0.5), static_cast<uint64_t>(0));
+  for (uint64_t v = 1; v <= 1000; ++v)
+  {
+    h.record(v * 1000);
+  }
+  ASSERT_EQ(h.count(), static_cast<uint64_t>(1000));
+  ASSERT_EQ(h.sum(), static_cast<uint64_t>(500500000));
+
+  // 相对误差不超过一个子桶
+  const auto near = [](const uint64_t actual, const uint64_t expected)
+  {
+    return actual >= expected && actual <= expected + expected / HISTOGRAM_SUB_BUCKETS;
+  };
+  ASSERT_TRUE(near(h.percentile(0.5), 500000));
+  ASSERT_TRUE(near(h.percentile(0.99), 990000));
+  ASSERT_TRUE(near(h.percentile(1.0), 1000000));
+  ASSERT_TRUE(h.percentile(0.0) >= 1000);
+}
+
+TEST(MetricsTest, RegistryReturnsSameObject)
+{
+  Registry registry;
+  auto& a = registry.counter("requests_total", "Requests");
+  auto& b = registry.counter("requests_total", "Requests");
+  auto& c = registry.counter("requests_total", "Requests", {{"method", "GET"}});
+  ASSERT_TRUE(&a == &b);
+  ASSERT_TRUE(&a != &c);
+
+  bool threw = false;
+  try
+  {
+    registry.gauge("requests_total", "Requests");
+  }
+  catch (const std::runtime_error&)
+  {
+    threw = true;
+  }
+  ASSERT_TRUE(threw);
+}
+
+TEST(MetricsTest, PrometheusExport)
+{
+  Registry registry;
+  registry.counter("requests_total", "Requests", {{"method", "GET"}}).inc(3);
+  registry.counter("requests_total", "Requests", {{"path", "a\"b\\c"}}).inc();
+  registry.gauge("connections", "Open connections").set(7);
+  auto& latency = registry.histogram("latency_seconds", "Latency", {}, {0.001, 0.01});
+  latency.record(500000);     // 0.5ms
+  latency.record(5000000);    // 5ms
+  latency.record(2000000000); // 2s
+
+  const std::string text = registry.exportPrometheus();
+  const std::string expected =
+    "# HELP connections Open connections\n"
+    "# TYPE connections gauge\n"
+    "connections 7\n"
+    "# HELP latency_seconds Latency\n"
+    "# TYPE latency_seconds histogram\n"
+    "latency_seconds_bucket{le=\"0.001\"} 1\n"
+    "latency_seconds_bucket{le=\"0.01\"} 2\n"
+    "latency_seconds_bucket{le=\"+Inf\"} 3\n"
+    "latency_seconds_sum 2.0055\n"
+    "latency_seconds_count 3\n"
+    "# HELP requests_total Requests\n"
+    "# TYPE requests_total counter\n"
+    "requests_total{method=\"GET\"} 3\n"
+    "requests_total{path=\"a\\\"b\\\\c\"} 1\n";
+  ASSERT_EQ(text, expected);
+}
+
+TEST(MetricsTest, Instrumentation)
+{
+#if defined(CPPKIT_ENABLE_METRICS)
+  auto& tasks = Registry::instance().counter("cppkit_thread_pool_tasks_total", "Tasks run by thread pools");
+  const uint64_t before = tasks.value();
+  {
+    cppkit::concurrency::ThreadPool pool(2);
+    for (int i = 0; i < 10; ++i)
+    {
+      pool.enqueue([] {});
+    }
+  }
+  ASSERT_EQ(tasks.value() - before, static_cast<uint64_t>(10));
+  ASSERT_EQ(Registry::instance().gauge("cppkit_thread_pool_queue_depth", "").value(), static_cast<int64_t>(0));
+
+  const std::string text = Registry::instance().exportPrometheus();
+  ASSERT_TRUE(text.find("# TYPE cppkit_thread_pool_tasks_total counter\n") != std::string::npos);
+#endif
+}
+
+int main()
+{
+  return RunAllTests();
+}
@@ -0,0 +1,126 @@
+#include "cppkit/msgpack/msgpack.hpp"
+#include "cppkit/testing/test.hpp"
+
+using namespace cppkit;
+using namespace cppkit::testing;
+
+struct Point
+{
+    int32_t x{};
+    int32_t y{};
+};
+
+REFLECT(Point, FIELD(x), FIELD(y))
+
+struct Shape
+{
+    std::string name;
+    bool closed{};
+    double area{};
+    float weight{};
+    uint64_t id{};
+    int64_t offset{};
+    std::vector<Point> points;
+    std::map<int, std::string> labels;
+    std::set<std::string> tags;
+    std::vector<std::byte> payload;
+};
+
+REFLECT(Shape, FIELD(name), FIELD(closed), FIELD(area), FIELD(weight), FIELD(id), FIELD(offset), FIELD(points),
+        FIELD(labels), FIELD(tags), FIELD(payload))
+
+// 只声明部分字段，并用 string_view / span 直接引用输入
+struct ShapeView
+{
+    std::string_view name;
+    std::span<const std::byte> payload;
+};
+
+REFLECT(ShapeView, FIELD(name), FIELD(payload))
+
+static Shape makeShape()
+{
+    Shape s{"triangle", true, 12.5, 0.25f, 18446744073709551615ull, -9000000000, {{0, 0}, {4, 0}, {0, -300}},
+            {{1, "one"}, {-2, "minus two"}}, {"a", "b"}, {}};
+    for (int i = 0; i < 300; ++i)
+        s.payload.push_back(static_cast<std::byte>(i));
+    return s;
+}
+
+TEST(MsgpackTest, Scalars)
+{
+    ASSERT_EQ(std::string("\x7f", 1), msgpack::encode(127));
+    ASSERT_EQ(std::string("\xcc\x80", 2), msgpack::encode(128));
+    ASSERT_EQ(std::string("\xe0", 1), msgpack::encode(-32));
+    ASSERT_EQ(std::string("\xd0\xdf", 2), msgpack::encode(-33));
+    ASSERT_EQ(std::string("\xa3" "abc", 4), msgpack::encode(std::string("abc")));
+    ASSERT_EQ(std::string("\xc3", 1), msgpack::encode(true));
+    ASSERT_EQ(-33, msgpack::decode<int>(msgpack::encode(-33)));
+    ASSERT_EQ(70000u, msgpack::decode<uint32_t>(msgpack::encode(70000)));
+    ASSERT_EQ(1.5, msgpack::decode<double>(msgpack::encode(1.5f)));
+    ASSERT_TRUE(msgpack::decode<double>(msgpack::encode(3)) == 3.0);
+}
+
+TEST(MsgpackTest, ReflectedRoundTrip)
+{
+    const Shape s = makeShape();
+    json::OutputBuffer buffer;
+    msgpack::encodeTo(buffer, s);
+    const auto decoded = msgpack::decode<Shape>(buffer.view());
+    ASSERT_EQ(json::stringify(s), json::stringify(decoded));
+    ASSERT_TRUE(decoded.payload == s.payload);
+    ASSERT_TRUE(buffer.size() < json::stringify(s).size());
+}
+
+TEST(MsgpackTest, ZeroCopyView)
+{
+    const std::string data = msgpack::encode(makeShape());
+    const auto view = msgpack::decode<ShapeView>(data);
+    ASSERT_EQ(std::string("triangle"), std::string(view.name));
+    ASSERT_TRUE(view.name.data() >= data.data() && view.name.data() < data.data() + data.size());
+    ASSERT_EQ(300u, view.payload.size());
+    ASSERT_TRUE(reinterpret_cast<const char*>(view.payload.data()) > data.data());
+}
+
+TEST(MsgpackTest, JsonConversion)
+{
+    const auto j = json::Json::parse(
+        R"({"a":[1,-2,3.5,null,true,"x"],"big":18446744073709551615,"nested":{"k":"a string longer than 31 bytes for str8"}})");
+    const std::string packed = msgpack::fromJson(j);
+    ASSERT_TRUE(msgpack::toJson(packed) == j);
+    ASSERT_EQ(j.dump(), msgpack::toJson(msgpack::encode(j)).dump());
+
+    // 反射对象 -> msgpack -> Json 与直接转 Json 一致
+    json::Json fromPacked = msgpack::toJson(msgpack::encode(Point{3, -4}));
+    ASSERT_EQ(json::Json(Point{3, -4}).dump(), fromPacked.dump());
+}
+
+TEST(MsgpackTest, Malformed)
+{
+    bool threw = false;
+    try
+    {
+        (void)msgpack::decode<Shape>(msgpack::encode(makeShape()).substr(0, 40));
+    }
+    catch (const std::runtime_error&)
+    {
+        threw = true;
+    }
+    ASSERT_TRUE(threw);
+
+    threw = false;
+    try
+    {
+        (void)msgpack::decode<int8_t>(msgpack::encode(1000));
+    }
+    catch (const std::runtime_error&)
+    {
+        threw = true;
+    }
+    ASSERT_TRUE(threw);
+}
+
+int main()
+{
+    return RunAllTests();
+}
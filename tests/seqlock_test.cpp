@@ -0,0 +1,74 @@
+#include "cppkit/concurrency/seqlock.hpp"
+#include "cppkit/testing/test.hpp"
+#include <atomic>
+#include <thread>
+#include <vector>
+
+using namespace cppkit::concurrency;
+using namespace cppkit::testing;
+
+// 写者每次把所有字段写成同一个值，读者读到的必须是某一次完整的写入
+struct Sample
+{
+  uint64_t values[37];
+  char tag; // 让大小不是 8 的整数倍
+};
+
+TEST(SeqLockTest, ReadersNeverSeeTornWrites)
+{
+  SeqLock<Sample> lock;
+  ASSERT_EQ(lock.version(), static_cast<uint64_t>(0));
+  ASSERT_EQ(lock.load().values[0], static_cast<uint64_t>(0));
+
+  constexpr uint64_t writes = 50000;
+  std::atomic<bool> done{false};
+  std::atomic<int> torn{0};
+  std::atomic<uint64_t> reads{0};
+
+  std::vector<std::thread> readers;
+  for (int i = 0; i < 3; ++i)
+  {
+    readers.emplace_back([&]
+    {
+      uint64_t last = 0;
+      while (!done.load(std::memory_order_acquire))
+      {
+        const Sample s = lock.load();
+        for (const uint64_t v : s.values)
+        {
+          if (v != s.values[0])
+            ++torn;
+        }
+        if (s.tag != static_cast<char>(s.values[0]) || s.values[0] < last)
+          ++torn;
+        last = s.values[0];
+        ++reads;
+      }
+    });
+  }
+
+  Sample s{};
+  for (uint64_t i = 1; i <= writes; ++i)
+  {
+    for (uint64_t& v : s.values)
+      v = i;
+    s.tag = static_cast<char>(i);
+    lock.store(s);
+    // 单核机器上也让读者有机会在写入之间运行
+    if (i % 1000 == 0)
+      std::this_thread::yield();
+  }
+  done = true;
+  for (auto& t : readers)
+    t.join();
+
+  ASSERT_EQ(torn.load(), 0);
+  ASSERT_TRUE(reads.load() > 0);
+  ASSERT_EQ(lock.version(), writes);
+  ASSERT_EQ(lock.load().values[36], writes);
+}
+
+int main()
+{
+  return RunAllTests();
+}
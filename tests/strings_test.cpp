@@ -0,0 +1,204 @@
+#include "cppkit/strings.hpp"
+#include "cppkit/testing/test.hpp"
+#include <cctype>
+#include <iterator>
+#include <random>
+
+using namespace cppkit;
+using namespace cppkit::testing;
+
+// 逐字节的参考实现，用来对照向量化版本
+static std::string refLower(std::string s)
+{
+  for (char& c : s)
+    if (c >= 'A' && c <= 'Z')
+      c = static_cast<char>(c + 32);
+  return s;
+}
+
+static std::string refEscape(const std::string_view s)
+{
+  std::string out;
+  for (const char c : s)
+  {
+    switch (c)
+    {
+    case '&': out += "&amp;";
+      break;
+    case '<': out += "&lt;";
+      break;
+    case '>': out += "&gt;";
+      break;
+    case '"': out += "&quot;";
+      break;
+    case '\'': out += "&#39;";
+      break;
+    default: out += c;
+    }
+  }
+  return out;
+}
+
+static std::string refUrlDecode(const std::string_view s, const bool spaceAsPlus)
+{
+  const auto hex = [](const char c)
+  {
+    return c >= '0' && c <= '9' ? c - '0' : c >= 'a' && c <= 'f' ? c - 'a' + 10 : c >= 'A' && c <= 'F' ? c - 'A' + 10 : -1;
+  };
+  std::string out;
+  for (size_t i = 0; i < s.size(); ++i)
+  {
+    if (spaceAsPlus && s[i] == '+')
+      out += ' ';
+    else if (s[i] == '%' && i + 2 < s.size() && hex(s[i + 1]) != -1 && hex(s[i + 2]) != -1)
+    {
+      out += static_cast<char>(hex(s[i + 1]) * 16 + hex(s[i + 2]));
+      i += 2;
+    }
+    else
+      out += s[i];
+  }
+  return out;
+}
+
+// 从 alphabet 中随机取字符，长度覆盖 SIMD 分组边界和尾部
+static std::string randomString(std::mt19937& gen, const size_t size, const std::string_view alphabet)
+{
+  std::string s(size, ' ');
+  for (char& c : s)
+    c = alphabet[gen() % alphabet.size()];
+  return s;
+}
+
+static std::string randomBytes(std::mt19937& gen, const size_t size)
+{
+  std::string s(size, ' ');
+  for (char& c : s)
+    c = static_cast<char>(gen());
+  return s;
+}
+
+TEST(StringsTest, SplitView)
+{
+  const std::vector<std::string_view> expected = {"", "a", "", "b", ""};
+  std::vector<std::string_view> parts;
+  for (const std::string_view part : splitView("/a//b/", '/'))
+    parts.push_back(part);
+  ASSERT_TRUE(parts == expected);
+
+  const auto view = splitView("x,y,z", ',');
+  ASSERT_EQ(std::distance(view.begin(), view.end()), 3);
+  ASSERT_EQ(*std::next(view.begin()), std::string_view("y"));
+
+  // 空串也有一段，和 split 一致
+  ASSERT_EQ(std::distance(splitView("", ',').begin(), splitView("", ',').end()), 1);
+
+  std::vector<std::string_view> buffer = {"stale"};
+  splitInto("k=v;x", ';', buffer);
+  ASSERT_TRUE(buffer == (std::vector<std::string_view>{"k=v", "x"}));
+  ASSERT_TRUE(split("a,,b", ',') == (std::vector<std::string>{"a", "", "b"}));
+}
+
+TEST(StringsTest, CaseFolding)
+{
+  std::mt19937 gen(1);
+  for (size_t size = 0; size < 300; ++size)
+  {
+    // 含有 0x80 以上的字节，以及紧挨字母范围的 '@' '[' '`' '{'
+    const std::string s = randomBytes(gen, size) + randomString(gen, size % 7, "@AZ[`az{");
+    ASSERT_EQ(toLower(s), refLower(s));
+
+    std::string upper = s;
+    toUpperInPlace(upper);
+    ASSERT_EQ(toLower(upper), refLower(s));
+
+    // 从不同偏移开始，覆盖未对齐的读取
+    const size_t skip = std::min<size_t>(size % 5, s.size());
+    std::string out = "Prefix:";
+    appendLower(out, std::string_view(s).substr(skip));
+    ASSERT_EQ(out, "Prefix:" + refLower(s.substr(skip)));
+  }
+  ASSERT_EQ(toUpper("Content-Type: x/Y 1"), std::string("CONTENT-TYPE: X/Y 1"));
+}
+
+TEST(StringsTest, CaseInsensitiveEquals)
+{
+  std::mt19937 gen(2);
+  for (size_t size = 0; size < 200; ++size)
+  {
+    const std::string a = randomString(gen, size, "abcXYZ-_09@[`{");
+    std::string b = a;
+    for (char& c : b)
+      if (gen() % 2 && std::isalpha(static_cast<unsigned char>(c)))
+        c = static_cast<char>(c ^ 0x20);
+    ASSERT_TRUE(iequals(a, b));
+
+    if (size > 0)
+    {
+      // 任意位置出现一个不同的字节都要发现
+      b[gen() % size] = '\x80';
+      ASSERT_TRUE(!iequals(a, b));
+    }
+  }
+  ASSERT_TRUE(!iequals("@", "`"));
+  ASSERT_TRUE(!iequals("[", "{"));
+  ASSERT_TRUE(!iequals("upgrade", "upgrades"));
+  ASSERT_TRUE(iequals("Keep-Alive", "keep-alive"));
+}
+
+TEST(StringsTest, FindFirstOf)
+{
+  std::mt19937 gen(3);
+  for (int round = 0; round < 2000; ++round)
+  {
+    const std::string s = randomString(gen, gen() % 150, "abcdefghijklmnopqrstuvwxyz%+&<");
+    const std::string chars = randomString(gen, 1 + gen() % 9, "%+&<>\"'z");
+    const size_t pos = gen() % (s.size() + 2);
+    ASSERT_EQ(findFirstOf(s, chars, pos), s.find_first_of(chars, pos));
+  }
+  ASSERT_EQ(findFirstOf("abc", ""), std::string_view::npos);
+}
+
+TEST(StringsTest, EscapeAndDecode)
+{
+  std::mt19937 gen(4);
+  for (size_t size = 0; size < 300; ++size)
+  {
+    const std::string html = randomString(gen, size, "abcdefghijklmnop&<>\"'");
+    ASSERT_EQ(escapeHtml(html), refEscape(html));
+
+    const std::string url = randomString(gen, size, "abcdef%+0123456789AFGZ");
+    ASSERT_EQ(urlDecode(url), refUrlDecode(url, true));
+    ASSERT_EQ(urlDecode(url, false), refUrlDecode(url, false));
+
+    std::string inPlace = url;
+    urlDecodeInPlace(inPlace);
+    ASSERT_EQ(inPlace, refUrlDecode(url, true));
+
+    std::string out = "q=";
+    appendUrlDecoded(out, url);
+    ASSERT_EQ(out, "q=" + refUrlDecode(url, true));
+  }
+  ASSERT_EQ(urlDecode("a%20b+c%2"), std::string("a b c%2"));
+  ASSERT_EQ(escapeHtml("<a href='x'>&</a>"), std::string("&lt;a href=&#39;x&#39;&gt;&amp;&lt;/a&gt;"));
+}
+
+TEST(StringsTest, TrimAndReplace)
+{
+  ASSERT_EQ(trimView(" \t value \r\n"), std::string_view("value"));
+  ASSERT_EQ(trimView(" \t "), std::string_view(""));
+  ASSERT_EQ(trim("x"), std::string("x"));
+
+  // 替换后变短或等长时原地进行，变长时另建字符串
+  ASSERT_EQ(replaceAll("a--b----c", "--", "-"), std::string("a-b--c"));
+  ASSERT_EQ(replaceAll("a--b--", "--", ""), std::string("ab"));
+  ASSERT_EQ(replaceAll("xyx", "x", "ab"), std::string("abyab"));
+  ASSERT_EQ(replace("aaaa", "a", "b", 2), std::string("bbaa"));
+  ASSERT_EQ(replace("aaaa", "a", "bc", 3), std::string("bcbcbca"));
+  ASSERT_EQ(replace("none", "x", "", 1), std::string("none"));
+}
+
+int main()
+{
+  return RunAllTests();
+}
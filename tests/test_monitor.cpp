@@ -1,4 +1,5 @@
 #include "cppkit/monitor.hpp"
+#include <atomic>
 #include <iostream>
 #include <thread>
 #include <chrono>
@@ -85,6 +86,67 @@ int main()
               << ((uptime % 3600) / 60) << " minutes "
               << (uptime % 60) << " seconds)" << std::endl;
 
+    // 测试当前进程指标
+    std::cout << "\n[Process Metrics]" << std::endl;
+    (void)monitor.GetProcessMetrics();
+    const ProcessMetrics process = monitor.GetProcessMetrics();
+    std::cout << "RSS: " << process.rss_kb << " KB" << std::endl;
+    std::cout << "Threads: " << process.thread_count << ", FDs: " << process.fd_count << std::endl;
+    std::cout << "Context switches: " << process.voluntary_ctx_switches << " voluntary, "
+              << process.involuntary_ctx_switches << " involuntary" << std::endl;
+    std::cout << "I/O: " << process.io_read_bytes << " bytes read, " << process.io_write_bytes << " bytes written"
+              << std::endl;
+#ifdef __linux__
+    if (process.rss_kb == 0 || process.thread_count == 0 || process.fd_count < 3)
+    {
+        std::cerr << "process metrics look wrong" << std::endl;
+        return 1;
+    }
+#endif
+
+    // 测试后台采样：10 Hz，同时有一个忙碌的工作线程
+    std::cout << "\n[Background Sampling]" << std::endl;
+    std::atomic<bool> stop{false};
+    std::thread busy([&stop]
+    {
+        volatile uint64_t x = 0;
+        while (!stop.load(std::memory_order_relaxed))
+        {
+            x = x + 1;
+        }
+    });
+    monitor.StartSampling(std::chrono::milliseconds(100));
+    std::this_thread::sleep_for(std::chrono::milliseconds(1050));
+    const MonitorSnapshot snapshot = monitor.GetSnapshot();
+    monitor.StopSampling();
+    stop = true;
+    busy.join();
+
+    std::cout << "Samples: " << snapshot.sequence << std::endl;
+    std::cout << "System CPU: " << snapshot.system.cpu_usage_percent << "%, Process CPU: "
+              << snapshot.process.cpu_usage_percent << "%" << std::endl;
+    for (uint32_t i = 0; i < snapshot.thread_count; ++i)
+    {
+        const ThreadMetrics& t = snapshot.threads[i];
+        std::cout << "  tid " << t.tid << " [" << t.name << "] cpu " << t.cpu_usage_percent << "%, ctx "
+                  << t.voluntary_ctx_switches << "/" << t.involuntary_ctx_switches << std::endl;
+    }
+    // 采样线程自身的开销，按每秒占一个核的比例计算
+    const double cost = 100.0 * static_cast<double>(snapshot.sampler_cpu_ns) / 1e9;
+    std::cout << "Sampler cost: " << cost << "% of a core at 10 Hz" << std::endl;
+    if (snapshot.sequence < 5 || monitor.IsSampling())
+    {
+        std::cerr << "background sampling did not run" << std::endl;
+        return 1;
+    }
+#ifdef __linux__
+    if (snapshot.thread_count < 3 || snapshot.process.cpu_usage_percent <= 0.0)
+    {
+        std::cerr << "thread metrics look wrong" << std::endl;
+        return 1;
+    }
+#endif
+
     std::cout << "\n========================================" << std::endl;
     std::cout << "Monitor Example Completed Successfully!" << std::endl;
     std::cout << "========================================" << std::endl;
@@ -0,0 +1,155 @@
+#include "cppkit/timer.hpp"
+#include "cppkit/testing/test.hpp"
+#include <algorithm>
+
+using namespace cppkit;
+using namespace cppkit::testing;
+using namespace std::chrono_literals;
+using Clock = std::chrono::steady_clock;
+
+// 等待条件成立，最多等 timeout
+template <typename Fn>
+static bool waitFor(Fn&& done, const std::chrono::milliseconds timeout = 2000ms)
+{
+  const auto deadline = Clock::now() + timeout;
+  while (!done())
+  {
+    if (Clock::now() > deadline)
+      return false;
+    std::this_thread::sleep_for(1ms);
+  }
+  return true;
+}
+
+TEST(TimerTest, TimeoutFiresInOrderAndNotEarly)
+{
+  Timer timer;
+  std::mutex mutex;
+  std::vector<int> order;
+  std::vector<std::chrono::nanoseconds> lateness;
+  const auto start = Clock::now();
+  for (const int ms : {30, 5, 20, 1, 10})
+  {
+    (void) timer.setTimeout(std::chrono::milliseconds(ms), [&, ms]
+    {
+      std::lock_guard lock(mutex);
+      order.push_back(ms);
+      lateness.push_back(Clock::now() - start - std::chrono::milliseconds(ms));
+    });
+  }
+  ASSERT_TRUE(waitFor([&] { std::lock_guard lock(mutex); return order.size() == 5; }));
+  ASSERT_TRUE(order == (std::vector<int>{1, 5, 10, 20, 30}));
+  for (const auto late : lateness)
+    ASSERT_TRUE(late >= 0ns);
+  ASSERT_EQ(timer.pending(), 0u);
+}
+
+TEST(TimerTest, CancelAndStaleIds)
+{
+  Timer timer;
+  std::atomic<int> fired = 0;
+  const TimerId a = timer.setTimeout(20ms, [&] { ++fired; });
+  const TimerId b = timer.setTimeout(1ms, [&] { ++fired; });
+  ASSERT_TRUE(a != 0 && a != b);
+  ASSERT_TRUE(timer.cancel(a));
+  ASSERT_TRUE(!timer.cancel(a));
+  ASSERT_TRUE(waitFor([&] { return fired == 1; }));
+
+  // 已触发的任务不能再取消；节点复用后旧 ID 也不会误删新任务
+  ASSERT_TRUE(!timer.cancel(b));
+  const TimerId c = timer.setTimeout(10ms, [&] { ++fired; });
+  ASSERT_TRUE(!timer.cancel(a));
+  ASSERT_TRUE(!timer.cancel(b));
+  ASSERT_TRUE(waitFor([&] { return fired == 2; }));
+  ASSERT_TRUE(!timer.cancel(c));
+  ASSERT_TRUE(!timer.cancel(0));
+  std::this_thread::sleep_for(30ms);
+  ASSERT_EQ(fired.load(), 2);
+}
+
+TEST(TimerTest, IntervalUntilCancelled)
+{
+  Timer timer;
+  std::atomic<int> fired = 0;
+  std::atomic<TimerId> id = 0;
+  id = timer.setInterval(2ms, [&]
+  {
+    // 回调里取消自己
+    if (++fired == 5)
+      (void) timer.cancel(id);
+  });
+  ASSERT_TRUE(waitFor([&] { return fired >= 5; }));
+  std::this_thread::sleep_for(20ms);
+  ASSERT_EQ(fired.load(), 5);
+  ASSERT_EQ(timer.pending(), 0u);
+}
+
+TEST(TimerTest, CascadesAcrossLevels)
+{
+  // 1us 一个 tick：200ms 约为 2e5 个 tick，需要从第 2 层逐级降到第 0 层
+  Timer timer(WheelConfig{.tickDuration = 1us, .shards = 2});
+  std::atomic<int> fired = 0;
+  const auto start = Clock::now();
+  std::atomic<int64_t> elapsedUs = 0;
+  for (const std::chrono::microseconds delay : {50us, 700us, 70000us, 200000us})
+  {
+    (void) timer.setTimeout(delay, [&, delay]
+    {
+      if (Clock::now() - start >= delay)
+        ++fired;
+      elapsedUs = std::chrono::duration_cast<std::chrono::microseconds>(Clock::now() - start).count();
+    });
+  }
+  ASSERT_TRUE(waitFor([&] { return fired == 4; }));
+  ASSERT_TRUE(elapsedUs >= 200000);
+}
+
+TEST(TimerTest, EarlierTimerWakesSleepingWorker)
+{
+  Timer timer;
+  std::atomic<bool> fired = false;
+  (void) timer.setTimeout(10s, [] {});
+  std::this_thread::sleep_for(5ms);
+  const auto start = Clock::now();
+  (void) timer.setTimeout(2ms, [&] { fired = true; });
+  ASSERT_TRUE(waitFor([&] { return fired.load(); }, 1000ms));
+  ASSERT_TRUE(Clock::now() - start < 500ms);
+  ASSERT_EQ(timer.pending(), 1u);
+}
+
+TEST(TimerTest, ExecutorAndConcurrentInsert)
+{
+  concurrency::ThreadPool pool(4);
+  Timer timer(WheelConfig{.executor = &pool});
+  std::atomic<int> fired = 0;
+  std::mutex mutex;
+  std::vector<std::thread::id> threads;
+  std::vector<std::thread> producers;
+  for (int t = 0; t < 8; ++t)
+  {
+    producers.emplace_back([&]
+    {
+      for (int i = 0; i < 500; ++i)
+      {
+        (void) timer.setTimeout(std::chrono::microseconds(i * 7 % 3000), [&]
+        {
+          std::lock_guard lock(mutex);
+          if (std::ranges::find(threads, std::this_thread::get_id()) == threads.end())
+            threads.push_back(std::this_thread::get_id());
+          ++fired;
+        });
+      }
+    });
+  }
+  for (auto& producer : producers)
+    producer.join();
+  ASSERT_TRUE(waitFor([&] { return fired == 4000; }));
+  std::lock_guard lock(mutex);
+  ASSERT_TRUE(std::ranges::find(threads, std::this_thread::get_id()) == threads.end());
+  ASSERT_TRUE(!threads.empty() && threads.size() <= 4);
+}
+
+int main()
+{
+  return RunAllTests();
+}
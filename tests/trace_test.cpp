@@ -0,0 +1,202 @@
+#include "cppkit/trace/trace.hpp"
+#include "cppkit/concurrency/coroutine.hpp"
+#include "cppkit/concurrency/thread_pool.hpp"
+#include "cppkit/json/json.hpp"
+#include "cppkit/testing/test.hpp"
+#include <cstring>
+#include <fstream>
+#include <sstream>
+
+using namespace cppkit::testing;
+using namespace cppkit;
+
+static const trace::SpanRecord* findSpan(const std::vector<trace::SpanRecord>& spans, const char* name)
+{
+  for (const auto& s : spans)
+  {
+    if (std::strcmp(s.name, name) == 0)
+    {
+      return &s;
+    }
+  }
+  return nullptr;
+}
+
+TEST(TraceTest, Traceparent)
+{
+  const auto ctx = trace::Context::fromTraceparent("00-4bf92f3577b34da6a3ce929d0e0e4736-00f067aa0ba902b7-01");
+  ASSERT_TRUE(ctx.valid());
+  ASSERT_TRUE(ctx.sampled());
+  ASSERT_EQ(ctx.traceHigh, static_cast<uint64_t>(0x4bf92f3577b34da6ULL));
+  ASSERT_EQ(ctx.traceLow, static_cast<uint64_t>(0xa3ce929d0e0e4736ULL));
+  ASSERT_EQ(ctx.spanId, static_cast<uint64_t>(0x00f067aa0ba902b7ULL));
+  ASSERT_EQ(ctx.traceparent(), std::string("00-4bf92f3577b34da6a3ce929d0e0e4736-00f067aa0ba902b7-01"));
+
+  // 更高版本允许追加字段
+  ASSERT_TRUE(trace::Context::fromTraceparent("01-4bf92f3577b34da6a3ce929d0e0e4736-00f067aa0ba902b7-00-x").valid());
+
+  // 全零 id、大写、版本 ff、长度不对都不合法
+  ASSERT_TRUE(!trace::Context::fromTraceparent("00-00000000000000000000000000000000-00f067aa0ba902b7-01").valid());
+  ASSERT_TRUE(!trace::Context::fromTraceparent("00-4bf92f3577b34da6a3ce929d0e0e4736-0000000000000000-01").valid());
+  ASSERT_TRUE(!trace::Context::fromTraceparent("00-4BF92F3577B34DA6A3CE929D0E0E4736-00f067aa0ba902b7-01").valid());
+  ASSERT_TRUE(!trace::Context::fromTraceparent("ff-4bf92f3577b34da6a3ce929d0e0e4736-00f067aa0ba902b7-01").valid());
+  ASSERT_TRUE(!trace::Context::fromTraceparent("00-4bf92f3577b34da6a3ce929d0e0e4736-00f067aa0ba902b7-01-").valid());
+  ASSERT_TRUE(!trace::Context::fromTraceparent("").valid());
+}
+
+TEST(TraceTest, DisabledRecordsNothing)
+{
+  trace::setEnabled(false);
+  trace::collect();
+  {
+    trace::Span span("disabled");
+    ASSERT_TRUE(!span.context().valid());
+    ASSERT_TRUE(!trace::current().valid());
+  }
+  trace::record("disabled.record", 1, 2);
+  ASSERT_TRUE(trace::collect().empty());
+}
+
+TEST(TraceTest, NestedSpans)
+{
+  trace::setEnabled(true);
+  const auto remote = trace::Context::fromTraceparent("00-4bf92f3577b34da6a3ce929d0e0e4736-00f067aa0ba902b7-01");
+  {
+    trace::Span outer("outer", remote);
+    ASSERT_EQ(trace::current().spanId, outer.context().spanId);
+    {
+      trace::Span inner("inner");
+      ASSERT_EQ(trace::current().spanId, inner.context().spanId);
+    }
+    ASSERT_EQ(trace::current().spanId, outer.context().spanId);
+    trace::record("recorded", 10, 30);
+  }
+  ASSERT_TRUE(!trace::current().valid());
+
+  // 父上下文未采样时只传播、不记录
+  {
+    trace::Span unsampled("unsampled",
+                          trace::Context::fromTraceparent("00-4bf92f3577b34da6a3ce929d0e0e4736-00f067aa0ba902b7-00"));
+    ASSERT_TRUE(unsampled.context().valid());
+  }
+  trace::setEnabled(false);
+
+  const auto spans = trace::collect();
+  ASSERT_EQ(spans.size(), static_cast<size_t>(3));
+  const auto* outer = findSpan(spans, "outer");
+  const auto* inner = findSpan(spans, "inner");
+  const auto* recorded = findSpan(spans, "recorded");
+  ASSERT_TRUE(outer && inner && recorded);
+  ASSERT_EQ(outer->parentSpanId, remote.spanId);
+  ASSERT_EQ(outer->context.traceLow, remote.traceLow);
+  ASSERT_EQ(inner->parentSpanId, outer->context.spanId);
+  ASSERT_EQ(inner->context.traceHigh, remote.traceHigh);
+  ASSERT_EQ(recorded->parentSpanId, outer->context.spanId);
+  ASSERT_EQ(recorded->durationNs, static_cast<uint64_t>(20));
+  ASSERT_TRUE(inner->startNs >= outer->startNs);
+  ASSERT_TRUE(inner->durationNs <= outer->durationNs);
+}
+
+TEST(TraceTest, ThreadPoolPropagation)
+{
+  trace::setEnabled(true);
+  trace::Context parent;
+  trace::Context seen;
+  {
+    concurrency::ThreadPool pool(2);
+    trace::Span root("root");
+    parent = root.context();
+    pool.enqueue([&seen]
+    {
+      trace::Span work("work");
+      seen = trace::current();
+    }).get();
+  }
+  trace::setEnabled(false);
+
+  const auto spans = trace::collect();
+  const auto* task = findSpan(spans, "thread_pool.task");
+  const auto* queue = findSpan(spans, "thread_pool.queue");
+  const auto* work = findSpan(spans, "work");
+  ASSERT_TRUE(task && queue && work);
+  ASSERT_EQ(task->parentSpanId, parent.spanId);
+  ASSERT_EQ(queue->parentSpanId, parent.spanId);
+  ASSERT_EQ(work->parentSpanId, task->context.spanId);
+  ASSERT_EQ(seen.traceLow, parent.traceLow);
+  ASSERT_TRUE(work->tid != findSpan(spans, "root")->tid);
+}
+
+static concurrency::Task<void> traced(const char* name, bool& ok)
+{
+  trace::Span span(name);
+  const auto mine = span.context();
+  for (int i = 0; i < 3; ++i)
+  {
+    co_await concurrency::yield();
+    ok = ok && trace::current().spanId == mine.spanId;
+  }
+}
+
+TEST(TraceTest, CoroutinePropagation)
+{
+  trace::setEnabled(true);
+  bool okA = true;
+  bool okB = true;
+  {
+    trace::Span root("root");
+    concurrency::Scheduler scheduler;
+    auto a = traced("a", okA);
+    auto b = traced("b", okB);
+    a.schedule_on(scheduler);
+    b.schedule_on(scheduler);
+    scheduler.run();
+    ASSERT_EQ(trace::current().spanId, root.context().spanId);
+  }
+  trace::setEnabled(false);
+
+  ASSERT_TRUE(okA);
+  ASSERT_TRUE(okB);
+  const auto spans = trace::collect();
+  const auto* root = findSpan(spans, "root");
+  ASSERT_TRUE(root != nullptr);
+  ASSERT_EQ(findSpan(spans, "a")->parentSpanId, root->context.spanId);
+  ASSERT_EQ(findSpan(spans, "b")->parentSpanId, root->context.spanId);
+}
+
+TEST(TraceTest, ChromeTraceExport)
+{
+  trace::setEnabled(true);
+  {
+    trace::Span span("export \"quoted\"");
+    trace::Span child("child");
+  }
+  trace::setEnabled(false);
+
+  const std::string path = "/tmp/cppkit_trace_test.json";
+  trace::writeChromeTrace(path);
+  std::ifstream ifs(path);
+  std::stringstream ss;
+  ss << ifs.rdbuf();
+
+  const auto json = json::Json::parse(ss.str());
+  const auto& events = json["traceEvents"].asArray();
+  size_t complete = 0;
+  for (size_t i = 0; i < events.size(); ++i)
+  {
+    if (events[i]["ph"].asString() == "X")
+    {
+      ++complete;
+      ASSERT_EQ(events[i]["args"]["trace_id"].asString().size(), static_cast<size_t>(32));
+    }
+  }
+  ASSERT_EQ(complete, static_cast<size_t>(2));
+  ASSERT_TRUE(ss.str().find("export \\\"quoted\\\"") != std::string::npos);
+
+  // 导出会取走记录
+  ASSERT_TRUE(trace::collect().empty());
+}
+
+int main()
+{
+  return RunAllTests();
+}
@@ -28,7 +28,7 @@ int main()
     std::cout << "Error: " << errMsg << std::endl;
   });
 
-  client.setOnMessage([](const std::vector<uint8_t>& data)
+  client.setOnMessage([](std::span<const uint8_t> data, MessageType)
   {
     std::cout << "Received: " << std::string(data.begin(), data.end()) << std::endl;
   });
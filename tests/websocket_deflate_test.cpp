@@ -0,0 +1,246 @@
+#include "cppkit/websocket/deflate.hpp"
+#include "cppkit/websocket/frame.hpp"
+#include "cppkit/testing/test.hpp"
+
+using namespace cppkit::websocket;
+using namespace cppkit::testing;
+
+static std::span<const uint8_t> bytes(const std::string_view s)
+{
+  return {reinterpret_cast<const uint8_t*>(s.data()), s.size()};
+}
+
+static std::string toString(const std::span<const uint8_t> data)
+{
+  return {data.begin(), data.end()};
+}
+
+TEST(WebSocketDeflateTest, NegotiateOffers)
+{
+  if (!deflateAvailable())
+    return;
+
+  DeflateParams params;
+  DeflateOptions options;
+  ASSERT_EQ(*negotiateDeflate("permessage-deflate; client_max_window_bits", options, params),
+            std::string("permessage-deflate"));
+  ASSERT_EQ(params.serverMaxWindowBits, 15);
+  ASSERT_TRUE(!params.serverNoContextTakeover);
+
+  // 客户端的限制与服务端配置取更严格的一方
+  options.serverNoContextTakeover = true;
+  options.clientMaxWindowBits = 12;
+  ASSERT_EQ(*negotiateDeflate("x-webkit-deflate-frame, permessage-deflate; server_max_window_bits=10; "
+                              "client_max_window_bits=\"14\"", options, params),
+            std::string("permessage-deflate; server_no_context_takeover; server_max_window_bits=10; "
+                        "client_max_window_bits=12"));
+  ASSERT_EQ(params.serverMaxWindowBits, 10);
+  ASSERT_EQ(params.clientMaxWindowBits, 12);
+  ASSERT_TRUE(params.serverNoContextTakeover);
+
+  // 客户端没有声明 client_max_window_bits 时无法限制它的窗口
+  ASSERT_TRUE(!negotiateDeflate("permessage-deflate", options, params));
+
+  // 非法提议被跳过，接受后面合法的那个
+  options = {};
+  for (const char* bad : {"permessage-deflate; server_max_window_bits=8", "permessage-deflate; foo",
+                          "permessage-deflate; server_max_window_bits=010",
+                          "permessage-deflate; server_no_context_takeover; server_no_context_takeover",
+                          "permessage-deflate; client_max_window_bits=16"})
+  {
+    ASSERT_TRUE(!negotiateDeflate(bad, options, params));
+    ASSERT_EQ(*negotiateDeflate(std::string(bad) + ", permessage-deflate; client_no_context_takeover", options,
+                                params),
+              std::string("permessage-deflate; client_no_context_takeover"));
+  }
+}
+
+TEST(WebSocketDeflateTest, ClientOfferAndResponse)
+{
+  if (!deflateAvailable())
+    return;
+
+  DeflateOptions options;
+  ASSERT_EQ(deflateOffer(options), std::string("permessage-deflate; client_max_window_bits"));
+  options.serverMaxWindowBits = 11;
+  options.clientNoContextTakeover = true;
+  ASSERT_EQ(deflateOffer(options), std::string("permessage-deflate; client_no_context_takeover; "
+                                               "server_max_window_bits=11; client_max_window_bits"));
+
+  DeflateParams params;
+  ASSERT_TRUE(acceptDeflateResponse("permessage-deflate; server_max_window_bits=10; client_max_window_bits=9",
+                                    options, params));
+  ASSERT_EQ(params.serverMaxWindowBits, 10);
+  ASSERT_EQ(params.clientMaxWindowBits, 9);
+  ASSERT_TRUE(params.clientNoContextTakeover);
+
+  // 服务端没有遵守我们的窗口限制、返回未知参数或多个扩展
+  ASSERT_TRUE(!acceptDeflateResponse("permessage-deflate", options, params));
+  ASSERT_TRUE(!acceptDeflateResponse("permessage-deflate; server_max_window_bits=11; x", options, params));
+  ASSERT_TRUE(!acceptDeflateResponse("permessage-deflate; server_max_window_bits=11, permessage-deflate", options,
+                                     params));
+  ASSERT_TRUE(!acceptDeflateResponse("permessage-deflate; server_max_window_bits=11; client_max_window_bits=8",
+                                     options, params));
+}
+
+TEST(WebSocketDeflateTest, Rfc7692Example)
+{
+  if (!deflateAvailable())
+    return;
+
+  // RFC 7692 7.2.3.1："Hello" 压缩后为 f2 48 cd c9 c9 07 00
+  PerMessageDeflate server(DeflateParams{}, true, DeflateOptions{});
+  std::vector<uint8_t> out;
+  server.compress(bytes("Hello"), out);
+  ASSERT_EQ(out.size(), 7u);
+  const uint8_t expected[] = {0xf2, 0x48, 0xcd, 0xc9, 0xc9, 0x07, 0x00};
+  ASSERT_TRUE(std::equal(out.begin(), out.end(), expected));
+
+  // 7.2.3.2：不压缩的存储块
+  PerMessageDeflate client(DeflateParams{}, false, DeflateOptions{});
+  const uint8_t stored[] = {0x00, 0x05, 0x00, 0xfa, 0xff, 0x48, 0x65, 0x6c, 0x6c, 0x6f, 0x00};
+  ASSERT_TRUE(client.decompress(stored, out, 100) == InflateStatus::OK);
+  ASSERT_EQ(toString(out), std::string("Hello"));
+
+  // 7.2.3.5：带 BFINAL 的块之后开始新的流
+  const uint8_t final[] = {0xf3, 0x48, 0xcd, 0xc9, 0xc9, 0x07, 0x00, 0x00};
+  ASSERT_TRUE(client.decompress(final, out, 100) == InflateStatus::OK);
+  ASSERT_EQ(toString(out), std::string("Hello"));
+  ASSERT_TRUE(client.decompress(expected, out, 100) == InflateStatus::OK);
+  ASSERT_EQ(toString(out), std::string("Hello"));
+}
+
+TEST(WebSocketDeflateTest, ContextTakeover)
+{
+  if (!deflateAvailable())
+    return;
+
+  std::string json;
+  for (int i = 0; i < 50; ++i)
+    json += R"({"symbol":"ABC","price":)" + std::to_string(100 + i) + R"(,"volume":12345,"side":"buy"},)";
+
+  for (const bool takeover : {true, false})
+  {
+    DeflateParams params;
+    params.serverNoContextTakeover = !takeover;
+    PerMessageDeflate server(params, true, DeflateOptions{});
+    PerMessageDeflate client(params, false, DeflateOptions{});
+
+    std::vector<uint8_t> first;
+    std::vector<uint8_t> second;
+    std::vector<uint8_t> plain;
+    server.compress(bytes(json), first);
+    server.compress(bytes(json), second);
+    ASSERT_TRUE(first.size() * 5 < json.size());
+    // 沿用上下文时第二条可以引用第一条的内容
+    ASSERT_EQ(second.size() < first.size(), takeover);
+    ASSERT_EQ(server.compressesIndependently(), !takeover);
+
+    ASSERT_TRUE(client.decompress(first, plain, json.size()) == InflateStatus::OK);
+    ASSERT_EQ(toString(plain), json);
+    ASSERT_TRUE(client.decompress(second, plain, json.size()) == InflateStatus::OK);
+    ASSERT_EQ(toString(plain), json);
+  }
+}
+
+TEST(WebSocketDeflateTest, DecompressLimits)
+{
+  if (!deflateAvailable())
+    return;
+
+  PerMessageDeflate server(DeflateParams{}, true, DeflateOptions{});
+  PerMessageDeflate client(DeflateParams{}, false, DeflateOptions{});
+  const std::string zeros(1 << 20, '\0');
+  std::vector<uint8_t> compressed;
+  server.compress(bytes(zeros), compressed);
+  ASSERT_TRUE(compressed.size() < 2048);
+
+  // 压缩炸弹在达到上限时停止，不会分配完整输出
+  std::vector<uint8_t> out;
+  ASSERT_TRUE(client.decompress(compressed, out, 4096) == InflateStatus::TOO_BIG);
+  ASSERT_TRUE(out.capacity() <= 8192);
+
+  PerMessageDeflate fresh(DeflateParams{}, false, DeflateOptions{});
+  const uint8_t garbage[] = {0xff, 0xff, 0xff, 0xff, 0x12};
+  ASSERT_TRUE(fresh.decompress(garbage, out, 4096) == InflateStatus::CORRUPT);
+}
+
+static std::vector<uint8_t> clientFrame(const std::span<const uint8_t> payload, const MessageType type, const bool fin,
+                                        const bool rsv1)
+{
+  auto frame = buildFrame(payload, type, fin, true);
+  if (rsv1)
+    frame[0] |= FRAME_RSV1;
+  return frame;
+}
+
+TEST(WebSocketDeflateTest, ReaderInflatesMessages)
+{
+  if (!deflateAvailable())
+    return;
+
+  PerMessageDeflate sender(DeflateParams{}, false, DeflateOptions{});
+  PerMessageDeflate receiver(DeflateParams{}, true, DeflateOptions{});
+
+  const std::string text = "κόσμε " + std::string(300, 'a');
+  std::vector<uint8_t> compressed;
+  sender.compress(bytes(text), compressed);
+
+  // 压缩消息分成两片，第二片之间插入 PING；RSV1 只在第一片上
+  const size_t half = compressed.size() / 2;
+  std::vector<uint8_t> wire;
+  for (const auto& frame : {clientFrame(std::span(compressed).first(half), MessageType::TEXT, false, true),
+                            clientFrame(bytes("p"), MessageType::PING, true, false),
+                            clientFrame(std::span(compressed).subspan(half), MessageType::CONTINUATION, true, false),
+                            clientFrame(bytes("raw"), MessageType::BINARY, true, false)})
+    wire.insert(wire.end(), frame.begin(), frame.end());
+
+  MessageReader reader(true);
+  reader.setDeflate(&receiver);
+  reader.append(wire);
+  std::vector<std::string> messages;
+  MessageReader::Message message{};
+  while (reader.next(message))
+    messages.push_back(toString(message.payload));
+  ASSERT_TRUE(!reader.failed());
+  ASSERT_EQ(messages.size(), 3u);
+  ASSERT_EQ(messages[1], text);
+  ASSERT_EQ(messages[2], std::string("raw"));
+
+  const auto expectError = [](const std::vector<uint8_t>& frame, PerMessageDeflate* deflate, const CloseCode code,
+                              const size_t maxMessageSize = MAX_PAYLOAD_SIZE)
+  {
+    MessageReader r(true, maxMessageSize);
+    r.setDeflate(deflate);
+    r.append(frame);
+    MessageReader::Message m{};
+    while (r.next(m))
+    {
+    }
+    ASSERT_TRUE(r.failed());
+    ASSERT_TRUE(r.error() == code);
+  };
+
+  // 未协商、控制帧或后续分片带 RSV1 都是协议错误
+  expectError(clientFrame(bytes("x"), MessageType::TEXT, true, true), nullptr, CloseCode::PROTOCOL_ERROR);
+  expectError(clientFrame(bytes("x"), MessageType::PING, true, true), &receiver, CloseCode::PROTOCOL_ERROR);
+  auto fragments = clientFrame(bytes("x"), MessageType::TEXT, false, false);
+  const auto next = clientFrame(bytes("y"), MessageType::CONTINUATION, true, true);
+  fragments.insert(fragments.end(), next.begin(), next.end());
+  expectError(fragments, &receiver, CloseCode::PROTOCOL_ERROR);
+
+  // 解压后超限或不是合法 UTF-8
+  PerMessageDeflate other(DeflateParams{}, false, DeflateOptions{});
+  other.compress(bytes(std::string(5000, 'z')), compressed);
+  PerMessageDeflate fresh(DeflateParams{}, true, DeflateOptions{});
+  expectError(clientFrame(compressed, MessageType::BINARY, true, true), &fresh, CloseCode::MESSAGE_TOO_BIG, 1000);
+  PerMessageDeflate fresh2(DeflateParams{}, false, DeflateOptions{});
+  fresh2.compress(bytes("\xCE\xBA\xE1"), compressed);
+  PerMessageDeflate fresh3(DeflateParams{}, true, DeflateOptions{});
+  expectError(clientFrame(compressed, MessageType::TEXT, true, true), &fresh3, CloseCode::INVALID_PAYLOAD);
+}
+
+int main()
+{
+  return RunAllTests();
+}
@@ -0,0 +1,193 @@
+#include "cppkit/websocket/frame.hpp"
+#include "cppkit/strings.hpp"
+#include "cppkit/testing/test.hpp"
+#include <algorithm>
+
+using namespace cppkit::websocket;
+using namespace cppkit::testing;
+
+static std::vector<uint8_t> pattern(const size_t size)
+{
+  std::vector<uint8_t> data(size);
+  for (size_t i = 0; i < size; ++i)
+    data[i] = static_cast<uint8_t>(i * 31 + 7);
+  return data;
+}
+
+TEST(WebSocketFrameTest, MaskMatchesBytewise)
+{
+  const uint8_t key[4] = {0x12, 0x34, 0xAB, 0xCD};
+  const auto data = pattern(300);
+  for (size_t size = 0; size <= data.size(); ++size)
+  {
+    std::vector<uint8_t> expected(data.begin(), data.begin() + static_cast<ptrdiff_t>(size));
+    for (size_t i = 0; i < size; ++i)
+      expected[i] ^= key[i % 4];
+
+    // 末尾哨兵检查越界写
+    std::vector<uint8_t> out(size + 1, 0xEE);
+    maskPayload(data.data(), out.data(), size, key);
+    ASSERT_TRUE(std::equal(expected.begin(), expected.end(), out.begin()));
+    ASSERT_EQ(out[size], 0xEE);
+
+    // 原地去掩码
+    maskPayload(out.data(), out.data(), size, key);
+    ASSERT_TRUE(std::equal(out.begin(), out.begin() + static_cast<ptrdiff_t>(size), data.begin()));
+  }
+}
+
+TEST(WebSocketFrameTest, HeaderLengths)
+{
+  const uint8_t key[4] = {1, 2, 3, 4};
+  ASSERT_EQ(makeFrameHeader(125, MessageType::TEXT).size, 2u);
+  ASSERT_EQ(makeFrameHeader(126, MessageType::TEXT).size, 4u);
+  ASSERT_EQ(makeFrameHeader(65535, MessageType::TEXT).size, 4u);
+  ASSERT_EQ(makeFrameHeader(65536, MessageType::TEXT).size, 10u);
+  ASSERT_EQ(makeFrameHeader(65536, MessageType::TEXT, true, key).size, MAX_FRAME_HEADER_SIZE);
+
+  const auto header = makeFrameHeader(300, MessageType::BINARY, false, key);
+  ASSERT_EQ(header.data[0], 0x02);
+  ASSERT_EQ(header.data[1], 0x80 | 126);
+  ASSERT_EQ(header.data[2], 0x01);
+  ASSERT_EQ(header.data[3], 0x2C);
+  ASSERT_EQ(header.data[4], 1);
+  ASSERT_EQ(header.data[7], 4);
+}
+
+TEST(WebSocketFrameTest, ParseIsZeroCopy)
+{
+  for (const size_t size : {size_t{0}, size_t{5}, size_t{125}, size_t{126}, size_t{1000}, size_t{70000}})
+  {
+    const auto payload = pattern(size);
+    for (const bool mask : {false, true})
+    {
+      auto wire = buildFrame(payload, MessageType::BINARY, true, mask);
+      Frame frame{};
+
+      // 数据不完整时返回 0
+      ASSERT_EQ(parseFrame(std::span(wire).first(wire.size() - 1), frame), 0u);
+
+      ASSERT_EQ(parseFrame(wire, frame), wire.size());
+      ASSERT_TRUE(frame.fin);
+      ASSERT_TRUE(frame.opCode == MessageType::BINARY);
+      ASSERT_EQ(frame.mask, mask);
+      ASSERT_EQ(frame.payloadLength, size);
+      ASSERT_EQ(frame.payload.size(), size);
+      ASSERT_TRUE(std::equal(payload.begin(), payload.end(), frame.payload.begin()));
+      if (size > 0)
+        ASSERT_TRUE(frame.payload.data() == wire.data() + (wire.size() - size));
+    }
+  }
+}
+
+TEST(WebSocketFrameTest, RejectsOversizedPayload)
+{
+  auto header = makeFrameHeader(MAX_PAYLOAD_SIZE + 1, MessageType::BINARY);
+  bool threw = false;
+  try
+  {
+    Frame frame{};
+    parseFrame(std::span(header.data, header.size), frame);
+  }
+  catch (const std::runtime_error&)
+  {
+    threw = true;
+  }
+  ASSERT_TRUE(threw);
+}
+
+TEST(WebSocketFrameTest, Utf8Validation)
+{
+  ASSERT_TRUE(cppkit::isValidUtf8(""));
+  ASSERT_TRUE(cppkit::isValidUtf8(std::string(100, 'a') + "κόσμε" + std::string(70, 'b') + "\xF0\x9F\x98\x80"));
+  ASSERT_TRUE(cppkit::isValidUtf8("\xEF\xBF\xBF\xF4\x8F\xBF\xBF"));
+  for (const char* bad : {"\x80", "\xC0\xAF", "\xE0\x80\xAF", "\xED\xA0\x80", "\xF4\x90\x80\x80", "\xF5\x80\x80\x80",
+                          "\xE2\x82", "\xCE\xBA\xE1\xBD"})
+  {
+    ASSERT_TRUE(!cppkit::isValidUtf8(bad));
+    // 非法字节位于长 ASCII 串之后，走向量化路径
+    ASSERT_TRUE(!cppkit::isValidUtf8(std::string(77, 'x') + bad + std::string(40, 'y')));
+  }
+}
+
+static std::vector<uint8_t> clientFrame(const std::string_view payload, const MessageType type, const bool fin = true)
+{
+  return buildFrame(std::span(reinterpret_cast<const uint8_t*>(payload.data()), payload.size()), type, fin, true);
+}
+
+static std::string toString(const std::span<const uint8_t> data)
+{
+  return {data.begin(), data.end()};
+}
+
+TEST(WebSocketFrameTest, ReaderReassemblesFragments)
+{
+  std::vector<uint8_t> wire;
+  for (const auto& frame : {clientFrame("Hel", MessageType::TEXT, false), clientFrame("ping", MessageType::PING),
+                            clientFrame("lo ", MessageType::CONTINUATION, false),
+                            clientFrame("wörld", MessageType::CONTINUATION), clientFrame("bin", MessageType::BINARY)})
+    wire.insert(wire.end(), frame.begin(), frame.end());
+
+  // 按 1 字节和 7 字节分块喂入
+  for (const size_t chunk : {size_t{1}, size_t{7}, wire.size()})
+  {
+    MessageReader reader(true);
+    std::vector<std::pair<MessageType, std::string>> messages;
+    for (size_t i = 0; i < wire.size(); i += chunk)
+    {
+      reader.append(std::span(wire).subspan(i, std::min(chunk, wire.size() - i)));
+      MessageReader::Message message{};
+      while (reader.next(message))
+        messages.emplace_back(message.type, toString(message.payload));
+    }
+    ASSERT_TRUE(!reader.failed());
+    ASSERT_EQ(messages.size(), 3u);
+    ASSERT_TRUE(messages[0].first == MessageType::PING);
+    ASSERT_EQ(messages[0].second, std::string("ping"));
+    ASSERT_TRUE(messages[1].first == MessageType::TEXT);
+    ASSERT_EQ(messages[1].second, std::string("Hello wörld"));
+    ASSERT_TRUE(messages[2].first == MessageType::BINARY);
+    ASSERT_EQ(messages[2].second, std::string("bin"));
+    ASSERT_EQ(reader.pending().size(), 0u);
+  }
+}
+
+TEST(WebSocketFrameTest, ReaderProtocolErrors)
+{
+  const auto expectError = [](const std::vector<std::vector<uint8_t>>& frames, const CloseCode code,
+                              const size_t maxMessageSize = MAX_PAYLOAD_SIZE)
+  {
+    MessageReader reader(true, maxMessageSize);
+    for (const auto& frame : frames)
+      reader.append(frame);
+    MessageReader::Message message{};
+    while (reader.next(message))
+    {
+    }
+    ASSERT_TRUE(reader.failed());
+    ASSERT_TRUE(reader.error() == code);
+  };
+
+  const std::string big(80, 'a');
+  expectError({clientFrame(big, MessageType::TEXT, false), clientFrame(big, MessageType::CONTINUATION)},
+              CloseCode::MESSAGE_TOO_BIG, 100);
+  expectError({clientFrame(std::string(101, 'a'), MessageType::BINARY)}, CloseCode::MESSAGE_TOO_BIG, 100);
+  expectError({buildFrame({}, MessageType::TEXT)}, CloseCode::PROTOCOL_ERROR); // 客户端帧未掩码
+  expectError({clientFrame("x", MessageType::CONTINUATION)}, CloseCode::PROTOCOL_ERROR);
+  expectError({clientFrame("a", MessageType::TEXT, false), clientFrame("b", MessageType::TEXT)},
+              CloseCode::PROTOCOL_ERROR);
+  expectError({clientFrame("p", MessageType::PING, false)}, CloseCode::PROTOCOL_ERROR);
+  expectError({clientFrame(std::string(126, 'p'), MessageType::PING)}, CloseCode::PROTOCOL_ERROR);
+  expectError({clientFrame("\xCE\xBA\xE1", MessageType::TEXT)}, CloseCode::INVALID_PAYLOAD);
+  expectError({clientFrame("\x03\xED", MessageType::CLOSE)}, CloseCode::PROTOCOL_ERROR); // 1005 不能出现在帧中
+  expectError({clientFrame("\x03\xE8\xFF", MessageType::CLOSE)}, CloseCode::INVALID_PAYLOAD);
+
+  auto rsv = clientFrame("x", MessageType::TEXT);
+  rsv[0] |= 0x40;
+  expectError({rsv}, CloseCode::PROTOCOL_ERROR);
+}
+
+int main()
+{
+  return RunAllTests();
+}
@@ -0,0 +1,156 @@
+#include "cppkit/websocket/client.hpp"
+#include "cppkit/websocket/server.hpp"
+#include "cppkit/testing/test.hpp"
+#include <arpa/inet.h>
+#include <atomic>
+#include <thread>
+#include <unistd.h>
+
+using namespace cppkit::websocket;
+using namespace cppkit::testing;
+
+// 回显服务器，收到 "stop" 时在自己的线程里停止
+static void runEchoServer(const uint16_t port, const bool deflate, std::atomic<bool>& stopped)
+{
+  WebSocketServer server("127.0.0.1", port);
+  if (deflate)
+    server.enableDeflate();
+  server.setOnMessage([&server](const ConnInfo& conn, const std::span<const uint8_t> data, const MessageType type)
+  {
+    if (std::string_view(reinterpret_cast<const char*>(data.data()), data.size()) == "stop")
+      server.stop();
+    else
+      (void) server.send(conn, data, type);
+  });
+  server.start();
+  stopped = true;
+}
+
+// 事件循环跑到 done 为真或超时
+static void runUntil(cppkit::event::EventLoop& loop, const std::function<bool()>& done, const int64_t timeoutMs)
+{
+  const int64_t timeout = loop.createTimeEvent(timeoutMs, [&loop](int64_t) -> int64_t
+  {
+    loop.stop();
+    return 0;
+  });
+  (void) loop.createTimeEvent(1, [&loop, done, timeout](int64_t) -> int64_t
+  {
+    if (done())
+    {
+      loop.deleteTimeEvent(timeout);
+      loop.stop();
+      return 0;
+    }
+    return 1;
+  });
+  loop.run();
+}
+
+// 单线程事件循环驱动多个客户端；服务端稍后才启动，靠重连连上
+static void echoManyClients(const uint16_t port, const bool deflate)
+{
+  constexpr size_t CLIENTS = 50;
+  const std::string big(4096, 'a');
+  cppkit::event::EventLoop loop;
+  std::vector<std::unique_ptr<WebSocketClient>> clients;
+  size_t echoed = 0;
+  size_t compressed = 0;
+  for (size_t i = 0; i < CLIENTS; ++i)
+  {
+    auto client = std::make_unique<WebSocketClient>(&loop);
+    if (deflate)
+      client->enableDeflate();
+    client->setReconnect({.enabled = true, .initialDelayMs = 10, .maxDelayMs = 50});
+    WebSocketClient* c = client.get();
+    client->setOnConnect([c, &big, &compressed]
+    {
+      compressed += c->deflateNegotiated();
+      (void) c->send(big);
+    });
+    client->setOnMessage([&big, &echoed](const std::span<const uint8_t> data, const MessageType type)
+    {
+      echoed += type == MessageType::TEXT && std::string(data.begin(), data.end()) == big;
+    });
+    ASSERT_TRUE(client->connect("ws://127.0.0.1:" + std::to_string(port) + "/"));
+    clients.push_back(std::move(client));
+  }
+
+  std::thread server;
+  std::atomic<bool> stopped = false;
+  (void) loop.createTimeEvent(30, [&server, &stopped, port, deflate](int64_t) -> int64_t
+  {
+    server = std::thread(runEchoServer, port, deflate, std::ref(stopped));
+    return 0;
+  });
+  runUntil(loop, [&echoed] { return echoed == CLIENTS; }, 5000);
+
+  ASSERT_EQ(echoed, CLIENTS);
+  ASSERT_EQ(compressed, deflate && deflateAvailable() ? CLIENTS : 0);
+  ASSERT_TRUE(clients[0]->send(std::string_view("stop")));
+  runUntil(loop, [&stopped] { return stopped.load(); }, 5000);
+  for (auto& client : clients)
+    client->disconnect();
+  server.join();
+}
+
+TEST(WebSocketLoopClientTest, EchoManyClients)
+{
+  echoManyClients(18741, false);
+}
+
+TEST(WebSocketLoopClientTest, EchoManyClientsDeflate)
+{
+  echoManyClients(18742, true);
+}
+
+TEST(WebSocketLoopClientTest, ReconnectAttemptsExhausted)
+{
+  cppkit::event::EventLoop loop;
+  WebSocketClient client(&loop);
+  client.setReconnect({.enabled = true, .initialDelayMs = 10, .maxDelayMs = 40, .maxAttempts = 3});
+  std::vector<std::string> errors;
+  client.setOnError([&errors](const std::string& message)
+  {
+    errors.push_back(message);
+  });
+  ASSERT_TRUE(client.connect("ws://127.0.0.1:18743/"));
+  runUntil(loop, [&errors] { return !errors.empty() && errors.back() == "Reconnect attempts exhausted"; }, 3000);
+
+  // 首次连接加三次重连都被拒绝，之后不再重试
+  ASSERT_EQ(errors.size(), 5u);
+  ASSERT_EQ(errors.back(), std::string("Reconnect attempts exhausted"));
+  ASSERT_TRUE(!client.isConnected());
+}
+
+TEST(WebSocketLoopClientTest, HandshakeTimeout)
+{
+  // 只监听不应答：TCP 连接能建立，握手永远等不到响应
+  const int listener = ::socket(AF_INET, SOCK_STREAM, 0);
+  sockaddr_in addr{};
+  addr.sin_family = AF_INET;
+  addr.sin_port = htons(18744);
+  inet_pton(AF_INET, "127.0.0.1", &addr.sin_addr);
+  constexpr int on = 1;
+  setsockopt(listener, SOL_SOCKET, SO_REUSEADDR, &on, sizeof(on));
+  ASSERT_EQ(::bind(listener, reinterpret_cast<sockaddr*>(&addr), sizeof(addr)), 0);
+  ASSERT_EQ(::listen(listener, 16), 0);
+
+  cppkit::event::EventLoop loop;
+  WebSocketClient client(&loop);
+  client.setConnectTimeout(50);
+  std::string error;
+  client.setOnError([&error](const std::string& message)
+  {
+    error = message;
+  });
+  ASSERT_TRUE(client.connect("ws://127.0.0.1:18744/"));
+  runUntil(loop, [&error] { return !error.empty(); }, 3000);
+  ::close(listener);
+  ASSERT_EQ(error, std::string("Connection timed out"));
+}
+
+int main()
+{
+  return RunAllTests();
+}
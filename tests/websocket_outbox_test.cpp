@@ -0,0 +1,190 @@
+#include "cppkit/websocket/conn.hpp"
+#include "cppkit/testing/test.hpp"
+#include <fcntl.h>
+#include <sys/socket.h>
+#include <unistd.h>
+
+using namespace cppkit::websocket;
+using namespace cppkit::testing;
+
+// 非阻塞 socketpair，发送端缓冲区尽量小，便于制造写满的情况
+struct Pair
+{
+  int sender = -1;
+  int receiver = -1;
+
+  Pair()
+  {
+    int fds[2];
+    socketpair(AF_UNIX, SOCK_STREAM, 0, fds);
+    sender = fds[0];
+    receiver = fds[1];
+    const int size = 4096;
+    setsockopt(sender, SOL_SOCKET, SO_SNDBUF, &size, sizeof(size));
+    fcntl(sender, F_SETFL, fcntl(sender, F_GETFL) | O_NONBLOCK);
+    fcntl(receiver, F_SETFL, fcntl(receiver, F_GETFL) | O_NONBLOCK);
+  }
+
+  ~Pair()
+  {
+    ::close(sender);
+    ::close(receiver);
+  }
+
+  // 读出对端当前能读到的全部数据
+  void drain(std::vector<uint8_t>& out) const
+  {
+    uint8_t buf[65536];
+    ssize_t n;
+    while ((n = ::read(receiver, buf, sizeof(buf))) > 0)
+      out.insert(out.end(), buf, buf + n);
+  }
+};
+
+static std::vector<uint8_t> numbered(const uint32_t id, const size_t size = 1000)
+{
+  std::vector<uint8_t> payload(size, static_cast<uint8_t>(id));
+  std::memcpy(payload.data(), &id, sizeof(id));
+  return payload;
+}
+
+// 按帧还原收到的消息编号，帧不完整或被截断时 ok 为 false
+static std::vector<uint32_t> messageIds(const std::vector<uint8_t>& wire, bool& ok)
+{
+  MessageReader reader(false);
+  reader.append(wire);
+  std::vector<uint32_t> ids;
+  MessageReader::Message message{};
+  while (reader.next(message))
+  {
+    uint32_t id;
+    std::memcpy(&id, message.payload.data(), sizeof(id));
+    ids.push_back(id);
+  }
+  ok = !reader.failed() && reader.pending().empty();
+  return ids;
+}
+
+TEST(WebSocketOutboxTest, QueuesAndFlushesInOrder)
+{
+  cppkit::event::EventLoop loop;
+  Pair pair;
+  const OutboxLimits limits;
+  Outbox outbox(&loop, pair.sender, limits, [](int, int) {});
+
+  // 共享帧与帧头 + 负载两种写法交替
+  constexpr uint32_t count = 300;
+  for (uint32_t i = 0; i < count; ++i)
+  {
+    const auto payload = numbered(i);
+    const bool sent = i % 2 == 0
+                        ? outbox.send(makeSharedFrame(payload))
+                        : outbox.send(makeFrameHeader(payload.size(), MessageType::BINARY), payload);
+    ASSERT_TRUE(sent);
+  }
+  ASSERT_TRUE(outbox.queuedBytes() > 0);
+  ASSERT_TRUE((loop.getFileEvents(pair.sender) & cppkit::event::AE_WRITABLE) != 0);
+
+  std::vector<uint8_t> wire;
+  while (outbox.queuedBytes() > 0)
+  {
+    pair.drain(wire);
+    ASSERT_TRUE(outbox.flush());
+  }
+  pair.drain(wire);
+  ASSERT_EQ(loop.getFileEvents(pair.sender) & cppkit::event::AE_WRITABLE, 0);
+
+  bool ok = false;
+  const auto ids = messageIds(wire, ok);
+  ASSERT_TRUE(ok);
+  ASSERT_EQ(ids.size(), static_cast<size_t>(count));
+  for (uint32_t i = 0; i < count; ++i)
+    ASSERT_EQ(ids[i], i);
+  ASSERT_EQ(outbox.droppedMessages(), 0u);
+}
+
+// 对端不读时连续发送 200 条 1000 字节的消息，再读出实际送达的消息编号
+static std::vector<uint32_t> runPolicy(const SlowConsumerPolicy policy, size_t& accepted)
+{
+  cppkit::event::EventLoop loop;
+  Pair pair;
+  const OutboxLimits limits{16 * 1024, policy};
+  Outbox outbox(&loop, pair.sender, limits, [](int, int) {});
+
+  accepted = 0;
+  for (uint32_t i = 0; i < 200; ++i)
+  {
+    if (outbox.send(makeSharedFrame(numbered(i))))
+      ++accepted;
+  }
+  ASSERT_TRUE(outbox.queuedBytes() <= limits.maxQueuedBytes);
+
+  std::vector<uint8_t> wire;
+  if (!outbox.broken())
+  {
+    while (outbox.queuedBytes() > 0)
+    {
+      pair.drain(wire);
+      ASSERT_TRUE(outbox.flush());
+    }
+  }
+  pair.drain(wire);
+  bool ok = false;
+  auto ids = messageIds(wire, ok);
+  ASSERT_TRUE(ok);
+  return ids;
+}
+
+TEST(WebSocketOutboxTest, DropNewest)
+{
+  size_t accepted = 0;
+  const auto ids = runPolicy(SlowConsumerPolicy::DROP_NEWEST, accepted);
+  ASSERT_TRUE(accepted < 200);
+  ASSERT_EQ(ids.size(), accepted);
+  // 保留的是最早的消息，且顺序不变
+  for (size_t i = 0; i < ids.size(); ++i)
+    ASSERT_EQ(ids[i], static_cast<uint32_t>(i));
+}
+
+TEST(WebSocketOutboxTest, DropOldest)
+{
+  size_t accepted = 0;
+  const auto ids = runPolicy(SlowConsumerPolicy::DROP_OLDEST, accepted);
+  // 新消息总能进入队列，最后一条一定送达，丢掉的是中间排队的旧消息
+  ASSERT_EQ(accepted, 200u);
+  ASSERT_TRUE(ids.size() < 200);
+  ASSERT_EQ(ids.back(), 199u);
+  for (size_t i = 1; i < ids.size(); ++i)
+    ASSERT_TRUE(ids[i] > ids[i - 1]);
+}
+
+TEST(WebSocketOutboxTest, DisconnectWhenOverLimit)
+{
+  cppkit::event::EventLoop loop;
+  Pair pair;
+  const OutboxLimits limits{16 * 1024, SlowConsumerPolicy::DISCONNECT};
+  Outbox outbox(&loop, pair.sender, limits, [](int, int) {});
+
+  bool rejected = false;
+  for (uint32_t i = 0; i < 200 && !rejected; ++i)
+    rejected = !outbox.send(makeSharedFrame(numbered(i)));
+  ASSERT_TRUE(rejected);
+  ASSERT_TRUE(outbox.broken());
+  ASSERT_TRUE(!outbox.send(makeSharedFrame(numbered(0))));
+}
+
+TEST(WebSocketOutboxTest, WriteErrorMarksBroken)
+{
+  cppkit::event::EventLoop loop;
+  Pair pair;
+  const OutboxLimits limits;
+  Outbox outbox(&loop, pair.sender, limits, [](int, int) {});
+  ::shutdown(pair.receiver, SHUT_RDWR);
+  ASSERT_TRUE(!outbox.send(makeSharedFrame(numbered(1))));
+  ASSERT_TRUE(outbox.broken());
+}
+
+int main()
+{
+  return RunAllTests();
+}
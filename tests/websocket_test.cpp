@@ -21,7 +21,7 @@ int main()
     std::cout << "客户端加入:" << connInfo.getClientId() << std::endl;
   });
 
-  server.setOnMessage([&clientMap](const ConnInfo& connInfo, const std::vector<uint8_t>& message, MessageType type)
+  server.setOnMessage([&clientMap](const ConnInfo& connInfo, std::span<const uint8_t> message, MessageType type)
   {
     // 广播消息给所有客户端
     const std::string msg(message.begin(), message.end());
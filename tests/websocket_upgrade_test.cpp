@@ -0,0 +1,217 @@
+#include "cppkit/websocket/client.hpp"
+#include "cppkit/websocket/server.hpp"
+#include "cppkit/http/server/http_server.hpp"
+#include "cppkit/testing/test.hpp"
+#include <arpa/inet.h>
+#include <atomic>
+#include <thread>
+#include <unistd.h>
+
+using namespace cppkit::websocket;
+using namespace cppkit::http::server;
+using namespace cppkit::testing;
+
+constexpr uint16_t PORT = 18751;
+
+static std::span<const uint8_t> bytes(const std::string_view s)
+{
+  return {reinterpret_cast<const uint8_t*>(s.data()), s.size()};
+}
+
+// 压缩不了的负载：伪随机字节
+static std::string noise(const size_t size)
+{
+  std::string data(size, '\0');
+  uint32_t state = 12345;
+  for (auto& c : data)
+  {
+    state = state * 1103515245 + 12345;
+    c = static_cast<char>(state >> 24);
+  }
+  return data;
+}
+
+// 同一个端口上既有普通路由又有 WebSocket，收到 "stop" 时停止，收到 "publish" 时向 "all" 广播
+static void runServer(std::atomic<bool>& stopped)
+{
+  HttpServer http("127.0.0.1", PORT);
+  http.Get("/hello", [](const HttpRequest&, HttpResponseWriter& writer)
+  {
+    writer.write("hello");
+  });
+
+  WebSocketServer ws;
+  ws.enableDeflate();
+  ws.attach(http, "/ws");
+  ws.setOnConnect([&](const HttpRequest& request, const ConnInfo& conn)
+  {
+    if (request.getQuery("sub") == "1")
+      ws.subscribe(conn, "all");
+  });
+  ws.setOnMessage([&](const ConnInfo& conn, const std::span<const uint8_t> data, const MessageType type)
+  {
+    const std::string_view text(reinterpret_cast<const char*>(data.data()), data.size());
+    if (text == "stop")
+      http.stop();
+    else if (text == "publish")
+      (void) ws.publish("all", bytes(noise(300)), MessageType::BINARY);
+    else
+      (void) ws.send(conn, data, type);
+  });
+  http.start();
+  stopped = true;
+}
+
+// 阻塞连接到服务器，读超时 2 秒
+static int dial()
+{
+  sockaddr_in addr{};
+  addr.sin_family = AF_INET;
+  addr.sin_port = htons(PORT);
+  inet_pton(AF_INET, "127.0.0.1", &addr.sin_addr);
+  for (int i = 0; i < 200; ++i)
+  {
+    const int fd = ::socket(AF_INET, SOCK_STREAM, 0);
+    if (::connect(fd, reinterpret_cast<sockaddr*>(&addr), sizeof(addr)) == 0)
+    {
+      const timeval tv{2, 0};
+      setsockopt(fd, SOL_SOCKET, SO_RCVTIMEO, &tv, sizeof(tv));
+      return fd;
+    }
+    ::close(fd);
+    usleep(10 * 1000);
+  }
+  return -1;
+}
+
+// 读到 done 为真、对端关闭或超时
+static std::string readUntil(const int fd, const std::function<bool(const std::string&)>& done)
+{
+  std::string data;
+  char buf[4096];
+  while (!done(data))
+  {
+    const ssize_t n = ::read(fd, buf, sizeof(buf));
+    if (n <= 0)
+      break;
+    data.append(buf, n);
+  }
+  return data;
+}
+
+static const std::string HANDSHAKE = "GET /ws?token=1 HTTP/1.1\r\n"
+    "Host: 127.0.0.1\r\n"
+    "Upgrade: WebSocket\r\n"
+    "Connection: keep-alive, Upgrade\r\n"
+    "Sec-WebSocket-Key: dGhlIHNhbXBsZSBub25jZQ==\r\n"
+    "Sec-WebSocket-Version: 13\r\n\r\n";
+
+TEST(WebSocketUpgradeTest, SharePortWithHttp)
+{
+  std::atomic<bool> stopped = false;
+  std::thread server(runServer, std::ref(stopped));
+
+  // 握手请求和第一帧在同一次写入中到达，请求头之后的数据要交给 WebSocket
+  const int ws = dial();
+  ASSERT_TRUE(ws >= 0);
+  const auto frame = buildFrame(bytes("early"), MessageType::TEXT, true, true);
+  std::string request = HANDSHAKE;
+  request.append(frame.begin(), frame.end());
+  ASSERT_EQ(::write(ws, request.data(), request.size()), static_cast<ssize_t>(request.size()));
+  const std::string response = readUntil(ws, [](const std::string& data)
+  {
+    const size_t end = data.find("\r\n\r\n");
+    return end != std::string::npos && data.size() >= end + 4 + 7;
+  });
+  ASSERT_TRUE(response.starts_with("HTTP/1.1 101 Switching Protocols\r\n"));
+  ASSERT_TRUE(response.find("Sec-WebSocket-Accept: s3pPLMBiTxaQ9kYGzzhZRbK+xOo=\r\n") != std::string::npos);
+  const std::string echoed = response.substr(response.find("\r\n\r\n") + 4);
+  ASSERT_EQ(echoed, std::string("\x81\x05" "early"));
+
+  // 普通请求照常路由；没有 Upgrade 头的 /ws 请求不会被接管
+  const int plain = dial();
+  const std::string get = "GET /hello HTTP/1.1\r\nHost: 127.0.0.1\r\nConnection: close\r\n\r\n";
+  ASSERT_EQ(::write(plain, get.data(), get.size()), static_cast<ssize_t>(get.size()));
+  const std::string hello = readUntil(plain, [](const std::string&) { return false; });
+  ::close(plain);
+  ASSERT_TRUE(hello.starts_with("HTTP/1.1 200"));
+  ASSERT_TRUE(hello.ends_with("\r\n\r\nhello"));
+
+  const int notUpgrade = dial();
+  const std::string getWs = "GET /ws HTTP/1.1\r\nHost: 127.0.0.1\r\nConnection: close\r\n\r\n";
+  ASSERT_EQ(::write(notUpgrade, getWs.data(), getWs.size()), static_cast<ssize_t>(getWs.size()));
+  const std::string notFound = readUntil(notUpgrade, [](const std::string&) { return false; });
+  ::close(notUpgrade);
+  ASSERT_TRUE(notFound.starts_with("HTTP/1.1 404"));
+
+  // 每条消息独立压缩时，压缩后没有变小的广播消息以未压缩的帧发送
+  const int sub = dial();
+  const std::string subscribe = "GET /ws?sub=1 HTTP/1.1\r\n"
+      "Host: 127.0.0.1\r\n"
+      "Upgrade: websocket\r\n"
+      "Connection: Upgrade\r\n"
+      "Sec-WebSocket-Key: dGhlIHNhbXBsZSBub25jZQ==\r\n"
+      "Sec-WebSocket-Extensions: permessage-deflate; server_no_context_takeover\r\n"
+      "Sec-WebSocket-Version: 13\r\n\r\n";
+  ASSERT_EQ(::write(sub, subscribe.data(), subscribe.size()), static_cast<ssize_t>(subscribe.size()));
+  const std::string accepted = readUntil(sub, [](const std::string& data) { return data.ends_with("\r\n\r\n"); });
+  ASSERT_TRUE(accepted.starts_with("HTTP/1.1 101 Switching Protocols\r\n"));
+  ASSERT_EQ(accepted.find("permessage-deflate") != std::string::npos, deflateAvailable());
+  const auto publish = buildFrame(bytes("publish"), MessageType::TEXT, true, true);
+  ASSERT_EQ(::write(sub, publish.data(), publish.size()), static_cast<ssize_t>(publish.size()));
+  const std::string published = readUntil(sub, [](const std::string& data) { return data.size() >= 4 + 300; });
+  ::close(sub);
+  ASSERT_EQ(published, std::string("\x82\x7e\x01\x2c", 4) + noise(300));
+
+  // 非阻塞客户端协商压缩后回显
+  cppkit::event::EventLoop loop;
+  WebSocketClient client(&loop);
+  client.enableDeflate();
+  const std::string big(1000, 'b');
+  std::string received;
+  client.setOnConnect([&]
+  {
+    (void) client.send(big);
+  });
+  client.setOnMessage([&](const std::span<const uint8_t> data, MessageType)
+  {
+    received.assign(data.begin(), data.end());
+    loop.stop();
+  });
+  client.setOnError([&](const std::string&)
+  {
+    loop.stop();
+  });
+  ASSERT_TRUE(client.connect("ws://127.0.0.1:" + std::to_string(PORT) + "/ws"));
+  const int64_t timeout = loop.createTimeEvent(3000, [&loop](int64_t) -> int64_t
+  {
+    loop.stop();
+    return 0;
+  });
+  loop.run();
+  loop.deleteTimeEvent(timeout);
+  ASSERT_EQ(client.deflateNegotiated(), deflateAvailable());
+  ASSERT_EQ(received, big);
+
+  // 第一个连接关闭时服务端要清理升级后的连接状态
+  ::close(ws);
+  ASSERT_TRUE(client.send(std::string_view("stop")));
+  (void) loop.createTimeEvent(1, [&](int64_t) -> int64_t
+  {
+    if (stopped)
+    {
+      loop.stop();
+      return 0;
+    }
+    return 1;
+  });
+  loop.run();
+  client.disconnect();
+  server.join();
+  ASSERT_TRUE(stopped);
+}
+
+int main()
+{
+  return RunAllTests();
+}